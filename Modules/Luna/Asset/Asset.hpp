@@ -70,6 +70,14 @@ namespace Luna
 			RV(*on_set_asset_data)(object_t userdata, asset_t asset, object_t data) = nullptr;
 			//! Called when the asset data is being unloaded.
 			void(*on_unload_asset_data)(object_t userdata, asset_t asset) = nullptr;
+			//! Called by `load_asset_recursive` after the asset data is loaded to get assets referenced by the asset data.
+			//! @param[in] data The loaded asset data.
+			//! @param[out] out_dependencies Receives assets that should be loaded together with this asset.
+			RV(*on_get_asset_dependencies)(object_t userdata, asset_t asset, object_t data, Vector<asset_t>& out_dependencies) = nullptr;
+			//! Called when the asset data is set to get the memory cost of the asset data in bytes. The cost is counted 
+			//! against the asset memory budget. If this is `nullptr`, the asset data is treated as costing no memory and is never evicted.
+			//! @param[in] data The asset data.
+			u64(*on_get_asset_memory_cost)(object_t userdata, asset_t asset, object_t data) = nullptr;
 		};
 
 		//! Registers one asset type so the asset system can handle the asset.
@@ -84,6 +92,24 @@ namespace Luna
 		//! @param[in] type The type of the asset.
 		LUNA_ASSET_API R<asset_t> new_asset(const Path& path, const Name& type);
 
+		//! Statistics of one `update_assets_meta` call.
+		struct AssetMetaUpdateStatistics
+		{
+			//! The number of directories scanned.
+			usize num_directories = 0;
+			//! The number of asset meta files loaded.
+			usize num_meta_files = 0;
+			//! The wall-clock time, in seconds, spent on scanning directories and parsing meta files.
+			//! Directories are scanned and meta files are parsed concurrently in this phase.
+			f64 collect_time = 0.0;
+			//! The time, in seconds, spent on registering loaded metadata to the asset system.
+			f64 register_time = 0.0;
+			//! The accumulated time, in seconds, spent by all jobs on enumerating directories.
+			f64 scan_job_time = 0.0;
+			//! The accumulated time, in seconds, spent by all jobs on reading and parsing meta files.
+			f64 parse_job_time = 0.0;
+		};
+
 		//! Updates asset metadata by reading asset meta files.
 		//! @param[in] path The path of the asset or direcotry.
 		//! If `path` represents one asset, the system loads the asset metadata by opening its meta file and reading from it.
@@ -94,7 +120,11 @@ namespace Luna
 		//! from asset meta file; if `allow_overwrite` is `false`, the system discards the new asset metadata and does not change the 
 		//! asset metadata in the system.
 		//! If `path` specifies one directory, this parameter is applied to all assets in that directory.
-		LUNA_ASSET_API RV update_assets_meta(const Path& path, bool allow_overwrite = true);
+		//! @param[out] statistics If not `nullptr`, receives the timings and counters of every phase of this call.
+		//! @remark When `path` specifies one directory, subdirectories are scanned and meta files are parsed concurrently
+		//! using the job system, then all loaded metadata are registered in one batch. If multiple meta files in the directory 
+		//! declare the same asset GUID, which one is registered is unspecified.
+		LUNA_ASSET_API RV update_assets_meta(const Path& path, bool allow_overwrite = true, AssetMetaUpdateStatistics* statistics = nullptr);
 
 		//! Gets or creates one asset entry. An asset is one block of application data that is stored on one asset file.
 		//! This function returns the asset entry corresponding to the specified Asset ID.
@@ -159,6 +189,18 @@ namespace Luna
 
 		LUNA_ASSET_API void load_asset(asset_t asset, bool force_reload = false);
 
+		//! Loads one asset and all assets it depends on.
+		//! @param[in] asset The asset to load.
+		//! @param[in] force_reload If this is `true`, every asset in the dependency closure is reloaded even if it is already loaded.
+		//! @return Returns one job ID that is finished when all assets in the dependency closure are loaded or failed to load.
+		//! Use `JobSystem::wait_job` or `JobSystem::is_job_finished` to wait for or check the completion. Returns `JobSystem::INVALID_JOB_ID`
+		//! if `asset` is null.
+		//! @remark Dependencies are reported by `AssetTypeDesc::on_get_asset_dependencies` once the asset data is loaded, and all reported 
+		//! dependencies are scheduled for loading at once, so assets of the same dependency level are loaded in parallel. Assets that are 
+		//! already loaded are not reloaded unless `force_reload` is `true`, but their dependencies are still checked. Every asset is visited 
+		//! at most once per call, so circular references are allowed. Loading errors of every asset can be fetched by `get_asset_loading_result`.
+		LUNA_ASSET_API JobSystem::job_id_t load_asset_recursive(asset_t asset, bool force_reload = false);
+
 		//! Creates one data object that contains the default data for the asset.
 		LUNA_ASSET_API RV load_asset_default_data(asset_t asset);
 
@@ -171,6 +213,90 @@ namespace Luna
 		//! Saves the asset synchronously.
 		LUNA_ASSET_API RV save_asset(asset_t asset);
 
+		//! Sets the memory budget for all loaded asset data.
+		//! @param[in] budget The budget in bytes. Pass `U64_MAX` to disable the budget, which is the default.
+		//! @remark When the memory cost of all loaded asset data exceeds the budget, the asset system unloads assets 
+		//! that are not referenced outside of the asset system in least-recently-used order until the memory cost is 
+		//! within the budget. The budget is checked when one asset data is loaded or set, and when the budget is changed. 
+		//! Assets referenced by any other `ObjRef` are never unloaded, so the memory cost may still exceed the budget 
+		//! if all loaded assets are in use.
+		//! 
+		//! One asset is used when its data is set, loaded or fetched by `get_asset_data`.
+		LUNA_ASSET_API void set_asset_memory_budget(u64 budget);
+
+		//! Gets the memory budget for all loaded asset data.
+		LUNA_ASSET_API u64 get_asset_memory_budget();
+
+		//! Unloads assets that are not referenced outside of the asset system in least-recently-used order, until the memory 
+		//! cost of all loaded asset data is not greater than `target_memory`.
+		//! @param[in] target_memory The memory cost in bytes to reach. Pass `0` to unload all unreferenced assets that have memory cost.
+		//! @return Returns the memory cost of unloaded assets in bytes.
+		LUNA_ASSET_API u64 evict_assets(u64 target_memory = 0);
+
+		struct AssetResidencyStatistics
+		{
+			//! The number of assets whose data is loaded.
+			usize num_resident_assets;
+			//! The memory cost of all loaded asset data in bytes.
+			u64 resident_memory;
+			//! The memory budget in bytes.
+			u64 memory_budget;
+			//! The number of assets unloaded by budget checks and `evict_assets` since the asset system is initialized.
+			usize num_evicted_assets;
+			//! The memory cost of assets unloaded by budget checks and `evict_assets` since the asset system is initialized.
+			u64 evicted_memory;
+			//! The number of evicted asset data objects that are waiting for their frames to complete before being released.
+			usize num_retired_assets;
+			//! The memory cost of evicted asset data objects that are waiting for their frames to complete before being released.
+			//! This is not counted in `resident_memory`.
+			u64 retired_memory;
+		};
+
+		//! Gets memory residency statistics of the asset system.
+		LUNA_ASSET_API AssetResidencyStatistics get_asset_residency_statistics();
+
+		//! Begins one new frame and releases data of assets evicted in completed frames.
+		//! @param[in] completed_frame The index of the last frame whose GPU work is known to be completed, or `0` if no 
+		//! frame is completed yet. Frame indices are returned by previous calls to this function.
+		//! @return Returns the index of the new frame. The first call returns `1`.
+		//! @remark Asset data may own GPU resources that are still used by command buffers in flight when the asset is evicted 
+		//! by budget checks or `evict_assets`. After this function is called once, evicted asset data is kept alive until the 
+		//! frame when it is evicted is completed, then released by the next call to this function. Before this function is 
+		//! called, evicted asset data is released immediately.
+		//! 
+		//! Asset data unloaded explicitly by `set_asset_data` or replaced by reloading is not deferred, the caller should make 
+		//! sure that the data is not used by the GPU in such case.
+		LUNA_ASSET_API u64 begin_asset_frame(u64 completed_frame);
+
+		//! Starts watching one directory for changes of asset files and asset meta files, so that changed assets can be 
+		//! reloaded by `update_asset_hot_reload`.
+		//! @param[in] dir The VFS path of the directory to watch.
+		//! @param[in] delay The time, in seconds, that one file must stay unchanged before its asset is reloaded. Multiple 
+		//! changes of one file within this time are coalesced into one reload.
+		//! @remark File changes are detected by `VFS::watch_dir`, which uses the file notification interface of the platform if 
+		//! available, and falls back to polling otherwise.
+		LUNA_ASSET_API RV enable_asset_hot_reload(const Path& dir, f64 delay = 0.2);
+
+		//! Stops watching one directory enabled by `enable_asset_hot_reload`. Changes detected but not processed are discarded.
+		LUNA_ASSET_API RV disable_asset_hot_reload(const Path& dir);
+
+		//! Processes file changes detected in all watched directories and reloads changed assets.
+		//! @return Returns the number of assets scheduled for reloading.
+		//! @remark This should be called periodically, for example once per frame. Changes are processed as follows:
+		//! * Added or modified asset meta files are loaded by `update_assets_meta`, so new assets are registered and 
+		//! changed asset types are applied. Added directories are scanned for new asset meta files in the same way.
+		//! * One changed file is mapped to the asset whose path is the file path with all extensions removed, 
+		//! one extension at a time, until one registered asset is found.
+		//! * Only loaded or loading assets are reloaded. Assets that are not loaded will read new data when they are loaded.
+		//! * Loaded assets that depend on reloaded assets, as reported by `AssetTypeDesc::on_get_asset_dependencies`, are 
+		//! also reloaded, recursively.
+		//! * Changes of one asset detected within two seconds after the asset system writes files of the asset (by `save_asset`, 
+		//! `move_asset`, `set_asset_type` or `new_asset`) are treated as changes made by the asset system and do not trigger reloading.
+		//! * If the watcher loses track of changes, all assets in the watched directory are reloaded.
+		//! 
+		//! Reloading is asynchronous and behaves like `load_asset` with `force_reload` set to `true`.
+		LUNA_ASSET_API usize update_asset_hot_reload();
+
 		//! Removes all registered assets and asset types.
 		LUNA_ASSET_API void close();
 	}
@@ -21,6 +21,11 @@
 #include <Luna/VariantUtils/JSON.hpp>
 #include <Luna/Runtime/Reflection.hpp>
 #include <Luna/VariantUtils/VariantUtils.hpp>
+#include <Luna/Runtime/Time.hpp>
+#include <Luna/Runtime/HashSet.hpp>
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/FileWatcher.hpp>
+#include <Luna/Runtime/Log.hpp>
 
 namespace Luna
 {
@@ -36,6 +41,55 @@ namespace Luna
 		Ref<IMutex> g_assets_mutex;
 		SelfIndexedHashMap<Guid, UniquePtr<AssetEntry>, AssetEntryExtractKey> g_assets;
 		HashMap<Path, asset_t> g_asset_path_mapping;
+
+		// Residency tracking.
+		volatile u64 g_asset_memory_budget;
+		volatile u64 g_resident_memory;
+		volatile usize g_num_resident_assets;
+		volatile u64 g_asset_use_counter;
+		// Protected by `g_assets_mutex`.
+		usize g_num_evicted_assets;
+		u64 g_evicted_memory;
+
+		// Deferred release of evicted asset data, protected by `g_assets_mutex`.
+		struct RetiredAssetData
+		{
+			ObjRef data;
+			u64 memory_cost;
+			//! The frame when the data is evicted.
+			u64 frame;
+		};
+		Vector<RetiredAssetData> g_retired_asset_data;
+		u64 g_retired_memory;
+		//! The index of the current frame, `0` if `begin_asset_frame` is never called.
+		u64 g_asset_frame;
+		//! The index of the last frame whose GPU work is completed.
+		u64 g_completed_asset_frame;
+
+		// Hot reload.
+		struct AssetWatch
+		{
+			Path dir;
+			Ref<IFileWatcher> watcher;
+			f64 delay;
+		};
+		struct PendingAssetFileChange
+		{
+			//! The time, in ticks, when the first change of the file is detected.
+			u64 first_change_ticks;
+			//! The time, in ticks, when the last change of the file is detected.
+			u64 last_change_ticks;
+			f64 delay;
+			FileChangeType type;
+			bool directory;
+		};
+		//! File changes detected within this time, in seconds, after the asset system writes asset files are ignored.
+		constexpr f64 ASSET_SELF_WRITE_IGNORE_TIME = 2.0;
+		Ref<IMutex> g_asset_hot_reload_mutex;
+		// Protected by `g_asset_hot_reload_mutex`.
+		Vector<AssetWatch> g_asset_watches;
+		HashMap<Path, PendingAssetFileChange> g_pending_asset_file_changes;
+
 		void init_asset_registry()
 		{
 			register_struct_type<AssetMetaFile>({
@@ -44,6 +98,16 @@ namespace Luna
 				});
 			set_serializable<AssetMetaFile>();
 			g_assets_mutex = new_mutex();
+			g_asset_hot_reload_mutex = new_mutex();
+			g_asset_memory_budget = U64_MAX;
+			g_resident_memory = 0;
+			g_num_resident_assets = 0;
+			g_asset_use_counter = 0;
+			g_num_evicted_assets = 0;
+			g_evicted_memory = 0;
+			g_retired_memory = 0;
+			g_asset_frame = 0;
+			g_completed_asset_frame = 0;
 		}
 		void close_asset_registry()
 		{
@@ -51,6 +115,101 @@ namespace Luna
 			g_assets.shrink_to_fit();
 			g_asset_path_mapping.clear();
 			g_asset_path_mapping.shrink_to_fit();
+			g_asset_watches.clear();
+			g_asset_watches.shrink_to_fit();
+			g_pending_asset_file_changes.clear();
+			g_pending_asset_file_changes.shrink_to_fit();
+			g_retired_asset_data.clear();
+			g_retired_asset_data.shrink_to_fit();
+			g_retired_memory = 0;
+			g_resident_memory = 0;
+			g_num_resident_assets = 0;
+		}
+		inline void touch_asset_entry(AssetEntry* entry)
+		{
+			entry->last_use = atom_inc_u64(&g_asset_use_counter);
+		}
+		//! Replaces the asset data and updates the residency tracking. `entry->lock` must be locked.
+		static void set_asset_entry_data(AssetEntry* entry, object_t data)
+		{
+			u64 memory_cost = 0;
+			if (data)
+			{
+				auto desc = get_asset_type_desc(entry->type);
+				if (succeeded(desc) && desc.get().on_get_asset_memory_cost)
+				{
+					memory_cost = desc.get().on_get_asset_memory_cost(desc.get().userdata.get(), asset_t(entry), data);
+				}
+				touch_asset_entry(entry);
+			}
+			if (data && !entry->data) atom_inc_usize(&g_num_resident_assets);
+			else if (!data && entry->data) atom_dec_usize(&g_num_resident_assets);
+			atom_add_u64(&g_resident_memory, (i64)(memory_cost - entry->memory_cost));
+			entry->memory_cost = memory_cost;
+			entry->data = data;
+		}
+		//! Unloads assets not referenced outside of the asset system in least-recently-used order until
+		//! the resident memory is not greater than `target_memory`. `g_assets_mutex` must be locked.
+		//! @param[in] keep One asset that should not be evicted, usually the asset that triggers the eviction.
+		static u64 internal_evict_assets(u64 target_memory, AssetEntry* keep)
+		{
+			struct EvictionCandidate
+			{
+				AssetEntry* entry;
+				u64 last_use;
+			};
+			Vector<EvictionCandidate> candidates;
+			for (auto& e : g_assets)
+			{
+				AssetEntry* entry = e.get();
+				if (entry == keep) continue;
+				LockGuard guard(entry->lock);
+				if (entry->data && entry->memory_cost && object_ref_count(entry->data.get()) == 1)
+				{
+					candidates.push_back({ entry, entry->last_use });
+				}
+			}
+			sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& lhs, const EvictionCandidate& rhs)
+				{
+					return lhs.last_use < rhs.last_use;
+				});
+			u64 evicted_memory = 0;
+			for (auto& candidate : candidates)
+			{
+				if (atom_add_u64(&g_resident_memory, 0) <= target_memory) break;
+				AssetEntry* entry = candidate.entry;
+				LockGuard guard(entry->lock);
+				// The asset may be used or referenced after it is collected.
+				if (!entry->data || entry->last_use != candidate.last_use || object_ref_count(entry->data.get()) != 1) continue;
+				auto desc = get_asset_type_desc(entry->type);
+				if (succeeded(desc) && desc.get().on_unload_asset_data)
+				{
+					desc.get().on_unload_asset_data(desc.get().userdata.get(), asset_t(entry));
+				}
+				u64 memory_cost = entry->memory_cost;
+				if (g_asset_frame > g_completed_asset_frame)
+				{
+					// GPU resources of the data may still be used by command buffers of frames in flight.
+					RetiredAssetData retired;
+					retired.data = entry->data;
+					retired.memory_cost = memory_cost;
+					retired.frame = g_asset_frame;
+					g_retired_asset_data.push_back(move(retired));
+					g_retired_memory += memory_cost;
+				}
+				set_asset_entry_data(entry, nullptr);
+				evicted_memory += memory_cost;
+				++g_num_evicted_assets;
+			}
+			g_evicted_memory += evicted_memory;
+			return evicted_memory;
+		}
+		//! Evicts assets if the resident memory exceeds the budget. No asset entry lock should be locked by the caller.
+		static void check_asset_memory_budget(AssetEntry* keep)
+		{
+			if (atom_add_u64(&g_resident_memory, 0) <= atom_add_u64(&g_asset_memory_budget, 0)) return;
+			MutexGuard guard(g_assets_mutex);
+			internal_evict_assets(g_asset_memory_budget, keep);
 		}
 		inline RV save_asset_meta(const AssetMetaFile& file, const Path& path)
 		{
@@ -83,6 +242,7 @@ namespace Luna
 			if (failed(r)) return r.errcode();
 			entry->path = path;
 			entry->type = type;
+			entry->last_write_ticks = get_ticks();
 			g_asset_path_mapping.insert(make_pair(path, ret));
 			return ret;
 		}
@@ -114,34 +274,181 @@ namespace Luna
 			return file;
 		}
 
-		static RV recursive_load_asset_meta(const Path& directory, Vector<AssetMetaUpdateInfo>& assets)
+		//! The number of meta files parsed by one job.
+		constexpr usize META_FILES_PER_JOB = 16;
+
+		struct AssetMetaLoadContext
 		{
-			lutry
+			SpinLock lock;
+			//! Loaded metadata merged from all jobs. Protected by `lock`.
+			Vector<AssetMetaUpdateInfo> assets;
+			//! The first error reported by any job. Protected by `lock`.
+			Error error;
+			//! Set to `true` when any job fails, so that jobs still pending can skip their work.
+			volatile u32 failed = 0;
+			volatile usize num_directories = 0;
+			//! Accumulated job times in ticks.
+			volatile u64 scan_ticks = 0;
+			volatile u64 parse_ticks = 0;
+
+			void report_error(ErrCode err)
 			{
-				lulet(iter, VFS::open_dir(directory));
-				Path path = directory;
-				for(; iter->is_valid(); iter->move_next())
+				LockGuard guard(lock);
+				if (failed) return;
+				if (err == BasicError::error_object())
 				{
-                    const c8* filename = iter->get_filename();
-                    if(!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
-					path.push_back(filename);
-					if(test_flags(iter->get_attributes(), FileAttributeFlag::directory))
+					error = get_error();
+				}
+				else
+				{
+					error.code = err;
+					error.message.clear();
+				}
+				failed = 1;
+			}
+		};
+
+		struct ParseAssetMetaJob
+		{
+			AssetMetaLoadContext* ctx;
+			//! Paths of meta files to parse.
+			Vector<Path> meta_paths;
+
+			static void run(void* params)
+			{
+				ParseAssetMetaJob* job = (ParseAssetMetaJob*)params;
+				AssetMetaLoadContext* ctx = job->ctx;
+				if (!atom_add_u32(&ctx->failed, 0))
+				{
+					u64 begin_ticks = get_ticks();
+					Vector<AssetMetaUpdateInfo> assets;
+					assets.reserve(job->meta_paths.size());
+					lutry
 					{
-						luexp(recursive_load_asset_meta(path, assets));
+						for (auto& path : job->meta_paths)
+						{
+							lulet(meta_file, internal_load_asset_meta(path));
+							AssetMetaUpdateInfo info;
+							info.path = move(path);
+							info.path.remove_extension();
+							info.meta_file = move(meta_file);
+							assets.push_back(move(info));
+						}
+						// Merge results of this job in one batch.
+						LockGuard guard(ctx->lock);
+						ctx->assets.reserve(ctx->assets.size() + assets.size());
+						for (auto& info : assets)
+						{
+							ctx->assets.push_back(move(info));
+						}
 					}
-					else if(path.extension() == "meta")
+					lucatch
 					{
-						lulet(meta_file, internal_load_asset_meta(path));
-						AssetMetaUpdateInfo info;
-						path.remove_extension();
-						info.path = path;
-						info.meta_file = move(meta_file);
-						assets.push_back(move(info));
+						ctx->report_error(luerr);
 					}
-					path.pop_back();
+					atom_add_u64(&ctx->parse_ticks, (i64)(get_ticks() - begin_ticks));
 				}
+				job->~ParseAssetMetaJob();
 			}
-			lucatchret;
+		};
+
+		struct ScanAssetDirectoryJob
+		{
+			AssetMetaLoadContext* ctx;
+			Path directory;
+
+			static void run(void* params);
+		};
+
+		static void submit_parse_asset_meta_job(AssetMetaLoadContext* ctx, Vector<Path>&& meta_paths, void* parent)
+		{
+			ParseAssetMetaJob* job = (ParseAssetMetaJob*)JobSystem::new_job(ParseAssetMetaJob::run, sizeof(ParseAssetMetaJob), alignof(ParseAssetMetaJob), parent);
+			new (job) ParseAssetMetaJob();
+			job->ctx = ctx;
+			job->meta_paths = move(meta_paths);
+			JobSystem::submit_job(job);
+		}
+
+		static void submit_scan_asset_directory_job(AssetMetaLoadContext* ctx, const Path& directory, void* parent)
+		{
+			ScanAssetDirectoryJob* job = (ScanAssetDirectoryJob*)JobSystem::new_job(ScanAssetDirectoryJob::run, sizeof(ScanAssetDirectoryJob), alignof(ScanAssetDirectoryJob), parent);
+			new (job) ScanAssetDirectoryJob();
+			job->ctx = ctx;
+			job->directory = directory;
+			JobSystem::submit_job(job);
+		}
+
+		void ScanAssetDirectoryJob::run(void* params)
+		{
+			ScanAssetDirectoryJob* job = (ScanAssetDirectoryJob*)params;
+			AssetMetaLoadContext* ctx = job->ctx;
+			if (!atom_add_u32(&ctx->failed, 0))
+			{
+				u64 begin_ticks = get_ticks();
+				atom_inc_usize(&ctx->num_directories);
+				lutry
+				{
+					lulet(iter, VFS::open_dir(job->directory));
+					Path path = job->directory;
+					Vector<Path> meta_paths;
+					for (; iter->is_valid(); iter->move_next())
+					{
+						const c8* filename = iter->get_filename();
+						if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+						path.push_back(filename);
+						if (test_flags(iter->get_attributes(), FileAttributeFlag::directory))
+						{
+							// Child jobs are attached to this job, so waiting for the root job waits for the whole tree.
+							submit_scan_asset_directory_job(ctx, path, params);
+						}
+						else if (path.extension() == "meta")
+						{
+							meta_paths.push_back(path);
+							if (meta_paths.size() == META_FILES_PER_JOB)
+							{
+								submit_parse_asset_meta_job(ctx, move(meta_paths), params);
+								meta_paths.clear();
+							}
+						}
+						path.pop_back();
+					}
+					if (!meta_paths.empty())
+					{
+						submit_parse_asset_meta_job(ctx, move(meta_paths), params);
+					}
+				}
+				lucatch
+				{
+					ctx->report_error(luerr);
+				}
+				atom_add_u64(&ctx->scan_ticks, (i64)(get_ticks() - begin_ticks));
+			}
+			job->~ScanAssetDirectoryJob();
+		}
+
+		static RV parallel_load_asset_meta(const Path& directory, Vector<AssetMetaUpdateInfo>& assets, AssetMetaUpdateStatistics* statistics)
+		{
+			AssetMetaLoadContext ctx;
+			ScanAssetDirectoryJob* root = (ScanAssetDirectoryJob*)JobSystem::new_job(ScanAssetDirectoryJob::run, sizeof(ScanAssetDirectoryJob), alignof(ScanAssetDirectoryJob));
+			new (root) ScanAssetDirectoryJob();
+			root->ctx = &ctx;
+			root->directory = directory;
+			JobSystem::job_id_t root_job = JobSystem::submit_job(root);
+			JobSystem::wait_job(root_job);
+			if (statistics)
+			{
+				f64 ticks_per_second = get_ticks_per_second();
+				statistics->num_directories = ctx.num_directories;
+				statistics->scan_job_time = (f64)ctx.scan_ticks / ticks_per_second;
+				statistics->parse_job_time = (f64)ctx.parse_ticks / ticks_per_second;
+			}
+			if (ctx.failed)
+			{
+				if (ctx.error.message.empty()) return ctx.error.code;
+				get_error() = move(ctx.error);
+				return BasicError::error_object();
+			}
+			assets = move(ctx.assets);
 			return ok;
 		}
 
@@ -153,8 +460,10 @@ namespace Luna
 			return AssetState::unloaded;
 		}
 
-		LUNA_ASSET_API RV update_assets_meta(const Path& path, bool allow_overwrite)
+		LUNA_ASSET_API RV update_assets_meta(const Path& path, bool allow_overwrite, AssetMetaUpdateStatistics* statistics)
 		{
+			f64 ticks_per_second = get_ticks_per_second();
+			u64 collect_begin_ticks = get_ticks();
 			lutry
 			{
 				// Collect assets to be updated.
@@ -162,7 +471,7 @@ namespace Luna
 				auto attr = VFS::get_file_attribute(path);
 				if(succeeded(attr) && test_flags(attr.get().attributes, FileAttributeFlag::directory))
 				{
-					luexp(recursive_load_asset_meta(path, update_assets));
+					luexp(parallel_load_asset_meta(path, update_assets, statistics));
 				}
 				else
 				{
@@ -174,11 +483,25 @@ namespace Luna
 					info.meta_file = move(meta_file);
 					update_assets.push_back(move(info));
 				}
-				// Do update.
+				u64 register_begin_ticks = get_ticks();
+				// Register all loaded metadata in one batch.
 				MutexGuard g(g_assets_mutex);
+				g_asset_path_mapping.reserve(g_asset_path_mapping.size() + update_assets.size());
 				for(auto& info : update_assets)
 				{
-					auto asset = get_asset(info.meta_file.guid);
+					asset_t asset;
+					auto iter = info.meta_file.guid == Guid(0, 0) ? g_assets.end() : g_assets.find(info.meta_file.guid);
+					if (iter != g_assets.end())
+					{
+						asset.handle = iter->get();
+					}
+					else
+					{
+						UniquePtr<AssetEntry> new_entry(memnew<AssetEntry>());
+						new_entry->guid = info.meta_file.guid == Guid(0, 0) ? random_guid() : info.meta_file.guid;
+						asset.handle = new_entry.get();
+						g_assets.insert(move(new_entry));
+					}
 					AssetEntry* entry = (AssetEntry*)asset.handle;
 					LockGuard g2(entry->lock);
 					auto state = internal_get_asset_state(entry);
@@ -193,10 +516,17 @@ namespace Luna
 							}
 						}
 						entry->type = info.meta_file.type;
-						entry->path = info.path;
+						entry->path = move(info.path);
 						g_asset_path_mapping.insert(make_pair(entry->path, asset));
 					}
 				}
+				if (statistics)
+				{
+					u64 end_ticks = get_ticks();
+					statistics->num_meta_files = update_assets.size();
+					statistics->collect_time = (f64)(register_begin_ticks - collect_begin_ticks) / ticks_per_second;
+					statistics->register_time = (f64)(end_ticks - register_begin_ticks) / ticks_per_second;
+				}
 			}
 			lucatchret;
 			return ok;
@@ -274,6 +604,7 @@ namespace Luna
 			auto r = save_asset_meta(file, entry->path);
 			if (failed(r)) return r.errcode();
 			entry->type = type;
+			entry->last_write_ticks = get_ticks();
 			return ok;
 		}
 		LUNA_ASSET_API R<Vector<Name>> get_asset_files(asset_t asset)
@@ -331,6 +662,7 @@ namespace Luna
 				}
 				AssetEntry* entry = (AssetEntry*)asset.handle;
 				LockGuard guard(entry->lock);
+				set_asset_entry_data(entry, nullptr);
 				entry->reset();
 			}
 			lucatchret;
@@ -371,6 +703,7 @@ namespace Luna
 				g_asset_path_mapping.erase(entry->path);
 				entry->path = new_path;
 				g_asset_path_mapping.insert(make_pair(entry->path, asset));
+				entry->last_write_ticks = get_ticks();
 			}
 			lucatchret;
 			return ok;
@@ -403,9 +736,10 @@ namespace Luna
 				entry->lock.lock();
 				if (entry->last_load_job == JobSystem::get_current_job_id(params))
 				{
-					entry->data = data;
+					set_asset_entry_data(entry, data.get());
 				}
 				entry->lock.unlock();
+				check_asset_memory_budget(entry);
 			}
 			lucatch
 			{
@@ -431,7 +765,7 @@ namespace Luna
 			asset_t* params = (asset_t*)JobSystem::new_job(load_asset_job, sizeof(asset_t), alignof(asset_t));
 			params->handle = entry;
 			entry->last_load_result.reset();
-			entry->data.reset();
+			set_asset_entry_data(entry, nullptr);
 			entry->last_load_job = JobSystem::submit_job(params);
 		}
 		LUNA_ASSET_API ObjRef get_asset_data(asset_t asset, bool trigger_load, bool block_until_loaded)
@@ -449,6 +783,7 @@ namespace Luna
 				JobSystem::wait_job(entry->last_load_job);
 				g = entry->lock;
 			}
+			if (entry->data) touch_asset_entry(entry);
 			return entry->data;
 		}
 		LUNA_ASSET_API RV set_asset_data(asset_t asset, object_t data)
@@ -474,7 +809,9 @@ namespace Luna
 				}
 			}
 			lucatchret;
-			entry->data = data;
+			set_asset_entry_data(entry, data);
+			g.unlock();
+			check_asset_memory_budget(entry);
 			return ok;
 		}
 		LUNA_ASSET_API void load_asset(asset_t asset, bool force_reload)
@@ -483,6 +820,108 @@ namespace Luna
 			LockGuard g(entry->lock);
 			internal_load_asset(entry, force_reload);
 		}
+		struct RecursiveLoadContext
+		{
+			SpinLock lock;
+			//! Assets already scheduled by this request. Protected by `lock`.
+			HashSet<opaque_t> visited;
+			bool force_reload;
+			//! Released by every job of this request and by `load_asset_recursive`.
+			volatile u32 ref_count;
+		};
+
+		inline void release_recursive_load_context(RecursiveLoadContext* ctx)
+		{
+			if (!atom_dec_u32(&ctx->ref_count))
+			{
+				memdelete(ctx);
+			}
+		}
+
+		struct RecursiveLoadJob
+		{
+			RecursiveLoadContext* ctx;
+			asset_t asset;
+
+			static void run(void* params);
+		};
+
+		static JobSystem::job_id_t submit_recursive_load_job(RecursiveLoadContext* ctx, asset_t asset, void* parent)
+		{
+			{
+				LockGuard guard(ctx->lock);
+				if (!ctx->visited.insert(asset.handle).second) return JobSystem::INVALID_JOB_ID;
+			}
+			atom_inc_u32(&ctx->ref_count);
+			// Dependency jobs are attached to the job that discovers them, so the root job is finished only
+			// after the whole dependency closure is finished.
+			RecursiveLoadJob* job = (RecursiveLoadJob*)JobSystem::new_job(RecursiveLoadJob::run, sizeof(RecursiveLoadJob), alignof(RecursiveLoadJob), parent);
+			job->ctx = ctx;
+			job->asset = asset;
+			return JobSystem::submit_job(job);
+		}
+
+		void RecursiveLoadJob::run(void* params)
+		{
+			RecursiveLoadJob* job = (RecursiveLoadJob*)params;
+			RecursiveLoadContext* ctx = job->ctx;
+			AssetEntry* entry = (AssetEntry*)job->asset.handle;
+			// The asset data is loaded by one standalone job, so that waiting for it never waits for
+			// dependency jobs of other requests.
+			entry->lock.lock();
+			internal_load_asset(entry, ctx->force_reload);
+			JobSystem::job_id_t load_job = entry->last_load_job;
+			entry->lock.unlock();
+			JobSystem::wait_job(load_job);
+			entry->lock.lock();
+			ObjRef data = entry->data;
+			Name type = entry->type;
+			entry->lock.unlock();
+			if (data)
+			{
+				Vector<asset_t> dependencies;
+				lutry
+				{
+					lulet(desc, get_asset_type_desc(type));
+					if (desc.on_get_asset_dependencies)
+					{
+						luexp(desc.on_get_asset_dependencies(desc.userdata.get(), job->asset, data.get(), dependencies));
+					}
+				}
+				lucatch
+				{
+					entry->lock.lock();
+					if (luerr == BasicError::error_object())
+					{
+						entry->last_load_result = get_error();
+					}
+					else
+					{
+						entry->last_load_result.code = luerr;
+					}
+					entry->lock.unlock();
+				}
+				for (asset_t dependency : dependencies)
+				{
+					if (dependency)
+					{
+						submit_recursive_load_job(ctx, dependency, params);
+					}
+				}
+			}
+			release_recursive_load_context(ctx);
+		}
+
+		LUNA_ASSET_API JobSystem::job_id_t load_asset_recursive(asset_t asset, bool force_reload)
+		{
+			if (!asset) return JobSystem::INVALID_JOB_ID;
+			RecursiveLoadContext* ctx = memnew<RecursiveLoadContext>();
+			ctx->force_reload = force_reload;
+			ctx->ref_count = 1;
+			JobSystem::job_id_t ret = submit_recursive_load_job(ctx, asset, nullptr);
+			release_recursive_load_context(ctx);
+			return ret;
+		}
 		LUNA_ASSET_API RV load_asset_default_data(asset_t asset)
 		{
 			AssetEntry* entry = (AssetEntry*)asset.handle;
@@ -503,9 +942,11 @@ namespace Luna
 				{
 					luthrow(set_error(BasicError::not_supported(), "Asset Default Data Loading is not Implemented by Asset %s", entry->type.c_str()));
 				}
-				entry->data = data;
+				set_asset_entry_data(entry, data.get());
 			}
 			lucatchret;
+			g.unlock();
+			check_asset_memory_budget(entry);
 			return ok;
 		}
 		LUNA_ASSET_API AssetState get_asset_state(asset_t asset)
@@ -544,6 +985,9 @@ namespace Luna
 				if (desc.on_save_asset)
 				{
 					luexp(desc.on_save_asset(desc.userdata.get(), asset, path, data.get()));
+					g = entry->lock;
+					entry->last_write_ticks = get_ticks();
+					g.unlock();
 				}
 				else
 				{
@@ -553,6 +997,306 @@ namespace Luna
 			lucatchret;
 			return ok;
 		}
+		LUNA_ASSET_API void set_asset_memory_budget(u64 budget)
+		{
+			MutexGuard guard(g_assets_mutex);
+			g_asset_memory_budget = budget;
+			if (g_resident_memory > budget)
+			{
+				internal_evict_assets(budget, nullptr);
+			}
+		}
+		LUNA_ASSET_API u64 get_asset_memory_budget()
+		{
+			return atom_add_u64(&g_asset_memory_budget, 0);
+		}
+		LUNA_ASSET_API u64 evict_assets(u64 target_memory)
+		{
+			MutexGuard guard(g_assets_mutex);
+			return internal_evict_assets(target_memory, nullptr);
+		}
+		LUNA_ASSET_API AssetResidencyStatistics get_asset_residency_statistics()
+		{
+			MutexGuard guard(g_assets_mutex);
+			AssetResidencyStatistics ret;
+			ret.num_resident_assets = g_num_resident_assets;
+			ret.resident_memory = g_resident_memory;
+			ret.memory_budget = g_asset_memory_budget;
+			ret.num_evicted_assets = g_num_evicted_assets;
+			ret.evicted_memory = g_evicted_memory;
+			ret.num_retired_assets = g_retired_asset_data.size();
+			ret.retired_memory = g_retired_memory;
+			return ret;
+		}
+		LUNA_ASSET_API u64 begin_asset_frame(u64 completed_frame)
+		{
+			Vector<RetiredAssetData> released;
+			u64 frame;
+			{
+				MutexGuard guard(g_assets_mutex);
+				g_completed_asset_frame = max(g_completed_asset_frame, completed_frame);
+				auto iter = g_retired_asset_data.begin();
+				while (iter != g_retired_asset_data.end())
+				{
+					if (iter->frame <= g_completed_asset_frame)
+					{
+						g_retired_memory -= iter->memory_cost;
+						released.push_back(move(*iter));
+						iter = g_retired_asset_data.erase(iter);
+					}
+					else ++iter;
+				}
+				frame = ++g_asset_frame;
+			}
+			// Asset data is released without locking, since releasing data may access other assets.
+			released.clear();
+			return frame;
+		}
+		LUNA_ASSET_API RV enable_asset_hot_reload(const Path& dir, f64 delay)
+		{
+			MutexGuard guard(g_asset_hot_reload_mutex);
+			for (auto& watch : g_asset_watches)
+			{
+				if (watch.dir == dir) return BasicError::already_exists();
+			}
+			lutry
+			{
+				AssetWatch watch;
+				luset(watch.watcher, VFS::watch_dir(dir));
+				watch.dir = dir;
+				watch.delay = delay;
+				g_asset_watches.push_back(move(watch));
+			}
+			lucatchret;
+			return ok;
+		}
+		LUNA_ASSET_API RV disable_asset_hot_reload(const Path& dir)
+		{
+			MutexGuard guard(g_asset_hot_reload_mutex);
+			for (auto iter = g_asset_watches.begin(); iter != g_asset_watches.end(); ++iter)
+			{
+				if (iter->dir == dir)
+				{
+					g_asset_watches.erase(iter);
+					for (auto change = g_pending_asset_file_changes.begin(); change != g_pending_asset_file_changes.end();)
+					{
+						if (change->first.is_subpath_of(dir)) change = g_pending_asset_file_changes.erase(change);
+						else ++change;
+					}
+					return ok;
+				}
+			}
+			return BasicError::not_found();
+		}
+		//! Finds the asset that owns the specified file by removing file extensions one at a time. 
+		//! `g_assets_mutex` must be locked.
+		static asset_t find_asset_by_file_path(Path path)
+		{
+			while (!path.empty())
+			{
+				auto iter = g_asset_path_mapping.find(path);
+				if (iter != g_asset_path_mapping.end()) return iter->second;
+				if (path.extension().empty()) break;
+				path.remove_extension();
+			}
+			return asset_t();
+		}
+		struct AssetHotReloadContext
+		{
+			HashSet<opaque_t> reload_set;
+			Vector<AssetEntry*> reload_list;
+			u64 ignore_ticks;
+
+			//! Adds one asset to be reloaded. `change_ticks` is the time when the change is first detected.
+			void add(AssetEntry* entry, u64 change_ticks)
+			{
+				if (reload_set.contains(entry)) return;
+				LockGuard guard(entry->lock);
+				AssetState state = internal_get_asset_state(entry);
+				if (state != AssetState::loaded && state != AssetState::loading) return;
+				if (entry->last_write_ticks && change_ticks >= entry->last_write_ticks &&
+					change_ticks - entry->last_write_ticks < ignore_ticks) return;
+				reload_set.insert(entry);
+				reload_list.push_back(entry);
+			}
+		};
+		//! Adds loaded assets that depend on assets in `ctx.reload_set` to `ctx`, recursively.
+		static void add_asset_dependents(AssetHotReloadContext& ctx)
+		{
+			struct LoadedAsset
+			{
+				AssetEntry* entry;
+				ObjRef data;
+				Name type;
+				Vector<asset_t> dependencies;
+			};
+			Vector<LoadedAsset> loaded_assets;
+			{
+				MutexGuard guard(g_assets_mutex);
+				for (auto& e : g_assets)
+				{
+					AssetEntry* entry = e.get();
+					if (ctx.reload_set.contains(entry)) continue;
+					LockGuard entry_guard(entry->lock);
+					if (!entry->data) continue;
+					LoadedAsset loaded_asset;
+					loaded_asset.entry = entry;
+					loaded_asset.data = entry->data;
+					loaded_asset.type = entry->type;
+					loaded_assets.push_back(move(loaded_asset));
+				}
+			}
+			// Dependencies are fetched without locking, since asset types may access other assets.
+			for (auto& loaded_asset : loaded_assets)
+			{
+				auto desc = get_asset_type_desc(loaded_asset.type);
+				if (succeeded(desc) && desc.get().on_get_asset_dependencies)
+				{
+					RV r = desc.get().on_get_asset_dependencies(desc.get().userdata.get(), asset_t(loaded_asset.entry),
+						loaded_asset.data.get(), loaded_asset.dependencies);
+					if (failed(r))
+					{
+						// The asset is still reloaded, but assets depending on it may not be reloaded.
+						LockGuard entry_guard(loaded_asset.entry->lock);
+						log_error("Asset", "Failed to get dependencies of asset %s: %s",
+							loaded_asset.entry->path.encode().c_str(), explain(r.errcode()));
+					}
+				}
+			}
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				for (auto& loaded_asset : loaded_assets)
+				{
+					if (ctx.reload_set.contains(loaded_asset.entry)) continue;
+					for (asset_t dependency : loaded_asset.dependencies)
+					{
+						if (ctx.reload_set.contains(dependency.handle))
+						{
+							ctx.reload_set.insert(loaded_asset.entry);
+							ctx.reload_list.push_back(loaded_asset.entry);
+							changed = true;
+							break;
+						}
+					}
+				}
+			}
+		}
+		LUNA_ASSET_API usize update_asset_hot_reload()
+		{
+			MutexGuard guard(g_asset_hot_reload_mutex);
+			u64 now = get_ticks();
+			f64 ticks_per_second = get_ticks_per_second();
+			// Collect changes. Changes of the same file are coalesced until the file stays unchanged for the delay time.
+			Vector<FileChange> changes;
+			for (auto& watch : g_asset_watches)
+			{
+				changes.clear();
+				auto r = watch.watcher->read_changes(changes);
+				if (failed(r))
+				{
+					// Changes may be lost, so treats every file in the directory as changed.
+					changes.push_back({ Path(), FileChangeType::modified, true });
+				}
+				for (auto& change : changes)
+				{
+					Path path = watch.dir;
+					path.append(change.path);
+					bool directory = change.directory || change.path.empty();
+					auto iter = g_pending_asset_file_changes.find(path);
+					if (iter == g_pending_asset_file_changes.end())
+					{
+						PendingAssetFileChange pending;
+						pending.first_change_ticks = now;
+						pending.last_change_ticks = now;
+						pending.delay = watch.delay;
+						pending.type = change.type;
+						pending.directory = directory;
+						g_pending_asset_file_changes.insert(make_pair(move(path), pending));
+					}
+					else
+					{
+						iter->second.last_change_ticks = now;
+						// Losing track of changes of one directory cannot be overwritten by other changes.
+						if (!iter->second.directory || iter->second.type != FileChangeType::modified)
+						{
+							iter->second.type = change.type;
+							iter->second.directory = directory;
+						}
+					}
+				}
+			}
+			Vector<Pair<Path, PendingAssetFileChange>> ready_changes;
+			for (auto iter = g_pending_asset_file_changes.begin(); iter != g_pending_asset_file_changes.end();)
+			{
+				if ((f64)(now - iter->second.last_change_ticks) >= iter->second.delay * ticks_per_second)
+				{
+					ready_changes.push_back(make_pair(iter->first, iter->second));
+					iter = g_pending_asset_file_changes.erase(iter);
+				}
+				else ++iter;
+			}
+			if (ready_changes.empty()) return 0;
+			// Register new and changed meta files first, so that changes of new assets can be mapped to assets.
+			for (auto& change : ready_changes)
+			{
+				if (change.second.type == FileChangeType::removed) continue;
+				if (change.second.directory)
+				{
+					RV r = update_assets_meta(change.first);
+					if (failed(r))
+					{
+						log_error("Asset", "Failed to update asset meta files in %s: %s", change.first.encode().c_str(), explain(r.errcode()));
+					}
+				}
+				else if (change.first.extension() == "meta")
+				{
+					Path asset_path = change.first;
+					asset_path.remove_extension();
+					RV r = update_assets_meta(asset_path);
+					if (failed(r))
+					{
+						log_error("Asset", "Failed to update asset meta file of %s: %s", asset_path.encode().c_str(), explain(r.errcode()));
+					}
+				}
+			}
+			AssetHotReloadContext ctx;
+			ctx.ignore_ticks = (u64)(ASSET_SELF_WRITE_IGNORE_TIME * ticks_per_second);
+			{
+				MutexGuard assets_guard(g_assets_mutex);
+				for (auto& change : ready_changes)
+				{
+					if (change.second.type == FileChangeType::removed) continue;
+					if (change.second.directory)
+					{
+						if (change.second.type != FileChangeType::modified) continue;
+						// The watcher lost track of changes, reload all assets in the directory.
+						for (auto& asset : g_asset_path_mapping)
+						{
+							if (asset.first.is_subpath_of(change.first))
+							{
+								ctx.add((AssetEntry*)asset.second.handle, change.second.first_change_ticks);
+							}
+						}
+						continue;
+					}
+					asset_t asset = find_asset_by_file_path(change.first);
+					if (asset)
+					{
+						ctx.add((AssetEntry*)asset.handle, change.second.first_change_ticks);
+					}
+				}
+			}
+			if (ctx.reload_list.empty()) return 0;
+			add_asset_dependents(ctx);
+			for (AssetEntry* entry : ctx.reload_list)
+			{
+				LockGuard entry_guard(entry->lock);
+				internal_load_asset(entry, true);
+			}
+			return ctx.reload_list.size();
+		}
 		LUNA_ASSET_API void close()
 		{
 			MutexGuard guard(g_assets_mutex);
@@ -602,6 +1346,7 @@ namespace Luna
 				close_asset_type();
 				g_assets_mutex.reset();
 				g_asset_types_mutex.reset();
+				g_asset_hot_reload_mutex.reset();
 			}
 		};
 	}
@@ -33,9 +33,19 @@ namespace Luna
 			ObjRef data;
 			JobSystem::job_id_t last_load_job;
 			Error last_load_result;
+			//! The memory cost of `data` reported by the asset type.
+			u64 memory_cost;
+			//! The use stamp of the last use, used for least-recently-used eviction.
+			u64 last_use;
+			//! The time, in ticks, when asset files are last written by the asset system, used to ignore 
+			//! file changes made by the asset system when hot reloading assets.
+			u64 last_write_ticks;
 			SpinLock lock;
 			AssetEntry() :
-				last_load_job(JobSystem::INVALID_JOB_ID) {}
+				last_load_job(JobSystem::INVALID_JOB_ID),
+				memory_cost(0),
+				last_use(0),
+				last_write_ticks(0) {}
 			void reset()
 			{
 				type.reset();
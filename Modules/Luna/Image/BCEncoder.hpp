@@ -0,0 +1,68 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file BCEncoder.hpp
+* @author JXMaster
+* @date 2026/10/19
+* @brief Block compression (BCn) encoders.
+*/
+#pragma once
+#include "Image.hpp"
+#include "DDSImage.hpp"
+
+namespace Luna
+{
+	namespace Image
+	{
+		//! Specifies the trade-off between encoding speed and quality of block compression.
+		//! @details The quality only controls how endpoints are searched, it does not change the block mode of one format:
+		//! BC6H blocks are always encoded with mode 11 and BC7 blocks are always encoded with mode 6, see @ref is_bc_encoding_supported.
+		//! Blocks that contain multiple distinct colors are therefore encoded with lower quality than encoders that search 
+		//! multi-region (BC6H) or multi-subset (BC7) modes, even with `high` quality.
+		enum class BCQuality : u8
+		{
+			//! Computes endpoints from the principal axis of every block only. BC7 p-bits are selected for every endpoint 
+			//! independently.
+			fast = 0,
+			//! Refines endpoints once using least squares fitting. BC7 blocks try all p-bit combinations.
+			normal = 1,
+			//! Refines endpoints up to three times using least squares fitting. BC4 and BC5 blocks also try the 6-value mode, 
+			//! which encodes 0 and 1 exactly.
+			high = 2,
+		};
+
+		//! Checks whether the specified format can be encoded by `encode_bc_image`.
+		//! @details The supported formats are BC1, BC3, BC4 (unorm), BC5 (unorm), BC6H and BC7.
+		//! BC6H blocks are encoded with the single-region 10-bit mode (mode 11), BC7 blocks are encoded with the
+		//! single-subset RGBA mode (mode 6).
+		LUNA_IMAGE_API bool is_bc_encoding_supported(DDSFormat format);
+
+		//! Encodes one image to blocks of the specified block compression format.
+		//! @details The image is split into 4x4 blocks, pixels outside of the image are filled by repeating border pixels.
+		//! Channels not present in the source format are filled with 0, alpha is filled with 1. Values of `unorm` formats
+		//! are encoded as-is, so sRGB images should be encoded to `_srgb` formats. Block rows are encoded in parallel using the
+		//! job system.
+		//! @param[in] desc The descriptor of the source image.
+		//! @param[in] image_data The source pixel data. Rows are tightly packed.
+		//! @param[in] format The block compression format to encode to.
+		//! @param[in] quality The encoding quality.
+		//! @param[out] dst The buffer to write encoded blocks to. The buffer must be large enough to hold
+		//! `ceil(height / 4)` rows of blocks.
+		//! @param[in] dst_row_pitch The number of bytes between two rows of blocks in `dst`.
+		LUNA_IMAGE_API RV encode_bc_image(const ImageDesc& desc, const void* image_data, DDSFormat format, BCQuality quality, void* dst, usize dst_row_pitch);
+
+		//! Creates one 2D DDS image by encoding the specified image and its mipmaps to the specified block compression format.
+		//! @details Mipmaps are generated by @ref generate_mipmaps using Kaiser filter, in sRGB color space if `format` is
+		//! one `_srgb` format.
+		//! @param[in] desc The descriptor of the source image.
+		//! @param[in] image_data The source pixel data. Rows are tightly packed.
+		//! @param[in] format The block compression format to encode to.
+		//! @param[in] mip_levels The number of mip levels of the DDS image. Specify `0` to generate the full mipmap chain.
+		//! @param[in] quality The encoding quality.
+		//! @return Returns the encoded DDS image.
+		LUNA_IMAGE_API R<DDSImage> encode_bc_dds_image(const ImageDesc& desc, const void* image_data, DDSFormat format,
+			u32 mip_levels = 0, BCQuality quality = BCQuality::normal);
+	}
+}
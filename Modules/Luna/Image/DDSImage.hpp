@@ -350,8 +350,34 @@ namespace Luna
                 desc({}) {}
         };
 
+        //! Describes one box region in one DDS subresource.
+        struct DDSRegion
+        {
+            u32 x;
+            u32 y;
+            u32 z;
+            u32 width;
+            u32 height;
+            u32 depth;
+        };
+
         LUNA_IMAGE_API R<DDSImage> new_dds_image(const DDSImageDesc& desc);
         LUNA_IMAGE_API R<DDSImageDesc> read_dds_image_file_desc(const void* data, usize data_size);
+        //! Reads the DDS image descriptor from the file header without reading pixel data.
+        //! @param[in] stream The stream to read. The header is read from the beginning of the stream.
+        LUNA_IMAGE_API R<DDSImageDesc> read_dds_image_file_desc(ISeekableStream* stream);
+        //! Reads pixels of one region of one DDS subresource from the file, without reading other pixels.
+        //! @param[in] stream The stream of the DDS file.
+        //! @param[in] desc The image descriptor read by `read_dds_image_file_desc`.
+        //! @param[in] mip_slice The mip level of the subresource.
+        //! @param[in] array_slice The array index of the subresource.
+        //! @param[in] region The region to read in pixels. For block-compressed formats, the region must be aligned to
+        //! block boundaries, unless it reaches the right or bottom edge of the subresource.
+        //! @param[out] dst The buffer to write pixels to. For block-compressed formats, every row in `dst` stores one row of blocks.
+        //! @param[in] dst_row_pitch The number of bytes between two rows in `dst`.
+        //! @param[in] dst_slice_pitch The number of bytes between two depth slices in `dst`.
+        LUNA_IMAGE_API RV read_dds_image_region(ISeekableStream* stream, const DDSImageDesc& desc, u32 mip_slice, u32 array_slice,
+            const DDSRegion& region, void* dst, usize dst_row_pitch, usize dst_slice_pitch);
         LUNA_IMAGE_API R<DDSImage> read_dds_image(const void* data, usize data_size);
         LUNA_IMAGE_API RV write_dds_file(ISeekableStream* stream, const DDSImage& image);
     }
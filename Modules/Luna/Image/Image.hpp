@@ -12,6 +12,7 @@
 #include <Luna/Runtime/Blob.hpp>
 #include <Luna/Runtime/Result.hpp>
 #include <Luna/Runtime/Stream.hpp>
+#include <Luna/Runtime/Functional.hpp>
 
 #ifndef LUNA_IMAGE_API
 #define LUNA_IMAGE_API
@@ -83,6 +84,31 @@ namespace Luna
 		LUNA_IMAGE_API R<ImageDesc> read_image_file_desc(const void* data, usize data_size);
 		LUNA_IMAGE_API R<Blob> read_image_file(const void* data, usize data_size, ImageFormat desired_format, ImageDesc& out_desc);
 
+		//! Called by @ref read_image_file_rows for every decoded band of rows.
+		//! @param[in] desc The descriptor of the image being decoded.
+		//! @param[in] first_row The index of the first row in the band.
+		//! @param[in] num_rows The number of rows in the band.
+		//! @param[in] data The pixel data of rows in the band. Rows are tightly packed in top-to-bottom order.
+		//! The data is valid only during the call.
+		//! @return Returns `ok` to continue decoding, or one error to stop decoding. The error will be returned by
+		//! @ref read_image_file_rows.
+		using image_rows_callback_t = RV(const ImageDesc& desc, u32 first_row, u32 num_rows, const void* data);
+
+		//! Decodes one image file from one stream band by band, so that the whole file data and the whole image are never
+		//! held in memory.
+		//! @details Supports non-interlaced PNG, TGA and Radiance HDR files. Bands are reported in top-to-bottom order,
+		//! except for TGA files stored bottom-to-top, whose bands are reported in bottom-to-top order. Pixels are converted
+		//! the same way as @ref read_image_file.
+		//! @param[in] stream The stream to read the file data from. The stream is read from its current position.
+		//! @param[in] desired_format The pixel format to decode to. Specify `ImageFormat::unkonwn` to decode to the
+		//! format stored in the file.
+		//! @param[in] band_rows The maximum number of rows reported by one callback.
+		//! @param[in] callback The callback to be invoked for every band.
+		//! @return Returns the descriptor of the decoded image. Returns `BasicError::not_supported` if the file format
+		//! cannot be decoded in bands, in which case the user should use @ref read_image_file instead.
+		LUNA_IMAGE_API R<ImageDesc> read_image_file_rows(IStream* stream, ImageFormat desired_format, u32 band_rows,
+			const Function<image_rows_callback_t>& callback);
+
 		LUNA_IMAGE_API RV write_png_file(ISeekableStream* stream, const ImageDesc& desc, const Blob& image_data);
 		LUNA_IMAGE_API RV write_bmp_file(ISeekableStream* stream, const ImageDesc& desc, const Blob& image_data);
 		LUNA_IMAGE_API RV write_tga_file(ISeekableStream* stream, const ImageDesc& desc, const Blob& image_data);
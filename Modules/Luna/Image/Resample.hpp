@@ -0,0 +1,94 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Resample.hpp
+* @author JXMaster
+* @date 2026/10/19
+* @brief CPU image resampling and mipmap generation.
+*/
+#pragma once
+#include "Image.hpp"
+#include <Luna/Runtime/Vector.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		//! Specifies the filter used to compute pixels when resampling images.
+		enum class ResampleFilter : u8
+		{
+			//! Averages all source pixels covered by one destination pixel. This is the fastest filter, and
+			//! produces the same result as the 2x2 average for power-of-two mipmaps.
+			box = 0,
+			//! The triangle (tent) filter, which behaves as bilinear interpolation when upsampling.
+			triangle = 1,
+			//! The Kaiser-windowed sinc filter with 3 pixels radius. This filter keeps more details than
+			//! box filter and is the recommended filter for generating mipmaps.
+			kaiser = 2,
+			//! The Lanczos filter with 3 pixels radius. This filter produces the sharpest result, but may
+			//! introduce ringing artifacts near sharp edges.
+			lanczos = 3,
+		};
+
+		enum class ResampleFlag : u32
+		{
+			none = 0,
+			//! Color channels of 8-bit and 16-bit formats are encoded in sRGB color space. If this is set,
+			//! color channels are converted to linear color space before filtering and converted back after filtering,
+			//! the fourth (alpha) channel is always treated as linear.
+			srgb = 0x01,
+			//! Weights color channels by the alpha channel when filtering, so that colors of transparent pixels
+			//! do not bleed into opaque pixels. This only affects formats with 4 channels.
+			alpha_weighted = 0x02,
+			//! Wraps pixels around image borders when filtering. This should be set for tiled textures.
+			//! If this is not set, border pixels are repeated.
+			wrap = 0x04,
+		};
+
+		//! Computes the number of mip levels of the full mipmap chain of one image.
+		//! @param[in] width The width of the image.
+		//! @param[in] height The height of the image.
+		//! @return Returns the number of mip levels including the top level.
+		inline u32 calc_mip_levels(u32 width, u32 height)
+		{
+			u32 size = max(width, height);
+			u32 levels = 1;
+			while (size > 1)
+			{
+				size >>= 1;
+				++levels;
+			}
+			return levels;
+		}
+
+		//! Resizes one image to the specified size.
+		//! @details Filtering is performed in 32-bit floating-point precision for all formats, so this can be
+		//! used for both LDR and HDR images. Values of floating-point formats are not clamped after filtering.
+		//! Rows are processed in parallel using the job system.
+		//! @param[in] desc The descriptor of the source image.
+		//! @param[in] image_data The source pixel data. Rows are tightly packed.
+		//! @param[in] width The width of the resized image.
+		//! @param[in] height The height of the resized image.
+		//! @param[in] filter The filter to use.
+		//! @param[in] flags Additional resampling flags.
+		//! @return Returns the pixel data of the resized image, which has the same format as the source image.
+		LUNA_IMAGE_API R<Blob> resize_image(const ImageDesc& desc, const void* image_data, u32 width, u32 height,
+			ResampleFilter filter = ResampleFilter::kaiser, ResampleFlag flags = ResampleFlag::none);
+
+		//! Generates mipmaps for one image on CPU.
+		//! @details Each mip level is filtered from the previous level in 32-bit floating-point precision,
+		//! so quantization errors do not accumulate between levels. The size of every mip level is half of the previous level
+		//! rounded down, and is not smaller than 1.
+		//! @param[in] desc The descriptor of the top level image.
+		//! @param[in] image_data The pixel data of the top level image. Rows are tightly packed.
+		//! @param[in] num_mips The number of mip levels including the top level. Specify `0` to generate the full mipmap chain.
+		//! @param[in] filter The filter to use.
+		//! @param[in] flags Additional resampling flags.
+		//! @return Returns the pixel data of generated mip levels. The `i`th element stores mip level `i + 1`, the top level
+		//! is not copied.
+		LUNA_IMAGE_API R<Vector<Blob>> generate_mipmaps(const ImageDesc& desc, const void* image_data, u32 num_mips = 0,
+			ResampleFilter filter = ResampleFilter::kaiser, ResampleFlag flags = ResampleFlag::none);
+	}
+}
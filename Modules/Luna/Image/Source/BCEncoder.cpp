@@ -0,0 +1,893 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file BCEncoder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "Image.hpp"
+#include "PixelFormat.hpp"
+#include "../BCEncoder.hpp"
+#include "../Resample.hpp"
+#include <Luna/Runtime/Math/Math.hpp>
+#include <Luna/Runtime/Math/Simd.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		//! The interpolation weights of 4-bit indices of BC6H and BC7 in 1/64 units.
+		constexpr u32 BC_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		//! The number of blocks encoded by one job. Smaller images are encoded on the calling thread.
+		constexpr u32 BC_BLOCKS_PER_JOB = 256;
+
+		struct BlockBitWriter
+		{
+			u8 data[16] = { 0 };
+			u32 pos = 0;
+
+			void write(u32 value, u32 num_bits)
+			{
+				for (u32 i = 0; i < num_bits; ++i, ++pos)
+				{
+					if ((value >> i) & 1) data[pos >> 3] |= (u8)(1 << (pos & 7));
+				}
+			}
+		};
+
+		inline u32 get_refine_iterations(BCQuality quality)
+		{
+			switch (quality)
+			{
+			case BCQuality::fast: return 0;
+			case BCQuality::normal: return 1;
+			default: return 3;
+			}
+		}
+
+		//! Finds the nearest palette entry of every pixel.
+		//! @return Returns the sum of squared errors of all pixels.
+		static f32 find_nearest_indices(const f32(*pixels)[4], u32 num_pixels, const f32(*palette)[4], u32 palette_size, u8* indices)
+		{
+			f32 total_err = 0.0f;
+			for (u32 i = 0; i < num_pixels; ++i)
+			{
+				f32 best_err = F32_MAX;
+				u8 best_index = 0;
+#ifdef LUNA_SIMD
+				using namespace Simd;
+				float4 p = load_f4(pixels[i]);
+				for (u32 k = 0; k < palette_size; ++k)
+				{
+					float4 d = sub_f4(p, load_f4(palette[k]));
+					f32 err = dot4_f4(d, d);
+					if (err < best_err)
+					{
+						best_err = err;
+						best_index = (u8)k;
+					}
+				}
+#else
+				for (u32 k = 0; k < palette_size; ++k)
+				{
+					f32 err = 0.0f;
+					for (u32 c = 0; c < 4; ++c)
+					{
+						f32 d = pixels[i][c] - palette[k][c];
+						err += d * d;
+					}
+					if (err < best_err)
+					{
+						best_err = err;
+						best_index = (u8)k;
+					}
+				}
+#endif
+				indices[i] = best_index;
+				total_err += best_err;
+			}
+			return total_err;
+		}
+
+		//! Computes initial endpoints from the extent of pixels along the principal axis.
+		static void fit_principal_endpoints(const f32(*pixels)[4], u32 num_pixels, u32 num_channels, f32 e0[4], f32 e1[4])
+		{
+			f32 mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (u32 i = 0; i < num_pixels; ++i)
+			{
+				for (u32 c = 0; c < num_channels; ++c) mean[c] += pixels[i][c];
+			}
+			for (u32 c = 0; c < num_channels; ++c) mean[c] /= (f32)num_pixels;
+			f32 cov[4][4] = {};
+			for (u32 i = 0; i < num_pixels; ++i)
+			{
+				f32 d[4];
+				for (u32 c = 0; c < num_channels; ++c) d[c] = pixels[i][c] - mean[c];
+				for (u32 c = 0; c < num_channels; ++c)
+				{
+					for (u32 r = c; r < num_channels; ++r) cov[c][r] += d[c] * d[r];
+				}
+			}
+			for (u32 c = 0; c < num_channels; ++c)
+			{
+				for (u32 r = 0; r < c; ++r) cov[c][r] = cov[r][c];
+			}
+			// Power iteration.
+			f32 axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			for (u32 iter = 0; iter < 8; ++iter)
+			{
+				f32 v[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				f32 max_v = 0.0f;
+				for (u32 c = 0; c < num_channels; ++c)
+				{
+					for (u32 r = 0; r < num_channels; ++r) v[c] += cov[c][r] * axis[r];
+					max_v = max(max_v, fabsf(v[c]));
+				}
+				if (max_v < 1e-8f) break;
+				for (u32 c = 0; c < num_channels; ++c) axis[c] = v[c] / max_v;
+			}
+			f32 len = 0.0f;
+			for (u32 c = 0; c < num_channels; ++c) len += axis[c] * axis[c];
+			len = sqrtf(len);
+			for (u32 c = 0; c < num_channels; ++c) axis[c] /= len;
+			f32 t_min = F32_MAX;
+			f32 t_max = -F32_MAX;
+			for (u32 i = 0; i < num_pixels; ++i)
+			{
+				f32 t = 0.0f;
+				for (u32 c = 0; c < num_channels; ++c) t += (pixels[i][c] - mean[c]) * axis[c];
+				t_min = min(t_min, t);
+				t_max = max(t_max, t);
+			}
+			for (u32 c = 0; c < 4; ++c)
+			{
+				e0[c] = c < num_channels ? mean[c] + axis[c] * t_min : 0.0f;
+				e1[c] = c < num_channels ? mean[c] + axis[c] * t_max : 0.0f;
+			}
+		}
+
+		//! Computes endpoints that minimize the squared error for the given interpolation factors of pixels.
+		//! @return Returns `false` if the endpoints cannot be solved, for example, when all factors are the same.
+		static bool refine_endpoints(const f32(*pixels)[4], u32 num_pixels, u32 num_channels, const f32* t, f32 e0[4], f32 e1[4])
+		{
+			f32 a = 0.0f;
+			f32 b = 0.0f;
+			f32 c = 0.0f;
+			f32 x0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			f32 x1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (u32 i = 0; i < num_pixels; ++i)
+			{
+				f32 s = 1.0f - t[i];
+				a += s * s;
+				b += s * t[i];
+				c += t[i] * t[i];
+				for (u32 ch = 0; ch < num_channels; ++ch)
+				{
+					x0[ch] += s * pixels[i][ch];
+					x1[ch] += t[i] * pixels[i][ch];
+				}
+			}
+			f32 det = a * c - b * b;
+			if (fabsf(det) < 1e-6f) return false;
+			f32 inv_det = 1.0f / det;
+			for (u32 ch = 0; ch < num_channels; ++ch)
+			{
+				e0[ch] = (c * x0[ch] - b * x1[ch]) * inv_det;
+				e1[ch] = (a * x1[ch] - b * x0[ch]) * inv_det;
+			}
+			return true;
+		}
+
+		inline u32 quantize_unorm(f32 v, u32 max_value)
+		{
+			return (u32)clamp(roundf(v * (f32)max_value / 255.0f), 0.0f, (f32)max_value);
+		}
+
+		inline u16 encode_565(const f32 c[4])
+		{
+			return (u16)((quantize_unorm(c[0], 31) << 11) | (quantize_unorm(c[1], 63) << 5) | quantize_unorm(c[2], 31));
+		}
+
+		inline void decode_565(u16 v, f32 dst[4])
+		{
+			u32 r = (v >> 11) & 31;
+			u32 g = (v >> 5) & 63;
+			u32 b = v & 31;
+			dst[0] = (f32)((r << 3) | (r >> 2));
+			dst[1] = (f32)((g << 2) | (g >> 4));
+			dst[2] = (f32)((b << 3) | (b >> 2));
+			dst[3] = 0.0f;
+		}
+
+		inline void write_u16(u8* dst, u16 v)
+		{
+			dst[0] = (u8)(v & 0xFF);
+			dst[1] = (u8)(v >> 8);
+		}
+
+		//! Encodes the BC1 color block.
+		//! @param[in] pixels The block pixels in [0, 255] range.
+		//! @param[in] punch_through If `true`, encodes the block in 3-color mode, and pixels with alpha
+		//! lower than 128 are encoded as transparent.
+		static void encode_bc1_color_block(const f32(*pixels)[4], u8* dst, bool punch_through, BCQuality quality)
+		{
+			alignas(16) f32 colors[16][4];
+			u8 pixel_map[16];
+			u32 num_colors = 0;
+			for (u32 i = 0; i < 16; ++i)
+			{
+				if (punch_through && pixels[i][3] < 128.0f) continue;
+				colors[num_colors][0] = pixels[i][0];
+				colors[num_colors][1] = pixels[i][1];
+				colors[num_colors][2] = pixels[i][2];
+				colors[num_colors][3] = 0.0f;
+				pixel_map[num_colors] = (u8)i;
+				++num_colors;
+			}
+			u32 palette_size = punch_through ? 3 : 4;
+			u16 c0 = 0;
+			u16 c1 = 0;
+			// Indices sorted by interpolation factor from `c0` to `c1`.
+			u8 order[16] = { 0 };
+			if (num_colors)
+			{
+				f32 e0[4];
+				f32 e1[4];
+				fit_principal_endpoints(colors, num_colors, 3, e0, e1);
+				u32 iterations = get_refine_iterations(quality);
+				f32 best_err = F32_MAX;
+				for (u32 iter = 0; ; ++iter)
+				{
+					u16 q0 = encode_565(e0);
+					u16 q1 = encode_565(e1);
+					alignas(16) f32 palette[4][4];
+					decode_565(q0, palette[0]);
+					decode_565(q1, palette[palette_size - 1]);
+					for (u32 k = 1; k + 1 < palette_size; ++k)
+					{
+						f32 t = (f32)k / (f32)(palette_size - 1);
+						for (u32 c = 0; c < 4; ++c) palette[k][c] = palette[0][c] * (1.0f - t) + palette[palette_size - 1][c] * t;
+					}
+					u8 indices[16];
+					f32 err = find_nearest_indices(colors, num_colors, palette, palette_size, indices);
+					if (err < best_err)
+					{
+						best_err = err;
+						c0 = q0;
+						c1 = q1;
+						memcpy(order, indices, num_colors);
+					}
+					if (iter == iterations) break;
+					f32 t[16];
+					for (u32 i = 0; i < num_colors; ++i) t[i] = (f32)indices[i] / (f32)(palette_size - 1);
+					if (!refine_endpoints(colors, num_colors, 3, t, e0, e1)) break;
+				}
+			}
+			u32 indices = 0;
+			if (!punch_through)
+			{
+				// The 4-color mode is selected by `c0 > c1`. If both colors are equal, all pixels use `c0`.
+				if (c0 < c1)
+				{
+					swap(c0, c1);
+					for (u32 i = 0; i < 16; ++i) order[i] = 3 - order[i];
+				}
+				constexpr u8 BC1_INDICES[4] = { 0, 2, 3, 1 };
+				for (u32 i = 0; i < 16; ++i)
+				{
+					u32 index = c0 == c1 ? 0 : BC1_INDICES[order[i]];
+					indices |= index << (i * 2);
+				}
+			}
+			else
+			{
+				// The 3-color mode is selected by `c0 <= c1`, index 3 is transparent black.
+				if (c0 > c1)
+				{
+					swap(c0, c1);
+					for (u32 i = 0; i < num_colors; ++i) order[i] = 2 - order[i];
+				}
+				constexpr u8 BC1_INDICES[3] = { 0, 2, 1 };
+				indices = 0xFFFFFFFF;
+				for (u32 i = 0; i < num_colors; ++i)
+				{
+					u32 shift = pixel_map[i] * 2;
+					indices = (indices & ~(3u << shift)) | ((u32)BC1_INDICES[order[i]] << shift);
+				}
+			}
+			write_u16(dst, c0);
+			write_u16(dst + 2, c1);
+			for (u32 i = 0; i < 4; ++i) dst[4 + i] = (u8)(indices >> (i * 8));
+		}
+
+		//! Evaluates one BC4 block with the specified endpoints.
+		//! @return Returns the sum of squared errors of all values.
+		static f32 evaluate_bc4_block(const f32(*values)[4], u8 a0, u8 a1, u8* indices)
+		{
+			alignas(16) f32 palette[8][4] = {};
+			palette[0][0] = a0;
+			palette[1][0] = a1;
+			if (a0 > a1)
+			{
+				for (u32 k = 1; k < 7; ++k) palette[k + 1][0] = ((f32)(7 - k) * a0 + (f32)k * a1) / 7.0f;
+			}
+			else
+			{
+				for (u32 k = 1; k < 5; ++k) palette[k + 1][0] = ((f32)(5 - k) * a0 + (f32)k * a1) / 5.0f;
+				palette[6][0] = 0.0f;
+				palette[7][0] = 255.0f;
+			}
+			return find_nearest_indices(values, 16, palette, 8, indices);
+		}
+
+		//! Encodes one BC4 block.
+		//! @param[in] pixels The block pixels in [0, 255] range.
+		//! @param[in] channel The channel of pixels to encode.
+		static void encode_bc4_block(const f32(*pixels)[4], u32 channel, u8* dst, BCQuality quality)
+		{
+			alignas(16) f32 values[16][4] = {};
+			f32 lo = 255.0f;
+			f32 hi = 0.0f;
+			for (u32 i = 0; i < 16; ++i)
+			{
+				f32 v = clamp(pixels[i][channel], 0.0f, 255.0f);
+				values[i][0] = v;
+				lo = min(lo, v);
+				hi = max(hi, v);
+			}
+			u8 a0 = (u8)roundf(hi);
+			u8 a1 = (u8)roundf(lo);
+			u8 indices[16] = { 0 };
+			if (a0 != a1)
+			{
+				f32 best_err = evaluate_bc4_block(values, a0, a1, indices);
+				u32 iterations = get_refine_iterations(quality);
+				f32 e0[4] = { hi, 0.0f, 0.0f, 0.0f };
+				f32 e1[4] = { lo, 0.0f, 0.0f, 0.0f };
+				u8 cur[16];
+				memcpy(cur, indices, 16);
+				for (u32 iter = 0; iter < iterations; ++iter)
+				{
+					f32 t[16];
+					for (u32 i = 0; i < 16; ++i) t[i] = cur[i] == 0 ? 0.0f : (cur[i] == 1 ? 1.0f : (f32)(cur[i] - 1) / 7.0f);
+					if (!refine_endpoints(values, 16, 1, t, e0, e1)) break;
+					u8 q0 = (u8)clamp(roundf(e0[0]), 0.0f, 255.0f);
+					u8 q1 = (u8)clamp(roundf(e1[0]), 0.0f, 255.0f);
+					// Refined endpoints must stay in 8-value mode.
+					if (q0 <= q1) break;
+					f32 err = evaluate_bc4_block(values, q0, q1, cur);
+					if (err < best_err)
+					{
+						best_err = err;
+						a0 = q0;
+						a1 = q1;
+						memcpy(indices, cur, 16);
+					}
+				}
+				if (quality == BCQuality::high)
+				{
+					// The 6-value mode encodes 0 and 255 exactly, and interpolates between remaining values.
+					f32 lo6 = 255.0f;
+					f32 hi6 = 0.0f;
+					for (u32 i = 0; i < 16; ++i)
+					{
+						f32 v = values[i][0];
+						if (v < 0.5f || v > 254.5f) continue;
+						lo6 = min(lo6, v);
+						hi6 = max(hi6, v);
+					}
+					if (lo6 <= hi6)
+					{
+						u8 q0 = (u8)roundf(lo6);
+						u8 q1 = (u8)roundf(hi6);
+						f32 err = evaluate_bc4_block(values, q0, q1, cur);
+						if (err < best_err)
+						{
+							best_err = err;
+							a0 = q0;
+							a1 = q1;
+							memcpy(indices, cur, 16);
+						}
+					}
+				}
+			}
+			dst[0] = a0;
+			dst[1] = a1;
+			u64 bits = 0;
+			for (u32 i = 0; i < 16; ++i) bits |= (u64)indices[i] << (i * 3);
+			for (u32 i = 0; i < 6; ++i) dst[2 + i] = (u8)(bits >> (i * 8));
+		}
+
+		//! Encodes one BC7 block using mode 6 (one subset, 7-bit RGBA endpoints with unique p-bits, 4-bit indices).
+		//! @param[in] pixels The block pixels in [0, 255] range.
+		static void encode_bc7_block(const f32(*pixels)[4], u8* dst, BCQuality quality)
+		{
+			f32 e0[4];
+			f32 e1[4];
+			fit_principal_endpoints(pixels, 16, 4, e0, e1);
+			u32 iterations = get_refine_iterations(quality);
+			f32 best_err = F32_MAX;
+			u32 best_q[2][4] = {};
+			u32 best_p[2] = { 0, 0 };
+			u8 best_indices[16] = { 0 };
+			for (u32 iter = 0; ; ++iter)
+			{
+				const f32* endpoints[2] = { e0, e1 };
+				// Selects p-bits that minimize the quantization error of every endpoint in fast mode, and tries
+				// all p-bit combinations otherwise.
+				u32 fast_p[2];
+				for (u32 e = 0; e < 2; ++e)
+				{
+					f32 err[2] = { 0.0f, 0.0f };
+					for (u32 p = 0; p < 2; ++p)
+					{
+						for (u32 c = 0; c < 4; ++c)
+						{
+							f32 q = clamp(roundf((endpoints[e][c] - (f32)p) * 0.5f), 0.0f, 127.0f);
+							f32 d = q * 2.0f + (f32)p - endpoints[e][c];
+							err[p] += d * d;
+						}
+					}
+					fast_p[e] = err[1] < err[0] ? 1 : 0;
+				}
+				u32 num_combinations = quality == BCQuality::fast ? 1 : 4;
+				for (u32 comb = 0; comb < num_combinations; ++comb)
+				{
+					u32 p[2];
+					if (quality == BCQuality::fast)
+					{
+						p[0] = fast_p[0];
+						p[1] = fast_p[1];
+					}
+					else
+					{
+						p[0] = comb & 1;
+						p[1] = comb >> 1;
+					}
+					u32 q[2][4];
+					u32 v[2][4];
+					for (u32 e = 0; e < 2; ++e)
+					{
+						for (u32 c = 0; c < 4; ++c)
+						{
+							q[e][c] = (u32)clamp(roundf((endpoints[e][c] - (f32)p[e]) * 0.5f), 0.0f, 127.0f);
+							v[e][c] = (q[e][c] << 1) | p[e];
+						}
+					}
+					alignas(16) f32 palette[16][4];
+					for (u32 k = 0; k < 16; ++k)
+					{
+						for (u32 c = 0; c < 4; ++c)
+						{
+							palette[k][c] = (f32)(((64 - BC_WEIGHTS4[k]) * v[0][c] + BC_WEIGHTS4[k] * v[1][c] + 32) >> 6);
+						}
+					}
+					u8 indices[16];
+					f32 err = find_nearest_indices(pixels, 16, palette, 16, indices);
+					if (err < best_err)
+					{
+						best_err = err;
+						memcpy(best_q, q, sizeof(q));
+						best_p[0] = p[0];
+						best_p[1] = p[1];
+						memcpy(best_indices, indices, 16);
+					}
+				}
+				if (iter == iterations) break;
+				f32 t[16];
+				for (u32 i = 0; i < 16; ++i) t[i] = (f32)BC_WEIGHTS4[best_indices[i]] / 64.0f;
+				if (!refine_endpoints(pixels, 16, 4, t, e0, e1)) break;
+			}
+			// The most significant bit of the index of the first pixel is implicitly 0.
+			if (best_indices[0] & 8)
+			{
+				for (u32 c = 0; c < 4; ++c) swap(best_q[0][c], best_q[1][c]);
+				swap(best_p[0], best_p[1]);
+				for (u32 i = 0; i < 16; ++i) best_indices[i] = 15 - best_indices[i];
+			}
+			BlockBitWriter writer;
+			writer.write(1 << 6, 7);
+			for (u32 c = 0; c < 4; ++c)
+			{
+				writer.write(best_q[0][c], 7);
+				writer.write(best_q[1][c], 7);
+			}
+			writer.write(best_p[0], 1);
+			writer.write(best_p[1], 1);
+			writer.write(best_indices[0], 3);
+			for (u32 i = 1; i < 16; ++i) writer.write(best_indices[i], 4);
+			memcpy(dst, writer.data, 16);
+		}
+
+		//! Converts one 32-bit float to 16-bit float with round-to-nearest-even.
+		inline u16 f32_to_f16(f32 value)
+		{
+			u32 bits;
+			memcpy(&bits, &value, sizeof(u32));
+			u32 sign = (bits >> 16) & 0x8000;
+			u32 exponent = (bits >> 23) & 0xFF;
+			u32 mantissa = bits & 0x7FFFFF;
+			if (exponent == 0xFF) return (u16)(sign | (mantissa ? 0x7E00 : 0x7C00));
+			i32 e = (i32)exponent - 127 + 15;
+			if (e >= 31) return (u16)(sign | 0x7C00);
+			if (e <= 0)
+			{
+				if (e < -10) return (u16)sign;
+				mantissa |= 0x800000;
+				u32 shift = (u32)(14 - e);
+				u32 h = mantissa >> shift;
+				u32 rem = mantissa & ((1u << shift) - 1);
+				u32 half = 1u << (shift - 1);
+				if (rem > half || (rem == half && (h & 1))) ++h;
+				return (u16)(sign | h);
+			}
+			u32 h = ((u32)e << 10) | (mantissa >> 13);
+			u32 rem = mantissa & 0x1FFF;
+			if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) ++h;
+			return (u16)(sign | h);
+		}
+
+		//! Converts one float to the final value space of BC6H, which is the bit pattern of the 16-bit float
+		//! as one integer, negated for negative values.
+		inline i32 f32_to_bc6h_value(f32 value, bool is_signed)
+		{
+			u16 h = f32_to_f16(value);
+			i32 magnitude = (i32)(h & 0x7FFF);
+			// NaN is encoded as 0, infinity is clamped to the largest finite value.
+			if (magnitude > 0x7C00) return 0;
+			magnitude = min(magnitude, 0x7BFF);
+			if (h & 0x8000) return is_signed ? -magnitude : 0;
+			return magnitude;
+		}
+
+		inline i32 bc6h_unquantize(i32 v, bool is_signed)
+		{
+			// Unquantizes 10-bit endpoints.
+			if (is_signed)
+			{
+				bool negative = v < 0;
+				i32 x = negative ? -v : v;
+				i32 r;
+				if (x == 0) r = 0;
+				else if (x >= 511) r = 0x7FFF;
+				else r = ((x << 15) + 0x4000) >> 9;
+				return negative ? -r : r;
+			}
+			if (v == 0) return 0;
+			if (v == 1023) return 0xFFFF;
+			return ((v << 16) + 0x8000) >> 10;
+		}
+
+		inline i32 bc6h_finish_unquantize(i32 v, bool is_signed)
+		{
+			if (is_signed) return v < 0 ? -(((-v) * 31) >> 5) : (v * 31) >> 5;
+			return (v * 31) >> 6;
+		}
+
+		//! Finds the 10-bit endpoint value that is decoded closest to the specified final value.
+		inline i32 bc6h_quantize(f32 value, bool is_signed)
+		{
+			i32 max_v = is_signed ? 511 : 1023;
+			i32 min_v = is_signed ? -511 : 0;
+			i32 guess = (i32)roundf(value * (f32)max_v / 31743.0f);
+			i32 best = 0;
+			f32 best_err = F32_MAX;
+			for (i32 v = guess - 1; v <= guess + 1; ++v)
+			{
+				i32 q = clamp(v, min_v, max_v);
+				f32 err = fabsf((f32)bc6h_finish_unquantize(bc6h_unquantize(q, is_signed), is_signed) - value);
+				if (err < best_err)
+				{
+					best_err = err;
+					best = q;
+				}
+			}
+			return best;
+		}
+
+		//! Encodes one BC6H block using mode 11 (one region, 10-bit endpoints, 4-bit indices).
+		//! @param[in] pixels The block pixels in linear floating-point values.
+		static void encode_bc6h_block(const f32(*pixels)[4], u8* dst, bool is_signed, BCQuality quality)
+		{
+			// Endpoints are fitted in the final value space, where interpolation is linear.
+			alignas(16) f32 values[16][4];
+			for (u32 i = 0; i < 16; ++i)
+			{
+				for (u32 c = 0; c < 3; ++c) values[i][c] = (f32)f32_to_bc6h_value(pixels[i][c], is_signed);
+				values[i][3] = 0.0f;
+			}
+			f32 e0[4];
+			f32 e1[4];
+			fit_principal_endpoints(values, 16, 3, e0, e1);
+			u32 iterations = get_refine_iterations(quality);
+			f32 best_err = F32_MAX;
+			i32 best_q[2][3] = {};
+			u8 best_indices[16] = { 0 };
+			for (u32 iter = 0; ; ++iter)
+			{
+				i32 q[2][3];
+				i32 u[2][3];
+				for (u32 c = 0; c < 3; ++c)
+				{
+					q[0][c] = bc6h_quantize(e0[c], is_signed);
+					q[1][c] = bc6h_quantize(e1[c], is_signed);
+					u[0][c] = bc6h_unquantize(q[0][c], is_signed);
+					u[1][c] = bc6h_unquantize(q[1][c], is_signed);
+				}
+				alignas(16) f32 palette[16][4];
+				for (u32 k = 0; k < 16; ++k)
+				{
+					i32 w = (i32)BC_WEIGHTS4[k];
+					for (u32 c = 0; c < 3; ++c)
+					{
+						palette[k][c] = (f32)bc6h_finish_unquantize(((64 - w) * u[0][c] + w * u[1][c] + 32) >> 6, is_signed);
+					}
+					palette[k][3] = 0.0f;
+				}
+				u8 indices[16];
+				f32 err = find_nearest_indices(values, 16, palette, 16, indices);
+				if (err < best_err)
+				{
+					best_err = err;
+					memcpy(best_q, q, sizeof(q));
+					memcpy(best_indices, indices, 16);
+				}
+				if (iter == iterations) break;
+				f32 t[16];
+				for (u32 i = 0; i < 16; ++i) t[i] = (f32)BC_WEIGHTS4[best_indices[i]] / 64.0f;
+				if (!refine_endpoints(values, 16, 3, t, e0, e1)) break;
+			}
+			if (best_indices[0] & 8)
+			{
+				for (u32 c = 0; c < 3; ++c) swap(best_q[0][c], best_q[1][c]);
+				for (u32 i = 0; i < 16; ++i) best_indices[i] = 15 - best_indices[i];
+			}
+			BlockBitWriter writer;
+			writer.write(0x03, 5);
+			for (u32 e = 0; e < 2; ++e)
+			{
+				for (u32 c = 0; c < 3; ++c) writer.write((u32)best_q[e][c] & 0x3FF, 10);
+			}
+			writer.write(best_indices[0], 3);
+			for (u32 i = 1; i < 16; ++i) writer.write(best_indices[i], 4);
+			memcpy(dst, writer.data, 16);
+		}
+
+		inline usize get_bc_block_size(DDSFormat format)
+		{
+			switch (format)
+			{
+			case DDSFormat::bc1_unorm:
+			case DDSFormat::bc1_unorm_srgb:
+			case DDSFormat::bc4_unorm:
+				return 8;
+			default:
+				return 16;
+			}
+		}
+
+		struct BCEncodeContext
+		{
+			const byte_t* src_data;
+			PixelFormatInfo src_format;
+			u32 src_pixel_size;
+			u32 width;
+			u32 height;
+			DDSFormat format;
+			BCQuality quality;
+			byte_t* dst;
+			usize dst_row_pitch;
+			u32 num_blocks_x;
+		};
+
+		static void encode_block(const BCEncodeContext& ctx, u32 bx, u32 by, byte_t* dst)
+		{
+			alignas(16) f32 pixels[16][4];
+			for (u32 y = 0; y < 4; ++y)
+			{
+				u32 py = min(by * 4 + y, ctx.height - 1);
+				for (u32 x = 0; x < 4; ++x)
+				{
+					u32 px = min(bx * 4 + x, ctx.width - 1);
+					load_pixel(ctx.src_data + ((usize)py * ctx.width + px) * ctx.src_pixel_size, ctx.src_format, pixels[y * 4 + x]);
+				}
+			}
+			if (ctx.format == DDSFormat::bc6h_uf16 || ctx.format == DDSFormat::bc6h_sf16)
+			{
+				encode_bc6h_block(pixels, dst, ctx.format == DDSFormat::bc6h_sf16, ctx.quality);
+				return;
+			}
+			for (u32 i = 0; i < 16; ++i)
+			{
+				for (u32 c = 0; c < 4; ++c) pixels[i][c] = clamp(pixels[i][c], 0.0f, 1.0f) * 255.0f;
+			}
+			switch (ctx.format)
+			{
+			case DDSFormat::bc1_unorm:
+			case DDSFormat::bc1_unorm_srgb:
+			{
+				bool punch_through = false;
+				for (u32 i = 0; i < 16; ++i) punch_through |= pixels[i][3] < 128.0f;
+				encode_bc1_color_block(pixels, dst, punch_through, ctx.quality);
+				break;
+			}
+			case DDSFormat::bc3_unorm:
+			case DDSFormat::bc3_unorm_srgb:
+				encode_bc4_block(pixels, 3, dst, ctx.quality);
+				encode_bc1_color_block(pixels, dst + 8, false, ctx.quality);
+				break;
+			case DDSFormat::bc4_unorm:
+				encode_bc4_block(pixels, 0, dst, ctx.quality);
+				break;
+			case DDSFormat::bc5_unorm:
+				encode_bc4_block(pixels, 0, dst, ctx.quality);
+				encode_bc4_block(pixels, 1, dst + 8, ctx.quality);
+				break;
+			case DDSFormat::bc7_unorm:
+			case DDSFormat::bc7_unorm_srgb:
+				encode_bc7_block(pixels, dst, ctx.quality);
+				break;
+			default:
+				lupanic();
+				break;
+			}
+		}
+
+		static void encode_block_rows(const BCEncodeContext& ctx, u32 begin, u32 end)
+		{
+			usize block_size = get_bc_block_size(ctx.format);
+			for (u32 by = begin; by < end; ++by)
+			{
+				byte_t* dst = ctx.dst + by * ctx.dst_row_pitch;
+				for (u32 bx = 0; bx < ctx.num_blocks_x; ++bx)
+				{
+					encode_block(ctx, bx, by, dst + bx * block_size);
+				}
+			}
+		}
+
+		struct BCEncodeRowsJob
+		{
+			const BCEncodeContext* ctx;
+			u32 begin;
+			u32 end;
+
+			static void run(void* params)
+			{
+				BCEncodeRowsJob* job = (BCEncodeRowsJob*)params;
+				encode_block_rows(*job->ctx, job->begin, job->end);
+			}
+		};
+
+		struct BCEncodeDispatchJob
+		{
+			const BCEncodeContext* ctx;
+			u32 num_rows;
+			u32 rows_per_job;
+
+			static void run(void* params)
+			{
+				BCEncodeDispatchJob* job = (BCEncodeDispatchJob*)params;
+				for (u32 begin = 0; begin < job->num_rows; begin += job->rows_per_job)
+				{
+					// Row jobs are attached to this job, so waiting for this job waits for all rows.
+					BCEncodeRowsJob* rows = (BCEncodeRowsJob*)JobSystem::new_job(BCEncodeRowsJob::run, sizeof(BCEncodeRowsJob), alignof(BCEncodeRowsJob), params);
+					rows->ctx = job->ctx;
+					rows->begin = begin;
+					rows->end = min(begin + job->rows_per_job, job->num_rows);
+					JobSystem::submit_job(rows);
+				}
+			}
+		};
+
+		LUNA_IMAGE_API bool is_bc_encoding_supported(DDSFormat format)
+		{
+			switch (format)
+			{
+			case DDSFormat::bc1_unorm:
+			case DDSFormat::bc1_unorm_srgb:
+			case DDSFormat::bc3_unorm:
+			case DDSFormat::bc3_unorm_srgb:
+			case DDSFormat::bc4_unorm:
+			case DDSFormat::bc5_unorm:
+			case DDSFormat::bc6h_uf16:
+			case DDSFormat::bc6h_sf16:
+			case DDSFormat::bc7_unorm:
+			case DDSFormat::bc7_unorm_srgb:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		LUNA_IMAGE_API RV encode_bc_image(const ImageDesc& desc, const void* image_data, DDSFormat format, BCQuality quality, void* dst, usize dst_row_pitch)
+		{
+			if (!image_data || !dst || !desc.width || !desc.height || !pixel_size(desc.format))
+			{
+				return set_error(BasicError::bad_arguments(), "Invalid source image for block compression.");
+			}
+			if (!is_bc_encoding_supported(format))
+			{
+				return set_error(BasicError::not_supported(), "The specified format is not supported by the block compression encoder.");
+			}
+			BCEncodeContext ctx;
+			ctx.src_data = (const byte_t*)image_data;
+			ctx.src_format = get_pixel_format_info(desc.format);
+			ctx.src_pixel_size = pixel_size(desc.format);
+			ctx.width = desc.width;
+			ctx.height = desc.height;
+			ctx.format = format;
+			ctx.quality = quality;
+			ctx.dst = (byte_t*)dst;
+			ctx.dst_row_pitch = dst_row_pitch;
+			ctx.num_blocks_x = (desc.width + 3) / 4;
+			u32 num_blocks_y = (desc.height + 3) / 4;
+			if (dst_row_pitch < ctx.num_blocks_x * get_bc_block_size(format))
+			{
+				return set_error(BasicError::bad_arguments(), "The destination row pitch is too small.");
+			}
+			u32 rows_per_job = max<u32>(BC_BLOCKS_PER_JOB / ctx.num_blocks_x, 1);
+			if (rows_per_job >= num_blocks_y)
+			{
+				encode_block_rows(ctx, 0, num_blocks_y);
+				return ok;
+			}
+			BCEncodeDispatchJob* job = (BCEncodeDispatchJob*)JobSystem::new_job(BCEncodeDispatchJob::run, sizeof(BCEncodeDispatchJob), alignof(BCEncodeDispatchJob));
+			job->ctx = &ctx;
+			job->num_rows = num_blocks_y;
+			job->rows_per_job = rows_per_job;
+			JobSystem::wait_job(JobSystem::submit_job(job));
+			return ok;
+		}
+
+		LUNA_IMAGE_API R<DDSImage> encode_bc_dds_image(const ImageDesc& desc, const void* image_data, DDSFormat format, u32 mip_levels, BCQuality quality)
+		{
+			DDSImage image;
+			lutry
+			{
+				if (!image_data || !desc.width || !desc.height || !pixel_size(desc.format))
+				{
+					return set_error(BasicError::bad_arguments(), "Invalid source image for block compression.");
+				}
+				if (!is_bc_encoding_supported(format))
+				{
+					return set_error(BasicError::not_supported(), "The specified format is not supported by the block compression encoder.");
+				}
+				u32 max_mips = calc_mip_levels(desc.width, desc.height);
+				mip_levels = mip_levels ? min(mip_levels, max_mips) : max_mips;
+				DDSImageDesc dds_desc;
+				dds_desc.width = desc.width;
+				dds_desc.height = desc.height;
+				dds_desc.depth = 1;
+				dds_desc.array_size = 1;
+				dds_desc.mip_levels = mip_levels;
+				dds_desc.format = format;
+				dds_desc.dimension = DDSDimension::tex2d;
+				dds_desc.flags = DDSFlag::none;
+				luset(image, new_dds_image(dds_desc));
+				Vector<Blob> mips;
+				if (mip_levels > 1)
+				{
+					bool srgb = format == DDSFormat::bc1_unorm_srgb || format == DDSFormat::bc3_unorm_srgb || format == DDSFormat::bc7_unorm_srgb;
+					luset(mips, generate_mipmaps(desc, image_data, mip_levels, ResampleFilter::kaiser, srgb ? ResampleFlag::srgb : ResampleFlag::none));
+				}
+				for (u32 mip = 0; mip < mip_levels; ++mip)
+				{
+					const DDSSubresource& subresource = image.subresources[calc_dds_subresoruce_index(mip, 0, mip_levels)];
+					ImageDesc mip_desc;
+					mip_desc.format = desc.format;
+					mip_desc.width = subresource.width;
+					mip_desc.height = subresource.height;
+					const void* mip_data = mip == 0 ? image_data : mips[mip - 1].data();
+					luexp(encode_bc_image(mip_desc, mip_data, format, quality, image.data.data() + subresource.data_offset, subresource.row_pitch));
+				}
+			}
+			lucatchret;
+			return image;
+		}
+	}
+}
@@ -680,6 +680,105 @@ namespace Luna
             lucatchret;
             return r;
         }
+        LUNA_IMAGE_API R<DDSImageDesc> read_dds_image_file_desc(ISeekableStream* stream)
+        {
+            lucheck(stream);
+            u8 header[sizeof(u32) + sizeof(DDSHeader) + sizeof(DDSHeaderDXT10)];
+            usize read_bytes = 0;
+            lutry
+            {
+                luexp(stream->seek(0, SeekMode::begin));
+                luexp(stream->read(header, sizeof(header), &read_bytes));
+            }
+            lucatchret;
+            return read_dds_image_file_desc(header, read_bytes);
+        }
+        LUNA_IMAGE_API RV read_dds_image_region(ISeekableStream* stream, const DDSImageDesc& desc, u32 mip_slice, u32 array_slice,
+            const DDSRegion& region, void* dst, usize dst_row_pitch, usize dst_slice_pitch)
+        {
+            lucheck(stream && dst);
+            if (mip_slice >= desc.mip_levels || array_slice >= desc.array_size)
+            {
+                return set_error(BasicError::out_of_range(), "The specified subresource does not exist.");
+            }
+            if (is_packed(desc.format) || (bits_per_pixel(desc.format) % 8 && !is_compressed(desc.format)))
+            {
+                return set_error(BasicError::not_supported(), "Reading regions of packed formats is not supported.");
+            }
+            lutry
+            {
+                // Finds the subresource in the same order as it is stored in the file.
+                u64 data_offset = sizeof(u32) + sizeof(DDSHeader) + sizeof(DDSHeaderDXT10);
+                u32 width = 0;
+                u32 height = 0;
+                u32 depth = 0;
+                usize row_pitch = 0;
+                usize slice_pitch = 0;
+                for (u32 item = 0; item <= array_slice; ++item)
+                {
+                    width = desc.width;
+                    height = desc.height;
+                    depth = desc.depth;
+                    for (u32 mip = 0; mip < desc.mip_levels; ++mip)
+                    {
+                        luexp(compute_pitch(desc.format, width, height, row_pitch, slice_pitch));
+                        if (item == array_slice && mip == mip_slice) break;
+                        data_offset += (u64)slice_pitch * depth;
+                        if (width > 1) width >>= 1;
+                        if (height > 1) height >>= 1;
+                        if (depth > 1) depth >>= 1;
+                    }
+                }
+                if ((u64)region.x + region.width > width || (u64)region.y + region.height > height || (u64)region.z + region.depth > depth)
+                {
+                    return set_error(BasicError::out_of_range(), "The specified region exceeds the subresource.");
+                }
+                // For block-compressed formats, one element is one 4x4 block.
+                u32 element_x = region.x;
+                u32 element_y = region.y;
+                u32 num_elements_x = region.width;
+                u32 num_rows = region.height;
+                usize element_size = bits_per_pixel(desc.format) / 8;
+                if (is_compressed(desc.format))
+                {
+                    if ((region.x % 4) || (region.y % 4) ||
+                        ((region.width % 4) && region.x + region.width != width) ||
+                        ((region.height % 4) && region.y + region.height != height))
+                    {
+                        return set_error(BasicError::bad_arguments(), "The region of one block-compressed image must be aligned to 4x4 blocks.");
+                    }
+                    element_x = region.x / 4;
+                    element_y = region.y / 4;
+                    num_elements_x = (region.width + 3) / 4;
+                    num_rows = (region.height + 3) / 4;
+                    element_size = bits_per_pixel(desc.format) * 16 / 8;
+                }
+                usize copy_size = num_elements_x * element_size;
+                for (u32 z = 0; z < region.depth; ++z)
+                {
+                    u64 slice_offset = data_offset + (u64)(region.z + z) * slice_pitch;
+                    byte_t* dst_slice = (byte_t*)dst + z * dst_slice_pitch;
+                    if (copy_size == row_pitch && dst_row_pitch == row_pitch)
+                    {
+                        // Rows are contiguous in both the file and the destination buffer.
+                        luexp(stream->seek(slice_offset + (u64)element_y * row_pitch, SeekMode::begin));
+                        usize read_bytes = 0;
+                        luexp(stream->read(dst_slice, copy_size * num_rows, &read_bytes));
+                        if (read_bytes != copy_size * num_rows) return BasicError::end_of_file();
+                        continue;
+                    }
+                    for (u32 row = 0; row < num_rows; ++row)
+                    {
+                        luexp(stream->seek(slice_offset + (u64)(element_y + row) * row_pitch + (u64)element_x * element_size, SeekMode::begin));
+                        usize read_bytes = 0;
+                        luexp(stream->read(dst_slice + row * dst_row_pitch, copy_size, &read_bytes));
+                        if (read_bytes != copy_size) return BasicError::end_of_file();
+                    }
+                }
+            }
+            lucatchret;
+            return ok;
+        }
         constexpr u32 DDS_SURFACE_FLAGS_TEXTURE = 0x00001000; // DDSCAPS_TEXTURE
         constexpr u32 DDS_SURFACE_FLAGS_MIPMAP = 0x00400008; // DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
         constexpr u32 DDS_SURFACE_FLAGS_CUBEMAP = 0x00000008;// DDSCAPS_COMPLEX
@@ -0,0 +1,134 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file HDRRowDecoder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "../Image.hpp"
+#include "../RowDecoder.hpp"
+#include <math.h>
+
+namespace Luna
+{
+	namespace Image
+	{
+		bool is_hdr_stream(StreamReader& reader)
+		{
+			constexpr const c8 radiance_sig[] = "#?RADIANCE\n";
+			constexpr const c8 rgbe_sig[] = "#?RGBE\n";
+			if (reader.available() >= sizeof(radiance_sig) - 1 && !memcmp(reader.peek(), radiance_sig, sizeof(radiance_sig) - 1)) return true;
+			if (reader.available() >= sizeof(rgbe_sig) - 1 && !memcmp(reader.peek(), rgbe_sig, sizeof(rgbe_sig) - 1)) return true;
+			return false;
+		}
+
+		//! Reads one header line without the line feed character.
+		static RV read_hdr_line(StreamReader& reader, c8* buf, usize buf_size)
+		{
+			usize len = 0;
+			lutry
+			{
+				while (true)
+				{
+					lulet(c, reader.read_u8());
+					if (c == '\n') break;
+					// Long lines are truncated, which is fine since we only check short lines.
+					if (len + 1 < buf_size) buf[len++] = (c8)c;
+				}
+			}
+			lucatchret;
+			buf[len] = 0;
+			return ok;
+		}
+
+		inline void rgbe_to_float(const u8* rgbe, f32* dst)
+		{
+			if (rgbe[3])
+			{
+				f32 f = ldexpf(1.0f, (i32)rgbe[3] - (128 + 8));
+				dst[0] = rgbe[0] * f;
+				dst[1] = rgbe[1] * f;
+				dst[2] = rgbe[2] * f;
+			}
+			else
+			{
+				dst[0] = dst[1] = dst[2] = 0.0f;
+			}
+		}
+
+		RV decode_hdr_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback)
+		{
+			lutry
+			{
+				c8 line[256];
+				luexp(read_hdr_line(reader, line, sizeof(line)));
+				bool valid_format = false;
+				while (true)
+				{
+					luexp(read_hdr_line(reader, line, sizeof(line)));
+					if (!line[0]) break;
+					if (!strcmp(line, "FORMAT=32-bit_rle_rgbe")) valid_format = true;
+				}
+				if (!valid_format) return ImageError::file_parse_error();
+				luexp(read_hdr_line(reader, line, sizeof(line)));
+				// Only the standard "-Y height +X width" orientation is supported, which is the same as `read_image_file`.
+				if (strncmp(line, "-Y ", 3)) return ImageError::file_parse_error();
+				c8* p = line + 3;
+				u32 height = (u32)strtoul(p, &p, 10);
+				while (*p == ' ') ++p;
+				if (strncmp(p, "+X ", 3)) return ImageError::file_parse_error();
+				u32 width = (u32)strtoul(p + 3, nullptr, 10);
+				luexp(sink.init(width, height, 3, ChannelType::float32, false, desired_format, band_rows, callback));
+				Blob scanline((usize)width * 4);
+				u8* rgbe = scanline.data();
+				for (u32 y = 0; y < height; ++y)
+				{
+					u8 head[4];
+					luexp(reader.read(head, 4));
+					bool rle = width >= 8 && width < 32768 && head[0] == 2 && head[1] == 2 && !(head[2] & 0x80);
+					if (!rle)
+					{
+						// Flat scanline.
+						memcpy(rgbe, head, 4);
+						luexp(reader.read(rgbe + 4, ((usize)width - 1) * 4));
+					}
+					else
+					{
+						if ((u32)((head[2] << 8) | head[3]) != width) return ImageError::file_parse_error();
+						// Every channel is run-length encoded separately.
+						for (u32 c = 0; c < 4; ++c)
+						{
+							u32 x = 0;
+							while (x < width)
+							{
+								lulet(count, reader.read_u8());
+								if (count > 128)
+								{
+									u32 n = count - 128;
+									if (x + n > width) return ImageError::file_parse_error();
+									lulet(value, reader.read_u8());
+									for (u32 i = 0; i < n; ++i) rgbe[(x++) * 4 + c] = value;
+								}
+								else
+								{
+									if (!count || x + count > width) return ImageError::file_parse_error();
+									for (u32 i = 0; i < count; ++i)
+									{
+										luset(rgbe[(x++) * 4 + c], reader.read_u8());
+									}
+								}
+							}
+						}
+					}
+					f32* dst = (f32*)sink.get_row_buffer();
+					for (u32 x = 0; x < width; ++x) rgbe_to_float(rgbe + x * 4, dst + x * 3);
+					luexp(sink.commit_row());
+				}
+			}
+			lucatchret;
+			return ok;
+		}
+	}
+}
@@ -0,0 +1,674 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PNGRowDecoder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "../Image.hpp"
+#include "../RowDecoder.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		inline u32 read_u32_be(const u8* p)
+		{
+			return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | (u32)p[3];
+		}
+		inline u32 make_chunk_type(char a, char b, char c, char d)
+		{
+			return ((u32)(u8)a << 24) | ((u32)(u8)b << 16) | ((u32)(u8)c << 8) | (u32)(u8)d;
+		}
+
+		//! Reads the compressed data stored in consecutive IDAT chunks.
+		struct IDATReader
+		{
+			StreamReader* m_reader;
+			//! The number of bytes not read in the current IDAT chunk.
+			u32 m_remaining = 0;
+			bool m_end = false;
+
+			R<u8> read_u8()
+			{
+				while (!m_remaining)
+				{
+					if (m_end) return BasicError::end_of_file();
+					// Skips CRC of the current chunk and reads the header of the next chunk.
+					u8 header[12];
+					RV r = m_reader->read(header, 12);
+					if (failed(r)) return r.errcode();
+					if (read_u32_be(header + 8) != make_chunk_type('I', 'D', 'A', 'T'))
+					{
+						m_end = true;
+						return BasicError::end_of_file();
+					}
+					m_remaining = read_u32_be(header + 4);
+				}
+				--m_remaining;
+				return m_reader->read_u8();
+			}
+		};
+
+		constexpr u32 HUFFMAN_FAST_BITS = 9;
+		constexpr u32 HUFFMAN_MAX_BITS = 15;
+
+		//! The canonical Huffman table used by DEFLATE.
+		struct HuffmanTable
+		{
+			//! Indexed by the next `HUFFMAN_FAST_BITS` bits, stores `(symbol << 4) | length`, or 0 if the code is longer.
+			u16 m_fast[1 << HUFFMAN_FAST_BITS];
+			//! The number of codes of every length.
+			u16 m_count[HUFFMAN_MAX_BITS + 1];
+			//! Symbols sorted by code.
+			u16 m_symbol[288];
+
+			bool build(const u8* lengths, u32 num_symbols)
+			{
+				memzero(m_fast, sizeof(m_fast));
+				memzero(m_count, sizeof(m_count));
+				for (u32 i = 0; i < num_symbols; ++i) ++m_count[lengths[i]];
+				m_count[0] = 0;
+				u16 offsets[HUFFMAN_MAX_BITS + 2];
+				u32 next_code[HUFFMAN_MAX_BITS + 1];
+				offsets[1] = 0;
+				u32 code = 0;
+				i32 left = 1;
+				for (u32 len = 1; len <= HUFFMAN_MAX_BITS; ++len)
+				{
+					left = (left << 1) - m_count[len];
+					// Over-subscribed.
+					if (left < 0) return false;
+					offsets[len + 1] = offsets[len] + m_count[len];
+					next_code[len] = code;
+					code = (code + m_count[len]) << 1;
+				}
+				for (u32 i = 0; i < num_symbols; ++i)
+				{
+					u32 len = lengths[i];
+					if (!len) continue;
+					m_symbol[offsets[len]++] = (u16)i;
+					if (len <= HUFFMAN_FAST_BITS)
+					{
+						// DEFLATE stores codes starting from the most significant bit, so the code is reversed.
+						u32 c = next_code[len];
+						u32 rev = 0;
+						for (u32 b = 0; b < len; ++b) rev |= ((c >> b) & 1) << (len - 1 - b);
+						for (u32 j = rev; j < (1u << HUFFMAN_FAST_BITS); j += (1u << len)) m_fast[j] = (u16)((i << 4) | len);
+					}
+					++next_code[len];
+				}
+				return true;
+			}
+		};
+
+		//! Decompresses one zlib stream incrementally, so that only the 32KB sliding window is kept in memory.
+		struct Inflater
+		{
+			IDATReader m_input;
+			u64 m_bits = 0;
+			u32 m_num_bits = 0;
+			//! The number of padding bytes inserted after the input ends.
+			u32 m_num_padding_bytes = 0;
+			bool m_final_block = false;
+			//! 0: No block is being decoded. 1: Stored block. 2: Huffman block.
+			u32 m_block_state = 0;
+			u32 m_stored_remaining = 0;
+			u32 m_copy_len = 0;
+			u32 m_copy_dist = 0;
+			u64 m_total_out = 0;
+			//! The Adler-32 checksum of the decompressed data. The modulo is deferred to every `ADLER_BATCH_SIZE` bytes.
+			u32 m_adler_a = 1;
+			u32 m_adler_b = 0;
+			u32 m_adler_pending = 0;
+			Blob m_window;
+			u32 m_window_pos = 0;
+			HuffmanTable m_lit;
+			HuffmanTable m_dist;
+
+			static constexpr u32 WINDOW_SIZE = 32768;
+			static constexpr u32 ADLER_MOD = 65521;
+			//! The maximum number of bytes that can be summed before `m_adler_b` may overflow.
+			static constexpr u32 ADLER_BATCH_SIZE = 5552;
+
+			Inflater() : m_window(WINDOW_SIZE) {}
+
+			RV ensure_bits(u32 n)
+			{
+				while (m_num_bits < n)
+				{
+					auto b = m_input.read_u8();
+					u64 v = 0;
+					if (succeeded(b)) v = b.get();
+					else
+					{
+						// Pads zero bytes so that the last codes can be decoded using fast tables. Running out of data
+						// is reported only if the padding bytes are actually consumed.
+						if (b.errcode() != BasicError::end_of_file()) return b.errcode();
+						++m_num_padding_bytes;
+					}
+					m_bits |= v << m_num_bits;
+					m_num_bits += 8;
+				}
+				return ok;
+			}
+			void consume_bits(u32 n)
+			{
+				m_bits >>= n;
+				m_num_bits -= n;
+			}
+			RV check_overrun()
+			{
+				return m_num_padding_bytes * 8 > m_num_bits ? ImageError::file_parse_error() : ok;
+			}
+			R<u32> get_bits(u32 n)
+			{
+				if (!n) return 0;
+				RV r = ensure_bits(n);
+				if (failed(r)) return r.errcode();
+				u32 v = (u32)(m_bits & ((1ull << n) - 1));
+				consume_bits(n);
+				return v;
+			}
+			R<u32> decode(const HuffmanTable& h)
+			{
+				RV r = ensure_bits(HUFFMAN_MAX_BITS);
+				if (failed(r)) return r.errcode();
+				u16 e = h.m_fast[m_bits & ((1 << HUFFMAN_FAST_BITS) - 1)];
+				if (e)
+				{
+					consume_bits(e & 15);
+					return (u32)(e >> 4);
+				}
+				u32 code = 0;
+				u32 first = 0;
+				u32 index = 0;
+				for (u32 len = 1; len <= HUFFMAN_MAX_BITS; ++len)
+				{
+					code |= (u32)(m_bits >> (len - 1)) & 1;
+					u32 count = h.m_count[len];
+					if (code - first < count)
+					{
+						consume_bits(len);
+						return (u32)h.m_symbol[index + code - first];
+					}
+					index += count;
+					first += count;
+					first <<= 1;
+					code <<= 1;
+				}
+				return ImageError::file_parse_error();
+			}
+			RV read_dynamic_tables()
+			{
+				constexpr u8 order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+				lutry
+				{
+					lulet(hlit, get_bits(5));
+					lulet(hdist, get_bits(5));
+					lulet(hclen, get_bits(4));
+					hlit += 257;
+					hdist += 1;
+					hclen += 4;
+					if (hlit > 286 || hdist > 30) return ImageError::file_parse_error();
+					u8 lengths[286 + 30];
+					memzero(lengths, 19);
+					for (u32 i = 0; i < hclen; ++i)
+					{
+						luset(lengths[order[i]], get_bits(3));
+					}
+					HuffmanTable& codelen = m_dist;
+					if (!codelen.build(lengths, 19)) return ImageError::file_parse_error();
+					u32 n = 0;
+					while (n < hlit + hdist)
+					{
+						lulet(sym, decode(codelen));
+						if (sym < 16)
+						{
+							lengths[n++] = (u8)sym;
+							continue;
+						}
+						u8 value = 0;
+						u32 repeat;
+						if (sym == 16)
+						{
+							if (!n) return ImageError::file_parse_error();
+							value = lengths[n - 1];
+							luset(repeat, get_bits(2));
+							repeat += 3;
+						}
+						else if (sym == 17)
+						{
+							luset(repeat, get_bits(3));
+							repeat += 3;
+						}
+						else
+						{
+							luset(repeat, get_bits(7));
+							repeat += 11;
+						}
+						if (n + repeat > hlit + hdist) return ImageError::file_parse_error();
+						memset(lengths + n, value, repeat);
+						n += repeat;
+					}
+					if (!m_lit.build(lengths, hlit) || !m_dist.build(lengths + hlit, hdist)) return ImageError::file_parse_error();
+				}
+				lucatchret;
+				return ok;
+			}
+			void build_fixed_tables()
+			{
+				u8 lengths[288];
+				memset(lengths, 8, 144);
+				memset(lengths + 144, 9, 112);
+				memset(lengths + 256, 7, 24);
+				memset(lengths + 280, 8, 8);
+				m_lit.build(lengths, 288);
+				memset(lengths, 5, 30);
+				m_dist.build(lengths, 30);
+			}
+			RV begin_block()
+			{
+				if (m_final_block) return ImageError::file_parse_error();
+				lutry
+				{
+					lulet(final_block, get_bits(1));
+					lulet(type, get_bits(2));
+					m_final_block = final_block != 0;
+					if (type == 0)
+					{
+						consume_bits(m_num_bits % 8);
+						lulet(len, get_bits(16));
+						lulet(nlen, get_bits(16));
+						if ((len ^ 0xFFFF) != nlen) return ImageError::file_parse_error();
+						m_stored_remaining = len;
+						m_block_state = 1;
+					}
+					else if (type == 1)
+					{
+						build_fixed_tables();
+						m_block_state = 2;
+					}
+					else if (type == 2)
+					{
+						luexp(read_dynamic_tables());
+						m_block_state = 2;
+					}
+					else return ImageError::file_parse_error();
+				}
+				lucatchret;
+				return ok;
+			}
+			void emit(u8* dst, u8 b)
+			{
+				*dst = b;
+				m_window.data()[m_window_pos] = b;
+				m_window_pos = (m_window_pos + 1) & (WINDOW_SIZE - 1);
+				++m_total_out;
+				m_adler_a += b;
+				m_adler_b += m_adler_a;
+				if (++m_adler_pending == ADLER_BATCH_SIZE)
+				{
+					m_adler_a %= ADLER_MOD;
+					m_adler_b %= ADLER_MOD;
+					m_adler_pending = 0;
+				}
+			}
+			//! Decompresses exactly `size` bytes.
+			RV read(u8* dst, usize size)
+			{
+				constexpr u16 len_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+					35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+				constexpr u8 len_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+				constexpr u16 dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+					257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+				constexpr u8 dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+				lutry
+				{
+					while (size)
+					{
+						if (m_copy_len)
+						{
+							u32 n = (u32)min<usize>(m_copy_len, size);
+							u8* window = m_window.data();
+							for (u32 i = 0; i < n; ++i)
+							{
+								emit(dst++, window[(m_window_pos - m_copy_dist) & (WINDOW_SIZE - 1)]);
+							}
+							m_copy_len -= n;
+							size -= n;
+						}
+						else if (m_block_state == 1)
+						{
+							if (!m_stored_remaining)
+							{
+								m_block_state = 0;
+								continue;
+							}
+							lulet(b, get_bits(8));
+							emit(dst++, (u8)b);
+							--m_stored_remaining;
+							--size;
+						}
+						else if (m_block_state == 2)
+						{
+							lulet(sym, decode(m_lit));
+							if (sym < 256)
+							{
+								emit(dst++, (u8)sym);
+								--size;
+							}
+							else if (sym == 256)
+							{
+								m_block_state = 0;
+							}
+							else
+							{
+								sym -= 257;
+								if (sym >= 29) return ImageError::file_parse_error();
+								lulet(len, get_bits(len_extra[sym]));
+								lulet(dist_sym, decode(m_dist));
+								if (dist_sym >= 30) return ImageError::file_parse_error();
+								lulet(dist, get_bits(dist_extra[dist_sym]));
+								dist += dist_base[dist_sym];
+								if (dist > m_total_out) return ImageError::file_parse_error();
+								m_copy_len = len + len_base[sym];
+								m_copy_dist = dist;
+							}
+						}
+						else
+						{
+							luexp(begin_block());
+						}
+					}
+					luexp(check_overrun());
+				}
+				lucatchret;
+				return ok;
+			}
+			//! Decodes the end of the stream after all data is read, and verifies the Adler-32 checksum of the data.
+			RV finish()
+			{
+				lutry
+				{
+					// The rest of the stream must not produce more data.
+					while (m_block_state || !m_final_block)
+					{
+						if (m_copy_len) return ImageError::file_parse_error();
+						if (m_block_state == 1)
+						{
+							if (m_stored_remaining) return ImageError::file_parse_error();
+							m_block_state = 0;
+						}
+						else if (m_block_state == 2)
+						{
+							lulet(sym, decode(m_lit));
+							if (sym != 256) return ImageError::file_parse_error();
+							m_block_state = 0;
+						}
+						else
+						{
+							luexp(begin_block());
+						}
+					}
+					// The checksum is stored in big-endian order starting from the next byte boundary.
+					consume_bits(m_num_bits % 8);
+					u32 checksum = 0;
+					for (u32 i = 0; i < 4; ++i)
+					{
+						lulet(b, get_bits(8));
+						checksum = (checksum << 8) | b;
+					}
+					luexp(check_overrun());
+					u32 adler = ((m_adler_b % ADLER_MOD) << 16) | (m_adler_a % ADLER_MOD);
+					if (checksum != adler) return set_error(ImageError::file_parse_error(), "The Adler-32 checksum of the PNG image data does not match.");
+				}
+				lucatchret;
+				return ok;
+			}
+		};
+
+		constexpr u8 PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+		bool is_png_stream(StreamReader& reader)
+		{
+			return reader.available() >= 8 && !memcmp(reader.peek(), PNG_SIGNATURE, 8);
+		}
+
+		inline u8 paeth_predictor(i32 a, i32 b, i32 c)
+		{
+			i32 p = a + b - c;
+			i32 pa = p > a ? p - a : a - p;
+			i32 pb = p > b ? p - b : b - p;
+			i32 pc = p > c ? p - c : c - p;
+			if (pa <= pb && pa <= pc) return (u8)a;
+			if (pb <= pc) return (u8)b;
+			return (u8)c;
+		}
+
+		static RV unfilter_row(u8 filter, u8* cur, const u8* prev, usize row_bytes, usize bpp)
+		{
+			switch (filter)
+			{
+			case 0: break;
+			case 1:
+				for (usize i = bpp; i < row_bytes; ++i) cur[i] += cur[i - bpp];
+				break;
+			case 2:
+				for (usize i = 0; i < row_bytes; ++i) cur[i] += prev[i];
+				break;
+			case 3:
+				for (usize i = 0; i < bpp; ++i) cur[i] += prev[i] >> 1;
+				for (usize i = bpp; i < row_bytes; ++i) cur[i] += (u8)(((u32)cur[i - bpp] + (u32)prev[i]) >> 1);
+				break;
+			case 4:
+				for (usize i = 0; i < bpp; ++i) cur[i] += prev[i];
+				for (usize i = bpp; i < row_bytes; ++i) cur[i] += paeth_predictor(cur[i - bpp], prev[i], prev[i - bpp]);
+				break;
+			default: return ImageError::file_parse_error();
+			}
+			return ok;
+		}
+
+		RV decode_png_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback)
+		{
+			lutry
+			{
+				luexp(reader.skip(8));
+				u32 width = 0, height = 0;
+				u8 depth = 0, color_type = 0;
+				u8 palette[256 * 4];
+				u32 palette_size = 0;
+				bool has_trns = false;
+				u16 trns[3] = { 0, 0, 0 };
+				bool has_header = false;
+				Inflater inflater;
+				inflater.m_input.m_reader = &reader;
+				// Parses chunks before the first IDAT chunk.
+				while (true)
+				{
+					u8 chunk_header[8];
+					luexp(reader.read(chunk_header, 8));
+					u32 len = read_u32_be(chunk_header);
+					u32 type = read_u32_be(chunk_header + 4);
+					if (type == make_chunk_type('I', 'H', 'D', 'R'))
+					{
+						u8 ihdr[13];
+						if (len != 13) return ImageError::file_parse_error();
+						luexp(reader.read(ihdr, 13));
+						width = read_u32_be(ihdr);
+						height = read_u32_be(ihdr + 4);
+						depth = ihdr[8];
+						color_type = ihdr[9];
+						if (ihdr[10] || ihdr[11]) return ImageError::file_parse_error();
+						if (ihdr[12]) return set_error(BasicError::not_supported(), "Interlaced PNG files cannot be decoded by rows.");
+						if (color_type > 6 || color_type == 1 || color_type == 5) return ImageError::file_parse_error();
+						if (depth != 1 && depth != 2 && depth != 4 && depth != 8 && depth != 16) return ImageError::file_parse_error();
+						if (color_type == 3 && depth == 16) return ImageError::file_parse_error();
+						if ((color_type == 2 || color_type == 4 || color_type == 6) && depth < 8) return ImageError::file_parse_error();
+						has_header = true;
+					}
+					else if (type == make_chunk_type('P', 'L', 'T', 'E'))
+					{
+						if (len > 256 * 3 || len % 3) return ImageError::file_parse_error();
+						palette_size = len / 3;
+						for (u32 i = 0; i < palette_size; ++i)
+						{
+							luexp(reader.read(palette + i * 4, 3));
+							palette[i * 4 + 3] = 255;
+						}
+					}
+					else if (type == make_chunk_type('t', 'R', 'N', 'S'))
+					{
+						if (color_type == 3)
+						{
+							if (len > palette_size) return ImageError::file_parse_error();
+							for (u32 i = 0; i < len; ++i)
+							{
+								luset(palette[i * 4 + 3], reader.read_u8());
+							}
+							has_trns = true;
+						}
+						else if (color_type == 0 || color_type == 2)
+						{
+							u32 num_values = color_type == 0 ? 1 : 3;
+							if (len != num_values * 2) return ImageError::file_parse_error();
+							u8 data[6];
+							luexp(reader.read(data, len));
+							for (u32 i = 0; i < num_values; ++i) trns[i] = (u16)((data[i * 2] << 8) | data[i * 2 + 1]);
+							has_trns = true;
+						}
+						else
+						{
+							luexp(reader.skip(len));
+						}
+					}
+					else if (type == make_chunk_type('I', 'D', 'A', 'T'))
+					{
+						inflater.m_input.m_remaining = len;
+						break;
+					}
+					else if (type == make_chunk_type('I', 'E', 'N', 'D'))
+					{
+						return ImageError::file_parse_error();
+					}
+					else
+					{
+						// Critical chunks that we do not know cannot be skipped.
+						if (!(chunk_header[4] & 0x20)) return ImageError::file_parse_error();
+						luexp(reader.skip(len));
+					}
+					if (type != make_chunk_type('I', 'D', 'A', 'T'))
+					{
+						// Skips CRC.
+						luexp(reader.skip(4));
+					}
+				}
+				if (!has_header) return ImageError::file_parse_error();
+				if (color_type == 3 && !palette_size) return ImageError::file_parse_error();
+				// Checks zlib header.
+				lulet(cmf, inflater.get_bits(8));
+				lulet(flg, inflater.get_bits(8));
+				if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 || (flg & 0x20)) return ImageError::file_parse_error();
+
+				u32 file_channels;
+				switch (color_type)
+				{
+				case 0: file_channels = 1; break;
+				case 2: file_channels = 3; break;
+				case 3: file_channels = 1; break;
+				case 4: file_channels = 2; break;
+				default: file_channels = 4; break;
+				}
+				u32 src_num_channels = color_type == 3 ? (has_trns ? 4 : 3) : file_channels + (has_trns ? 1 : 0);
+				ChannelType src_type = depth == 16 ? ChannelType::unorm16 : ChannelType::unorm8;
+				luexp(sink.init(width, height, src_num_channels, src_type, false, desired_format, band_rows, callback));
+
+				usize row_bytes = ((usize)width * file_channels * depth + 7) / 8;
+				usize filter_bpp = max<usize>((file_channels * depth) / 8, 1);
+				Blob rows(row_bytes * 2);
+				u8* prev = rows.data();
+				u8* cur = rows.data() + row_bytes;
+				memzero(prev, row_bytes);
+				// Scales low-bit-depth gray values to [0, 255].
+				constexpr u8 depth_scale[9] = { 0, 255, 85, 0, 17, 0, 0, 0, 1 };
+				for (u32 y = 0; y < height; ++y)
+				{
+					u8 filter;
+					luexp(inflater.read(&filter, 1));
+					luexp(inflater.read(cur, row_bytes));
+					luexp(unfilter_row(filter, cur, prev, row_bytes, filter_bpp));
+					byte_t* out = sink.get_row_buffer();
+					if (depth == 16)
+					{
+						u16* dst = (u16*)out;
+						for (u32 x = 0; x < width; ++x)
+						{
+							const u8* src = cur + (usize)x * file_channels * 2;
+							bool transparent = has_trns;
+							for (u32 c = 0; c < file_channels; ++c)
+							{
+								u16 v = (u16)((src[c * 2] << 8) | src[c * 2 + 1]);
+								if (has_trns && v != trns[c]) transparent = false;
+								*dst++ = v;
+							}
+							if (has_trns) *dst++ = transparent ? 0 : 65535;
+						}
+					}
+					else if (color_type == 3)
+					{
+						u8* dst = (u8*)out;
+						u32 entry_size = has_trns ? 4 : 3;
+						for (u32 x = 0; x < width; ++x)
+						{
+							u32 index;
+							if (depth == 8) index = cur[x];
+							else
+							{
+								u32 bit = x * depth;
+								index = (cur[bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+							}
+							// Out-of-range indices are decoded as black to be tolerant to broken files.
+							if (index < palette_size) memcpy(dst, palette + index * 4, entry_size);
+							else
+							{
+								memzero(dst, entry_size);
+								if (has_trns) dst[3] = 255;
+							}
+							dst += entry_size;
+						}
+					}
+					else
+					{
+						u8* dst = (u8*)out;
+						for (u32 x = 0; x < width; ++x)
+						{
+							bool transparent = has_trns;
+							for (u32 c = 0; c < file_channels; ++c)
+							{
+								u32 v;
+								if (depth == 8) v = cur[(usize)x * file_channels + c];
+								else
+								{
+									u32 bit = x * depth;
+									v = (cur[bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+								}
+								if (has_trns && v != trns[c]) transparent = false;
+								*dst++ = (u8)(v * depth_scale[depth]);
+							}
+							if (has_trns) *dst++ = transparent ? 0 : 255;
+						}
+					}
+					luexp(sink.commit_row());
+					swap(prev, cur);
+				}
+				luexp(inflater.finish());
+			}
+			lucatchret;
+			return ok;
+		}
+	}
+}
@@ -0,0 +1,198 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file TGARowDecoder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "../Image.hpp"
+#include "../RowDecoder.hpp"
+
+namespace Luna
+{
+	namespace Image
+	{
+		struct TGAHeader
+		{
+			u8 id_length;
+			u8 color_map_type;
+			u8 image_type;
+			u16 color_map_first;
+			u16 color_map_length;
+			u8 color_map_bits;
+			u16 width;
+			u16 height;
+			u8 bits_per_pixel;
+			u8 descriptor;
+		};
+
+		inline TGAHeader parse_tga_header(const u8* p)
+		{
+			TGAHeader h;
+			h.id_length = p[0];
+			h.color_map_type = p[1];
+			h.image_type = p[2];
+			h.color_map_first = (u16)(p[3] | (p[4] << 8));
+			h.color_map_length = (u16)(p[5] | (p[6] << 8));
+			h.color_map_bits = p[7];
+			h.width = (u16)(p[12] | (p[13] << 8));
+			h.height = (u16)(p[14] | (p[15] << 8));
+			h.bits_per_pixel = p[16];
+			h.descriptor = p[17];
+			return h;
+		}
+
+		inline bool is_valid_tga_bits(u8 bits)
+		{
+			return bits == 8 || bits == 15 || bits == 16 || bits == 24 || bits == 32;
+		}
+
+		bool is_tga_stream(StreamReader& reader)
+		{
+			// TGA files do not have signatures, so we validate header fields instead.
+			if (reader.available() < 18) return false;
+			TGAHeader h = parse_tga_header(reader.peek());
+			if (h.color_map_type > 1) return false;
+			if (h.color_map_type == 1)
+			{
+				if (h.image_type != 1 && h.image_type != 9) return false;
+				if (!is_valid_tga_bits(h.color_map_bits)) return false;
+				if (h.bits_per_pixel != 8 && h.bits_per_pixel != 16) return false;
+			}
+			else
+			{
+				if (h.image_type != 2 && h.image_type != 3 && h.image_type != 10 && h.image_type != 11) return false;
+				if (!is_valid_tga_bits(h.bits_per_pixel)) return false;
+			}
+			return h.width && h.height;
+		}
+
+		//! Converts one TGA pixel to 8-bit RGB(A) or gray(-alpha).
+		inline void convert_tga_pixel(const u8* src, u32 bits, bool gray, u8* dst)
+		{
+			if (gray)
+			{
+				dst[0] = src[0];
+				if (bits == 16) dst[1] = src[1];
+				return;
+			}
+			switch (bits)
+			{
+			case 15:
+			case 16:
+			{
+				u32 px = src[0] | (src[1] << 8);
+				dst[0] = (u8)(((px >> 10) & 31) * 255 / 31);
+				dst[1] = (u8)(((px >> 5) & 31) * 255 / 31);
+				dst[2] = (u8)((px & 31) * 255 / 31);
+				break;
+			}
+			case 24:
+				dst[0] = src[2];
+				dst[1] = src[1];
+				dst[2] = src[0];
+				break;
+			case 32:
+				dst[0] = src[2];
+				dst[1] = src[1];
+				dst[2] = src[0];
+				dst[3] = src[3];
+				break;
+			}
+		}
+
+		inline u32 get_tga_num_channels(u32 bits, bool gray)
+		{
+			switch (bits)
+			{
+			case 8: return gray ? 1 : 3;
+			case 16: return gray ? 2 : 3;
+			case 15:
+			case 24: return 3;
+			default: return 4;
+			}
+		}
+
+		RV decode_tga_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback)
+		{
+			lutry
+			{
+				u8 header_data[18];
+				luexp(reader.read(header_data, 18));
+				TGAHeader h = parse_tga_header(header_data);
+				luexp(reader.skip(h.id_length));
+				bool rle = h.image_type >= 9;
+				bool color_mapped = h.color_map_type == 1;
+				bool gray = (h.image_type & 7) == 3;
+				u32 bits = color_mapped ? h.color_map_bits : h.bits_per_pixel;
+				u32 num_channels = get_tga_num_channels(bits, gray);
+				// Color maps are converted to the output format when loaded.
+				Blob color_map;
+				if (h.color_map_type == 1)
+				{
+					u32 entry_size = (h.color_map_bits + 7) / 8;
+					color_map = Blob((usize)h.color_map_length * num_channels);
+					u8 entry[4];
+					for (u32 i = 0; i < h.color_map_length; ++i)
+					{
+						luexp(reader.read(entry, entry_size));
+						convert_tga_pixel(entry, h.color_map_bits, false, color_map.data() + i * num_channels);
+					}
+				}
+				else if (h.color_map_length)
+				{
+					luexp(reader.skip((usize)h.color_map_length * ((h.color_map_bits + 7) / 8)));
+				}
+				luexp(sink.init(h.width, h.height, num_channels, ChannelType::unorm8, (h.descriptor & 0x20) == 0, desired_format, band_rows, callback));
+				u32 pixel_size = (h.bits_per_pixel + 7) / 8;
+				u32 rle_count = 0;
+				bool rle_repeat = false;
+				u8 pixel[4];
+				for (u32 y = 0; y < h.height; ++y)
+				{
+					u8* dst = (u8*)sink.get_row_buffer();
+					for (u32 x = 0; x < h.width; ++x)
+					{
+						if (rle)
+						{
+							// RLE packets may cross row boundaries, so the packet state is kept between rows.
+							if (!rle_count)
+							{
+								lulet(packet, reader.read_u8());
+								rle_count = (packet & 0x7F) + 1;
+								rle_repeat = (packet & 0x80) != 0;
+								luexp(reader.read(pixel, pixel_size));
+							}
+							else if (!rle_repeat)
+							{
+								luexp(reader.read(pixel, pixel_size));
+							}
+							--rle_count;
+						}
+						else
+						{
+							luexp(reader.read(pixel, pixel_size));
+						}
+						if (color_mapped)
+						{
+							u32 index = pixel_size == 1 ? pixel[0] : (pixel[0] | (pixel[1] << 8));
+							index = index >= h.color_map_first ? index - h.color_map_first : index;
+							if (index >= h.color_map_length) return ImageError::file_parse_error();
+							memcpy(dst, color_map.data() + index * num_channels, num_channels);
+						}
+						else
+						{
+							convert_tga_pixel(pixel, bits, gray, dst);
+						}
+						dst += num_channels;
+					}
+					luexp(sink.commit_row());
+				}
+			}
+			lucatchret;
+			return ok;
+		}
+	}
+}
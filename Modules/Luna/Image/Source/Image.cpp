@@ -11,6 +11,7 @@
 #include "IO/STBImage.hpp"
 #include "IO/STBImageWrite.hpp"
 #include <Luna/Runtime/Module.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 namespace Luna
 {
@@ -283,6 +284,10 @@ namespace Luna
 		struct ImageModule : public Module
 		{
 			virtual const c8* get_name() override { return "Image"; }
+			virtual RV on_register() override
+			{
+				return add_dependency_modules(this, {module_job_system()});
+			}
 			virtual RV on_init() override
 			{
 				stbi_init();
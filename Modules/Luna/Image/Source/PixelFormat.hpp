@@ -0,0 +1,73 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PixelFormat.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../Image.hpp"
+#include <Luna/Runtime/Assert.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		enum class ChannelType : u8
+		{
+			unorm8,
+			unorm16,
+			float32,
+		};
+
+		struct PixelFormatInfo
+		{
+			u32 num_channels;
+			ChannelType type;
+		};
+
+		inline PixelFormatInfo get_pixel_format_info(ImageFormat format)
+		{
+			switch (format)
+			{
+			case ImageFormat::r8_unorm: return { 1, ChannelType::unorm8 };
+			case ImageFormat::rg8_unorm: return { 2, ChannelType::unorm8 };
+			case ImageFormat::rgb8_unorm: return { 3, ChannelType::unorm8 };
+			case ImageFormat::rgba8_unorm: return { 4, ChannelType::unorm8 };
+			case ImageFormat::r16_unorm: return { 1, ChannelType::unorm16 };
+			case ImageFormat::rg16_unorm: return { 2, ChannelType::unorm16 };
+			case ImageFormat::rgb16_unorm: return { 3, ChannelType::unorm16 };
+			case ImageFormat::rgba16_unorm: return { 4, ChannelType::unorm16 };
+			case ImageFormat::r32_float: return { 1, ChannelType::float32 };
+			case ImageFormat::rg32_float: return { 2, ChannelType::float32 };
+			case ImageFormat::rgb32_float: return { 3, ChannelType::float32 };
+			case ImageFormat::rgba32_float: return { 4, ChannelType::float32 };
+			default: lupanic(); return { 0, ChannelType::unorm8 };
+			}
+		}
+
+		//! Reads one pixel as 4 floats. `unorm` channels are normalized to [0, 1], channels not present in
+		//! the format are set to 0, and alpha is set to 1.
+		inline void load_pixel(const byte_t* src, const PixelFormatInfo& info, f32 dst[4])
+		{
+			dst[0] = 0.0f;
+			dst[1] = 0.0f;
+			dst[2] = 0.0f;
+			dst[3] = 1.0f;
+			switch (info.type)
+			{
+			case ChannelType::unorm8:
+				for (u32 c = 0; c < info.num_channels; ++c) dst[c] = (f32)((const u8*)src)[c] / 255.0f;
+				break;
+			case ChannelType::unorm16:
+				for (u32 c = 0; c < info.num_channels; ++c) dst[c] = (f32)((const u16*)src)[c] / 65535.0f;
+				break;
+			case ChannelType::float32:
+				for (u32 c = 0; c < info.num_channels; ++c) dst[c] = ((const f32*)src)[c];
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,542 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Resample.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "Image.hpp"
+#include "PixelFormat.hpp"
+#include "../Resample.hpp"
+#include <Luna/Runtime/Math/Math.hpp>
+#include <Luna/Runtime/Math/Simd.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		//! Pixels are filtered as 4 floats regardless of the source format, so that every pixel can be
+		//! processed by one SIMD register.
+		constexpr usize FILTER_PIXEL_SIZE = sizeof(f32) * 4;
+
+		//! The number of pixels processed by one job. Smaller images are processed on the calling thread.
+		constexpr usize RESAMPLE_PIXELS_PER_JOB = 16384;
+
+		inline f32 srgb_to_linear(f32 v)
+		{
+			return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+		}
+		inline f32 linear_to_srgb(f32 v)
+		{
+			return v <= 0.0031308f ? v * 12.92f : 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+		}
+
+		struct SRGBTable
+		{
+			f32 values[256];
+
+			SRGBTable()
+			{
+				for (u32 i = 0; i < 256; ++i) values[i] = srgb_to_linear((f32)i / 255.0f);
+			}
+		};
+
+		//! Returns the table that converts 8-bit sRGB values to linear values.
+		inline const f32* get_srgb_to_linear_table()
+		{
+			static SRGBTable table;
+			return table.values;
+		}
+
+		inline f32 sinc(f32 x)
+		{
+			if (fabsf(x) < 1e-5f) return 1.0f;
+			x *= PI;
+			return sinf(x) / x;
+		}
+
+		//! The zeroth order modified Bessel function of the first kind, used by the Kaiser window.
+		inline f32 bessel_i0(f32 x)
+		{
+			f32 sum = 1.0f;
+			f32 term = 1.0f;
+			f32 half_x = x * 0.5f;
+			for (u32 k = 1; k < 32; ++k)
+			{
+				f32 t = half_x / (f32)k;
+				term *= t * t;
+				sum += term;
+				if (term < sum * 1e-8f) break;
+			}
+			return sum;
+		}
+
+		constexpr f32 KAISER_RADIUS = 3.0f;
+		constexpr f32 KAISER_ALPHA = 4.0f;
+		constexpr f32 LANCZOS_RADIUS = 3.0f;
+
+		static f32 box_filter(f32 x)
+		{
+			return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+		}
+		static f32 triangle_filter(f32 x)
+		{
+			x = fabsf(x);
+			return x < 1.0f ? 1.0f - x : 0.0f;
+		}
+		static f32 kaiser_filter(f32 x)
+		{
+			x = fabsf(x);
+			if (x >= KAISER_RADIUS) return 0.0f;
+			f32 t = x / KAISER_RADIUS;
+			return sinc(x) * bessel_i0(KAISER_ALPHA * sqrtf(1.0f - t * t)) / bessel_i0(KAISER_ALPHA);
+		}
+		static f32 lanczos_filter(f32 x)
+		{
+			x = fabsf(x);
+			if (x >= LANCZOS_RADIUS) return 0.0f;
+			return sinc(x) * sinc(x / LANCZOS_RADIUS);
+		}
+
+		//! Stores source pixel indices and weights for every destination pixel along one axis.
+		struct ResampleWeights
+		{
+			//! Taps of destination pixel `i` are in range [`offsets[i]`, `offsets[i + 1]`).
+			Vector<u32> offsets;
+			Vector<u32> indices;
+			Vector<f32> weights;
+		};
+
+		static void compute_resample_weights(ResampleWeights& w, u32 src_size, u32 dst_size, ResampleFilter filter, bool wrap)
+		{
+			f32(*func)(f32);
+			f32 radius;
+			switch (filter)
+			{
+			case ResampleFilter::box: func = box_filter; radius = 0.5f; break;
+			case ResampleFilter::triangle: func = triangle_filter; radius = 1.0f; break;
+			case ResampleFilter::kaiser: func = kaiser_filter; radius = KAISER_RADIUS; break;
+			case ResampleFilter::lanczos: func = lanczos_filter; radius = LANCZOS_RADIUS; break;
+			default: lupanic(); return;
+			}
+			f32 scale = (f32)dst_size / (f32)src_size;
+			// The filter is stretched when downsampling, so that it covers all source pixels of one destination pixel.
+			f32 filter_scale = scale < 1.0f ? 1.0f / scale : 1.0f;
+			f32 support = max(radius * filter_scale, 0.5f);
+			w.offsets.resize(dst_size + 1);
+			w.offsets[0] = 0;
+			for (u32 i = 0; i < dst_size; ++i)
+			{
+				f32 center = ((f32)i + 0.5f) / scale;
+				i32 first = (i32)floorf(center - support);
+				i32 last = (i32)ceilf(center + support);
+				usize begin = w.weights.size();
+				f32 sum = 0.0f;
+				for (i32 j = first; j <= last; ++j)
+				{
+					f32 weight = func(((f32)j + 0.5f - center) / filter_scale);
+					if (weight == 0.0f) continue;
+					i32 index = wrap ? ((j % (i32)src_size) + (i32)src_size) % (i32)src_size : clamp(j, 0, (i32)src_size - 1);
+					w.indices.push_back((u32)index);
+					w.weights.push_back(weight);
+					sum += weight;
+				}
+				if (sum == 0.0f)
+				{
+					w.indices.resize(begin);
+					w.weights.resize(begin);
+					w.indices.push_back((u32)clamp((i32)center, 0, (i32)src_size - 1));
+					w.weights.push_back(1.0f);
+				}
+				else
+				{
+					f32 inv_sum = 1.0f / sum;
+					for (usize j = begin; j < w.weights.size(); ++j) w.weights[j] *= inv_sum;
+				}
+				w.offsets[i + 1] = (u32)w.weights.size();
+			}
+		}
+
+		//! Converts one row of pixels to linear float4 pixels.
+		static void decode_row(const byte_t* src, f32* dst, u32 width, const PixelFormatInfo& info, ResampleFlag flags)
+		{
+			u32 num_channels = info.num_channels;
+			bool srgb = test_flags(flags, ResampleFlag::srgb) && info.type != ChannelType::float32;
+			u32 num_color_channels = min<u32>(num_channels, 3);
+			for (u32 x = 0; x < width; ++x)
+			{
+				f32* p = dst + x * 4;
+				p[0] = 0.0f;
+				p[1] = 0.0f;
+				p[2] = 0.0f;
+				p[3] = 1.0f;
+				switch (info.type)
+				{
+				case ChannelType::unorm8:
+				{
+					const u8* s = (const u8*)src + x * num_channels;
+					const f32* table = srgb ? get_srgb_to_linear_table() : nullptr;
+					for (u32 c = 0; c < num_channels; ++c)
+					{
+						p[c] = (table && c < num_color_channels) ? table[s[c]] : (f32)s[c] / 255.0f;
+					}
+					break;
+				}
+				case ChannelType::unorm16:
+				{
+					const u16* s = (const u16*)src + x * num_channels;
+					for (u32 c = 0; c < num_channels; ++c)
+					{
+						f32 v = (f32)s[c] / 65535.0f;
+						p[c] = (srgb && c < num_color_channels) ? srgb_to_linear(v) : v;
+					}
+					break;
+				}
+				case ChannelType::float32:
+				{
+					const f32* s = (const f32*)src + x * num_channels;
+					for (u32 c = 0; c < num_channels; ++c) p[c] = s[c];
+					break;
+				}
+				}
+				if (num_channels == 4 && test_flags(flags, ResampleFlag::alpha_weighted))
+				{
+					p[0] *= p[3];
+					p[1] *= p[3];
+					p[2] *= p[3];
+				}
+			}
+		}
+
+		//! Converts one row of linear float4 pixels to the destination format.
+		static void encode_row(const f32* src, byte_t* dst, u32 width, const PixelFormatInfo& info, ResampleFlag flags)
+		{
+			u32 num_channels = info.num_channels;
+			bool srgb = test_flags(flags, ResampleFlag::srgb) && info.type != ChannelType::float32;
+			bool alpha_weighted = num_channels == 4 && test_flags(flags, ResampleFlag::alpha_weighted);
+			u32 num_color_channels = min<u32>(num_channels, 3);
+			for (u32 x = 0; x < width; ++x)
+			{
+				f32 p[4] = { src[x * 4], src[x * 4 + 1], src[x * 4 + 2], src[x * 4 + 3] };
+				if (alpha_weighted)
+				{
+					f32 inv_alpha = p[3] > 1e-6f ? 1.0f / p[3] : 0.0f;
+					p[0] *= inv_alpha;
+					p[1] *= inv_alpha;
+					p[2] *= inv_alpha;
+				}
+				switch (info.type)
+				{
+				case ChannelType::unorm8:
+				{
+					u8* d = (u8*)dst + x * num_channels;
+					for (u32 c = 0; c < num_channels; ++c)
+					{
+						f32 v = clamp(p[c], 0.0f, 1.0f);
+						if (srgb && c < num_color_channels) v = linear_to_srgb(v);
+						d[c] = (u8)(v * 255.0f + 0.5f);
+					}
+					break;
+				}
+				case ChannelType::unorm16:
+				{
+					u16* d = (u16*)dst + x * num_channels;
+					for (u32 c = 0; c < num_channels; ++c)
+					{
+						f32 v = clamp(p[c], 0.0f, 1.0f);
+						if (srgb && c < num_color_channels) v = linear_to_srgb(v);
+						d[c] = (u16)(v * 65535.0f + 0.5f);
+					}
+					break;
+				}
+				case ChannelType::float32:
+				{
+					f32* d = (f32*)dst + x * num_channels;
+					for (u32 c = 0; c < num_channels; ++c) d[c] = p[c];
+					break;
+				}
+				}
+			}
+		}
+
+		//! Filters one row of pixels horizontally.
+		static void resample_row(const f32* src, f32* dst, u32 dst_width, const ResampleWeights& w)
+		{
+			const u32* indices = w.indices.data();
+			const f32* weights = w.weights.data();
+			for (u32 x = 0; x < dst_width; ++x)
+			{
+				u32 begin = w.offsets[x];
+				u32 end = w.offsets[x + 1];
+#ifdef LUNA_SIMD
+				using namespace Simd;
+				float4 acc = setzero_f4();
+				for (u32 t = begin; t < end; ++t)
+				{
+					acc = muladd_f4(load_f4(src + indices[t] * 4), dup_f4(weights[t]), acc);
+				}
+				store_f4(dst + x * 4, acc);
+#else
+				f32 acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (u32 t = begin; t < end; ++t)
+				{
+					const f32* s = src + indices[t] * 4;
+					f32 weight = weights[t];
+					acc[0] += s[0] * weight;
+					acc[1] += s[1] * weight;
+					acc[2] += s[2] * weight;
+					acc[3] += s[3] * weight;
+				}
+				memcpy(dst + x * 4, acc, FILTER_PIXEL_SIZE);
+#endif
+			}
+		}
+
+		//! Adds one weighted row of pixels to the destination row.
+		static void accumulate_row(const f32* src, f32* dst, u32 width, f32 weight)
+		{
+#ifdef LUNA_SIMD
+			using namespace Simd;
+			float4 w = dup_f4(weight);
+			for (u32 x = 0; x < width; ++x)
+			{
+				store_f4(dst + x * 4, muladd_f4(load_f4(src + x * 4), w, load_f4(dst + x * 4)));
+			}
+#else
+			for (u32 i = 0; i < width * 4; ++i)
+			{
+				dst[i] += src[i] * weight;
+			}
+#endif
+		}
+
+		struct ResampleContext
+		{
+			PixelFormatInfo format;
+			u32 pixel_size;
+			ResampleFlag flags;
+			u32 src_width;
+			u32 src_height;
+			u32 dst_width;
+			u32 dst_height;
+			//! The encoded source pixels. If this is `nullptr`, `src_pixels` is used.
+			const byte_t* src_data = nullptr;
+			//! The linear float4 source pixels.
+			const f32* src_pixels = nullptr;
+			//! Horizontally filtered pixels, `dst_width` * `src_height` float4 pixels.
+			f32* tmp_pixels = nullptr;
+			//! If not `nullptr`, linear float4 destination pixels are written to this buffer.
+			f32* dst_pixels = nullptr;
+			//! If not `nullptr`, encoded destination pixels are written to this buffer.
+			byte_t* dst_data = nullptr;
+			ResampleWeights hweights;
+			ResampleWeights vweights;
+		};
+
+		using resample_pass_t = void(const ResampleContext& ctx, u32 begin, u32 end, f32* scratch);
+
+		static void horizontal_pass(const ResampleContext& ctx, u32 begin, u32 end, f32* scratch)
+		{
+			usize src_pitch = (usize)ctx.src_width * ctx.pixel_size;
+			for (u32 y = begin; y < end; ++y)
+			{
+				const f32* src;
+				if (ctx.src_data)
+				{
+					decode_row(ctx.src_data + y * src_pitch, scratch, ctx.src_width, ctx.format, ctx.flags);
+					src = scratch;
+				}
+				else
+				{
+					src = ctx.src_pixels + (usize)y * ctx.src_width * 4;
+				}
+				resample_row(src, ctx.tmp_pixels + (usize)y * ctx.dst_width * 4, ctx.dst_width, ctx.hweights);
+			}
+		}
+
+		static void vertical_pass(const ResampleContext& ctx, u32 begin, u32 end, f32* scratch)
+		{
+			usize dst_pitch = (usize)ctx.dst_width * ctx.pixel_size;
+			for (u32 y = begin; y < end; ++y)
+			{
+				f32* dst = ctx.dst_pixels ? ctx.dst_pixels + (usize)y * ctx.dst_width * 4 : scratch;
+				memzero(dst, ctx.dst_width * FILTER_PIXEL_SIZE);
+				for (u32 t = ctx.vweights.offsets[y]; t < ctx.vweights.offsets[y + 1]; ++t)
+				{
+					accumulate_row(ctx.tmp_pixels + (usize)ctx.vweights.indices[t] * ctx.dst_width * 4, dst, ctx.dst_width, ctx.vweights.weights[t]);
+				}
+				if (ctx.dst_data)
+				{
+					encode_row(dst, ctx.dst_data + y * dst_pitch, ctx.dst_width, ctx.format, ctx.flags);
+				}
+			}
+		}
+
+		static void run_resample_pass(const ResampleContext& ctx, resample_pass_t* pass, u32 begin, u32 end, u32 scratch_width)
+		{
+			Blob scratch;
+			if (scratch_width) scratch = Blob(scratch_width * FILTER_PIXEL_SIZE, FILTER_PIXEL_SIZE);
+			pass(ctx, begin, end, (f32*)scratch.data());
+		}
+
+		struct ResampleRowsJob
+		{
+			const ResampleContext* ctx;
+			resample_pass_t* pass;
+			u32 begin;
+			u32 end;
+			u32 scratch_width;
+
+			static void run(void* params)
+			{
+				ResampleRowsJob* job = (ResampleRowsJob*)params;
+				run_resample_pass(*job->ctx, job->pass, job->begin, job->end, job->scratch_width);
+			}
+		};
+
+		struct ResampleDispatchJob
+		{
+			const ResampleContext* ctx;
+			resample_pass_t* pass;
+			u32 num_rows;
+			u32 rows_per_job;
+			u32 scratch_width;
+
+			static void run(void* params)
+			{
+				ResampleDispatchJob* job = (ResampleDispatchJob*)params;
+				for (u32 begin = 0; begin < job->num_rows; begin += job->rows_per_job)
+				{
+					// Row jobs are attached to this job, so waiting for this job waits for all rows.
+					ResampleRowsJob* rows = (ResampleRowsJob*)JobSystem::new_job(ResampleRowsJob::run, sizeof(ResampleRowsJob), alignof(ResampleRowsJob), params);
+					rows->ctx = job->ctx;
+					rows->pass = job->pass;
+					rows->begin = begin;
+					rows->end = min(begin + job->rows_per_job, job->num_rows);
+					rows->scratch_width = job->scratch_width;
+					JobSystem::submit_job(rows);
+				}
+			}
+		};
+
+		//! Runs one resampling pass for all rows, splitting rows into multiple jobs if the image is large enough.
+		static void dispatch_resample_pass(const ResampleContext& ctx, resample_pass_t* pass, u32 num_rows, u32 row_width, u32 scratch_width)
+		{
+			u32 rows_per_job = (u32)max<usize>(RESAMPLE_PIXELS_PER_JOB / max<u32>(row_width, 1), 1);
+			if (rows_per_job >= num_rows)
+			{
+				run_resample_pass(ctx, pass, 0, num_rows, scratch_width);
+				return;
+			}
+			ResampleDispatchJob* job = (ResampleDispatchJob*)JobSystem::new_job(ResampleDispatchJob::run, sizeof(ResampleDispatchJob), alignof(ResampleDispatchJob));
+			job->ctx = &ctx;
+			job->pass = pass;
+			job->num_rows = num_rows;
+			job->rows_per_job = rows_per_job;
+			job->scratch_width = scratch_width;
+			JobSystem::wait_job(JobSystem::submit_job(job));
+		}
+
+		//! Resamples the image described by `ctx`. `src_data` or `src_pixels`, `dst_pixels` or `dst_data`, and
+		//! `tmp_pixels` must be set before calling this.
+		static void resample(ResampleContext& ctx, ResampleFilter filter)
+		{
+			bool wrap = test_flags(ctx.flags, ResampleFlag::wrap);
+			compute_resample_weights(ctx.hweights, ctx.src_width, ctx.dst_width, filter, wrap);
+			compute_resample_weights(ctx.vweights, ctx.src_height, ctx.dst_height, filter, wrap);
+			dispatch_resample_pass(ctx, horizontal_pass, ctx.src_height, max(ctx.src_width, ctx.dst_width), ctx.src_data ? ctx.src_width : 0);
+			dispatch_resample_pass(ctx, vertical_pass, ctx.dst_height, ctx.dst_width, ctx.dst_pixels ? 0 : ctx.dst_width);
+		}
+
+		static RV validate_resample_arguments(const ImageDesc& desc, const void* image_data, ResampleFilter filter)
+		{
+			if (!image_data || !desc.width || !desc.height || !pixel_size(desc.format))
+			{
+				return set_error(BasicError::bad_arguments(), "Invalid source image for resampling.");
+			}
+			if (filter > ResampleFilter::lanczos)
+			{
+				return set_error(BasicError::bad_arguments(), "Invalid resample filter.");
+			}
+			return ok;
+		}
+
+		LUNA_IMAGE_API R<Blob> resize_image(const ImageDesc& desc, const void* image_data, u32 width, u32 height, ResampleFilter filter, ResampleFlag flags)
+		{
+			Blob ret;
+			lutry
+			{
+				luexp(validate_resample_arguments(desc, image_data, filter));
+				if (!width || !height) return set_error(BasicError::bad_arguments(), "The size of the resized image cannot be 0.");
+				ResampleContext ctx;
+				ctx.format = get_pixel_format_info(desc.format);
+				ctx.pixel_size = pixel_size(desc.format);
+				ctx.flags = flags;
+				ctx.src_width = desc.width;
+				ctx.src_height = desc.height;
+				ctx.dst_width = width;
+				ctx.dst_height = height;
+				ctx.src_data = (const byte_t*)image_data;
+				Blob tmp((usize)width * desc.height * FILTER_PIXEL_SIZE, FILTER_PIXEL_SIZE);
+				ret = Blob((usize)width * height * pixel_size(desc.format));
+				ctx.tmp_pixels = (f32*)tmp.data();
+				ctx.dst_data = ret.data();
+				resample(ctx, filter);
+			}
+			lucatchret;
+			return ret;
+		}
+
+		LUNA_IMAGE_API R<Vector<Blob>> generate_mipmaps(const ImageDesc& desc, const void* image_data, u32 num_mips, ResampleFilter filter, ResampleFlag flags)
+		{
+			Vector<Blob> ret;
+			lutry
+			{
+				luexp(validate_resample_arguments(desc, image_data, filter));
+				u32 max_mips = calc_mip_levels(desc.width, desc.height);
+				num_mips = num_mips ? min(num_mips, max_mips) : max_mips;
+				PixelFormatInfo format = get_pixel_format_info(desc.format);
+				// Every level is filtered from the linear pixels of the previous level. Levels shrink, so buffers allocated
+				// for the first levels can be reused by all following levels.
+				Blob tmp;
+				Blob pixels[2];
+				u32 src_width = desc.width;
+				u32 src_height = desc.height;
+				const f32* src_pixels = nullptr;
+				for (u32 level = 1; level < num_mips; ++level)
+				{
+					ResampleContext ctx;
+					ctx.format = format;
+					ctx.pixel_size = pixel_size(desc.format);
+					ctx.flags = flags;
+					ctx.src_width = src_width;
+					ctx.src_height = src_height;
+					ctx.dst_width = max<u32>(src_width >> 1, 1);
+					ctx.dst_height = max<u32>(src_height >> 1, 1);
+					if (src_pixels) ctx.src_pixels = src_pixels;
+					else ctx.src_data = (const byte_t*)image_data;
+					if (tmp.empty()) tmp = Blob((usize)ctx.dst_width * ctx.src_height * FILTER_PIXEL_SIZE, FILTER_PIXEL_SIZE);
+					ctx.tmp_pixels = (f32*)tmp.data();
+					if (level + 1 < num_mips)
+					{
+						Blob& dst_pixels = pixels[level % 2];
+						if (dst_pixels.empty()) dst_pixels = Blob((usize)ctx.dst_width * ctx.dst_height * FILTER_PIXEL_SIZE, FILTER_PIXEL_SIZE);
+						ctx.dst_pixels = (f32*)dst_pixels.data();
+					}
+					Blob mip((usize)ctx.dst_width * ctx.dst_height * pixel_size(desc.format));
+					ctx.dst_data = mip.data();
+					resample(ctx, filter);
+					ret.push_back(move(mip));
+					src_pixels = ctx.dst_pixels;
+					src_width = ctx.dst_width;
+					src_height = ctx.dst_height;
+				}
+			}
+			lucatchret;
+			return ret;
+		}
+	}
+}
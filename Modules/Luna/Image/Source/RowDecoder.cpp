@@ -0,0 +1,264 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file RowDecoder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "Image.hpp"
+#include "RowDecoder.hpp"
+#include <Luna/Runtime/Math/Math.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		RV StreamReader::fill(usize size)
+		{
+			if (available() >= size || m_eof) return ok;
+			// Moves remaining data to the front of the buffer.
+			usize remaining = available();
+			if (m_cursor)
+			{
+				memmove(m_buffer.data(), m_buffer.data() + m_cursor, remaining);
+				m_cursor = 0;
+				m_size = remaining;
+			}
+			if (size > m_buffer.size()) m_buffer.resize(size);
+			while (m_size < size && !m_eof)
+			{
+				usize read_bytes = 0;
+				RV r = m_stream->read(m_buffer.data() + m_size, m_buffer.size() - m_size, &read_bytes);
+				if (failed(r)) return r;
+				if (!read_bytes) m_eof = true;
+				m_size += read_bytes;
+			}
+			return ok;
+		}
+		RV StreamReader::read(void* dst, usize size)
+		{
+			u8* d = (u8*)dst;
+			while (size)
+			{
+				if (!available())
+				{
+					RV r = fill(min(size, m_buffer.size()));
+					if (failed(r)) return r;
+					if (!available()) return BasicError::end_of_file();
+				}
+				usize copy_size = min(size, available());
+				memcpy(d, peek(), copy_size);
+				m_cursor += copy_size;
+				d += copy_size;
+				size -= copy_size;
+			}
+			return ok;
+		}
+		RV StreamReader::skip(usize size)
+		{
+			while (size)
+			{
+				if (!available())
+				{
+					RV r = fill(min(size, m_buffer.size()));
+					if (failed(r)) return r;
+					if (!available()) return BasicError::end_of_file();
+				}
+				usize skip_size = min(size, available());
+				m_cursor += skip_size;
+				size -= skip_size;
+			}
+			return ok;
+		}
+
+		inline ImageFormat get_image_format(u32 num_channels, ChannelType type)
+		{
+			constexpr ImageFormat formats[3][4] = {
+				{ ImageFormat::r8_unorm, ImageFormat::rg8_unorm, ImageFormat::rgb8_unorm, ImageFormat::rgba8_unorm },
+				{ ImageFormat::r16_unorm, ImageFormat::rg16_unorm, ImageFormat::rgb16_unorm, ImageFormat::rgba16_unorm },
+				{ ImageFormat::r32_float, ImageFormat::rg32_float, ImageFormat::rgb32_float, ImageFormat::rgba32_float },
+			};
+			return formats[(u32)type][num_channels - 1];
+		}
+
+		// Conversions match stb_image used by `read_image_file`: one-channel and two-channel images are treated as
+		// grayscale and grayscale-alpha images, and color channels are gamma-corrected by 2.2 when converting between
+		// LDR and HDR formats.
+		constexpr f32 LDR_HDR_GAMMA = 2.2f;
+
+		inline f32 get_channel_max(ChannelType type)
+		{
+			switch (type)
+			{
+			case ChannelType::unorm8: return 255.0f;
+			case ChannelType::unorm16: return 65535.0f;
+			default: return 1.0f;
+			}
+		}
+
+		static void convert_pixel(const byte_t* src, u32 src_num_channels, ChannelType src_type, byte_t* dst, u32 dst_num_channels, ChannelType dst_type)
+		{
+			f32 s[4];
+			for (u32 c = 0; c < src_num_channels; ++c)
+			{
+				switch (src_type)
+				{
+				case ChannelType::unorm8: s[c] = (f32)((const u8*)src)[c]; break;
+				case ChannelType::unorm16: s[c] = (f32)((const u16*)src)[c]; break;
+				case ChannelType::float32: s[c] = ((const f32*)src)[c]; break;
+				}
+			}
+			f32 alpha_max = get_channel_max(src_type);
+			bool src_has_alpha = src_num_channels == 2 || src_num_channels == 4;
+			f32 alpha = src_has_alpha ? s[src_num_channels - 1] : alpha_max;
+			f32 gray = src_num_channels <= 2 ? s[0] : (s[0] * 77.0f + s[1] * 150.0f + s[2] * 29.0f) / 256.0f;
+			f32 d[4];
+			switch (dst_num_channels)
+			{
+			case 1: d[0] = gray; break;
+			case 2: d[0] = gray; d[1] = alpha; break;
+			case 3:
+			case 4:
+				if (src_num_channels <= 2)
+				{
+					d[0] = d[1] = d[2] = gray;
+				}
+				else
+				{
+					d[0] = s[0];
+					d[1] = s[1];
+					d[2] = s[2];
+				}
+				d[3] = alpha;
+				break;
+			}
+			if (src_type != ChannelType::float32 && src_type != dst_type && dst_type != ChannelType::float32)
+			{
+				// Integer to integer conversion.
+				f32 scale = get_channel_max(dst_type) / alpha_max;
+				for (u32 c = 0; c < dst_num_channels; ++c) d[c] = floorf(d[c] * scale + 0.5f);
+			}
+			else if (src_type != dst_type)
+			{
+				f32 src_max = get_channel_max(src_type);
+				f32 dst_max = get_channel_max(dst_type);
+				for (u32 c = 0; c < dst_num_channels; ++c)
+				{
+					bool is_alpha = (dst_num_channels == 2 && c == 1) || (dst_num_channels == 4 && c == 3);
+					f32 v = d[c] / src_max;
+					if (!is_alpha)
+					{
+						v = dst_type == ChannelType::float32 ? powf(v, LDR_HDR_GAMMA) : powf(max(v, 0.0f), 1.0f / LDR_HDR_GAMMA);
+					}
+					if (dst_type != ChannelType::float32) v = floorf(clamp(v, 0.0f, 1.0f) * dst_max + 0.5f);
+					d[c] = v;
+				}
+			}
+			for (u32 c = 0; c < dst_num_channels; ++c)
+			{
+				switch (dst_type)
+				{
+				case ChannelType::unorm8: ((u8*)dst)[c] = (u8)d[c]; break;
+				case ChannelType::unorm16: ((u16*)dst)[c] = (u16)d[c]; break;
+				case ChannelType::float32: ((f32*)dst)[c] = d[c]; break;
+				}
+			}
+		}
+
+		inline u32 get_channel_size(ChannelType type)
+		{
+			switch (type)
+			{
+			case ChannelType::unorm8: return 1;
+			case ChannelType::unorm16: return 2;
+			default: return 4;
+			}
+		}
+
+		RV RowSink::init(u32 width, u32 height, u32 src_num_channels, ChannelType src_type, bool bottom_up, ImageFormat desired_format,
+			u32 band_rows, const Function<image_rows_callback_t>* callback)
+		{
+			if (!width || !height) return ImageError::file_parse_error();
+			m_desc.width = width;
+			m_desc.height = height;
+			m_desc.format = desired_format == ImageFormat::unkonwn ? get_image_format(src_num_channels, src_type) : desired_format;
+			m_src_num_channels = src_num_channels;
+			m_src_type = src_type;
+			m_band_rows = min(max(band_rows, 1u), height);
+			m_callback = callback;
+			m_bottom_up = bottom_up;
+			m_band = Blob((usize)m_band_rows * width * pixel_size(m_desc.format));
+			m_row = Blob((usize)width * src_num_channels * get_channel_size(src_type));
+			m_num_band_rows = 0;
+			m_next_row = 0;
+			return ok;
+		}
+
+		RV RowSink::commit_row()
+		{
+			u32 height = m_desc.height;
+			if (m_next_row >= height) return ImageError::file_parse_error();
+			u32 band_size = min(m_band_rows, height - (m_next_row - m_num_band_rows));
+			u32 band_first = m_bottom_up ? height - (m_next_row - m_num_band_rows) - band_size : m_next_row - m_num_band_rows;
+			u32 row = m_bottom_up ? height - 1 - m_next_row : m_next_row;
+			usize dst_pitch = (usize)m_desc.width * pixel_size(m_desc.format);
+			byte_t* dst = m_band.data() + (row - band_first) * dst_pitch;
+			PixelFormatInfo dst_info = get_pixel_format_info(m_desc.format);
+			if (dst_info.num_channels == m_src_num_channels && dst_info.type == m_src_type)
+			{
+				memcpy(dst, m_row.data(), dst_pitch);
+			}
+			else
+			{
+				usize src_pixel_size = m_src_num_channels * get_channel_size(m_src_type);
+				usize dst_pixel_size = pixel_size(m_desc.format);
+				for (u32 x = 0; x < m_desc.width; ++x)
+				{
+					convert_pixel(m_row.data() + x * src_pixel_size, m_src_num_channels, m_src_type,
+						dst + x * dst_pixel_size, dst_info.num_channels, dst_info.type);
+				}
+			}
+			++m_next_row;
+			++m_num_band_rows;
+			if (m_num_band_rows == band_size)
+			{
+				m_num_band_rows = 0;
+				return (*m_callback)(m_desc, band_first, band_size, m_band.data());
+			}
+			return ok;
+		}
+
+		LUNA_IMAGE_API R<ImageDesc> read_image_file_rows(IStream* stream, ImageFormat desired_format, u32 band_rows,
+			const Function<image_rows_callback_t>& callback)
+		{
+			lucheck(stream);
+			StreamReader reader(stream);
+			RowSink sink;
+			lutry
+			{
+				luexp(reader.fill(32));
+				if (is_png_stream(reader))
+				{
+					luexp(decode_png_rows(reader, sink, desired_format, band_rows, &callback));
+				}
+				else if (is_hdr_stream(reader))
+				{
+					luexp(decode_hdr_rows(reader, sink, desired_format, band_rows, &callback));
+				}
+				else if (is_tga_stream(reader))
+				{
+					luexp(decode_tga_rows(reader, sink, desired_format, band_rows, &callback));
+				}
+				else
+				{
+					return set_error(BasicError::not_supported(), "The image file format cannot be decoded by rows.");
+				}
+				if (sink.m_next_row != sink.m_desc.height) return ImageError::file_parse_error();
+			}
+			lucatchret;
+			return sink.m_desc;
+		}
+	}
+}
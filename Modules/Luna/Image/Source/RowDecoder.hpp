@@ -0,0 +1,87 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file RowDecoder.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../Image.hpp"
+#include "PixelFormat.hpp"
+#include <Luna/Runtime/MemoryUtils.hpp>
+
+namespace Luna
+{
+	namespace Image
+	{
+		//! Reads one stream through one internal buffer, so that decoders can read files byte by byte.
+		struct StreamReader
+		{
+			IStream* m_stream;
+			Blob m_buffer;
+			usize m_cursor = 0;
+			usize m_size = 0;
+			bool m_eof = false;
+
+			StreamReader(IStream* stream) :
+				m_stream(stream),
+				m_buffer(64_kb) {}
+
+			//! Reads more data to the buffer so that at least `size` bytes are available if the stream is long enough.
+			RV fill(usize size);
+			//! Returns the pointer to the buffered data not read yet.
+			const u8* peek() const { return m_buffer.data() + m_cursor; }
+			usize available() const { return m_size - m_cursor; }
+			//! Reads exactly `size` bytes. Returns `BasicError::end_of_file` if the stream ends before `size` bytes are read.
+			RV read(void* dst, usize size);
+			RV skip(usize size);
+			R<u8> read_u8()
+			{
+				if (m_cursor == m_size)
+				{
+					RV r = fill(1);
+					if (failed(r)) return r.errcode();
+					if (m_cursor == m_size) return BasicError::end_of_file();
+				}
+				return m_buffer.data()[m_cursor++];
+			}
+		};
+
+		//! Converts decoded rows to the desired format and reports them to the user in bands.
+		struct RowSink
+		{
+			ImageDesc m_desc;
+			//! The format of rows written by the decoder.
+			u32 m_src_num_channels;
+			ChannelType m_src_type;
+			u32 m_band_rows;
+			const Function<image_rows_callback_t>* m_callback;
+			//! True if rows are decoded in bottom-to-top order.
+			bool m_bottom_up;
+			Blob m_band;
+			Blob m_row;
+			u32 m_num_band_rows = 0;
+			u32 m_next_row = 0;
+
+			//! Initializes the sink.
+			//! @param[in] desired_format The format to convert rows to, `ImageFormat::unkonwn` to use the source format.
+			RV init(u32 width, u32 height, u32 src_num_channels, ChannelType src_type, bool bottom_up, ImageFormat desired_format,
+				u32 band_rows, const Function<image_rows_callback_t>* callback);
+			//! Returns the buffer the decoder should write the next row to, in the source format.
+			byte_t* get_row_buffer() { return m_row.data(); }
+			//! Converts and stores the row written to the row buffer, and invokes the callback if the band is full.
+			RV commit_row();
+		};
+
+		//! Returns `true` if the buffered data starts with the signature of the format.
+		bool is_png_stream(StreamReader& reader);
+		bool is_hdr_stream(StreamReader& reader);
+		bool is_tga_stream(StreamReader& reader);
+
+		RV decode_png_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback);
+		RV decode_hdr_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback);
+		RV decode_tga_rows(StreamReader& reader, RowSink& sink, ImageFormat desired_format, u32 band_rows, const Function<image_rows_callback_t>* callback);
+	}
+}
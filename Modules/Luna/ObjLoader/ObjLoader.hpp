@@ -94,8 +94,39 @@ namespace Luna
 		};
 
 		//! Loads object file from file.
-		//! @param[in] file_name The platform path of the file.
+		//! @details The file is split into chunks on line boundaries, and chunks are parsed in parallel using the job system.
+		//! Polygons with more than 3 vertices are triangulated by ear clipping, so every face of the loaded mesh is one triangle.
+		//! @param[in] obj_file The data of the object file.
+		//! @param[in] mtl_file The data of the material library file. Only material names are read from this file, which are
+		//! used to resolve material IDs of faces.
 		LUNA_OBJ_LOADER_API R<ObjMesh> load(Span<const byte_t> obj_file, Span<const byte_t> mtl_file);
+
+		//! One range of indices that use the same material in @ref IndexedMesh.
+		struct IndexedMeshPiece
+		{
+			//! The material ID of faces in this piece, -1 if faces do not have materials.
+			i32 material_id;
+			u32 first_index;
+			u32 num_indices;
+		};
+
+		//! The indexed triangle list built from one shape by @ref build_indexed_mesh.
+		struct IndexedMesh
+		{
+			//! The attribute indices of every unique vertex.
+			Vector<Index> vertices;
+			//! The vertex indices of all triangles, grouped by materials.
+			Vector<u32> indices;
+			//! Index ranges of every material, sorted by material IDs.
+			Vector<IndexedMeshPiece> pieces;
+		};
+
+		//! Welds vertices of one shape and builds the indexed triangle list of the shape.
+		//! @details Faces with more than 3 vertices are triangulated by ear clipping in the same way as @ref load, which only
+		//! happens if the mesh is not loaded by @ref load. Vertices are ordered by the first time they are used by faces.
+		//! @param[in] obj The loaded object file.
+		//! @param[in] shape_index The index of the shape to build.
+		LUNA_OBJ_LOADER_API IndexedMesh build_indexed_mesh(const ObjMesh& obj, u32 shape_index);
 	}
 
 	struct Module;
@@ -0,0 +1,164 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file IndexedMesh.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+
+#define LUNA_OBJ_LOADER_API LUNA_EXPORT
+#include "../ObjLoader.hpp"
+#include "Triangulate.hpp"
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/Algorithm.hpp>
+
+namespace Luna
+{
+	namespace ObjLoader
+	{
+		inline u32 hash_index(const Index& index)
+		{
+			u64 h = (u64)(u32)index.vertex_index * 0x9E3779B97F4A7C15ull;
+			h ^= (u64)(u32)index.normal_index * 0xC2B2AE3D27D4EB4Full;
+			h ^= (u64)(u32)index.texcoord_index * 0x165667B19E3779F9ull;
+			h ^= h >> 29;
+			return (u32)(h ^ (h >> 32));
+		}
+
+		//! The open-addressing table used to weld vertices. Every slot stores the vertex index plus one, or zero if the slot
+		//! is empty. Keys are read from the vertex array, so that every slot only takes 4 bytes.
+		struct VertexTable
+		{
+			Vector<u32> m_slots;
+			u32 m_mask;
+
+			void reset(usize capacity)
+			{
+				usize size = 16;
+				while (size < capacity) size <<= 1;
+				m_slots.clear();
+				m_slots.resize(size, 0);
+				m_mask = (u32)(size - 1);
+			}
+			void insert_new(u32 hash, u32 vertex)
+			{
+				u32 slot = hash & m_mask;
+				while (m_slots[slot]) slot = (slot + 1) & m_mask;
+				m_slots[slot] = vertex + 1;
+			}
+			//! Returns the index of the vertex that has the specified attributes, adding it to `vertices` if not found.
+			u32 find_or_insert(const Index& index, Vector<Index>& vertices)
+			{
+				u32 hash = hash_index(index);
+				u32 slot = hash & m_mask;
+				while (u32 v = m_slots[slot])
+				{
+					if (vertices[v - 1] == index) return v - 1;
+					slot = (slot + 1) & m_mask;
+				}
+				u32 vertex = (u32)vertices.size();
+				vertices.push_back(index);
+				m_slots[slot] = vertex + 1;
+				// Keeps the load factor under 0.5.
+				if (vertices.size() * 2 > m_slots.size())
+				{
+					reset(m_slots.size() * 2);
+					for (u32 i = 0; i < (u32)vertices.size(); ++i) insert_new(hash_index(vertices[i]), i);
+				}
+				return vertex;
+			}
+		};
+
+		LUNA_OBJ_LOADER_API IndexedMesh build_indexed_mesh(const ObjMesh& obj, u32 shape_index)
+		{
+			const Mesh& mesh = obj.shapes[shape_index].mesh;
+			const Attributes& attributes = obj.attributes;
+			IndexedMesh r;
+			usize num_faces = mesh.num_face_vertices.size();
+
+			// Counts triangles of every material.
+			HashMap<i32, usize> material_slots;
+			Vector<i32> materials;
+			Vector<usize> num_indices;
+			Vector<u32> face_slots(num_faces);
+			i32 last_material = 0;
+			usize last_slot = USIZE_MAX;
+			for (usize i = 0; i < num_faces; ++i)
+			{
+				i32 material = mesh.material_ids[i];
+				if (last_slot == USIZE_MAX || material != last_material)
+				{
+					auto iter = material_slots.find(material);
+					if (iter == material_slots.end())
+					{
+						iter = material_slots.insert(make_pair(material, materials.size())).first;
+						materials.push_back(material);
+						num_indices.push_back(0);
+					}
+					last_material = material;
+					last_slot = iter->second;
+				}
+				face_slots[i] = (u32)last_slot;
+				u32 n = mesh.num_face_vertices[i];
+				if (n >= 3) num_indices[last_slot] += (n - 2) * 3;
+			}
+
+			// Sorts pieces by material IDs and computes the write position of every material.
+			Vector<usize> order(materials.size());
+			for (usize i = 0; i < order.size(); ++i) order[i] = i;
+			sort(order.begin(), order.end(), [&](usize a, usize b) { return materials[a] < materials[b]; });
+			Vector<usize> write_pos(materials.size());
+			usize total_indices = 0;
+			for (usize slot : order)
+			{
+				if (!num_indices[slot]) continue;
+				IndexedMeshPiece piece;
+				piece.material_id = materials[slot];
+				piece.first_index = (u32)total_indices;
+				piece.num_indices = (u32)num_indices[slot];
+				r.pieces.push_back(piece);
+				write_pos[slot] = total_indices;
+				total_indices += num_indices[slot];
+			}
+			r.indices.resize(total_indices);
+
+			// Welds vertices. The table is sized by the number of attributes, which is a good estimation of the number
+			// of unique vertices for most meshes.
+			usize estimated_vertices = max(attributes.vertices.size(), max(attributes.normals.size(), attributes.texcoords.size()));
+			estimated_vertices = min(estimated_vertices, mesh.indices.size());
+			r.vertices.reserve(estimated_vertices);
+			VertexTable table;
+			table.reset(estimated_vertices * 2);
+			usize index_offset = 0;
+			Index triangles[253 * 3];
+			Vector<u32> remaining;
+			for (usize i = 0; i < num_faces; ++i)
+			{
+				u32 n = mesh.num_face_vertices[i];
+				if (n >= 3)
+				{
+					const Index* polygon = mesh.indices.data() + index_offset;
+					u32* dst = r.indices.data() + write_pos[face_slots[i]];
+					if (n == 3)
+					{
+						for (u32 j = 0; j < 3; ++j) dst[j] = table.find_or_insert(polygon[j], r.vertices);
+					}
+					else
+					{
+						// Vertices are added in the order of polygon corners, so that the vertex order does not depend on
+						// how the polygon is triangulated. Faces are triangulated in the same way as `load`.
+						for (u32 j = 0; j < n; ++j) table.find_or_insert(polygon[j], r.vertices);
+						triangulate_polygon(polygon, n, attributes.vertices, remaining, triangles);
+						for (u32 j = 0; j < (n - 2) * 3; ++j) dst[j] = table.find_or_insert(triangles[j], r.vertices);
+					}
+					write_pos[face_slots[i]] += (n - 2) * 3;
+				}
+				index_offset += n;
+			}
+			return r;
+		}
+	}
+}
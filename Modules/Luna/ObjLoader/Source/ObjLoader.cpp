@@ -2,7 +2,7 @@
 * This file is a portion of Luna SDK.
 * For conditions of distribution and use, see the disclaimer
 * and license in LICENSE.txt
-* 
+*
 * @file ObjLoader.cpp
 * @author JXMaster
 * @date 2020/5/12
@@ -11,132 +11,791 @@
 
 #define LUNA_OBJ_LOADER_API LUNA_EXPORT
 #include "../ObjLoader.hpp"
-#include "tiny_obj_loader.h"
+#include "Triangulate.hpp"
 #include <Luna/Runtime/Module.hpp>
-
-#include <filesystem>
-#include <iostream>
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/MemoryUtils.hpp>
+#include <Luna/Runtime/Math/Math.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 namespace Luna
 {
 	namespace ObjLoader
 	{
-		static_assert(sizeof(Index) == sizeof(tinyobj::index_t), "Index size does not match");
-
 		struct ObjLoaderModule : public Module
 		{
 			virtual const c8* get_name() override { return "ObjLoader"; }
+			virtual RV on_register() override
+			{
+				return add_dependency_modules(this, {module_job_system()});
+			}
 		};
 
-		void copy_shape(Shape& dst, const tinyobj::shape_t& src)
+		//! The number of bytes parsed by one job.
+		constexpr usize OBJ_BYTES_PER_JOB = 1_mb;
+
+		inline bool is_space(c8 c)
+		{
+			return c == ' ' || c == '\t';
+		}
+		inline void skip_spaces(const c8*& p, const c8* end)
+		{
+			while (p < end && is_space(*p)) ++p;
+		}
+		//! Checks whether the line starts with the specified tag followed by one space.
+		inline bool match_tag(const c8* p, const c8* end, const c8* tag, usize tag_len)
+		{
+			return (usize)(end - p) > tag_len && !memcmp(p, tag, tag_len) && is_space(p[tag_len]);
+		}
+
+		//! Parses one decimal real number. Returns `false` if no number is found.
+		static bool parse_real(const c8*& p, const c8* end, f32& out)
 		{
-			dst.name = Name(src.name.c_str());
-			
-			// Copy mesh.
-			dst.mesh.indices.resize(src.mesh.indices.size());
-			if (dst.mesh.indices.size())
+			skip_spaces(p, end);
+			const c8* s = p;
+			bool neg = false;
+			if (s < end && (*s == '+' || *s == '-'))
 			{
-				memcpy(&dst.mesh.indices[0], &src.mesh.indices[0], dst.mesh.indices.size() * sizeof(Index));
+				neg = *s == '-';
+				++s;
 			}
-			dst.mesh.num_face_vertices.resize(src.mesh.num_face_vertices.size());
-			if (dst.mesh.num_face_vertices.size())
+			u64 mantissa = 0;
+			i32 exp10 = 0;
+			u32 num_digits = 0;
+			u32 num_significant_digits = 0;
+			while (s < end && *s >= '0' && *s <= '9')
 			{
-				memcpy(&dst.mesh.num_face_vertices[0], &src.mesh.num_face_vertices[0], dst.mesh.num_face_vertices.size() * sizeof(u8));
+				if (num_significant_digits < 19)
+				{
+					mantissa = mantissa * 10 + (u64)(*s - '0');
+					if (mantissa) ++num_significant_digits;
+				}
+				else ++exp10;
+				++num_digits;
+				++s;
 			}
-			dst.mesh.material_ids.resize(src.mesh.material_ids.size());
-			if (dst.mesh.material_ids.size())
+			if (s < end && *s == '.')
 			{
-				memcpy(&dst.mesh.material_ids[0], &src.mesh.material_ids[0], dst.mesh.material_ids.size() * sizeof(i32));
+				++s;
+				while (s < end && *s >= '0' && *s <= '9')
+				{
+					if (num_significant_digits < 19)
+					{
+						mantissa = mantissa * 10 + (u64)(*s - '0');
+						if (mantissa) ++num_significant_digits;
+						--exp10;
+					}
+					++num_digits;
+					++s;
+				}
 			}
-			dst.mesh.smoothing_group_ids.resize(src.mesh.smoothing_group_ids.size());
-			if (dst.mesh.smoothing_group_ids.size())
+			if (!num_digits) return false;
+			if (s < end && (*s == 'e' || *s == 'E'))
 			{
-				memcpy(&dst.mesh.smoothing_group_ids[0], &src.mesh.smoothing_group_ids[0], dst.mesh.smoothing_group_ids.size() * sizeof(i32));
+				const c8* e = s + 1;
+				bool exp_neg = false;
+				if (e < end && (*e == '+' || *e == '-'))
+				{
+					exp_neg = *e == '-';
+					++e;
+				}
+				if (e < end && *e >= '0' && *e <= '9')
+				{
+					i32 exp = 0;
+					while (e < end && *e >= '0' && *e <= '9')
+					{
+						if (exp < 10000) exp = exp * 10 + (*e - '0');
+						++e;
+					}
+					exp10 += exp_neg ? -exp : exp;
+					s = e;
+				}
 			}
+			f64 v = (f64)mantissa;
+			if (exp10)
+			{
+				constexpr f64 pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+				i32 e = exp10 < 0 ? -exp10 : exp10;
+				f64 scale = 1.0;
+				while (e > 22)
+				{
+					scale *= 1e22;
+					e -= 22;
+				}
+				scale *= pow10[e];
+				v = exp10 < 0 ? v / scale : v * scale;
+			}
+			out = (f32)(neg ? -v : v);
+			p = s;
+			return true;
+		}
 
-			// Copy lines.
-			dst.lines.indices.resize(src.lines.indices.size());
-			if (dst.lines.indices.size())
+		static bool parse_int(const c8*& p, const c8* end, i32& out)
+		{
+			const c8* s = p;
+			bool neg = false;
+			if (s < end && (*s == '+' || *s == '-'))
 			{
-				memcpy(&dst.lines.indices[0], &src.lines.indices[0], dst.lines.indices.size() * sizeof(Index));
+				neg = *s == '-';
+				++s;
 			}
-			dst.lines.num_line_vertices.resize(src.lines.num_line_vertices.size());
-			if (dst.lines.num_line_vertices.size())
+			if (s == end || *s < '0' || *s > '9') return false;
+			i64 v = 0;
+			while (s < end && *s >= '0' && *s <= '9')
 			{
-				memcpy(&dst.lines.num_line_vertices[0], &src.lines.num_line_vertices[0], dst.lines.num_line_vertices.size() * sizeof(i32));
+				if (v < I32_MAX) v = v * 10 + (*s - '0');
+				++s;
 			}
+			v = min<i64>(v, I32_MAX);
+			out = (i32)(neg ? -v : v);
+			p = s;
+			return true;
+		}
 
-			// Copy points.
-			dst.points.indices.resize(src.points.indices.size());
-			if (dst.points.indices.size())
+		//! Reads one string that is terminated by spaces.
+		inline Pair<const c8*, usize> parse_string(const c8*& p, const c8* end)
+		{
+			skip_spaces(p, end);
+			const c8* s = p;
+			while (p < end && !is_space(*p)) ++p;
+			return make_pair(s, (usize)(p - s));
+		}
+
+		enum class SegmentCommand : u8
+		{
+			//! The segment starts at the beginning of one chunk.
+			none,
+			//! The segment starts at one `g` line.
+			group,
+			//! The segment starts at one `o` line.
+			object,
+		};
+
+		//! A range of primitives in one chunk that belongs to the same shape.
+		struct Segment
+		{
+			SegmentCommand command = SegmentCommand::none;
+			String name;
+			//! The number of faces, triangles, lines and line vertices and point vertices in this segment.
+			usize num_faces = 0;
+			usize num_triangles = 0;
+			usize num_lines = 0;
+			usize num_line_indices = 0;
+			usize num_point_indices = 0;
+			//! The shape this segment belongs to, or `USIZE_MAX` if this segment is empty.
+			usize shape = USIZE_MAX;
+			//! The first triangle, line and point index of this segment in the shape.
+			usize first_triangle = 0;
+			usize first_line = 0;
+			usize first_line_index = 0;
+			usize first_point_index = 0;
+		};
+
+		//! Records that the material ID or smoothing group ID changes starting from the specified face.
+		struct StateChange
+		{
+			usize first_face;
+			i32 value;
+		};
+
+		//! The data parsed from one chunk of the file.
+		struct Chunk
+		{
+			const c8* begin;
+			const c8* end;
+			usize num_lines = 0;
+			// Attributes defined in this chunk, and attributes defined before this chunk.
+			usize num_vertices = 0;
+			usize num_normals = 0;
+			usize num_texcoords = 0;
+			usize first_vertex = 0;
+			usize first_normal = 0;
+			usize first_texcoord = 0;
+			// Face, line and point indices. Faces are stored as polygons and are triangulated after all vertices are loaded.
+			Vector<Index> face_indices;
+			Vector<u32> face_sizes;
+			Vector<Index> line_indices;
+			Vector<u32> line_sizes;
+			Vector<Index> point_indices;
+			Vector<Segment> segments;
+			Vector<StateChange> material_changes;
+			Vector<StateChange> smoothing_changes;
+			// The material ID and smoothing group ID at the beginning of this chunk.
+			i32 material_id = -1;
+			i32 smoothing_group_id = 0;
+			// The error occurred when parsing this chunk.
+			ErrCode error = ErrCode(0);
+			usize error_line = 0;
+		};
+
+		struct ParseContext
+		{
+			ObjMesh* obj;
+			const HashMap<Name, i32>* material_map;
+			Vector<Chunk>* chunks;
+		};
+
+		using chunk_pass_t = void(const ParseContext& ctx, Chunk& chunk);
+
+		struct ChunkJob
+		{
+			const ParseContext* ctx;
+			chunk_pass_t* pass;
+			Chunk* chunk;
+
+			static void run(void* params)
+			{
+				ChunkJob* job = (ChunkJob*)params;
+				job->pass(*job->ctx, *job->chunk);
+			}
+		};
+
+		struct ChunkDispatchJob
+		{
+			const ParseContext* ctx;
+			chunk_pass_t* pass;
+
+			static void run(void* params)
+			{
+				ChunkDispatchJob* job = (ChunkDispatchJob*)params;
+				for (Chunk& chunk : *job->ctx->chunks)
+				{
+					// Chunk jobs are attached to this job, so waiting for this job waits for all chunks.
+					ChunkJob* chunk_job = (ChunkJob*)JobSystem::new_job(ChunkJob::run, sizeof(ChunkJob), alignof(ChunkJob), params);
+					chunk_job->ctx = job->ctx;
+					chunk_job->pass = job->pass;
+					chunk_job->chunk = &chunk;
+					JobSystem::submit_job(chunk_job);
+				}
+			}
+		};
+
+		//! Runs one pass for all chunks in parallel.
+		static void dispatch_chunk_pass(const ParseContext& ctx, chunk_pass_t* pass)
+		{
+			if (ctx.chunks->size() == 1)
 			{
-				memcpy(&dst.points.indices[0], &src.points.indices[0], dst.points.indices.size() * sizeof(Index));
+				pass(ctx, (*ctx.chunks)[0]);
+				return;
 			}
+			ChunkDispatchJob* job = (ChunkDispatchJob*)JobSystem::new_job(ChunkDispatchJob::run, sizeof(ChunkDispatchJob), alignof(ChunkDispatchJob));
+			job->ctx = &ctx;
+			job->pass = pass;
+			JobSystem::wait_job(JobSystem::submit_job(job));
 		}
 
-		LUNA_OBJ_LOADER_API R<ObjMesh> load(Span<const byte_t> obj_file, Span<const byte_t> mtl_file)
+		//! Calls `func(line_begin, line_end)` for every line in the chunk. Trailing `\r` is removed.
+		template <typename _Func>
+		inline void for_each_line(const c8* begin, const c8* end, _Func&& func)
 		{
+			const c8* p = begin;
+			while (p < end)
+			{
+				const c8* line_end = (const c8*)memchr(p, '\n', end - p);
+				if (!line_end) line_end = end;
+				const c8* e = line_end;
+				if (e > p && e[-1] == '\r') --e;
+				skip_spaces(p, e);
+				if (!func(p, e)) return;
+				p = line_end + 1;
+			}
+		}
 
-			std::string obj_source((const c8*)obj_file.data(), obj_file.size());
-			std::string mtl_source;
-			if (!mtl_file.empty())
+		//! Counts attributes defined in the chunk, so that indices of attributes can be determined before parsing.
+		static void count_chunk_attributes(const ParseContext&, Chunk& chunk)
+		{
+			for_each_line(chunk.begin, chunk.end, [&](const c8* p, const c8* e)
 			{
-				mtl_source.assign((const c8*)mtl_file.data(), mtl_file.size());
+				++chunk.num_lines;
+				if (e - p > 1 && p[0] == 'v')
+				{
+					if (is_space(p[1])) ++chunk.num_vertices;
+					else if (e - p > 2 && p[1] == 'n' && is_space(p[2])) ++chunk.num_normals;
+					else if (e - p > 2 && p[1] == 't' && is_space(p[2])) ++chunk.num_texcoords;
+				}
+				return true;
+			});
+		}
+
+		//! Converts one 1-based or negative relative index to one 0-based index.
+		inline bool resolve_index(i32 index, usize num_defined, i32& out)
+		{
+			if (index > 0) out = index - 1;
+			else if (index < 0) out = (i32)((i64)num_defined + index);
+			else return false;
+			return true;
+		}
+
+		static bool parse_index(const c8*& p, const c8* end, usize num_vertices, usize num_normals, usize num_texcoords, Index& out)
+		{
+			out.vertex_index = -1;
+			out.normal_index = -1;
+			out.texcoord_index = -1;
+			i32 v;
+			if (!parse_int(p, end, v) || !resolve_index(v, num_vertices, out.vertex_index)) return false;
+			if (p < end && *p == '/')
+			{
+				++p;
+				if (p < end && *p != '/')
+				{
+					if (!parse_int(p, end, v) || !resolve_index(v, num_texcoords, out.texcoord_index)) return false;
+				}
+				if (p < end && *p == '/')
+				{
+					++p;
+					if (!parse_int(p, end, v) || !resolve_index(v, num_normals, out.normal_index)) return false;
+				}
 			}
+			return p == end || is_space(*p);
+		}
 
-			tinyobj::ObjReader reader;
+		//! Parses all lines in the chunk. Attributes are written to the object directly, while primitives are stored in the chunk.
+		static void parse_chunk(const ParseContext& ctx, Chunk& chunk)
+		{
+			Attributes& attributes = ctx.obj->attributes;
+			usize num_vertices = chunk.first_vertex;
+			usize num_normals = chunk.first_normal;
+			usize num_texcoords = chunk.first_texcoord;
+			usize line = 0;
+			chunk.segments.emplace_back();
+			// Guesses the number of faces from the chunk size to reduce reallocations.
+			chunk.face_indices.reserve((chunk.end - chunk.begin) / 32);
+			chunk.face_sizes.reserve((chunk.end - chunk.begin) / 96);
+			for_each_line(chunk.begin, chunk.end, [&](const c8* p, const c8* e)
+			{
+				++line;
+				if (p == e || *p == '#') return true;
+				Segment& segment = chunk.segments.back();
+				if (match_tag(p, e, "v", 1))
+				{
+					p += 2;
+					Float3U& pos = attributes.vertices[num_vertices];
+					pos = Float3U(0.0f, 0.0f, 0.0f);
+					parse_real(p, e, pos.x);
+					parse_real(p, e, pos.y);
+					parse_real(p, e, pos.z);
+					Float3U& color = attributes.colors[num_vertices];
+					if (!parse_real(p, e, color.x) || !parse_real(p, e, color.y) || !parse_real(p, e, color.z))
+					{
+						color = Float3U(1.0f, 1.0f, 1.0f);
+					}
+					++num_vertices;
+				}
+				else if (match_tag(p, e, "vn", 2))
+				{
+					p += 3;
+					Float3U& n = attributes.normals[num_normals];
+					n = Float3U(0.0f, 0.0f, 0.0f);
+					parse_real(p, e, n.x);
+					parse_real(p, e, n.y);
+					parse_real(p, e, n.z);
+					++num_normals;
+				}
+				else if (match_tag(p, e, "vt", 2))
+				{
+					p += 3;
+					Float2U& t = attributes.texcoords[num_texcoords];
+					t = Float2U(0.0f, 0.0f);
+					parse_real(p, e, t.x);
+					parse_real(p, e, t.y);
+					++num_texcoords;
+				}
+				else if (match_tag(p, e, "f", 1) || match_tag(p, e, "l", 1) || match_tag(p, e, "p", 1))
+				{
+					c8 type = *p;
+					Vector<Index>& indices = type == 'f' ? chunk.face_indices : (type == 'l' ? chunk.line_indices : chunk.point_indices);
+					usize first = indices.size();
+					p += 2;
+					skip_spaces(p, e);
+					while (p < e)
+					{
+						Index index;
+						if (!parse_index(p, e, num_vertices, num_normals, num_texcoords, index))
+						{
+							chunk.error = BasicError::format_error();
+							chunk.error_line = line;
+							return false;
+						}
+						indices.push_back(index);
+						skip_spaces(p, e);
+					}
+					u32 count = (u32)(indices.size() - first);
+					if (type == 'f')
+					{
+						chunk.face_sizes.push_back(count);
+						++segment.num_faces;
+						if (count >= 3) segment.num_triangles += count - 2;
+					}
+					else if (type == 'l')
+					{
+						chunk.line_sizes.push_back(count);
+						++segment.num_lines;
+						segment.num_line_indices += count;
+					}
+					else
+					{
+						segment.num_point_indices += count;
+					}
+				}
+				else if (match_tag(p, e, "usemtl", 6))
+				{
+					p += 6;
+					auto name = parse_string(p, e);
+					auto iter = ctx.material_map->find(Name(name.first, name.second));
+					i32 material_id = iter == ctx.material_map->end() ? -1 : iter->second;
+					chunk.material_changes.push_back({ chunk.face_sizes.size(), material_id });
+				}
+				else if (match_tag(p, e, "s", 1))
+				{
+					p += 2;
+					skip_spaces(p, e);
+					if (p == e) return true;
+					i32 id = 0;
+					if ((usize)(e - p) >= 3 && !memcmp(p, "off", 3)) id = 0;
+					else if (!parse_int(p, e, id) || id < 0) id = 0;
+					chunk.smoothing_changes.push_back({ chunk.face_sizes.size(), id });
+				}
+				else if (match_tag(p, e, "g", 1) || match_tag(p, e, "o", 1))
+				{
+					Segment s;
+					s.command = *p == 'g' ? SegmentCommand::group : SegmentCommand::object;
+					p += 2;
+					skip_spaces(p, e);
+					if (s.command == SegmentCommand::group)
+					{
+						// Multiple group names are joined by spaces.
+						while (p < e)
+						{
+							auto name = parse_string(p, e);
+							if (!s.name.empty()) s.name.push_back(' ');
+							s.name.append(name.first, name.second);
+							skip_spaces(p, e);
+						}
+					}
+					else
+					{
+						while (e > p && is_space(e[-1])) --e;
+						s.name.assign(p, e - p);
+					}
+					chunk.segments.push_back(move(s));
+				}
+				return true;
+			});
+		}
 
-			bool ret = reader.ParseFromString(obj_source, mtl_source);
+		void triangulate_polygon(const Index* polygon, u32 n, const Vector<Float3U>& positions, Vector<u32>& remaining, Index* dst)
+		{
+			remaining.clear();
+			for (u32 i = 0; i < n; ++i)
+			{
+				if ((usize)polygon[i].vertex_index >= positions.size())
+				{
+					// Invalid positions, falls back to triangle fans.
+					for (u32 j = 0; j < n - 2; ++j)
+					{
+						*dst++ = polygon[0];
+						*dst++ = polygon[j + 1];
+						*dst++ = polygon[j + 2];
+					}
+					return;
+				}
+				remaining.push_back(i);
+			}
+			// Computes the polygon normal using Newell's method.
+			f32 nx = 0.0f, ny = 0.0f, nz = 0.0f;
+			for (u32 i = 0; i < n; ++i)
+			{
+				const Float3U& a = positions[polygon[i].vertex_index];
+				const Float3U& b = positions[polygon[(i + 1) % n].vertex_index];
+				nx += (a.y - b.y) * (a.z + b.z);
+				ny += (a.z - b.z) * (a.x + b.x);
+				nz += (a.x - b.x) * (a.y + b.y);
+			}
+			u32 axis_x, axis_y;
+			f32 normal_sign;
+			if (fabsf(nx) >= fabsf(ny) && fabsf(nx) >= fabsf(nz)) { axis_x = 1; axis_y = 2; normal_sign = nx; }
+			else if (fabsf(ny) >= fabsf(nz)) { axis_x = 2; axis_y = 0; normal_sign = ny; }
+			else { axis_x = 0; axis_y = 1; normal_sign = nz; }
+			f32 orientation = normal_sign < 0.0f ? -1.0f : 1.0f;
+			auto get_point = [&](u32 i) -> Float2U
+			{
+				const Float3U& p = positions[polygon[i].vertex_index];
+				const f32* v = &p.x;
+				return Float2U(v[axis_x], v[axis_y]);
+			};
+			auto cross = [](const Float2U& o, const Float2U& a, const Float2U& b)
+			{
+				return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+			};
+			u32 guess = 0;
+			u32 num_failures = 0;
+			while (remaining.size() > 3)
+			{
+				u32 num_remaining = (u32)remaining.size();
+				if (guess >= num_remaining) guess = 0;
+				u32 i0 = remaining[guess];
+				u32 i1 = remaining[(guess + 1) % num_remaining];
+				u32 i2 = remaining[(guess + 2) % num_remaining];
+				bool is_ear = true;
+				// If no ear can be found for one whole round, the polygon is degenerated, so we clip the next vertex anyway.
+				if (num_failures < num_remaining)
+				{
+					Float2U a = get_point(i0), b = get_point(i1), c = get_point(i2);
+					if (cross(a, b, c) * orientation <= 0.0f) is_ear = false;
+					for (u32 k = 3; is_ear && k < num_remaining; ++k)
+					{
+						Float2U p = get_point(remaining[(guess + k) % num_remaining]);
+						if (cross(a, b, p) * orientation >= 0.0f &&
+							cross(b, c, p) * orientation >= 0.0f &&
+							cross(c, a, p) * orientation >= 0.0f)
+						{
+							is_ear = false;
+						}
+					}
+				}
+				if (!is_ear)
+				{
+					++guess;
+					++num_failures;
+					continue;
+				}
+				*dst++ = polygon[i0];
+				*dst++ = polygon[i1];
+				*dst++ = polygon[i2];
+				remaining.erase(remaining.begin() + (guess + 1) % num_remaining);
+				num_failures = 0;
+			}
+			*dst++ = polygon[remaining[0]];
+			*dst++ = polygon[remaining[1]];
+			*dst++ = polygon[remaining[2]];
+		}
 
-			if (!ret)
+		//! Writes triangles, lines and points of the chunk to shapes.
+		static void write_chunk_primitives(const ParseContext& ctx, Chunk& chunk)
+		{
+			ObjMesh& obj = *ctx.obj;
+			usize face = 0;
+			usize face_index = 0;
+			usize line = 0;
+			usize line_index = 0;
+			usize point_index = 0;
+			i32 material_id = chunk.material_id;
+			i32 smoothing_group_id = chunk.smoothing_group_id;
+			const StateChange* material_change = chunk.material_changes.begin();
+			const StateChange* smoothing_change = chunk.smoothing_changes.begin();
+			Vector<u32> remaining;
+			for (Segment& segment : chunk.segments)
 			{
-				auto& warn = reader.Warning();
-				auto& err = reader.Error();
-				if (!err.empty())
+				if (segment.shape == USIZE_MAX)
+				{
+					// Primitives of discarded shapes are skipped.
+					for (usize i = 0; i < segment.num_faces; ++i) face_index += chunk.face_sizes[face + i];
+					face += segment.num_faces;
+					line += segment.num_lines;
+					line_index += segment.num_line_indices;
+					point_index += segment.num_point_indices;
+					continue;
+				}
+				Shape& shape = obj.shapes[segment.shape];
+				usize triangle = segment.first_triangle;
+				for (usize i = 0; i < segment.num_faces; ++i, ++face)
 				{
-					return set_error(BasicError::format_error(), err.c_str());
+					while (material_change != chunk.material_changes.end() && material_change->first_face <= face)
+					{
+						material_id = material_change->value;
+						++material_change;
+					}
+					while (smoothing_change != chunk.smoothing_changes.end() && smoothing_change->first_face <= face)
+					{
+						smoothing_group_id = smoothing_change->value;
+						++smoothing_change;
+					}
+					u32 n = chunk.face_sizes[face];
+					const Index* polygon = chunk.face_indices.data() + face_index;
+					face_index += n;
+					if (n < 3) continue;
+					Index* dst = shape.mesh.indices.data() + triangle * 3;
+					if (n == 3)
+					{
+						dst[0] = polygon[0];
+						dst[1] = polygon[1];
+						dst[2] = polygon[2];
+					}
+					else
+					{
+						triangulate_polygon(polygon, n, obj.attributes.vertices, remaining, dst);
+					}
+					for (u32 t = 0; t < n - 2; ++t, ++triangle)
+					{
+						shape.mesh.material_ids[triangle] = material_id;
+						shape.mesh.smoothing_group_ids[triangle] = (u32)smoothing_group_id;
+					}
 				}
-				return BasicError::format_error();
+				memcpy(shape.lines.num_line_vertices.data() + segment.first_line, chunk.line_sizes.data() + line, segment.num_lines * sizeof(i32));
+				memcpy(shape.lines.indices.data() + segment.first_line_index, chunk.line_indices.data() + line_index, segment.num_line_indices * sizeof(Index));
+				memcpy(shape.points.indices.data() + segment.first_point_index, chunk.point_indices.data() + point_index, segment.num_point_indices * sizeof(Index));
+				line += segment.num_lines;
+				line_index += segment.num_line_indices;
+				point_index += segment.num_point_indices;
 			}
+			// Releases chunk memory as soon as possible.
+			chunk.face_indices.clear();
+			chunk.face_indices.shrink_to_fit();
+			chunk.face_sizes.clear();
+			chunk.face_sizes.shrink_to_fit();
+		}
 
-			const tinyobj::attrib_t& attrib = reader.GetAttrib();
-			const std::vector<tinyobj::shape_t>& shapes = reader.GetShapes();
-			const std::vector<tinyobj::material_t>& meterials = reader.GetMaterials();
+		static void read_material_names(Span<const byte_t> mtl_file, HashMap<Name, i32>& material_map)
+		{
+			i32 num_materials = 0;
+			const c8* begin = (const c8*)mtl_file.data();
+			for_each_line(begin, begin + mtl_file.size(), [&](const c8* p, const c8* e)
+			{
+				if (match_tag(p, e, "newmtl", 6))
+				{
+					p += 7;
+					if (p < e)
+					{
+						material_map.insert(make_pair(Name(p, e - p), num_materials));
+						++num_materials;
+					}
+				}
+				return true;
+			});
+		}
 
-			ObjMesh obj;
+		LUNA_OBJ_LOADER_API R<ObjMesh> load(Span<const byte_t> obj_file, Span<const byte_t> mtl_file)
+		{
+			HashMap<Name, i32> material_map;
+			read_material_names(mtl_file, material_map);
 
-			auto& attributes = obj.attributes;
+			// Splits the file into chunks on line boundaries.
+			Vector<Chunk> chunks;
+			const c8* data = (const c8*)obj_file.data();
+			const c8* data_end = data + obj_file.size();
+			const c8* cur = data;
+			do
+			{
+				Chunk chunk;
+				chunk.begin = cur;
+				if ((usize)(data_end - cur) <= OBJ_BYTES_PER_JOB) cur = data_end;
+				else
+				{
+					const c8* line_end = (const c8*)memchr(cur + OBJ_BYTES_PER_JOB, '\n', data_end - cur - OBJ_BYTES_PER_JOB);
+					cur = line_end ? line_end + 1 : data_end;
+				}
+				chunk.end = cur;
+				chunks.push_back(move(chunk));
+			} while (cur < data_end);
 
-			// Copy attributes.
-			attributes.vertices.resize(attrib.vertices.size() / 3);
-			attributes.normals.resize(attrib.normals.size() / 3);
-			attributes.texcoords.resize(attrib.texcoords.size() / 2);
-			attributes.colors.resize(attrib.colors.size() / 3);
+			ObjMesh obj;
+			ParseContext ctx;
+			ctx.obj = &obj;
+			ctx.material_map = &material_map;
+			ctx.chunks = &chunks;
 
-			if (attributes.vertices.size())
+			// Pass 1: counts attributes so that every chunk knows the indices of its attributes.
+			dispatch_chunk_pass(ctx, count_chunk_attributes);
+			usize num_vertices = 0, num_normals = 0, num_texcoords = 0;
+			for (Chunk& chunk : chunks)
 			{
-				memcpy(&attributes.vertices[0], &attrib.vertices[0], sizeof(Float3U) * attributes.vertices.size());
+				chunk.first_vertex = num_vertices;
+				chunk.first_normal = num_normals;
+				chunk.first_texcoord = num_texcoords;
+				num_vertices += chunk.num_vertices;
+				num_normals += chunk.num_normals;
+				num_texcoords += chunk.num_texcoords;
 			}
-			if (attributes.normals.size())
+			obj.attributes.vertices.resize(num_vertices);
+			obj.attributes.colors.resize(num_vertices);
+			obj.attributes.normals.resize(num_normals);
+			obj.attributes.texcoords.resize(num_texcoords);
+
+			// Pass 2: parses attributes and primitives.
+			dispatch_chunk_pass(ctx, parse_chunk);
+			usize line_offset = 0;
+			for (Chunk& chunk : chunks)
 			{
-				memcpy(&attributes.normals[0], &attrib.normals[0], sizeof(Float3U) * attributes.normals.size());
+				if (chunk.error.code)
+				{
+					return set_error(chunk.error, "Failed to parse the obj file at line %llu.", (u64)(line_offset + chunk.error_line));
+				}
+				line_offset += chunk.num_lines;
 			}
-			if (attributes.texcoords.size())
+
+			// Assigns segments to shapes. One new shape is started by every `g` or `o` line, and empty shapes are discarded.
+			// Shapes that are ended by `g` lines are discarded if they do not have faces, which is the same as tinyobjloader.
+			struct ShapeSize
 			{
-				memcpy(&attributes.texcoords[0], &attrib.texcoords[0], sizeof(Float2U) * attributes.texcoords.size());
-			}
-			if (attributes.colors.size())
+				usize num_triangles = 0;
+				usize num_lines = 0;
+				usize num_line_indices = 0;
+				usize num_point_indices = 0;
+			};
+			Vector<ShapeSize> shape_sizes;
+			Vector<Segment*> shape_segments;
+			bool shape_started = false;
+			const String* shape_name = nullptr;
+			i32 material_id = -1;
+			i32 smoothing_group_id = 0;
+			for (Chunk& chunk : chunks)
 			{
-				memcpy(&attributes.colors[0], &attrib.colors[0], sizeof(Float3U) * attributes.colors.size());
+				chunk.material_id = material_id;
+				chunk.smoothing_group_id = smoothing_group_id;
+				if (!chunk.material_changes.empty()) material_id = chunk.material_changes.back().value;
+				if (!chunk.smoothing_changes.empty()) smoothing_group_id = chunk.smoothing_changes.back().value;
+				for (Segment& segment : chunk.segments)
+				{
+					if (segment.command != SegmentCommand::none)
+					{
+						if (shape_started && segment.command == SegmentCommand::group && !shape_sizes.back().num_triangles)
+						{
+							for (Segment* s : shape_segments) s->shape = USIZE_MAX;
+							obj.shapes.pop_back();
+							shape_sizes.pop_back();
+						}
+						shape_started = false;
+						shape_name = &segment.name;
+					}
+					if (!segment.num_triangles && !segment.num_lines && !segment.num_point_indices) continue;
+					if (!shape_started)
+					{
+						Shape shape;
+						if (shape_name) shape.name = Name(shape_name->c_str());
+						obj.shapes.push_back(move(shape));
+						shape_sizes.emplace_back();
+						shape_segments.clear();
+						shape_started = true;
+					}
+					segment.shape = obj.shapes.size() - 1;
+					shape_segments.push_back(&segment);
+					ShapeSize& size = shape_sizes.back();
+					segment.first_triangle = size.num_triangles;
+					segment.first_line = size.num_lines;
+					segment.first_line_index = size.num_line_indices;
+					segment.first_point_index = size.num_point_indices;
+					size.num_triangles += segment.num_triangles;
+					size.num_lines += segment.num_lines;
+					size.num_line_indices += segment.num_line_indices;
+					size.num_point_indices += segment.num_point_indices;
+				}
 			}
-
-			// Copy shape information.
-			obj.shapes.resize(shapes.size());
-			for (usize i = 0; i < shapes.size(); ++i)
+			for (usize i = 0; i < obj.shapes.size(); ++i)
 			{
-				copy_shape(obj.shapes[i], shapes[i]);
+				Shape& shape = obj.shapes[i];
+				const ShapeSize& size = shape_sizes[i];
+				shape.mesh.indices.resize(size.num_triangles * 3);
+				shape.mesh.num_face_vertices.resize(size.num_triangles, 3);
+				shape.mesh.material_ids.resize(size.num_triangles);
+				shape.mesh.smoothing_group_ids.resize(size.num_triangles);
+				shape.lines.indices.resize(size.num_line_indices);
+				shape.lines.num_line_vertices.resize(size.num_lines);
+				shape.points.indices.resize(size.num_point_indices);
 			}
 
+			// Pass 3: triangulates faces and writes primitives to shapes.
+			dispatch_chunk_pass(ctx, write_chunk_primitives);
 			return obj;
 		}
 	}
@@ -146,4 +805,4 @@ namespace Luna
 		static ObjLoader::ObjLoaderModule m;
 		return &m;
 	}
-}
\ No newline at end of file
+}
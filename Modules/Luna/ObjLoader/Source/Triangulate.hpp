@@ -0,0 +1,26 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Triangulate.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../ObjLoader.hpp"
+
+namespace Luna
+{
+	namespace ObjLoader
+	{
+		//! Triangulates one polygon by ear clipping on the plane that the polygon is most parallel to.
+		//! @details Polygons that refer to invalid positions are converted to triangle fans.
+		//! @param[in] polygon The corners of the polygon.
+		//! @param[in] n The number of corners, which must be greater than 3.
+		//! @param[in] positions The vertex positions that corners refer to.
+		//! @param[in] remaining The scratch buffer used by this function.
+		//! @param[out] dst The buffer to write `(n - 2) * 3` indices to.
+		void triangulate_polygon(const Index* polygon, u32 n, const Vector<Float3U>& positions, Vector<u32>& remaining, Index* dst);
+	}
+}
@@ -23,8 +23,8 @@ namespace Luna
         enum class RenderGraphResourceType : u8
         {
             //! This resource is used to hold temporal data during the render graph execution.
-            //! The render graph allocates this resource at first access, and releases the resource after last 
-            //! access.
+            //! The render graph computes the lifetime of this resource when the graph is being compiled, and 
+            //! transient resources whose lifetimes do not overlap may share the same device memory.
             transient = 0,
             //! This resource is persistent. Such resources are used to hold data between render graph executions.
             //! The render graph allocates this resource when the graph is being compiled, 
@@ -71,6 +71,30 @@ namespace Luna
         struct RenderGraphCompileConfig
         {
             bool enable_time_profiling = false;
+            //! The maximum number of segments that enabled passes are split into when executing the render graph.
+            //! If this is greater than 1, every segment is recorded into one separate command buffer concurrently 
+            //! using job system workers, and segments are submitted in pass order. Passes are assigned to segments based
+            //! on the recording time of passes measured in the last execution. Passes on different command queues are 
+            //! always recorded in different segments, which may create more segments than this number.
+            u32 max_recording_segments = 1;
+            //! The maximum number of compiled plans kept by the render graph besides the current one. 
+            //! When `compile` is called with one render graph desc and config that matches one cached plan, the cached plan 
+            //! is reused without compiling. Cached plans keep their passes and resources alive, so set this to 0 
+            //! to release them immediately.
+            u32 max_cached_plans = 4;
+        };
+
+        struct RenderPassTimeRange
+        {
+            //! The index of the pass in `RenderGraphDesc::passes`.
+            usize pass;
+            //! The index of the command queue that executes the pass.
+            u32 command_queue;
+            //! The time when the pass begins on GPU, in seconds, relative to the beginning of the earliest pass.
+            //! See `IRenderGraph::get_pass_time_ranges` for queues that use different clocks.
+            f64 begin;
+            //! The time when the pass ends on GPU, in seconds, relative to the beginning of the earliest pass.
+            f64 end;
         };
 
         struct IRenderGraph : virtual Interface
@@ -83,6 +107,11 @@ namespace Luna
 
             virtual void set_desc(const RenderGraphDesc& desc) = 0;
 
+            //! Compiles the render graph using the current render graph desc.
+            //! @remark Compiled plans are cached by their render graph descs and configs. If one cached plan matches, 
+            //! it is restored without compiling any pass. Otherwise, passes whose connections and connected resource descs 
+            //! are not changed since the last compilation reuse their render pass objects, and only passes affected by 
+            //! the change are compiled again.
             virtual RV compile(const RenderGraphCompileConfig& config) = 0;
 
             virtual void get_enabled_render_passes(Vector<usize>& render_passes) = 0;
@@ -91,11 +120,45 @@ namespace Luna
 
             virtual void set_external_resource(usize index, RHI::IResource* resource) = 0;
 
+            //! Records all enabled passes.
+            //! @param[in] cmdbuf The command buffer to record passes to. Passes that run on other command queues are 
+            //! recorded to command buffers created by the render graph, and are synchronized with passes on the queue of 
+            //! `cmdbuf` using fences.
+            //! @remark If the render graph is compiled with `max_recording_segments` greater than 1, only the last segment
+            //! is recorded to `cmdbuf`. Other segments are recorded to command buffers created by the render graph on the same
+            //! command queue as `cmdbuf`, and are submitted before this function returns. The user should submit `cmdbuf` after
+            //! this function returns, and should not record commands that passes depend on to `cmdbuf` before calling this 
+            //! function, since they will be executed after the previous segments.
+            //! 
+            //! If passes run on multiple command queues, all passes may be recorded to command buffers created by the 
+            //! render graph. In such case, the render graph submits one command buffer on the queue of `cmdbuf` that waits 
+            //! for all passes, so commands recorded to `cmdbuf` are executed after all passes.
+            //! 
+            //! Command buffers created by the render graph are reused by every execution, so this function blocks until the ones 
+            //! submitted by the last execution are finished on GPU.
             virtual RV execute(RHI::ICommandBuffer* cmdbuf) = 0;
 
             virtual RHI::IResource* get_persistent_resource(usize index) = 0;
 
             virtual RV get_pass_time_intervals(Vector<u64>& pass_times) = 0;
+
+            //! Gets the GPU time range of every enabled pass measured in the last execution. The render graph must be 
+            //! compiled with `enable_time_profiling` set.
+            //! @param[out] ranges The time ranges of enabled passes.
+            //! @param[out] overlapped_time If not `nullptr`, returns the time in seconds that passes run concurrently on 
+            //! different command queues, which is the sum of pass times minus the total time covered by any pass.
+            //! @remark Time ranges of passes on different command queues are computed from the timestamp of every queue, 
+            //! and may not be accurately comparable on backends that use different clocks for different queues. If command 
+            //! queues of passes report different timestamp frequencies, their clocks are considered different: ranges of every 
+            //! queue are relative to the earliest pass on the same queue, and `overlapped_time` is always 0.
+            virtual RV get_pass_time_ranges(Vector<RenderPassTimeRange>& ranges, f64* overlapped_time = nullptr) = 0;
+
+            //! Gets the total size of device memory allocated for transient resources when the render graph is compiled.
+            //! This does not include temporary resources allocated by passes.
+            //! @remark Transient resources are placed in memory slots, and resources whose lifetimes do not overlap may share
+            //! one slot. Every slot is as large as its largest resource and all slots are allocated during the execution, so 
+            //! this may be greater than the peak size of transient resources that are alive at the same time.
+            virtual u64 get_allocated_transient_memory_size() = 0;
         };
 
         LUNA_RG_API Ref<IRenderGraph> new_render_graph(RHI::IDevice* device);
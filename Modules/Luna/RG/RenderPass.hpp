@@ -91,6 +91,13 @@ namespace Luna
             virtual void set_resource_desc(usize resource, const ResourceDesc& desc) = 0;
 
             virtual void set_render_pass_object(IRenderPass* render_pass) = 0;
+
+            //! Sets the type of the command queue that this pass should be executed on. The default type is 
+            //! `RHI::CommandQueueType::graphics`.
+            //! @remark Passes that are not executed on graphics queues can run concurrently with graphics passes 
+            //! if they have no resource dependency. If the device does not have one queue of the specified type, 
+            //! the pass is executed on the queue of the command buffer passed to `IRenderGraph::execute`.
+            virtual void set_command_queue_type(RHI::CommandQueueType type) = 0;
         };
 
         using render_pass_compile_func_t = RV(object_t userdata, IRenderGraphCompiler* compiler);
@@ -109,6 +116,13 @@ namespace Luna
             Vector<RenderPassTypeParameter> input_parameters;
             //! The resource that is used as outputs of the node.
             Vector<RenderPassTypeParameter> output_parameters;
+            //! The function to compile one pass of this type.
+            //! @remark When the render graph is compiled again, this function is not called for one pass if the pass has
+            //! the same type, the same connections and the same descs of all connected resources as the last compilation.
+            //! In such case, the render pass object, the command queue type and descs of connected resources set by the last
+            //! call are reused. So the result of this function must depend only on descs of resources connected to the pass,
+            //! and must not depend on other states, like global settings or states of `userdata` that may change between
+            //! compilations.
             render_pass_compile_func_t* compile;
             ObjRef userdata;
         };
@@ -11,6 +11,7 @@
 #define LUNA_RG_API LUNA_EXPORT
 #include "RenderPass.hpp"
 #include <Luna/Runtime/Module.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 #include "RenderGraph.hpp"
 #include "../RG.hpp"
 namespace Luna
@@ -22,12 +23,14 @@ namespace Luna
             virtual const c8* get_name() override { return "RG"; }
 			virtual RV on_register() override
 			{
-				return add_dependency_module(this, module_rhi());
+				return add_dependency_modules(this, {module_rhi(), module_job_system()});
 			}
 			virtual RV on_init() override
 			{
 				register_boxed_type<RenderGraph>();
-                impl_interface_for_type<RenderGraph, IRenderGraph, IRenderPassContext, IRenderGraphCompiler>();
+                impl_interface_for_type<RenderGraph, IRenderGraph, IRenderGraphCompiler>();
+                register_boxed_type<RenderPassContext>();
+                impl_interface_for_type<RenderPassContext, IRenderPassContext>();
                 g_render_pass_types_mtx = new_mutex();
                 return ok;
 			}
@@ -11,6 +11,9 @@
 #define LUNA_RG_API LUNA_EXPORT
 #include "RenderGraph.hpp"
 #include "RenderPass.hpp"
+#include <Luna/Runtime/Time.hpp>
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
 
 namespace Luna
 {
@@ -59,7 +62,219 @@ namespace Luna
             return true;
         }
 
+        inline bool operator==(const ResourceDesc& lhs, const ResourceDesc& rhs)
+        {
+            if (lhs.type != rhs.type || lhs.memory_type != rhs.memory_type) return false;
+            if (lhs.type == ResourceType::buffer)
+            {
+                return lhs.buffer.size == rhs.buffer.size && lhs.buffer.usages == rhs.buffer.usages && lhs.buffer.flags == rhs.buffer.flags;
+            }
+            const RHI::TextureDesc& l = lhs.texture;
+            const RHI::TextureDesc& r = rhs.texture;
+            return l.type == r.type && l.format == r.format && l.width == r.width && l.height == r.height && l.depth == r.depth &&
+                l.array_size == r.array_size && l.mip_levels == r.mip_levels && l.sample_count == r.sample_count && 
+                l.usages == r.usages && l.flags == r.flags;
+        }
+        inline bool operator!=(const ResourceDesc& lhs, const ResourceDesc& rhs)
+        {
+            return !(lhs == rhs);
+        }
+        inline bool is_connections_equal(const Vector<RenderGraphConnection>& lhs, const Vector<RenderGraphConnection>& rhs)
+        {
+            if (lhs.size() != rhs.size()) return false;
+            for (usize i = 0; i < lhs.size(); ++i)
+            {
+                if (lhs[i].pass != rhs[i].pass || lhs[i].parameter != rhs[i].parameter || lhs[i].resource != rhs[i].resource) return false;
+            }
+            return true;
+        }
+        inline bool is_compile_inputs_equal(const RenderGraphDesc& lhs, const RenderGraphCompileConfig& lhs_config,
+            const RenderGraphDesc& rhs, const RenderGraphCompileConfig& rhs_config)
+        {
+            if (lhs_config.enable_time_profiling != rhs_config.enable_time_profiling ||
+                lhs_config.max_recording_segments != rhs_config.max_recording_segments) return false;
+            if (lhs.passes.size() != rhs.passes.size() || lhs.resources.size() != rhs.resources.size()) return false;
+            for (usize i = 0; i < lhs.passes.size(); ++i)
+            {
+                if (lhs.passes[i].name != rhs.passes[i].name || lhs.passes[i].type != rhs.passes[i].type) return false;
+            }
+            for (usize i = 0; i < lhs.resources.size(); ++i)
+            {
+                auto& l = lhs.resources[i];
+                auto& r = rhs.resources[i];
+                if (l.type != r.type || l.flags != r.flags || l.name != r.name || l.desc != r.desc) return false;
+            }
+            return is_connections_equal(lhs.input_connections, rhs.input_connections) &&
+                is_connections_equal(lhs.output_connections, rhs.output_connections);
+        }
+        template <typename _Ty>
+        inline u64 hash_value(u64 h, const _Ty& value)
+        {
+            return memhash64(&value, sizeof(_Ty), h);
+        }
+        inline u64 hash_resource_desc(u64 h, const ResourceDesc& desc)
+        {
+            h = hash_value(h, desc.type);
+            h = hash_value(h, desc.memory_type);
+            if (desc.type == ResourceType::buffer)
+            {
+                h = hash_value(h, desc.buffer.size);
+                h = hash_value(h, desc.buffer.usages);
+                return hash_value(h, desc.buffer.flags);
+            }
+            const RHI::TextureDesc& tex = desc.texture;
+            h = hash_value(h, tex.type);
+            h = hash_value(h, tex.format);
+            h = hash_value(h, tex.width);
+            h = hash_value(h, tex.height);
+            h = hash_value(h, tex.depth);
+            h = hash_value(h, tex.array_size);
+            h = hash_value(h, tex.mip_levels);
+            h = hash_value(h, tex.sample_count);
+            h = hash_value(h, tex.usages);
+            return hash_value(h, tex.flags);
+        }
+        inline u64 hash_compile_inputs(const RenderGraphDesc& desc, const RenderGraphCompileConfig& config)
+        {
+            u64 h = hash_value(0, config.enable_time_profiling);
+            h = hash_value(h, config.max_recording_segments);
+            for (auto& pass : desc.passes)
+            {
+                h = hash_value(h, pass.name.id());
+                h = hash_value(h, pass.type.id());
+            }
+            for (auto& res : desc.resources)
+            {
+                h = hash_value(h, res.type);
+                h = hash_value(h, res.flags);
+                h = hash_value(h, res.name.id());
+                h = hash_resource_desc(h, res.desc);
+            }
+            for (auto& c : desc.input_connections)
+            {
+                h = hash_value(h, c.pass);
+                h = hash_value(h, c.parameter.id());
+                h = hash_value(h, c.resource);
+            }
+            // Separates input connections from output connections.
+            h = hash_value(h, desc.input_connections.size());
+            for (auto& c : desc.output_connections)
+            {
+                h = hash_value(h, c.pass);
+                h = hash_value(h, c.parameter.id());
+                h = hash_value(h, c.resource);
+            }
+            return h;
+        }
+        void RenderGraph::store_compiled_plan(CompiledPlan& plan)
+        {
+            plan.m_hash = m_compiled_hash;
+            plan.m_desc = move(m_compiled_desc);
+            plan.m_config = m_compiled_config;
+            plan.m_pass_data = move(m_pass_data);
+            plan.m_resource_data = move(m_resource_data);
+            plan.m_enabled_passes = move(m_enabled_passes);
+            plan.m_transient_memory_slots = move(m_transient_memory_slots);
+            plan.m_transient_memory_size = m_transient_memory_size;
+            m_pass_data.clear();
+            m_resource_data.clear();
+            m_enabled_passes.clear();
+            m_transient_memory_slots.clear();
+            m_transient_memory_size = 0;
+            m_compiled = false;
+        }
+        void RenderGraph::load_compiled_plan(CompiledPlan& plan)
+        {
+            m_compiled_hash = plan.m_hash;
+            m_compiled_desc = move(plan.m_desc);
+            m_compiled_config = plan.m_config;
+            m_pass_data = move(plan.m_pass_data);
+            m_resource_data = move(plan.m_resource_data);
+            m_enabled_passes = move(plan.m_enabled_passes);
+            m_transient_memory_slots = move(plan.m_transient_memory_slots);
+            m_transient_memory_size = plan.m_transient_memory_size;
+            m_enable_time_profiling = m_compiled_config.enable_time_profiling;
+            m_max_recording_segments = m_compiled_config.max_recording_segments;
+            m_num_enabled_passes = (u32)m_enabled_passes.size();
+            m_compiled = true;
+        }
         RV RenderGraph::compile(const RenderGraphCompileConfig& config)
+        {
+            lutry
+            {
+                u64 hash = hash_compile_inputs(m_desc, config);
+                if (m_compiled && m_compiled_hash == hash && is_compile_inputs_equal(m_compiled_desc, m_compiled_config, m_desc, config))
+                {
+                    // Nothing changed, only updates the cache size.
+                    m_compiled_config.max_cached_plans = config.max_cached_plans;
+                    if (m_cached_plans.size() > config.max_cached_plans) m_cached_plans.resize(config.max_cached_plans);
+                    return ok;
+                }
+                CompiledPlan prev;
+                bool has_prev = m_compiled;
+                if (has_prev) store_compiled_plan(prev);
+                usize cached = USIZE_MAX;
+                for (usize i = 0; i < m_cached_plans.size(); ++i)
+                {
+                    auto& plan = m_cached_plans[i];
+                    if (plan.m_hash == hash && is_compile_inputs_equal(plan.m_desc, plan.m_config, m_desc, config))
+                    {
+                        cached = i;
+                        break;
+                    }
+                }
+                RV r = ok;
+                if (cached != USIZE_MAX)
+                {
+                    load_compiled_plan(m_cached_plans[cached]);
+                    m_cached_plans.erase(m_cached_plans.begin() + cached);
+                    m_compiled_config.max_cached_plans = config.max_cached_plans;
+                }
+                else
+                {
+                    r = compile_plan(config, has_prev ? &prev : nullptr);
+                    if (succeeded(r))
+                    {
+                        m_compiled_hash = hash;
+                        m_compiled_desc = m_desc;
+                        m_compiled_config = config;
+                        m_compiled = true;
+                    }
+                }
+                if (has_prev) m_cached_plans.insert(m_cached_plans.begin(), move(prev));
+                if (m_cached_plans.size() > config.max_cached_plans) m_cached_plans.resize(config.max_cached_plans);
+                luexp(r);
+                luexp(update_time_query_heap());
+            }
+            lucatchret;
+            return ok;
+        }
+        bool RenderGraph::can_reuse_pass(const CompiledPlan& prev, usize pass)
+        {
+            if (pass >= prev.m_pass_data.size() || prev.m_desc.passes[pass].type != m_desc.passes[pass].type) return false;
+            auto& data = m_pass_data[pass];
+            auto& prev_data = prev.m_pass_data[pass];
+            if (!prev_data.m_enabled || !prev_data.m_render_pass) return false;
+            if (data.m_compile_resources.size() != prev_data.m_compile_resources.size()) return false;
+            for (usize i = 0; i < data.m_compile_resources.size(); ++i)
+            {
+                if (data.m_compile_resources[i] != prev_data.m_compile_resources[i]) return false;
+                if (m_resource_data[data.m_compile_resources[i]].m_resource_desc != prev_data.m_compile_input_descs[i]) return false;
+            }
+            auto is_parameters_equal = [](const HashMap<Name, usize>& lhs, const HashMap<Name, usize>& rhs)
+            {
+                if (lhs.size() != rhs.size()) return false;
+                for (auto& i : lhs)
+                {
+                    auto iter = rhs.find(i.first);
+                    if (iter == rhs.end() || iter->second != i.second) return false;
+                }
+                return true;
+            };
+            return is_parameters_equal(data.m_input_resources, prev_data.m_input_resources) &&
+                is_parameters_equal(data.m_output_resources, prev_data.m_output_resources);
+        }
+        RV RenderGraph::compile_plan(const RenderGraphCompileConfig& config, const CompiledPlan* prev)
         {
             lutry
             {
@@ -68,6 +283,17 @@ namespace Luna
                 m_pass_data.clear();
                 m_pass_data.resize(m_desc.passes.size());
                 m_enable_time_profiling = config.enable_time_profiling;
+                m_max_recording_segments = config.max_recording_segments;
+                // Passes that prefer compute or copy queues are executed on the first queue of that type.
+                m_compute_queue = U32_MAX;
+                m_copy_queue = U32_MAX;
+                u32 num_queues = m_device->get_num_command_queues();
+                for (u32 i = 0; i < num_queues; ++i)
+                {
+                    auto queue_type = m_device->get_command_queue_desc(i).type;
+                    if (queue_type == RHI::CommandQueueType::compute && m_compute_queue == U32_MAX) m_compute_queue = i;
+                    if (queue_type == RHI::CommandQueueType::copy && m_copy_queue == U32_MAX) m_copy_queue = i;
+                }
                 Vector<ResourceTrackData> resource_track_data(m_resource_data.size());
                 // Initialize pass data and resource track data.
                 for (auto& i : m_desc.input_connections)
@@ -133,38 +359,78 @@ namespace Luna
                 }
                 // Compile every node in execution order.
                 u32 num_enabled_passes = 0;
+                m_enabled_passes.clear();
                 for(usize i = 0; i < m_desc.passes.size(); ++i)
                 {
                     m_current_compile_pass = i;
                     if(m_pass_data[i].m_enabled)
                     {
+                        auto& pass = m_pass_data[i];
+                        pass.m_time_query_index = num_enabled_passes;
+                        m_enabled_passes.push_back(i);
                         ++num_enabled_passes;
-                        MutexGuard guard(g_render_pass_types_mtx);
-                        auto iter = g_render_pass_types.find(m_desc.passes[i].type);
-                        if(iter == g_render_pass_types.end())
+                        auto add_compile_resource = [&](usize r)
+                        {
+                            for (usize j : pass.m_compile_resources) if (j == r) return;
+                            pass.m_compile_resources.push_back(r);
+                        };
+                        for (auto& r : pass.m_input_resources) add_compile_resource(r.second);
+                        for (auto& r : pass.m_output_resources) add_compile_resource(r.second);
+                        sort(pass.m_compile_resources.begin(), pass.m_compile_resources.end());
+                        for (usize r : pass.m_compile_resources) pass.m_compile_input_descs.push_back(m_resource_data[r].m_resource_desc);
+                        if (prev && can_reuse_pass(*prev, i))
                         {
-                            return set_error(BasicError::not_found(), "Render pass type \"%s\" is not found.", m_desc.passes[i].type.c_str());
+                            // The pass sees the same resources as the last compilation, so it produces the same 
+                            // render pass object and resource descs.
+                            auto& prev_pass = prev->m_pass_data[i];
+                            pass.m_render_pass = prev_pass.m_render_pass;
+                            pass.m_queue_type = prev_pass.m_queue_type;
+                            pass.m_record_ticks = prev_pass.m_record_ticks;
+                            pass.m_compile_output_descs = prev_pass.m_compile_output_descs;
+                            for (usize j = 0; j < pass.m_compile_resources.size(); ++j)
+                            {
+                                m_resource_data[pass.m_compile_resources[j]].m_resource_desc = pass.m_compile_output_descs[j];
+                            }
+                            continue;
                         }
-                        luexp(iter->compile(iter->userdata.get(), this));
+                        {
+                            MutexGuard guard(g_render_pass_types_mtx);
+                            auto iter = g_render_pass_types.find(m_desc.passes[i].type);
+                            if(iter == g_render_pass_types.end())
+                            {
+                                return set_error(BasicError::not_found(), "Render pass type \"%s\" is not found.", m_desc.passes[i].type.c_str());
+                            }
+                            luexp(iter->compile(iter->userdata.get(), this));
+                        }
+                        for (usize r : pass.m_compile_resources) pass.m_compile_output_descs.push_back(m_resource_data[r].m_resource_desc);
                     }
                 }
                 // Resolve transient resource lifetime.
                 for(usize i = 0; i < resource_track_data.size(); ++i)
                 {
                     auto& res = resource_track_data[i];
-                    if(m_desc.resources[i].type == RenderGraphResourceType::transient && res.first_access != USIZE_MAX)
+                    if (res.first_access == USIZE_MAX) continue;
+                    m_resource_data[i].m_first_access = res.first_access;
+                    m_resource_data[i].m_last_access = res.last_access;
+                    if(m_desc.resources[i].type == RenderGraphResourceType::transient)
                     {
                         m_pass_data[resource_track_data[i].first_access].m_create_resources.push_back(i);
-                        m_pass_data[resource_track_data[i].last_access].m_release_resources.push_back(i);
                     }
                 }
+                luexp(place_transient_resources(prev));
                 // Create output resources.
                 for(usize i = 0; i < m_desc.resources.size(); ++i)
                 {
                     if(m_desc.resources[i].type == RenderGraphResourceType::persistent)
                     {
                         auto& res = m_resource_data[i];
-                        if(is_resource_desc_valid(res.m_resource_desc))
+                        if (prev && i < prev->m_resource_data.size() && prev->m_desc.resources[i].type == RenderGraphResourceType::persistent &&
+                            prev->m_resource_data[i].m_resource && prev->m_resource_data[i].m_resource_desc == res.m_resource_desc)
+                        {
+                            // Reuses the persistent resource if the resource desc is not changed.
+                            res.m_resource = prev->m_resource_data[i].m_resource;
+                        }
+                        else if(is_resource_desc_valid(res.m_resource_desc))
                         {
                             if (res.m_resource_desc.type == ResourceType::buffer)
                             {
@@ -182,19 +448,27 @@ namespace Luna
                         }
                     }
                 }
+                m_num_enabled_passes = num_enabled_passes;
+            }
+            lucatchret;
+            return ok;
+        }
+        RV RenderGraph::update_time_query_heap()
+        {
+            lutry
+            {
                 // Recreate time query heap.
                 if (m_enable_time_profiling)
                 {
-                    if (!m_time_query_heap || m_time_query_heap_capacity < num_enabled_passes)
+                    if (!m_time_query_heap || m_time_query_heap_capacity < m_num_enabled_passes)
                     {
                         RHI::QueryHeapDesc desc;
                         desc.type = RHI::QueryType::timestamp;
-                        desc.count = num_enabled_passes * 2;
+                        desc.count = m_num_enabled_passes * 2;
                         luset(m_time_query_heap, m_device->new_query_heap(desc));
-                        m_time_query_heap_capacity = num_enabled_passes;
+                        m_time_query_heap_capacity = m_num_enabled_passes;
                     }
                 }
-                m_num_enabled_passes = num_enabled_passes;
             }
             lucatchret;
             return ok;
@@ -210,61 +484,535 @@ namespace Luna
                 }
             }
         }
-        RV RenderGraph::execute(RHI::ICommandBuffer* cmdbuf)
+        //! Estimates the memory size of one resource. This is only used to sort resources before placing them, the actual
+        //! memory size is determined by the device.
+        inline u64 estimate_resource_size(const ResourceDesc& desc)
+        {
+            if (desc.type == ResourceType::buffer) return desc.buffer.size;
+            const RHI::TextureDesc& tex = desc.texture;
+            u64 size = (u64)tex.width * tex.height * tex.depth * tex.array_size * tex.sample_count * RHI::bits_per_pixel(tex.format) / 8;
+            // Mipmap chains take at most 1/3 more memory.
+            if (tex.mip_levels != 1) size += size / 3;
+            return size;
+        }
+        RV RenderGraph::place_transient_resources(const CompiledPlan* prev)
         {
             lutry
             {
-                m_transient_memory.clear();
-                m_cmdbuf = cmdbuf;
-                m_current_time_query_index = 0;
-                for(usize i = 0; i < m_pass_data.size(); ++i)
-                {
-                    auto& data = m_pass_data[i];
-                    if(!data.m_enabled) continue;
-                    // Allocates resources.
-                    Vector<RHI::BufferBarrier> buffer_barriers;
-                    Vector<RHI::TextureBarrier> texture_barriers;
-                    for(usize h : data.m_create_resources)
+                m_transient_memory_slots.clear();
+                m_transient_memory_size = 0;
+                Vector<usize> resources;
+                Vector<u64> sizes(m_desc.resources.size(), 0);
+                // Transient resources of the last compilation can be reused if all transient resources have the same 
+                // descs and lifetimes.
+                bool reuse = prev && prev->m_resource_data.size() == m_resource_data.size();
+                for(usize i = 0; i < m_desc.resources.size(); ++i)
+                {
+                    bool transient = m_desc.resources[i].type == RenderGraphResourceType::transient && m_resource_data[i].m_first_access != USIZE_MAX;
+                    if (reuse)
+                    {
+                        bool prev_transient = prev->m_desc.resources[i].type == RenderGraphResourceType::transient && prev->m_resource_data[i].m_first_access != USIZE_MAX;
+                        if (transient != prev_transient) reuse = false;
+                    }
+                    if(!transient) continue;
+                    auto& res = m_resource_data[i];
+                    if(!is_resource_desc_valid(res.m_resource_desc))
+                    {
+                        return set_error(BasicError::bad_data(), "Cannot create transient resource %s because the resource layout is not specified.", m_desc.resources[i].name.c_str());
+                    }
+                    if (res.m_resource_desc.type == ResourceType::texture) res.m_resource_desc.texture.flags |= RHI::ResourceFlag::allow_aliasing;
+                    else res.m_resource_desc.buffer.flags |= RHI::ResourceFlag::allow_aliasing;
+                    sizes[i] = estimate_resource_size(res.m_resource_desc);
+                    resources.push_back(i);
+                    if (reuse)
+                    {
+                        auto& prev_res = prev->m_resource_data[i];
+                        if (prev_res.m_resource_desc != res.m_resource_desc || prev_res.m_first_access != res.m_first_access ||
+                            prev_res.m_last_access != res.m_last_access) reuse = false;
+                    }
+                }
+                if (reuse)
+                {
+                    m_transient_memory_slots = prev->m_transient_memory_slots;
+                    m_transient_memory_size = prev->m_transient_memory_size;
+                    for (usize i : resources)
                     {
-                        auto& res = m_resource_data[h];
-                        if(is_resource_desc_valid(res.m_resource_desc))
+                        m_resource_data[i].m_resource = prev->m_resource_data[i].m_resource;
+                        m_resource_data[i].m_memory_slot = prev->m_resource_data[i].m_memory_slot;
+                    }
+                    return ok;
+                }
+                // Places resources from the largest one using first fit, so that every slot is sized by its first resource 
+                // in most cases.
+                sort(resources.begin(), resources.end(), [&](usize a, usize b) { return sizes[a] > sizes[b] || (sizes[a] == sizes[b] && a < b); });
+                Vector<RHI::BufferDesc> buffers;
+                Vector<RHI::TextureDesc> textures;
+                auto collect_descs = [&](const TransientMemorySlot& slot)
+                {
+                    buffers.clear();
+                    textures.clear();
+                    for(usize r : slot.m_resources)
+                    {
+                        auto& desc = m_resource_data[r].m_resource_desc;
+                        if (desc.type == ResourceType::texture) textures.push_back(desc.texture);
+                        else buffers.push_back(desc.buffer);
+                    }
+                };
+                for(usize i : resources)
+                {
+                    auto& desc = m_resource_data[i].m_resource_desc;
+                    usize target = USIZE_MAX;
+                    for(usize s = 0; s < m_transient_memory_slots.size(); ++s)
+                    {
+                        auto& slot = m_transient_memory_slots[s];
+                        if(slot.m_memory_type != desc.memory_type) continue;
+                        bool overlapped = false;
+                        for(usize r : slot.m_resources)
                         {
-                            luset(res.m_resource, allocate_transient_resource(res.m_resource_desc));
-                            cmdbuf->attach_device_object(res.m_resource);
-                            if(m_desc.resources[h].name) res.m_resource->set_name(m_desc.resources[h].name.c_str());
+                            auto& a = m_resource_data[i];
+                            auto& b = m_resource_data[r];
+                            if(a.m_first_access <= b.m_last_access && b.m_first_access <= a.m_last_access)
+                            {
+                                overlapped = true;
+                                break;
+                            }
                         }
-                        else
+                        if(overlapped) continue;
+                        collect_descs(slot);
+                        if (desc.type == ResourceType::texture) textures.push_back(desc.texture);
+                        else buffers.push_back(desc.buffer);
+                        if(m_device->is_resources_aliasing_compatible(desc.memory_type, buffers.cspan(), textures.cspan()))
                         {
-                            return set_error(BasicError::bad_data(), "Cannot create transient resource %s because the resource layout is not specified.", m_desc.resources[h].name.c_str());
+                            target = s;
+                            break;
                         }
+                    }
+                    if(target == USIZE_MAX)
+                    {
+                        target = m_transient_memory_slots.size();
+                        TransientMemorySlot slot;
+                        slot.m_memory_type = desc.memory_type;
+                        m_transient_memory_slots.push_back(move(slot));
+                    }
+                    m_transient_memory_slots[target].m_resources.push_back(i);
+                    m_resource_data[i].m_memory_slot = target;
+                }
+                // Allocates memory for every slot and creates resources.
+                for(auto& slot : m_transient_memory_slots)
+                {
+                    collect_descs(slot);
+                    luset(slot.m_memory, m_device->allocate_memory(slot.m_memory_type, buffers.cspan(), textures.cspan()));
+                    m_transient_memory_size += slot.m_memory->get_size();
+                    for(usize r : slot.m_resources)
+                    {
+                        auto& res = m_resource_data[r];
                         if (res.m_resource_desc.type == ResourceType::texture)
                         {
-                            Ref<RHI::ITexture> tex = res.m_resource;
-                            texture_barriers.push_back({ tex, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, RHI::TextureStateFlag::automatic, RHI::TextureStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
+                            luset(res.m_resource, m_device->new_aliasing_texture(slot.m_memory, res.m_resource_desc.texture));
                         }
                         else
                         {
-                            Ref<RHI::IBuffer> buf = res.m_resource;
-                            buffer_barriers.push_back({ buf, RHI::BufferStateFlag::automatic, RHI::BufferStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
+                            luset(res.m_resource, m_device->new_aliasing_buffer(slot.m_memory, res.m_resource_desc.buffer));
+                        }
+                        if(m_desc.resources[r].name) res.m_resource->set_name(m_desc.resources[r].name.c_str());
+                    }
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RV RenderGraph::record_pass(RenderPassContext* ctx, usize pass)
+        {
+            lutry
+            {
+                auto& data = m_pass_data[pass];
+                RHI::ICommandBuffer* cmdbuf = ctx->m_cmdbuf;
+                u64 begin_ticks = get_ticks();
+                // Transient resources may alias memory of resources used by previous passes.
+                Vector<RHI::BufferBarrier> buffer_barriers;
+                Vector<RHI::TextureBarrier> texture_barriers;
+                for(usize h : data.m_create_resources)
+                {
+                    auto& res = m_resource_data[h];
+                    cmdbuf->attach_device_object(res.m_resource);
+                    if (res.m_resource_desc.type == ResourceType::texture)
+                    {
+                        Ref<RHI::ITexture> tex = res.m_resource;
+                        texture_barriers.push_back({ tex, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, RHI::TextureStateFlag::automatic, RHI::TextureStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
+                    }
+                    else
+                    {
+                        Ref<RHI::IBuffer> buf = res.m_resource;
+                        buffer_barriers.push_back({ buf, RHI::BufferStateFlag::automatic, RHI::BufferStateFlag::none, RHI::ResourceBarrierFlag::aliasing });
+                    }
+                }
+                if (!buffer_barriers.empty() || !texture_barriers.empty()) cmdbuf->resource_barrier({ buffer_barriers.data(), buffer_barriers.size() }, {texture_barriers.data(), texture_barriers.size()});
+                ctx->m_current_pass = pass;
+                if (m_desc.passes[pass].name) cmdbuf->begin_event(m_desc.passes[pass].name.c_str());
+                luexp(data.m_render_pass->execute(ctx));
+                if (m_desc.passes[pass].name) cmdbuf->end_event();
+                for(auto& res : ctx->m_temporary_resources)
+                {
+                    release_transient_resource(*ctx->m_memory_pool, res);
+                }
+                ctx->m_temporary_resources.clear();
+                data.m_record_ticks = get_ticks() - begin_ticks;
+            }
+            lucatchret;
+            return ok;
+        }
+        RV RenderGraph::record_segment(RenderPassContext* ctx, usize segment)
+        {
+            lutry
+            {
+                for(usize i = m_segment_begins[segment]; i < m_segment_begins[segment + 1]; ++i)
+                {
+                    luexp(record_pass(ctx, m_enabled_passes[i]));
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        u32 RenderGraph::get_pass_queue(usize pass, u32 main_queue) const
+        {
+            switch (m_pass_data[pass].m_queue_type)
+            {
+            case RHI::CommandQueueType::compute:
+                return m_compute_queue != U32_MAX ? m_compute_queue : main_queue;
+            case RHI::CommandQueueType::copy:
+                // Compute queues can also execute copy commands.
+                if (m_copy_queue != U32_MAX) return m_copy_queue;
+                return m_compute_queue != U32_MAX ? m_compute_queue : main_queue;
+            default:
+                return main_queue;
+            }
+        }
+        void RenderGraph::split_segments(u32 main_queue)
+        {
+            usize num_passes = m_enabled_passes.size();
+            usize num_segments = min<usize>(max<u32>(m_max_recording_segments, 1), num_passes);
+            for (usize pass : m_enabled_passes) m_pass_data[pass].m_queue = get_pass_queue(pass, main_queue);
+            m_segment_begins.clear();
+            m_segment_begins.push_back(0);
+            // Every pass costs at least one tick, so that passes that are not recorded yet are distributed evenly.
+            u64 total_ticks = 0;
+            if (num_segments > 1)
+            {
+                for (usize pass : m_enabled_passes) total_ticks += max<u64>(m_pass_data[pass].m_record_ticks, 1);
+            }
+            u64 ticks = 0;
+            usize num_cuts = 1;
+            for (usize i = 0; i + 1 < num_passes; ++i)
+            {
+                bool cut = false;
+                if (num_cuts < num_segments)
+                {
+                    ticks += max<u64>(m_pass_data[m_enabled_passes[i]].m_record_ticks, 1);
+                    // Cuts the segment if it reaches its share of ticks, or if the remaining passes are just enough for
+                    // the remaining segments.
+                    if (ticks * num_segments >= total_ticks * num_cuts || num_passes - i - 1 == num_segments - num_cuts)
+                    {
+                        cut = true;
+                        ++num_cuts;
+                    }
+                }
+                // Passes on different queues are always recorded to different command buffers.
+                if (m_pass_data[m_enabled_passes[i]].m_queue != m_pass_data[m_enabled_passes[i + 1]].m_queue) cut = true;
+                if (cut) m_segment_begins.push_back(i + 1);
+            }
+            m_segment_begins.push_back(num_passes);
+        }
+        RV RenderGraph::build_submissions(u32 main_queue)
+        {
+            lutry
+            {
+                usize num_segments = m_segment_begins.size() - 1;
+                m_submissions.resize(num_segments);
+                for (usize i = 0; i < num_segments; ++i)
+                {
+                    auto& submission = m_submissions[i];
+                    submission.m_queue = m_pass_data[m_enabled_passes[m_segment_begins[i]]].m_queue;
+                    submission.m_wait_fences.clear();
+                    submission.m_signal_fences.clear();
+                }
+                usize num_fences = 0;
+                auto add_dependency = [&](usize src, usize dst)
+                {
+                    m_submissions[src].m_signal_fences.push_back(num_fences);
+                    m_submissions[dst].m_wait_fences.push_back(num_fences);
+                    ++num_fences;
+                };
+                // Tracks accesses of every resource by segments. Transient resources are tracked by their memory slots, 
+                // so that resources that alias the same memory are never accessed concurrently.
+                struct AccessData
+                {
+                    usize m_last_write = USIZE_MAX;
+                    Vector<usize> m_reads;
+                };
+                Vector<AccessData> accesses(m_resource_data.size() + m_transient_memory_slots.size());
+                auto get_access_key = [&](usize resource)
+                {
+                    usize slot = m_resource_data[resource].m_memory_slot;
+                    return slot == USIZE_MAX ? resource : m_resource_data.size() + slot;
+                };
+                Vector<usize> sources;
+                for (usize i = 0; i < num_segments; ++i)
+                {
+                    sources.clear();
+                    u32 queue = m_submissions[i].m_queue;
+                    auto add_source = [&](usize src)
+                    {
+                        if (src != USIZE_MAX && src != i && m_submissions[src].m_queue != queue) sources.push_back(src);
+                    };
+                    for (usize p = m_segment_begins[i]; p < m_segment_begins[i + 1]; ++p)
+                    {
+                        auto& pass = m_pass_data[m_enabled_passes[p]];
+                        for (auto& r : pass.m_input_resources)
+                        {
+                            add_source(accesses[get_access_key(r.second)].m_last_write);
+                        }
+                        for (auto& r : pass.m_output_resources)
+                        {
+                            auto& access = accesses[get_access_key(r.second)];
+                            add_source(access.m_last_write);
+                            for (usize src : access.m_reads) add_source(src);
+                        }
+                        // Creating transient resources overwrites memory of resources in the same slot.
+                        for (usize r : pass.m_create_resources)
+                        {
+                            auto& access = accesses[get_access_key(r)];
+                            add_source(access.m_last_write);
+                            for (usize src : access.m_reads) add_source(src);
                         }
                     }
-                    if (!buffer_barriers.empty() || !texture_barriers.empty()) cmdbuf->resource_barrier({ buffer_barriers.data(), buffer_barriers.size() }, {texture_barriers.data(), texture_barriers.size()});
-                    m_current_pass = i;
-                    if (m_desc.passes[i].name) cmdbuf->begin_event(m_desc.passes[i].name.c_str());
-                    luexp(m_pass_data[i].m_render_pass->execute(this));
-                    if (m_desc.passes[i].name) cmdbuf->end_event();
-                    for(auto& res : m_temporary_resources)
+                    // Only the last source segment of every queue needs to be waited, since segments on the same queue 
+                    // are executed in order.
+                    sort(sources.begin(), sources.end(), [&](usize a, usize b) { return a > b; });
+                    for (usize s = 0; s < sources.size(); ++s)
                     {
-                        release_transient_resource(res);
+                        bool waited = false;
+                        for (usize t = 0; t < s; ++t)
+                        {
+                            if (m_submissions[sources[t]].m_queue == m_submissions[sources[s]].m_queue)
+                            {
+                                waited = true;
+                                break;
+                            }
+                        }
+                        if (!waited) add_dependency(sources[s], i);
                     }
-                    m_temporary_resources.clear();
-                    // Release resources.
-                    for(usize h : data.m_release_resources)
+                    for (usize p = m_segment_begins[i]; p < m_segment_begins[i + 1]; ++p)
                     {
-                        auto& res = m_resource_data[h];
-                        release_transient_resource(res.m_resource);
+                        auto& pass = m_pass_data[m_enabled_passes[p]];
+                        for (auto& r : pass.m_input_resources)
+                        {
+                            auto& reads = accesses[get_access_key(r.second)].m_reads;
+                            if (reads.empty() || reads.back() != i) reads.push_back(i);
+                        }
+                        for (auto& r : pass.m_output_resources)
+                        {
+                            auto& access = accesses[get_access_key(r.second)];
+                            access.m_last_write = i;
+                            access.m_reads.clear();
+                        }
+                        for (usize r : pass.m_create_resources)
+                        {
+                            auto& access = accesses[get_access_key(r)];
+                            access.m_last_write = i;
+                            access.m_reads.clear();
+                        }
                     }
-                    ++m_current_time_query_index;
+                }
+                // The main queue must wait for the last segment of every other queue, so that commands submitted to the 
+                // main queue after this execution see results of all passes.
+                usize join = num_segments - 1;
+                if (m_submissions[join].m_queue != main_queue)
+                {
+                    join = num_segments;
+                    SubmissionData submission;
+                    submission.m_queue = main_queue;
+                    m_submissions.push_back(move(submission));
+                }
+                for (usize i = 0; i < num_segments; ++i)
+                {
+                    u32 queue = m_submissions[i].m_queue;
+                    if (queue == main_queue) continue;
+                    bool last = true;
+                    for (usize j = i + 1; j < num_segments; ++j)
+                    {
+                        if (m_submissions[j].m_queue == queue)
+                        {
+                            last = false;
+                            break;
+                        }
+                    }
+                    if (!last) continue;
+                    bool joined = false;
+                    for (usize j = i + 1; j < num_segments && !joined; ++j)
+                    {
+                        if (m_submissions[j].m_queue != main_queue) continue;
+                        for (usize f : m_submissions[j].m_wait_fences)
+                        {
+                            for (usize g : m_submissions[i].m_signal_fences)
+                            {
+                                if (f == g) joined = true;
+                            }
+                        }
+                    }
+                    if (!joined) add_dependency(i, join);
+                }
+                while (m_fences.size() < num_fences)
+                {
+                    lulet(fence, m_device->new_fence());
+                    m_fences.push_back(fence);
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RV RenderGraph::prepare_segment_command_buffers(RHI::ICommandBuffer* cmdbuf, Span<const u32> queues)
+        {
+            lutry
+            {
+                // Command buffers of segments are reused by every execution instead of being double buffered, so this waits 
+                // for segments submitted by the last execution on the CPU. This blocks only if the GPU is one whole execution 
+                // behind the CPU, and it keeps segments of the last execution from running concurrently with passes of this 
+                // execution on other queues, since both use the same transient memory.
+                for (auto& i : m_segment_cmdbufs)
+                {
+                    if (!i.m_cmdbuf) continue;
+                    // Command buffers submitted in the last execution must be finished before reset.
+                    if (i.m_submitted) i.m_cmdbuf->wait();
+                    if (i.m_recorded) luexp(i.m_cmdbuf->reset());
+                    i.m_recorded = false;
+                    i.m_submitted = false;
+                }
+                if (m_segment_cmdbufs.size() < queues.size()) m_segment_cmdbufs.resize(queues.size());
+                for (usize i = 0; i < queues.size(); ++i)
+                {
+                    auto& segment_cmdbuf = m_segment_cmdbufs[i];
+                    if (segment_cmdbuf.m_cmdbuf && segment_cmdbuf.m_cmdbuf->get_command_queue_index() != queues[i])
+                    {
+                        segment_cmdbuf.m_cmdbuf.reset();
+                    }
+                    if (!segment_cmdbuf.m_cmdbuf)
+                    {
+                        luset(segment_cmdbuf.m_cmdbuf, m_device->new_command_buffer(queues[i]));
+                    }
+                    segment_cmdbuf.m_recorded = true;
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+
+        struct RecordSegmentJob
+        {
+            RenderGraph* graph;
+            usize segment;
+
+            static void run(void* params)
+            {
+                RecordSegmentJob* job = (RecordSegmentJob*)params;
+                RenderPassContext* ctx = job->graph->m_contexts[job->segment];
+                ctx->m_result = job->graph->record_segment(ctx, job->segment);
+            }
+        };
+
+        struct RecordDispatchJob
+        {
+            RenderGraph* graph;
+
+            static void run(void* params)
+            {
+                RecordDispatchJob* job = (RecordDispatchJob*)params;
+                usize num_segments = job->graph->m_segment_begins.size() - 1;
+                for (usize i = 0; i < num_segments; ++i)
+                {
+                    // Segment jobs are attached to this job, so waiting for this job waits for all segments.
+                    RecordSegmentJob* segment_job = (RecordSegmentJob*)JobSystem::new_job(RecordSegmentJob::run, sizeof(RecordSegmentJob), alignof(RecordSegmentJob), params);
+                    segment_job->graph = job->graph;
+                    segment_job->segment = i;
+                    JobSystem::submit_job(segment_job);
+                }
+            }
+        };
+
+        RV RenderGraph::execute(RHI::ICommandBuffer* cmdbuf)
+        {
+            lutry
+            {
+                m_transient_memory.clear();
+                u32 main_queue = cmdbuf->get_command_queue_index();
+                split_segments(main_queue);
+                usize num_segments = m_segment_begins.size() - 1;
+                while (m_contexts.size() < num_segments)
+                {
+                    Ref<RenderPassContext> ctx = new_object<RenderPassContext>();
+                    ctx->m_graph = this;
+                    m_contexts.push_back(ctx);
+                }
+                if (num_segments == 1 && m_pass_data[m_enabled_passes[0]].m_queue == main_queue)
+                {
+                    // Records all passes on the current thread.
+                    RenderPassContext* ctx = m_contexts[0];
+                    ctx->m_cmdbuf = cmdbuf;
+                    ctx->m_memory_pool = &m_transient_memory;
+                    RV r = record_segment(ctx, 0);
+                    ctx->m_cmdbuf.reset();
+                    luexp(r);
+                    return ok;
+                }
+                luexp(build_submissions(main_queue));
+                // The last segment is recorded to `cmdbuf` if it does not need to wait for other queues.
+                auto& last_submission = m_submissions.back();
+                bool record_to_cmdbuf = m_submissions.size() == num_segments && last_submission.m_wait_fences.empty();
+                usize num_submissions = record_to_cmdbuf ? num_segments - 1 : m_submissions.size();
+                Vector<u32> queues(num_submissions);
+                for (usize i = 0; i < num_submissions; ++i) queues[i] = m_submissions[i].m_queue;
+                luexp(prepare_segment_command_buffers(cmdbuf, queues.cspan()));
+                // Temporary resources are allocated from memory pools of every segment, so that segments can be 
+                // recorded concurrently.
+                for (usize segment = 0; segment < num_segments; ++segment)
+                {
+                    RenderPassContext* ctx = m_contexts[segment];
+                    ctx->m_cmdbuf = segment < num_submissions ? m_segment_cmdbufs[segment].m_cmdbuf.get() : cmdbuf;
+                    ctx->m_segment_memory.clear();
+                    ctx->m_memory_pool = &ctx->m_segment_memory;
+                    ctx->m_result = ok;
+                }
+                if (num_segments == 1)
+                {
+                    m_contexts[0]->m_result = record_segment(m_contexts[0], 0);
+                }
+                else
+                {
+                    RecordDispatchJob* job = (RecordDispatchJob*)JobSystem::new_job(RecordDispatchJob::run, sizeof(RecordDispatchJob), alignof(RecordDispatchJob));
+                    job->graph = this;
+                    JobSystem::wait_job(JobSystem::submit_job(job));
+                }
+                for (usize segment = 0; segment < num_segments; ++segment)
+                {
+                    RenderPassContext* ctx = m_contexts[segment];
+                    ctx->m_cmdbuf.reset();
+                    ctx->m_segment_memory.clear();
+                    luexp(ctx->m_result);
+                }
+                // Submits segments in pass order. Resource states are resolved against the global resource states when 
+                // every command buffer is submitted, so barriers between segments are inserted by the submission. Segments 
+                // on different queues are synchronized by fences.
+                Vector<RHI::IFence*> wait_fences;
+                Vector<RHI::IFence*> signal_fences;
+                for (usize i = 0; i < num_submissions; ++i)
+                {
+                    auto& submission = m_submissions[i];
+                    wait_fences.clear();
+                    signal_fences.clear();
+                    for (usize f : submission.m_wait_fences) wait_fences.push_back(m_fences[f]);
+                    for (usize f : submission.m_signal_fences) signal_fences.push_back(m_fences[f]);
+                    auto& segment_cmdbuf = m_segment_cmdbufs[i];
+                    luexp(segment_cmdbuf.m_cmdbuf->submit({ wait_fences.data(), wait_fences.size() }, { signal_fences.data(), signal_fences.size() }, true));
+                    segment_cmdbuf.m_submitted = true;
                 }
             }
             lucatchret;
@@ -288,18 +1036,108 @@ namespace Luna
             lucatchret;
             return ok;
         }
-        R<Ref<RHI::IResource>> RenderGraph::allocate_temporary_resource(const ResourceDesc& desc)
+        RV RenderGraph::get_pass_time_ranges(Vector<RenderPassTimeRange>& ranges, f64* overlapped_time)
+        {
+            lutry
+            {
+                ranges.clear();
+                if (overlapped_time) *overlapped_time = 0.0;
+                if (!m_enable_time_profiling || !m_num_enabled_passes) return ok;
+                Vector<u64> times((usize)m_num_enabled_passes * 2);
+                luexp(m_time_query_heap->get_timestamp_values(0, m_num_enabled_passes * 2, times.data()));
+                // Queues with different timestamp frequencies use different clocks, whose timestamps cannot be compared.
+                // In such case, ranges of every queue are relative to the earliest pass of the queue, and the overlapped 
+                // time is not computed.
+                bool same_clock = true;
+                f64 first_frequency = 0.0;
+                for (usize i = 0; i < m_num_enabled_passes; ++i)
+                {
+                    usize pass = m_enabled_passes[i];
+                    RenderPassTimeRange range;
+                    range.pass = pass;
+                    range.command_queue = m_pass_data[pass].m_queue;
+                    lulet(frequency, m_device->get_command_queue_timestamp_frequency(range.command_queue));
+                    if (i == 0) first_frequency = frequency;
+                    else if (frequency != first_frequency) same_clock = false;
+                    range.begin = (f64)times[i * 2] / frequency;
+                    range.end = (f64)times[i * 2 + 1] / frequency;
+                    ranges.push_back(range);
+                }
+                HashMap<u32, f64> min_begins;
+                for (auto& range : ranges)
+                {
+                    u32 clock = same_clock ? 0 : range.command_queue;
+                    auto iter = min_begins.insert(make_pair(clock, range.begin)).first;
+                    iter->second = min(iter->second, range.begin);
+                }
+                for (auto& range : ranges)
+                {
+                    f64 min_begin = min_begins.find(same_clock ? 0 : range.command_queue)->second;
+                    range.begin -= min_begin;
+                    range.end -= min_begin;
+                }
+                if (overlapped_time && same_clock)
+                {
+                    // The overlapped time is the sum of pass times minus the length of the union of all ranges.
+                    Vector<RenderPassTimeRange> sorted = ranges;
+                    sort(sorted.begin(), sorted.end(), [](const RenderPassTimeRange& a, const RenderPassTimeRange& b) { return a.begin < b.begin; });
+                    f64 total_time = 0.0;
+                    f64 covered_time = 0.0;
+                    f64 end = 0.0;
+                    for (auto& range : sorted)
+                    {
+                        total_time += range.end - range.begin;
+                        if (range.end <= end) continue;
+                        covered_time += range.end - max(range.begin, end);
+                        end = range.end;
+                    }
+                    *overlapped_time = total_time - covered_time;
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RHI::IResource* RenderPassContext::get_input(const Name& name)
+        {
+            auto& data = m_graph->m_pass_data[m_current_pass];
+            auto iter = data.m_input_resources.find(name);
+            if(iter == data.m_input_resources.end()) return nullptr;
+            auto h = iter->second;
+            return m_graph->m_resource_data[h].m_resource;
+        }
+        RHI::IResource* RenderPassContext::get_output(const Name& name)
+        {
+            auto& data = m_graph->m_pass_data[m_current_pass];
+            auto iter = data.m_output_resources.find(name);
+            if(iter == data.m_output_resources.end()) return nullptr;
+            auto h = iter->second;
+            return m_graph->m_resource_data[h].m_resource;
+        }
+        RHI::IQueryHeap* RenderPassContext::get_timestamp_query_heap(u32* begin_index, u32* end_index)
+        {
+            if(m_graph->m_enable_time_profiling)
+            {
+                u32 query_index = m_graph->m_pass_data[m_current_pass].m_time_query_index;
+                if(begin_index) *begin_index = query_index * 2;
+                if(end_index) *end_index = query_index * 2 + 1;
+                return m_graph->m_time_query_heap;
+            }
+            if(begin_index) *begin_index = 0;
+            if(end_index) *end_index = 0;
+            return nullptr;
+        }
+        R<Ref<RHI::IResource>> RenderPassContext::allocate_temporary_resource(const ResourceDesc& desc)
         {
             Ref<RHI::IResource> ret;
             lutry
             {
-                luset(ret, allocate_transient_resource(desc));
+                luset(ret, m_graph->allocate_transient_resource(*m_memory_pool, desc));
                 m_temporary_resources.push_back(ret);
             }
             lucatchret;
             return ret;
         }
-        void RenderGraph::release_temporary_resource(RHI::IResource* res)
+        void RenderPassContext::release_temporary_resource(RHI::IResource* res)
         {
             for(auto iter = m_temporary_resources.begin(); iter != m_temporary_resources.end(); ++iter)
             {
@@ -13,7 +13,34 @@ namespace Luna
 {
     namespace RG
     {
-        struct RenderGraph : IRenderGraph, IRenderGraphCompiler, IRenderPassContext
+        struct RenderGraph;
+
+        //! The context used to record passes of one segment.
+        struct RenderPassContext : IRenderPassContext
+        {
+            lustruct("RG::RenderPassContext", "{3f4c2a1e-8b0d-4e57-9c6a-2d71b5e0f8a3}");
+            luiimpl();
+
+            RenderGraph* m_graph;
+            Ref<RHI::ICommandBuffer> m_cmdbuf;
+            usize m_current_pass;
+            Vector<Ref<RHI::IResource>> m_temporary_resources;
+            //! The memory pool to allocate temporary resources from. This points to the transient memory pool of the render
+            //! graph if only one segment is recorded, or to `m_segment_memory` if segments are recorded concurrently.
+            Vector<Ref<RHI::IDeviceMemory>>* m_memory_pool;
+            Vector<Ref<RHI::IDeviceMemory>> m_segment_memory;
+            //! The recording result of this segment.
+            RV m_result;
+
+            virtual RHI::ICommandBuffer* get_command_buffer() override { return m_cmdbuf; }
+            virtual RHI::IResource* get_input(const Name& name) override;
+            virtual RHI::IResource* get_output(const Name& name) override;
+            virtual RHI::IQueryHeap* get_timestamp_query_heap(u32* begin_index, u32* end_index) override;
+            virtual R<Ref<RHI::IResource>> allocate_temporary_resource(const ResourceDesc& desc) override;
+            virtual void release_temporary_resource(RHI::IResource* res) override;
+        };
+
+        struct RenderGraph : IRenderGraph, IRenderGraphCompiler
         {
             lustruct("RG::RenderGraph", "{feefd806-4b82-48cd-b350-f8fc9387fc65}");
             luiimpl();
@@ -26,16 +53,34 @@ namespace Luna
             {
                 HashMap<Name, usize> m_input_resources;
                 HashMap<Name, usize> m_output_resources;
-                // The indices of `m_transient_resources` that should be released when this node is finished.
+                // The transient resources that are first accessed by this pass.
                 Vector<usize> m_create_resources;
-                Vector<usize> m_release_resources;
                 Ref<IRenderPass> m_render_pass;
                 bool m_enabled = false;
+                // The index of the timestamp query of this pass.
+                u32 m_time_query_index = 0;
+                // The CPU ticks used to record this pass in the last execution, used to balance segments.
+                u64 m_record_ticks = 0;
+                // The type of the command queue this pass prefers.
+                RHI::CommandQueueType m_queue_type = RHI::CommandQueueType::graphics;
+                // The index of the command queue that executes this pass in the last execution.
+                u32 m_queue = 0;
+                // Resources connected to this pass and their descs before and after this pass is compiled, used to
+                // check whether this pass can be reused when the render graph is compiled again.
+                Vector<usize> m_compile_resources;
+                Vector<ResourceDesc> m_compile_input_descs;
+                Vector<ResourceDesc> m_compile_output_descs;
             };
             struct ResourceData
             {
                 ResourceDesc m_resource_desc;
                 Ref<RHI::IResource> m_resource;
+                // The index of the transient memory slot of this resource, or `USIZE_MAX` if this resource is not 
+                // placed in transient memory.
+                usize m_memory_slot = USIZE_MAX;
+                // The lifetime of this resource, or `USIZE_MAX` if this resource is not used.
+                usize m_first_access = USIZE_MAX;
+                usize m_last_access = USIZE_MAX;
             };
             Vector<PassData> m_pass_data;
             Vector<ResourceData> m_resource_data;
@@ -43,24 +88,88 @@ namespace Luna
 
             Ref<RHI::IQueryHeap> m_time_query_heap;
             u32 m_time_query_heap_capacity = 0;
-            u32 m_current_time_query_index = 0;
             u32 m_num_enabled_passes;
+            Vector<usize> m_enabled_passes;
+            u32 m_max_recording_segments;
+            // The dedicated compute and copy queues, or `U32_MAX` if the device does not have one.
+            u32 m_compute_queue;
+            u32 m_copy_queue;
 
             // Compile context.
             usize m_current_compile_pass;
 
             // Execution context.
-            Ref<RHI::ICommandBuffer> m_cmdbuf;
-            Vector<Ref<RHI::IResource>> m_temporary_resources;
-            usize m_current_pass;
+            struct SegmentCommandBuffer
+            {
+                Ref<RHI::ICommandBuffer> m_cmdbuf;
+                bool m_recorded = false;
+                bool m_submitted = false;
+            };
+            // One context per segment.
+            Vector<Ref<RenderPassContext>> m_contexts;
+            // Command buffers created by the render graph. The last segment is recorded to the command buffer 
+            // specified by the user if it does not need to be synchronized with other queues.
+            Vector<SegmentCommandBuffer> m_segment_cmdbufs;
+            // The first index in `m_enabled_passes` of every segment, plus one end index.
+            Vector<usize> m_segment_begins;
+            struct SubmissionData
+            {
+                u32 m_queue;
+                // Indices of fences in `m_fences` to wait before this submission.
+                Vector<usize> m_wait_fences;
+                // Indices of fences in `m_fences` to signal after this submission.
+                Vector<usize> m_signal_fences;
+            };
+            // One submission per segment, plus one optional empty submission on the main queue that waits for 
+            // the last submission of every other queue.
+            Vector<SubmissionData> m_submissions;
+            // Fences are binary, so every cross-queue dependency uses one fence.
+            Vector<Ref<RHI::IFence>> m_fences;
+
+            // Transient resources are placed in memory slots when the render graph is compiled. Resources in 
+            // the same slot have disjoint lifetimes, and share the memory of the slot.
+            struct TransientMemorySlot
+            {
+                RHI::MemoryType m_memory_type;
+                Ref<RHI::IDeviceMemory> m_memory;
+                Vector<usize> m_resources;
+            };
+            Vector<TransientMemorySlot> m_transient_memory_slots;
+            u64 m_transient_memory_size = 0;
+
+            // The data produced by compiling the render graph with one desc and config.
+            struct CompiledPlan
+            {
+                u64 m_hash;
+                RenderGraphDesc m_desc;
+                RenderGraphCompileConfig m_config;
+                Vector<PassData> m_pass_data;
+                Vector<ResourceData> m_resource_data;
+                Vector<usize> m_enabled_passes;
+                Vector<TransientMemorySlot> m_transient_memory_slots;
+                u64 m_transient_memory_size;
+            };
+            // Whether the render graph holds one compiled plan.
+            bool m_compiled = false;
+            u64 m_compiled_hash;
+            RenderGraphDesc m_compiled_desc;
+            RenderGraphCompileConfig m_compiled_config;
+            // Cached plans, ordered from the most recently used one.
+            Vector<CompiledPlan> m_cached_plans;
+            void store_compiled_plan(CompiledPlan& plan);
+            void load_compiled_plan(CompiledPlan& plan);
+            RV compile_plan(const RenderGraphCompileConfig& config, const CompiledPlan* prev);
+            bool can_reuse_pass(const CompiledPlan& prev, usize pass);
+            RV update_time_query_heap();
 
+            // The memory pool for temporary resources allocated by passes.
             Vector<Ref<RHI::IDeviceMemory>> m_transient_memory;
-            R<Ref<RHI::IResource>> allocate_transient_resource(const ResourceDesc& desc)
+            R<Ref<RHI::IResource>> allocate_transient_resource(Vector<Ref<RHI::IDeviceMemory>>& memory_pool, const ResourceDesc& desc)
             {
                 // Try to reuse one memory block.
                 Ref<RHI::IResource> ret;
-                auto iter = m_transient_memory.begin();
-                while (iter != m_transient_memory.end())
+                auto iter = memory_pool.begin();
+                while (iter != memory_pool.end())
                 {
                     if (desc.type == ResourceType::texture)
                     {
@@ -68,7 +177,7 @@ namespace Luna
                         if (succeeded(r))
                         {
                             ret = r.get();
-                            m_transient_memory.erase(iter);
+                            memory_pool.erase(iter);
                             break;
                         }
                     }
@@ -78,7 +187,7 @@ namespace Luna
                         if (succeeded(r))
                         {
                             ret = r.get();
-                            m_transient_memory.erase(iter);
+                            memory_pool.erase(iter);
                             break;
                         }
                     }
@@ -106,10 +215,18 @@ namespace Luna
                 }
                 return ret;
             }
-            void release_transient_resource(RHI::IResource* resource)
+            void release_transient_resource(Vector<Ref<RHI::IDeviceMemory>>& memory_pool, RHI::IResource* resource)
             {
-                m_transient_memory.push_back(resource->get_memory());
+                memory_pool.push_back(resource->get_memory());
             }
+            RV place_transient_resources(const CompiledPlan* prev);
+            RV record_pass(RenderPassContext* ctx, usize pass);
+            RV record_segment(RenderPassContext* ctx, usize segment);
+            u32 get_pass_queue(usize pass, u32 main_queue) const;
+            void split_segments(u32 main_queue);
+            RV build_submissions(u32 main_queue);
+            RV prepare_segment_command_buffers(RHI::ICommandBuffer* cmdbuf, Span<const u32> queues);
+
             virtual RHI::IDevice* get_device() override { return m_device.get(); }
             virtual const RenderGraphDesc& get_desc() override { return m_desc; }
             virtual void set_desc(const RenderGraphDesc& desc) override { m_desc = desc; }
@@ -136,6 +253,8 @@ namespace Luna
                 return nullptr;
             }
             virtual RV get_pass_time_intervals(Vector<u64>& pass_time_intervals) override;
+            virtual RV get_pass_time_ranges(Vector<RenderPassTimeRange>& ranges, f64* overlapped_time) override;
+            virtual u64 get_allocated_transient_memory_size() override { return m_transient_memory_size; }
 
             virtual usize get_input_resource(const Name& parameter) override
             {
@@ -166,38 +285,10 @@ namespace Luna
             {
                 m_pass_data[m_current_compile_pass].m_render_pass = render_pass;
             }
-
-            virtual RHI::ICommandBuffer* get_command_buffer() override { return m_cmdbuf; }
-            virtual RHI::IResource* get_input(const Name& name) override
+            virtual void set_command_queue_type(RHI::CommandQueueType type) override
             {
-                auto& data = m_pass_data[m_current_pass];
-                auto iter = data.m_input_resources.find(name);
-                if(iter == data.m_input_resources.end()) return nullptr;
-                auto h = iter->second;
-                return m_resource_data[h].m_resource;
+                m_pass_data[m_current_compile_pass].m_queue_type = type;
             }
-            virtual RHI::IResource* get_output(const Name& name) override
-            {
-                auto& data = m_pass_data[m_current_pass];
-                auto iter = data.m_output_resources.find(name);
-                if(iter == data.m_output_resources.end()) return nullptr;
-                auto h = iter->second;
-                return m_resource_data[h].m_resource;
-            }
-            virtual RHI::IQueryHeap* get_timestamp_query_heap(u32* begin_index, u32* end_index) override
-            {
-                if(m_enable_time_profiling)
-                {
-                    if(begin_index) *begin_index = m_current_time_query_index * 2;
-                    if(end_index) *end_index = m_current_time_query_index * 2 + 1;
-                    return m_time_query_heap;
-                }
-                if(begin_index) *begin_index = 0;
-                if(end_index) *end_index = 0;
-                return nullptr;
-            }
-            virtual R<Ref<RHI::IResource>> allocate_temporary_resource(const ResourceDesc& desc) override;
-            virtual void release_temporary_resource(RHI::IResource* res) override;
         };
     }
 }
@@ -49,8 +49,9 @@ namespace Luna
 			BufferDesc(const BufferDesc&) = default;
 			BufferDesc& operator=(const BufferDesc&) = default;
 			BufferDesc(BufferUsageFlag usages, u64 size, ResourceFlag flags = ResourceFlag::none) :
+				size(size),
 				usages(usages),
-				size(size) {}
+				flags(flags) {}
 		};
 
         struct IBuffer : virtual IResource
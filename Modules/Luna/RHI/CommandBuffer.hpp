@@ -366,6 +366,30 @@ namespace Luna
 				size(size),
 				format(format) {}
 		};
+		//! The layout of one indirect argument record consumed by `ICommandBuffer::draw_indirect`.
+		struct DrawIndirectArguments
+		{
+			u32 vertex_count_per_instance;
+			u32 instance_count;
+			u32 start_vertex_location;
+			u32 start_instance_location;
+		};
+		//! The layout of one indirect argument record consumed by `ICommandBuffer::draw_indexed_indirect`.
+		struct DrawIndexedIndirectArguments
+		{
+			u32 index_count_per_instance;
+			u32 instance_count;
+			u32 start_index_location;
+			i32 base_vertex_location;
+			u32 start_instance_location;
+		};
+		//! The layout of one indirect argument record consumed by `ICommandBuffer::dispatch_indirect`.
+		struct DispatchIndirectArguments
+		{
+			u32 thread_group_count_x;
+			u32 thread_group_count_y;
+			u32 thread_group_count_z;
+		};
 		//! @interface ICommandBuffer
 		//! The command buffer is used to allocate memory for commands, record commands, submitting 
 		//! commands to GPU and tracks the state of the submitted commands.
@@ -400,6 +424,23 @@ namespace Luna
 			//! will not be released before GPU finishes accessing them.
 			virtual void attach_device_object(IDeviceChild* obj) = 0;
 
+			//! Allocates one transient descriptor set and writes descriptors to it.
+			//! @param[in] desc The descriptor set desc. `DescriptorSetLayoutFlag::variable_descriptors` is not supported for 
+			//! transient descriptor sets.
+			//! @param[in] writes The descriptors to write to the descriptor set.
+			//! @return Returns the descriptor set. The descriptor set is owned by this command buffer and is valid until the next 
+			//! `reset` is called, so it should not be attached to the command buffer or be referred after `reset`. 
+			//! The descriptor set should not be updated by `IDescriptorSet::update_descriptors`.
+			//! @remark Transient descriptor sets are allocated from descriptor pools owned by the command buffer when supported 
+			//! by the backend, and all of them are released in bulk when the command buffer is reset, which is much cheaper than 
+			//! creating and releasing descriptor sets using `IDevice::new_descriptor_set` for descriptor sets that are used only 
+			//! once.
+			//! 
+			//! If one transient descriptor set with the same layout and the same descriptors is allocated since the last `reset`, 
+			//! that descriptor set is returned without allocating a new one. Descriptors are compared by the resource objects 
+			//! they refer to, so resources referred by transient descriptor sets must not be released before `reset` is called.
+			virtual R<IDescriptorSet*> allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes) = 0;
+
 			//! Begins a new event. This is for use in diagnostic tools like RenderDoc, PIX, etc to group commands into hierarchical
 			//! sections.
 			virtual void begin_event(const c8* event_name) = 0;
@@ -430,6 +471,8 @@ namespace Luna
 			//! * draw_indexed
 			//! * draw_instanced
 			//! * draw_indexed_instanced
+			//! * draw_indirect
+			//! * draw_indexed_indirect
 			//! * clear_color_attachment
 			//! * clear_depth_stencil_attachment
 			//! The following functions can only be called outside of one render pass range:
@@ -501,6 +544,36 @@ namespace Luna
 			//! Draws indexed, instanced primitives.
 			virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
 				i32 base_vertex_location, u32 start_instance_location) = 0;
+
+			//! Draws non-indexed, instanced primitives using arguments read from one buffer by the GPU.
+			//! @param[in] buffer The buffer that stores `DrawIndirectArguments` records. The buffer must be created with 
+			//! `BufferUsageFlag::indirect_buffer`, and must be in `BufferStateFlag::indirect_argument` state.
+			//! @param[in] offset The offset, in bytes, of the first argument record in `buffer`. This must be a multiple of 4.
+			//! @param[in] max_draw_count The maximum number of draws to perform. If `count_buffer` is `nullptr`, exactly 
+			//! `max_draw_count` draws are performed.
+			//! @param[in] stride The distance, in bytes, between two adjacent argument records. This must be a multiple of 4 
+			//! and not less than `sizeof(DrawIndirectArguments)`.
+			//! @param[in] count_buffer The optional buffer that stores the number of draws as one `u32` value. If this is not 
+			//! `nullptr`, the number of draws is the minimum of the stored value and `max_draw_count`. The buffer must be in 
+			//! `BufferStateFlag::indirect_argument` state. This can only be specified if `DeviceFeature::draw_indirect_count` 
+			//! is supported.
+			//! @param[in] count_buffer_offset The offset, in bytes, of the draw count in `count_buffer`. This must be a multiple of 4.
+			virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride = sizeof(DrawIndirectArguments),
+				IBuffer* count_buffer = nullptr, u64 count_buffer_offset = 0) = 0;
+
+			//! Draws indexed, instanced primitives using arguments read from one buffer by the GPU.
+			//! @param[in] buffer The buffer that stores `DrawIndexedIndirectArguments` records. The buffer must be created with 
+			//! `BufferUsageFlag::indirect_buffer`, and must be in `BufferStateFlag::indirect_argument` state.
+			//! @param[in] offset The offset, in bytes, of the first argument record in `buffer`. This must be a multiple of 4.
+			//! @param[in] max_draw_count The maximum number of draws to perform. If `count_buffer` is `nullptr`, exactly 
+			//! `max_draw_count` draws are performed.
+			//! @param[in] stride The distance, in bytes, between two adjacent argument records. This must be a multiple of 4 
+			//! and not less than `sizeof(DrawIndexedIndirectArguments)`.
+			//! @param[in] count_buffer The optional buffer that stores the number of draws as one `u32` value. See `draw_indirect` 
+			//! for details.
+			//! @param[in] count_buffer_offset The offset, in bytes, of the draw count in `count_buffer`. This must be a multiple of 4.
+			virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride = sizeof(DrawIndexedIndirectArguments),
+				IBuffer* count_buffer = nullptr, u64 count_buffer_offset = 0) = 0;
             
             virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) = 0;
 
@@ -516,6 +589,7 @@ namespace Luna
 			//! * set_compute_descriptor_set
 			//! * set_compute_descriptor_sets
 			//! * dispatch
+			//! * dispatch_indirect
 			virtual void begin_compute_pass(const ComputePassDesc& desc = ComputePassDesc()) = 0;
 
 			//! Sets the compute pipeline layout.
@@ -535,6 +609,12 @@ namespace Luna
 			//! Executes a command list from a thread group.
 			virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) = 0;
 
+			//! Dispatches thread groups using arguments read from one buffer by the GPU.
+			//! @param[in] buffer The buffer that stores one `DispatchIndirectArguments` record. The buffer must be created with 
+			//! `BufferUsageFlag::indirect_buffer`, and must be in `BufferStateFlag::indirect_argument` state.
+			//! @param[in] offset The offset, in bytes, of the argument record in `buffer`. This must be a multiple of 4.
+			virtual void dispatch_indirect(IBuffer* buffer, u64 offset) = 0;
+
 			//! Ends a compute pass.
 			virtual void end_compute_pass() = 0;
 
@@ -16,6 +16,7 @@
 #include "Fence.hpp"
 #include "QueryHeap.hpp"
 #include "Adapter.hpp"
+#include <Luna/Runtime/Blob.hpp>
 
 #ifndef LUNA_RHI_API
 #define LUNA_RHI_API
@@ -33,6 +34,8 @@ namespace Luna
 			pixel_shader_write,
 			//! The alignment requiremtn for the buffer data start location and size.
 			uniform_buffer_data_alignment,
+			//! Allow specifying count buffers in `ICommandBuffer::draw_indirect` and `ICommandBuffer::draw_indexed_indirect`.
+			draw_indirect_count,
 		};
 
 		struct DeviceFeatureData
@@ -42,6 +45,7 @@ namespace Luna
 				bool unbound_descriptor_array;
 				bool pixel_shader_write;
 				u32 uniform_buffer_data_alignment;
+				bool draw_indirect_count;
 			};
 		};
 
@@ -174,6 +178,21 @@ namespace Luna
 			//! @param[in] desc The swap chain description.
 			//! @return Returns the new created swap chain, or `nullptr` if failed to create.
 			virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) = 0;
+
+			//! Gets the data of the pipeline cache of this device. The pipeline cache stores compiled pipeline states, 
+			//! and its data can be saved to disk and passed to `merge_pipeline_cache_data` in later runs to reduce 
+			//! pipeline state creation time.
+			//! @return Returns the pipeline cache data, or one empty blob if pipeline caches are not supported by the backend.
+			virtual R<Blob> get_pipeline_cache_data() = 0;
+
+			//! Merges the pipeline cache data returned by `get_pipeline_cache_data` to the pipeline cache of this device.
+			//! @param[in] data The pipeline cache data.
+			//! @remark Pipeline cache data produced by another device, driver or driver version is ignored, so loading 
+			//! stale data is not an error. 
+			//! 
+			//! This should be called before creating pipeline states, and should not be called when pipeline states are
+			//! being created by other threads.
+			virtual RV merge_pipeline_cache_data(Span<const byte_t> data) = 0;
 		};
 
 		//! Creates one device using the specified adapter.
@@ -22,6 +22,9 @@ namespace Luna
 			d3d12,
 			vulkan,
 			metal,
+			//! The headless backend that runs without GPU. Resources are stored in system memory, and commands are 
+			//! validated and recorded, then executed on CPU when submitted. Shaders are not compiled or run.
+			null,
 		};
 
 		//! Gets the render backend type.
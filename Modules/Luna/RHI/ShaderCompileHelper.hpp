@@ -26,6 +26,8 @@ namespace Luna
 				return ShaderCompiler::TargetFormat::spir_v;
             case BackendType::metal:
                 return ShaderCompiler::TargetFormat::msl;
+            case BackendType::null:
+                return ShaderCompiler::TargetFormat::none;
 			}
 			lupanic();
 			return ShaderCompiler::TargetFormat::none;
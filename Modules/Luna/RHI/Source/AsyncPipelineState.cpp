@@ -0,0 +1,118 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncPipelineState.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "AsyncPipelineState.hpp"
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/String.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        void GraphicsPipelineStateJob::run(void* params)
+        {
+            GraphicsPipelineStateJob* job = (GraphicsPipelineStateJob*)params;
+            job->m_future->set_result(job->m_device->new_graphics_pipeline_state(job->m_desc));
+            job->~GraphicsPipelineStateJob();
+        }
+        void ComputePipelineStateJob::run(void* params)
+        {
+            ComputePipelineStateJob* job = (ComputePipelineStateJob*)params;
+            job->m_future->set_result(job->m_device->new_compute_pipeline_state(job->m_desc));
+            job->~ComputePipelineStateJob();
+        }
+        LUNA_RHI_API Ref<IPipelineStateFuture> new_graphics_pipeline_state_async(IDevice* device, const GraphicsPipelineStateDesc& desc)
+        {
+            Ref<PipelineStateFuture> future = new_object<PipelineStateFuture>();
+            GraphicsPipelineStateJob* job = (GraphicsPipelineStateJob*)JobSystem::new_job(GraphicsPipelineStateJob::run, 
+                sizeof(GraphicsPipelineStateJob), alignof(GraphicsPipelineStateJob));
+            new (job) GraphicsPipelineStateJob();
+            job->m_future = future;
+            job->m_device = device;
+            job->m_pipeline_layout = desc.pipeline_layout;
+            job->m_desc = desc;
+            // Copies all data referred by the desc, since the desc may be released when the job runs.
+            job->m_vs = Blob(desc.vs.data(), desc.vs.size());
+            job->m_ps = Blob(desc.ps.data(), desc.ps.size());
+            job->m_bindings.assign(desc.input_layout.bindings.begin(), desc.input_layout.bindings.end());
+            job->m_attributes.assign(desc.input_layout.attributes.begin(), desc.input_layout.attributes.end());
+            job->m_semantic_names.reserve(job->m_attributes.size());
+            for (auto& attr : job->m_attributes)
+            {
+                if (!attr.semantic_name) continue;
+                job->m_semantic_names.push_back(Name(attr.semantic_name));
+                attr.semantic_name = job->m_semantic_names.back().c_str();
+            }
+            job->m_desc.vs = job->m_vs.cspan();
+            job->m_desc.ps = job->m_ps.cspan();
+            job->m_desc.input_layout.bindings = Span<const InputBindingDesc>(job->m_bindings.data(), job->m_bindings.size());
+            job->m_desc.input_layout.attributes = Span<const InputAttributeDesc>(job->m_attributes.data(), job->m_attributes.size());
+            future->m_job = JobSystem::submit_job(job);
+            return future;
+        }
+        LUNA_RHI_API Ref<IPipelineStateFuture> new_compute_pipeline_state_async(IDevice* device, const ComputePipelineStateDesc& desc)
+        {
+            Ref<PipelineStateFuture> future = new_object<PipelineStateFuture>();
+            ComputePipelineStateJob* job = (ComputePipelineStateJob*)JobSystem::new_job(ComputePipelineStateJob::run, 
+                sizeof(ComputePipelineStateJob), alignof(ComputePipelineStateJob));
+            new (job) ComputePipelineStateJob();
+            job->m_future = future;
+            job->m_device = device;
+            job->m_pipeline_layout = desc.pipeline_layout;
+            job->m_desc = desc;
+            job->m_cs = Blob(desc.cs.data(), desc.cs.size());
+            job->m_desc.cs = job->m_cs.cspan();
+            future->m_job = JobSystem::submit_job(job);
+            return future;
+        }
+        LUNA_RHI_API RV load_pipeline_cache(IDevice* device, const c8* path)
+        {
+            lutry
+            {
+                auto f = open_file(path, FileOpenFlag::read, FileCreationMode::open_existing);
+                if (failed(f))
+                {
+                    if (f.errcode() == BasicError::not_found()) return ok;
+                    return f.errcode();
+                }
+                lulet(data, load_file_data(f.get()));
+                luexp(device->merge_pipeline_cache_data(data.cspan()));
+            }
+            lucatchret;
+            return ok;
+        }
+        LUNA_RHI_API RV save_pipeline_cache(IDevice* device, const c8* path)
+        {
+            lutry
+            {
+                lulet(data, device->get_pipeline_cache_data());
+                if (data.empty()) return ok;
+                // Writes to one temporary file first, so that the old file is kept if the process exits while writing.
+                String temp_path = path;
+                temp_path.append(".tmp");
+                {
+                    lulet(f, open_file(temp_path.c_str(), FileOpenFlag::write, FileCreationMode::create_always));
+                    auto r = f->write(data.data(), data.size());
+                    if (failed(r))
+                    {
+                        f.reset();
+                        // The write error is returned, and one temporary file that cannot be deleted is overwritten next time.
+                        auto _ = delete_file(temp_path.c_str());
+                        return r;
+                    }
+                }
+                luexp(move_file(temp_path.c_str(), path));
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
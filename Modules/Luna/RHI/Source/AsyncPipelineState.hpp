@@ -0,0 +1,93 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncPipelineState.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../Utility.hpp"
+#include "../Device.hpp"
+#include <Luna/Runtime/Blob.hpp>
+#include <Luna/Runtime/Name.hpp>
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/JobSystem/JobSystem.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct PipelineStateFuture : IPipelineStateFuture
+        {
+            lustruct("RHI::PipelineStateFuture", "{7b3e91c2-48d0-4a5f-9e16-c2a85f0d3b74}");
+            luiimpl();
+
+            JobSystem::job_id_t m_job = JobSystem::INVALID_JOB_ID;
+            // Written by the job, and read after the job is finished.
+            Ref<IPipelineState> m_pso;
+            Error m_error;
+
+            void set_result(R<Ref<IPipelineState>>&& result)
+            {
+                if (succeeded(result))
+                {
+                    m_pso = result.get();
+                }
+                else if (result.errcode() == BasicError::error_object())
+                {
+                    m_error = get_error();
+                }
+                else
+                {
+                    m_error.code = result.errcode();
+                }
+            }
+
+            virtual void wait() override
+            {
+                JobSystem::wait_job(m_job);
+            }
+            virtual bool try_wait() override
+            {
+                return JobSystem::is_job_finished(m_job);
+            }
+            virtual R<Ref<IPipelineState>> get() override
+            {
+                wait();
+                if (m_pso) return m_pso;
+                if (m_error.message.empty()) return m_error.code;
+                get_error() = m_error;
+                return BasicError::error_object();
+            }
+        };
+
+        //! Holds copies of all data referred by one graphics pipeline state desc.
+        struct GraphicsPipelineStateJob
+        {
+            Ref<PipelineStateFuture> m_future;
+            Ref<IDevice> m_device;
+            Ref<IPipelineLayout> m_pipeline_layout;
+            GraphicsPipelineStateDesc m_desc;
+            Blob m_vs;
+            Blob m_ps;
+            Vector<InputBindingDesc> m_bindings;
+            Vector<InputAttributeDesc> m_attributes;
+            Vector<Name> m_semantic_names;
+
+            static void run(void* params);
+        };
+
+        struct ComputePipelineStateJob
+        {
+            Ref<PipelineStateFuture> m_future;
+            Ref<IDevice> m_device;
+            Ref<IPipelineLayout> m_pipeline_layout;
+            ComputePipelineStateDesc m_desc;
+            Blob m_cs;
+
+            static void run(void* params);
+        };
+    }
+}
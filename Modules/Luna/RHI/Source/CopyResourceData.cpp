@@ -9,163 +9,430 @@
 */
 #include <Luna/Runtime/PlatformDefines.hpp>
 #define LUNA_RHI_API LUNA_EXPORT
-#include "../Utility.hpp"
-#include "../Device.hpp"
+#include "CopyResourceData.hpp"
+#include <Luna/Runtime/Log.hpp>
 
 namespace Luna
 {
     namespace RHI
     {
-        struct CopyBufferPlacementInfo
-		{
-			u64 offset;
-			u64 row_pitch;
-			u64 slice_pitch;
-			Format pixel_format;
-		};
-        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies)
+        //! Computes placements of copy data in staging buffers.
+        //! @param[out] max_alignment The maximum alignment required by all placements.
+        static void place_copies(IDevice* dev, Span<const CopyResourceData> copies, Vector<CopyBufferPlacementInfo>& placements,
+            u64& upload_buffer_size, u64& readback_buffer_size, u64& max_alignment)
+        {
+            upload_buffer_size = 0;
+            readback_buffer_size = 0;
+            max_alignment = 1;
+            placements.clear();
+            placements.reserve(copies.size());
+            for (auto& i : copies)
+            {
+                if (i.op == ResourceDataCopyOp::read_buffer)
+                {
+                    u64 offset = readback_buffer_size;
+                    placements.push_back({ offset, 0, 0, Format::unknown });
+                    readback_buffer_size += i.read_buffer_desc.copy_size;
+                }
+                else if (i.op == ResourceDataCopyOp::write_buffer)
+                {
+                    u64 offset = upload_buffer_size;
+                    placements.push_back({ offset, 0, 0, Format::unknown });
+                    upload_buffer_size += i.write_buffer_desc.copy_size;
+                }
+                else if (i.op == ResourceDataCopyOp::read_texture)
+                {
+                    u64 size, alignment, row_pitch, slice_pitch;
+                    auto desc = i.read_texture_desc.src->get_desc();
+                    dev->get_texture_data_placement_info(i.read_texture_desc.copy_width, i.read_texture_desc.copy_height, i.read_texture_desc.copy_depth,
+                        desc.format, &size, &alignment, &row_pitch, &slice_pitch);
+                    u64 offset = align_upper(readback_buffer_size, alignment);
+                    placements.push_back({ offset, row_pitch, slice_pitch, desc.format });
+                    readback_buffer_size = offset + size;
+                    max_alignment = max(max_alignment, alignment);
+                }
+                else if (i.op == ResourceDataCopyOp::write_texture)
+                {
+                    u64 size, alignment, row_pitch, slice_pitch;
+                    auto desc = i.write_texture_desc.dst->get_desc();
+                    dev->get_texture_data_placement_info(i.write_texture_desc.copy_width, i.write_texture_desc.copy_height, i.write_texture_desc.copy_depth,
+                        desc.format, &size, &alignment, &row_pitch, &slice_pitch);
+                    u64 offset = align_upper(upload_buffer_size, alignment);
+                    placements.push_back({ offset, row_pitch, slice_pitch, desc.format });
+                    upload_buffer_size = offset + size;
+                    max_alignment = max(max_alignment, alignment);
+                }
+            }
+        }
+        //! Fills data of write copies to the mapped upload buffer.
+        static void write_upload_data(u8* upload_data, Span<const CopyResourceData> copies, const Vector<CopyBufferPlacementInfo>& placements)
+        {
+            for (usize i = 0; i < copies.size(); ++i)
+            {
+                auto& copy = copies[i];
+                auto& placement = placements[i];
+                if (copy.op == ResourceDataCopyOp::write_buffer)
+                {
+                    memcpy(upload_data + (usize)placement.offset, copy.write_buffer_desc.src, copy.write_buffer_desc.copy_size);
+                }
+                else if (copy.op == ResourceDataCopyOp::write_texture)
+                {
+                    usize copy_size_per_row = bits_per_pixel(placement.pixel_format) * copy.write_texture_desc.copy_width / 8;
+                    memcpy_bitmap3d(upload_data + (usize)placement.offset, copy.write_texture_desc.src,
+                        copy_size_per_row, copy.write_texture_desc.copy_height, copy.write_texture_desc.copy_depth,
+                        (usize)placement.row_pitch, copy.write_texture_desc.src_row_pitch, (usize)placement.slice_pitch, copy.write_texture_desc.src_slice_pitch);
+                }
+            }
+        }
+        //! Records copy commands. Placements of upload and readback data are offsetted by `upload_offset` and `readback_offset`.
+        static void record_copies(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies, const Vector<CopyBufferPlacementInfo>& placements,
+            IBuffer* upload_buffer, u64 upload_offset, IBuffer* readback_buffer, u64 readback_offset)
         {
-            auto dev = command_buffer->get_device();
-			// Allocate one upload and one readback heap.
-			u64 upload_buffer_size = 0;
-			u64 readback_buffer_size = 0;
-			Vector<CopyBufferPlacementInfo> placements;
             Vector<BufferBarrier> buffer_barriers;
             Vector<TextureBarrier> texture_barriers;
-			placements.reserve(copies.size());
-			for (auto& i : copies)
-			{
-				if (i.op == ResourceDataCopyOp::read_buffer)
-				{
-					u64 offset = readback_buffer_size;
-					placements.push_back({ offset, 0, 0, Format::unknown });
-					readback_buffer_size += i.read_buffer_desc.copy_size;
-					buffer_barriers.emplace_back(i.read_buffer_desc.src, BufferStateFlag::automatic, BufferStateFlag::copy_source);
-				}
-				else if (i.op == ResourceDataCopyOp::write_buffer)
-				{
-					u64 offset = upload_buffer_size;
-					placements.push_back({ offset, 0, 0, Format::unknown });
-					upload_buffer_size += i.write_buffer_desc.copy_size;
-					buffer_barriers.emplace_back(i.write_buffer_desc.dst, BufferStateFlag::automatic, BufferStateFlag::copy_dest);
-				}
-				else if (i.op == ResourceDataCopyOp::read_texture)
-				{
-					u64 size, alignment, row_pitch, slice_pitch;
-					auto desc = i.read_texture_desc.src->get_desc();
-					dev->get_texture_data_placement_info(i.read_texture_desc.copy_width, i.read_texture_desc.copy_height, i.read_texture_desc.copy_depth,
-						desc.format, &size, &alignment, &row_pitch, &slice_pitch);
-					u64 offset = align_upper(readback_buffer_size, alignment);
-					placements.push_back({ offset, row_pitch, slice_pitch, desc.format });
-					readback_buffer_size = offset + size;
-					texture_barriers.emplace_back(i.read_texture_desc.src, i.read_texture_desc.src_subresource, TextureStateFlag::automatic, TextureStateFlag::copy_source);
-				}
-				else if (i.op == ResourceDataCopyOp::write_texture)
-				{
-					u64 size, alignment, row_pitch, slice_pitch;
-					auto desc = i.write_texture_desc.dst->get_desc();
-					dev->get_texture_data_placement_info(i.write_texture_desc.copy_width, i.write_texture_desc.copy_height, i.write_texture_desc.copy_depth,
-						desc.format, &size, &alignment, &row_pitch, &slice_pitch);
-					u64 offset = align_upper(upload_buffer_size, alignment);
-					placements.push_back({ offset, row_pitch, slice_pitch, desc.format });
-					upload_buffer_size = offset + size;
-					texture_barriers.emplace_back(i.write_texture_desc.dst, i.write_texture_desc.dst_subresource, TextureStateFlag::automatic, TextureStateFlag::copy_dest);
-				}
-			}
-			lutry
-			{
-				Ref<IBuffer> upload_buffer;
-				Ref<IBuffer> readback_buffer;
-				void* upload_data = nullptr;
-				void* readback_data = nullptr;
-				if (upload_buffer_size)
-				{
-					luset(upload_buffer, dev->new_buffer(MemoryType::upload, BufferDesc(BufferUsageFlag::copy_source, upload_buffer_size)));
-					luexp(upload_buffer->map(0, 0, &upload_data));
-					// Fill upload data.
-					for (usize i = 0; i < copies.size(); ++i)
-					{
-						auto& copy = copies[i];
-                        auto& placement = placements[i];
-						if (copy.op == ResourceDataCopyOp::write_buffer)
-						{
-							memcpy((u8*)upload_data + (usize)placement.offset, copy.write_buffer_desc.src, copy.write_buffer_desc.copy_size);
-						}
-						else if (copy.op == ResourceDataCopyOp::write_texture)
-						{
-							usize copy_size_per_row = bits_per_pixel(placement.pixel_format) * copy.write_texture_desc.copy_width / 8;
-							memcpy_bitmap3d((u8*)upload_data + (usize)placement.offset, copy.write_texture_desc.src,
-								copy_size_per_row, copy.write_texture_desc.copy_height, copy.write_texture_desc.copy_depth,
-								(usize)placement.row_pitch, copy.write_texture_desc.src_row_pitch, (usize)placement.slice_pitch, copy.write_texture_desc.src_slice_pitch);
-						}
-					}
-					upload_buffer->unmap(0, USIZE_MAX);
-				}
-				if (readback_buffer_size)
-				{
-					luset(readback_buffer, dev->new_buffer(MemoryType::readback, BufferDesc(BufferUsageFlag::copy_dest, readback_buffer_size)));
-				}
-				// Use GPU to copy data.
-				command_buffer->begin_copy_pass();
-                command_buffer->resource_barrier({buffer_barriers.data(), buffer_barriers.size()}, {texture_barriers.data(), texture_barriers.size()});
-				for (usize i = 0; i < copies.size(); ++i)
-				{
-					auto& copy = copies[i];
-                    auto& placement = placements[i];
-					if (copy.op == ResourceDataCopyOp::read_buffer)
-					{
-                        auto& desc = copy.read_buffer_desc;
-                        command_buffer->copy_buffer(readback_buffer, placement.offset, desc.src, desc.src_offset, desc.copy_size);
-					}
-					else if (copy.op == ResourceDataCopyOp::write_buffer)
-					{
-                        auto& desc = copy.write_buffer_desc;
-                        command_buffer->copy_buffer(desc.dst, desc.dst_offset, upload_buffer, placement.offset, desc.copy_size);
-					}
-					else if (copy.op == ResourceDataCopyOp::read_texture)
-					{
-                        auto& desc = copy.read_texture_desc;
-                        
-                        command_buffer->copy_texture_to_buffer(readback_buffer, placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch,
-                            desc.src, desc.src_subresource, desc.src_x, desc.src_y, desc.src_z, desc.copy_width, desc.copy_height, desc.copy_depth);
-					}
-					else if (copy.op == ResourceDataCopyOp::write_texture)
-					{
-                        auto& desc = copy.write_texture_desc;
-                        command_buffer->copy_buffer_to_texture(desc.dst, desc.dst_subresource, desc.dst_x, desc.dst_y, desc.dst_z, 
-                            upload_buffer, placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch, desc.copy_width, desc.copy_height, desc.copy_depth);
-					}
-				}
-				command_buffer->end_copy_pass();
-				// Submit copy command to GPU and wait for completion.
+            for (auto& i : copies)
+            {
+                if (i.op == ResourceDataCopyOp::read_buffer)
+                {
+                    buffer_barriers.emplace_back(i.read_buffer_desc.src, BufferStateFlag::automatic, BufferStateFlag::copy_source);
+                }
+                else if (i.op == ResourceDataCopyOp::write_buffer)
+                {
+                    buffer_barriers.emplace_back(i.write_buffer_desc.dst, BufferStateFlag::automatic, BufferStateFlag::copy_dest);
+                }
+                else if (i.op == ResourceDataCopyOp::read_texture)
+                {
+                    texture_barriers.emplace_back(i.read_texture_desc.src, i.read_texture_desc.src_subresource, TextureStateFlag::automatic, TextureStateFlag::copy_source);
+                }
+                else if (i.op == ResourceDataCopyOp::write_texture)
+                {
+                    texture_barriers.emplace_back(i.write_texture_desc.dst, i.write_texture_desc.dst_subresource, TextureStateFlag::automatic, TextureStateFlag::copy_dest);
+                }
+            }
+            command_buffer->begin_copy_pass();
+            command_buffer->resource_barrier({buffer_barriers.data(), buffer_barriers.size()}, {texture_barriers.data(), texture_barriers.size()});
+            for (usize i = 0; i < copies.size(); ++i)
+            {
+                auto& copy = copies[i];
+                auto& placement = placements[i];
+                if (copy.op == ResourceDataCopyOp::read_buffer)
+                {
+                    auto& desc = copy.read_buffer_desc;
+                    command_buffer->copy_buffer(readback_buffer, readback_offset + placement.offset, desc.src, desc.src_offset, desc.copy_size);
+                }
+                else if (copy.op == ResourceDataCopyOp::write_buffer)
+                {
+                    auto& desc = copy.write_buffer_desc;
+                    command_buffer->copy_buffer(desc.dst, desc.dst_offset, upload_buffer, upload_offset + placement.offset, desc.copy_size);
+                }
+                else if (copy.op == ResourceDataCopyOp::read_texture)
+                {
+                    auto& desc = copy.read_texture_desc;
+                    command_buffer->copy_texture_to_buffer(readback_buffer, readback_offset + placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch,
+                        desc.src, desc.src_subresource, desc.src_x, desc.src_y, desc.src_z, desc.copy_width, desc.copy_height, desc.copy_depth);
+                }
+                else if (copy.op == ResourceDataCopyOp::write_texture)
+                {
+                    auto& desc = copy.write_texture_desc;
+                    command_buffer->copy_buffer_to_texture(desc.dst, desc.dst_subresource, desc.dst_x, desc.dst_y, desc.dst_z, 
+                        upload_buffer, upload_offset + placement.offset, (u32)placement.row_pitch, (u32)placement.slice_pitch, desc.copy_width, desc.copy_height, desc.copy_depth);
+                }
+            }
+            command_buffer->end_copy_pass();
+        }
+        //! Copies data of one read copy from the mapped readback buffer to host memory.
+        static void read_readback_data(const u8* readback_data, const CopyResourceData& copy, const CopyBufferPlacementInfo& placement)
+        {
+            if (copy.op == ResourceDataCopyOp::read_buffer)
+            {
+                memcpy(copy.read_buffer_desc.dst, readback_data + (usize)placement.offset, copy.read_buffer_desc.copy_size);
+            }
+            else if (copy.op == ResourceDataCopyOp::read_texture)
+            {
+                usize copy_size_per_row = bits_per_pixel(placement.pixel_format) * copy.read_texture_desc.copy_width / 8;
+                memcpy_bitmap3d(copy.read_texture_desc.dst, readback_data + (usize)placement.offset,
+                    copy_size_per_row, copy.read_texture_desc.copy_height, copy.read_texture_desc.copy_depth,
+                    copy.read_texture_desc.dst_row_pitch, (usize)placement.row_pitch, copy.read_texture_desc.dst_slice_pitch, (usize)placement.slice_pitch);
+            }
+        }
+        LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies)
+        {
+            auto dev = command_buffer->get_device();
+            // Allocate one upload and one readback heap.
+            u64 upload_buffer_size;
+            u64 readback_buffer_size;
+            u64 max_alignment;
+            Vector<CopyBufferPlacementInfo> placements;
+            place_copies(dev, copies, placements, upload_buffer_size, readback_buffer_size, max_alignment);
+            lutry
+            {
+                Ref<IBuffer> upload_buffer;
+                Ref<IBuffer> readback_buffer;
+                void* upload_data = nullptr;
+                void* readback_data = nullptr;
+                if (upload_buffer_size)
+                {
+                    luset(upload_buffer, dev->new_buffer(MemoryType::upload, BufferDesc(BufferUsageFlag::copy_source, upload_buffer_size)));
+                    luexp(upload_buffer->map(0, 0, &upload_data));
+                    write_upload_data((u8*)upload_data, copies, placements);
+                    upload_buffer->unmap(0, USIZE_MAX);
+                }
+                if (readback_buffer_size)
+                {
+                    luset(readback_buffer, dev->new_buffer(MemoryType::readback, BufferDesc(BufferUsageFlag::copy_dest, readback_buffer_size)));
+                }
+                // Use GPU to copy data.
+                record_copies(command_buffer, copies, placements, upload_buffer, 0, readback_buffer, 0);
+                // Submit copy command to GPU and wait for completion.
                 luexp(command_buffer->submit({}, {}, true));
                 command_buffer->wait();
                 luexp(command_buffer->reset());
-				// Read data for read calls.
-				if (readback_buffer)
-				{
-					luexp(readback_buffer->map(0, USIZE_MAX, &readback_data));
-					for (usize i = 0; i < copies.size(); ++i)
-					{
-						auto& copy = copies[i];
-                        auto& placement = placements[i];
-						if (copy.op == ResourceDataCopyOp::read_buffer)
-						{
-							memcpy(copy.read_buffer_desc.dst, (u8*)readback_data + (usize)placement.offset, copy.read_buffer_desc.copy_size);
-						}
-						else if (copy.op == ResourceDataCopyOp::read_texture)
-						{
-							usize copy_size_per_row = bits_per_pixel(placement.pixel_format) * copy.read_texture_desc.copy_width / 8;
-							memcpy_bitmap3d(copy.read_texture_desc.dst, (u8*)readback_data + (usize)placement.offset,
-								copy_size_per_row, copy.read_texture_desc.copy_height, copy.read_texture_desc.copy_depth,
-								copy.read_texture_desc.dst_row_pitch, (usize)placement.row_pitch, copy.read_texture_desc.dst_slice_pitch, (usize)placement.slice_pitch);
-						}
-					}
-					readback_buffer->unmap(0, 0);
-				}
-			}
-			lucatchret;
-			return ok;
+                // Read data for read calls.
+                if (readback_buffer)
+                {
+                    luexp(readback_buffer->map(0, USIZE_MAX, &readback_data));
+                    for (usize i = 0; i < copies.size(); ++i)
+                    {
+                        read_readback_data((const u8*)readback_data, copies[i], placements[i]);
+                    }
+                    readback_buffer->unmap(0, 0);
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RV ResourceDataCopier::init(IDevice* device, u32 command_queue_index, u64 upload_buffer_size, u64 readback_buffer_size)
+        {
+            lutry
+            {
+                m_device = device;
+                m_command_queue_index = command_queue_index;
+                m_mtx = new_mutex();
+                // Rounds ring sizes up so that every placement alignment divides the ring size.
+                constexpr u64 RING_ALIGNMENT = 64 * 1024;
+                if (upload_buffer_size)
+                {
+                    m_upload_ring.m_size = align_upper(upload_buffer_size, RING_ALIGNMENT);
+                    luset(m_upload_ring.m_buffer, device->new_buffer(MemoryType::upload, BufferDesc(BufferUsageFlag::copy_source, m_upload_ring.m_size)));
+                    m_upload_ring.m_buffer->set_name("ResourceDataCopierUploadRing");
+                }
+                if (readback_buffer_size)
+                {
+                    m_readback_ring.m_size = align_upper(readback_buffer_size, RING_ALIGNMENT);
+                    luset(m_readback_ring.m_buffer, device->new_buffer(MemoryType::readback, BufferDesc(BufferUsageFlag::copy_dest, m_readback_ring.m_size)));
+                    m_readback_ring.m_buffer->set_name("ResourceDataCopierReadbackRing");
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RV ResourceDataCopier::open_batch()
+        {
+            if (get_recording_batch()) return ok;
+            lutry
+            {
+                CopyBatch batch;
+                if (!m_free_cmdbufs.empty())
+                {
+                    batch.m_cmdbuf = move(m_free_cmdbufs.back());
+                    m_free_cmdbufs.pop_back();
+                }
+                else
+                {
+                    luset(batch.m_cmdbuf, m_device->new_command_buffer(m_command_queue_index));
+                    batch.m_cmdbuf->set_name("ResourceDataCopier");
+                }
+                batch.m_ticket = m_next_ticket++;
+                m_batches.push_back(move(batch));
+            }
+            lucatchret;
+            return ok;
+        }
+        RV ResourceDataCopier::submit_batch()
+        {
+            CopyBatch* batch = get_recording_batch();
+            if (!batch || batch->m_empty) return ok;
+            lutry
+            {
+                batch->m_upload_end = m_upload_ring.m_head;
+                batch->m_readback_end = m_readback_ring.m_head;
+                luexp(batch->m_cmdbuf->submit({}, {}, true));
+                batch->m_submitted = true;
+            }
+            lucatchret;
+            return ok;
+        }
+        RV ResourceDataCopier::retire_batches(u64 wait_ticket)
+        {
+            lutry
+            {
+                while (!m_batches.empty())
+                {
+                    CopyBatch& batch = m_batches.front();
+                    if (!batch.m_submitted) break;
+                    // Batches that are being waited by other threads are retired by those threads, so that their 
+                    // command buffers are not reset during the wait.
+                    if (batch.m_num_waiters || !batch.m_cmdbuf->try_wait())
+                    {
+                        if (batch.m_ticket > wait_ticket) break;
+                        // Waits without holding the lock, so that other threads can record copies and poll tickets
+                        // during the wait.
+                        Ref<ICommandBuffer> cmdbuf = batch.m_cmdbuf;
+                        ++batch.m_num_waiters;
+                        m_mtx->unlock();
+                        cmdbuf->wait();
+                        m_mtx->wait();
+                        // `m_batches` may be reallocated by other threads during the wait, but batches with waiters 
+                        // are never retired, so the batch is still the front one.
+                        --m_batches.front().m_num_waiters;
+                        continue;
+                    }
+                    for (auto& read : batch.m_reads)
+                    {
+                        void* data = nullptr;
+                        luexp(read.m_buffer->map((usize)read.m_offset, (usize)(read.m_offset + read.m_size), &data));
+                        read_readback_data((const u8*)data + (usize)read.m_offset, read.m_copy, read.m_placement);
+                        read.m_buffer->unmap(0, 0);
+                    }
+                    luexp(batch.m_cmdbuf->reset());
+                    m_free_cmdbufs.push_back(move(batch.m_cmdbuf));
+                    // Tails may be moved forward when rings become empty, see `allocate_staging`.
+                    m_upload_ring.m_tail = max(m_upload_ring.m_tail, batch.m_upload_end);
+                    m_readback_ring.m_tail = max(m_readback_ring.m_tail, batch.m_readback_end);
+                    m_completed_ticket = batch.m_ticket;
+                    m_batches.pop_front();
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        RV ResourceDataCopier::allocate_staging(StagingRing& ring, MemoryType memory_type, BufferUsageFlag usages, u64 size, u64 alignment,
+            Ref<IBuffer>& buffer, u64& offset)
+        {
+            lutry
+            {
+                u64 pos = ring.find(size, alignment);
+                if (pos != U64_MAX)
+                {
+                    // One empty ring restarts from one buffer boundary, which frees the space before the boundary.
+                    if (ring.m_head == ring.m_tail) ring.m_tail = pos;
+                    ring.m_head = pos + size;
+                    buffer = ring.m_buffer;
+                    offset = pos % ring.m_size;
+                }
+                else
+                {
+                    // The data cannot fit in the ring, uses one temporary buffer that is kept alive by the command buffer.
+                    luset(buffer, m_device->new_buffer(memory_type, BufferDesc(usages, size)));
+                    get_recording_batch()->m_cmdbuf->attach_device_object(buffer);
+                    offset = 0;
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+        R<u64> ResourceDataCopier::copy_resource_data(Span<const CopyResourceData> copies)
+        {
+            MutexGuard guard(m_mtx);
+            u64 ticket;
+            lutry
+            {
+                u64 upload_size;
+                u64 readback_size;
+                u64 alignment;
+                Vector<CopyBufferPlacementInfo> placements;
+                place_copies(m_device, copies, placements, upload_size, readback_size, alignment);
+                // Frees ring space if the data can fit in one ring but the ring is occupied by unfinished batches.
+                while (true)
+                {
+                    bool upload_fits = !upload_size || upload_size > m_upload_ring.m_size || m_upload_ring.find(upload_size, alignment) != U64_MAX;
+                    bool readback_fits = !readback_size || readback_size > m_readback_ring.m_size || m_readback_ring.find(readback_size, alignment) != U64_MAX;
+                    if (upload_fits && readback_fits) break;
+                    CopyBatch* batch = get_recording_batch();
+                    if (batch && !batch->m_empty)
+                    {
+                        luexp(submit_batch());
+                    }
+                    if (m_batches.empty() || !m_batches.front().m_submitted) break;
+                    luexp(retire_batches(m_batches.front().m_ticket));
+                }
+                luexp(open_batch());
+                CopyBatch* batch = get_recording_batch();
+                Ref<IBuffer> upload_buffer;
+                Ref<IBuffer> readback_buffer;
+                u64 upload_offset = 0;
+                u64 readback_offset = 0;
+                if (upload_size)
+                {
+                    luexp(allocate_staging(m_upload_ring, MemoryType::upload, BufferUsageFlag::copy_source, upload_size, alignment, upload_buffer, upload_offset));
+                    void* upload_data = nullptr;
+                    luexp(upload_buffer->map(0, 0, &upload_data));
+                    write_upload_data((u8*)upload_data + (usize)upload_offset, copies, placements);
+                    upload_buffer->unmap((usize)upload_offset, (usize)(upload_offset + upload_size));
+                }
+                if (readback_size)
+                {
+                    luexp(allocate_staging(m_readback_ring, MemoryType::readback, BufferUsageFlag::copy_dest, readback_size, alignment, readback_buffer, readback_offset));
+                    for (usize i = 0; i < copies.size(); ++i)
+                    {
+                        if (copies[i].op != ResourceDataCopyOp::read_buffer && copies[i].op != ResourceDataCopyOp::read_texture) continue;
+                        PendingRead read;
+                        read.m_copy = copies[i];
+                        read.m_buffer = readback_buffer;
+                        read.m_offset = readback_offset;
+                        read.m_size = readback_size;
+                        read.m_placement = placements[i];
+                        batch->m_reads.push_back(move(read));
+                    }
+                }
+                record_copies(batch->m_cmdbuf, copies, placements, upload_buffer, upload_offset, readback_buffer, readback_offset);
+                batch->m_empty = false;
+                ticket = batch->m_ticket;
+            }
+            lucatchret;
+            return ticket;
+        }
+        RV ResourceDataCopier::flush()
+        {
+            MutexGuard guard(m_mtx);
+            return submit_batch();
+        }
+        bool ResourceDataCopier::is_completed(u64 ticket)
+        {
+            MutexGuard guard(m_mtx);
+            if (ticket > m_completed_ticket)
+            {
+                // Batches that fail to retire are kept, so the ticket is reported as not completed.
+                auto r = retire_batches(0);
+                if (failed(r)) log_error("RHI", "Failed to retire resource data copy batches: %s", explain(r.errcode()));
+            }
+            return ticket <= m_completed_ticket;
+        }
+        RV ResourceDataCopier::wait(u64 ticket)
+        {
+            MutexGuard guard(m_mtx);
+            lutry
+            {
+                if (ticket <= m_completed_ticket) return ok;
+                CopyBatch* batch = get_recording_batch();
+                if (batch && batch->m_ticket <= ticket)
+                {
+                    luexp(submit_batch());
+                }
+                luexp(retire_batches(ticket));
+            }
+            lucatchret;
+            return ok;
+        }
+        LUNA_RHI_API R<Ref<IResourceDataCopier>> new_resource_data_copier(IDevice* device, u32 command_queue_index, u64 upload_buffer_size, u64 readback_buffer_size)
+        {
+            Ref<ResourceDataCopier> ret = new_object<ResourceDataCopier>();
+            lutry
+            {
+                luexp(ret->init(device, command_queue_index, upload_buffer_size, readback_buffer_size));
+            }
+            lucatchret;
+            return Ref<IResourceDataCopier>(ret);
         }
     }
 }
@@ -0,0 +1,115 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CopyResourceData.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../Utility.hpp"
+#include "../Device.hpp"
+#include <Luna/Runtime/Mutex.hpp>
+#include <Luna/Runtime/RingDeque.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct CopyBufferPlacementInfo
+        {
+            u64 offset;
+            u64 row_pitch;
+            u64 slice_pitch;
+            Format pixel_format;
+        };
+
+        //! One staging buffer that is allocated as a ring.
+        struct StagingRing
+        {
+            Ref<IBuffer> m_buffer;
+            u64 m_size = 0;
+            // Positions increase monotonically, the offset in the buffer is `position % m_size`.
+            // Memory in [m_tail, m_head) is used by batches that are not finished.
+            u64 m_head = 0;
+            u64 m_tail = 0;
+
+            //! Finds the position to allocate one memory block without allocating it.
+            //! @return Returns the position, or `U64_MAX` if the ring does not have enough space.
+            u64 find(u64 size, u64 alignment) const
+            {
+                if (!m_buffer || size > m_size) return U64_MAX;
+                // Restarts from one buffer boundary if the ring is empty, so that the whole buffer is available.
+                u64 pos = m_head == m_tail ? align_upper(m_head, m_size) : align_upper(m_head, alignment);
+                // Blocks cannot wrap around the end of the buffer.
+                if (pos % m_size + size > m_size) pos = align_upper(pos, m_size);
+                if (pos + size - m_tail > m_size) return U64_MAX;
+                return pos;
+            }
+        };
+
+        struct ResourceDataCopier : IResourceDataCopier
+        {
+            lustruct("RHI::ResourceDataCopier", "{c8e0b9d4-2f6a-4c13-8e57-1b9a3d6f0e25}");
+            luiimpl();
+
+            struct PendingRead
+            {
+                CopyResourceData m_copy;
+                Ref<IBuffer> m_buffer;
+                // The offset of the copy data in `m_buffer`.
+                u64 m_offset;
+                u64 m_size;
+                CopyBufferPlacementInfo m_placement;
+            };
+            struct CopyBatch
+            {
+                u64 m_ticket;
+                Ref<ICommandBuffer> m_cmdbuf;
+                bool m_empty = true;
+                bool m_submitted = false;
+                // The number of threads that are waiting for the command buffer without holding the lock.
+                u32 m_num_waiters = 0;
+                // The ring head positions when the batch is submitted, which become ring tail positions when
+                // the batch is finished.
+                u64 m_upload_end = 0;
+                u64 m_readback_end = 0;
+                Vector<PendingRead> m_reads;
+            };
+
+            Ref<IDevice> m_device;
+            u32 m_command_queue_index;
+            Ref<IMutex> m_mtx;
+            StagingRing m_upload_ring;
+            StagingRing m_readback_ring;
+            // Batches that are not finished in submission order. The last batch may be the batch that is being recorded.
+            RingDeque<CopyBatch> m_batches;
+            Vector<Ref<ICommandBuffer>> m_free_cmdbufs;
+            u64 m_next_ticket = 1;
+            // All batches whose tickets are not greater than this are finished.
+            u64 m_completed_ticket = 0;
+
+            RV init(IDevice* device, u32 command_queue_index, u64 upload_buffer_size, u64 readback_buffer_size);
+            CopyBatch* get_recording_batch()
+            {
+                if (m_batches.empty() || m_batches.back().m_submitted) return nullptr;
+                return &m_batches.back();
+            }
+            RV open_batch();
+            RV submit_batch();
+            //! Retires finished batches in submission order. Batches whose tickets are not greater than `wait_ticket`
+            //! are waited. The lock is released during the wait, so states of the copier may change after this call.
+            RV retire_batches(u64 wait_ticket);
+            RV allocate_staging(StagingRing& ring, MemoryType memory_type, BufferUsageFlag usages, u64 size, u64 alignment,
+                Ref<IBuffer>& buffer, u64& offset);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual u32 get_command_queue_index() override { return m_command_queue_index; }
+            virtual R<u64> copy_resource_data(Span<const CopyResourceData> copies) override;
+            virtual RV flush() override;
+            virtual bool is_completed(u64 ticket) override;
+            virtual RV wait(u64 ticket) override;
+        };
+    }
+}
@@ -271,6 +271,8 @@ namespace Luna
 			if (FAILED(hr)) return encode_hresult(hr);
 			m_tracking_system.reset();
 			m_objs.clear();
+			m_transient_desc_set_cache.clear();
+			m_transient_desc_sets.clear();
 			m_vbs.clear();
 			m_ib.reset();
 			m_heap_set = false;
@@ -278,6 +280,26 @@ namespace Luna
 			m_compute_pipeline_layout.reset();
 			return ok;
 		}
+		R<IDescriptorSet*> CommandBuffer::allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes)
+		{
+			lutsassert();
+			IDescriptorSet* ret = nullptr;
+			lutry
+			{
+				u64 hash = m_transient_desc_set_cache.encode_key(desc.layout, writes);
+				ret = m_transient_desc_set_cache.find(hash);
+				if (ret) return ret;
+				// Descriptor sets are sub-allocated from the global shader-visible heaps, so they are created normally and 
+				// kept alive until the command buffer is reset.
+				lulet(set, m_device->new_descriptor_set(desc));
+				luexp(set->update_descriptors(writes));
+				ret = set;
+				m_transient_desc_sets.push_back(move(set));
+				m_transient_desc_set_cache.insert(hash, ret);
+			}
+			lucatchret;
+			return ret;
+		}
 		void CommandBuffer::begin_render_pass(const RenderPassDesc& desc)
 		{
 			lutsassert();
@@ -578,6 +600,34 @@ namespace Luna
 			assert_graphcis_context();
 			m_li->DrawInstanced(vertex_count_per_instance, instance_count, start_vertex_location, start_instance_location);
 		}
+		void CommandBuffer::execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE type, IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+			IBuffer* count_buffer, u64 count_buffer_offset)
+		{
+			auto signature = m_device->get_command_signature(type, stride);
+			if (failed(signature))
+			{
+				// This only fails if the device is out of memory.
+				lupanic_msg("Failed to create command signature for indirect commands.");
+				return;
+			}
+			BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+			ID3D12Resource* c = count_buffer ? cast_object<BufferResource>(count_buffer->get_object())->m_res.Get() : nullptr;
+			m_li->ExecuteIndirect(signature.get(), max_draw_count, b->m_res.Get(), offset, c, count_buffer_offset);
+		}
+		void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+			IBuffer* count_buffer, u64 count_buffer_offset)
+		{
+			lutsassert();
+			assert_graphcis_context();
+			execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, buffer, offset, max_draw_count, stride, count_buffer, count_buffer_offset);
+		}
+		void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+			IBuffer* count_buffer, u64 count_buffer_offset)
+		{
+			lutsassert();
+			assert_graphcis_context();
+			execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, buffer, offset, max_draw_count, stride, count_buffer, count_buffer_offset);
+		}
 		void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
 		{
 			lutsassert();
@@ -767,6 +817,12 @@ namespace Luna
 			assert_compute_context();
 			m_li->Dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 		}
+		void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+		{
+			lutsassert();
+			assert_compute_context();
+			execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, buffer, offset, 1, sizeof(DispatchIndirectArguments), nullptr, 0);
+		}
 		void CommandBuffer::end_compute_pass()
 		{
 			lutsassert();
@@ -15,6 +15,7 @@
 #include "DescriptorSet.hpp"
 #include "PipelineState.hpp"
 #include "PipelineLayout.hpp"
+#include "../DescriptorSetCache.hpp"
 
 namespace Luna
 {
@@ -165,6 +166,10 @@ namespace Luna
 			//! The attached graphic objects.
 			Vector<Ref<IDeviceChild>> m_objs;
 
+			//! Transient descriptor sets allocated since the last reset.
+			Vector<Ref<IDescriptorSet>> m_transient_desc_sets;
+			TransientDescriptorSetCache m_transient_desc_set_cache;
+
 			bool m_compute_pass_begin = false;
 			bool m_copy_pass_begin = false;
 
@@ -240,6 +245,7 @@ namespace Luna
 			{
 				m_objs.push_back(obj);
 			}
+			virtual R<IDescriptorSet*> allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes) override;
 			virtual void begin_event(const c8* event_name) override
 			{
 				usize len = utf8_to_utf16_len(event_name);
@@ -285,6 +291,12 @@ namespace Luna
 				i32 base_vertex_location, u32 start_instance_location) override;
 			virtual void draw_instanced(u32 vertex_count_per_instance, u32 instance_count, u32 start_vertex_location,
 				u32 start_instance_location) override;
+			virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
+			virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
+			void execute_indirect(D3D12_INDIRECT_ARGUMENT_TYPE type, IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset);
 			virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
 			virtual void end_occlusion_query(u32 index) override;
 			virtual void end_render_pass() override;
@@ -297,6 +309,7 @@ namespace Luna
 			}
 			virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
 			virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+			virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
 			virtual void end_compute_pass() override;
 			virtual void begin_copy_pass(const CopyPassDesc& desc) override;
 			virtual void copy_resource(IResource* dst, IResource* src) override;
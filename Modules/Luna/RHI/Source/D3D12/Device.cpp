@@ -189,6 +189,7 @@ namespace Luna
 			{
 				m_adapter = adapter;
 				luexp(encode_hresult(::D3D12CreateDevice(adapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&m_device))));
+				m_command_signatures_mtx = new_mutex();
 				D3D12MA::ALLOCATOR_DESC allocator_desc{};
 				allocator_desc.pDevice = m_device.Get();
 				allocator_desc.pAdapter = adapter;
@@ -243,6 +244,27 @@ namespace Luna
 			lucatchret;
 			return ok;
 		}
+		R<ID3D12CommandSignature*> Device::get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE type, u32 stride)
+		{
+			u64 key = ((u64)type << 32) | (u64)stride;
+			MutexGuard guard(m_command_signatures_mtx);
+			auto iter = m_command_signatures.find(key);
+			if (iter != m_command_signatures.end()) return iter->second.Get();
+			D3D12_INDIRECT_ARGUMENT_DESC arg{};
+			arg.Type = type;
+			D3D12_COMMAND_SIGNATURE_DESC desc{};
+			desc.ByteStride = stride;
+			desc.NumArgumentDescs = 1;
+			desc.pArgumentDescs = &arg;
+			desc.NodeMask = 0;
+			ComPtr<ID3D12CommandSignature> signature;
+			// The root signature is not required if the signature only changes draw or dispatch arguments.
+			HRESULT hr = m_device->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(&signature));
+			if (FAILED(hr)) return encode_hresult(hr).errcode();
+			ID3D12CommandSignature* ret = signature.Get();
+			m_command_signatures.insert(make_pair(key, move(signature)));
+			return ret;
+		}
 		DeviceFeatureData Device::check_feature(DeviceFeature feature)
 		{
 			DeviceFeatureData ret;
@@ -257,6 +279,9 @@ namespace Luna
 			case DeviceFeature::uniform_buffer_data_alignment:
 				ret.uniform_buffer_data_alignment = 256;
 				break;
+			case DeviceFeature::draw_indirect_count:
+				ret.draw_indirect_count = true;
+				break;
 			default: lupanic();
 			}
 			return ret;
@@ -17,6 +17,7 @@
 #include <Luna/Runtime/List.hpp>
 #include <Luna/Runtime/SpinLock.hpp>
 #include <Luna/Runtime/UniquePtr.hpp>
+#include <Luna/Runtime/HashMap.hpp>
 
 namespace Luna
 {
@@ -101,10 +102,16 @@ namespace Luna
 			// Memory Allocator.
 			ComPtr<D3D12MA::Allocator> m_allocator;
 
+			// Command signatures used by indirect commands, keyed by argument type and stride.
+			HashMap<u64, ComPtr<ID3D12CommandSignature>> m_command_signatures;
+			Ref<IMutex> m_command_signatures_mtx;
+
 			~Device();
 
 			R<UniquePtr<CommandQueue>> new_command_queue(const CommandQueueDesc& desc);
 			RV init(IDXGIAdapter* adapter);
+			//! Gets the command signature for indirect commands. The signature is created on the first use.
+			R<ID3D12CommandSignature*> get_command_signature(D3D12_INDIRECT_ARGUMENT_TYPE type, u32 stride);
 			
 			virtual DeviceFeatureData check_feature(DeviceFeature feature) override;
 			virtual void get_texture_data_placement_info(u32 width, u32 height, u32 depth, Format format,
@@ -127,6 +134,8 @@ namespace Luna
 			virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
 			virtual R<Ref<IFence>> new_fence() override;
 			virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+			virtual R<Blob> get_pipeline_cache_data() override { return Blob(); }
+			virtual RV merge_pipeline_cache_data(Span<const byte_t> data) override { return ok; }
 		};
 	}
 }
\ No newline at end of file
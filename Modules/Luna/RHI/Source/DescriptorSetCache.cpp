@@ -0,0 +1,79 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorSetCache.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "DescriptorSetCache.hpp"
+#include <Luna/Runtime/Hash.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        inline u64 pack_u32(u32 low, u32 high)
+        {
+            return (u64)low | ((u64)high << 32);
+        }
+        inline u32 f32_bits(f32 v)
+        {
+            u32 r;
+            memcpy(&r, &v, sizeof(u32));
+            return r;
+        }
+        u64 TransientDescriptorSetCache::encode_key(IDescriptorSetLayout* layout, Span<const WriteDescriptorSet> writes)
+        {
+            // Every field is encoded explicitly, since descriptor structures may contain uninitialized padding bytes.
+            m_key.clear();
+            m_key.push_back((u64)(usize)layout);
+            for (auto& write : writes)
+            {
+                m_key.push_back(pack_u32(write.binding_slot, write.first_array_index));
+                m_key.push_back(pack_u32(write.num_descs, (u32)write.type));
+                for (u32 i = 0; i < write.num_descs; ++i)
+                {
+                    switch (write.type)
+                    {
+                    case DescriptorType::uniform_buffer_view:
+                    case DescriptorType::read_buffer_view:
+                    case DescriptorType::read_write_buffer_view:
+                    {
+                        auto& view = write.buffer_views[i];
+                        m_key.push_back((u64)(usize)view.buffer);
+                        m_key.push_back(view.first_element);
+                        m_key.push_back(pack_u32(view.element_count, view.element_size));
+                    }
+                    break;
+                    case DescriptorType::read_texture_view:
+                    case DescriptorType::read_write_texture_view:
+                    {
+                        auto& view = write.texture_views[i];
+                        m_key.push_back((u64)(usize)view.texture);
+                        m_key.push_back(pack_u32((u32)view.type, (u32)view.format));
+                        m_key.push_back(pack_u32(view.mip_slice, view.mip_size));
+                        m_key.push_back(pack_u32(view.array_slice, view.array_size));
+                    }
+                    break;
+                    case DescriptorType::sampler:
+                    {
+                        auto& s = write.samplers[i];
+                        m_key.push_back(pack_u32(
+                            (u32)s.min_filter | ((u32)s.mag_filter << 8) | ((u32)s.mip_filter << 16) | ((u32)s.address_u << 24),
+                            (u32)s.address_v | ((u32)s.address_w << 8) | ((u32)s.anisotropy_enable << 16) | ((u32)s.compare_enable << 24)));
+                        m_key.push_back(pack_u32((u32)s.compare_function | ((u32)s.border_color << 8), s.max_anisotropy));
+                        m_key.push_back(pack_u32(f32_bits(s.min_lod), f32_bits(s.max_lod)));
+                    }
+                    break;
+                    default: lupanic(); break;
+                    }
+                }
+            }
+            return memhash64(m_key.data(), m_key.size() * sizeof(u64));
+        }
+    }
+}
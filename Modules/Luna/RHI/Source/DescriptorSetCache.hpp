@@ -0,0 +1,73 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DescriptorSetCache.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../DescriptorSet.hpp"
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/Vector.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Caches transient descriptor sets allocated by one command buffer by their layouts and descriptors, so that 
+        //! allocating descriptor sets with identical contents returns the same set.
+        //! @details Descriptors are identified by the addresses of resources they refer to, so the cache must be cleared 
+        //! before resources used by cached sets can be released, which is ensured by clearing the cache when the command 
+        //! buffer is reset.
+        struct TransientDescriptorSetCache
+        {
+            struct Entry
+            {
+                Vector<u64> m_key;
+                IDescriptorSet* m_set;
+            };
+            HashMap<u64, Entry> m_entries;
+            // The key encoded by the last `encode_key` call.
+            Vector<u64> m_key;
+
+            //! Encodes the key of the descriptor set to `m_key`.
+            //! @return Returns the hash of the key.
+            u64 encode_key(IDescriptorSetLayout* layout, Span<const WriteDescriptorSet> writes);
+
+            //! Finds the descriptor set whose key equals to `m_key`.
+            IDescriptorSet* find(u64 hash) const
+            {
+                auto iter = m_entries.find(hash);
+                if (iter == m_entries.end()) return nullptr;
+                auto& key = iter->second.m_key;
+                if (key.size() != m_key.size() || memcmp(key.data(), m_key.data(), m_key.size() * sizeof(u64))) return nullptr;
+                return iter->second.m_set;
+            }
+
+            //! Adds the descriptor set with key `m_key` to the cache. Hash collisions replace the old entry.
+            void insert(u64 hash, IDescriptorSet* set)
+            {
+                auto iter = m_entries.find(hash);
+                if (iter == m_entries.end())
+                {
+                    Entry entry;
+                    entry.m_key = m_key;
+                    entry.m_set = set;
+                    m_entries.insert(make_pair(hash, move(entry)));
+                }
+                else
+                {
+                    iter->second.m_key = m_key;
+                    iter->second.m_set = set;
+                }
+            }
+
+            void clear()
+            {
+                m_entries.clear();
+            }
+        };
+    }
+}
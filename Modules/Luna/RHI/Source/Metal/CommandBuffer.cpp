@@ -40,6 +40,8 @@ namespace Luna
         {
             AutoreleasePool pool;
             m_objs.clear();
+            m_transient_desc_set_cache.clear();
+            m_transient_desc_sets.clear();
             m_buffer = retain(m_device->m_queues[m_command_queue_index].queue->commandBuffer());
             if(!m_buffer) return BasicError::bad_platform_call();
             return ok;
@@ -48,6 +50,25 @@ namespace Luna
         {
             m_objs.push_back(obj);
         }
+        R<IDescriptorSet*> CommandBuffer::allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes)
+        {
+            IDescriptorSet* ret = nullptr;
+            lutry
+            {
+                u64 hash = m_transient_desc_set_cache.encode_key(desc.layout, writes);
+                ret = m_transient_desc_set_cache.find(hash);
+                if(ret) return ret;
+                // Metal descriptor sets are argument buffers, which are created normally and kept alive until the 
+                // command buffer is reset.
+                lulet(set, m_device->new_descriptor_set(desc));
+                luexp(set->update_descriptors(writes));
+                ret = set;
+                m_transient_desc_sets.push_back(move(set));
+                m_transient_desc_set_cache.insert(hash, ret);
+            }
+            lucatchret;
+            return ret;
+        }
         void CommandBuffer::begin_event(const c8* event_name)
         {
             AutoreleasePool pool;
@@ -373,6 +394,32 @@ namespace Luna
             m_render->drawIndexedPrimitives(m_primitive_type, (NS::UInteger)index_count_per_instance, type, 
                 buffer->m_buffer.get(), (NS::UInteger)start_index_location, instance_count, (NS::Integer)base_vertex_location, start_instance_location);
         }
+        void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset)
+        {
+            assert_graphcis_context();
+            lucheck_msg(!count_buffer, "DeviceFeature::draw_indirect_count is not supported.");
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            // Metal does not support multi-draw, so every argument record is drawn separately.
+            for(u32 i = 0; i < max_draw_count; ++i)
+            {
+                m_render->drawPrimitives(m_primitive_type, b->m_buffer.get(), (NS::UInteger)(offset + (u64)i * stride));
+            }
+        }
+        void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset)
+        {
+            assert_graphcis_context();
+            lucheck_msg(!count_buffer, "DeviceFeature::draw_indirect_count is not supported.");
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            Buffer* index_buffer = cast_object<Buffer>(m_index_buffer_view.buffer->get_object());
+            MTL::IndexType type = encode_index_type(m_index_buffer_view.format);
+            for(u32 i = 0; i < max_draw_count; ++i)
+            {
+                m_render->drawIndexedPrimitives(m_primitive_type, type, index_buffer->m_buffer.get(), (NS::UInteger)m_index_buffer_view.offset,
+                    b->m_buffer.get(), (NS::UInteger)(offset + (u64)i * stride));
+            }
+        }
         void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
         {
             assert_graphcis_context();
@@ -535,6 +582,13 @@ namespace Luna
             m_compute->dispatchThreadgroups(MTL::Size::Make(thread_group_count_x, thread_group_count_y, thread_group_count_z), 
                 MTL::Size::Make(m_num_threads_per_group.x, m_num_threads_per_group.y, m_num_threads_per_group.z));
         }
+        void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+        {
+            assert_compute_context();
+            Buffer* b = cast_object<Buffer>(buffer->get_object());
+            m_compute->dispatchThreadgroups(b->m_buffer.get(), (NS::UInteger)offset, 
+                MTL::Size::Make(m_num_threads_per_group.x, m_num_threads_per_group.y, m_num_threads_per_group.z));
+        }
         void CommandBuffer::end_compute_pass()
         {
             assert_compute_context();
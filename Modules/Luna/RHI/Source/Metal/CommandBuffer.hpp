@@ -10,6 +10,7 @@
 #pragma once
 #include "Device.hpp"
 #include "QueryHeap.hpp"
+#include "../DescriptorSetCache.hpp"
 
 namespace Luna
 {
@@ -27,6 +28,10 @@ namespace Luna
             // The attached graphic objects.
 			Vector<Ref<IDeviceChild>> m_objs;
 
+            // Transient descriptor sets allocated since the last reset.
+            Vector<Ref<IDescriptorSet>> m_transient_desc_sets;
+            TransientDescriptorSetCache m_transient_desc_set_cache;
+
             NSPtr<MTL::RenderCommandEncoder> m_render;
             NSPtr<MTL::ComputeCommandEncoder> m_compute;
             NSPtr<MTL::BlitCommandEncoder> m_blit;
@@ -74,6 +79,7 @@ namespace Luna
 			virtual u32 get_command_queue_index() override { return m_command_queue_index; }
             virtual RV reset() override;
 			virtual void attach_device_object(IDeviceChild* obj) override;
+            virtual R<IDescriptorSet*> allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes) override;
 			virtual void begin_event(const c8* event_name) override;
 			virtual void end_event() override;
             virtual void begin_render_pass(const RenderPassDesc& desc) override;
@@ -95,6 +101,10 @@ namespace Luna
 				u32 start_instance_location) override;
 			virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
 				i32 base_vertex_location, u32 start_instance_location) override;
+			virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
+			virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
             virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
             virtual void end_occlusion_query(u32 index) override;
 			virtual void end_render_pass() override;
@@ -104,6 +114,7 @@ namespace Luna
 			virtual void set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
 			virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
 			virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+			virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
 			virtual void end_compute_pass() override;
 			virtual void begin_copy_pass(const CopyPassDesc& desc) override;
 			virtual void copy_resource(IResource* dst, IResource* src) override;
@@ -128,6 +128,9 @@ namespace Luna
 			case DeviceFeature::uniform_buffer_data_alignment:
 				ret.uniform_buffer_data_alignment = 0;
 				break;
+			case DeviceFeature::draw_indirect_count:
+				ret.draw_indirect_count = false;
+				break;
 			default: lupanic();
 			}
 			return ret;
@@ -72,6 +72,8 @@ namespace Luna
             virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
             virtual R<Ref<IFence>> new_fence() override;
             virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+            virtual R<Blob> get_pipeline_cache_data() override { return Blob(); }
+            virtual RV merge_pipeline_cache_data(Span<const byte_t> data) override { return ok; }
         };
 
         extern Ref<IDevice> g_main_device;
@@ -0,0 +1,36 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Adapter.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "Adapter.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        Vector<Ref<IAdapter>> g_adapters;
+        void init_adapters()
+        {
+            g_adapters.clear();
+            Ref<Adapter> adapter = new_object<Adapter>();
+            adapter->m_name = "Null Adapter";
+            adapter->m_execute_copies = true;
+            g_adapters.push_back(Ref<IAdapter>(adapter));
+            adapter = new_object<Adapter>();
+            adapter->m_name = "Null Adapter (Record Only)";
+            adapter->m_execute_copies = false;
+            g_adapters.push_back(Ref<IAdapter>(adapter));
+        }
+        LUNA_RHI_API Vector<Ref<IAdapter>> get_adapters()
+        {
+            return g_adapters;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Adapter.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Common.hpp"
+#include "../../Adapter.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Adapter : IAdapter
+        {
+            lustruct("RHI::Adapter", "{5e4e956f-baf9-4ace-aa44-82571cc73817}");
+            luiimpl();
+
+            const c8* m_name;
+            //! Whether devices created from this adapter execute copy commands on CPU when command buffers are submitted.
+            //! If this is `false`, commands are only validated and recorded, which measures the CPU cost of the renderer
+            //! without the cost of copying resource data.
+            bool m_execute_copies;
+
+            virtual const c8* get_name() override
+            {
+                return m_name;
+            }
+        };
+        extern Vector<Ref<IAdapter>> g_adapters;
+        void init_adapters();
+    }
+}
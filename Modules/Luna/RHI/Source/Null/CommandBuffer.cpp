@@ -0,0 +1,727 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file CommandBuffer.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "CommandBuffer.hpp"
+#include "DescriptorSet.hpp"
+#include <Luna/Runtime/Time.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV CommandBuffer::init(u32 command_queue_index)
+        {
+            if (command_queue_index >= m_device->m_queues.size())
+            {
+                return set_error(BasicError::bad_arguments(), "Invalid command queue index %u.", command_queue_index);
+            }
+            m_command_queue_index = command_queue_index;
+            return ok;
+        }
+        RV CommandBuffer::reset()
+        {
+            lutsassert();
+            m_objs.clear();
+            m_transient_desc_set_cache.clear();
+            m_transient_desc_sets.clear();
+            m_commands.clear();
+            m_submitted = false;
+            m_pass = PassType::none;
+            m_num_open_events = 0;
+            m_pipeline_layout = nullptr;
+            m_pipeline_state = nullptr;
+            m_index_buffer_bound = false;
+            m_occlusion_query_heap = nullptr;
+            m_timestamp_query_heap = nullptr;
+            m_pipeline_statistics_query_heap = nullptr;
+            return ok;
+        }
+        void CommandBuffer::attach_device_object(IDeviceChild* obj)
+        {
+            lutsassert();
+            m_objs.push_back(obj);
+        }
+        R<IDescriptorSet*> CommandBuffer::allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes)
+        {
+            lutsassert();
+            IDescriptorSet* ret = nullptr;
+            lutry
+            {
+                u64 hash = m_transient_desc_set_cache.encode_key(desc.layout, writes);
+                ret = m_transient_desc_set_cache.find(hash);
+                if (ret) return ret;
+                lulet(set, m_device->new_descriptor_set(desc));
+                luexp(set->update_descriptors(writes));
+                ret = set;
+                m_transient_desc_sets.push_back(move(set));
+                m_transient_desc_set_cache.insert(hash, ret);
+            }
+            lucatchret;
+            return ret;
+        }
+        void CommandBuffer::begin_event(const c8* event_name)
+        {
+            lutsassert();
+            assert_recording();
+            ++m_num_open_events;
+            record(CommandType::begin_event);
+        }
+        void CommandBuffer::end_event()
+        {
+            lutsassert();
+            assert_recording();
+            lucheck_msg(m_num_open_events, "end_event is called without one matching begin_event.");
+            --m_num_open_events;
+            record(CommandType::end_event);
+        }
+        void CommandBuffer::begin_pass(PassType pass, IQueryHeap* timestamp_query_heap, u32 timestamp_begin_index, u32 timestamp_end_index,
+            IQueryHeap* pipeline_statistics_query_heap, u32 pipeline_statistics_index)
+        {
+            assert_recording();
+            assert_no_context();
+            m_pass = pass;
+            m_pipeline_layout = nullptr;
+            m_pipeline_state = nullptr;
+            m_index_buffer_bound = false;
+            m_timestamp_query_heap = nullptr;
+            m_pipeline_statistics_query_heap = nullptr;
+            if (timestamp_query_heap)
+            {
+                m_timestamp_query_heap = cast_object<QueryHeap>(timestamp_query_heap->get_object());
+                [[maybe_unused]] QueryType type = m_timestamp_query_heap->m_desc.type;
+                lucheck_msg(type == QueryType::timestamp || type == QueryType::timestamp_copy_queue, "The timestamp query heap must be created with timestamp query type.");
+                lucheck_msg(timestamp_begin_index == DONT_QUERY || timestamp_begin_index < m_timestamp_query_heap->m_desc.count, "Timestamp query index out of range.");
+                lucheck_msg(timestamp_end_index == DONT_QUERY || timestamp_end_index < m_timestamp_query_heap->m_desc.count, "Timestamp query index out of range.");
+                if (timestamp_begin_index != DONT_QUERY)
+                {
+                    record_query(CommandType::write_timestamp, m_timestamp_query_heap, timestamp_begin_index);
+                }
+                m_timestamp_end_query_index = timestamp_end_index;
+            }
+            if (pipeline_statistics_query_heap)
+            {
+                m_pipeline_statistics_query_heap = cast_object<QueryHeap>(pipeline_statistics_query_heap->get_object());
+                lucheck_msg(m_pipeline_statistics_query_heap->m_desc.type == QueryType::pipeline_statistics, 
+                    "The pipeline statistics query heap must be created with pipeline statistics query type.");
+                lucheck_msg(pipeline_statistics_index == DONT_QUERY || pipeline_statistics_index < m_pipeline_statistics_query_heap->m_desc.count, 
+                    "Pipeline statistics query index out of range.");
+                m_pipeline_statistics_query_index = pipeline_statistics_index;
+            }
+        }
+        void CommandBuffer::end_pass()
+        {
+            if (m_pipeline_statistics_query_heap && m_pipeline_statistics_query_index != DONT_QUERY)
+            {
+                record_query(CommandType::write_pipeline_statistics, m_pipeline_statistics_query_heap, m_pipeline_statistics_query_index);
+            }
+            if (m_timestamp_query_heap && m_timestamp_end_query_index != DONT_QUERY)
+            {
+                record_query(CommandType::write_timestamp, m_timestamp_query_heap, m_timestamp_end_query_index);
+            }
+            m_pass = PassType::none;
+            m_pipeline_layout = nullptr;
+            m_pipeline_state = nullptr;
+            m_index_buffer_bound = false;
+            m_occlusion_query_heap = nullptr;
+            m_timestamp_query_heap = nullptr;
+            m_pipeline_statistics_query_heap = nullptr;
+        }
+        void CommandBuffer::begin_render_pass(const RenderPassDesc& desc)
+        {
+            lutsassert();
+            lucheck_msg(m_device->m_queues[m_command_queue_index].type == CommandQueueType::graphics, 
+                "Render passes can only be recorded on graphics command queues.");
+            for (u32 i = 0; i < 8; ++i)
+            {
+                const ColorAttachment& attachment = desc.color_attachments[i];
+                if (!attachment.texture) continue;
+                [[maybe_unused]] Texture* texture = cast_object<Texture>(attachment.texture->get_object());
+                lucheck_msg(test_flags(texture->m_desc.usages, TextureUsageFlag::color_attachment), 
+                    "Color attachments must be created with TextureUsageFlag::color_attachment.");
+                lucheck_msg(attachment.mip_slice < texture->m_desc.mip_levels && attachment.array_slice + desc.array_size <= texture->m_desc.array_size, 
+                    "The color attachment subresource is out of range.");
+                const ResolveAttachment& resolve = desc.resolve_attachments[i];
+                if (resolve.texture)
+                {
+                    [[maybe_unused]] Texture* resolve_texture = cast_object<Texture>(resolve.texture->get_object());
+                    lucheck_msg(test_flags(resolve_texture->m_desc.usages, TextureUsageFlag::resolve_attachment), 
+                        "Resolve attachments must be created with TextureUsageFlag::resolve_attachment.");
+                    lucheck_msg(texture->m_desc.sample_count > 1, "Resolve attachments can only be specified for multi-sample color attachments.");
+                }
+            }
+            if (desc.depth_stencil_attachment.texture)
+            {
+                [[maybe_unused]] Texture* texture = cast_object<Texture>(desc.depth_stencil_attachment.texture->get_object());
+                lucheck_msg(test_flags(texture->m_desc.usages, TextureUsageFlag::depth_stencil_attachment), 
+                    "Depth stencil attachments must be created with TextureUsageFlag::depth_stencil_attachment.");
+                lucheck_msg(desc.depth_stencil_attachment.mip_slice < texture->m_desc.mip_levels && 
+                    desc.depth_stencil_attachment.array_slice + desc.array_size <= texture->m_desc.array_size, 
+                    "The depth stencil attachment subresource is out of range.");
+            }
+            begin_pass(PassType::render, desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index,
+                desc.pipeline_statistics_query_heap, desc.pipeline_statistics_query_write_index);
+            m_occlusion_query_heap = nullptr;
+            if (desc.occlusion_query_heap)
+            {
+                m_occlusion_query_heap = cast_object<QueryHeap>(desc.occlusion_query_heap->get_object());
+                lucheck_msg(m_occlusion_query_heap->m_desc.type == QueryType::occlusion, "The occlusion query heap must be created with occlusion query type.");
+            }
+            record(CommandType::begin_render_pass);
+        }
+        void CommandBuffer::set_graphics_pipeline_layout(IPipelineLayout* pipeline_layout)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck(pipeline_layout);
+            m_pipeline_layout = cast_object<PipelineLayout>(pipeline_layout->get_object());
+            record(CommandType::set_pipeline_layout);
+        }
+        void CommandBuffer::set_graphics_pipeline_state(IPipelineState* pso)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck(pso);
+            m_pipeline_state = cast_object<PipelineState>(pso->get_object());
+            lucheck_msg(m_pipeline_state->m_is_graphics, "set_graphics_pipeline_state requires one graphics pipeline state.");
+            record(CommandType::set_pipeline_state);
+        }
+        void CommandBuffer::set_vertex_buffers(u32 start_slot, Span<const VertexBufferView> views)
+        {
+            lutsassert();
+            assert_graphics_context();
+            for (auto& view : views)
+            {
+                lucheck(view.buffer);
+                [[maybe_unused]] Buffer* buffer = cast_object<Buffer>(view.buffer->get_object());
+                lucheck_msg(test_flags(buffer->m_desc.usages, BufferUsageFlag::vertex_buffer), 
+                    "Vertex buffers must be created with BufferUsageFlag::vertex_buffer.");
+                lucheck_msg(view.offset + view.size <= buffer->m_desc.size, "The vertex buffer view exceeds the buffer size.");
+            }
+            record(CommandType::set_vertex_buffers);
+        }
+        void CommandBuffer::set_index_buffer(const IndexBufferView& view)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck(view.buffer);
+            [[maybe_unused]] Buffer* buffer = cast_object<Buffer>(view.buffer->get_object());
+            lucheck_msg(test_flags(buffer->m_desc.usages, BufferUsageFlag::index_buffer), 
+                "Index buffers must be created with BufferUsageFlag::index_buffer.");
+            lucheck_msg(view.offset + view.size <= buffer->m_desc.size, "The index buffer view exceeds the buffer size.");
+            lucheck_msg(view.format == Format::r16_uint || view.format == Format::r32_uint, "The index format must be Format::r16_uint or Format::r32_uint.");
+            m_index_buffer_bound = true;
+            record(CommandType::set_index_buffer);
+        }
+        void CommandBuffer::set_graphics_descriptor_set(u32 index, IDescriptorSet* descriptor_set)
+        {
+            set_graphics_descriptor_sets(index, { &descriptor_set, 1 });
+        }
+        void CommandBuffer::set_graphics_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_pipeline_layout, "The graphics pipeline layout must be set before setting descriptor sets.");
+            lucheck_msg(start_index + descriptor_sets.size() <= m_pipeline_layout->m_descriptor_set_layouts.size(), 
+                "The descriptor set index exceeds the number of descriptor sets of the pipeline layout.");
+            for ([[maybe_unused]] IDescriptorSet* set : descriptor_sets)
+            {
+                lucheck(set);
+            }
+            record(CommandType::set_descriptor_sets);
+        }
+        void CommandBuffer::set_viewport(const Viewport& viewport)
+        {
+            set_viewports({ &viewport, 1 });
+        }
+        void CommandBuffer::set_viewports(Span<const Viewport> viewports)
+        {
+            lutsassert();
+            assert_graphics_context();
+            record(CommandType::set_viewports);
+        }
+        void CommandBuffer::set_scissor_rect(const RectI& rect)
+        {
+            set_scissor_rects({ &rect, 1 });
+        }
+        void CommandBuffer::set_scissor_rects(Span<const RectI> rects)
+        {
+            lutsassert();
+            assert_graphics_context();
+            record(CommandType::set_scissor_rects);
+        }
+        void CommandBuffer::set_blend_factor(const Float4U& blend_factor)
+        {
+            lutsassert();
+            assert_graphics_context();
+            record(CommandType::set_blend_factor);
+        }
+        void CommandBuffer::set_stencil_ref(u32 stencil_ref)
+        {
+            lutsassert();
+            assert_graphics_context();
+            record(CommandType::set_stencil_ref);
+        }
+        void CommandBuffer::draw(u32 vertex_count, u32 start_vertex_location)
+        {
+            draw_instanced(vertex_count, 1, start_vertex_location, 0);
+        }
+        void CommandBuffer::draw_indexed(u32 index_count, u32 start_index_location, i32 base_vertex_location)
+        {
+            draw_indexed_instanced(index_count, 1, start_index_location, base_vertex_location, 0);
+        }
+        void CommandBuffer::draw_instanced(u32 vertex_count_per_instance, u32 instance_count, u32 start_vertex_location,
+            u32 start_instance_location)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_pipeline_state, "The graphics pipeline state must be set before drawing.");
+            DrawCommand& c = record(CommandType::draw).draw;
+            c.vertex_or_index_count_per_instance = vertex_count_per_instance;
+            c.instance_count = instance_count;
+            c.start_vertex_or_index_location = start_vertex_location;
+            c.base_vertex_location = 0;
+            c.start_instance_location = start_instance_location;
+            c.indexed = false;
+        }
+        void CommandBuffer::draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
+            i32 base_vertex_location, u32 start_instance_location)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_pipeline_state, "The graphics pipeline state must be set before drawing.");
+            lucheck_msg(m_index_buffer_bound, "The index buffer must be set before drawing indexed primitives.");
+            DrawCommand& c = record(CommandType::draw).draw;
+            c.vertex_or_index_count_per_instance = index_count_per_instance;
+            c.instance_count = instance_count;
+            c.start_vertex_or_index_location = start_index_location;
+            c.base_vertex_location = base_vertex_location;
+            c.start_instance_location = start_instance_location;
+            c.indexed = true;
+        }
+        void CommandBuffer::validate_indirect_buffer(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride, u32 args_size, 
+            IBuffer* count_buffer, u64 count_buffer_offset)
+        {
+            lucheck(buffer);
+            [[maybe_unused]] Buffer* b = cast_object<Buffer>(buffer->get_object());
+            lucheck_msg(test_flags(b->m_desc.usages, BufferUsageFlag::indirect_buffer), 
+                "Indirect argument buffers must be created with BufferUsageFlag::indirect_buffer.");
+            lucheck_msg(stride >= args_size, "The indirect argument stride must not be smaller than the size of one argument record.");
+            lucheck_msg(max_draw_count == 0 || offset + (u64)(max_draw_count - 1) * stride + args_size <= b->m_desc.size, 
+                "Indirect argument records exceed the buffer size.");
+            if (count_buffer)
+            {
+                [[maybe_unused]] Buffer* c = cast_object<Buffer>(count_buffer->get_object());
+                lucheck_msg(test_flags(c->m_desc.usages, BufferUsageFlag::indirect_buffer), 
+                    "Count buffers must be created with BufferUsageFlag::indirect_buffer.");
+                lucheck_msg(count_buffer_offset + sizeof(u32) <= c->m_desc.size, "The draw count exceeds the count buffer size.");
+            }
+        }
+        void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+            IBuffer* count_buffer, u64 count_buffer_offset)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_pipeline_state, "The graphics pipeline state must be set before drawing.");
+            validate_indirect_buffer(buffer, offset, max_draw_count, stride, sizeof(DrawIndirectArguments), count_buffer, count_buffer_offset);
+            record_indirect(CommandType::draw_indirect, buffer, offset, max_draw_count, stride, count_buffer, count_buffer_offset, false);
+        }
+        void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+            IBuffer* count_buffer, u64 count_buffer_offset)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_pipeline_state, "The graphics pipeline state must be set before drawing.");
+            lucheck_msg(m_index_buffer_bound, "The index buffer must be set before drawing indexed primitives.");
+            validate_indirect_buffer(buffer, offset, max_draw_count, stride, sizeof(DrawIndexedIndirectArguments), count_buffer, count_buffer_offset);
+            record_indirect(CommandType::draw_indirect, buffer, offset, max_draw_count, stride, count_buffer, count_buffer_offset, true);
+        }
+        void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_occlusion_query_heap, "Occlusion queries require RenderPassDesc::occlusion_query_heap to be set.");
+            lucheck_msg(index < m_occlusion_query_heap->m_desc.count, "Occlusion query index out of range.");
+        }
+        void CommandBuffer::end_occlusion_query(u32 index)
+        {
+            lutsassert();
+            assert_graphics_context();
+            lucheck_msg(m_occlusion_query_heap, "Occlusion queries require RenderPassDesc::occlusion_query_heap to be set.");
+            lucheck_msg(index < m_occlusion_query_heap->m_desc.count, "Occlusion query index out of range.");
+            record_query(CommandType::write_occlusion, m_occlusion_query_heap, index);
+        }
+        void CommandBuffer::end_render_pass()
+        {
+            lutsassert();
+            assert_graphics_context();
+            record(CommandType::end_render_pass);
+            end_pass();
+        }
+        void CommandBuffer::begin_compute_pass(const ComputePassDesc& desc)
+        {
+            lutsassert();
+            lucheck_msg(m_device->m_queues[m_command_queue_index].type != CommandQueueType::copy, 
+                "Compute passes cannot be recorded on copy command queues.");
+            begin_pass(PassType::compute, desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index,
+                desc.pipeline_statistics_query_heap, desc.pipeline_statistics_query_write_index);
+            record(CommandType::begin_compute_pass);
+        }
+        void CommandBuffer::set_compute_pipeline_layout(IPipelineLayout* pipeline_layout)
+        {
+            lutsassert();
+            assert_compute_context();
+            lucheck(pipeline_layout);
+            m_pipeline_layout = cast_object<PipelineLayout>(pipeline_layout->get_object());
+            record(CommandType::set_pipeline_layout);
+        }
+        void CommandBuffer::set_compute_pipeline_state(IPipelineState* pso)
+        {
+            lutsassert();
+            assert_compute_context();
+            lucheck(pso);
+            m_pipeline_state = cast_object<PipelineState>(pso->get_object());
+            lucheck_msg(!m_pipeline_state->m_is_graphics, "set_compute_pipeline_state requires one compute pipeline state.");
+            record(CommandType::set_pipeline_state);
+        }
+        void CommandBuffer::set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set)
+        {
+            set_compute_descriptor_sets(index, { &descriptor_set, 1 });
+        }
+        void CommandBuffer::set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets)
+        {
+            lutsassert();
+            assert_compute_context();
+            lucheck_msg(m_pipeline_layout, "The compute pipeline layout must be set before setting descriptor sets.");
+            lucheck_msg(start_index + descriptor_sets.size() <= m_pipeline_layout->m_descriptor_set_layouts.size(), 
+                "The descriptor set index exceeds the number of descriptor sets of the pipeline layout.");
+            for ([[maybe_unused]] IDescriptorSet* set : descriptor_sets)
+            {
+                lucheck(set);
+            }
+            record(CommandType::set_descriptor_sets);
+        }
+        void CommandBuffer::dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z)
+        {
+            lutsassert();
+            assert_compute_context();
+            lucheck_msg(m_pipeline_state, "The compute pipeline state must be set before dispatching.");
+            DispatchCommand& c = record(CommandType::dispatch).dispatch;
+            c.thread_group_count_x = thread_group_count_x;
+            c.thread_group_count_y = thread_group_count_y;
+            c.thread_group_count_z = thread_group_count_z;
+        }
+        void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+        {
+            lutsassert();
+            assert_compute_context();
+            lucheck_msg(m_pipeline_state, "The compute pipeline state must be set before dispatching.");
+            validate_indirect_buffer(buffer, offset, 1, sizeof(DispatchIndirectArguments), sizeof(DispatchIndirectArguments), nullptr, 0);
+            record_indirect(CommandType::dispatch_indirect, buffer, offset, 1, sizeof(DispatchIndirectArguments), nullptr, 0, false);
+        }
+        void CommandBuffer::end_compute_pass()
+        {
+            lutsassert();
+            assert_compute_context();
+            record(CommandType::end_compute_pass);
+            end_pass();
+        }
+        void CommandBuffer::begin_copy_pass(const CopyPassDesc& desc)
+        {
+            lutsassert();
+            begin_pass(PassType::copy, desc.timestamp_query_heap, desc.timestamp_query_begin_pass_write_index, desc.timestamp_query_end_pass_write_index,
+                nullptr, DONT_QUERY);
+            record(CommandType::begin_copy_pass);
+        }
+        void CommandBuffer::copy_resource(IResource* dst, IResource* src)
+        {
+            lutsassert();
+            assert_copy_context();
+            lucheck(dst && src);
+            Buffer* dst_buffer = cast_object<Buffer>(dst->get_object());
+            Buffer* src_buffer = cast_object<Buffer>(src->get_object());
+            if (dst_buffer && src_buffer)
+            {
+                lucheck_msg(dst_buffer->m_desc.size == src_buffer->m_desc.size, "copy_resource requires buffers with the same size.");
+                copy_buffer(dst_buffer, 0, src_buffer, 0, dst_buffer->m_desc.size);
+                return;
+            }
+            Texture* dst_texture = cast_object<Texture>(dst->get_object());
+            Texture* src_texture = cast_object<Texture>(src->get_object());
+            lucheck_msg(dst_texture && src_texture, "copy_resource requires two buffers or two textures.");
+            lucheck_msg(dst_texture->m_desc.width == src_texture->m_desc.width && dst_texture->m_desc.height == src_texture->m_desc.height &&
+                dst_texture->m_desc.depth == src_texture->m_desc.depth && dst_texture->m_desc.array_size == src_texture->m_desc.array_size &&
+                dst_texture->m_desc.mip_levels == src_texture->m_desc.mip_levels, "copy_resource requires textures with the same size.");
+            for (u32 array_slice = 0; array_slice < dst_texture->m_desc.array_size; ++array_slice)
+            {
+                for (u32 mip_slice = 0; mip_slice < dst_texture->m_desc.mip_levels; ++mip_slice)
+                {
+                    SubresourceIndex subresource(mip_slice, array_slice);
+                    UInt3U size = dst_texture->get_mip_size(mip_slice);
+                    copy_texture(dst_texture, subresource, 0, 0, 0, src_texture, subresource, 0, 0, 0, size.x, size.y, size.z);
+                }
+            }
+        }
+        void CommandBuffer::copy_buffer(
+            IBuffer* dst, u64 dst_offset,
+            IBuffer* src, u64 src_offset,
+            u64 copy_bytes)
+        {
+            lutsassert();
+            assert_copy_context();
+            lucheck(dst && src);
+            Buffer* d = cast_object<Buffer>(dst->get_object());
+            Buffer* s = cast_object<Buffer>(src->get_object());
+            lucheck_msg(test_flags(d->m_desc.usages, BufferUsageFlag::copy_dest), "The copy destination must be created with BufferUsageFlag::copy_dest.");
+            lucheck_msg(test_flags(s->m_desc.usages, BufferUsageFlag::copy_source), "The copy source must be created with BufferUsageFlag::copy_source.");
+            lucheck_msg(dst_offset + copy_bytes <= d->m_desc.size, "The copy range exceeds the destination buffer size.");
+            lucheck_msg(src_offset + copy_bytes <= s->m_desc.size, "The copy range exceeds the source buffer size.");
+            Command& command = record(CommandType::copy_buffer);
+            command.copy_buffer.dst = d;
+            command.copy_buffer.dst_offset = dst_offset;
+            command.copy_buffer.src = s;
+            command.copy_buffer.src_offset = src_offset;
+            command.copy_buffer.copy_bytes = copy_bytes;
+        }
+        static bool is_texture_region_valid(Texture* texture, SubresourceIndex subresource, u32 x, u32 y, u32 z, u32 width, u32 height, u32 depth)
+        {
+            if (!texture->is_valid_subresource(subresource)) return false;
+            UInt3U size = texture->get_mip_size(subresource.mip_slice);
+            if ((u64)x + width > size.x || (u64)y + height > size.y || (u64)z + depth > size.z) return false;
+            // Regions of block-compressed textures must be aligned to blocks, except for regions that end at the texture edge.
+            TexelBlockInfo block = get_texel_block_info(texture->m_desc.format);
+            if ((x % block.width) || (y % block.height)) return false;
+            if (((x + width) % block.width) && x + width != size.x) return false;
+            if (((y + height) % block.height) && y + height != size.y) return false;
+            return true;
+        }
+        void CommandBuffer::copy_texture(
+            ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+            ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            lutsassert();
+            assert_copy_context();
+            lucheck(dst && src);
+            Texture* d = cast_object<Texture>(dst->get_object());
+            Texture* s = cast_object<Texture>(src->get_object());
+            lucheck_msg(test_flags(d->m_desc.usages, TextureUsageFlag::copy_dest), "The copy destination must be created with TextureUsageFlag::copy_dest.");
+            lucheck_msg(test_flags(s->m_desc.usages, TextureUsageFlag::copy_source), "The copy source must be created with TextureUsageFlag::copy_source.");
+            lucheck_msg(bits_per_pixel(d->m_desc.format) == bits_per_pixel(s->m_desc.format) && 
+                is_block_compressed_format(d->m_desc.format) == is_block_compressed_format(s->m_desc.format), 
+                "Textures copied between each other must have compatible formats.");
+            lucheck_msg(is_texture_region_valid(d, dst_subresource, dst_x, dst_y, dst_z, copy_width, copy_height, copy_depth), 
+                "The copy region exceeds the destination texture subresource.");
+            lucheck_msg(is_texture_region_valid(s, src_subresource, src_x, src_y, src_z, copy_width, copy_height, copy_depth), 
+                "The copy region exceeds the source texture subresource.");
+            Command& command = record(CommandType::copy_texture);
+            CopyTextureCommand& c = command.copy_texture;
+            c.dst = d;
+            c.dst_subresource = dst_subresource;
+            c.dst_x = dst_x;
+            c.dst_y = dst_y;
+            c.dst_z = dst_z;
+            c.src = s;
+            c.src_subresource = src_subresource;
+            c.src_x = src_x;
+            c.src_y = src_y;
+            c.src_z = src_z;
+            c.copy_width = copy_width;
+            c.copy_height = copy_height;
+            c.copy_depth = copy_depth;
+        }
+        static void validate_buffer_texture_copy(Buffer* buffer, u64 buffer_offset, u32 row_pitch, u32 slice_pitch, 
+            Texture* texture, u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            u64 row_bytes, slice_bytes, size;
+            calc_texture_data_placement(copy_width, copy_height, 1, texture->m_desc.format, row_bytes, slice_bytes, size);
+            lucheck_msg(row_pitch >= row_bytes, "The buffer row pitch is smaller than the size of one row of the copy region.");
+            TexelBlockInfo block = get_texel_block_info(texture->m_desc.format);
+            u32 num_rows = (copy_height + block.height - 1) / block.height;
+            lucheck_msg(copy_depth <= 1 || slice_pitch >= (u64)row_pitch * num_rows, "The buffer slice pitch is smaller than the size of one slice of the copy region.");
+            [[maybe_unused]] u64 end = copy_width && copy_height && copy_depth ? 
+                buffer_offset + (u64)(copy_depth - 1) * slice_pitch + (u64)(num_rows - 1) * row_pitch + row_bytes : buffer_offset;
+            lucheck_msg(end <= buffer->m_desc.size, "The copy region exceeds the buffer size.");
+        }
+        static void record_buffer_texture_copy(CopyBufferTextureCommand& c, Buffer* buffer, u64 buffer_offset, u32 row_pitch, u32 slice_pitch,
+            Texture* texture, SubresourceIndex subresource, u32 x, u32 y, u32 z, u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            c.buffer = buffer;
+            c.buffer_offset = buffer_offset;
+            c.buffer_row_pitch = row_pitch;
+            c.buffer_slice_pitch = slice_pitch;
+            c.texture = texture;
+            c.subresource = subresource;
+            c.x = x;
+            c.y = y;
+            c.z = z;
+            c.copy_width = copy_width;
+            c.copy_height = copy_height;
+            c.copy_depth = copy_depth;
+        }
+        void CommandBuffer::copy_buffer_to_texture(
+            ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+            IBuffer* src, u64 src_offset, u32 src_row_pitch, u32 src_slice_pitch,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            lutsassert();
+            assert_copy_context();
+            lucheck(dst && src);
+            Texture* d = cast_object<Texture>(dst->get_object());
+            Buffer* s = cast_object<Buffer>(src->get_object());
+            lucheck_msg(test_flags(d->m_desc.usages, TextureUsageFlag::copy_dest), "The copy destination must be created with TextureUsageFlag::copy_dest.");
+            lucheck_msg(test_flags(s->m_desc.usages, BufferUsageFlag::copy_source), "The copy source must be created with BufferUsageFlag::copy_source.");
+            lucheck_msg(is_texture_region_valid(d, dst_subresource, dst_x, dst_y, dst_z, copy_width, copy_height, copy_depth), 
+                "The copy region exceeds the destination texture subresource.");
+            validate_buffer_texture_copy(s, src_offset, src_row_pitch, src_slice_pitch, d, copy_width, copy_height, copy_depth);
+            Command& command = record(CommandType::copy_buffer_to_texture);
+            record_buffer_texture_copy(command.copy_buffer_texture, s, src_offset, src_row_pitch, src_slice_pitch,
+                d, dst_subresource, dst_x, dst_y, dst_z, copy_width, copy_height, copy_depth);
+        }
+        void CommandBuffer::copy_texture_to_buffer(
+            IBuffer* dst, u64 dst_offset, u32 dst_row_pitch, u32 dst_slice_pitch,
+            ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+            u32 copy_width, u32 copy_height, u32 copy_depth)
+        {
+            lutsassert();
+            assert_copy_context();
+            lucheck(dst && src);
+            Buffer* d = cast_object<Buffer>(dst->get_object());
+            Texture* s = cast_object<Texture>(src->get_object());
+            lucheck_msg(test_flags(d->m_desc.usages, BufferUsageFlag::copy_dest), "The copy destination must be created with BufferUsageFlag::copy_dest.");
+            lucheck_msg(test_flags(s->m_desc.usages, TextureUsageFlag::copy_source), "The copy source must be created with TextureUsageFlag::copy_source.");
+            lucheck_msg(is_texture_region_valid(s, src_subresource, src_x, src_y, src_z, copy_width, copy_height, copy_depth), 
+                "The copy region exceeds the source texture subresource.");
+            validate_buffer_texture_copy(d, dst_offset, dst_row_pitch, dst_slice_pitch, s, copy_width, copy_height, copy_depth);
+            Command& command = record(CommandType::copy_texture_to_buffer);
+            record_buffer_texture_copy(command.copy_buffer_texture, d, dst_offset, dst_row_pitch, dst_slice_pitch,
+                s, src_subresource, src_x, src_y, src_z, copy_width, copy_height, copy_depth);
+        }
+        void CommandBuffer::end_copy_pass()
+        {
+            lutsassert();
+            assert_copy_context();
+            record(CommandType::end_copy_pass);
+            end_pass();
+        }
+        void CommandBuffer::resource_barrier(Span<const BufferBarrier> buffer_barriers, Span<const TextureBarrier> texture_barriers)
+        {
+            lutsassert();
+            assert_recording();
+            assert_non_render_pass();
+            for ([[maybe_unused]] auto& barrier : buffer_barriers)
+            {
+                lucheck(barrier.buffer);
+                lucheck_msg(barrier.after != BufferStateFlag::automatic, "The after state of one barrier must not be BufferStateFlag::automatic.");
+            }
+            for (auto& barrier : texture_barriers)
+            {
+                lucheck(barrier.texture);
+                lucheck_msg(barrier.after != TextureStateFlag::automatic, "The after state of one barrier must not be TextureStateFlag::automatic.");
+                [[maybe_unused]] Texture* texture = cast_object<Texture>(barrier.texture->get_object());
+                lucheck_msg(barrier.subresource == TEXTURE_BARRIER_ALL_SUBRESOURCES || texture->is_valid_subresource(barrier.subresource), 
+                    "The barrier subresource is out of range.");
+            }
+            record(CommandType::resource_barrier);
+        }
+        static void copy_texture_rows(byte_t* dst, u64 dst_row_pitch, u64 dst_slice_pitch, const byte_t* src, u64 src_row_pitch, u64 src_slice_pitch,
+            u32 copy_width, u32 copy_height, u32 copy_depth, Format format)
+        {
+            u64 row_bytes, slice_bytes, size;
+            calc_texture_data_placement(copy_width, copy_height, 1, format, row_bytes, slice_bytes, size);
+            TexelBlockInfo block = get_texel_block_info(format);
+            u32 num_rows = (copy_height + block.height - 1) / block.height;
+            for (u32 z = 0; z < copy_depth; ++z)
+            {
+                for (u32 row = 0; row < num_rows; ++row)
+                {
+                    memcpy(dst + z * dst_slice_pitch + row * dst_row_pitch, src + z * src_slice_pitch + row * src_row_pitch, row_bytes);
+                }
+            }
+        }
+        //! Gets the address of the texel block at (x, y, z) of one texture subresource, and the row and slice pitch of the subresource.
+        static byte_t* get_texel_address(Texture* texture, SubresourceIndex subresource, u32 x, u32 y, u32 z, u64& row_pitch, u64& slice_pitch)
+        {
+            UInt3U size = texture->get_mip_size(subresource.mip_slice);
+            u64 subresource_size;
+            calc_texture_data_placement(size.x, size.y, size.z, texture->m_desc.format, row_pitch, slice_pitch, subresource_size);
+            TexelBlockInfo block = get_texel_block_info(texture->m_desc.format);
+            return texture->get_subresource_data(subresource) + z * slice_pitch + (y / block.height) * row_pitch + (x / block.width) * block.bytes;
+        }
+        void CommandBuffer::execute_commands()
+        {
+            bool execute_copies = m_device->m_execute_copies;
+            for (auto& command : m_commands)
+            {
+                switch (command.type)
+                {
+                case CommandType::copy_buffer:
+                    if (execute_copies)
+                    {
+                        auto& c = command.copy_buffer;
+                        memmove(c.dst->get_data() + c.dst_offset, c.src->get_data() + c.src_offset, c.copy_bytes);
+                    }
+                    break;
+                case CommandType::copy_texture:
+                    if (execute_copies)
+                    {
+                        auto& c = command.copy_texture;
+                        u64 dst_row_pitch, dst_slice_pitch, src_row_pitch, src_slice_pitch;
+                        byte_t* dst = get_texel_address(c.dst, c.dst_subresource, c.dst_x, c.dst_y, c.dst_z, dst_row_pitch, dst_slice_pitch);
+                        const byte_t* src = get_texel_address(c.src, c.src_subresource, c.src_x, c.src_y, c.src_z, src_row_pitch, src_slice_pitch);
+                        copy_texture_rows(dst, dst_row_pitch, dst_slice_pitch, src, src_row_pitch, src_slice_pitch, 
+                            c.copy_width, c.copy_height, c.copy_depth, c.dst->m_desc.format);
+                    }
+                    break;
+                case CommandType::copy_buffer_to_texture:
+                    if (execute_copies)
+                    {
+                        auto& c = command.copy_buffer_texture;
+                        u64 row_pitch, slice_pitch;
+                        byte_t* dst = get_texel_address(c.texture, c.subresource, c.x, c.y, c.z, row_pitch, slice_pitch);
+                        copy_texture_rows(dst, row_pitch, slice_pitch, c.buffer->get_data() + c.buffer_offset, c.buffer_row_pitch, c.buffer_slice_pitch,
+                            c.copy_width, c.copy_height, c.copy_depth, c.texture->m_desc.format);
+                    }
+                    break;
+                case CommandType::copy_texture_to_buffer:
+                    if (execute_copies)
+                    {
+                        auto& c = command.copy_buffer_texture;
+                        u64 row_pitch, slice_pitch;
+                        const byte_t* src = get_texel_address(c.texture, c.subresource, c.x, c.y, c.z, row_pitch, slice_pitch);
+                        copy_texture_rows(c.buffer->get_data() + c.buffer_offset, c.buffer_row_pitch, c.buffer_slice_pitch, src, row_pitch, slice_pitch,
+                            c.copy_width, c.copy_height, c.copy_depth, c.texture->m_desc.format);
+                    }
+                    break;
+                case CommandType::write_timestamp:
+                    command.query.heap->m_values[command.query.index] = get_ticks();
+                    break;
+                case CommandType::write_occlusion:
+                    command.query.heap->m_values[command.query.index] = 1;
+                    break;
+                case CommandType::write_pipeline_statistics:
+                    memzero(&command.query.heap->m_pipeline_statistics[command.query.index], sizeof(PipelineStatistics));
+                    break;
+                default: break;
+                }
+            }
+        }
+        RV CommandBuffer::submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting)
+        {
+            lutsassert();
+            assert_recording();
+            lucheck_msg(m_pass == PassType::none, "The command buffer cannot be submitted when one pass is open.");
+            lucheck_msg(m_num_open_events == 0, "The command buffer cannot be submitted when one event is open.");
+            // Since command buffers are executed when they are submitted, all commands that signal 
+            // `wait_fences` are already executed, so fences do not need to be handled.
+            execute_commands();
+            m_submitted = true;
+            return ok;
+        }
+    }
+}
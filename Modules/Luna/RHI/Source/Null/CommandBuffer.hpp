@@ -0,0 +1,317 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file CommandBuffer.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Device.hpp"
+#include "Resource.hpp"
+#include "PipelineState.hpp"
+#include "QueryHeap.hpp"
+#include "../DescriptorSetCache.hpp"
+#include <Luna/Runtime/TSAssert.hpp>
+
+namespace Luna
+{
+    namespace RHI
+    {
+        enum class CommandType : u8
+        {
+            begin_event,
+            end_event,
+            begin_render_pass,
+            end_render_pass,
+            begin_compute_pass,
+            end_compute_pass,
+            begin_copy_pass,
+            end_copy_pass,
+            set_pipeline_layout,
+            set_pipeline_state,
+            set_vertex_buffers,
+            set_index_buffer,
+            set_descriptor_sets,
+            set_viewports,
+            set_scissor_rects,
+            set_blend_factor,
+            set_stencil_ref,
+            draw,
+            draw_indirect,
+            dispatch,
+            dispatch_indirect,
+            copy_buffer,
+            copy_texture,
+            copy_buffer_to_texture,
+            copy_texture_to_buffer,
+            resource_barrier,
+            write_timestamp,
+            write_occlusion,
+            write_pipeline_statistics,
+        };
+
+        struct CopyBufferCommand
+        {
+            Buffer* dst;
+            u64 dst_offset;
+            Buffer* src;
+            u64 src_offset;
+            u64 copy_bytes;
+        };
+
+        struct CopyTextureCommand
+        {
+            Texture* dst;
+            SubresourceIndex dst_subresource;
+            u32 dst_x;
+            u32 dst_y;
+            u32 dst_z;
+            Texture* src;
+            SubresourceIndex src_subresource;
+            u32 src_x;
+            u32 src_y;
+            u32 src_z;
+            u32 copy_width;
+            u32 copy_height;
+            u32 copy_depth;
+        };
+
+        //! Used by both `copy_buffer_to_texture` and `copy_texture_to_buffer`.
+        struct CopyBufferTextureCommand
+        {
+            Buffer* buffer;
+            u64 buffer_offset;
+            u32 buffer_row_pitch;
+            u32 buffer_slice_pitch;
+            Texture* texture;
+            SubresourceIndex subresource;
+            u32 x;
+            u32 y;
+            u32 z;
+            u32 copy_width;
+            u32 copy_height;
+            u32 copy_depth;
+        };
+
+        struct QueryCommand
+        {
+            QueryHeap* heap;
+            u32 index;
+        };
+
+        //! Used by both `draw_instanced` and `draw_indexed_instanced`.
+        struct DrawCommand
+        {
+            u32 vertex_or_index_count_per_instance;
+            u32 instance_count;
+            u32 start_vertex_or_index_location;
+            i32 base_vertex_location;
+            u32 start_instance_location;
+            bool indexed;
+        };
+
+        //! Used by `draw_indirect`, `draw_indexed_indirect` and `dispatch_indirect`. The null backend does not read 
+        //! indirect arguments, so they are stored as-is.
+        struct IndirectCommand
+        {
+            Buffer* buffer;
+            u64 offset;
+            u32 max_draw_count;
+            u32 stride;
+            Buffer* count_buffer;
+            u64 count_buffer_offset;
+            bool indexed;
+        };
+
+        struct DispatchCommand
+        {
+            u32 thread_group_count_x;
+            u32 thread_group_count_y;
+            u32 thread_group_count_z;
+        };
+
+        //! One recorded command. Copy, query, draw and dispatch commands store their arguments so that they can be 
+        //! executed on submission or checked by tests. Other commands store only their types.
+        struct Command
+        {
+            CommandType type;
+            union
+            {
+                CopyBufferCommand copy_buffer;
+                CopyTextureCommand copy_texture;
+                CopyBufferTextureCommand copy_buffer_texture;
+                QueryCommand query;
+                DrawCommand draw;
+                IndirectCommand indirect;
+                DispatchCommand dispatch;
+            };
+        };
+
+        enum class PassType : u8
+        {
+            none,
+            render,
+            compute,
+            copy,
+        };
+
+        //! Commands are validated and recorded when they are called, and are executed on CPU when the command
+        //! buffer is submitted. Since the execution is finished before `submit` returns, waiting for the command 
+        //! buffer and fences never blocks.
+        struct CommandBuffer : ICommandBuffer
+        {
+            lustruct("RHI::CommandBuffer", "{d2649bb3-6075-491b-bd5f-defdd5abdad4}");
+            luiimpl();
+            lutsassert_lock();
+
+            Ref<Device> m_device;
+            u32 m_command_queue_index;
+
+            // The attached graphic objects.
+            Vector<Ref<IDeviceChild>> m_objs;
+
+            // Transient descriptor sets allocated since the last reset.
+            Vector<Ref<IDescriptorSet>> m_transient_desc_sets;
+            TransientDescriptorSetCache m_transient_desc_set_cache;
+
+            Vector<Command> m_commands;
+            bool m_submitted = false;
+
+            // Validation states.
+            PassType m_pass = PassType::none;
+            u32 m_num_open_events = 0;
+            PipelineLayout* m_pipeline_layout = nullptr;
+            PipelineState* m_pipeline_state = nullptr;
+            bool m_index_buffer_bound = false;
+            QueryHeap* m_occlusion_query_heap = nullptr;
+            QueryHeap* m_timestamp_query_heap = nullptr;
+            QueryHeap* m_pipeline_statistics_query_heap = nullptr;
+            u32 m_timestamp_end_query_index = DONT_QUERY;
+            u32 m_pipeline_statistics_query_index = DONT_QUERY;
+
+            RV init(u32 command_queue_index);
+
+            void assert_recording()
+            {
+                lucheck_msg(!m_submitted, "The command buffer must be reset before recording new commands after it is submitted.");
+            }
+            void assert_graphics_context()
+            {
+                lucheck_msg(m_pass == PassType::render, "A graphics command can only be submitted between begin_render_pass and end_render_pass.");
+            }
+            void assert_compute_context()
+            {
+                lucheck_msg(m_pass == PassType::compute, "A compute command can only be submitted between begin_compute_pass and end_compute_pass.");
+            }
+            void assert_copy_context()
+            {
+                lucheck_msg(m_pass == PassType::copy, "A copy command can only be submitted between begin_copy_pass and end_copy_pass.");
+            }
+            void assert_non_render_pass()
+            {
+                lucheck_msg(m_pass != PassType::render, "This command cannot be submitted within a render pass.");
+            }
+            void assert_no_context()
+            {
+                lucheck_msg(m_pass == PassType::none, "This command can only be submitted when no pass is open.");
+            }
+            Command& record(CommandType type)
+            {
+                Command& command = *m_commands.emplace_back();
+                command.type = type;
+                return command;
+            }
+            void record_query(CommandType type, QueryHeap* heap, u32 index)
+            {
+                Command& command = record(type);
+                command.query.heap = heap;
+                command.query.index = index;
+            }
+            void record_indirect(CommandType type, IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+                IBuffer* count_buffer, u64 count_buffer_offset, bool indexed)
+            {
+                IndirectCommand& c = record(type).indirect;
+                c.buffer = cast_object<Buffer>(buffer->get_object());
+                c.offset = offset;
+                c.max_draw_count = max_draw_count;
+                c.stride = stride;
+                c.count_buffer = count_buffer ? cast_object<Buffer>(count_buffer->get_object()) : nullptr;
+                c.count_buffer_offset = count_buffer_offset;
+                c.indexed = indexed;
+            }
+            void begin_pass(PassType pass, IQueryHeap* timestamp_query_heap, u32 timestamp_begin_index, u32 timestamp_end_index,
+                IQueryHeap* pipeline_statistics_query_heap, u32 pipeline_statistics_index);
+            void end_pass();
+            void validate_indirect_buffer(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride, u32 args_size, IBuffer* count_buffer, u64 count_buffer_offset);
+            void execute_commands();
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual void wait() override {}
+            virtual bool try_wait() override { return true; }
+            virtual u32 get_command_queue_index() override { return m_command_queue_index; }
+            virtual RV reset() override;
+            virtual void attach_device_object(IDeviceChild* obj) override;
+            virtual R<IDescriptorSet*> allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes) override;
+            virtual void begin_event(const c8* event_name) override;
+            virtual void end_event() override;
+            virtual void begin_render_pass(const RenderPassDesc& desc) override;
+            virtual void set_graphics_pipeline_layout(IPipelineLayout* pipeline_layout) override;
+            virtual void set_graphics_pipeline_state(IPipelineState* pso) override;
+            virtual void set_vertex_buffers(u32 start_slot, Span<const VertexBufferView> views) override;
+            virtual void set_index_buffer(const IndexBufferView& view) override;
+            virtual void set_graphics_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
+            virtual void set_graphics_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
+            virtual void set_viewport(const Viewport& viewport) override;
+            virtual void set_viewports(Span<const Viewport> viewports) override;
+            virtual void set_scissor_rect(const RectI& rect) override;
+            virtual void set_scissor_rects(Span<const RectI> rects) override;
+            virtual void set_blend_factor(const Float4U& blend_factor) override;
+            virtual void set_stencil_ref(u32 stencil_ref) override;
+            virtual void draw(u32 vertex_count, u32 start_vertex_location) override;
+            virtual void draw_indexed(u32 index_count, u32 start_index_location, i32 base_vertex_location) override;
+            virtual void draw_instanced(u32 vertex_count_per_instance, u32 instance_count, u32 start_vertex_location,
+                u32 start_instance_location) override;
+            virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
+                i32 base_vertex_location, u32 start_instance_location) override;
+            virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+                IBuffer* count_buffer, u64 count_buffer_offset) override;
+            virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+                IBuffer* count_buffer, u64 count_buffer_offset) override;
+            virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
+            virtual void end_occlusion_query(u32 index) override;
+            virtual void end_render_pass() override;
+            virtual void begin_compute_pass(const ComputePassDesc& desc) override;
+            virtual void set_compute_pipeline_layout(IPipelineLayout* pipeline_layout) override;
+            virtual void set_compute_pipeline_state(IPipelineState* pso) override;
+            virtual void set_compute_descriptor_set(u32 index, IDescriptorSet* descriptor_set) override;
+            virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
+            virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+            virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
+            virtual void end_compute_pass() override;
+            virtual void begin_copy_pass(const CopyPassDesc& desc) override;
+            virtual void copy_resource(IResource* dst, IResource* src) override;
+            virtual void copy_buffer(
+                IBuffer* dst, u64 dst_offset,
+                IBuffer* src, u64 src_offset,
+                u64 copy_bytes) override;
+            virtual void copy_texture(
+                ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+                ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void copy_buffer_to_texture(
+                ITexture* dst, SubresourceIndex dst_subresource, u32 dst_x, u32 dst_y, u32 dst_z,
+                IBuffer* src, u64 src_offset, u32 src_row_pitch, u32 src_slice_pitch,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void copy_texture_to_buffer(
+                IBuffer* dst, u64 dst_offset, u32 dst_row_pitch, u32 dst_slice_pitch,
+                ITexture* src, SubresourceIndex src_subresource, u32 src_x, u32 src_y, u32 src_z,
+                u32 copy_width, u32 copy_height, u32 copy_depth) override;
+            virtual void end_copy_pass() override;
+            virtual void resource_barrier(Span<const BufferBarrier> buffer_barriers, Span<const TextureBarrier> texture_barriers) override;
+            virtual RV submit(Span<IFence*> wait_fences, Span<IFence*> signal_fences, bool allow_host_waiting) override;
+        };
+    }
+}
@@ -0,0 +1,64 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Common.hpp
+* @author JXMaster
+* @date 2026/10/19
+* @brief Common utilities for the null backend, which implements all RHI objects in system memory without any GPU.
+*/
+#pragma once
+#include "../RHI.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        inline bool is_block_compressed_format(Format format)
+        {
+            return format >= Format::bc1_rgba_unorm && format <= Format::bc7_rgba_unorm_srgb;
+        }
+
+        //! The size of the smallest unit of one texture data that can be copied.
+        struct TexelBlockInfo
+        {
+            //! The width of one block in pixels.
+            u32 width;
+            //! The height of one block in pixels.
+            u32 height;
+            //! The size of one block in bytes.
+            u32 bytes;
+        };
+
+        inline TexelBlockInfo get_texel_block_info(Format format)
+        {
+            TexelBlockInfo r;
+            if (is_block_compressed_format(format))
+            {
+                r.width = 4;
+                r.height = 4;
+                r.bytes = (u32)bits_per_pixel(format) * 16 / 8;
+            }
+            else
+            {
+                r.width = 1;
+                r.height = 1;
+                r.bytes = (u32)bits_per_pixel(format) / 8;
+            }
+            return r;
+        }
+
+        //! Computes the tightly packed data placement of one texture region. Every row stores one row of texel blocks.
+        inline void calc_texture_data_placement(u32 width, u32 height, u32 depth, Format format, u64& row_pitch, u64& slice_pitch, u64& size)
+        {
+            TexelBlockInfo block = get_texel_block_info(format);
+            row_pitch = (u64)((width + block.width - 1) / block.width) * block.bytes;
+            slice_pitch = row_pitch * ((height + block.height - 1) / block.height);
+            size = slice_pitch * depth;
+        }
+
+        //! The alignment of resource data in device memory and texture data in buffers.
+        constexpr u64 NULL_RESOURCE_DATA_ALIGNMENT = 16;
+    }
+}
@@ -0,0 +1,132 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DescriptorSet.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "DescriptorSet.hpp"
+#include "Resource.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV DescriptorSet::init(const DescriptorSetDesc& desc)
+        {
+            if (!desc.layout) return set_error(BasicError::bad_arguments(), "DescriptorSetDesc::layout must not be `nullptr`.");
+            m_layout = cast_object<DescriptorSetLayout>(desc.layout->get_object());
+            m_num_variable_descriptors = desc.num_variable_descriptors;
+            if (test_flags(m_layout->m_flags, DescriptorSetLayoutFlag::variable_descriptors) &&
+                m_num_variable_descriptors > m_layout->m_bindings.back().num_descs)
+            {
+                return set_error(BasicError::bad_arguments(), "DescriptorSetDesc::num_variable_descriptors (%u) exceeds the maximum number of descriptors of the binding (%u).",
+                    m_num_variable_descriptors, m_layout->m_bindings.back().num_descs);
+            }
+            return ok;
+        }
+        RV DescriptorSet::validate_write(const WriteDescriptorSet& write)
+        {
+            usize binding_index = m_layout->find_binding(write.binding_slot);
+            if (binding_index == USIZE_MAX)
+            {
+                return set_error(BasicError::bad_arguments(), "Binding slot %u is not declared in the descriptor set layout.", write.binding_slot);
+            }
+            const DescriptorSetLayoutBinding& binding = m_layout->m_bindings[binding_index];
+            if (binding.type != write.type)
+            {
+                return set_error(BasicError::bad_arguments(), "The descriptor type written to binding slot %u does not match the descriptor set layout.", write.binding_slot);
+            }
+            u32 num_descs = binding.num_descs;
+            if (test_flags(m_layout->m_flags, DescriptorSetLayoutFlag::variable_descriptors))
+            {
+                // The variable-sized binding is the binding with the largest binding slot.
+                bool is_variable = true;
+                for (auto& b : m_layout->m_bindings)
+                {
+                    if (b.binding_slot > binding.binding_slot) is_variable = false;
+                }
+                if (is_variable) num_descs = m_num_variable_descriptors;
+            }
+            if ((u64)write.first_array_index + (u64)write.num_descs > (u64)num_descs)
+            {
+                return set_error(BasicError::out_of_range(), "Descriptors [%u, %u) written to binding slot %u exceed the number of descriptors of the binding (%u).",
+                    write.first_array_index, write.first_array_index + write.num_descs, write.binding_slot, num_descs);
+            }
+            for (u32 i = 0; i < write.num_descs; ++i)
+            {
+                switch (write.type)
+                {
+                case DescriptorType::uniform_buffer_view:
+                case DescriptorType::read_buffer_view:
+                case DescriptorType::read_write_buffer_view:
+                {
+                    const BufferViewDesc& view = write.buffer_views[i];
+                    if (!view.buffer) return set_error(BasicError::bad_arguments(), "The buffer written to binding slot %u must not be `nullptr`.", write.binding_slot);
+                    Buffer* buffer = cast_object<Buffer>(view.buffer->get_object());
+                    BufferUsageFlag required_usage = write.type == DescriptorType::uniform_buffer_view ? BufferUsageFlag::uniform_buffer :
+                        (write.type == DescriptorType::read_buffer_view ? BufferUsageFlag::read_buffer : BufferUsageFlag::read_write_buffer);
+                    if (!test_flags(buffer->m_desc.usages, required_usage))
+                    {
+                        return set_error(BasicError::bad_arguments(), "The buffer written to binding slot %u does not have the required usage flag.", write.binding_slot);
+                    }
+                    u64 begin, size;
+                    if (write.type == DescriptorType::uniform_buffer_view)
+                    {
+                        begin = view.first_element;
+                        size = view.element_size == U32_MAX ? buffer->m_desc.size - min(begin, buffer->m_desc.size) : view.element_size;
+                    }
+                    else
+                    {
+                        begin = view.first_element * view.element_size;
+                        size = (u64)view.element_count * view.element_size;
+                    }
+                    if (begin + size > buffer->m_desc.size)
+                    {
+                        return set_error(BasicError::out_of_range(), "The buffer view written to binding slot %u exceeds the buffer size.", write.binding_slot);
+                    }
+                    break;
+                }
+                case DescriptorType::read_texture_view:
+                case DescriptorType::read_write_texture_view:
+                {
+                    TextureViewDesc view = write.texture_views[i];
+                    if (!view.texture) return set_error(BasicError::bad_arguments(), "The texture written to binding slot %u must not be `nullptr`.", write.binding_slot);
+                    Texture* texture = cast_object<Texture>(view.texture->get_object());
+                    TextureUsageFlag required_usage = write.type == DescriptorType::read_texture_view ? 
+                        TextureUsageFlag::read_texture : TextureUsageFlag::read_write_texture;
+                    if (!test_flags(texture->m_desc.usages, required_usage))
+                    {
+                        return set_error(BasicError::bad_arguments(), "The texture written to binding slot %u does not have the required usage flag.", write.binding_slot);
+                    }
+                    validate_texture_view_desc(texture->m_desc, view);
+                    if (view.mip_slice + view.mip_size > texture->m_desc.mip_levels ||
+                        view.array_slice + view.array_size > texture->m_desc.array_size)
+                    {
+                        return set_error(BasicError::out_of_range(), "The texture view written to binding slot %u exceeds the subresource range of the texture.", write.binding_slot);
+                    }
+                    break;
+                }
+                case DescriptorType::sampler:
+                    break;
+                default: lupanic();
+                }
+            }
+            return ok;
+        }
+        RV DescriptorSet::update_descriptors(Span<const WriteDescriptorSet> writes)
+        {
+            lutry
+            {
+                for (auto& write : writes)
+                {
+                    luexp(validate_write(write));
+                }
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
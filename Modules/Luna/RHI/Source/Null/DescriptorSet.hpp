@@ -0,0 +1,35 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DescriptorSet.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "DescriptorSetLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The null backend does not store descriptors, descriptor writes are only validated.
+        struct DescriptorSet : IDescriptorSet
+        {
+            lustruct("RHI::DescriptorSet", "{89ad6f85-1e03-4043-8f10-5b905893d141}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<DescriptorSetLayout> m_layout;
+            u32 m_num_variable_descriptors;
+
+            RV init(const DescriptorSetDesc& desc);
+            RV validate_write(const WriteDescriptorSet& write);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual RV update_descriptors(Span<const WriteDescriptorSet> writes) override;
+        };
+    }
+}
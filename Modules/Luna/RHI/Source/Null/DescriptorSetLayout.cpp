@@ -0,0 +1,48 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DescriptorSetLayout.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "DescriptorSetLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV DescriptorSetLayout::init(const DescriptorSetLayoutDesc& desc)
+        {
+            m_flags = desc.flags;
+            m_bindings.assign(desc.bindings.begin(), desc.bindings.end());
+            for (usize i = 0; i < m_bindings.size(); ++i)
+            {
+                for (usize j = i + 1; j < m_bindings.size(); ++j)
+                {
+                    if (m_bindings[i].binding_slot == m_bindings[j].binding_slot)
+                    {
+                        return set_error(BasicError::bad_arguments(), "Binding slot %u is specified by more than one binding.", m_bindings[i].binding_slot);
+                    }
+                }
+                if (m_bindings[i].num_descs == 0)
+                {
+                    return set_error(BasicError::bad_arguments(), "The number of descriptors of binding slot %u must not be 0.", m_bindings[i].binding_slot);
+                }
+            }
+            if (test_flags(m_flags, DescriptorSetLayoutFlag::variable_descriptors))
+            {
+                if (m_bindings.empty())
+                {
+                    return set_error(BasicError::bad_arguments(), "DescriptorSetLayoutFlag::variable_descriptors requires at least one binding.");
+                }
+                if (!m_device->check_feature(DeviceFeature::unbound_descriptor_array).unbound_descriptor_array)
+                {
+                    return set_error(BasicError::not_supported(), "DescriptorSetLayoutFlag::variable_descriptors is not supported by the device.");
+                }
+            }
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DescriptorSetLayout.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct DescriptorSetLayout : IDescriptorSetLayout
+        {
+            lustruct("RHI::DescriptorSetLayout", "{4319e636-66cd-4ec2-8d87-5958eabbc4c4}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Vector<DescriptorSetLayoutBinding> m_bindings;
+            DescriptorSetLayoutFlag m_flags;
+
+            RV init(const DescriptorSetLayoutDesc& desc);
+
+            //! Finds the binding with the specified binding slot.
+            //! @return Returns the index of the binding in `m_bindings`, or `USIZE_MAX` if not found.
+            usize find_binding(u32 binding_slot) const
+            {
+                for (usize i = 0; i < m_bindings.size(); ++i)
+                {
+                    if (m_bindings[i].binding_slot == binding_slot) return i;
+                }
+                return USIZE_MAX;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+        };
+    }
+}
@@ -0,0 +1,329 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Device.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RHI_API LUNA_EXPORT
+#include "Device.hpp"
+#include "../RHI.hpp"
+#include "Adapter.hpp"
+#include "DeviceMemory.hpp"
+#include "Resource.hpp"
+#include "CommandBuffer.hpp"
+#include "PipelineLayout.hpp"
+#include "PipelineState.hpp"
+#include "DescriptorSetLayout.hpp"
+#include "DescriptorSet.hpp"
+#include "QueryHeap.hpp"
+#include "Fence.hpp"
+#include "SwapChain.hpp"
+#include <Luna/Runtime/Time.hpp>
+namespace Luna
+{
+    namespace RHI
+    {
+        RV Device::init()
+        {
+            CommandQueueDesc desc;
+            desc.type = CommandQueueType::graphics;
+            desc.flags = CommandQueueFlag::presenting;
+            m_queues.push_back(desc);
+            desc.type = CommandQueueType::compute;
+            desc.flags = CommandQueueFlag::none;
+            m_queues.push_back(desc);
+            m_queues.push_back(desc);
+            desc.type = CommandQueueType::copy;
+            m_queues.push_back(desc);
+            m_queues.push_back(desc);
+            return ok;
+        }
+        u64 Device::get_buffer_size(const BufferDesc& desc)
+        {
+            return align_upper(desc.size, NULL_RESOURCE_DATA_ALIGNMENT);
+        }
+        u64 Device::get_texture_size(const TextureDesc& desc)
+        {
+            TextureDesc validated_desc = desc;
+            if (failed(validate_texture_desc(validated_desc))) return 0;
+            return calc_texture_layout(validated_desc, nullptr);
+        }
+        RV Device::validate_memory(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            if (memory_type != MemoryType::local && !textures.empty())
+            {
+                return set_error(BasicError::not_supported(), "Textures cannot be created in upload or readback heaps.");
+            }
+            return ok;
+        }
+        DeviceFeatureData Device::check_feature(DeviceFeature feature)
+        {
+            DeviceFeatureData ret;
+            switch (feature)
+            {
+            case DeviceFeature::unbound_descriptor_array:
+                ret.unbound_descriptor_array = true;
+                break;
+            case DeviceFeature::pixel_shader_write:
+                ret.pixel_shader_write = true;
+                break;
+            case DeviceFeature::uniform_buffer_data_alignment:
+                ret.uniform_buffer_data_alignment = 0;
+                break;
+            case DeviceFeature::draw_indirect_count:
+                ret.draw_indirect_count = true;
+                break;
+            default: lupanic();
+            }
+            return ret;
+        }
+        void Device::get_texture_data_placement_info(u32 width, u32 height, u32 depth, Format format,
+            u64* size, u64* alignment, u64* row_pitch, u64* slice_pitch)
+        {
+            u64 d_row_pitch, d_slice_pitch, d_size;
+            calc_texture_data_placement(width, height, depth, format, d_row_pitch, d_slice_pitch, d_size);
+            if (size) *size = d_size;
+            if (alignment) *alignment = NULL_RESOURCE_DATA_ALIGNMENT;
+            if (row_pitch) *row_pitch = d_row_pitch;
+            if (slice_pitch) *slice_pitch = d_slice_pitch;
+        }
+        R<Ref<IBuffer>> Device::new_buffer(MemoryType memory_type, const BufferDesc& desc)
+        {
+            Ref<IBuffer> ret;
+            lutry
+            {
+                Ref<Buffer> buffer = new_object<Buffer>();
+                buffer->m_device = this;
+                luexp(buffer->init_as_committed(memory_type, desc));
+                ret = buffer;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<ITexture>> Device::new_texture(MemoryType memory_type, const TextureDesc& desc, const ClearValue* optimized_clear_value)
+        {
+            Ref<ITexture> ret;
+            lutry
+            {
+                Ref<Texture> texture = new_object<Texture>();
+                texture->m_device = this;
+                luexp(texture->init_as_committed(memory_type, desc));
+                ret = texture;
+            }
+            lucatchret;
+            return ret;
+        }
+        bool Device::is_resources_aliasing_compatible(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            return succeeded(validate_memory(memory_type, buffers, textures));
+        }
+        R<Ref<IDeviceMemory>> Device::allocate_memory(MemoryType memory_type, Span<const BufferDesc> buffers, Span<const TextureDesc> textures)
+        {
+            Ref<IDeviceMemory> ret;
+            lutry
+            {
+                luexp(validate_memory(memory_type, buffers, textures));
+                u64 size = 0;
+                for (auto& buffer : buffers)
+                {
+                    size = max(size, get_buffer_size(buffer));
+                }
+                for (auto& texture : textures)
+                {
+                    size = max(size, get_texture_size(texture));
+                }
+                Ref<DeviceMemory> memory = new_object<DeviceMemory>();
+                memory->m_device = this;
+                luexp(memory->init(memory_type, size));
+                ret = memory;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IBuffer>> Device::new_aliasing_buffer(IDeviceMemory* device_memory, const BufferDesc& desc)
+        {
+            Ref<IBuffer> ret;
+            lutry
+            {
+                Ref<Buffer> buffer = new_object<Buffer>();
+                buffer->m_device = this;
+                luexp(buffer->init_as_aliasing(device_memory, desc));
+                ret = buffer;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<ITexture>> Device::new_aliasing_texture(IDeviceMemory* device_memory, const TextureDesc& desc, const ClearValue* optimized_clear_value)
+        {
+            Ref<ITexture> ret;
+            lutry
+            {
+                Ref<Texture> texture = new_object<Texture>();
+                texture->m_device = this;
+                luexp(texture->init_as_aliasing(device_memory, desc));
+                ret = texture;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IPipelineLayout>> Device::new_pipeline_layout(const PipelineLayoutDesc& desc)
+        {
+            Ref<IPipelineLayout> ret;
+            lutry
+            {
+                Ref<PipelineLayout> o = new_object<PipelineLayout>();
+                o->m_device = this;
+                luexp(o->init(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IPipelineState>> Device::new_graphics_pipeline_state(const GraphicsPipelineStateDesc& desc)
+        {
+            Ref<IPipelineState> ret;
+            lutry
+            {
+                Ref<PipelineState> o = new_object<PipelineState>();
+                o->m_device = this;
+                luexp(o->init_as_graphics(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IPipelineState>> Device::new_compute_pipeline_state(const ComputePipelineStateDesc& desc)
+        {
+            Ref<IPipelineState> ret;
+            lutry
+            {
+                Ref<PipelineState> o = new_object<PipelineState>();
+                o->m_device = this;
+                luexp(o->init_as_compute(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IDescriptorSetLayout>> Device::new_descriptor_set_layout(const DescriptorSetLayoutDesc& desc)
+        {
+            Ref<IDescriptorSetLayout> ret;
+            lutry
+            {
+                Ref<DescriptorSetLayout> o = new_object<DescriptorSetLayout>();
+                o->m_device = this;
+                luexp(o->init(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IDescriptorSet>> Device::new_descriptor_set(const DescriptorSetDesc& desc)
+        {
+            Ref<IDescriptorSet> ret;
+            lutry
+            {
+                Ref<DescriptorSet> o = new_object<DescriptorSet>();
+                o->m_device = this;
+                luexp(o->init(desc));
+                ret = o;
+            }
+            lucatchret;
+            return ret;
+        }
+        u32 Device::get_num_command_queues()
+        {
+            return (u32)m_queues.size();
+        }
+        CommandQueueDesc Device::get_command_queue_desc(u32 command_queue_index)
+        {
+            lucheck(command_queue_index < m_queues.size());
+            return m_queues[command_queue_index];
+        }
+        R<Ref<ICommandBuffer>> Device::new_command_buffer(u32 command_queue_index)
+        {
+            Ref<ICommandBuffer> ret;
+            lutry
+            {
+                Ref<CommandBuffer> buf = new_object<CommandBuffer>();
+                buf->m_device = this;
+                luexp(buf->init(command_queue_index));
+                ret = buf;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<f64> Device::get_command_queue_timestamp_frequency(u32 command_queue_index)
+        {
+            if (command_queue_index >= m_queues.size())
+            {
+                return set_error(BasicError::bad_arguments(), "Invalid command queue index %u.", command_queue_index);
+            }
+            // Timestamps are written using CPU ticks when command buffers are submitted.
+            return (f64)get_ticks_per_second();
+        }
+        R<Ref<IQueryHeap>> Device::new_query_heap(const QueryHeapDesc& desc)
+        {
+            Ref<IQueryHeap> ret;
+            lutry
+            {
+                Ref<QueryHeap> heap = new_object<QueryHeap>();
+                heap->m_device = this;
+                luexp(heap->init(desc));
+                ret = heap;
+            }
+            lucatchret;
+            return ret;
+        }
+        R<Ref<IFence>> Device::new_fence()
+        {
+            Ref<Fence> fence = new_object<Fence>();
+            fence->m_device = this;
+            return Ref<IFence>(fence);
+        }
+        R<Ref<ISwapChain>> Device::new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc)
+        {
+            Ref<ISwapChain> ret;
+            lutry
+            {
+                Ref<SwapChain> swap_chain = new_object<SwapChain>();
+                swap_chain->m_device = this;
+                luexp(swap_chain->init(command_queue_index, window, desc));
+                ret = swap_chain;
+            }
+            lucatchret;
+            return ret;
+        }
+        LUNA_RHI_API R<Ref<IDevice>> new_device(IAdapter* adapter)
+        {
+            Adapter* ada = cast_object<Adapter>(adapter->get_object());
+            Ref<Device> dev = new_object<Device>();
+            dev->m_execute_copies = ada->m_execute_copies;
+            auto r = dev->init();
+            if (failed(r)) return r.errcode();
+            return Ref<IDevice>(dev);
+        }
+        Ref<IDevice> g_main_device;
+        LUNA_RHI_API IDevice* get_main_device()
+        {
+            return g_main_device.get();
+        }
+        RV init_main_device()
+        {
+            if (!g_main_device)
+            {
+                lutry
+                {
+                    lulet(dev, new_device(g_adapters[0]));
+                    g_main_device = dev;
+                }
+                lucatchret;
+            }
+            return ok;
+        }
+    }
+}
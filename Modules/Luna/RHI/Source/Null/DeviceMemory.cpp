@@ -0,0 +1,34 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DeviceMemory.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "DeviceMemory.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV DeviceMemory::init(MemoryType memory_type, u64 size)
+        {
+            m_memory_type = memory_type;
+            m_size = size;
+            // Allocates at least one byte so that empty resources still have valid addresses.
+            m_data = (byte_t*)memalloc((usize)max<u64>(size, 1), NULL_RESOURCE_DATA_ALIGNMENT);
+            if (!m_data) return BasicError::out_of_memory();
+            return ok;
+        }
+        DeviceMemory::~DeviceMemory()
+        {
+            if (m_data)
+            {
+                memfree(m_data, NULL_RESOURCE_DATA_ALIGNMENT);
+                m_data = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file DeviceMemory.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The device memory is allocated from system memory.
+        struct DeviceMemory : IDeviceMemory
+        {
+            lustruct("RHI::DeviceMemory", "{041ac47c-74dc-4463-8924-02defffa1032}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            byte_t* m_data = nullptr;
+            MemoryType m_memory_type;
+            u64 m_size;
+
+            RV init(MemoryType memory_type, u64 size);
+            ~DeviceMemory();
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual MemoryType get_memory_type() override { return m_memory_type; }
+            virtual u64 get_size() override { return m_size; }
+        };
+    }
+}
@@ -0,0 +1,29 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Fence.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Command buffers are executed when they are submitted, so fences do not need to do anything.
+        struct Fence : IFence
+        {
+            lustruct("RHI::Fence", "{75bb4569-947b-45f7-bfc8-aff9e5157471}");
+            luiimpl();
+
+            Ref<Device> m_device;
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+        };
+    }
+}
@@ -0,0 +1,41 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file PipelineLayout.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "DescriptorSetLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct PipelineLayout : IPipelineLayout
+        {
+            lustruct("RHI::PipelineLayout", "{6bea66db-7ee0-479f-86c1-a8ced085f40d}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Vector<Ref<DescriptorSetLayout>> m_descriptor_set_layouts;
+            PipelineLayoutFlag m_flags;
+
+            RV init(const PipelineLayoutDesc& desc)
+            {
+                m_flags = desc.flags;
+                for (IDescriptorSetLayout* layout : desc.descriptor_set_layouts)
+                {
+                    if (!layout) return set_error(BasicError::bad_arguments(), "Descriptor set layouts of one pipeline layout must not be `nullptr`.");
+                    m_descriptor_set_layouts.push_back(cast_object<DescriptorSetLayout>(layout->get_object()));
+                }
+                return ok;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+        };
+    }
+}
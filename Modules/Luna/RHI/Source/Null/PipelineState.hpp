@@ -0,0 +1,51 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file PipelineState.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "PipelineLayout.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The null backend does not compile shaders, pipeline states only store the information 
+        //! used to validate commands.
+        struct PipelineState : IPipelineState
+        {
+            lustruct("RHI::PipelineState", "{2a52115c-2ebb-45c7-8aea-e87eeffaed22}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<PipelineLayout> m_pipeline_layout;
+            bool m_is_graphics;
+
+            RV init_as_graphics(const GraphicsPipelineStateDesc& desc)
+            {
+                if (!desc.pipeline_layout) return set_error(BasicError::bad_arguments(), "GraphicsPipelineStateDesc::pipeline_layout must not be `nullptr`.");
+                if (desc.num_color_attachments > 8)
+                {
+                    return set_error(BasicError::bad_arguments(), "GraphicsPipelineStateDesc::num_color_attachments (%u) must not be greater than 8.", (u32)desc.num_color_attachments);
+                }
+                m_pipeline_layout = cast_object<PipelineLayout>(desc.pipeline_layout->get_object());
+                m_is_graphics = true;
+                return ok;
+            }
+            RV init_as_compute(const ComputePipelineStateDesc& desc)
+            {
+                if (!desc.pipeline_layout) return set_error(BasicError::bad_arguments(), "ComputePipelineStateDesc::pipeline_layout must not be `nullptr`.");
+                m_pipeline_layout = cast_object<PipelineLayout>(desc.pipeline_layout->get_object());
+                m_is_graphics = false;
+                return ok;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+        };
+    }
+}
@@ -0,0 +1,73 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file QueryHeap.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Device.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! Query values are written when command buffers are submitted. Timestamps are CPU ticks, 
+        //! occlusion queries always report visible (1), and pipeline statistics are always 0.
+        struct QueryHeap : IQueryHeap
+        {
+            lustruct("RHI::QueryHeap", "{e326b3d4-bb2a-446d-8f5e-bc49c9951c65}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            QueryHeapDesc m_desc;
+            Vector<u64> m_values;
+            Vector<PipelineStatistics> m_pipeline_statistics;
+
+            RV init(const QueryHeapDesc& desc)
+            {
+                m_desc = desc;
+                if (desc.type == QueryType::pipeline_statistics)
+                {
+                    PipelineStatistics stat;
+                    memzero(&stat, sizeof(PipelineStatistics));
+                    m_pipeline_statistics.resize(desc.count, stat);
+                }
+                else
+                {
+                    m_values.resize(desc.count, 0);
+                }
+                return ok;
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual QueryHeapDesc get_desc() override { return m_desc; }
+            virtual RV get_timestamp_values(u32 index, u32 count, u64* values) override
+            {
+                if (m_desc.type != QueryType::timestamp && m_desc.type != QueryType::timestamp_copy_queue) return BasicError::not_supported();
+                return get_values(index, count, values);
+            }
+            virtual RV get_occlusion_values(u32 index, u32 count, u64* values) override
+            {
+                if (m_desc.type != QueryType::occlusion) return BasicError::not_supported();
+                return get_values(index, count, values);
+            }
+            virtual RV get_pipeline_statistics_values(u32 index, u32 count, PipelineStatistics* values) override
+            {
+                if (m_desc.type != QueryType::pipeline_statistics) return BasicError::not_supported();
+                if ((u64)index + count > m_desc.count) return BasicError::out_of_range();
+                memcpy(values, m_pipeline_statistics.data() + index, sizeof(PipelineStatistics) * count);
+                return ok;
+            }
+            RV get_values(u32 index, u32 count, u64* values)
+            {
+                if ((u64)index + count > m_desc.count) return BasicError::out_of_range();
+                memcpy(values, m_values.data() + index, sizeof(u64) * count);
+                return ok;
+            }
+        };
+    }
+}
@@ -0,0 +1,102 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Resource.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "Resource.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV Buffer::init_as_committed(MemoryType memory_type, const BufferDesc& desc)
+        {
+            lutry
+            {
+                m_desc = desc;
+                m_memory = new_object<DeviceMemory>();
+                m_memory->m_device = m_device;
+                luexp(m_memory->init(memory_type, m_device->get_buffer_size(desc)));
+            }
+            lucatchret;
+            return ok;
+        }
+        RV Buffer::init_as_aliasing(IDeviceMemory* memory, const BufferDesc& desc)
+        {
+            m_desc = desc;
+            DeviceMemory* mem = cast_object<DeviceMemory>(memory->get_object());
+            if (m_device->get_buffer_size(desc) > mem->m_size)
+            {
+                return set_error(BasicError::bad_arguments(), "The device memory (%llu bytes) is too small to store the buffer (%llu bytes).",
+                    mem->m_size, desc.size);
+            }
+            m_memory = mem;
+            return ok;
+        }
+        RV Buffer::map(usize read_begin, usize read_end, void** data)
+        {
+            if (m_memory->m_memory_type == MemoryType::local)
+            {
+                return set_error(BasicError::not_supported(), "Buffers in local memory cannot be mapped.");
+            }
+            if (data) *data = get_data();
+            return ok;
+        }
+        u64 calc_texture_layout(const TextureDesc& desc, Vector<u64>* subresource_offsets)
+        {
+            u64 size = 0;
+            if (subresource_offsets) subresource_offsets->resize(desc.mip_levels * desc.array_size);
+            for (u32 array_slice = 0; array_slice < desc.array_size; ++array_slice)
+            {
+                for (u32 mip_slice = 0; mip_slice < desc.mip_levels; ++mip_slice)
+                {
+                    u64 row_pitch, slice_pitch, subresource_size;
+                    calc_texture_data_placement(max<u32>(desc.width >> mip_slice, 1), max<u32>(desc.height >> mip_slice, 1), max<u32>(desc.depth >> mip_slice, 1),
+                        desc.format, row_pitch, slice_pitch, subresource_size);
+                    size = align_upper(size, NULL_RESOURCE_DATA_ALIGNMENT);
+                    if (subresource_offsets) (*subresource_offsets)[mip_slice + array_slice * desc.mip_levels] = size;
+                    size += subresource_size * desc.sample_count;
+                }
+            }
+            return size;
+        }
+        RV Texture::init_as_committed(MemoryType memory_type, const TextureDesc& desc)
+        {
+            lutry
+            {
+                m_desc = desc;
+                luexp(validate_texture_desc(m_desc));
+                luexp(m_device->validate_memory(memory_type, Span<const BufferDesc>(), Span<const TextureDesc>(&m_desc, 1)));
+                u64 size = calc_texture_layout(m_desc, &m_subresource_offsets);
+                m_memory = new_object<DeviceMemory>();
+                m_memory->m_device = m_device;
+                luexp(m_memory->init(memory_type, size));
+            }
+            lucatchret;
+            return ok;
+        }
+        RV Texture::init_as_aliasing(IDeviceMemory* memory, const TextureDesc& desc)
+        {
+            lutry
+            {
+                m_desc = desc;
+                luexp(validate_texture_desc(m_desc));
+                DeviceMemory* mem = cast_object<DeviceMemory>(memory->get_object());
+                luexp(m_device->validate_memory(mem->m_memory_type, Span<const BufferDesc>(), Span<const TextureDesc>(&m_desc, 1)));
+                u64 size = calc_texture_layout(m_desc, &m_subresource_offsets);
+                if (size > mem->m_size)
+                {
+                    return set_error(BasicError::bad_arguments(), "The device memory (%llu bytes) is too small to store the texture (%llu bytes).",
+                        mem->m_size, size);
+                }
+                m_memory = mem;
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
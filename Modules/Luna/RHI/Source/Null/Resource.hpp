@@ -0,0 +1,82 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Resource.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "DeviceMemory.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        struct Buffer : IBuffer
+        {
+            lustruct("RHI::Buffer", "{be105260-1c3e-4cec-9406-50f600aa3fd7}");
+            luiimpl();
+
+            Ref<Device> m_device;
+
+            BufferDesc m_desc;
+            Ref<DeviceMemory> m_memory;
+
+            RV init_as_committed(MemoryType memory_type, const BufferDesc& desc);
+            RV init_as_aliasing(IDeviceMemory* memory, const BufferDesc& desc);
+
+            byte_t* get_data() const { return m_memory->m_data; }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual IDeviceMemory* get_memory() override { return m_memory; }
+            virtual BufferDesc get_desc() override { return m_desc; }
+            virtual RV map(usize read_begin, usize read_end, void** data) override;
+            virtual void unmap(usize write_begin, usize write_end) override {}
+        };
+
+        //! Computes the memory size and the data offset of every subresource of one texture.
+        //! Subresources are stored in `mip_slice + array_slice * mip_levels` order, and the data of every 
+        //! subresource is tightly packed in the same layout as `get_texture_data_placement_info`.
+        u64 calc_texture_layout(const TextureDesc& desc, Vector<u64>* subresource_offsets);
+
+        struct Texture : ITexture
+        {
+            lustruct("RHI::Texture", "{7360bfb1-15fa-4059-8fc8-d4b522aa1bed}");
+            luiimpl();
+
+            Ref<Device> m_device;
+
+            TextureDesc m_desc;
+            Ref<DeviceMemory> m_memory;
+            Vector<u64> m_subresource_offsets;
+
+            RV init_as_committed(MemoryType memory_type, const TextureDesc& desc);
+            RV init_as_aliasing(IDeviceMemory* memory, const TextureDesc& desc);
+
+            u32 count_subresources() const
+            {
+                return m_desc.mip_levels * m_desc.array_size;
+            }
+            bool is_valid_subresource(const SubresourceIndex& subresource) const
+            {
+                return subresource.mip_slice < m_desc.mip_levels && subresource.array_slice < m_desc.array_size;
+            }
+            UInt3U get_mip_size(u32 mip_slice) const
+            {
+                return UInt3U(max<u32>(m_desc.width >> mip_slice, 1), max<u32>(m_desc.height >> mip_slice, 1), max<u32>(m_desc.depth >> mip_slice, 1));
+            }
+            byte_t* get_subresource_data(const SubresourceIndex& subresource) const
+            {
+                return m_memory->m_data + m_subresource_offsets[subresource.mip_slice + subresource.array_slice * m_desc.mip_levels];
+            }
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual IDeviceMemory* get_memory() override { return m_memory; }
+            virtual TextureDesc get_desc() override { return m_desc; }
+        };
+    }
+}
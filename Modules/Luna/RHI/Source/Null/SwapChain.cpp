@@ -0,0 +1,66 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file SwapChain.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "SwapChain.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        RV SwapChain::init(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc)
+        {
+            if (command_queue_index >= m_device->m_queues.size() || 
+                !test_flags(m_device->m_queues[command_queue_index].flags, CommandQueueFlag::presenting))
+            {
+                return set_error(BasicError::bad_arguments(), "The command queue %u does not support presenting.", command_queue_index);
+            }
+            m_window = window;
+            m_command_queue_index = command_queue_index;
+            return reset(desc);
+        }
+        R<ITexture*> SwapChain::get_current_back_buffer()
+        {
+            return (ITexture*)m_back_buffers[m_current_back_buffer].get();
+        }
+        RV SwapChain::present()
+        {
+            m_current_back_buffer = (m_current_back_buffer + 1) % (u32)m_back_buffers.size();
+            return ok;
+        }
+        RV SwapChain::reset(const SwapChainDesc& desc)
+        {
+            lutry
+            {
+                SwapChainDesc new_desc = desc;
+                if (new_desc.width == 0 || new_desc.height == 0)
+                {
+                    if (!m_window) return set_error(BasicError::bad_arguments(), "The swap chain size must be specified if the swap chain is not bound to one window.");
+                    auto framebuffer_size = m_window->get_framebuffer_size();
+                    new_desc.width = new_desc.width == 0 ? framebuffer_size.x : new_desc.width;
+                    new_desc.height = new_desc.height == 0 ? framebuffer_size.y : new_desc.height;
+                }
+                new_desc.format = new_desc.format == Format::unknown ? Format::bgra8_unorm : new_desc.format;
+                new_desc.buffer_count = new_desc.buffer_count == 0 ? 2 : new_desc.buffer_count;
+                m_back_buffers.clear();
+                for (u32 i = 0; i < new_desc.buffer_count; ++i)
+                {
+                    Ref<Texture> back_buffer = new_object<Texture>();
+                    back_buffer->m_device = m_device;
+                    luexp(back_buffer->init_as_committed(MemoryType::local, 
+                        TextureDesc::tex2d(new_desc.format, TextureUsageFlag::color_attachment | TextureUsageFlag::copy_dest, new_desc.width, new_desc.height, 1, 1)));
+                    m_back_buffers.push_back(move(back_buffer));
+                }
+                m_desc = new_desc;
+                m_current_back_buffer = 0;
+            }
+            lucatchret;
+            return ok;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file SwapChain.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Resource.hpp"
+
+namespace Luna
+{
+    namespace RHI
+    {
+        //! The swap chain stores back buffers in system memory and does not display them.
+        struct SwapChain : ISwapChain
+        {
+            lustruct("RHI::SwapChain", "{1cdd5a9c-11d6-4594-96e8-b25e462dfcd8}");
+            luiimpl();
+
+            Ref<Device> m_device;
+            Ref<Window::IWindow> m_window;
+            SwapChainDesc m_desc;
+            u32 m_command_queue_index;
+
+            Vector<Ref<Texture>> m_back_buffers;
+            u32 m_current_back_buffer = 0;
+
+            RV init(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc);
+
+            virtual IDevice* get_device() override { return m_device; }
+            virtual void set_name(const c8* name) override {}
+            virtual Window::IWindow* get_window() override { return m_window; }
+            virtual SwapChainDesc get_desc() override { return m_desc; }
+            virtual R<ITexture*> get_current_back_buffer() override;
+            virtual RV present() override;
+            virtual RV reset(const SwapChainDesc& desc) override;
+        };
+    }
+}
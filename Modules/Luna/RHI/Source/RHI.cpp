@@ -12,6 +12,8 @@
 #include "RHI.hpp"
 #include <Luna/Runtime/Module.hpp>
 #include "../DescriptorSet.hpp"
+#include "CopyResourceData.hpp"
+#include "AsyncPipelineState.hpp"
 namespace Luna
 {
 	namespace RHI
@@ -21,10 +23,14 @@ namespace Luna
 			virtual const c8* get_name() override { return "RHI"; }
 			virtual RV on_register() override
 			{
-				return add_dependency_module(this, module_window());
+				return add_dependency_modules(this, {module_window(), module_job_system()});
 			}
 			virtual RV on_init() override
 			{
+				register_boxed_type<ResourceDataCopier>();
+				impl_interface_for_type<ResourceDataCopier, IResourceDataCopier>();
+				register_boxed_type<PipelineStateFuture>();
+				impl_interface_for_type<PipelineStateFuture, IPipelineStateFuture, IWaitable>();
 				return render_api_init();
 			}
 			virtual void on_close() override
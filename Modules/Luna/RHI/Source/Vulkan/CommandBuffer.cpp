@@ -117,12 +117,14 @@ namespace Luna
 				luexp(begin_command_buffer());
 				m_track_system.m_queue_type = m_queue.desc.type;
 				m_track_system.m_queue_family_index = m_queue.queue_family_index;
+				m_track_system.init(m_device);
 			}
 			lucatchret;
 			return ok;
 		}
 		CommandBuffer::~CommandBuffer()
 		{
+			auto r = reset_transient_descriptor_sets();
 			for (VkFramebuffer fbo : m_fbos)
 			{
 				m_device->m_funcs.vkDestroyFramebuffer(m_device->m_device, fbo, nullptr);
@@ -222,6 +224,7 @@ namespace Luna
 				luexp(begin_command_buffer());
 				m_track_system.reset();
 				m_objs.clear();
+				luexp(reset_transient_descriptor_sets());
 				m_rt_width = 0;
 				m_rt_height = 0;
 				m_graphics_pipeline_layout = nullptr;
@@ -239,6 +242,77 @@ namespace Luna
 		{
 			m_objs.push_back(obj);
 		}
+		RV CommandBuffer::reset_transient_descriptor_sets()
+		{
+			for (usize i = 0; i < m_num_transient_desc_sets; ++i)
+			{
+				DescriptorSet* set = m_transient_desc_sets[i];
+				set->m_desc_set = VK_NULL_HANDLE;
+				set->m_layout.reset();
+				set->m_samplers.clear();
+			}
+			m_num_transient_desc_sets = 0;
+			m_transient_desc_set_cache.clear();
+			RV r = ok;
+			for (VkDescriptorPool pool : m_transient_desc_pools)
+			{
+				auto res = encode_vk_result(m_device->m_funcs.vkResetDescriptorPool(m_device->m_device, pool, 0));
+				if (failed(res)) r = res;
+			}
+			m_device->release_transient_descriptor_pools(Span<const VkDescriptorPool>(m_transient_desc_pools.data(), m_transient_desc_pools.size()));
+			m_transient_desc_pools.clear();
+			return r;
+		}
+		R<IDescriptorSet*> CommandBuffer::allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes)
+		{
+			DescriptorSet* ret = nullptr;
+			lutry
+			{
+				DescriptorSetLayout* layout = cast_object<DescriptorSetLayout>(desc.layout->get_object());
+				if (test_flags(layout->m_desc.flags, DescriptorSetLayoutFlag::variable_descriptors))
+				{
+					return BasicError::not_supported();
+				}
+				u64 hash = m_transient_desc_set_cache.encode_key(desc.layout, writes);
+				IDescriptorSet* cached = m_transient_desc_set_cache.find(hash);
+				if (cached) return cached;
+				// Allocates from the last pool, and acquires one new pool if the last pool is full.
+				VkDescriptorSetAllocateInfo alloc_info{};
+				alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+				alloc_info.descriptorSetCount = 1;
+				alloc_info.pSetLayouts = &layout->m_layout;
+				VkDescriptorSet desc_set = VK_NULL_HANDLE;
+				VkResult r = VK_ERROR_OUT_OF_POOL_MEMORY;
+				if (!m_transient_desc_pools.empty())
+				{
+					alloc_info.descriptorPool = m_transient_desc_pools.back();
+					r = m_device->m_funcs.vkAllocateDescriptorSets(m_device->m_device, &alloc_info, &desc_set);
+				}
+				if (r == VK_ERROR_OUT_OF_POOL_MEMORY || r == VK_ERROR_FRAGMENTED_POOL)
+				{
+					lulet(pool, m_device->acquire_transient_descriptor_pool());
+					m_transient_desc_pools.push_back(pool);
+					alloc_info.descriptorPool = pool;
+					r = m_device->m_funcs.vkAllocateDescriptorSets(m_device->m_device, &alloc_info, &desc_set);
+				}
+				luexp(encode_vk_result(r));
+				if (m_num_transient_desc_sets == m_transient_desc_sets.size())
+				{
+					Ref<DescriptorSet> set = new_object<DescriptorSet>();
+					set->m_device = m_device;
+					set->m_transient = true;
+					m_transient_desc_sets.push_back(move(set));
+				}
+				ret = m_transient_desc_sets[m_num_transient_desc_sets];
+				++m_num_transient_desc_sets;
+				ret->m_layout = layout;
+				ret->m_desc_set = desc_set;
+				luexp(ret->update_descriptors(writes));
+				m_transient_desc_set_cache.insert(hash, ret);
+			}
+			lucatchret;
+			return ret;
+		}
 		void CommandBuffer::begin_event(const c8* event_name)
 		{
 			if (g_enable_validation_layer)
@@ -633,6 +707,52 @@ namespace Luna
 			m_device->m_funcs.vkCmdDrawIndexed(m_command_buffer, index_count_per_instance * instance_count, instance_count, 
 				start_index_location, base_vertex_location, start_instance_location);
 		}
+		void CommandBuffer::draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+			IBuffer* count_buffer, u64 count_buffer_offset)
+		{
+			assert_graphcis_context();
+			BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+			if (count_buffer)
+			{
+				lucheck_msg(m_device->m_draw_indirect_count_supported, "DeviceFeature::draw_indirect_count is not supported.");
+				BufferResource* c = cast_object<BufferResource>(count_buffer->get_object());
+				m_device->m_funcs.vkCmdDrawIndirectCountKHR(m_command_buffer, b->m_buffer, offset, c->m_buffer, count_buffer_offset, max_draw_count, stride);
+			}
+			else if (m_device->m_physical_device_features.multiDrawIndirect || max_draw_count <= 1)
+			{
+				m_device->m_funcs.vkCmdDrawIndirect(m_command_buffer, b->m_buffer, offset, max_draw_count, stride);
+			}
+			else
+			{
+				for (u32 i = 0; i < max_draw_count; ++i)
+				{
+					m_device->m_funcs.vkCmdDrawIndirect(m_command_buffer, b->m_buffer, offset + (u64)i * stride, 1, stride);
+				}
+			}
+		}
+		void CommandBuffer::draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+			IBuffer* count_buffer, u64 count_buffer_offset)
+		{
+			assert_graphcis_context();
+			BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+			if (count_buffer)
+			{
+				lucheck_msg(m_device->m_draw_indirect_count_supported, "DeviceFeature::draw_indirect_count is not supported.");
+				BufferResource* c = cast_object<BufferResource>(count_buffer->get_object());
+				m_device->m_funcs.vkCmdDrawIndexedIndirectCountKHR(m_command_buffer, b->m_buffer, offset, c->m_buffer, count_buffer_offset, max_draw_count, stride);
+			}
+			else if (m_device->m_physical_device_features.multiDrawIndirect || max_draw_count <= 1)
+			{
+				m_device->m_funcs.vkCmdDrawIndexedIndirect(m_command_buffer, b->m_buffer, offset, max_draw_count, stride);
+			}
+			else
+			{
+				for (u32 i = 0; i < max_draw_count; ++i)
+				{
+					m_device->m_funcs.vkCmdDrawIndexedIndirect(m_command_buffer, b->m_buffer, offset + (u64)i * stride, 1, stride);
+				}
+			}
+		}
 		void CommandBuffer::begin_occlusion_query(OcclusionQueryMode mode, u32 index)
 		{
 			assert_graphcis_context();
@@ -722,6 +842,12 @@ namespace Luna
 			assert_compute_context();
 			m_device->m_funcs.vkCmdDispatch(m_command_buffer, thread_group_count_x, thread_group_count_y, thread_group_count_z);
 		}
+		void CommandBuffer::dispatch_indirect(IBuffer* buffer, u64 offset)
+		{
+			assert_compute_context();
+			BufferResource* b = cast_object<BufferResource>(buffer->get_object());
+			m_device->m_funcs.vkCmdDispatchIndirect(m_command_buffer, b->m_buffer, offset);
+		}
 		void CommandBuffer::end_compute_pass()
 		{
 			lucheck_msg(m_compute_pass_begin, "Calling end_compute_pass without prior call to begin_compute_pass.");
@@ -963,7 +1089,7 @@ namespace Luna
 				Vector<VkPipelineStageFlags> wait_stages;
 
 				bool resolve_enabled = false;
-				if (!m_track_system.m_unresolved_image_states.empty() || !m_track_system.m_unresolved_buffer_states.empty())
+				if (!m_track_system.m_unresolved_image_barriers.empty() || !m_track_system.m_unresolved_buffer_barriers.empty())
 				{
 					// Resolve image states.
 					m_track_system.resolve();
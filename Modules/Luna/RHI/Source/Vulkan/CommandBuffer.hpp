@@ -12,6 +12,8 @@
 #include "../../CommandBuffer.hpp"
 #include "Device.hpp"
 #include "ResourceStateTrackingSystem.hpp"
+#include "DescriptorSet.hpp"
+#include "../DescriptorSetCache.hpp"
 #include <Luna/Runtime/UniquePtr.hpp>
 
 namespace Luna
@@ -51,6 +53,13 @@ namespace Luna
 			// The attached graphic objects.
 			Vector<Ref<IDeviceChild>> m_objs;
 
+			// Descriptor pools for transient descriptor sets, which are reset and returned to the device on `reset`.
+			Vector<VkDescriptorPool> m_transient_desc_pools;
+			// Transient descriptor set objects. Objects are reused after `reset` to avoid allocating them every frame.
+			Vector<Ref<DescriptorSet>> m_transient_desc_sets;
+			usize m_num_transient_desc_sets = 0;
+			TransientDescriptorSetCache m_transient_desc_set_cache;
+
 			// Controled by begin_render_pass/end_render_pass.
 			bool m_render_pass_begin = false;
 			u32 m_rt_width = 0;
@@ -83,6 +92,7 @@ namespace Luna
 			RV begin_command_buffer();
 
 			R<QueueTransferTracker*> get_transfer_tracker(u32 queue_family_index);
+			RV reset_transient_descriptor_sets();
 
 			void assert_graphcis_context()
 			{
@@ -111,6 +121,7 @@ namespace Luna
 			virtual u32 get_command_queue_index() override { return m_queue_index; }
 			virtual RV reset() override;
 			virtual void attach_device_object(IDeviceChild* obj) override;
+			virtual R<IDescriptorSet*> allocate_transient_descriptor_set(const DescriptorSetDesc& desc, Span<const WriteDescriptorSet> writes) override;
 			virtual void begin_event(const c8* event_name) override;
 			virtual void end_event() override;
 			virtual void begin_render_pass(const RenderPassDesc& desc) override;
@@ -135,6 +146,10 @@ namespace Luna
 				u32 start_instance_location) override;
 			virtual void draw_indexed_instanced(u32 index_count_per_instance, u32 instance_count, u32 start_index_location,
 				i32 base_vertex_location, u32 start_instance_location) override;
+			virtual void draw_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
+			virtual void draw_indexed_indirect(IBuffer* buffer, u64 offset, u32 max_draw_count, u32 stride,
+				IBuffer* count_buffer, u64 count_buffer_offset) override;
 			virtual void begin_occlusion_query(OcclusionQueryMode mode, u32 index) override;
 			virtual void end_occlusion_query(u32 index) override;
 			virtual void end_render_pass() override;
@@ -147,6 +162,7 @@ namespace Luna
 			}
 			virtual void set_compute_descriptor_sets(u32 start_index, Span<IDescriptorSet*> descriptor_sets) override;
 			virtual void dispatch(u32 thread_group_count_x, u32 thread_group_count_y, u32 thread_group_count_z) override;
+			virtual void dispatch_indirect(IBuffer* buffer, u64 offset) override;
 			virtual void end_compute_pass() override;
 			virtual void begin_copy_pass(const CopyPassDesc& desc) override;
 			virtual void copy_resource(IResource* dst, IResource* src) override;
@@ -505,10 +505,10 @@ namespace Luna
 				lupanic();
 				break;
 			}
-			// Compatible with both compute and graphics queues
+			// Compatible with both compute and graphics queues, copy queues do not support this stage.
 			if (test_flags(state, BufferStateFlag::indirect_argument))
 			{
-				flags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+				flags |= queue_type == CommandQueueType::copy ? VK_PIPELINE_STAGE_ALL_COMMANDS_BIT : VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
 			}
 			if (test_flags(state, BufferStateFlag::copy_dest) ||
 				test_flags(state, BufferStateFlag::copy_source))
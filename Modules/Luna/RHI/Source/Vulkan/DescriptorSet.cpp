@@ -44,7 +44,7 @@ namespace Luna
 		}
 		DescriptorSet::~DescriptorSet()
 		{
-			if (m_desc_set != VK_NULL_HANDLE)
+			if (m_desc_set != VK_NULL_HANDLE && !m_transient)
 			{
 				MutexGuard guard(m_device->m_desc_pool_mtx);
 				m_device->m_funcs.vkFreeDescriptorSets(m_device->m_device, m_device->m_desc_pool, 1, &m_desc_set);
@@ -26,6 +26,9 @@ namespace Luna
 			Ref<DescriptorSetLayout> m_layout;
 
 			VkDescriptorSet m_desc_set = VK_NULL_HANDLE;
+			// Transient descriptor sets are allocated from descriptor pools of command buffers, and are released 
+			// when the pool is reset.
+			bool m_transient = false;
 
 			HashMap<u32, Ref<Sampler>> m_samplers;
 
@@ -36,6 +36,22 @@ namespace Luna
 				enabled_extensions.push_back(VK_KHR_MAINTENANCE1_EXTENSION_NAME);
 			}
 
+			// Enable optional extensions if supported.
+			{
+				u32 extension_count;
+				vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+				VkExtensionProperties* available_extensions = (VkExtensionProperties*)alloca(sizeof(VkExtensionProperties) * extension_count);
+				vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions);
+				for (u32 i = 0; i < extension_count; ++i)
+				{
+					if (!strcmp(available_extensions[i].extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+					{
+						enabled_extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+						m_draw_indirect_count_supported = true;
+					}
+				}
+			}
+
 			m_desc_pool_mtx = new_mutex();
 			m_physical_device = physical_device;
 			vkGetPhysicalDeviceProperties(physical_device, &m_physical_device_properties);
@@ -100,6 +116,15 @@ namespace Luna
 			{
 				return r.errcode();
 			}
+			{
+				VkPipelineCacheCreateInfo cache_info{};
+				cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+				r = encode_vk_result(m_funcs.vkCreatePipelineCache(m_device, &cache_info, nullptr, &m_pipeline_cache));
+				if (failed(r))
+				{
+					return r.errcode();
+				}
+			}
 			m_render_pass_pool.m_device = m_device;
 			m_render_pass_pool.m_vkCreateRenderPass = m_funcs.vkCreateRenderPass;
 			m_render_pass_pool.m_vkDestroyRenderPass = m_funcs.vkDestroyRenderPass;
@@ -122,6 +147,41 @@ namespace Luna
 			create_info.maxSets = 8192;
 			return encode_vk_result(m_funcs.vkCreateDescriptorPool(m_device, &create_info, nullptr, &m_desc_pool));
 		}
+		R<VkDescriptorPool> Device::acquire_transient_descriptor_pool()
+		{
+			{
+				MutexGuard guard(m_desc_pool_mtx);
+				if (!m_free_transient_desc_pools.empty())
+				{
+					VkDescriptorPool pool = m_free_transient_desc_pools.back();
+					m_free_transient_desc_pools.pop_back();
+					return pool;
+				}
+			}
+			// Transient pools do not allow freeing individual sets, so they can be allocated linearly.
+			VkDescriptorPoolSize pool_sizes[5] = {
+				{VK_DESCRIPTOR_TYPE_SAMPLER, 256},
+				{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1024},
+				{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 256},
+				{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1024},
+				{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 256}
+			};
+			VkDescriptorPoolCreateInfo create_info{};
+			create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			create_info.poolSizeCount = 5;
+			create_info.pPoolSizes = pool_sizes;
+			create_info.flags = 0;
+			create_info.maxSets = 1024;
+			VkDescriptorPool pool = VK_NULL_HANDLE;
+			auto r = encode_vk_result(m_funcs.vkCreateDescriptorPool(m_device, &create_info, nullptr, &pool));
+			if (failed(r)) return r.errcode();
+			return pool;
+		}
+		void Device::release_transient_descriptor_pools(Span<const VkDescriptorPool> pools)
+		{
+			MutexGuard guard(m_desc_pool_mtx);
+			m_free_transient_desc_pools.insert(m_free_transient_desc_pools.end(), pools.begin(), pools.end());
+		}
 		RV Device::init_vma_allocator()
 		{
 			VmaAllocatorCreateInfo allocator_create_info = {};
@@ -195,6 +255,16 @@ namespace Luna
 				m_funcs.vkDestroyDescriptorPool(m_device, m_desc_pool, nullptr);
 				m_desc_pool = VK_NULL_HANDLE;
 			}
+			for (VkDescriptorPool pool : m_free_transient_desc_pools)
+			{
+				m_funcs.vkDestroyDescriptorPool(m_device, pool, nullptr);
+			}
+			m_free_transient_desc_pools.clear();
+			if (m_pipeline_cache != VK_NULL_HANDLE)
+			{
+				m_funcs.vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+				m_pipeline_cache = VK_NULL_HANDLE;
+			}
 			if (m_device != VK_NULL_HANDLE)
 			{
 				m_funcs.vkDestroyDevice(m_device, nullptr);
@@ -271,6 +341,9 @@ namespace Luna
 			case DeviceFeature::uniform_buffer_data_alignment:
 				ret.uniform_buffer_data_alignment = (u32)m_physical_device_properties.limits.minUniformBufferOffsetAlignment;
 				break;
+			case DeviceFeature::draw_indirect_count:
+				ret.draw_indirect_count = m_draw_indirect_count_supported;
+				break;
 			default: lupanic();
 			}
 			return ret;
@@ -524,6 +597,53 @@ namespace Luna
 			lucatchret;
 			return ret;
 		}
+		R<Blob> Device::get_pipeline_cache_data()
+		{
+			Blob ret;
+			lutry
+			{
+				usize size = 0;
+				luexp(encode_vk_result(m_funcs.vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, nullptr)));
+				ret = Blob(size);
+				luexp(encode_vk_result(m_funcs.vkGetPipelineCacheData(m_device, m_pipeline_cache, &size, ret.data())));
+				// The cache may be shrunk if pipelines are not added between two calls.
+				if (size < ret.size()) ret = Blob(ret.data(), size);
+			}
+			lucatchret;
+			return ret;
+		}
+		RV Device::merge_pipeline_cache_data(Span<const byte_t> data)
+		{
+			// Validates the header so that data produced by other devices or drivers is ignored.
+			if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) return ok;
+			VkPipelineCacheHeaderVersionOne header;
+			memcpy(&header, data.data(), sizeof(header));
+			if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerSize > data.size() ||
+				header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+				header.vendorID != m_physical_device_properties.vendorID ||
+				header.deviceID != m_physical_device_properties.deviceID ||
+				memcmp(header.pipelineCacheUUID, m_physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE))
+			{
+				return ok;
+			}
+			VkPipelineCache src_cache = VK_NULL_HANDLE;
+			lutry
+			{
+				VkPipelineCacheCreateInfo cache_info{};
+				cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+				cache_info.initialDataSize = data.size();
+				cache_info.pInitialData = data.data();
+				luexp(encode_vk_result(m_funcs.vkCreatePipelineCache(m_device, &cache_info, nullptr, &src_cache)));
+				luexp(encode_vk_result(m_funcs.vkMergePipelineCaches(m_device, m_pipeline_cache, 1, &src_cache)));
+			}
+			lucatch
+			{
+				if (src_cache != VK_NULL_HANDLE) m_funcs.vkDestroyPipelineCache(m_device, src_cache, nullptr);
+				return luerr;
+			}
+			m_funcs.vkDestroyPipelineCache(m_device, src_cache, nullptr);
+			return ok;
+		}
 		LUNA_RHI_API R<Ref<IDevice>> new_device(IAdapter* adapter)
 		{
 			Ref<IDevice> ret;
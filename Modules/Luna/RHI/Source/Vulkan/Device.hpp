@@ -14,6 +14,7 @@
 #include "RenderPassPool.hpp"
 #include <Luna/Runtime/SpinLock.hpp>
 #include <Luna/Runtime/UniquePtr.hpp>
+#include <Luna/Runtime/HashSet.hpp>
 namespace Luna
 {
 	namespace RHI
@@ -43,20 +44,36 @@ namespace Luna
 			//VkPhysicalDeviceMemoryProperties m_memory_properties;
 			VkPhysicalDeviceFeatures m_physical_device_features;
 			VkPhysicalDeviceProperties m_physical_device_properties;
+			// `VK_KHR_draw_indirect_count` is enabled.
+			bool m_draw_indirect_count_supported = false;
 
 			// Descriptor Pools.
 			VkDescriptorPool m_desc_pool = VK_NULL_HANDLE;
 			Ref<IMutex> m_desc_pool_mtx;
+			// Reset descriptor pools for transient descriptor sets that are not owned by any command buffer.
+			// Protected by `m_desc_pool_mtx`.
+			Vector<VkDescriptorPool> m_free_transient_desc_pools;
 
 			// Vulkan memory allocator.
 			VmaAllocator m_allocator = VK_NULL_HANDLE;
 
+			// The pipeline cache used by all pipeline states created by this device.
+			VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+
 			// Render pass pools.
 			RenderPassPool m_render_pass_pool;
 			SpinLock m_render_pass_pool_lock;
 
+			// Tags of resource state tracking systems that are recording commands. See `ResourceStateTrackingSystem::m_tracking_tag`.
+			HashSet<u32> m_live_tracking_tags;
+			SpinLock m_live_tracking_tags_lock;
+
 			RV init(VkPhysicalDevice physical_device, const Vector<QueueFamily>& queue_families);
 			RV init_descriptor_pools();
+			//! Gets one empty descriptor pool for allocating transient descriptor sets.
+			R<VkDescriptorPool> acquire_transient_descriptor_pool();
+			//! Returns descriptor pools acquired by `acquire_transient_descriptor_pool`. Pools must be reset before returned.
+			void release_transient_descriptor_pools(Span<const VkDescriptorPool> pools);
 			RV init_vma_allocator();
 			~Device();
 
@@ -85,6 +102,8 @@ namespace Luna
 			virtual R<Ref<IQueryHeap>> new_query_heap(const QueryHeapDesc& desc) override;
 			virtual R<Ref<IFence>> new_fence() override;
 			virtual R<Ref<ISwapChain>> new_swap_chain(u32 command_queue_index, Window::IWindow* window, const SwapChainDesc& desc) override;
+			virtual R<Blob> get_pipeline_cache_data() override;
+			virtual RV merge_pipeline_cache_data(Span<const byte_t> data) override;
 		};
 
 		extern Ref<IDevice> g_main_device;
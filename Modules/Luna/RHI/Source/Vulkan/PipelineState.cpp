@@ -269,7 +269,7 @@ namespace Luna
 				luset(create_info.renderPass, m_device->m_render_pass_pool.get_render_pass(render_pass));
 				guard.unlock();
 				create_info.subpass = 0;
-				luexp(encode_vk_result(m_device->m_funcs.vkCreateGraphicsPipelines(m_device->m_device, VK_NULL_HANDLE, 1, &create_info, nullptr, &m_pipeline)));
+				luexp(encode_vk_result(m_device->m_funcs.vkCreateGraphicsPipelines(m_device->m_device, m_device->m_pipeline_cache, 1, &create_info, nullptr, &m_pipeline)));
 			}	
 			lucatchret;
 			return ok;
@@ -293,7 +293,7 @@ namespace Luna
 				// pipeline layout.
 				PipelineLayout* playout = (PipelineLayout*)desc.pipeline_layout->get_object();
 				create_info.layout = playout->m_pipeline_layout;
-				luexp(encode_vk_result(m_device->m_funcs.vkCreateComputePipelines(m_device->m_device, VK_NULL_HANDLE, 1, &create_info, nullptr, &m_pipeline)));
+				luexp(encode_vk_result(m_device->m_funcs.vkCreateComputePipelines(m_device->m_device, m_device->m_pipeline_cache, 1, &create_info, nullptr, &m_pipeline)));
 			}
 			lucatchret;
 			return ok;
@@ -28,6 +28,10 @@ namespace Luna
 
 			u32 m_owning_queue_family_index = U32_MAX;
 
+			// The tracking tag (high 32 bits) and slot index (low 32 bits) of the last resource state tracking system
+			// that tracks this resource. See `ResourceStateTrackingSystem::m_tracking_tag`.
+			volatile u64 m_tracking_slot = 0;
+
 			RV init_as_committed(MemoryType memory_type, const BufferDesc& desc);
 			RV init_as_aliasing(const BufferDesc& desc, DeviceMemory* memory);
 			~BufferResource();
@@ -62,6 +66,10 @@ namespace Luna
 			// Global state.
 			Vector<ImageGlobalState> m_global_states;
 
+			// The tracking tag (high 32 bits) and slot index (low 32 bits) of the last resource state tracking system
+			// that tracks this resource. See `ResourceStateTrackingSystem::m_tracking_tag`.
+			volatile u64 m_tracking_slot = 0;
+
 			// Image views.
 			Vector<Pair<TextureViewDesc, Ref<ImageView>>> m_image_views;
 			SpinLock m_image_views_lock;
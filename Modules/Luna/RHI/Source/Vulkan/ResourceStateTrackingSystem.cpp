@@ -13,6 +13,72 @@ namespace Luna
 {
 	namespace RHI
 	{
+		static u32 g_tracking_tag = 0;
+
+		u32 ResourceStateTrackingSystem::new_tracking_tag()
+		{
+			u32 tag = atom_inc_u32(&g_tracking_tag);
+			// 0 is reserved for resources that are never tracked.
+			if (tag == 0) tag = atom_inc_u32(&g_tracking_tag);
+			return tag;
+		}
+		void ResourceStateTrackingSystem::begin_tracking()
+		{
+			m_tracking_tag = new_tracking_tag();
+			LockGuard guard(m_device->m_live_tracking_tags_lock);
+			m_device->m_live_tracking_tags.insert(m_tracking_tag);
+		}
+		void ResourceStateTrackingSystem::end_tracking()
+		{
+			if (!m_device) return;
+			LockGuard guard(m_device->m_live_tracking_tags_lock);
+			m_device->m_live_tracking_tags.erase(m_tracking_tag);
+		}
+		bool ResourceStateTrackingSystem::claim_tracking_slot(u64 volatile* tracking_slot, u32 slot_index)
+		{
+			u64 current = *tracking_slot;
+			u32 tag = (u32)(current >> 32);
+			if (tag)
+			{
+				// The resource is claimed by another tracking system. This only happens when the same resource is 
+				// used by command buffers that are recorded concurrently, or by one command buffer that is reset 
+				// without being submitted.
+				LockGuard guard(m_device->m_live_tracking_tags_lock);
+				if (m_device->m_live_tracking_tags.count(tag)) return false;
+			}
+			return atom_compare_exchange_u64(tracking_slot, encode_tracking_slot(slot_index), current) == current;
+		}
+		u32 ResourceStateTrackingSystem::find_buffer_slot(BufferResource* res) const
+		{
+			u64 tracking_slot = res->m_tracking_slot;
+			if ((u32)(tracking_slot >> 32) == m_tracking_tag)
+			{
+				u32 slot_index = (u32)tracking_slot;
+				if (slot_index < m_buffer_slots.size() && m_buffer_slots[slot_index].m_res == res)
+				{
+					return slot_index;
+				}
+			}
+			// The resource is not tracked, or is claimed by another tracking system.
+			if (m_buffer_slot_map.empty()) return U32_MAX;
+			auto iter = m_buffer_slot_map.find(res);
+			return iter == m_buffer_slot_map.end() ? U32_MAX : iter->second;
+		}
+		u32 ResourceStateTrackingSystem::find_image_slot(ImageResource* res) const
+		{
+			u64 tracking_slot = res->m_tracking_slot;
+			if ((u32)(tracking_slot >> 32) == m_tracking_tag)
+			{
+				u32 slot_index = (u32)tracking_slot;
+				if (slot_index < m_image_slots.size() && m_image_slots[slot_index].m_res == res)
+				{
+					return slot_index;
+				}
+			}
+			if (m_image_slot_map.empty()) return U32_MAX;
+			auto iter = m_image_slot_map.find(res);
+			return iter == m_image_slot_map.end() ? U32_MAX : iter->second;
+		}
 		void ResourceStateTrackingSystem::append_buffer(BufferResource* res, VkAccessFlags before, VkAccessFlags after,
 			u32 before_queue_family_index, u32 after_queue_family_index)
 		{
@@ -61,10 +127,20 @@ namespace Luna
 			{
 				barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			}
-			barrier.subresourceRange.baseMipLevel = subresource.mip_slice;
-			barrier.subresourceRange.baseArrayLayer = subresource.array_slice;
-			barrier.subresourceRange.levelCount = 1;
-			barrier.subresourceRange.layerCount = 1;
+			if (subresource == TEXTURE_BARRIER_ALL_SUBRESOURCES)
+			{
+				barrier.subresourceRange.baseMipLevel = 0;
+				barrier.subresourceRange.baseArrayLayer = 0;
+				barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+				barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+			}
+			else
+			{
+				barrier.subresourceRange.baseMipLevel = subresource.mip_slice;
+				barrier.subresourceRange.baseArrayLayer = subresource.array_slice;
+				barrier.subresourceRange.levelCount = 1;
+				barrier.subresourceRange.layerCount = 1;
+			}
 			m_image_barriers.push_back(barrier);
 		}
 		void ResourceStateTrackingSystem::pack_buffer_internal(BufferResource* res, const BufferBarrier& barrier, 
@@ -153,26 +229,81 @@ namespace Luna
 		void ResourceStateTrackingSystem::pack_buffer(const BufferBarrier& barrier)
 		{
 			BufferResource* res = cast_object<BufferResource>(barrier.buffer->get_object());
-			auto iter = m_current_buffer_states.find(res);
-			if (iter == m_current_buffer_states.end())
+			u32 slot_index = find_buffer_slot(res);
+			if (slot_index == U32_MAX)
 			{
 				// This resource is used on the current buffer for the first time.
-				m_unresolved_buffer_states.insert(make_pair(res, barrier));
-				m_current_buffer_states.insert(make_pair(res, barrier.after));
+				slot_index = (u32)m_buffer_slots.size();
+				BufferTrackingSlot slot;
+				slot.m_res = res;
+				slot.m_state = barrier.after;
+				m_buffer_slots.push_back(slot);
+				if (!claim_tracking_slot(&res->m_tracking_slot, slot_index))
+				{
+					m_buffer_slot_map.insert(make_pair(res, slot_index));
+				}
+				UnresolvedBufferBarrier unresolved;
+				unresolved.m_res = res;
+				unresolved.m_barrier = barrier;
+				m_unresolved_buffer_barriers.push_back(unresolved);
 			}
 			else
 			{
+				BufferTrackingSlot& slot = m_buffer_slots[slot_index];
 				pack_buffer_internal(res, barrier, 
-					encode_access_flags(iter->second), determine_pipeline_stage_flags(iter->second, m_queue_type), 
+					encode_access_flags(slot.m_state), determine_pipeline_stage_flags(slot.m_state, m_queue_type), 
+					VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+				slot.m_state = barrier.after;
+			}
+		}
+		void ResourceStateTrackingSystem::pack_image_tracked(ImageResource* res, const TextureBarrier& barrier, TextureStateFlag& state)
+		{
+			if (state == TextureStateFlag::automatic)
+			{
+				// This subresource is used on the current buffer for the first time.
+				UnresolvedTextureBarrier unresolved;
+				unresolved.m_res = res;
+				unresolved.m_barrier = barrier;
+				m_unresolved_image_barriers.push_back(unresolved);
+			}
+			else
+			{
+				ImageState tracked_state;
+				tracked_state.access_flags = encode_access_flags(state);
+				tracked_state.image_layout = encode_image_layout(state);
+				pack_image_internal(res, barrier, 
+					tracked_state, determine_pipeline_stage_flags(state, m_queue_type),
 					VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
-				iter->second = barrier.after;
 			}
+			state = barrier.after;
 		}
 		void ResourceStateTrackingSystem::pack_image(const TextureBarrier& barrier)
 		{
 			ImageResource* res = cast_object<ImageResource>(barrier.texture->get_object());
+			u32 slot_index = find_image_slot(res);
+			if (slot_index == U32_MAX)
+			{
+				slot_index = (u32)m_image_slots.size();
+				ImageTrackingSlot slot;
+				slot.m_res = res;
+				slot.m_whole_resource = true;
+				slot.m_state = TextureStateFlag::automatic;
+				slot.m_first_subresource_state = 0;
+				m_image_slots.push_back(slot);
+				if (!claim_tracking_slot(&res->m_tracking_slot, slot_index))
+				{
+					m_image_slot_map.insert(make_pair(res, slot_index));
+				}
+			}
+			ImageTrackingSlot& slot = m_image_slots[slot_index];
 			if (barrier.subresource == TEXTURE_BARRIER_ALL_SUBRESOURCES)
 			{
+				if (slot.m_whole_resource)
+				{
+					// Fast path: transits all subresources using one barrier.
+					pack_image_tracked(res, barrier, slot.m_state);
+					return;
+				}
 				TextureBarrier sub_barrier = barrier;
 				for (u32 array_slice = 0; array_slice < res->m_desc.array_size; ++array_slice)
 				{
@@ -180,42 +311,50 @@ namespace Luna
 					{
 						sub_barrier.subresource.array_slice = array_slice;
 						sub_barrier.subresource.mip_slice = mip_slice;
-						pack_image(sub_barrier);
+						u32 subresource_index = calc_subresource_state_index(mip_slice, array_slice, res->m_desc.mip_levels);
+						pack_image_tracked(res, sub_barrier, m_subresource_states[slot.m_first_subresource_state + subresource_index]);
 					}
 				}
+				// All subresources are in the same state now.
+				slot.m_whole_resource = true;
+				slot.m_state = barrier.after;
 			}
 			else
 			{
-				ImageResourceKey key;
-				key.m_res = res;
-				key.m_subres = barrier.subresource;
-				auto iter = m_current_image_states.find(key);
-				if (iter == m_current_image_states.end())
+				if (slot.m_whole_resource)
 				{
-					// This resource is used on the current buffer for the first time.
-					m_unresolved_image_states.insert(make_pair(key, barrier));
-					m_current_image_states.insert(make_pair(key, barrier.after));
-				}
-				else
-				{
-					ImageState tracked_state;
-					tracked_state.access_flags = encode_access_flags(iter->second);
-					tracked_state.image_layout = encode_image_layout(iter->second);
-					pack_image_internal(res, barrier, 
-						tracked_state, determine_pipeline_stage_flags(iter->second, m_queue_type),
-						VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
-					iter->second = barrier.after;
+					// Expands the slot to per-subresource states.
+					slot.m_whole_resource = false;
+					slot.m_first_subresource_state = (u32)m_subresource_states.size();
+					m_subresource_states.resize(m_subresource_states.size() + res->count_subresources(), slot.m_state);
 				}
+				u32 subresource_index = calc_subresource_state_index(barrier.subresource.mip_slice, barrier.subresource.array_slice, res->m_desc.mip_levels);
+				pack_image_tracked(res, barrier, m_subresource_states[slot.m_first_subresource_state + subresource_index]);
+			}
+		}
+		void ResourceStateTrackingSystem::resolve_image(ImageResource* res, const TextureBarrier& barrier, const ImageGlobalState& global_state)
+		{
+			u32 before_queue = global_state.m_owning_queue_family_index;
+			if (before_queue == U32_MAX) before_queue = m_queue_family_index;
+			ImageState before_state;
+			before_state.access_flags = 0;
+			before_state.image_layout = global_state.m_image_layout;
+			pack_image_internal(res, barrier, before_state, 0, before_queue, m_queue_family_index);
+			if (before_queue != m_queue_family_index)
+			{
+				// queue ownership transfer.
+				auto iter = m_queue_transfer_barriers.insert(make_pair(before_queue, QueueTransferBarriers())).first;
+				iter->second.image_barriers.push_back(m_image_barriers.back());
 			}
 		}
 		void ResourceStateTrackingSystem::resolve()
 		{
 			begin_new_barriers_batch();
-			for (auto& i : m_unresolved_buffer_states)
+			for (auto& i : m_unresolved_buffer_barriers)
 			{
-				u32 before_queue = i.first->m_owning_queue_family_index;
+				u32 before_queue = i.m_res->m_owning_queue_family_index;
 				if (before_queue == U32_MAX) before_queue = m_queue_family_index;
-				pack_buffer_internal(i.first, i.second, 0, 0, before_queue, m_queue_family_index);
+				pack_buffer_internal(i.m_res, i.m_barrier, 0, 0, before_queue, m_queue_family_index);
 				if (before_queue != m_queue_family_index)
 				{
 					// queue ownership transfer.
@@ -223,44 +362,84 @@ namespace Luna
 					iter->second.buffer_barriers.push_back(m_buffer_barriers.back());
 				}
 			}
-			for (auto& i : m_unresolved_image_states)
+			for (auto& i : m_unresolved_image_barriers)
 			{
-				LockGuard guard(i.first.m_res->m_image_views_lock);
-				auto global_state = i.first.m_res->m_global_states[calc_subresource_state_index(i.first.m_subres.mip_slice, i.first.m_subres.array_slice, i.first.m_res->m_desc.mip_levels)];
-				u32 before_queue = global_state.m_owning_queue_family_index;
-				if (before_queue == U32_MAX) before_queue = m_queue_family_index;
-				ImageState before_state;
-				before_state.access_flags = 0;
-				before_state.image_layout = global_state.m_image_layout;
-				pack_image_internal(i.first.m_res, i.second, before_state, 0, before_queue, m_queue_family_index);
-				if (before_queue != m_queue_family_index)
+				ImageResource* res = i.m_res;
+				LockGuard guard(res->m_image_views_lock);
+				if (i.m_barrier.subresource == TEXTURE_BARRIER_ALL_SUBRESOURCES)
 				{
-					// queue ownership transfer.
-					auto iter = m_queue_transfer_barriers.insert(make_pair(before_queue, QueueTransferBarriers())).first;
-					iter->second.image_barriers.push_back(m_image_barriers.back());
+					bool same_global_state = true;
+					for (usize j = 1; j < res->m_global_states.size(); ++j)
+					{
+						if (res->m_global_states[j].m_image_layout != res->m_global_states[0].m_image_layout ||
+							res->m_global_states[j].m_owning_queue_family_index != res->m_global_states[0].m_owning_queue_family_index)
+						{
+							same_global_state = false;
+							break;
+						}
+					}
+					if (same_global_state)
+					{
+						resolve_image(res, i.m_barrier, res->m_global_states[0]);
+					}
+					else
+					{
+						TextureBarrier sub_barrier = i.m_barrier;
+						for (u32 array_slice = 0; array_slice < res->m_desc.array_size; ++array_slice)
+						{
+							for (u32 mip_slice = 0; mip_slice < res->m_desc.mip_levels; ++mip_slice)
+							{
+								sub_barrier.subresource.array_slice = array_slice;
+								sub_barrier.subresource.mip_slice = mip_slice;
+								resolve_image(res, sub_barrier, res->m_global_states[calc_subresource_state_index(mip_slice, array_slice, res->m_desc.mip_levels)]);
+							}
+						}
+					}
+				}
+				else
+				{
+					resolve_image(res, i.m_barrier, res->m_global_states[calc_subresource_state_index(i.m_barrier.subresource.mip_slice, i.m_barrier.subresource.array_slice, res->m_desc.mip_levels)]);
 				}
 			}
 			if (m_src_stage_flags == 0) m_src_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 			if (m_dst_stage_flags == 0) m_dst_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 		}
+		void ResourceStateTrackingSystem::append_finish_image(ImageResource* res, const SubresourceIndex& subresource, TextureStateFlag state)
+		{
+			ImageState before;
+			before.access_flags = encode_access_flags(state);
+			before.image_layout = encode_image_layout(state);
+			ImageState after;
+			after.access_flags = 0;
+			after.image_layout = encode_image_layout(state);
+			append_image(res, subresource, before, after);
+			m_src_stage_flags |= determine_pipeline_stage_flags(state, m_queue_type);
+		}
 		void ResourceStateTrackingSystem::generate_finish_barriers()
 		{
 			begin_new_barriers_batch();
-			for (auto& i : m_current_buffer_states)
+			for (auto& i : m_buffer_slots)
 			{
-				append_buffer(i.first, encode_access_flags(i.second), 0);
-				m_src_stage_flags |= determine_pipeline_stage_flags(i.second, m_queue_type);
+				append_buffer(i.m_res, encode_access_flags(i.m_state), 0);
+				m_src_stage_flags |= determine_pipeline_stage_flags(i.m_state, m_queue_type);
 			}
-			for (auto& i : m_current_image_states)
+			for (auto& i : m_image_slots)
 			{
-				ImageState before;
-				before.access_flags = encode_access_flags(i.second);
-				before.image_layout = encode_image_layout(i.second);
-				ImageState after;
-				after.access_flags = 0;
-				after.image_layout = encode_image_layout(i.second);
-				append_image(i.first.m_res, i.first.m_subres, before, after);
-				m_src_stage_flags |= determine_pipeline_stage_flags(i.second, m_queue_type);
+				if (i.m_whole_resource)
+				{
+					append_finish_image(i.m_res, TEXTURE_BARRIER_ALL_SUBRESOURCES, i.m_state);
+					continue;
+				}
+				for (u32 array_slice = 0; array_slice < i.m_res->m_desc.array_size; ++array_slice)
+				{
+					for (u32 mip_slice = 0; mip_slice < i.m_res->m_desc.mip_levels; ++mip_slice)
+					{
+						TextureStateFlag state = m_subresource_states[i.m_first_subresource_state + 
+							calc_subresource_state_index(mip_slice, array_slice, i.m_res->m_desc.mip_levels)];
+						if (state == TextureStateFlag::automatic) continue;
+						append_finish_image(i.m_res, SubresourceIndex(mip_slice, array_slice), state);
+					}
+				}
 			}
 			if (m_src_stage_flags == 0)
 			{
@@ -270,18 +449,27 @@ namespace Luna
 		}
 		void ResourceStateTrackingSystem::apply()
 		{
-			for (auto& i : m_current_buffer_states)
+			for (u32 slot_index = 0; slot_index < (u32)m_buffer_slots.size(); ++slot_index)
 			{
-				BufferResource* res = i.first;
+				BufferResource* res = m_buffer_slots[slot_index].m_res;
 				res->m_owning_queue_family_index = m_queue_family_index;
+				// Releases the claim so that the next command buffer can claim the resource without checking tags.
+				atom_compare_exchange_u64(&res->m_tracking_slot, 0, encode_tracking_slot(slot_index));
 			}
-			for (auto& i : m_current_image_states)
+			for (u32 slot_index = 0; slot_index < (u32)m_image_slots.size(); ++slot_index)
 			{
-				ImageResource* res = i.first.m_res;
-				u32 subresource_index = calc_subresource_state_index(i.first.m_subres.mip_slice, i.first.m_subres.array_slice, res->m_desc.mip_levels);
-				res->m_global_states[subresource_index].m_image_layout = encode_image_layout(i.second);
-				res->m_global_states[subresource_index].m_owning_queue_family_index = m_queue_family_index;
+				auto& i = m_image_slots[slot_index];
+				ImageResource* res = i.m_res;
+				atom_compare_exchange_u64(&res->m_tracking_slot, 0, encode_tracking_slot(slot_index));
+				for (usize j = 0; j < res->m_global_states.size(); ++j)
+				{
+					TextureStateFlag state = i.m_whole_resource ? i.m_state : m_subresource_states[i.m_first_subresource_state + j];
+					if (state == TextureStateFlag::automatic) continue;
+					res->m_global_states[j].m_image_layout = encode_image_layout(state);
+					res->m_global_states[j].m_owning_queue_family_index = m_queue_family_index;
+				}
 			}
+			end_tracking();
 		}
 	}
 }
\ No newline at end of file
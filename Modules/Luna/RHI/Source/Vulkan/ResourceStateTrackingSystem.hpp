@@ -10,34 +10,10 @@
 #pragma once
 #include "Device.hpp"
 #include "Resource.hpp"
+#include <Luna/Runtime/Atomic.hpp>
 
 namespace Luna
 {
-	namespace RHI
-	{
-		struct ImageResourceKey
-		{
-			ImageResource* m_res;
-			SubresourceIndex m_subres;
-
-			bool operator==(const ImageResourceKey& rhs) const
-			{
-				return m_res == rhs.m_res && m_subres == rhs.m_subres;
-			}
-		};
-	}
-
-	template<>
-	struct hash<RHI::ImageResourceKey>
-	{
-		usize operator()(const RHI::ImageResourceKey& value)
-		{
-			usize h = (usize)value.m_res;
-			h ^= hash<RHI::SubresourceIndex>()(value.m_subres);
-			return h;
-		}
-	};
-
 	namespace RHI
 	{
 		inline constexpr u32 calc_subresource_state_index(u32 mip_slice, u32 array_slice, u32 mip_levels)
@@ -65,22 +41,68 @@ namespace Luna
 			Vector<VkImageMemoryBarrier> image_barriers;
 		};
 
+		struct BufferTrackingSlot
+		{
+			BufferResource* m_res;
+			BufferStateFlag m_state;
+		};
+
+		struct ImageTrackingSlot
+		{
+			ImageResource* m_res;
+			//! If `true`, all subresources of the image are in `m_state`, and `m_first_subresource_state` is not used.
+			//! This is the fast path for barriers that transit the whole resource, the slot is expanded to 
+			//! per-subresource states only when one single subresource is transited.
+			bool m_whole_resource;
+			TextureStateFlag m_state;
+			//! The index of the state of the first subresource in `ResourceStateTrackingSystem::m_subresource_states`.
+			//! Subresources that are not used in the current command buffer have `TextureStateFlag::automatic` state.
+			u32 m_first_subresource_state;
+		};
+
+		struct UnresolvedBufferBarrier
+		{
+			BufferResource* m_res;
+			BufferBarrier m_barrier;
+		};
+
+		struct UnresolvedTextureBarrier
+		{
+			ImageResource* m_res;
+			TextureBarrier m_barrier;
+		};
+
 		class ResourceStateTrackingSystem
 		{
 		public:
 
+			Device* m_device = nullptr;
 			CommandQueueType m_queue_type = CommandQueueType::graphics;
 			u32 m_queue_family_index;
 
-			//! Tables for unresolved resources. Unlike most implementations in other library, because 
+			//! The tag that identifies the current recording of this tracking system. Tags of recordings that are not 
+			//! submitted are stored in `Device::m_live_tracking_tags`. When one resource is used for the first time, 
+			//! the system claims the resource by storing the tag and the slot index in `m_tracking_slot` of the 
+			//! resource, so that the slot can be found without hash lookups. Claims are released when the command 
+			//! buffer is submitted. Claims whose tags are not live (like claims of command buffers that are reset 
+			//! without being submitted) can be overwritten.
+			u32 m_tracking_tag = 0;
+
+			//! Dense arrays for the current state of resources used in the current command buffer.
+			Vector<BufferTrackingSlot> m_buffer_slots;
+			Vector<ImageTrackingSlot> m_image_slots;
+			Vector<TextureStateFlag> m_subresource_states;
+
+			//! Fallback tables used only for resources that are claimed by another tracking system that is recording 
+			//! concurrently. Resources claimed by this system are not added to these tables.
+			HashMap<BufferResource*, u32> m_buffer_slot_map;
+			HashMap<ImageResource*, u32> m_image_slot_map;
+
+			//! Barriers for unresolved resources. Unlike most implementations in other library, because 
 			//! we don't know when the list will be submitted to the queue, we defer the resolving of this 
 			//! to the time when the list is actually submitted.
-			HashMap<BufferResource*, BufferBarrier> m_unresolved_buffer_states;
-			HashMap<ImageResourceKey, TextureBarrier> m_unresolved_image_states;
-
-			//! Tables for the current state of resources.
-			HashMap<BufferResource*, BufferStateFlag> m_current_buffer_states;
-			HashMap<ImageResourceKey, TextureStateFlag> m_current_image_states;
+			Vector<UnresolvedBufferBarrier> m_unresolved_buffer_barriers;
+			Vector<UnresolvedTextureBarrier> m_unresolved_image_barriers;
 
 			Vector<VkBufferMemoryBarrier> m_buffer_barriers;
 			Vector<VkImageMemoryBarrier> m_image_barriers;
@@ -88,14 +110,28 @@ namespace Luna
 			VkPipelineStageFlags m_dst_stage_flags = 0;
 			HashMap<u32, QueueTransferBarriers> m_queue_transfer_barriers;
 
-			ResourceStateTrackingSystem() {}
+			~ResourceStateTrackingSystem()
+			{
+				end_tracking();
+			}
+
+			void init(Device* device)
+			{
+				m_device = device;
+				begin_tracking();
+			}
 
 			void reset()
 			{
-				m_unresolved_buffer_states.clear();
-				m_unresolved_image_states.clear();
-				m_current_buffer_states.clear();
-				m_current_image_states.clear();
+				end_tracking();
+				begin_tracking();
+				m_buffer_slots.clear();
+				m_image_slots.clear();
+				m_subresource_states.clear();
+				m_buffer_slot_map.clear();
+				m_image_slot_map.clear();
+				m_unresolved_buffer_barriers.clear();
+				m_unresolved_image_barriers.clear();
 			}
 
 			void begin_new_barriers_batch()
@@ -109,19 +145,35 @@ namespace Luna
 
 			VkImageLayout get_image_layout(ImageResource* res, const SubresourceIndex& subresource) const
 			{
-				ImageResourceKey k;
-				k.m_res = res;
-				k.m_subres = subresource;
-				auto iter = m_current_image_states.find(k);
-				if (iter == m_current_image_states.end())
+				u32 subresource_index = calc_subresource_state_index(subresource.mip_slice, subresource.array_slice, res->m_desc.mip_levels);
+				u32 slot_index = find_image_slot(res);
+				if (slot_index != U32_MAX)
 				{
-					u32 subresource_index = calc_subresource_state_index(subresource.mip_slice, subresource.array_slice, res->m_desc.mip_levels);
-					return res->m_global_states[subresource_index].m_image_layout;
+					const ImageTrackingSlot& slot = m_image_slots[slot_index];
+					TextureStateFlag state = slot.m_whole_resource ? slot.m_state : m_subresource_states[slot.m_first_subresource_state + subresource_index];
+					if (state != TextureStateFlag::automatic)
+					{
+						return encode_image_layout(state);
+					}
 				}
-				return encode_image_layout(iter->second);
+				return res->m_global_states[subresource_index].m_image_layout;
 			}
 
 		private:
+			static u32 new_tracking_tag();
+			void begin_tracking();
+			void end_tracking();
+			u64 encode_tracking_slot(u32 slot_index) const
+			{
+				return ((u64)m_tracking_tag << 32) | (u64)slot_index;
+			}
+			//! Stores `slot_index` to `tracking_slot` of one resource if the resource is not claimed by another live 
+			//! tracking system.
+			//! @return Returns `true` if the resource is claimed by this system, `false` otherwise.
+			bool claim_tracking_slot(u64 volatile* tracking_slot, u32 slot_index);
+			u32 find_buffer_slot(BufferResource* res) const;
+			u32 find_image_slot(ImageResource* res) const;
+
 			void append_buffer(BufferResource* res, VkAccessFlags before, VkAccessFlags after, 
 				u32 before_queue_family_index = VK_QUEUE_FAMILY_IGNORED, u32 after_queue_family_index = VK_QUEUE_FAMILY_IGNORED);
 			void append_image(ImageResource* res, const SubresourceIndex& subresource, const ImageState& before, const ImageState& after,
@@ -133,6 +185,10 @@ namespace Luna
 			void pack_image_internal(ImageResource* res, const TextureBarrier& barrier,
 				const ImageState& recorded_before_state, VkPipelineStageFlags recorded_src_pipeline_stage_flags,
 				u32 before_queue_family_index, u32 after_queue_family_index);
+			//! Packs one barrier for one image slot whose subresource is tracked in `state`.
+			void pack_image_tracked(ImageResource* res, const TextureBarrier& barrier, TextureStateFlag& state);
+			void resolve_image(ImageResource* res, const TextureBarrier& barrier, const ImageGlobalState& global_state);
+			void append_finish_image(ImageResource* res, const SubresourceIndex& subresource, TextureStateFlag state);
 		public:
 
 			//! Appends one barrier that transits the specified subresources' state to after
@@ -146,7 +202,7 @@ namespace Luna
 			//! Generates barriers that should be inserted at the end of the command buffer.
 			void generate_finish_barriers();
 
-			//! Applies all after state back to the resource global state.
+			//! Applies all after state back to the resource global state, and releases resources claimed by this system.
 			void apply();
 		};
 	}
@@ -11,6 +11,9 @@
 #pragma once
 #include "Resource.hpp"
 #include "CommandBuffer.hpp"
+#include "PipelineState.hpp"
+#include <Luna/Runtime/Ref.hpp>
+#include <Luna/Runtime/Waitable.hpp>
 #ifndef LUNA_RHI_API
 #define LUNA_RHI_API
 #endif
@@ -144,6 +147,97 @@ namespace Luna
 
         //! Copies buffer data from host memory to device local memory.
         //! The system allocates one staging buffer for the copy internally.
+        //! @remark This function submits `command_buffer` and blocks the current thread until the GPU finishes the copy. 
+        //! Use `IResourceDataCopier` to copy resource data without creating staging buffers and waiting for every copy.
         LUNA_RHI_API RV copy_resource_data(ICommandBuffer* command_buffer, Span<const CopyResourceData> copies);
+
+        //! Copies resource data between host memory and device memory using persistent staging ring buffers.
+        //! @details Copies are recorded to one internal command buffer and submitted together as one batch when `flush` 
+        //! is called, when one ticket of the batch is waited, or when staging buffers run out of space. Staging memory used 
+        //! by one batch is reclaimed when the GPU finishes the batch. Copies that do not fit in staging buffers use 
+        //! temporary staging buffers that are released with the batch.
+        //! 
+        //! All functions of this object are thread safe, so multiple threads can share one copier, and copies from 
+        //! different threads are batched into the same submission.
+        struct IResourceDataCopier : virtual Interface
+        {
+            luiid("{6a1f2d3c-7e45-4b08-a9c1-3d5e8f27b604}");
+
+            virtual IDevice* get_device() = 0;
+
+            //! Gets the index of the command queue that copies are submitted to.
+            virtual u32 get_command_queue_index() = 0;
+
+            //! Records copies to the current batch.
+            //! @param[in] copies The copies to perform. Source host memory of write copies is copied to staging buffers before 
+            //! this function returns, so it can be released after this call. Destination host memory of read copies must be 
+            //! valid until the returned ticket is completed.
+            //! @return Returns the ticket of the batch that contains the copies, which can be passed to `is_completed` and `wait`.
+            virtual R<u64> copy_resource_data(Span<const CopyResourceData> copies) = 0;
+
+            //! Submits the current batch to the GPU without waiting for it.
+            virtual RV flush() = 0;
+
+            //! Checks whether the batch of the specified ticket is finished by the GPU. This never blocks the current thread.
+            //! @remark Read copies of one batch are written to destination host memory when this returns `true` or `wait` 
+            //! returns for one ticket of the batch. Batches that are not submitted yet are never completed, call `flush` to 
+            //! submit them.
+            virtual bool is_completed(u64 ticket) = 0;
+
+            //! Blocks the current thread until the batch of the specified ticket is finished by the GPU. The batch is 
+            //! submitted first if it is not submitted yet.
+            virtual RV wait(u64 ticket) = 0;
+        };
+
+        //! Creates one new resource data copier.
+        //! @param[in] device The device to copy resources for.
+        //! @param[in] command_queue_index The index of the command queue to submit copies to.
+        //! @param[in] upload_buffer_size The size of the staging ring buffer used by write copies.
+        //! @param[in] readback_buffer_size The size of the staging ring buffer used by read copies. Specify 0 to always use 
+        //! temporary buffers for read copies.
+        LUNA_RHI_API R<Ref<IResourceDataCopier>> new_resource_data_copier(IDevice* device, u32 command_queue_index, 
+            u64 upload_buffer_size = 64 * 1024 * 1024, u64 readback_buffer_size = 4 * 1024 * 1024);
+
+        //! Loads pipeline cache data from the specified file and merges it to the pipeline cache of the device.
+        //! @param[in] device The device to load pipeline cache for.
+        //! @param[in] path The platform path of the pipeline cache file.
+        //! @remark If the file does not exist, this function does nothing and succeeds. See `IDevice::merge_pipeline_cache_data`
+        //! for details.
+        LUNA_RHI_API RV load_pipeline_cache(IDevice* device, const c8* path);
+
+        //! Saves the pipeline cache data of the device to the specified file. The old file is overwritten.
+        //! @param[in] device The device to save pipeline cache for.
+        //! @param[in] path The platform path of the pipeline cache file.
+        //! @remark If the backend does not support pipeline caches, this function does nothing and succeeds.
+        //! 
+        //! Data is written to one temporary file at `path` with ".tmp" appended, which then replaces the old file, so
+        //! the old file is not corrupted if writing fails.
+        LUNA_RHI_API RV save_pipeline_cache(IDevice* device, const c8* path);
+
+        //! Represents one pipeline state that is being created asynchronously. Waiting for this object blocks the current 
+        //! thread until the creation is finished.
+        struct IPipelineStateFuture : virtual IWaitable
+        {
+            luiid("{e4b27c90-5d1a-4f36-b8a2-6c0d93f1e847}");
+
+            //! Waits for the creation to finish and gets the result.
+            //! @return Returns the created pipeline state, or the error that occurs when creating the pipeline state.
+            virtual R<Ref<IPipelineState>> get() = 0;
+        };
+
+        //! Creates one graphics pipeline state using job system workers.
+        //! @param[in] device The device to create the pipeline state on.
+        //! @param[in] desc The descriptor object. Data referred by the descriptor object, including shader byte codes, 
+        //! input layouts and semantic names, is copied before this function returns.
+        //! @return Returns one future object that can be waited for the created pipeline state.
+        //! @remark The JobSystem module must be initialized before calling this function.
+        LUNA_RHI_API Ref<IPipelineStateFuture> new_graphics_pipeline_state_async(IDevice* device, const GraphicsPipelineStateDesc& desc);
+
+        //! Creates one compute pipeline state using job system workers.
+        //! @param[in] device The device to create the pipeline state on.
+        //! @param[in] desc The descriptor object. Shader byte codes are copied before this function returns.
+        //! @return Returns one future object that can be waited for the created pipeline state.
+        //! @remark The JobSystem module must be initialized before calling this function.
+        LUNA_RHI_API Ref<IPipelineStateFuture> new_compute_pipeline_state_async(IDevice* device, const ComputePipelineStateDesc& desc);
     }
 }
\ No newline at end of file
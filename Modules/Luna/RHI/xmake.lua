@@ -14,11 +14,11 @@ option("rhi_api")
     set_default(default_rhi_api)
     set_showmenu(true)
     if is_os("windows") then
-        set_values("D3D12", "Vulkan")
+        set_values("D3D12", "Vulkan", "Null")
     elseif is_os("macosx", "ios") then
-        set_values("Metal")
+        set_values("Metal", "Null")
     elseif is_os("linux", "android") then
-        set_values("Vulkan")
+        set_values("Vulkan", "Null")
     end
     set_description("The Graphics API to use for RHI")
 option_end()
@@ -58,7 +58,11 @@ luna_sdk_module_target("RHI")
         add_files("Source/Metal/**.cpp", "Source/Metal/**.mm")
         add_frameworks("Foundation", "QuartzCore", "Metal")
         add_deps("VariantUtils")
+    elseif is_config("rhi_api", "Null") then
+        add_defines("LUNA_RHI_NULL")
+        add_headerfiles("Source/Null/**.hpp", {install = false})
+        add_files("Source/Null/**.cpp")
     end
-    add_deps("Runtime", "Window")
+    add_deps("Runtime", "Window", "JobSystem")
 target_end()
 
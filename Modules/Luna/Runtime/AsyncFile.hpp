@@ -0,0 +1,107 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncFile.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "File.hpp"
+#include "Waitable.hpp"
+#include "Functional.hpp"
+#include "Span.hpp"
+
+#ifndef LUNA_RUNTIME_API
+#define LUNA_RUNTIME_API
+#endif
+
+namespace Luna
+{
+	//! @addtogroup RuntimeFile
+	//! @{
+
+	//! @brief Specifies the operation type of one asynchronous file I/O request.
+	enum class FileIOOp : u8
+	{
+		//! @brief Reads data from the file to the buffer.
+		read = 0,
+		//! @brief Writes data from the buffer to the file.
+		write = 1,
+	};
+
+	//! @brief Describes one asynchronous file I/O request.
+	struct FileIORequest
+	{
+		//! @brief The file to read or write. The file is retained by the system until the request completes.
+		IFile* file;
+		//! @brief The position, in bytes, to read or write data. This does not depend on the file cursor.
+		u64 offset;
+		//! @brief The buffer to read data to or write data from. The buffer must be valid until the request completes.
+		void* buffer;
+		//! @brief The size, in bytes, of the data to read or write.
+		usize size;
+		//! @brief The operation type.
+		FileIOOp op;
+	};
+
+	//! @brief Called when one request in one asynchronous file I/O batch completes.
+	//! @param[in] index The index of the request in the batch.
+	//! @param[in] result The result of the request.
+	//! @param[in] transferred_bytes The number of bytes read or written. For read requests, this may be smaller than
+	//! the request size if the end of the file is reached.
+	//! @remark The callback is invoked on one system I/O thread, so it should return quickly, for example by submitting
+	//! one job to process the data.
+	using file_io_callback_t = void(usize index, RV result, usize transferred_bytes);
+
+	//! @interface IFileIOBatch
+	//! @brief Represents one batch of asynchronous file I/O requests submitted by @ref submit_file_io.
+	//! @details The batch is signaled when all requests in the batch are completed.
+	struct IFileIOBatch : virtual IWaitable
+	{
+		luiid("{e2d1c7a4-5b3f-4e68-9a0c-7f41b86d2e15}");
+
+		//! @brief Gets the number of requests in this batch.
+		//! @return Returns the number of requests in this batch.
+		virtual usize get_num_requests() = 0;
+
+		//! @brief Checks whether all requests in this batch are completed.
+		//! @return Returns `true` if all requests are completed, returns `false` otherwise.
+		virtual bool is_finished() = 0;
+
+		//! @brief Gets the result of one request.
+		//! @param[in] index The index of the request.
+		//! @return Returns the result of the request.
+		//! @par Valid Usage
+		//! * The request must be completed.
+		virtual RV get_result(usize index) = 0;
+
+		//! @brief Gets the number of bytes transferred by one request.
+		//! @param[in] index The index of the request.
+		//! @return Returns the number of bytes read or written by the request.
+		//! @par Valid Usage
+		//! * The request must be completed.
+		virtual usize get_transferred_bytes(usize index) = 0;
+	};
+
+	//! @brief Submits one batch of asynchronous file I/O requests.
+	//! @details Requests are executed by the platform asynchronous I/O interface when available (`io_uring` on Linux),
+	//! so many requests can be in flight without blocking any thread. On other platforms, or for files not opened by
+	//! @ref open_file, requests are executed by blocking calls on a small set of dedicated I/O threads.
+	//!
+	//! Requests in one batch may complete in any order. The file cursor position of files used by requests is undefined
+	//! after the requests complete, and the user should not read or write the same file by @ref IStream methods while
+	//! requests that use the file are in flight.
+	//! @param[in] requests The requests to submit.
+	//! @param[in] callback The optional callback invoked when each request completes.
+	//! @return Returns the batch object that can be used to wait for all requests and fetch request results.
+	LUNA_RUNTIME_API R<Ref<IFileIOBatch>> submit_file_io(Span<const FileIORequest> requests, const Function<file_io_callback_t>& callback = nullptr);
+
+	//! @brief Checks whether asynchronous file I/O is performed by the platform asynchronous I/O interface.
+	//! @return Returns `true` if the platform asynchronous I/O interface is used, returns `false` if
+	//! all requests are executed by I/O threads.
+	LUNA_RUNTIME_API bool is_native_async_file_io_supported();
+
+	//! @}
+}
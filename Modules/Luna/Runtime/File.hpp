@@ -144,6 +144,53 @@ namespace Luna
 	//! * `file` must be opened with @ref FileOpenFlag::read flag.
 	LUNA_RUNTIME_API R<Blob> load_file_data(IFile* file);
 
+	//! @brief Specifies attributes for one file map operation.
+	enum class FileMapFlag : u32
+	{
+		none = 0x00,
+		//! @brief Maps the file as copy-on-write.
+		//! @details If this is specified, the mapped data is writable, and modifications are private to the mapping
+		//! and never written back to the file. If this is not specified, the mapped data is read-only, and
+		//! writing to the mapped data causes undefined behavior.
+		copy_on_write = 0x01,
+	};
+
+	//! @interface IFileMapping
+	//! @brief Represents a mapped view of one range of a file. See @ref map_file for details.
+	struct IFileMapping : virtual Interface
+	{
+		luiid("{6a3e9d07-4b0c-4c52-9f0e-2d7b5e8a1c93}");
+
+		//! @brief Gets the pointer to the mapped data.
+		//! @return Returns the pointer to the first byte of the mapped range. The pointer is valid until the mapping object is released.
+		virtual byte_t* get_data() = 0;
+
+		//! @brief Gets the size of the mapped data.
+		//! @return Returns the size, in bytes, of the mapped range.
+		virtual usize get_size() = 0;
+	};
+
+	//! @brief Maps one range of the file to memory.
+	//! @details If `file` is opened by @ref open_file, the range is mapped by the platform virtual memory
+	//! system and pages are loaded on demand, so no data is copied. For other file implementations,
+	//! the range is read into one memory buffer owned by the returned mapping object.
+	//!
+	//! The mapping stays valid after `file` is released. Changing the size of the file while it is mapped
+	//! causes undefined behavior when accessing mapped data beyond the new end of the file.
+	//! @param[in] file The file to map.
+	//! @param[in] offset The offset, in bytes, of the first byte to map. This does not need to be aligned.
+	//! @param[in] size The size, in bytes, of the range to map. If this is `USIZE_MAX`, the range from `offset`
+	//! to the end of the file is mapped.
+	//! @param[in] flags The file map flags.
+	//! @return Returns the new mapping object.
+	//! @par Possible Errors
+	//! * @ref BasicError::out_of_range
+	//! * @ref BasicError::access_denied
+	//! * @ref BasicError::bad_platform_call for all errors that cannot be identified.
+	//! @par Valid Usage
+	//! * `file` must be opened with @ref FileOpenFlag::read flag.
+	LUNA_RUNTIME_API R<Ref<IFileMapping>> map_file(IFile* file, u64 offset = 0, usize size = USIZE_MAX, FileMapFlag flags = FileMapFlag::none);
+
 	//! @brief Gets the file attribute.
 	//! @param[in] path The path of the file.
 	//! @return Returns the file attribute structure.
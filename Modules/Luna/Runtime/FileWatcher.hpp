@@ -0,0 +1,70 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file FileWatcher.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "File.hpp"
+#include "Path.hpp"
+#include "Vector.hpp"
+
+#ifndef LUNA_RUNTIME_API
+#define LUNA_RUNTIME_API
+#endif
+
+namespace Luna
+{
+	//! @addtogroup RuntimeFile
+	//! @{
+
+	//! @brief Specifies the type of one file change.
+	enum class FileChangeType : u8
+	{
+		//! @brief The file or directory is created, or moved into the watched directory.
+		added = 0,
+		//! @brief The file data is modified.
+		modified = 1,
+		//! @brief The file or directory is deleted, or moved out of the watched directory.
+		removed = 2,
+	};
+
+	//! @brief Describes one file change detected by one file watcher.
+	struct FileChange
+	{
+		//! @brief The path of the changed file or directory relative to the watched directory.
+		//! @details If this is empty, the watcher has lost track of some changes (for example, when the
+		//! system event queue overflows), and any file in the watched directory may be changed.
+		Path path;
+		//! @brief The change type.
+		FileChangeType type;
+		//! @brief `true` if the changed item is a directory.
+		bool directory;
+	};
+
+	//! @interface IFileWatcher
+	//! @brief Watches one directory and all its subdirectories for file changes.
+	struct IFileWatcher : virtual Interface
+	{
+		luiid("{5c8e2f14-a3d7-4b69-8e01-f2b94c6d7a35}");
+
+		//! @brief Fetches file changes detected since the last call.
+		//! @details This call never blocks. Renaming one file is reported as removing the old file and
+		//! adding the new file. When one directory is added, all files in the directory are also reported as added.
+		//! One file may be reported multiple times if it is changed multiple times.
+		//! @param[out] changes The vector to append detected changes to.
+		virtual RV read_changes(Vector<FileChange>& changes) = 0;
+	};
+
+	//! @brief Watches one directory and all its subdirectories for file changes using the platform file
+	//! notification interface (`inotify` on Linux).
+	//! @param[in] path The native path of the directory to watch.
+	//! @return Returns the new watcher object. Returns `BasicError::not_supported` if the platform does not
+	//! support file notifications, in which case the user should detect changes by polling file attributes.
+	LUNA_RUNTIME_API R<Ref<IFileWatcher>> watch_dir(const c8* path);
+
+	//! @}
+}
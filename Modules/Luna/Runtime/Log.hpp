@@ -107,12 +107,167 @@ namespace Luna
 	//! @param[in] args Arguments used to format the log message.
 	LUNA_RUNTIME_API void logv_error(const c8* tag, const c8* format, VarList args);
 
+	//! @brief Specifies the type of one argument stored in one structured log record.
+	enum class LogArgType : u8
+	{
+		//! The argument is stored as one `i64` value.
+		signed_integer = 0,
+		//! The argument is stored as one `u64` value.
+		unsigned_integer = 1,
+		//! The argument is stored as one `f64` value.
+		floating_point = 2,
+		//! The argument is stored as one `u32` string length followed by string characters without the null terminator.
+		string = 3,
+		//! The argument is stored as one `u64` address value.
+		pointer = 4,
+	};
+
+	//! @brief Describes one structured log record, whose message is formatted only when required.
+	struct LogRecord
+	{
+		//! The log verbosity.
+		LogVerbosity verbosity;
+		//! The null-terminated log tag.
+		const c8* tag;
+		//! The `printf`-style format string of the log message.
+		const c8* format;
+		//! The packed arguments used to format the log message. Every argument begins with one @ref LogArgType byte 
+		//! followed by unaligned argument data.
+		const u8* args;
+		//! The size of the packed arguments in bytes.
+		usize args_size;
+	};
+
+	//! @brief Called by the log system when one structured log record is emitted.
+	//! @param[in] record The emitted log record. The record data is only valid during this call.
+	using log_record_callback_t = void(const LogRecord& record);
+
+	//! @brief Checks whether log messages with the specified verbosity will be accepted by at least one log handler.
+	//! @param[in] verbosity The log verbosity to check.
+	//! @return Returns `true` if log messages with the specified verbosity will be accepted by at least one log handler, returns `false` otherwise.
+	//! @remark Log calls check this automatically and return without formatting the log message if no handler accepts the message.
+	LUNA_RUNTIME_API bool is_log_verbosity_enabled(LogVerbosity verbosity);
+
+	//! @brief Submits one structured log record with packed arguments.
+	//! @details This is the low-level function used by @ref log_record. The format string is not copied, so it must be valid until the 
+	//! log system is closed. String literals are recommended.
+	//! @param[in] verbosity The log verbosity.
+	//! @param[in] tag The log tag. Used by the implementation to filter logs.
+	//! @param[in] format The log message format.
+	//! @param[in] args The packed arguments. See @ref LogRecord::args for details.
+	//! @param[in] args_size The size of the packed arguments in bytes.
+	LUNA_RUNTIME_API void submit_log_record(LogVerbosity verbosity, const c8* tag, const c8* format, const u8* args, usize args_size);
+
+	//! @brief Formats the message of one structured log record.
+	//! @param[in] record The log record to format.
+	//! @param[out] buf The buffer to write the null-terminated message to. This can be `nullptr` if `buf_size` is `0`.
+	//! @param[in] buf_size The size of the buffer in bytes. The message will be truncated if the buffer is not large enough.
+	//! @return Returns the length of the formatted message, not including the null terminator. If the returned value is not 
+	//! smaller than `buf_size`, the message is truncated.
+	LUNA_RUNTIME_API usize format_log_record(const LogRecord& record, c8* buf, usize buf_size);
+
+	namespace Impl
+	{
+		template <typename _Ty>
+		inline usize get_log_arg_size(const _Ty& v)
+		{
+			using T = decay_t<_Ty>;
+			if constexpr (is_same_v<T, c8*> || is_same_v<T, const c8*>)
+			{
+				const c8* s = v;
+				return 1 + sizeof(u32) + (s ? strlen(s) : 0);
+			}
+			else
+			{
+				static_assert(is_arithmetic_v<T> || is_enum_v<T> || is_pointer_v<T> || is_null_pointer_v<T>, "Unsupported log argument type.");
+				return 1 + sizeof(u64);
+			}
+		}
+		template <typename _Ty>
+		inline void write_log_arg(u8*& dst, LogArgType type, const _Ty& v)
+		{
+			*dst = (u8)type;
+			memcpy(dst + 1, &v, sizeof(_Ty));
+			dst += 1 + sizeof(_Ty);
+		}
+		template <typename _Ty>
+		inline void encode_log_arg(u8*& dst, const _Ty& v)
+		{
+			using T = decay_t<_Ty>;
+			if constexpr (is_same_v<T, c8*> || is_same_v<T, const c8*>)
+			{
+				const c8* s = v;
+				u32 len = s ? (u32)strlen(s) : 0;
+				write_log_arg(dst, LogArgType::string, len);
+				memcpy(dst, s, len);
+				dst += len;
+			}
+			else if constexpr (is_enum_v<T>)
+			{
+				encode_log_arg(dst, (underlying_type_t<T>)v);
+			}
+			else if constexpr (is_floating_point_v<T>)
+			{
+				write_log_arg(dst, LogArgType::floating_point, (f64)v);
+			}
+			else if constexpr (is_integral_v<T> && is_signed_v<T>)
+			{
+				write_log_arg(dst, LogArgType::signed_integer, (i64)v);
+			}
+			else if constexpr (is_integral_v<T>)
+			{
+				write_log_arg(dst, LogArgType::unsigned_integer, (u64)v);
+			}
+			else
+			{
+				write_log_arg(dst, LogArgType::pointer, (u64)(usize)v);
+			}
+		}
+	}
+
+	//! @brief Logs one structured log record.
+	//! @details Unlike @ref log, this function does not format the log message when it is called. Instead, it records the format string 
+	//! pointer and packs arguments into one compact binary record, and the message will be formatted only when required by log handlers. 
+	//! If no log handler accepts the specified verbosity, this function returns without packing arguments.
+	//! 
+	//! Supported argument types are arithmetic types, enumerations, pointers and C strings. C strings are copied to the record, while 
+	//! other pointers are recorded as address values.
+	//! @param[in] verbosity The log verbosity.
+	//! @param[in] tag The log tag. Used by the implementation to filter logs.
+	//! @param[in] format The log message format. The format string is not copied, so it must be valid until the 
+	//! log system is closed. String literals are recommended.
+	//! @param[in] args Arguments used to format the log message.
+	template <typename... _Args>
+	inline void log_record(LogVerbosity verbosity, const c8* tag, const c8* format, const _Args&... args)
+	{
+		if (!is_log_verbosity_enabled(verbosity)) return;
+		constexpr usize STACK_BUFFER_SIZE = 256;
+		usize size = (Impl::get_log_arg_size(args) + ... + 0);
+		u8 stack_buf[STACK_BUFFER_SIZE];
+		u8* buf = size <= STACK_BUFFER_SIZE ? stack_buf : (u8*)memalloc(size);
+		u8* dst = buf;
+		(Impl::encode_log_arg(dst, args), ...);
+		submit_log_record(verbosity, tag, format, buf, size);
+		if (buf != stack_buf) memfree(buf);
+	}
+
 	//! @brief Registers one custom log handler that will be called when a new log message is spawned.
+	//! @details Structured log records emitted by @ref log_record are formatted before they are passed to this handler.
 	//! @param[in] handler The handler to register.
+	//! @param[in] max_verbosity The maximum log verbosity level that will be passed to this handler.
 	//! @return Returns one handler identifier that can be used to register the handler.
-	LUNA_RUNTIME_API usize register_log_handler(const Function<log_callback_t>& handler);
+	LUNA_RUNTIME_API usize register_log_handler(const Function<log_callback_t>& handler, LogVerbosity max_verbosity = LogVerbosity::verbose);
+	//! @brief Registers one custom log handler that will be called when a new structured log record is emitted.
+	//! @details Unlike handlers registered by @ref register_log_handler, this handler receives log records whose messages are not formatted, 
+	//! and the handler may use @ref format_log_record to format the message when needed. Log messages emitted by @ref log are not 
+	//! passed to this handler.
+	//! @param[in] handler The handler to register.
+	//! @param[in] max_verbosity The maximum log verbosity level that will be passed to this handler.
+	//! @return Returns one handler identifier that can be used to register the handler.
+	LUNA_RUNTIME_API usize register_log_record_handler(const Function<log_record_callback_t>& handler, LogVerbosity max_verbosity = LogVerbosity::verbose);
 	//! @brief Unregisters one registered log handler.
-	//! @param[in] handler_id The handler identifier returned by @ref register_log_handler for the handler to be unregistered.
+	//! @param[in] handler_id The handler identifier returned by @ref register_log_handler or @ref register_log_record_handler 
+	//! for the handler to be unregistered.
 	LUNA_RUNTIME_API void unregister_log_handler(usize handler_id);
 
 	//! @brief Enables or disables outputting log messages to platform's default logging device.
@@ -132,11 +287,67 @@ namespace Luna
 	//! @brief Sets the maximum log verbosity level that will be outputted to the log file.
 	//! @param[in] verbosity Specifies the maximum log verbosity level that will be outputted to the log file.
 	LUNA_RUNTIME_API void set_log_to_file_verbosity(LogVerbosity verbosity);
-	//! @brief Flushes the log-to-file cache and writes all cached logs to the log file.
+	//! @brief Flushes the log-to-file cache and writes all cached logs to the log file and the binary log file.
 	//! @remark For performance reasons, when logging-to-file is enabled, log messages will be cached in a log buffer and written
 	//! to the log file in one call when the buffer is full. The user can also call @ref flush_log_to_file to flush the cache
 	//! manually when needed.
 	LUNA_RUNTIME_API void flush_log_to_file();
 
+	//! @brief Enables or disables outputting log messages and structured log records to the binary log file.
+	//! @details The binary log file stores structured log records without formatting them, and can be decoded offline by the `LogDecoder` program.
+	//! Log messages emitted by @ref log are stored as formatted strings.
+	//! @param[in] enabled Specifies `true` to enable logging to binary file. Specify `false` to disable it.
+	LUNA_RUNTIME_API void set_log_to_binary_file_enabled(bool enabled);
+	//! @brief Sets the file path of the binary log file.
+	//! @param[in] file The file path of the binary log file. The file path may be absolute or relative to the current working directory.
+	//! @remark If the binary log file path is not set by the user, the default binary log file path will be `"./Log.bin"`.
+	//! The binary log file will be overwritten when the first log is written to it.
+	LUNA_RUNTIME_API void set_log_binary_file(const c8* file);
+	//! @brief Sets the maximum log verbosity level that will be outputted to the binary log file.
+	//! @param[in] verbosity Specifies the maximum log verbosity level that will be outputted to the binary log file.
+	LUNA_RUNTIME_API void set_log_to_binary_file_verbosity(LogVerbosity verbosity);
+
+	//! @brief Specifies the behavior of one log call when the asynchronous log queue of the calling thread is full.
+	enum class LogQueueFullPolicy : u8
+	{
+		//! Discards the new log message. The number of discarded messages can be fetched by @ref get_log_dropped_count.
+		drop = 0,
+		//! Blocks the calling thread until the logger thread frees enough space for the new log message.
+		block = 1,
+	};
+
+	//! @brief Enables or disables asynchronous logging.
+	//! @details When asynchronous logging is enabled, every log call formats the log message and pushes it to one lock-free
+	//! queue owned by the calling thread, then returns immediately. One background logger thread drains all queues in batches and
+	//! calls log handlers on behalf of the logging threads, so that slow handlers (like writing logs to file) do not block the logging
+	//! threads.
+	//! 
+	//! When asynchronous logging is disabled, log handlers are called synchronously by the logging thread. Disabling asynchronous logging
+	//! dispatches all pending log messages before this function returns.
+	//! 
+	//! Asynchronous logging is disabled by default.
+	//! @param[in] enabled Specifies `true` to enable asynchronous logging. Specify `false` to disable it.
+	//! @remark Log messages emitted by the same thread are always dispatched in emission order, but log messages emitted by different
+	//! threads may be dispatched in any order. Log messages with @ref LogVerbosity::fatal_error verbosity are always dispatched synchronously 
+	//! after all pending log messages are dispatched.
+	LUNA_RUNTIME_API void set_log_async_enabled(bool enabled);
+	//! @brief Sets the size, in bytes, of the asynchronous log queue for every thread.
+	//! @details The size will be rounded up to the next power of two. The new size only applies to threads that emit their first log message
+	//! after this call. The default queue size is 64KB.
+	//! @remark One log message larger than half of the queue size is truncated. One log record whose arguments cannot fit in half of the
+	//! queue is discarded and counted by @ref get_log_dropped_count.
+	//! @param[in] size The new size of the asynchronous log queue.
+	LUNA_RUNTIME_API void set_log_async_queue_size(usize size);
+	//! @brief Sets the behavior of log calls when the asynchronous log queue of the calling thread is full.
+	//! @details The default policy is @ref LogQueueFullPolicy::drop.
+	//! @param[in] policy The policy to set.
+	LUNA_RUNTIME_API void set_log_async_queue_full_policy(LogQueueFullPolicy policy);
+	//! @brief Dispatches all pending asynchronous log messages to log handlers and flushes the log-to-file cache.
+	//! @details This function blocks until all log messages emitted before this call are dispatched.
+	LUNA_RUNTIME_API void flush_log();
+	//! @brief Gets the number of log messages discarded because the asynchronous log queue of the logging thread is full.
+	//! @return Returns the number of discarded log messages since the log system is initialized.
+	LUNA_RUNTIME_API u64 get_log_dropped_count();
+
 	//! @}
 }
\ No newline at end of file
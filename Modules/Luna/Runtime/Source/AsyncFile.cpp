@@ -0,0 +1,298 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncFile.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RUNTIME_API LUNA_EXPORT
+#include "AsyncFile.hpp"
+#include "File.hpp"
+#include "OS.hpp"
+#include "../Mutex.hpp"
+#include "../Semaphore.hpp"
+#include "../Thread.hpp"
+#include "../RingDeque.hpp"
+
+namespace Luna
+{
+	//! The maximum number of operations in flight in the native queue.
+	constexpr u32 NATIVE_FILE_IO_QUEUE_DEPTH = 256;
+	//! The number of I/O threads that execute blocking operations.
+	constexpr u32 NUM_FILE_IO_THREADS = 4;
+
+	struct AsyncFileIO
+	{
+		Ref<IMutex> mutex;
+		bool started = false;
+		bool exiting = false;
+
+		// Native queue.
+		opaque_t native_queue = nullptr;
+		Ref<IThread> completion_thread;
+		u32 native_in_flight = 0;
+		//! Operations waiting for the native queue to have free slots.
+		RingDeque<FileIOOperation*> native_pending;
+
+		// Blocking I/O threads.
+		Vector<Ref<IThread>> io_threads;
+		RingDeque<FileIOOperation*> io_thread_queue;
+		Ref<ISemaphore> io_thread_semaphore;
+		//! Serializes seek-and-read/write operations on files not opened by `open_file`.
+		Ref<IMutex> stream_mutex;
+	};
+
+	static AsyncFileIO* g_async_file_io;
+
+	static void complete_operation(FileIOOperation* op, const RV& result, usize transferred_bytes)
+	{
+		FileIOBatch* batch = op->m_batch;
+		batch->m_results[op->m_index] = result;
+		batch->m_transferred_bytes[op->m_index] = transferred_bytes;
+		if (batch->m_callback)
+		{
+			batch->m_callback(op->m_index, result, transferred_bytes);
+		}
+		if (!atom_dec_usize(&batch->m_num_pending))
+		{
+			batch->m_files.clear();
+			batch->m_signal->trigger();
+			// Releases the reference added in `submit_file_io`.
+			object_release(batch->get_object());
+		}
+	}
+
+	static void execute_blocking_operation(FileIOOperation* op)
+	{
+		const FileIORequest& req = op->m_batch->m_requests[op->m_index];
+		File* native_file = cast_object<File>(req.file->get_object());
+		usize transferred_bytes = 0;
+		RV r;
+		if (native_file)
+		{
+			// Continues from the data transferred by native operations.
+			u64 offset = req.offset + op->m_transferred_bytes;
+			void* buffer = (u8*)req.buffer + op->m_transferred_bytes;
+			usize size = req.size - op->m_transferred_bytes;
+			r = req.op == FileIOOp::read ?
+				OS::read_file_at(native_file->m_file, offset, buffer, size, &transferred_bytes) :
+				OS::write_file_at(native_file->m_file, offset, buffer, size, &transferred_bytes);
+			transferred_bytes += op->m_transferred_bytes;
+		}
+		else
+		{
+			MutexGuard guard(g_async_file_io->stream_mutex);
+			r = req.file->seek((i64)req.offset, SeekMode::begin);
+			if (succeeded(r))
+			{
+				r = req.op == FileIOOp::read ?
+					req.file->read(req.buffer, req.size, &transferred_bytes) :
+					req.file->write(req.buffer, req.size, &transferred_bytes);
+			}
+		}
+		complete_operation(op, r, transferred_bytes);
+	}
+
+	// Must be called with `g_async_file_io->mutex` locked.
+	static void push_blocking_operation(FileIOOperation* op)
+	{
+		g_async_file_io->io_thread_queue.push_back(op);
+		g_async_file_io->io_thread_semaphore->release();
+	}
+
+	// Must be called with `g_async_file_io->mutex` locked and `native_in_flight` smaller than the queue depth.
+	static void submit_native_operation(FileIOOperation* op)
+	{
+		const FileIORequest& req = op->m_batch->m_requests[op->m_index];
+		File* native_file = cast_object<File>(req.file->get_object());
+		RV r = OS::submit_async_file_io(g_async_file_io->native_queue, native_file->m_file, req.op == FileIOOp::write, 
+			req.offset + op->m_transferred_bytes, (u8*)req.buffer + op->m_transferred_bytes, req.size - op->m_transferred_bytes, op);
+		if (succeeded(r))
+		{
+			++g_async_file_io->native_in_flight;
+		}
+		else
+		{
+			push_blocking_operation(op);
+		}
+	}
+
+	static void completion_thread_run(void* params)
+	{
+		AsyncFileIO* ctx = g_async_file_io;
+		OS::AsyncFileIOCompletion completions[64];
+		while (true)
+		{
+			usize num_completions = OS::wait_async_file_io(ctx->native_queue, completions, 64);
+			FileIOOperation* resubmit_ops[64];
+			usize num_resubmit_ops = 0;
+			for (usize i = 0; i < num_completions; ++i)
+			{
+				FileIOOperation* op = (FileIOOperation*)completions[i].userdata;
+				const FileIORequest& req = op->m_batch->m_requests[op->m_index];
+				usize transferred_bytes = op->m_transferred_bytes + completions[i].transferred_bytes;
+				if (succeeded(completions[i].result) && completions[i].transferred_bytes && transferred_bytes < req.size)
+				{
+					// Short reads and writes are submitted again for the remaining data. Reads that transfer 
+					// 0 bytes reach the end of the file and are completed.
+					op->m_transferred_bytes = transferred_bytes;
+					resubmit_ops[num_resubmit_ops++] = op;
+				}
+				else
+				{
+					complete_operation(op, completions[i].result, transferred_bytes);
+				}
+			}
+			MutexGuard guard(ctx->mutex);
+			ctx->native_in_flight -= (u32)num_completions;
+			for (usize i = 0; i < num_resubmit_ops; ++i)
+			{
+				submit_native_operation(resubmit_ops[i]);
+			}
+			while (!ctx->native_pending.empty() && ctx->native_in_flight < NATIVE_FILE_IO_QUEUE_DEPTH)
+			{
+				FileIOOperation* op = ctx->native_pending.front();
+				ctx->native_pending.pop_front();
+				submit_native_operation(op);
+			}
+			if (ctx->exiting && !ctx->native_in_flight && ctx->native_pending.empty()) break;
+		}
+	}
+
+	static void io_thread_run(void* params)
+	{
+		AsyncFileIO* ctx = g_async_file_io;
+		while (true)
+		{
+			ctx->io_thread_semaphore->wait();
+			FileIOOperation* op = nullptr;
+			{
+				MutexGuard guard(ctx->mutex);
+				if (!ctx->io_thread_queue.empty())
+				{
+					op = ctx->io_thread_queue.front();
+					ctx->io_thread_queue.pop_front();
+				}
+				else if (ctx->exiting)
+				{
+					break;
+				}
+			}
+			if (op) execute_blocking_operation(op);
+		}
+	}
+
+	// Must be called with `g_async_file_io->mutex` locked.
+	static void start_async_file_io()
+	{
+		AsyncFileIO* ctx = g_async_file_io;
+		if (ctx->started) return;
+		auto queue = OS::new_async_file_io_queue(NATIVE_FILE_IO_QUEUE_DEPTH);
+		if (succeeded(queue))
+		{
+			ctx->native_queue = queue.get();
+			ctx->completion_thread = new_thread(completion_thread_run, nullptr, "File I/O Completion");
+		}
+		ctx->io_thread_semaphore = new_semaphore(0, I32_MAX);
+		ctx->stream_mutex = new_mutex();
+		for (u32 i = 0; i < NUM_FILE_IO_THREADS; ++i)
+		{
+			ctx->io_threads.push_back(new_thread(io_thread_run, nullptr, "File I/O"));
+		}
+		ctx->started = true;
+	}
+
+	void async_file_io_init()
+	{
+		g_async_file_io = memnew<AsyncFileIO>();
+		g_async_file_io->mutex = new_mutex();
+	}
+	void async_file_io_close()
+	{
+		AsyncFileIO* ctx = g_async_file_io;
+		if (ctx->started)
+		{
+			{
+				MutexGuard guard(ctx->mutex);
+				ctx->exiting = true;
+			}
+			// Threads exit after all submitted operations are completed. The completion thread
+			// may move failed native operations to I/O threads, so it must exit first.
+			if (ctx->native_queue)
+			{
+				OS::interrupt_async_file_io_wait(ctx->native_queue);
+				ctx->completion_thread->wait();
+				OS::close_async_file_io_queue(ctx->native_queue);
+			}
+			for (u32 i = 0; i < NUM_FILE_IO_THREADS; ++i)
+			{
+				ctx->io_thread_semaphore->release();
+			}
+			for (auto& t : ctx->io_threads)
+			{
+				t->wait();
+			}
+		}
+		memdelete(ctx);
+		g_async_file_io = nullptr;
+	}
+
+	LUNA_RUNTIME_API R<Ref<IFileIOBatch>> submit_file_io(Span<const FileIORequest> requests, const Function<file_io_callback_t>& callback)
+	{
+		Ref<FileIOBatch> batch = new_object<FileIOBatch>();
+		usize num_requests = requests.size();
+		batch->m_signal = new_signal(true);
+		batch->m_callback = callback;
+		batch->m_requests.assign(requests.begin(), requests.end());
+		batch->m_files.reserve(num_requests);
+		batch->m_operations.reserve(num_requests);
+		for (usize i = 0; i < num_requests; ++i)
+		{
+			lucheck(requests[i].file);
+			batch->m_files.push_back(requests[i].file);
+			batch->m_operations.push_back({ batch.get(), i, 0 });
+		}
+		batch->m_results.resize(num_requests, ok);
+		batch->m_transferred_bytes.resize(num_requests, 0);
+		if (!num_requests)
+		{
+			batch->m_signal->trigger();
+			return Ref<IFileIOBatch>(batch);
+		}
+		batch->m_num_pending = num_requests;
+		// Keeps the batch alive until all requests complete.
+		object_retain(batch->get_object());
+		AsyncFileIO* ctx = g_async_file_io;
+		MutexGuard guard(ctx->mutex);
+		start_async_file_io();
+		for (auto& op : batch->m_operations)
+		{
+			const FileIORequest& req = batch->m_requests[op.m_index];
+			bool native = ctx->native_queue && req.size <= U32_MAX && cast_object<File>(req.file->get_object());
+			if (!native)
+			{
+				push_blocking_operation(&op);
+			}
+			else if (ctx->native_in_flight < NATIVE_FILE_IO_QUEUE_DEPTH)
+			{
+				submit_native_operation(&op);
+			}
+			else
+			{
+				ctx->native_pending.push_back(&op);
+			}
+		}
+		return Ref<IFileIOBatch>(batch);
+	}
+
+	LUNA_RUNTIME_API bool is_native_async_file_io_supported()
+	{
+		AsyncFileIO* ctx = g_async_file_io;
+		MutexGuard guard(ctx->mutex);
+		start_async_file_io();
+		return ctx->native_queue != nullptr;
+	}
+}
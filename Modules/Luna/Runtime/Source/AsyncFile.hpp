@@ -0,0 +1,77 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncFile.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../AsyncFile.hpp"
+#include "../Signal.hpp"
+#include "../Atomic.hpp"
+
+namespace Luna
+{
+	struct FileIOBatch;
+
+	struct FileIOOperation
+	{
+		FileIOBatch* m_batch;
+		usize m_index;
+		//! The number of bytes transferred by former native operations if the operation is split 
+		//! because of short reads or writes.
+		usize m_transferred_bytes;
+	};
+
+	struct FileIOBatch : IFileIOBatch
+	{
+		lustruct("FileIOBatch", "{4f8a2c61-d93e-4b07-8e15-a6c37b90d2f4}");
+		luiimpl();
+
+		Vector<FileIORequest> m_requests;
+		//! Holds references to files until all requests complete.
+		Vector<Ref<IFile>> m_files;
+		Vector<FileIOOperation> m_operations;
+		Vector<RV> m_results;
+		Vector<usize> m_transferred_bytes;
+		Function<file_io_callback_t> m_callback;
+		//! Manual-reset signal triggered when all requests complete.
+		Ref<ISignal> m_signal;
+		volatile usize m_num_pending;
+
+		FileIOBatch() :
+			m_num_pending(0) {}
+
+		virtual void wait() override
+		{
+			m_signal->wait();
+		}
+		virtual bool try_wait() override
+		{
+			return m_signal->try_wait();
+		}
+		virtual usize get_num_requests() override
+		{
+			return m_requests.size();
+		}
+		virtual bool is_finished() override
+		{
+			return atom_add_usize(&m_num_pending, 0) == 0;
+		}
+		virtual RV get_result(usize index) override
+		{
+			lucheck(index < m_results.size());
+			return m_results[index];
+		}
+		virtual usize get_transferred_bytes(usize index) override
+		{
+			lucheck(index < m_transferred_bytes.size());
+			return m_transferred_bytes[index];
+		}
+	};
+
+	void async_file_io_init();
+	void async_file_io_close();
+}
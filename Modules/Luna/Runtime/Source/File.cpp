@@ -47,6 +47,40 @@ namespace Luna
 		lucatchret;
 		return ret;
 	}
+	LUNA_RUNTIME_API R<Ref<IFileMapping>> map_file(IFile* file, u64 offset, usize size, FileMapFlag flags)
+	{
+		lucheck(file);
+		Ref<IFileMapping> ret;
+		lutry
+		{
+			u64 file_size = file->get_size();
+			if (offset > file_size) return BasicError::out_of_range();
+			if (size == USIZE_MAX) size = (usize)(file_size - offset);
+			else if (size > file_size - offset) return BasicError::out_of_range();
+			auto mapping = new_object<FileMapping>();
+			File* native_file = cast_object<File>(file->get_object());
+			if (native_file && size)
+			{
+				void* data;
+				luset(mapping->m_mapping, OS::map_file(native_file->m_file, offset, size, test_flags(flags, FileMapFlag::copy_on_write), &data));
+				mapping->m_data = (byte_t*)data;
+			}
+			else if (size)
+			{
+				// Fall back to reading the range into memory.
+				mapping->m_buffer.resize(size);
+				lulet(cursor, file->tell());
+				luexp(file->seek((i64)offset, SeekMode::begin));
+				luexp(file->read(mapping->m_buffer.data(), size));
+				luexp(file->seek((i64)cursor, SeekMode::begin));
+				mapping->m_data = mapping->m_buffer.data();
+			}
+			mapping->m_size = size;
+			ret = mapping;
+		}
+		lucatchret;
+		return ret;
+	}
 	LUNA_RUNTIME_API R<FileAttribute> get_file_attribute(const c8* filename)
 	{
 		return OS::get_file_attribute(filename);
@@ -60,6 +60,37 @@ namespace Luna
 			OS::flush_file(m_file);
 		}
 	};
+	struct FileMapping : IFileMapping
+	{
+		lustruct("FileMapping", "{0e6f4b1a-8d52-4c7e-b3a9-5f12c6d80e47}");
+		luiimpl();
+
+		//! The platform mapping handle, or `nullptr` if the data is stored in `m_buffer`.
+		opaque_t m_mapping;
+		byte_t* m_data;
+		usize m_size;
+		Blob m_buffer;
+
+		FileMapping() :
+			m_mapping(nullptr),
+			m_data(nullptr),
+			m_size(0) {}
+		~FileMapping()
+		{
+			if (m_mapping)
+			{
+				OS::unmap_file(m_mapping);
+			}
+		}
+		virtual byte_t* get_data() override
+		{
+			return m_data;
+		}
+		virtual usize get_size() override
+		{
+			return m_size;
+		}
+	};
 	struct FileIterator : IFileIterator
 	{
 		lustruct("FileIterator", "{bd87c27c-34ed-4764-8417-6ef37c316ed3}");
@@ -0,0 +1,30 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file FileWatcher.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_RUNTIME_API LUNA_EXPORT
+#include "FileWatcher.hpp"
+
+namespace Luna
+{
+	LUNA_RUNTIME_API R<Ref<IFileWatcher>> watch_dir(const c8* path)
+	{
+		lucheck(path);
+		Ref<IFileWatcher> ret;
+		lutry
+		{
+			lulet(handle, OS::new_file_watcher(path));
+			auto watcher = new_object<FileWatcher>();
+			watcher->m_watcher = handle;
+			ret = watcher;
+		}
+		lucatchret;
+		return ret;
+	}
+}
@@ -0,0 +1,40 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file FileWatcher.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "../FileWatcher.hpp"
+#include "../TSAssert.hpp"
+#include "OS.hpp"
+
+namespace Luna
+{
+	struct FileWatcher : IFileWatcher
+	{
+		lustruct("FileWatcher", "{a61d3b8e-47c2-4f05-9d7b-18e6c2f3a940}");
+		luiimpl();
+		lutsassert_lock();
+
+		opaque_t m_watcher;
+
+		FileWatcher() :
+			m_watcher(nullptr) {}
+		~FileWatcher()
+		{
+			if (m_watcher)
+			{
+				OS::close_file_watcher(m_watcher);
+			}
+		}
+		virtual RV read_changes(Vector<FileChange>& changes) override
+		{
+			lutsassert();
+			return OS::read_file_watcher_changes(m_watcher, changes);
+		}
+	};
+}
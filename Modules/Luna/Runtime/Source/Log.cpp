@@ -12,15 +12,32 @@
 #include "../Log.hpp"
 #include "../Mutex.hpp"
 #include "../File.hpp"
-#include "../Event.hpp"
+#include "../Thread.hpp"
+#include "../Signal.hpp"
+#include "../Atomic.hpp"
+#include "../Vector.hpp"
+#include "../HashMap.hpp"
 #include "OS.hpp"
 
 namespace Luna
 {	
-	static Event<log_callback_t> g_log_callbacks;
+	struct LogHandler
+	{
+		usize id;
+		LogVerbosity max_verbosity;
+		Function<log_callback_t> callback;
+		Function<log_record_callback_t> record_callback;
+	};
+	static Vector<LogHandler> g_log_handlers;
+	static usize g_next_log_handler_id;
 
 	static Ref<IMutex> g_log_mutex;
 
+	//! The maximum verbosity accepted by any log handler, or `-1` if no handler accepts any log.
+	static volatile i32 g_log_max_verbosity = -1;
+	//! The maximum verbosity accepted by any handler that needs formatted log messages.
+	static i32 g_log_text_max_verbosity = -1;
+
 	inline const c8* print_verbosity(LogVerbosity verbosity)
 	{
 		switch (verbosity)
@@ -41,7 +58,7 @@ namespace Luna
 		LogVerbosity verbosity = LogVerbosity::info;
 	};
 	static PlatformLog g_platform_log;
-	void platform_log(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	static void platform_log(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
 	{
 		if (g_platform_log.enabled && (u8)verbosity <= (u8)g_platform_log.verbosity)
 		{
@@ -77,7 +94,7 @@ namespace Luna
 		}
 	}
 
-	void file_log(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	static void file_log(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
 	{
 		FileLog* data = g_filelog;
 		if (data->enabled && (u8)verbosity <= (u8)data->verbosity)
@@ -97,19 +114,582 @@ namespace Luna
 		}
 	}
 
+	// Binary log file format:
+	// The file begins with the 8-byte magic "LUNALOG\0" and one `u32` version number, followed by chunks. Every chunk 
+	// begins with one `u8` chunk type. All numbers are stored in little-endian without padding.
+	// * format chunk: `u32` format ID, `u32` format string length, format string characters.
+	// * record chunk: `u8` verbosity, `u32` format ID, `u16` tag length, tag characters, `u32` arguments size, packed arguments.
+	// * message chunk: `u8` verbosity, `u16` tag length, tag characters, `u32` message length, message characters.
+	// The format chunk for one format ID is always written before the first record chunk that uses the format ID.
+	constexpr u32 BINARY_LOG_VERSION = 1;
+	constexpr u8 BINARY_LOG_CHUNK_FORMAT = 0;
+	constexpr u8 BINARY_LOG_CHUNK_RECORD = 1;
+	constexpr u8 BINARY_LOG_CHUNK_MESSAGE = 2;
+
+	struct BinaryFileLog
+	{
+		bool enabled = false;
+		LogVerbosity verbosity = LogVerbosity::verbose;
+		//! `true` if the file is created and the file header is written.
+		bool file_created = false;
+		Name filename;
+		Vector<u8> log_buffer;
+		HashMap<const c8*, u32> format_ids;
+	};
+
+	static BinaryFileLog* g_binary_filelog;
+
+	static void flush_binary_log_file()
+	{
+		BinaryFileLog* data = g_binary_filelog;
+		if (!data->log_buffer.empty())
+		{
+			lutry
+			{
+				lulet(f, open_file(data->filename.c_str(), FileOpenFlag::write, 
+					data->file_created ? FileCreationMode::open_always : FileCreationMode::create_always));
+				luexp(f->seek(0, SeekMode::end));
+				luexp(f->write(data->log_buffer.data(), data->log_buffer.size()));
+				data->file_created = true;
+				data->log_buffer.clear();
+			}
+			lucatch
+			{
+				return;
+			}
+		}
+	}
+
+	template <typename _Ty>
+	inline void write_binary_log(const _Ty& value)
+	{
+		auto& buffer = g_binary_filelog->log_buffer;
+		usize offset = buffer.size();
+		buffer.resize(offset + sizeof(_Ty));
+		memcpy(buffer.data() + offset, &value, sizeof(_Ty));
+	}
+	inline void write_binary_log(const void* data, usize size)
+	{
+		auto& buffer = g_binary_filelog->log_buffer;
+		usize offset = buffer.size();
+		buffer.resize(offset + size);
+		memcpy(buffer.data() + offset, data, size);
+	}
+	inline void begin_binary_log_chunk(u8 chunk_type)
+	{
+		if (!g_binary_filelog->file_created && g_binary_filelog->log_buffer.empty())
+		{
+			write_binary_log("LUNALOG", 8);
+			write_binary_log(BINARY_LOG_VERSION);
+		}
+		write_binary_log(chunk_type);
+	}
+	inline void write_binary_log_tag(const c8* tag, usize tag_length)
+	{
+		u16 len = (u16)min<usize>(tag_length, U16_MAX);
+		write_binary_log(len);
+		write_binary_log(tag, len);
+	}
+	inline void end_binary_log_chunk()
+	{
+		if (g_binary_filelog->log_buffer.size() > 64_kb)
+		{
+			flush_binary_log_file();
+		}
+	}
+
+	static void binary_file_log_message(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	{
+		BinaryFileLog* data = g_binary_filelog;
+		if (data->enabled && (u8)verbosity <= (u8)data->verbosity)
+		{
+			begin_binary_log_chunk(BINARY_LOG_CHUNK_MESSAGE);
+			write_binary_log((u8)verbosity);
+			write_binary_log_tag(tag, tag_length);
+			write_binary_log((u32)message_length);
+			write_binary_log(message, message_length);
+			end_binary_log_chunk();
+		}
+	}
+
+	static void binary_file_log_record(const LogRecord& record)
+	{
+		BinaryFileLog* data = g_binary_filelog;
+		if (data->enabled && (u8)record.verbosity <= (u8)data->verbosity)
+		{
+			u32 format_id;
+			auto iter = data->format_ids.find(record.format);
+			if (iter == data->format_ids.end())
+			{
+				format_id = (u32)data->format_ids.size();
+				data->format_ids.insert(make_pair(record.format, format_id));
+				u32 format_length = (u32)strlen(record.format);
+				begin_binary_log_chunk(BINARY_LOG_CHUNK_FORMAT);
+				write_binary_log(format_id);
+				write_binary_log(format_length);
+				write_binary_log(record.format, format_length);
+			}
+			else
+			{
+				format_id = iter->second;
+			}
+			begin_binary_log_chunk(BINARY_LOG_CHUNK_RECORD);
+			write_binary_log((u8)record.verbosity);
+			write_binary_log(format_id);
+			write_binary_log_tag(record.tag, strlen(record.tag));
+			write_binary_log((u32)record.args_size);
+			write_binary_log(record.args, record.args_size);
+			end_binary_log_chunk();
+		}
+	}
+
+	//! Recomputes the maximum accepted verbosity. Must be called with `g_log_mutex` locked.
+	static void update_log_max_verbosity()
+	{
+		i32 text_max_verbosity = -1;
+		i32 record_max_verbosity = -1;
+		if (g_platform_log.enabled) text_max_verbosity = max(text_max_verbosity, (i32)g_platform_log.verbosity);
+		if (g_filelog->enabled) text_max_verbosity = max(text_max_verbosity, (i32)g_filelog->verbosity);
+		if (g_binary_filelog->enabled) record_max_verbosity = (i32)g_binary_filelog->verbosity;
+		for (auto& handler : g_log_handlers)
+		{
+			if (handler.callback) text_max_verbosity = max(text_max_verbosity, (i32)handler.max_verbosity);
+			else record_max_verbosity = max(record_max_verbosity, (i32)handler.max_verbosity);
+		}
+		g_log_text_max_verbosity = text_max_verbosity;
+		g_log_max_verbosity = max(text_max_verbosity, record_max_verbosity);
+	}
+
+	//! Dispatches one formatted log message to all handlers that need formatted log messages. 
+	//! Must be called with `g_log_mutex` locked.
+	static void dispatch_log_text(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	{
+		platform_log(verbosity, tag, tag_length, message, message_length);
+		file_log(verbosity, tag, tag_length, message, message_length);
+		for (auto& handler : g_log_handlers)
+		{
+			if (handler.callback && (u8)verbosity <= (u8)handler.max_verbosity)
+			{
+				handler.callback(verbosity, tag, tag_length, message, message_length);
+			}
+		}
+	}
+
+	//! Dispatches one log message emitted by `log`. Must be called with `g_log_mutex` locked.
+	static void dispatch_log_message(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	{
+		dispatch_log_text(verbosity, tag, tag_length, message, message_length);
+		binary_file_log_message(verbosity, tag, tag_length, message, message_length);
+	}
+
+	constexpr usize LOG_STACK_BUFFER_SIZE = 256;
+
+	//! Dispatches one structured log record. Must be called with `g_log_mutex` locked.
+	static void dispatch_log_record(const LogRecord& record)
+	{
+		for (auto& handler : g_log_handlers)
+		{
+			if (handler.record_callback && (u8)record.verbosity <= (u8)handler.max_verbosity)
+			{
+				handler.record_callback(record);
+			}
+		}
+		binary_file_log_record(record);
+		// Formats the message only if required.
+		if ((i32)record.verbosity <= g_log_text_max_verbosity)
+		{
+			c8 buf[LOG_STACK_BUFFER_SIZE];
+			c8* abuf = nullptr;
+			usize len = format_log_record(record, buf, LOG_STACK_BUFFER_SIZE);
+			if (len >= LOG_STACK_BUFFER_SIZE)
+			{
+				abuf = (c8*)memalloc(sizeof(c8) * (len + 1));
+				len = format_log_record(record, abuf, len + 1);
+			}
+			dispatch_log_text(record.verbosity, record.tag, strlen(record.tag), abuf ? abuf : buf, len);
+			if (abuf) memfree(abuf);
+		}
+	}
+
+	enum class LogQueueEntryType : u8
+	{
+		//! The entry stores one formatted log message.
+		message = 0,
+		//! The entry stores one structured log record.
+		record = 1,
+		//! The entry is only used to fill the tail of the ring buffer and contains no log.
+		padding = 2,
+	};
+	//! The header of one entry in the asynchronous log queue. 
+	//! For message entries, the header is followed by the null-terminated tag and the null-terminated message.
+	//! For record entries, the header is followed by the format string pointer, the null-terminated tag and the packed arguments.
+	struct LogQueueEntry
+	{
+		//! The total size of this entry in bytes, including the header, the payload and the padding.
+		u32 entry_size;
+		//! The length of the message not including the null terminator for message entries, or the size of the 
+		//! packed arguments for record entries.
+		u32 data_size;
+		//! The length of the tag, not including the null terminator.
+		u16 tag_length;
+		LogVerbosity verbosity;
+		LogQueueEntryType type;
+		u32 reserved;
+	};
+	static_assert(sizeof(LogQueueEntry) == 16, "Incorrect LogQueueEntry size.");
+	constexpr usize LOG_QUEUE_ENTRY_ALIGNMENT = 16;
+	constexpr usize LOG_MIN_QUEUE_SIZE = 4_kb;
+
+	//! The single-producer single-consumer ring buffer that stores logs emitted by one thread.
+	//! The producer is the thread that owns the queue, the consumer is the thread that holds `g_log_mutex`.
+	struct LogQueue
+	{
+		u8* m_buffer;
+		usize m_capacity;
+		//! The end position of the last committed entry. Only modified by the producer.
+		volatile usize m_write_pos = 0;
+		//! The end position of the last reserved entry. Only accessed by the producer.
+		usize m_reserved_pos = 0;
+		//! The begin position of the first unconsumed entry. Only modified by the consumer.
+		volatile usize m_read_pos = 0;
+		volatile u32 m_thread_dead = 0;
+		//! `true` if this queue is owned by the logger thread.
+		bool m_logger_thread = false;
+
+		LogQueue(usize capacity) :
+			m_capacity(capacity)
+		{
+			m_buffer = (u8*)memalloc(capacity, LOG_QUEUE_ENTRY_ALIGNMENT);
+		}
+		~LogQueue()
+		{
+			memfree(m_buffer, LOG_QUEUE_ENTRY_ALIGNMENT);
+		}
+	};
+
+	struct AsyncLog
+	{
+		volatile bool enabled = false;
+		volatile bool exiting = false;
+		LogQueueFullPolicy queue_full_policy = LogQueueFullPolicy::drop;
+		usize queue_size = 64_kb;
+		opaque_t queue_tls;
+		//! The number of `LogDispatchGuard` objects of the current thread.
+		opaque_t dispatch_depth_tls;
+		//! Serializes `set_log_async_enabled` calls, so that one new logger thread cannot be created before 
+		//! the old one exits.
+		Ref<IMutex> switch_mutex;
+		//! All log queues. Protected by `g_log_mutex`.
+		Vector<LogQueue*> queues;
+		Ref<IThread> logger_thread;
+		Ref<ISignal> wake_signal;
+		volatile u32 logger_sleeping = 0;
+		volatile u64 dropped_count = 0;
+	};
+
+	static AsyncLog* g_async_log;
+
+	inline usize load_acquire(volatile usize* v)
+	{
+		// Atomic operations imply full memory barriers.
+		return atom_add_usize(v, 0);
+	}
+
+	//! Locks `g_log_mutex` for dispatching logs, and marks the current thread as dispatching logs.
+	//! Log handlers may log again when they are called, and such logs must not wait for the logger thread,
+	//! which needs `g_log_mutex` to proceed.
+	struct LogDispatchGuard
+	{
+		MutexGuard m_guard;
+
+		LogDispatchGuard() :
+			m_guard(g_log_mutex)
+		{
+			usize depth = (usize)OS::tls_get(g_async_log->dispatch_depth_tls);
+			OS::tls_set(g_async_log->dispatch_depth_tls, (void*)(depth + 1));
+		}
+		void unlock()
+		{
+			if (!m_guard.locked()) return;
+			usize depth = (usize)OS::tls_get(g_async_log->dispatch_depth_tls);
+			OS::tls_set(g_async_log->dispatch_depth_tls, (void*)(depth - 1));
+			m_guard.unlock();
+		}
+		~LogDispatchGuard()
+		{
+			unlock();
+		}
+	};
+
+	inline bool is_current_thread_dispatching_logs()
+	{
+		return OS::tls_get(g_async_log->dispatch_depth_tls) != nullptr;
+	}
+
+	static void log_queue_tls_dtor(void* data)
+	{
+		// Marks the queue to be dead, so that it will be deleted after 
+		// all logs in the queue are dispatched.
+		LogQueue* queue = (LogQueue*)data;
+		atom_exchange_u32(&queue->m_thread_dead, 1);
+	}
+
+	static LogQueue* get_current_thread_log_queue()
+	{
+		LogQueue* queue = (LogQueue*)OS::tls_get(g_async_log->queue_tls);
+		if (!queue)
+		{
+			queue = memnew<LogQueue>(g_async_log->queue_size);
+			OS::tls_set(g_async_log->queue_tls, queue);
+			MutexGuard guard(g_log_mutex);
+			g_async_log->queues.push_back(queue);
+		}
+		return queue;
+	}
+
+	//! Dispatches all committed entries in the queue. Must be called with `g_log_mutex` locked.
+	static usize dispatch_log_queue(LogQueue* queue)
+	{
+		usize num_entries = 0;
+		usize read_pos = queue->m_read_pos;
+		usize write_pos = load_acquire(&queue->m_write_pos);
+		while (read_pos != write_pos)
+		{
+			LogQueueEntry* entry = (LogQueueEntry*)(queue->m_buffer + (read_pos & (queue->m_capacity - 1)));
+			if (entry->type == LogQueueEntryType::message)
+			{
+				const c8* tag = (const c8*)(entry + 1);
+				const c8* message = tag + entry->tag_length + 1;
+				dispatch_log_message(entry->verbosity, tag, entry->tag_length, message, entry->data_size);
+				++num_entries;
+			}
+			else if (entry->type == LogQueueEntryType::record)
+			{
+				LogRecord record;
+				record.verbosity = entry->verbosity;
+				memcpy(&record.format, entry + 1, sizeof(const c8*));
+				record.tag = (const c8*)(entry + 1) + sizeof(const c8*);
+				record.args = (const u8*)record.tag + entry->tag_length + 1;
+				record.args_size = entry->data_size;
+				dispatch_log_record(record);
+				++num_entries;
+			}
+			read_pos += entry->entry_size;
+			// Release the space as soon as possible so that blocked producers can proceed.
+			atom_exchange_usize(&queue->m_read_pos, read_pos);
+		}
+		return num_entries;
+	}
+
+	//! Dispatches committed entries in all queues, and deletes queues whose owning threads are dead.
+	//! @return Returns the number of dispatched logs.
+	static usize dispatch_log_queues()
+	{
+		LogDispatchGuard guard;
+		usize num_logs = 0;
+		auto& queues = g_async_log->queues;
+		for (usize i = 0; i < queues.size();)
+		{
+			LogQueue* queue = queues[i];
+			// Checks the dead flag before dispatching, so that logs committed before the thread exits are never lost.
+			bool dead = queue->m_thread_dead != 0;
+			num_logs += dispatch_log_queue(queue);
+			if (dead)
+			{
+				memdelete(queue);
+				queues.erase(queues.begin() + i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		return num_logs;
+	}
+
+	static void logger_thread_run(void* params)
+	{
+		AsyncLog* ctx = g_async_log;
+		get_current_thread_log_queue()->m_logger_thread = true;
+		while (true)
+		{
+			bool exiting = ctx->exiting;
+			if (dispatch_log_queues()) continue;
+			if (exiting) break;
+			// Checks the queues again after marking the sleeping flag, so that logs committed before the 
+			// producer reads the flag are not missed.
+			atom_exchange_u32(&ctx->logger_sleeping, 1);
+			if (dispatch_log_queues() || ctx->exiting)
+			{
+				atom_exchange_u32(&ctx->logger_sleeping, 0);
+				continue;
+			}
+			ctx->wake_signal->wait();
+		}
+	}
+
+	inline void wake_logger_thread()
+	{
+		if (atom_exchange_u32(&g_async_log->logger_sleeping, 0))
+		{
+			g_async_log->wake_signal->trigger();
+		}
+	}
+
+	//! Gets the maximum size of one entry. One entry that wraps around the buffer needs the tail space and its own space,
+	//! so entries no larger than half of the capacity can always be reserved when the queue is empty, wherever the 
+	//! write position is.
+	inline usize get_max_log_queue_entry_size(LogQueue* queue)
+	{
+		return queue->m_capacity / 2;
+	}
+
+	static LogQueueEntry* try_reserve_log_queue_entry(LogQueue* queue, usize entry_size)
+	{
+		usize write_pos = queue->m_write_pos;
+		usize read_pos = load_acquire(&queue->m_read_pos);
+		usize offset = write_pos & (queue->m_capacity - 1);
+		usize tail_size = queue->m_capacity - offset;
+		usize required_size = entry_size <= tail_size ? entry_size : tail_size + entry_size;
+		if (queue->m_capacity - (write_pos - read_pos) < required_size) return nullptr;
+		if (entry_size > tail_size)
+		{
+			// Fills the tail with one padding entry and wraps to the beginning of the buffer.
+			LogQueueEntry* padding = (LogQueueEntry*)(queue->m_buffer + offset);
+			padding->entry_size = (u32)tail_size;
+			padding->type = LogQueueEntryType::padding;
+			queue->m_reserved_pos = write_pos + required_size;
+			return (LogQueueEntry*)queue->m_buffer;
+		}
+		queue->m_reserved_pos = write_pos + entry_size;
+		return (LogQueueEntry*)(queue->m_buffer + offset);
+	}
+
+	static LogQueueEntry* reserve_log_queue_entry(LogQueue* queue, usize entry_size)
+	{
+		while (true)
+		{
+			LogQueueEntry* entry = try_reserve_log_queue_entry(queue, entry_size);
+			if (entry) return entry;
+			// The logger thread cannot wait for itself. Threads that are dispatching logs cannot wait for the 
+			// logger thread either, since they are holding `g_log_mutex` that the logger thread needs.
+			if (g_async_log->queue_full_policy == LogQueueFullPolicy::drop || queue->m_logger_thread || is_current_thread_dispatching_logs())
+			{
+				atom_inc_u64(&g_async_log->dropped_count);
+				return nullptr;
+			}
+			if (g_async_log->enabled)
+			{
+				wake_logger_thread();
+				yield_current_thread();
+			}
+			else
+			{
+				// Asynchronous logging is disabled after this call begins, dispatches logs by ourself.
+				dispatch_log_queues();
+			}
+		}
+	}
+
+	static void async_logv(LogVerbosity verbosity, const c8* tag, const c8* format, VarList args)
+	{
+		LogQueue* queue = get_current_thread_log_queue();
+		c8 buf[LOG_STACK_BUFFER_SIZE];
+		VarList args_copy;
+		va_copy(args_copy, args);
+		i32 len = vsnprintf(buf, LOG_STACK_BUFFER_SIZE, format, args_copy);
+		va_end(args_copy);
+		if (len < 0) return;
+		usize tag_length = min<usize>(strlen(tag), queue->m_capacity / 4);
+		usize message_length = min<usize>((usize)len, get_max_log_queue_entry_size(queue) - sizeof(LogQueueEntry) - tag_length - 2);
+		usize entry_size = align_upper(sizeof(LogQueueEntry) + tag_length + message_length + 2, LOG_QUEUE_ENTRY_ALIGNMENT);
+		LogQueueEntry* entry = reserve_log_queue_entry(queue, entry_size);
+		if (!entry) return;
+		entry->entry_size = (u32)entry_size;
+		entry->data_size = (u32)message_length;
+		entry->tag_length = (u16)tag_length;
+		entry->verbosity = verbosity;
+		entry->type = LogQueueEntryType::message;
+		c8* dst_tag = (c8*)(entry + 1);
+		memcpy(dst_tag, tag, tag_length);
+		dst_tag[tag_length] = 0;
+		c8* dst_message = dst_tag + tag_length + 1;
+		if ((usize)len < LOG_STACK_BUFFER_SIZE)
+		{
+			memcpy(dst_message, buf, message_length);
+			dst_message[message_length] = 0;
+		}
+		else
+		{
+			// Formats long messages directly into the queue to avoid heap allocation.
+			vsnprintf(dst_message, message_length + 1, format, args);
+		}
+		atom_exchange_usize(&queue->m_write_pos, queue->m_reserved_pos);
+		wake_logger_thread();
+	}
+
+	static void async_submit_log_record(LogVerbosity verbosity, const c8* tag, const c8* format, const u8* args, usize args_size)
+	{
+		LogQueue* queue = get_current_thread_log_queue();
+		usize tag_length = min<usize>(strlen(tag), queue->m_capacity / 4);
+		usize entry_size = align_upper(sizeof(LogQueueEntry) + sizeof(const c8*) + tag_length + 1 + args_size, LOG_QUEUE_ENTRY_ALIGNMENT);
+		if (entry_size > get_max_log_queue_entry_size(queue))
+		{
+			atom_inc_u64(&g_async_log->dropped_count);
+			return;
+		}
+		LogQueueEntry* entry = reserve_log_queue_entry(queue, entry_size);
+		if (!entry) return;
+		entry->entry_size = (u32)entry_size;
+		entry->data_size = (u32)args_size;
+		entry->tag_length = (u16)tag_length;
+		entry->verbosity = verbosity;
+		entry->type = LogQueueEntryType::record;
+		u8* dst = (u8*)(entry + 1);
+		memcpy(dst, &format, sizeof(const c8*));
+		dst += sizeof(const c8*);
+		memcpy(dst, tag, tag_length);
+		dst[tag_length] = 0;
+		dst += tag_length + 1;
+		memcpy(dst, args, args_size);
+		atom_exchange_usize(&queue->m_write_pos, queue->m_reserved_pos);
+		wake_logger_thread();
+	}
+
 	void log_init()
 	{
 		g_log_mutex = new_mutex();
-		register_log_handler(platform_log);
 		g_filelog = memnew<FileLog>();
 		g_filelog->filename = "./Log.txt";
-		register_log_handler(file_log);
+		g_binary_filelog = memnew<BinaryFileLog>();
+		g_binary_filelog->filename = "./Log.bin";
+		g_async_log = memnew<AsyncLog>();
+		g_async_log->queue_tls = OS::tls_alloc(log_queue_tls_dtor);
+		g_async_log->dispatch_depth_tls = OS::tls_alloc(nullptr);
+		g_async_log->switch_mutex = new_mutex();
+		g_async_log->wake_signal = new_signal(false);
+		g_next_log_handler_id = 0;
+		update_log_max_verbosity();
 	}
 	void log_close()
 	{
+		set_log_async_enabled(false);
+		dispatch_log_queues();
+		OS::tls_free(g_async_log->queue_tls);
+		OS::tls_free(g_async_log->dispatch_depth_tls);
+		for (LogQueue* queue : g_async_log->queues)
+		{
+			memdelete(queue);
+		}
+		memdelete(g_async_log);
+		g_async_log = nullptr;
 		flush_log_file();
 		memdelete(g_filelog);
-		g_log_callbacks.clear();
+		flush_binary_log_file();
+		memdelete(g_binary_filelog);
+		g_log_handlers.clear();
+		g_log_handlers.shrink_to_fit();
+		g_log_max_verbosity = -1;
 		g_log_mutex = nullptr;
 	}
 	LUNA_RUNTIME_API void log(LogVerbosity verbosity, const c8* tag, const c8* format, ...)
@@ -119,33 +699,91 @@ namespace Luna
 		logv(verbosity, tag, format, args);
 		va_end(args);
 	}
-	constexpr usize LOG_STACK_BUFFER_SIZE = 256;
 	LUNA_RUNTIME_API void logv(LogVerbosity verbosity, const c8* tag, const c8* format, VarList args)
 	{
+		if (!is_log_verbosity_enabled(verbosity)) return;
+		if(!tag) tag = "";
+		if (g_async_log->enabled && verbosity != LogVerbosity::fatal_error)
+		{
+			async_logv(verbosity, tag, format, args);
+			return;
+		}
 		c8 buf[LOG_STACK_BUFFER_SIZE];
 		c8* abuf = nullptr;
-		i32 len = vsnprintf(buf, LOG_STACK_BUFFER_SIZE, format, args);
+		VarList args_copy;
+		va_copy(args_copy, args);
+		i32 len = vsnprintf(buf, LOG_STACK_BUFFER_SIZE, format, args_copy);
+		va_end(args_copy);
 		if (len >= LOG_STACK_BUFFER_SIZE)
 		{
 			abuf = (c8*)memalloc(sizeof(c8) * (len + 1));
 			len = vsnprintf(abuf, len + 1, format, args);
 		}
 		c8* use_buf = abuf ? abuf : buf;
-		MutexGuard guard(g_log_mutex);
-		if(!tag) tag = "";
-		g_log_callbacks(verbosity, tag, strlen(tag), use_buf, len);
+		LogDispatchGuard guard;
+		// Dispatches pending asynchronous logs firstly to keep logs in order.
+		if (!g_async_log->queues.empty()) dispatch_log_queues();
+		dispatch_log_message(verbosity, tag, strlen(tag), use_buf, len);
 		guard.unlock();
 		if (abuf) memfree(abuf);
 	}
-	LUNA_RUNTIME_API usize register_log_handler(const Function<log_callback_t>& handler)
+	LUNA_RUNTIME_API bool is_log_verbosity_enabled(LogVerbosity verbosity)
+	{
+		return (i32)verbosity <= g_log_max_verbosity;
+	}
+	LUNA_RUNTIME_API void submit_log_record(LogVerbosity verbosity, const c8* tag, const c8* format, const u8* args, usize args_size)
+	{
+		if (!is_log_verbosity_enabled(verbosity)) return;
+		if(!tag) tag = "";
+		if (g_async_log->enabled && verbosity != LogVerbosity::fatal_error)
+		{
+			async_submit_log_record(verbosity, tag, format, args, args_size);
+			return;
+		}
+		LogRecord record;
+		record.verbosity = verbosity;
+		record.tag = tag;
+		record.format = format;
+		record.args = args;
+		record.args_size = args_size;
+		LogDispatchGuard guard;
+		if (!g_async_log->queues.empty()) dispatch_log_queues();
+		dispatch_log_record(record);
+	}
+	LUNA_RUNTIME_API usize register_log_handler(const Function<log_callback_t>& handler, LogVerbosity max_verbosity)
 	{
 		MutexGuard guard(g_log_mutex);
-		return g_log_callbacks.add_handler(handler);
+		LogHandler h;
+		h.id = g_next_log_handler_id++;
+		h.max_verbosity = max_verbosity;
+		h.callback = handler;
+		g_log_handlers.push_back(move(h));
+		update_log_max_verbosity();
+		return g_log_handlers.back().id;
+	}
+	LUNA_RUNTIME_API usize register_log_record_handler(const Function<log_record_callback_t>& handler, LogVerbosity max_verbosity)
+	{
+		MutexGuard guard(g_log_mutex);
+		LogHandler h;
+		h.id = g_next_log_handler_id++;
+		h.max_verbosity = max_verbosity;
+		h.record_callback = handler;
+		g_log_handlers.push_back(move(h));
+		update_log_max_verbosity();
+		return g_log_handlers.back().id;
 	}
 	LUNA_RUNTIME_API void unregister_log_handler(usize handler_id)
 	{
 		MutexGuard guard(g_log_mutex);
-		g_log_callbacks.remove_handler(handler_id);
+		for (auto iter = g_log_handlers.begin(); iter != g_log_handlers.end(); ++iter)
+		{
+			if (iter->id == handler_id)
+			{
+				g_log_handlers.erase(iter);
+				break;
+			}
+		}
+		update_log_max_verbosity();
 	}
 	LUNA_RUNTIME_API void log_verbose(const c8* tag, const c8* format, ...)
 	{
@@ -206,16 +844,19 @@ namespace Luna
 	{
 		MutexGuard guard(g_log_mutex);
 		g_platform_log.enabled = enabled;
+		update_log_max_verbosity();
 	}
 	LUNA_RUNTIME_API void set_log_to_platform_verbosity(LogVerbosity verbosity)
 	{
 		MutexGuard guard(g_log_mutex);
 		g_platform_log.verbosity = verbosity;
+		update_log_max_verbosity();
 	}
 	LUNA_RUNTIME_API void set_log_to_file_enabled(bool enabled)
 	{
 		MutexGuard guard(g_log_mutex);
 		g_filelog->enabled = enabled;
+		update_log_max_verbosity();
 	}
 	LUNA_RUNTIME_API void set_log_file(const c8* file)
 	{
@@ -227,10 +868,296 @@ namespace Luna
 	{
 		MutexGuard guard(g_log_mutex);
 		g_filelog->verbosity = verbosity;
+		update_log_max_verbosity();
 	}
 	LUNA_RUNTIME_API void flush_log_to_file()
 	{
 		MutexGuard guard(g_log_mutex);
 		flush_log_file();
+		flush_binary_log_file();
+	}
+	LUNA_RUNTIME_API void set_log_to_binary_file_enabled(bool enabled)
+	{
+		MutexGuard guard(g_log_mutex);
+		g_binary_filelog->enabled = enabled;
+		update_log_max_verbosity();
+	}
+	LUNA_RUNTIME_API void set_log_binary_file(const c8* file)
+	{
+		MutexGuard guard(g_log_mutex);
+		flush_binary_log_file();
+		g_binary_filelog->filename = file;
+		// Format strings should be written again to the new file.
+		g_binary_filelog->file_created = false;
+		g_binary_filelog->log_buffer.clear();
+		g_binary_filelog->format_ids.clear();
+	}
+	LUNA_RUNTIME_API void set_log_to_binary_file_verbosity(LogVerbosity verbosity)
+	{
+		MutexGuard guard(g_log_mutex);
+		g_binary_filelog->verbosity = verbosity;
+		update_log_max_verbosity();
+	}
+	LUNA_RUNTIME_API void set_log_async_enabled(bool enabled)
+	{
+		// Held until the old logger thread exits when disabling.
+		MutexGuard switch_guard(g_async_log->switch_mutex);
+		MutexGuard guard(g_log_mutex);
+		if (enabled == g_async_log->enabled) return;
+		if (enabled)
+		{
+			g_async_log->exiting = false;
+			g_async_log->logger_thread = new_thread(logger_thread_run, nullptr, "Logger");
+			g_async_log->enabled = true;
+		}
+		else
+		{
+			g_async_log->enabled = false;
+			g_async_log->exiting = true;
+			Ref<IThread> logger_thread = move(g_async_log->logger_thread);
+			// The logger thread needs to lock the mutex to dispatch remaining logs.
+			guard.unlock();
+			atom_exchange_u32(&g_async_log->logger_sleeping, 0);
+			g_async_log->wake_signal->trigger();
+			logger_thread->wait();
+			dispatch_log_queues();
+		}
+	}
+	LUNA_RUNTIME_API void set_log_async_queue_size(usize size)
+	{
+		usize queue_size = LOG_MIN_QUEUE_SIZE;
+		while (queue_size < size) queue_size <<= 1;
+		MutexGuard guard(g_log_mutex);
+		g_async_log->queue_size = queue_size;
+	}
+	LUNA_RUNTIME_API void set_log_async_queue_full_policy(LogQueueFullPolicy policy)
+	{
+		MutexGuard guard(g_log_mutex);
+		g_async_log->queue_full_policy = policy;
+	}
+	LUNA_RUNTIME_API void flush_log()
+	{
+		MutexGuard guard(g_log_mutex);
+		dispatch_log_queues();
+		flush_log_file();
+		flush_binary_log_file();
+	}
+	LUNA_RUNTIME_API u64 get_log_dropped_count()
+	{
+		return g_async_log->dropped_count;
+	}
+
+	struct LogArgReader
+	{
+		const u8* cur;
+		const u8* end;
+
+		bool read_type(LogArgType& type)
+		{
+			if (cur >= end) return false;
+			type = (LogArgType)*cur;
+			++cur;
+			return true;
+		}
+		template <typename _Ty>
+		_Ty read_value()
+		{
+			_Ty v = 0;
+			if (cur + sizeof(_Ty) <= end) memcpy(&v, cur, sizeof(_Ty));
+			cur += sizeof(_Ty);
+			return v;
+		}
+		void skip_string()
+		{
+			u32 len = read_value<u32>();
+			cur += len;
+		}
+		i64 read_integer()
+		{
+			LogArgType type;
+			if (!read_type(type)) return 0;
+			switch (type)
+			{
+			case LogArgType::signed_integer: return read_value<i64>();
+			case LogArgType::unsigned_integer: return (i64)read_value<u64>();
+			case LogArgType::floating_point: return (i64)read_value<f64>();
+			case LogArgType::pointer: return (i64)read_value<u64>();
+			case LogArgType::string: skip_string(); return 0;
+			default: cur = end; return 0;
+			}
+		}
+		f64 read_float()
+		{
+			LogArgType type;
+			if (!read_type(type)) return 0.0;
+			switch (type)
+			{
+			case LogArgType::signed_integer: return (f64)read_value<i64>();
+			case LogArgType::unsigned_integer: return (f64)read_value<u64>();
+			case LogArgType::floating_point: return read_value<f64>();
+			case LogArgType::pointer: return (f64)read_value<u64>();
+			case LogArgType::string: skip_string(); return 0.0;
+			default: cur = end; return 0.0;
+			}
+		}
+		bool read_string(const c8*& str, u32& len)
+		{
+			LogArgType type;
+			if (!read_type(type)) return false;
+			if (type != LogArgType::string)
+			{
+				cur += sizeof(u64);
+				return false;
+			}
+			len = read_value<u32>();
+			str = (const c8*)cur;
+			if (cur + len > end) len = (u32)(end - min(cur, end));
+			cur += len;
+			return true;
+		}
+	};
+
+	struct LogFormatWriter
+	{
+		c8* buf;
+		usize buf_size;
+		usize len = 0;
+
+		void write(const c8* str, usize str_len)
+		{
+			if (len < buf_size)
+			{
+				memcpy(buf + len, str, min(str_len, buf_size - len));
+			}
+			len += str_len;
+		}
+		template <typename _Ty>
+		void write_formatted(const c8* spec, _Ty value)
+		{
+			i32 r = len < buf_size ? snprintf(buf + len, buf_size - len, spec, value) : snprintf(nullptr, 0, spec, value);
+			if (r > 0) len += (usize)r;
+		}
+		void write_formatted_string(const c8* spec, i32 precision, const c8* value)
+		{
+			i32 r = len < buf_size ? snprintf(buf + len, buf_size - len, spec, precision, value) : snprintf(nullptr, 0, spec, precision, value);
+			if (r > 0) len += (usize)r;
+		}
+	};
+
+	LUNA_RUNTIME_API usize format_log_record(const LogRecord& record, c8* buf, usize buf_size)
+	{
+		LogArgReader reader;
+		reader.cur = record.args;
+		reader.end = record.args + record.args_size;
+		LogFormatWriter writer;
+		writer.buf = buf;
+		writer.buf_size = buf_size;
+		const c8* cur = record.format;
+		while (*cur)
+		{
+			if (*cur != '%')
+			{
+				const c8* next = strchr(cur, '%');
+				usize n = next ? (usize)(next - cur) : strlen(cur);
+				writer.write(cur, n);
+				cur += n;
+				continue;
+			}
+			if (cur[1] == '%')
+			{
+				writer.write("%", 1);
+				cur += 2;
+				continue;
+			}
+			// Rebuilds the conversion specification with length modifiers that match the stored argument types.
+			++cur;
+			c8 spec[64];
+			usize spec_len = 0;
+			spec[spec_len++] = '%';
+			while (*cur && strchr("-+ #0", *cur) && spec_len < 8) spec[spec_len++] = *cur++;
+			if (*cur == '*')
+			{
+				spec_len += snprintf(spec + spec_len, 16, "%d", (i32)reader.read_integer());
+				++cur;
+			}
+			else
+			{
+				while (*cur >= '0' && *cur <= '9' && spec_len < 24) spec[spec_len++] = *cur++;
+			}
+			i32 precision = -1;
+			if (*cur == '.')
+			{
+				++cur;
+				if (*cur == '*')
+				{
+					precision = (i32)reader.read_integer();
+					++cur;
+				}
+				else
+				{
+					precision = 0;
+					while (*cur >= '0' && *cur <= '9')
+					{
+						precision = precision * 10 + (*cur - '0');
+						++cur;
+					}
+				}
+				if (precision >= 0) spec_len += snprintf(spec + spec_len, 16, ".%d", precision);
+			}
+			while (*cur && strchr("hljztLqI", *cur)) ++cur;
+			c8 conversion = *cur;
+			if (!conversion) break;
+			++cur;
+			switch (conversion)
+			{
+			case 'd': case 'i':
+				strcpy(spec + spec_len, "lld");
+				writer.write_formatted(spec, (long long)reader.read_integer());
+				break;
+			case 'u': case 'o': case 'x': case 'X':
+				spec[spec_len++] = 'l';
+				spec[spec_len++] = 'l';
+				spec[spec_len++] = conversion;
+				spec[spec_len] = 0;
+				writer.write_formatted(spec, (unsigned long long)reader.read_integer());
+				break;
+			case 'c':
+				strcpy(spec + spec_len, "c");
+				writer.write_formatted(spec, (int)reader.read_integer());
+				break;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				spec[spec_len++] = conversion;
+				spec[spec_len] = 0;
+				writer.write_formatted(spec, (double)reader.read_float());
+				break;
+			case 'p':
+				strcpy(spec + spec_len, "p");
+				writer.write_formatted(spec, (void*)(usize)reader.read_integer());
+				break;
+			case 's':
+			{
+				// Strings in records are not null-terminated, so we always pass the length as precision.
+				const c8* str = "(null)";
+				u32 str_len = 6;
+				reader.read_string(str, str_len);
+				if (precision >= 0 && (u32)precision < str_len) str_len = (u32)precision;
+				// Removes the precision written to the specification.
+				c8* dot = strchr(spec, '.');
+				if (dot) spec_len = dot - spec;
+				strcpy(spec + spec_len, ".*s");
+				writer.write_formatted_string(spec, (i32)str_len, str);
+				break;
+			}
+			default:
+				// Unsupported conversion (including `%n`), skip one argument.
+				reader.read_integer();
+				break;
+			}
+		}
+		if (buf_size)
+		{
+			buf[min(writer.len, buf_size - 1)] = 0;
+		}
+		return writer.len;
 	}
 }
\ No newline at end of file
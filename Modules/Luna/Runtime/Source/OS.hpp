@@ -17,6 +17,7 @@
 #include "../Time.hpp"
 #include "../Thread.hpp"
 #include "../File.hpp"
+#include "../FileWatcher.hpp"
 #include "../Log.hpp"
 namespace Luna
 {
@@ -377,6 +378,100 @@ namespace Luna
 		//! @param[in] file The file handle opened by `open_file`.
 		void flush_file(opaque_t file);
 
+		//! Maps one range of the file into the virtual address space of the current process.
+		//! @param[in] file The file handle opened by `open_file`. The file must be opened with `FileOpenFlag::read`.
+		//! @param[in] offset The offset, in bytes, of the first byte to map. This does not need to be aligned to
+		//! the page size or allocation granularity of the platform.
+		//! @param[in] size The size, in bytes, of the range to map. Must not be 0.
+		//! @param[in] copy_on_write If `true`, the mapped pages are writable, and modifications are private to the mapping
+		//! and never written back to the file. If `false`, the mapped pages are read-only.
+		//! @param[out] data Receives the pointer to the first mapped byte (the byte at `offset`).
+		//! @return Returns the new mapping handle if succeeds. Returns one error code if failed.
+		R<opaque_t> map_file(opaque_t file, u64 offset, usize size, bool copy_on_write, void** data);
+
+		//! Unmaps one file mapping created by `map_file`.
+		//! @param[in] mapping The mapping handle returned by `map_file`.
+		void unmap_file(opaque_t mapping);
+
+		//! Reads data from the specified position of the file. Multiple threads can call this on the same file concurrently.
+		//! @param[in] file The file handle opened by `open_file`.
+		//! @param[in] offset The position, in bytes, to read data from.
+		//! @param[in] buffer The buffer used to store the read data.
+		//! @param[in] size The size, in bytes, of the data to read.
+		//! @param[out] read_bytes If this is not `nullptr`, the system sets the actual size of bytes being read to the buffer
+		//! to this parameter.
+		//! @remark The file cursor position is undefined after this call.
+		RV read_file_at(opaque_t file, u64 offset, void* buffer, usize size, usize* read_bytes = nullptr);
+
+		//! Writes data to the specified position of the file. Multiple threads can call this on the same file concurrently.
+		//! @param[in] file The file handle opened by `open_file`.
+		//! @param[in] offset The position, in bytes, to write data to.
+		//! @param[in] buffer The buffer that holds the data to be written.
+		//! @param[in] size The size, in bytes, of the data to write.
+		//! @param[out] write_bytes If not `nullptr`, the system sets the actual size of bytes being written to this parameter.
+		//! @remark The file cursor position is undefined after this call.
+		RV write_file_at(opaque_t file, u64 offset, const void* buffer, usize size, usize* write_bytes = nullptr);
+
+		//! Describes one completed native asynchronous file I/O operation.
+		struct AsyncFileIOCompletion
+		{
+			//! The user data passed to `submit_async_file_io`.
+			void* userdata;
+			//! The result of the operation.
+			RV result;
+			//! The number of bytes transferred.
+			usize transferred_bytes;
+		};
+
+		//! Creates one native asynchronous file I/O queue.
+		//! @param[in] queue_depth The maximum number of operations that can be in flight at the same time.
+		//! @return Returns the new queue handle if succeeds. Returns `BasicError::not_supported` if the platform
+		//! does not support native asynchronous file I/O.
+		R<opaque_t> new_async_file_io_queue(u32 queue_depth);
+
+		//! Closes one native asynchronous file I/O queue. All submitted operations must be completed before calling this.
+		void close_async_file_io_queue(opaque_t queue);
+
+		//! Submits one positional read or write operation to the native asynchronous file I/O queue.
+		//! This call is thread safe.
+		//! @param[in] queue The queue handle returned by `new_async_file_io_queue`.
+		//! @param[in] file The file handle opened by `open_file`.
+		//! @param[in] write `true` to write data from `buffer` to the file, `false` to read data from the file to `buffer`.
+		//! @param[in] offset The position, in bytes, to read or write data.
+		//! @param[in] buffer The buffer to read data to or write data from.
+		//! @param[in] size The size, in bytes, of the data to read or write. Must not be greater than `U32_MAX`.
+		//! @param[in] userdata The user data reported with the completion of this operation.
+		//! @par Valid Usage
+		//! * The number of operations in flight must not exceed `queue_depth`.
+		RV submit_async_file_io(opaque_t queue, opaque_t file, bool write, u64 offset, void* buffer, usize size, void* userdata);
+
+		//! Waits until at least one operation submitted to the queue completes, and fetches completions.
+		//! Only one thread may wait on one queue at the same time.
+		//! @param[in] queue The queue handle returned by `new_async_file_io_queue`.
+		//! @param[out] completions The buffer that receives completions.
+		//! @param[in] max_completions The maximum number of completions to fetch.
+		//! @return Returns the number of completions written to `completions`. Returns `0` if the wait is
+		//! interrupted by `interrupt_async_file_io_wait`.
+		usize wait_async_file_io(opaque_t queue, AsyncFileIOCompletion* completions, usize max_completions);
+
+		//! Wakes up the thread waiting in `wait_async_file_io` on the specified queue.
+		//! @param[in] queue The queue handle returned by `new_async_file_io_queue`.
+		void interrupt_async_file_io_wait(opaque_t queue);
+
+		//! Creates one native file watcher that watches the specified directory and all its subdirectories.
+		//! @param[in] path The path of the directory to watch.
+		//! @return Returns the new watcher handle if succeeds. Returns `BasicError::not_supported` if the platform
+		//! does not support file notifications.
+		R<opaque_t> new_file_watcher(const c8* path);
+
+		//! Closes one file watcher created by `new_file_watcher`.
+		void close_file_watcher(opaque_t watcher);
+
+		//! Fetches file changes detected by the watcher since the last call without blocking.
+		//! @param[in] watcher The watcher handle returned by `new_file_watcher`.
+		//! @param[out] changes The vector to append detected changes to. Paths are relative to the watched directory.
+		RV read_file_watcher_changes(opaque_t watcher, Vector<FileChange>& changes);
+
 		//! Gets the attribute/status of one file or directory.
 		//! @param[in] path The path of the file to get.
 		//! @return Returns the file attribute structure if succeeded, returns error code if failed.
@@ -0,0 +1,283 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file AsyncFileIO.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "../../OS.hpp"
+#include <errno.h>
+
+#ifdef LUNA_PLATFORM_LINUX
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#endif
+
+namespace Luna
+{
+	namespace OS
+	{
+#if defined(LUNA_PLATFORM_LINUX) && defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+		int get_file_fd(opaque_t file);
+
+		// Reserved user data used to interrupt the waiting thread.
+		static constexpr u64 IO_URING_INTERRUPT_USERDATA = U64_MAX;
+
+		struct IOUring
+		{
+			int fd;
+			// Submission queue.
+			void* sq_ring;
+			usize sq_ring_size;
+			u32* sq_head;
+			u32* sq_tail;
+			u32 sq_mask;
+			u32 sq_entries;
+			u32* sq_array;
+			io_uring_sqe* sqes;
+			usize sqes_size;
+			// Completion queue.
+			void* cq_ring;
+			usize cq_ring_size;
+			u32* cq_head;
+			u32* cq_tail;
+			u32 cq_mask;
+			io_uring_cqe* cqes;
+			// Serializes submissions from multiple threads.
+			pthread_mutex_t sq_mutex;
+		};
+
+		static int io_uring_setup(u32 entries, io_uring_params* p)
+		{
+			return (int)syscall(__NR_io_uring_setup, entries, p);
+		}
+		static int io_uring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags)
+		{
+			return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+		}
+		static void close_io_uring(IOUring* ring)
+		{
+			if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+			if (ring->cq_ring && ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+			if (ring->sq_ring) munmap(ring->sq_ring, ring->sq_ring_size);
+			if (ring->fd >= 0) ::close(ring->fd);
+			pthread_mutex_destroy(&ring->sq_mutex);
+			Luna::memdelete(ring);
+		}
+		R<opaque_t> new_async_file_io_queue(u32 queue_depth)
+		{
+			io_uring_params p;
+			memset(&p, 0, sizeof(p));
+			int fd = io_uring_setup(queue_depth, &p);
+			if (fd < 0)
+			{
+				// The kernel does not support io_uring, or io_uring is disabled by the system.
+				return BasicError::not_supported();
+			}
+			IOUring* ring = Luna::memnew<IOUring>();
+			memzero(ring, sizeof(IOUring));
+			ring->fd = fd;
+			pthread_mutex_init(&ring->sq_mutex, nullptr);
+			// IORING_OP_READ and IORING_OP_WRITE are available since the same kernel version as IORING_FEAT_RW_CUR_POS.
+			if (!(p.features & IORING_FEAT_RW_CUR_POS))
+			{
+				close_io_uring(ring);
+				return BasicError::not_supported();
+			}
+			ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(u32);
+			ring->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+			bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (single_mmap)
+			{
+				ring->sq_ring_size = max(ring->sq_ring_size, ring->cq_ring_size);
+				ring->cq_ring_size = ring->sq_ring_size;
+			}
+			void* sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			if (sq_ring == MAP_FAILED)
+			{
+				close_io_uring(ring);
+				return BasicError::bad_platform_call();
+			}
+			ring->sq_ring = sq_ring;
+			if (single_mmap)
+			{
+				ring->cq_ring = sq_ring;
+			}
+			else
+			{
+				void* cq_ring = mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+				if (cq_ring == MAP_FAILED)
+				{
+					close_io_uring(ring);
+					return BasicError::bad_platform_call();
+				}
+				ring->cq_ring = cq_ring;
+			}
+			ring->sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+			void* sqes = mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED)
+			{
+				close_io_uring(ring);
+				return BasicError::bad_platform_call();
+			}
+			ring->sqes = (io_uring_sqe*)sqes;
+			u8* sq = (u8*)ring->sq_ring;
+			ring->sq_head = (u32*)(sq + p.sq_off.head);
+			ring->sq_tail = (u32*)(sq + p.sq_off.tail);
+			ring->sq_mask = *(u32*)(sq + p.sq_off.ring_mask);
+			ring->sq_entries = *(u32*)(sq + p.sq_off.ring_entries);
+			ring->sq_array = (u32*)(sq + p.sq_off.array);
+			u8* cq = (u8*)ring->cq_ring;
+			ring->cq_head = (u32*)(cq + p.cq_off.head);
+			ring->cq_tail = (u32*)(cq + p.cq_off.tail);
+			ring->cq_mask = *(u32*)(cq + p.cq_off.ring_mask);
+			ring->cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+			return ring;
+		}
+		void close_async_file_io_queue(opaque_t queue)
+		{
+			close_io_uring((IOUring*)queue);
+		}
+		static RV push_sqe(IOUring* ring, u8 opcode, int fd, u64 offset, void* buffer, u32 size, u64 userdata)
+		{
+			pthread_mutex_lock(&ring->sq_mutex);
+			u32 tail = *ring->sq_tail;
+			u32 head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+			if (tail - head >= ring->sq_entries)
+			{
+				pthread_mutex_unlock(&ring->sq_mutex);
+				return BasicError::out_of_resource();
+			}
+			u32 index = tail & ring->sq_mask;
+			io_uring_sqe* sqe = ring->sqes + index;
+			memset(sqe, 0, sizeof(io_uring_sqe));
+			sqe->opcode = opcode;
+			sqe->fd = fd;
+			sqe->off = offset;
+			sqe->addr = (u64)(usize)buffer;
+			sqe->len = size;
+			sqe->user_data = userdata;
+			ring->sq_array[index] = index;
+			__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+			int r;
+			do
+			{
+				r = io_uring_enter(ring->fd, 1, 0, 0);
+			} while (r < 0 && errno == EINTR);
+			pthread_mutex_unlock(&ring->sq_mutex);
+			return r < 0 ? BasicError::bad_platform_call() : ok;
+		}
+		RV submit_async_file_io(opaque_t queue, opaque_t file, bool write, u64 offset, void* buffer, usize size, void* userdata)
+		{
+			lucheck(size <= U32_MAX);
+			IOUring* ring = (IOUring*)queue;
+			int fd = get_file_fd(file);
+			return push_sqe(ring, write ? IORING_OP_WRITE : IORING_OP_READ, fd, offset, buffer, (u32)size, (u64)(usize)userdata);
+		}
+		static RV translate_cqe_result(i32 res)
+		{
+			switch (-res)
+			{
+			case EACCES:
+			case EPERM:
+				return BasicError::access_denied();
+			case EINVAL:
+				return BasicError::bad_arguments();
+			case ENOMEM:
+				return BasicError::out_of_memory();
+			default:
+				return BasicError::bad_platform_call();
+			}
+		}
+		usize wait_async_file_io(opaque_t queue, AsyncFileIOCompletion* completions, usize max_completions)
+		{
+			IOUring* ring = (IOUring*)queue;
+			while (true)
+			{
+				u32 head = *ring->cq_head;
+				u32 tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+				if (head == tail)
+				{
+					int r = io_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+					if (r < 0 && errno != EINTR)
+					{
+						lupanic_msg_always("io_uring_enter failed.");
+					}
+					continue;
+				}
+				usize num_completions = 0;
+				bool interrupted = false;
+				while (head != tail && num_completions < max_completions)
+				{
+					io_uring_cqe* cqe = ring->cqes + (head & ring->cq_mask);
+					if (cqe->user_data == IO_URING_INTERRUPT_USERDATA)
+					{
+						interrupted = true;
+					}
+					else
+					{
+						AsyncFileIOCompletion& c = completions[num_completions];
+						c.userdata = (void*)(usize)cqe->user_data;
+						if (cqe->res < 0)
+						{
+							c.result = translate_cqe_result(cqe->res);
+							c.transferred_bytes = 0;
+						}
+						else
+						{
+							c.result = ok;
+							c.transferred_bytes = (usize)cqe->res;
+						}
+						++num_completions;
+					}
+					++head;
+				}
+				__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+				if (num_completions || interrupted) return num_completions;
+			}
+		}
+		void interrupt_async_file_io_wait(opaque_t queue)
+		{
+			IOUring* ring = (IOUring*)queue;
+			RV r = push_sqe(ring, IORING_OP_NOP, -1, 0, nullptr, 0, IO_URING_INTERRUPT_USERDATA);
+			// The submission queue is full only until the kernel consumes entries submitted by other threads.
+			while (r.errcode() == BasicError::out_of_resource())
+			{
+				yield_current_thread();
+				r = push_sqe(ring, IORING_OP_NOP, -1, 0, nullptr, 0, IO_URING_INTERRUPT_USERDATA);
+			}
+			// The waiting thread cannot be woken up if the interrupt entry is not submitted.
+			lupanic_if_failed(r);
+		}
+#else
+		R<opaque_t> new_async_file_io_queue(u32 queue_depth)
+		{
+			return BasicError::not_supported();
+		}
+		void close_async_file_io_queue(opaque_t queue)
+		{
+			lupanic();
+		}
+		RV submit_async_file_io(opaque_t queue, opaque_t file, bool write, u64 offset, void* buffer, usize size, void* userdata)
+		{
+			lupanic();
+			return BasicError::not_supported();
+		}
+		usize wait_async_file_io(opaque_t queue, AsyncFileIOCompletion* completions, usize max_completions)
+		{
+			lupanic();
+			return 0;
+		}
+		void interrupt_async_file_io_wait(opaque_t queue)
+		{
+			lupanic();
+		}
+#endif
+	}
+}
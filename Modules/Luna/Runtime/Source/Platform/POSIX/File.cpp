@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <sys/mman.h>
 
 #ifdef LUNA_PLATFORM_MACOS
 #include <libproc.h>
@@ -507,6 +508,99 @@ namespace Luna
 			if (f->buffered) flush_buffered_file(f->handle);
 			else flush_unbuffered_file(f->handle);
 		}
+		int get_file_fd(opaque_t file)
+		{
+			File* f = (File*)file;
+			if (f->buffered)
+			{
+				// Pending writes in the user-mode buffer must reach the file before accessing the file descriptor directly.
+				FILE* fp = (FILE*)f->handle;
+				fflush(fp);
+				return fileno(fp);
+			}
+			return (int)(usize)f->handle;
+		}
+		struct FileMapping
+		{
+			void* base;
+			usize map_size;
+		};
+		R<opaque_t> map_file(opaque_t file, u64 offset, usize size, bool copy_on_write, void** data)
+		{
+			lucheck(file && size && data);
+			int fd = get_file_fd(file);
+			// `mmap` requires the offset to be aligned to the page size.
+			u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+			u64 map_offset = offset - offset % page_size;
+			usize map_size = (usize)(offset - map_offset) + size;
+			int prot = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+			int map_flags = copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+			void* base = mmap(nullptr, map_size, prot, map_flags, fd, (off_t)map_offset);
+			if (base == MAP_FAILED)
+			{
+				switch (errno)
+				{
+				case EACCES:
+					return BasicError::access_denied();
+				case EINVAL:
+					return BasicError::bad_arguments();
+				case ENOMEM:
+					return BasicError::out_of_memory();
+				case ENODEV:
+					return BasicError::not_supported();
+				default:
+					return BasicError::bad_platform_call();
+				}
+			}
+			FileMapping* mapping = Luna::memnew<FileMapping>();
+			mapping->base = base;
+			mapping->map_size = map_size;
+			*data = (u8*)base + (offset - map_offset);
+			return mapping;
+		}
+		void unmap_file(opaque_t mapping)
+		{
+			FileMapping* m = (FileMapping*)mapping;
+			munmap(m->base, m->map_size);
+			Luna::memdelete(m);
+		}
+		RV read_file_at(opaque_t file, u64 offset, void* buffer, usize size, usize* read_bytes)
+		{
+			int fd = get_file_fd(file);
+			usize total = 0;
+			while (total < size)
+			{
+				isize sz = ::pread(fd, (u8*)buffer + total, size - total, (off_t)(offset + total));
+				if (sz == -1)
+				{
+					if (errno == EINTR) continue;
+					if (read_bytes) *read_bytes = total;
+					return BasicError::bad_platform_call();
+				}
+				if (sz == 0) break; // EOF.
+				total += sz;
+			}
+			if (read_bytes) *read_bytes = total;
+			return ok;
+		}
+		RV write_file_at(opaque_t file, u64 offset, const void* buffer, usize size, usize* write_bytes)
+		{
+			int fd = get_file_fd(file);
+			usize total = 0;
+			while (total < size)
+			{
+				isize sz = ::pwrite(fd, (const u8*)buffer + total, size - total, (off_t)(offset + total));
+				if (sz == -1)
+				{
+					if (errno == EINTR) continue;
+					if (write_bytes) *write_bytes = total;
+					return BasicError::bad_platform_call();
+				}
+				total += sz;
+			}
+			if (write_bytes) *write_bytes = total;
+			return ok;
+		}
 		R<FileAttribute> get_file_attribute(const c8* path)
 		{
 			struct stat s;
@@ -0,0 +1,235 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file FileWatcher.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "../../OS.hpp"
+#include <errno.h>
+
+#ifdef LUNA_PLATFORM_LINUX
+#include <Luna/Runtime/HashMap.hpp>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+namespace Luna
+{
+	namespace OS
+	{
+#ifdef LUNA_PLATFORM_LINUX
+		constexpr u32 INOTIFY_WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+		struct FileWatcher
+		{
+			int fd;
+			String root;
+			//! Maps watch descriptors to directory paths relative to `root`.
+			HashMap<int, Path> dirs;
+		};
+
+		inline ErrCode translate_inotify_error(int err)
+		{
+			switch (err)
+			{
+			case EACCES: return BasicError::access_denied();
+			case ENOENT: return BasicError::not_found();
+			case ENOTDIR: return BasicError::not_directory();
+			case ENOMEM: return BasicError::out_of_memory();
+			// The watch or instance limit of the user is reached.
+			case EMFILE:
+			case ENFILE:
+			case ENOSPC: return BasicError::out_of_resource();
+			default: return BasicError::bad_platform_call();
+			}
+		}
+
+		//! Watches one directory and all its subdirectories.
+		//! @param[in] added If not `nullptr`, all files and directories in the directory are reported as added,
+		//! since they may be created before the watch is added.
+		static RV add_watch_recursive(FileWatcher* w, const Path& dir, Vector<FileChange>* added)
+		{
+			String native_path = w->root;
+			if (!dir.empty())
+			{
+				native_path.push_back('/');
+				native_path.append(dir.encode(PathSeparator::slash));
+			}
+			int wd = inotify_add_watch(w->fd, native_path.c_str(), INOTIFY_WATCH_MASK);
+			if (wd < 0)
+			{
+				int err = errno;
+				// The directory may be removed before it is watched.
+				if (err == ENOENT || err == ENOTDIR) return ok;
+				return translate_inotify_error(err);
+			}
+			w->dirs.insert_or_assign(wd, dir);
+			DIR* d = ::opendir(native_path.c_str());
+			if (!d) return ok;
+			RV r = ok;
+			while (struct dirent* entry = ::readdir(d))
+			{
+				if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+				bool directory = entry->d_type == DT_DIR;
+				if (entry->d_type == DT_UNKNOWN)
+				{
+					String child_path = native_path;
+					child_path.push_back('/');
+					child_path.append(entry->d_name);
+					struct stat st;
+					directory = !::stat(child_path.c_str(), &st) && S_ISDIR(st.st_mode);
+				}
+				if (!directory && !added) continue;
+				Path child = dir;
+				child.push_back(entry->d_name);
+				if (added)
+				{
+					added->push_back({ child, FileChangeType::added, directory });
+				}
+				if (directory)
+				{
+					r = add_watch_recursive(w, child, added);
+					if (failed(r)) break;
+				}
+			}
+			::closedir(d);
+			return r;
+		}
+
+		//! Removes watches of one directory and all its subdirectories.
+		static void remove_watch_recursive(FileWatcher* w, const Path& dir)
+		{
+			Vector<int> removed;
+			for (auto& i : w->dirs)
+			{
+				if (i.second.is_subpath_of(dir)) removed.push_back(i.first);
+			}
+			for (int wd : removed)
+			{
+				inotify_rm_watch(w->fd, wd);
+				w->dirs.erase(wd);
+			}
+		}
+
+		inline void push_file_change(Vector<FileChange>& changes, Path&& path, FileChangeType type, bool directory)
+		{
+			// Coalesces repeated events of the same file, like multiple `IN_MODIFY` of one write sequence.
+			if (!changes.empty())
+			{
+				FileChange& last = changes.back();
+				if (last.type == type && last.directory == directory && last.path == path) return;
+			}
+			changes.push_back({ move(path), type, directory });
+		}
+
+		R<opaque_t> new_file_watcher(const c8* path)
+		{
+			int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (fd < 0) return translate_inotify_error(errno);
+			FileWatcher* w = memnew<FileWatcher>();
+			w->fd = fd;
+			w->root = path;
+			while (w->root.size() > 1 && w->root.back() == '/') w->root.pop_back();
+			RV r = add_watch_recursive(w, Path(), nullptr);
+			if (succeeded(r) && w->dirs.empty()) r = BasicError::not_found();
+			if (failed(r))
+			{
+				::close(fd);
+				memdelete(w);
+				return r.errcode();
+			}
+			return w;
+		}
+		void close_file_watcher(opaque_t watcher)
+		{
+			FileWatcher* w = (FileWatcher*)watcher;
+			::close(w->fd);
+			memdelete(w);
+		}
+		RV read_file_watcher_changes(opaque_t watcher, Vector<FileChange>& changes)
+		{
+			FileWatcher* w = (FileWatcher*)watcher;
+			alignas(inotify_event) c8 buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+			while (true)
+			{
+				ssize_t len = ::read(w->fd, buffer, sizeof(buffer));
+				if (len < 0)
+				{
+					int err = errno;
+					if (err == EINTR) continue;
+					if (err == EAGAIN || err == EWOULDBLOCK) break;
+					return translate_inotify_error(err);
+				}
+				if (len == 0) break;
+				for (c8* cur = buffer; cur < buffer + len; cur += sizeof(inotify_event) + ((inotify_event*)cur)->len)
+				{
+					const inotify_event* e = (const inotify_event*)cur;
+					if (e->mask & IN_Q_OVERFLOW)
+					{
+						push_file_change(changes, Path(), FileChangeType::modified, true);
+						continue;
+					}
+					if (e->mask & IN_IGNORED)
+					{
+						w->dirs.erase(e->wd);
+						continue;
+					}
+					// Events of the watched directory itself are reported by its parent directory.
+					if (!e->len) continue;
+					auto iter = w->dirs.find(e->wd);
+					if (iter == w->dirs.end()) continue;
+					Path path = iter->second;
+					path.push_back(e->name);
+					bool directory = (e->mask & IN_ISDIR) != 0;
+					if (e->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						if (directory)
+						{
+							push_file_change(changes, Path(path), FileChangeType::added, true);
+							RV r = add_watch_recursive(w, path, &changes);
+							if (failed(r)) return r;
+						}
+						else
+						{
+							push_file_change(changes, move(path), FileChangeType::added, false);
+						}
+					}
+					else if (e->mask & (IN_DELETE | IN_MOVED_FROM))
+					{
+						// Watches of one moved directory are not removed by the system, and would report
+						// changes with stale paths.
+						if (directory && (e->mask & IN_MOVED_FROM)) remove_watch_recursive(w, path);
+						push_file_change(changes, move(path), FileChangeType::removed, directory);
+					}
+					else if (!directory && (e->mask & (IN_MODIFY | IN_CLOSE_WRITE)))
+					{
+						push_file_change(changes, move(path), FileChangeType::modified, false);
+					}
+				}
+			}
+			return ok;
+		}
+#else
+		R<opaque_t> new_file_watcher(const c8* path)
+		{
+			return BasicError::not_supported();
+		}
+		void close_file_watcher(opaque_t watcher)
+		{
+			lupanic();
+		}
+		RV read_file_watcher_changes(opaque_t watcher, Vector<FileChange>& changes)
+		{
+			lupanic();
+			return BasicError::not_supported();
+		}
+#endif
+	}
+}
@@ -503,6 +503,138 @@ namespace Luna
 			if (f->buffered) flush_buffered_file(f->handle);
 			else flush_unbuffered_file(f->handle);
 		}
+		static HANDLE get_file_handle(opaque_t file)
+		{
+			File* f = (File*)file;
+			if (f->buffered)
+			{
+				// Pending writes in the user-mode buffer must reach the file before accessing the file handle directly.
+				FILE* fp = (FILE*)f->handle;
+				_fflush_nolock(fp);
+				return (HANDLE)_get_osfhandle(_fileno(fp));
+			}
+			return (HANDLE)f->handle;
+		}
+		R<opaque_t> map_file(opaque_t file, u64 offset, usize size, bool copy_on_write, void** data)
+		{
+			lucheck(file && size && data);
+			HANDLE h = get_file_handle(file);
+			HANDLE mapping = ::CreateFileMappingW(h, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping)
+			{
+				DWORD err = ::GetLastError();
+				return translate_last_error(err);
+			}
+			// `MapViewOfFile` requires the offset to be aligned to the allocation granularity.
+			SYSTEM_INFO si;
+			::GetSystemInfo(&si);
+			u64 map_offset = offset - offset % si.dwAllocationGranularity;
+			usize map_size = (usize)(offset - map_offset) + size;
+			void* base = ::MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ,
+				(DWORD)(map_offset >> 32), (DWORD)(map_offset & 0xFFFFFFFF), map_size);
+			// The view keeps a reference to the mapping object, so the handle can be closed here.
+			::CloseHandle(mapping);
+			if (!base)
+			{
+				DWORD err = ::GetLastError();
+				return translate_last_error(err);
+			}
+			*data = (u8*)base + (offset - map_offset);
+			return base;
+		}
+		void unmap_file(opaque_t mapping)
+		{
+			::UnmapViewOfFile(mapping);
+		}
+		RV read_file_at(opaque_t file, u64 offset, void* buffer, usize size, usize* read_bytes)
+		{
+			HANDLE h = get_file_handle(file);
+			usize total = 0;
+			while (total < size)
+			{
+				// Synchronous handles use the offset specified in OVERLAPPED and block until the operation completes.
+				OVERLAPPED o;
+				memzero(&o);
+				u64 pos = offset + total;
+				o.Offset = (DWORD)(pos & 0xFFFFFFFF);
+				o.OffsetHigh = (DWORD)(pos >> 32);
+				DWORD actual = 0;
+				DWORD to_read = (DWORD)min<usize>(size - total, U32_MAX);
+				if (!::ReadFile(h, (u8*)buffer + total, to_read, &actual, &o))
+				{
+					DWORD err = ::GetLastError();
+					if (err == ERROR_HANDLE_EOF) break;
+					if (read_bytes) *read_bytes = total;
+					return translate_last_error(err);
+				}
+				if (!actual) break;
+				total += actual;
+			}
+			if (read_bytes) *read_bytes = total;
+			return ok;
+		}
+		RV write_file_at(opaque_t file, u64 offset, const void* buffer, usize size, usize* write_bytes)
+		{
+			HANDLE h = get_file_handle(file);
+			usize total = 0;
+			while (total < size)
+			{
+				OVERLAPPED o;
+				memzero(&o);
+				u64 pos = offset + total;
+				o.Offset = (DWORD)(pos & 0xFFFFFFFF);
+				o.OffsetHigh = (DWORD)(pos >> 32);
+				DWORD actual = 0;
+				DWORD to_write = (DWORD)min<usize>(size - total, U32_MAX);
+				if (!::WriteFile(h, (const u8*)buffer + total, to_write, &actual, &o))
+				{
+					DWORD err = ::GetLastError();
+					if (write_bytes) *write_bytes = total;
+					return translate_last_error(err);
+				}
+				total += actual;
+			}
+			if (write_bytes) *write_bytes = total;
+			return ok;
+		}
+		// Files are not opened with FILE_FLAG_OVERLAPPED, so I/O completion ports cannot be used. The
+		// runtime falls back to blocking positional I/O on I/O threads.
+		R<opaque_t> new_async_file_io_queue(u32 queue_depth)
+		{
+			return BasicError::not_supported();
+		}
+		void close_async_file_io_queue(opaque_t queue)
+		{
+			lupanic();
+		}
+		RV submit_async_file_io(opaque_t queue, opaque_t file, bool write, u64 offset, void* buffer, usize size, void* userdata)
+		{
+			lupanic();
+			return BasicError::not_supported();
+		}
+		usize wait_async_file_io(opaque_t queue, AsyncFileIOCompletion* completions, usize max_completions)
+		{
+			lupanic();
+			return 0;
+		}
+		void interrupt_async_file_io_wait(opaque_t queue)
+		{
+			lupanic();
+		}
+		// `ReadDirectoryChangesW` is not used yet, so file changes are detected by polling on Windows.
+		R<opaque_t> new_file_watcher(const c8* path)
+		{
+			return BasicError::not_supported();
+		}
+		void close_file_watcher(opaque_t watcher)
+		{
+			lupanic();
+		}
+		RV read_file_watcher_changes(opaque_t watcher, Vector<FileChange>& changes)
+		{
+			lupanic();
+			return BasicError::not_supported();
+		}
 		inline i64 file_time_to_timestamp(const FILETIME& filetime)
 		{
 			ULARGE_INTEGER  ui;
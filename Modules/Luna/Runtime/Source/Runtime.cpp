@@ -19,6 +19,8 @@
 #include "Mutex.hpp"
 #include "Semaphore.hpp"
 #include "File.hpp"
+#include "AsyncFile.hpp"
+#include "FileWatcher.hpp"
 #include "Thread.hpp"
 #include "TypeInfo.hpp"
 #include "Interface.hpp"
@@ -48,6 +50,12 @@ namespace Luna
 		impl_interface_for_type<File, IFile, ISeekableStream, IStream>();
 		register_boxed_type<FileIterator>();
 		impl_interface_for_type<FileIterator, IFileIterator>();
+		register_boxed_type<FileMapping>();
+		impl_interface_for_type<FileMapping, IFileMapping>();
+		register_boxed_type<FileIOBatch>();
+		impl_interface_for_type<FileIOBatch, IWaitable, IFileIOBatch>();
+		register_boxed_type<FileWatcher>();
+		impl_interface_for_type<FileWatcher, IFileWatcher>();
 		register_boxed_type<Thread>();
 		impl_interface_for_type<Thread, IWaitable, IThread>();
 		register_boxed_type<MainThread>();
@@ -73,6 +81,7 @@ namespace Luna
 		thread_init();
 		random_init();
 		log_init();
+		async_file_io_init();
 		std_io_init();
 		module_init();
 		g_initialized = true;
@@ -83,6 +92,7 @@ namespace Luna
 		if (!g_initialized) return;
 		module_close();
 		std_io_close();
+		async_file_io_close();
 		log_close();
 		random_close();
 		thread_close();
@@ -10,6 +10,7 @@
 #pragma once
 #include <Luna/Runtime/File.hpp>
 #include <Luna/Runtime/Path.hpp>
+#include <Luna/Runtime/FileWatcher.hpp>
 
 #ifndef LUNA_VFS_API
 #define LUNA_VFS_API
@@ -33,6 +34,11 @@ namespace Luna
 			R<Ref<IFileIterator>>(*open_dir)(void* driver_data, void* mount_data, const Path& path);
 			RV(*create_dir)(void* driver_data, void* mount_data, const Path& path);
 			R<Name>(*get_native_path)(void* driver_data, void* mount_data, const Path& path);
+			//! Maps one range of the file to memory. If this is `nullptr`, the file is opened by `open_file` and mapped by `Luna::map_file`.
+			R<Ref<IFileMapping>>(*map_file)(void* driver_data, void* mount_data, const Path& path, u64 offset, usize size, FileMapFlag flags) = nullptr;
+			//! Watches one directory for file changes using the notification interface of the file device. If this is `nullptr` or 
+			//! fails, file changes are detected by polling file attributes.
+			R<Ref<IFileWatcher>>(*watch_dir)(void* driver_data, void* mount_data, const Path& path) = nullptr;
 		};
 
 		LUNA_VFS_API void register_driver(const Name& name, const DriverDesc& desc);
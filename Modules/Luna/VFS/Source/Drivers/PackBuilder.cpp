@@ -0,0 +1,206 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackBuilder.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "PackDriver.hpp"
+#include "../../VFS.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/Path.hpp>
+
+namespace Luna
+{
+	namespace VFS
+	{
+		struct PackBuildNode
+		{
+			String name;
+			String native_path;
+			bool directory;
+			u64 size;
+			Vector<usize> children;
+			// Filled when building the table of contents.
+			u64 offset;
+		};
+
+		static RV scan_directory(Vector<PackBuildNode>& nodes, usize dir_node)
+		{
+			lutry
+			{
+				lulet(iter, Luna::open_dir(nodes[dir_node].native_path.c_str()));
+				for (; iter->is_valid(); iter->move_next())
+				{
+					const c8* filename = iter->get_filename();
+					if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+					Path native_path = nodes[dir_node].native_path;
+					native_path.push_back(filename);
+					PackBuildNode node;
+					node.name = filename;
+					node.native_path = native_path.encode(PathSeparator::system_preferred);
+					node.directory = test_flags(iter->get_attributes(), FileAttributeFlag::directory);
+					node.size = 0;
+					node.offset = 0;
+					if (!node.directory)
+					{
+						lulet(attribute, Luna::get_file_attribute(node.native_path.c_str()));
+						node.size = attribute.size;
+					}
+					usize index = nodes.size();
+					bool directory = node.directory;
+					nodes.push_back(move(node));
+					nodes[dir_node].children.push_back(index);
+					if (directory)
+					{
+						luexp(scan_directory(nodes, index));
+					}
+				}
+			}
+			lucatchret;
+			return ok;
+		}
+
+		inline u64 align_pack_offset(u64 offset, u64 alignment)
+		{
+			return (offset + alignment - 1) / alignment * alignment;
+		}
+
+		static RV write_zero_padding(IFile* file, u64 size)
+		{
+			static const u8 zeros[4_kb] = { 0 };
+			lutry
+			{
+				while (size)
+				{
+					usize write_size = (usize)min<u64>(size, sizeof(zeros));
+					luexp(file->write(zeros, write_size));
+					size -= write_size;
+				}
+			}
+			lucatchret;
+			return ok;
+		}
+
+		LUNA_VFS_API RV build_pack_file(const c8* source_dir, const c8* pack_path, u32 alignment)
+		{
+			lucheck(source_dir && pack_path);
+			if (!alignment || (alignment & (alignment - 1))) return BasicError::bad_arguments();
+			lutry
+			{
+				// Collect all files and directories.
+				Vector<PackBuildNode> nodes;
+				{
+					PackBuildNode root;
+					root.native_path = source_dir;
+					root.directory = true;
+					root.size = 0;
+					root.offset = 0;
+					nodes.push_back(move(root));
+				}
+				luexp(scan_directory(nodes, 0));
+				// Children of the same directory are placed contiguously and sorted by name, directories
+				// are expanded in breadth-first order. `order` maps entry indices to node indices.
+				auto sort_children = [&nodes](Vector<usize>& children)
+				{
+					sort(children.begin(), children.end(), [&nodes](usize a, usize b)
+						{
+							return strcmp(nodes[a].name.c_str(), nodes[b].name.c_str()) < 0;
+						});
+				};
+				Vector<usize> order;
+				order.reserve(nodes.size() - 1);
+				sort_children(nodes[0].children);
+				order.insert(order.end(), nodes[0].children.begin(), nodes[0].children.end());
+				for (usize i = 0; i < order.size(); ++i)
+				{
+					PackBuildNode& node = nodes[order[i]];
+					if (!node.directory) continue;
+					sort_children(node.children);
+					node.offset = order.size();
+					order.insert(order.end(), node.children.begin(), node.children.end());
+				}
+				if (order.size() > U32_MAX) return BasicError::out_of_range();
+				// Build the string table.
+				String strings;
+				Vector<PackEntry> entries(order.size());
+				for (usize i = 0; i < order.size(); ++i)
+				{
+					const PackBuildNode& node = nodes[order[i]];
+					PackEntry& entry = entries[i];
+					entry.name_offset = (u32)strings.size();
+					entry.name_length = (u32)node.name.size();
+					entry.flags = node.directory ? PackEntryFlag::directory : PackEntryFlag::none;
+					entry.reserved = 0;
+					strings.append(node.name.c_str(), node.name.size() + 1);
+				}
+				// Lay out file data.
+				PackHeader header;
+				memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+				header.version = PACK_VERSION;
+				header.num_entries = (u32)order.size();
+				header.root_num_children = (u32)nodes[0].children.size();
+				header.alignment = alignment;
+				header.entries_offset = align_pack_offset(sizeof(PackHeader), 8);
+				header.strings_offset = header.entries_offset + entries.size() * sizeof(PackEntry);
+				header.strings_size = strings.size();
+				u64 data_end = header.strings_offset + header.strings_size;
+				for (usize i = 0; i < order.size(); ++i)
+				{
+					const PackBuildNode& node = nodes[order[i]];
+					PackEntry& entry = entries[i];
+					if (node.directory)
+					{
+						entry.offset = node.offset;
+						entry.size = node.children.size();
+					}
+					else
+					{
+						u64 record_alignment = node.size >= PACK_LARGE_FILE_SIZE ? max<u64>(alignment, PACK_LARGE_FILE_ALIGNMENT) : alignment;
+						entry.offset = align_pack_offset(data_end, record_alignment);
+						entry.size = node.size;
+						data_end = entry.offset + entry.size;
+					}
+				}
+				// Write the pack file.
+				lulet(file, Luna::open_file(pack_path, FileOpenFlag::write | FileOpenFlag::user_buffering, FileCreationMode::create_always));
+				luexp(file->write(&header, sizeof(PackHeader)));
+				luexp(write_zero_padding(file, header.entries_offset - sizeof(PackHeader)));
+				luexp(file->write(entries.data(), entries.size() * sizeof(PackEntry)));
+				luexp(file->write(strings.data(), strings.size()));
+				u64 cursor = header.strings_offset + header.strings_size;
+				constexpr usize copy_buffer_size = 1_mb;
+				Blob buffer(copy_buffer_size);
+				for (usize i = 0; i < order.size(); ++i)
+				{
+					const PackBuildNode& node = nodes[order[i]];
+					const PackEntry& entry = entries[i];
+					if (node.directory) continue;
+					luexp(write_zero_padding(file, entry.offset - cursor));
+					lulet(src, Luna::open_file(node.native_path.c_str(), FileOpenFlag::read, FileCreationMode::open_existing));
+					u64 remaining = entry.size;
+					while (remaining)
+					{
+						usize read_size = (usize)min<u64>(remaining, copy_buffer_size);
+						usize read_bytes;
+						luexp(src->read(buffer.data(), read_size, &read_bytes));
+						if (read_bytes != read_size)
+						{
+							return set_error(BasicError::io_error(), "The size of file %s changed while building the pack file.", node.native_path.c_str());
+						}
+						luexp(file->write(buffer.data(), read_size));
+						remaining -= read_size;
+					}
+					cursor = entry.offset + entry.size;
+				}
+				file->flush();
+			}
+			lucatchret;
+			return ok;
+		}
+	}
+}
@@ -0,0 +1,308 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackDriver.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "PackDriver.hpp"
+#include "../../VFS.hpp"
+#include "../../Driver.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+
+namespace Luna
+{
+	namespace VFS
+	{
+		RV PackFile::read(void* buffer, usize size, usize* read_bytes)
+		{
+			lutsassert();
+			usize sz = m_cursor >= m_size ? 0 : (usize)min<u64>(size, m_size - m_cursor);
+			memcpy(buffer, m_data + m_cursor, sz);
+			m_cursor += sz;
+			if (read_bytes) *read_bytes = sz;
+			return ok;
+		}
+		RV PackFile::seek(i64 offset, SeekMode mode)
+		{
+			lutsassert();
+			i64 base;
+			switch (mode)
+			{
+			case SeekMode::begin: base = 0; break;
+			case SeekMode::current: base = (i64)m_cursor; break;
+			case SeekMode::end: base = (i64)m_size; break;
+			default: return BasicError::bad_arguments();
+			}
+			i64 cursor = base + offset;
+			if (cursor < 0) return BasicError::bad_arguments();
+			m_cursor = (u64)cursor;
+			return ok;
+		}
+
+		struct PackMountData
+		{
+			Ref<IFile> m_file;
+			Ref<IFileMapping> m_archive;
+			const PackHeader* m_header;
+			const PackEntry* m_entries;
+			const c8* m_strings;
+			FileAttribute m_attribute;
+
+			//! Finds the entry of the specified path. Returns `U64_MAX` for the root directory.
+			R<u64> find_entry(const Path& path) const
+			{
+				u64 first = 0;
+				u64 count = m_header->root_num_children;
+				u64 index = U64_MAX;
+				for (usize i = 0; i < path.size(); ++i)
+				{
+					const Name& node = path[i];
+					if (index != U64_MAX && !test_flags(m_entries[index].flags, PackEntryFlag::directory))
+					{
+						return BasicError::not_directory();
+					}
+					const PackEntry* begin = m_entries + first;
+					const PackEntry* end = begin + count;
+					const PackEntry* iter = lower_bound(begin, end, node, [this](const PackEntry& e, const Name& name)
+						{
+							return strcmp(m_strings + e.name_offset, name.c_str()) < 0;
+						});
+					if (iter == end || strcmp(m_strings + iter->name_offset, node.c_str()))
+					{
+						return BasicError::not_found();
+					}
+					index = (u64)(iter - m_entries);
+					first = iter->offset;
+					count = iter->size;
+				}
+				return index;
+			}
+		};
+
+		//! Checks that every offset and size in the pack refers to data in the mapped range, so that the pack can be
+		//! accessed without further checks. Ranges are checked as `size > limit - offset` after checking
+		//! `offset <= limit`, so that corrupted values cannot wrap around.
+		static RV validate_pack(const byte_t* data, usize size)
+		{
+			if (size < sizeof(PackHeader)) return BasicError::format_error();
+			const PackHeader* header = (const PackHeader*)data;
+			if (memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC))) return BasicError::format_error();
+			if (header->version != PACK_VERSION) return BasicError::not_supported();
+			if (header->entries_offset > size || (u64)header->num_entries * sizeof(PackEntry) > size - header->entries_offset ||
+				header->strings_offset > size || header->strings_size > size - header->strings_offset ||
+				header->root_num_children > header->num_entries)
+			{
+				return BasicError::format_error();
+			}
+			const PackEntry* entries = (const PackEntry*)(data + header->entries_offset);
+			const c8* strings = (const c8*)(data + header->strings_offset);
+			for (u32 i = 0; i < header->num_entries; ++i)
+			{
+				const PackEntry& e = entries[i];
+				// Names are compared using `strcmp`, so they must be terminated in the string table.
+				if ((u64)e.name_offset + e.name_length >= header->strings_size ||
+					strings[(u64)e.name_offset + e.name_length] != 0)
+				{
+					return BasicError::format_error();
+				}
+				if (test_flags(e.flags, PackEntryFlag::directory))
+				{
+					if (e.offset > header->num_entries || e.size > header->num_entries - e.offset) return BasicError::format_error();
+				}
+				else if (e.offset > size || e.size > size - e.offset)
+				{
+					return BasicError::format_error();
+				}
+			}
+			return ok;
+		}
+
+		static R<void*> pack_mount(void* driver_data, const c8* driver_path, const Path& mount_dir, typeinfo_t params_type, void* params_data)
+		{
+			PackMountData* data = nullptr;
+			lutry
+			{
+				lulet(file, Luna::open_file(driver_path, FileOpenFlag::read, FileCreationMode::open_existing));
+				lulet(attribute, Luna::get_file_attribute(driver_path));
+				// The whole pack file is mapped once, so reading the table of contents and file data does not
+				// need any further system call.
+				lulet(archive, Luna::map_file(file));
+				luexp(validate_pack(archive->get_data(), archive->get_size()));
+				data = memnew<PackMountData>();
+				data->m_file = file;
+				data->m_archive = archive;
+				data->m_header = (const PackHeader*)archive->get_data();
+				data->m_entries = (const PackEntry*)(archive->get_data() + data->m_header->entries_offset);
+				data->m_strings = (const c8*)(archive->get_data() + data->m_header->strings_offset);
+				data->m_attribute = attribute;
+			}
+			lucatchret;
+			return data;
+		}
+		static RV pack_unmount(void* driver_data, void* mount_data)
+		{
+			memdelete((PackMountData*)mount_data);
+			return ok;
+		}
+		static R<Ref<IFile>> pack_open_file(void* driver_data, void* mount_data, const Path& path, FileOpenFlag flags, FileCreationMode creation)
+		{
+			auto data = (PackMountData*)mount_data;
+			if (test_flags(flags, FileOpenFlag::write)) return BasicError::access_denied();
+			if (creation != FileCreationMode::open_existing && creation != FileCreationMode::open_always) return BasicError::access_denied();
+			Ref<IFile> ret;
+			lutry
+			{
+				lulet(index, data->find_entry(path));
+				if (index == U64_MAX || test_flags(data->m_entries[index].flags, PackEntryFlag::directory))
+				{
+					return BasicError::is_directory();
+				}
+				const PackEntry& entry = data->m_entries[index];
+				auto file = new_object<PackFile>();
+				file->m_archive = data->m_archive;
+				file->m_data = data->m_archive->get_data() + entry.offset;
+				file->m_size = entry.size;
+				ret = file;
+			}
+			lucatchret;
+			return ret;
+		}
+		static R<FileAttribute> pack_get_file_attribute(void* driver_data, void* mount_data, const Path& path)
+		{
+			auto data = (PackMountData*)mount_data;
+			FileAttribute ret = data->m_attribute;
+			lutry
+			{
+				lulet(index, data->find_entry(path));
+				if (index == U64_MAX || test_flags(data->m_entries[index].flags, PackEntryFlag::directory))
+				{
+					ret.size = 0;
+					ret.attributes = FileAttributeFlag::read_only | FileAttributeFlag::directory;
+				}
+				else
+				{
+					ret.size = data->m_entries[index].size;
+					ret.attributes = FileAttributeFlag::read_only;
+				}
+			}
+			lucatchret;
+			return ret;
+		}
+		static RV pack_copy_file(void* driver_data, void* from_mount_data, void* to_mount_data, const Path& from_path, const Path& to_path, FileCopyFlag flags)
+		{
+			return BasicError::access_denied();
+		}
+		static RV pack_move_file(void* driver_data, void* from_mount_data, void* to_mount_data, const Path& from_path, const Path& to_path, FileMoveFlag flags)
+		{
+			return BasicError::access_denied();
+		}
+		static RV pack_delete_file(void* driver_data, void* mount_data, const Path& path)
+		{
+			return BasicError::access_denied();
+		}
+		static R<Ref<IFileIterator>> pack_open_dir(void* driver_data, void* mount_data, const Path& path)
+		{
+			auto data = (PackMountData*)mount_data;
+			Ref<IFileIterator> ret;
+			lutry
+			{
+				lulet(index, data->find_entry(path));
+				auto iter = new_object<PackDirIterator>();
+				iter->m_archive = data->m_archive;
+				iter->m_entries = data->m_entries;
+				iter->m_strings = data->m_strings;
+				if (index == U64_MAX)
+				{
+					iter->m_current = 0;
+					iter->m_end = data->m_header->root_num_children;
+				}
+				else
+				{
+					const PackEntry& entry = data->m_entries[index];
+					if (!test_flags(entry.flags, PackEntryFlag::directory)) return BasicError::not_directory();
+					iter->m_current = entry.offset;
+					iter->m_end = entry.offset + entry.size;
+				}
+				ret = iter;
+			}
+			lucatchret;
+			return ret;
+		}
+		static RV pack_create_dir(void* driver_data, void* mount_data, const Path& path)
+		{
+			return BasicError::access_denied();
+		}
+		static R<Name> pack_get_native_path(void* driver_data, void* mount_data, const Path& path)
+		{
+			return BasicError::not_supported();
+		}
+		static R<Ref<IFileMapping>> pack_map_file(void* driver_data, void* mount_data, const Path& path, u64 offset, usize size, FileMapFlag flags)
+		{
+			auto data = (PackMountData*)mount_data;
+			Ref<IFileMapping> ret;
+			lutry
+			{
+				lulet(index, data->find_entry(path));
+				if (index == U64_MAX || test_flags(data->m_entries[index].flags, PackEntryFlag::directory))
+				{
+					return BasicError::is_directory();
+				}
+				const PackEntry& entry = data->m_entries[index];
+				if (offset > entry.size) return BasicError::out_of_range();
+				if (size == USIZE_MAX) size = (usize)(entry.size - offset);
+				else if (size > entry.size - offset) return BasicError::out_of_range();
+				if (test_flags(flags, FileMapFlag::copy_on_write))
+				{
+					// Copy-on-write pages must not be shared with the read-only mapping of the pack file.
+					luset(ret, Luna::map_file(data->m_file, entry.offset + offset, size, flags));
+				}
+				else
+				{
+					auto mapping = new_object<PackFileMapping>();
+					mapping->m_archive = data->m_archive;
+					mapping->m_data = data->m_archive->get_data() + entry.offset + offset;
+					mapping->m_size = size;
+					ret = mapping;
+				}
+			}
+			lucatchret;
+			return ret;
+		}
+		void register_pack_types()
+		{
+			register_boxed_type<PackFile>();
+			impl_interface_for_type<PackFile, IFile, ISeekableStream, IStream>();
+			register_boxed_type<PackFileMapping>();
+			impl_interface_for_type<PackFileMapping, IFileMapping>();
+			register_boxed_type<PackDirIterator>();
+			impl_interface_for_type<PackDirIterator, IFileIterator>();
+		}
+		void register_pack_driver()
+		{
+			DriverDesc desc;
+			desc.driver_data = nullptr;
+			desc.driver_close = nullptr;
+			desc.mount = pack_mount;
+			desc.unmount = pack_unmount;
+			desc.open_file = pack_open_file;
+			desc.get_file_attribute = pack_get_file_attribute;
+			desc.copy_file = pack_copy_file;
+			desc.move_file = pack_move_file;
+			desc.delete_file = pack_delete_file;
+			desc.open_dir = pack_open_dir;
+			desc.create_dir = pack_create_dir;
+			desc.get_native_path = pack_get_native_path;
+			desc.map_file = pack_map_file;
+			register_driver(get_pack_driver(), desc);
+		}
+		LUNA_VFS_API Name get_pack_driver()
+		{
+			return "Pack";
+		}
+	}
+}
@@ -0,0 +1,167 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PackDriver.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/TSAssert.hpp>
+
+namespace Luna
+{
+	namespace VFS
+	{
+		// Pack file layout:
+		//
+		// PackHeader
+		// PackEntry[num_entries]
+		// String table (null-terminated entry names)
+		// File data (every file record starts at one aligned offset)
+		//
+		// Entries form one hierarchical table of contents: children of the same directory are stored
+		// contiguously and sorted by name, so one path can be found by binary-searching each path component,
+		// and one directory can be listed without scanning unrelated entries. Children of the root directory
+		// are stored at [0, root_num_children).
+
+		constexpr c8 PACK_MAGIC[8] = { 'L', 'U', 'N', 'A', 'P', 'A', 'K', '\0' };
+		constexpr u32 PACK_VERSION = 1;
+
+		struct PackHeader
+		{
+			c8 magic[8];
+			u32 version;
+			u32 num_entries;
+			u32 root_num_children;
+			//! The alignment of small file records. Large file records are aligned to `PACK_LARGE_FILE_ALIGNMENT`.
+			u32 alignment;
+			u64 entries_offset;
+			u64 strings_offset;
+			u64 strings_size;
+		};
+
+		enum class PackEntryFlag : u32
+		{
+			none = 0x00,
+			directory = 0x01,
+		};
+
+		struct PackEntry
+		{
+			u32 name_offset;
+			u32 name_length;
+			PackEntryFlag flags;
+			u32 reserved;
+			//! For files, the offset of the file data in the pack file.
+			//! For directories, the index of the first child entry.
+			u64 offset;
+			//! For files, the size of the file data.
+			//! For directories, the number of child entries.
+			u64 size;
+		};
+
+		//! Files whose size is not smaller than this are aligned to `PACK_LARGE_FILE_ALIGNMENT`, so that
+		//! they start at one page boundary.
+		constexpr u64 PACK_LARGE_FILE_SIZE = 64_kb;
+		constexpr u64 PACK_LARGE_FILE_ALIGNMENT = 4_kb;
+
+		struct PackFile : IFile
+		{
+			lustruct("VFS::PackFile", "{b7a0e3f2-61c4-4d8e-9a25-3e8f0c71d4b6}");
+			luiimpl();
+			lutsassert_lock();
+
+			//! Keeps the pack file mapping alive.
+			Ref<IFileMapping> m_archive;
+			const byte_t* m_data;
+			u64 m_size;
+			u64 m_cursor;
+
+			PackFile() :
+				m_data(nullptr),
+				m_size(0),
+				m_cursor(0) {}
+
+			virtual RV read(void* buffer, usize size, usize* read_bytes) override;
+			virtual RV write(const void* buffer, usize size, usize* write_bytes) override
+			{
+				if (write_bytes) *write_bytes = 0;
+				return BasicError::not_supported();
+			}
+			virtual u64 get_size() override
+			{
+				return m_size;
+			}
+			virtual RV set_size(u64 sz) override
+			{
+				return BasicError::not_supported();
+			}
+			virtual R<u64> tell() override
+			{
+				return m_cursor;
+			}
+			virtual RV seek(i64 offset, SeekMode mode) override;
+			virtual void flush() override {}
+		};
+
+		struct PackFileMapping : IFileMapping
+		{
+			lustruct("VFS::PackFileMapping", "{2c5d8f41-a07e-4b93-b6d2-8e1f43a9c05d}");
+			luiimpl();
+
+			//! Keeps the pack file mapping alive.
+			Ref<IFileMapping> m_archive;
+			byte_t* m_data;
+			usize m_size;
+
+			virtual byte_t* get_data() override
+			{
+				return m_data;
+			}
+			virtual usize get_size() override
+			{
+				return m_size;
+			}
+		};
+
+		struct PackDirIterator : IFileIterator
+		{
+			lustruct("VFS::PackDirIterator", "{8e41c6d3-5f2a-4b70-9c18-d7a3b5e2f016}");
+			luiimpl();
+			lutsassert_lock();
+
+			//! Keeps the pack file mapping alive.
+			Ref<IFileMapping> m_archive;
+			const PackEntry* m_entries;
+			const c8* m_strings;
+			u64 m_current;
+			u64 m_end;
+
+			virtual bool is_valid() override
+			{
+				return m_current < m_end;
+			}
+			virtual const c8* get_filename() override
+			{
+				return is_valid() ? m_strings + m_entries[m_current].name_offset : nullptr;
+			}
+			virtual FileAttributeFlag get_attributes() override
+			{
+				if (!is_valid()) return FileAttributeFlag::none;
+				return test_flags(m_entries[m_current].flags, PackEntryFlag::directory) ?
+					FileAttributeFlag::read_only | FileAttributeFlag::directory : FileAttributeFlag::read_only;
+			}
+			virtual bool move_next() override
+			{
+				if (m_current < m_end) ++m_current;
+				return is_valid();
+			}
+		};
+
+		void register_pack_types();
+		void register_pack_driver();
+	}
+}
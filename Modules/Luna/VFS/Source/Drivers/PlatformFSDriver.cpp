@@ -97,6 +97,25 @@ namespace Luna
 			auto native_path = data->make_native_path_str(path);
 			return Name(native_path);
 		}
+		static R<Ref<IFileMapping>> fs_map_file(void* driver_data, void* mount_data, const Path& path, u64 offset, usize size, FileMapFlag flags)
+		{
+			auto data = (PlatformFileSystemMountData*)mount_data;
+			auto native_path = data->make_native_path_str(path);
+			Ref<IFileMapping> ret;
+			lutry
+			{
+				lulet(file, Luna::open_file(native_path.c_str(), FileOpenFlag::read, FileCreationMode::open_existing));
+				luset(ret, Luna::map_file(file, offset, size, flags));
+			}
+			lucatchret;
+			return ret;
+		}
+		static R<Ref<IFileWatcher>> fs_watch_dir(void* driver_data, void* mount_data, const Path& path)
+		{
+			auto data = (PlatformFileSystemMountData*)mount_data;
+			auto native_path = data->make_native_path_str(path);
+			return Luna::watch_dir(native_path.c_str());
+		}
 		void register_platform_filesystem_driver()
 		{
 			DriverDesc desc;
@@ -112,6 +131,8 @@ namespace Luna
 			desc.open_dir = fs_open_dir;
 			desc.create_dir = fs_create_dir;
 			desc.get_native_path = fs_get_native_path;
+			desc.map_file = fs_map_file;
+			desc.watch_dir = fs_watch_dir;
 			register_driver(get_platform_filesystem_driver(), desc);
 		}
 		LUNA_VFS_API Name get_platform_filesystem_driver()
@@ -0,0 +1,109 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PollingFileWatcher.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/PlatformDefines.hpp>
+#define LUNA_VFS_API LUNA_EXPORT
+#include "PollingFileWatcher.hpp"
+#include "../VFS.hpp"
+#include <Luna/Runtime/Time.hpp>
+
+namespace Luna
+{
+	namespace VFS
+	{
+		static RV scan_dir(const Path& root, const Path& dir, HashMap<Path, PollingFileRecord>& files)
+		{
+			lutry
+			{
+				Path path = root;
+				path.append(dir);
+				lulet(iter, VFS::open_dir(path));
+				Vector<Path> subdirs;
+				for (; iter->is_valid(); iter->move_next())
+				{
+					const c8* filename = iter->get_filename();
+					if (!strcmp(filename, ".") || !strcmp(filename, "..")) continue;
+					Path relative_path = dir;
+					relative_path.push_back(filename);
+					PollingFileRecord record;
+					record.directory = test_flags(iter->get_attributes(), FileAttributeFlag::directory);
+					record.size = 0;
+					record.last_write_time = 0;
+					if (record.directory)
+					{
+						subdirs.push_back(relative_path);
+					}
+					else
+					{
+						path.push_back(filename);
+						auto attribute = VFS::get_file_attribute(path);
+						path.pop_back();
+						// The file may be deleted after it is enumerated.
+						if (failed(attribute)) continue;
+						record.size = attribute.get().size;
+						record.last_write_time = attribute.get().last_write_time;
+					}
+					files.insert(make_pair(move(relative_path), record));
+				}
+				// Closes the directory before scanning subdirectories.
+				iter.reset();
+				for (auto& subdir : subdirs)
+				{
+					auto r = scan_dir(root, subdir, files);
+					// The directory may be deleted after it is enumerated.
+					if (failed(r) && r.errcode() != BasicError::not_found()) luthrow(r.errcode());
+				}
+			}
+			lucatchret;
+			return ok;
+		}
+		RV PollingFileWatcher::scan(HashMap<Path, PollingFileRecord>& files)
+		{
+			m_last_scan_ticks = get_ticks();
+			return scan_dir(m_path, Path(), files);
+		}
+		RV PollingFileWatcher::read_changes(Vector<FileChange>& changes)
+		{
+			lutsassert();
+			if ((f64)(get_ticks() - m_last_scan_ticks) < POLLING_FILE_WATCHER_INTERVAL * get_ticks_per_second()) return ok;
+			HashMap<Path, PollingFileRecord> files;
+			lutry
+			{
+				luexp(scan(files));
+			}
+			lucatchret;
+			for (auto& file : files)
+			{
+				auto iter = m_files.find(file.first);
+				if (iter == m_files.end() || iter->second.directory != file.second.directory)
+				{
+					if (iter != m_files.end())
+					{
+						changes.push_back({ file.first, FileChangeType::removed, iter->second.directory });
+					}
+					changes.push_back({ file.first, FileChangeType::added, file.second.directory });
+				}
+				else if (!file.second.directory &&
+					(iter->second.size != file.second.size || iter->second.last_write_time != file.second.last_write_time))
+				{
+					changes.push_back({ file.first, FileChangeType::modified, false });
+				}
+			}
+			for (auto& file : m_files)
+			{
+				if (files.find(file.first) == files.end())
+				{
+					changes.push_back({ file.first, FileChangeType::removed, file.second.directory });
+				}
+			}
+			m_files = move(files);
+			return ok;
+		}
+	}
+}
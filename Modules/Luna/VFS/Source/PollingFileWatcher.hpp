@@ -0,0 +1,48 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file PollingFileWatcher.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include <Luna/Runtime/FileWatcher.hpp>
+#include <Luna/Runtime/HashMap.hpp>
+#include <Luna/Runtime/TSAssert.hpp>
+
+namespace Luna
+{
+	namespace VFS
+	{
+		//! The minimum interval, in seconds, between two scans of one polling file watcher.
+		constexpr f64 POLLING_FILE_WATCHER_INTERVAL = 1.0;
+
+		struct PollingFileRecord
+		{
+			u64 size;
+			i64 last_write_time;
+			bool directory;
+		};
+
+		//! Detects file changes by comparing file attributes of two scans of the watched directory.
+		struct PollingFileWatcher : IFileWatcher
+		{
+			lustruct("VFS::PollingFileWatcher", "{3e7b9c25-d18f-4a60-b4e2-6c0f5a8d1b97}");
+			luiimpl();
+			lutsassert_lock();
+
+			Path m_path;
+			//! Files of the last scan, indexed by paths relative to `m_path`.
+			HashMap<Path, PollingFileRecord> m_files;
+			u64 m_last_scan_ticks;
+
+			PollingFileWatcher() :
+				m_last_scan_ticks(0) {}
+
+			RV scan(HashMap<Path, PollingFileRecord>& files);
+			virtual RV read_changes(Vector<FileChange>& changes) override;
+		};
+	}
+}
@@ -13,7 +13,10 @@
 #include <Luna/Runtime/UniquePtr.hpp>
 #include <Luna/Runtime/Mutex.hpp>
 #include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
 #include "Drivers/PlatformFSDriver.hpp"
+#include "Drivers/PackDriver.hpp"
+#include "PollingFileWatcher.hpp"
 
 namespace Luna
 {
@@ -86,6 +89,7 @@ namespace Luna
 					g_mounts.erase(iter);
 					return ok;
 				}
+				++iter;
 			}
 			return BasicError::not_found();
 		}
@@ -100,6 +104,7 @@ namespace Luna
 					iter->m_mount_path = to_path;
 					return ok;
 				}
+				++iter;
 			}
 			return BasicError::not_found();
 		}
@@ -157,7 +162,7 @@ namespace Luna
 				{
 					for (u64 i = 0; i < file_sz; i += 16_mb)
 					{
-						usize bytes_to_read = (usize)min(16_mb, file_sz - i);
+						usize bytes_to_read = (usize)min<u64>(16_mb, file_sz - i);
 						usize bytes_read;
 						luexp(from_file->read(buf.data(), bytes_to_read, &bytes_read));
 						luassert(bytes_to_read == bytes_read);
@@ -179,7 +184,12 @@ namespace Luna
 			{
 				from_file = nullptr;
 				to_file = nullptr;
-				auto _ = to->m_driver->delete_file(to->m_driver->driver_data, to->m_mount_data, to_path);
+				// Removes the partially copied file.
+				RV r = to->m_driver->delete_file(to->m_driver->driver_data, to->m_mount_data, to_path);
+				if (failed(r))
+				{
+					log_error("VFS", "Failed to delete partially copied file %s: %s", to_path.encode().c_str(), explain(r.errcode()));
+				}
 				return luerr;
 			}
 			return ok;
@@ -197,6 +207,27 @@ namespace Luna
 			lucatchret;
 			return ret;
 		}
+		LUNA_VFS_API R<Ref<IFileMapping>> map_file(const Path& path, u64 offset, usize size, FileMapFlag flags)
+		{
+			MutexGuard _guard(g_mounts_mutex);
+			Path relative_path;
+			Ref<IFileMapping> ret;
+			lutry
+			{
+				lulet(mnt, route_path(path, relative_path));
+				if (mnt.m_driver->map_file)
+				{
+					luset(ret, mnt.m_driver->map_file(mnt.m_driver->driver_data, mnt.m_mount_data, relative_path, offset, size, flags));
+				}
+				else
+				{
+					lulet(file, mnt.m_driver->open_file(mnt.m_driver->driver_data, mnt.m_mount_data, relative_path, FileOpenFlag::read, FileCreationMode::open_existing));
+					luset(ret, Luna::map_file(file, offset, size, flags));
+				}
+			}
+			lucatchret;
+			return ret;
+		}
 		LUNA_VFS_API R<FileAttribute> get_file_attribute(const Path& path)
 		{
 			MutexGuard _guard(g_mounts_mutex);
@@ -286,6 +317,30 @@ namespace Luna
 			lucatchret;
 			return ok;
 		}
+		LUNA_VFS_API R<Ref<IFileWatcher>> watch_dir(const Path& path, bool force_polling)
+		{
+			MutexGuard _guard(g_mounts_mutex);
+			Path relative_path;
+			Ref<IFileWatcher> ret;
+			lutry
+			{
+				lulet(mnt, route_path(path, relative_path));
+				if (!force_polling && mnt.m_driver->watch_dir)
+				{
+					auto watcher = mnt.m_driver->watch_dir(mnt.m_driver->driver_data, mnt.m_mount_data, relative_path);
+					if (succeeded(watcher)) return watcher;
+				}
+				// Falls back to polling.
+				lulet(attribute, get_file_attribute(path));
+				if (!test_flags(attribute.attributes, FileAttributeFlag::directory)) return BasicError::not_directory();
+				Ref<PollingFileWatcher> watcher = new_object<PollingFileWatcher>();
+				watcher->m_path = path;
+				luexp(watcher->scan(watcher->m_files));
+				ret = watcher;
+			}
+			lucatchret;
+			return ret;
+		}
 		LUNA_VFS_API R<Name> get_native_path(const Path& vfs_path)
 		{
 			MutexGuard _guard(g_mounts_mutex);
@@ -307,11 +362,24 @@ namespace Luna
 			{
 				g_driver_mutex = new_mutex();
 				g_mounts_mutex = new_mutex();
+				register_pack_types();
+				register_boxed_type<PollingFileWatcher>();
+				impl_interface_for_type<PollingFileWatcher, IFileWatcher>();
 				register_platform_filesystem_driver();
+				register_pack_driver();
 				return ok;
 			}
 			virtual void on_close() override
 			{
+				// Unmounts in reverse order so that drivers can release resources held by mounts.
+				for (auto iter = g_mounts.rbegin(); iter != g_mounts.rend(); ++iter)
+				{
+					RV r = iter->m_driver->unmount(iter->m_driver->driver_data, iter->m_mount_data);
+					if (failed(r))
+					{
+						log_error("VFS", "Failed to unmount %s: %s", iter->m_mount_path.encode().c_str(), explain(r.errcode()));
+					}
+				}
 				g_mounts.clear();
 				g_mounts.shrink_to_fit();
 				g_mounts_mutex = nullptr;
@@ -11,6 +11,7 @@
 #pragma once
 #include <Luna/Runtime/File.hpp>
 #include <Luna/Runtime/Path.hpp>
+#include <Luna/Runtime/FileWatcher.hpp>
 
 #ifndef LUNA_VFS_API
 #define LUNA_VFS_API
@@ -49,6 +50,18 @@ namespace Luna
 		//! * BasicError::not_directory
 		//! * BasicError::bad_platform_call for all errors that cannot be identified.
 		LUNA_VFS_API R<Ref<IFile>>	open_file(const Path& path, FileOpenFlag flags, FileCreationMode creation);
+		//! Maps one range of the file to memory.
+		//! @param[in] path The path of the file.
+		//! @param[in] offset The offset, in bytes, of the first byte to map.
+		//! @param[in] size The size, in bytes, of the range to map. If this is `USIZE_MAX`, the range from `offset`
+		//! to the end of the file is mapped.
+		//! @param[in] flags The file map flags.
+		//! @return If succeeded, returns the new mapping object. If failed, returns one of the following error codes:
+		//! * BasicError::out_of_range
+		//! * BasicError::access_denied
+		//! * BasicError::not_found
+		//! * BasicError::bad_platform_call for all errors that cannot be identified.
+		LUNA_VFS_API R<Ref<IFileMapping>> map_file(const Path& path, u64 offset = 0, usize size = USIZE_MAX, FileMapFlag flags = FileMapFlag::none);
 		//! Gets the file or directory attribute.
 		//! @param[in] path The path of the file to check.
 		//! @return Returns the file attribute structure, or one of the following error codes if failed:
@@ -100,10 +113,35 @@ namespace Luna
 		//! * BasicError::bad_platform_call for all errors that cannot be identified.
 		LUNA_VFS_API RV	create_dir(const Path& path);
 
+		//! Watches one directory and all its subdirectories for file changes.
+		//! @param[in] path The path of the directory to watch.
+		//! @param[in] force_polling If `true`, file changes are always detected by polling.
+		//! @return Returns the new watcher object if succeeded. Paths of changes reported by the watcher are relative to `path`.
+		//! @remark If the driver of the directory supports file notifications, changes are reported by the notification
+		//! interface of the file device. Otherwise, the watcher scans the directory when `IFileWatcher::read_changes` is called
+		//! and reports differences of file sizes and last write times since the last scan. Scans are performed at most once per
+		//! second, so `read_changes` can be called every frame.
+		LUNA_VFS_API R<Ref<IFileWatcher>> watch_dir(const Path& path, bool force_polling = false);
+
 		//! Translates one VFS path to one native driver path.
 		LUNA_VFS_API R<Name> get_native_path(const Path& vfs_path);
 
 		LUNA_VFS_API Name get_platform_filesystem_driver();
+
+		//! Gets the name of the pack file driver.
+		//! @details The pack file driver mounts one pack file built by @ref build_pack_file as one read-only
+		//! directory. The `driver_path` passed to @ref mount is the native path of the pack file.
+		//! The whole pack file is mapped to memory when mounted, so path lookups and directory iterations do not
+		//! need any system call, and @ref map_file returns views into the pack file mapping without copying data.
+		LUNA_VFS_API Name get_pack_driver();
+
+		//! Builds one pack file from all files and directories in one native directory.
+		//! @param[in] source_dir The native path of the directory to pack. The directory itself is mapped to the
+		//! root directory of the pack file.
+		//! @param[in] pack_path The native path of the pack file to write.
+		//! @param[in] alignment The alignment of file records in the pack file. Must be a power of two. Files larger than
+		//! 64KB are always aligned to at least 4KB so that they start at one page boundary.
+		LUNA_VFS_API RV build_pack_file(const c8* source_dir, const c8* pack_path, u32 alignment = 16);
 	}
 
 	namespace VFSError
@@ -0,0 +1,217 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/Runtime/StdIO.hpp>
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/String.hpp>
+#include <Luna/Runtime/Vector.hpp>
+using namespace Luna;
+
+// See comments in Runtime/Source/Log.cpp for the binary log file format.
+constexpr u32 BINARY_LOG_VERSION = 1;
+constexpr u8 BINARY_LOG_CHUNK_FORMAT = 0;
+constexpr u8 BINARY_LOG_CHUNK_RECORD = 1;
+constexpr u8 BINARY_LOG_CHUNK_MESSAGE = 2;
+
+RV print_help()
+{
+    const c8 help_text[] = R"(LogDecoder v0.0.1
+Binary log decoder for LunaSDK.
+This program converts binary log files written by the binary file log handler to text log files.
+Usage: LogDecoder <input> [options]
+    -o  Sets the output file. Prints to standard output if not specified.
+    -h, --help      Print help message.
+)";
+    auto io = get_std_io_stream();
+    return io->write(help_text, sizeof(help_text) - 1);
+}
+
+inline const c8* print_verbosity(LogVerbosity verbosity)
+{
+    switch (verbosity)
+    {
+    case LogVerbosity::fatal_error: return "Fatal Error";
+    case LogVerbosity::error: return "Error";
+    case LogVerbosity::warning: return "Warning";
+    case LogVerbosity::info: return "Info";
+    case LogVerbosity::debug: return "Debug";
+    case LogVerbosity::verbose: return "Verbose";
+    default: return "Unknown";
+    }
+}
+
+struct BinaryLogReader
+{
+    const u8* cur;
+    const u8* end;
+
+    template <typename _Ty>
+    R<_Ty> read()
+    {
+        if (cur + sizeof(_Ty) > end) return set_error(BasicError::format_error(), "Unexpected end of binary log file.");
+        _Ty v;
+        memcpy(&v, cur, sizeof(_Ty));
+        cur += sizeof(_Ty);
+        return v;
+    }
+    R<const u8*> read_bytes(usize size)
+    {
+        if (cur + size > end) return set_error(BasicError::format_error(), "Unexpected end of binary log file.");
+        const u8* r = cur;
+        cur += size;
+        return r;
+    }
+};
+
+void write_log_line(String& output, LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+{
+    output.push_back('[');
+    output.append(tag, tag_length);
+    output.push_back(']');
+    output.append(print_verbosity(verbosity));
+    output.push_back(':');
+    output.push_back(' ');
+    output.append(message, message_length);
+    output.push_back('\n');
+}
+
+R<String> decode_binary_log(const Blob& data)
+{
+    String output;
+    lutry
+    {
+        BinaryLogReader reader;
+        reader.cur = data.data();
+        reader.end = data.data() + data.size();
+        lulet(magic, reader.read_bytes(8));
+        if (memcmp(magic, "LUNALOG", 8)) return set_error(BasicError::format_error(), "The input file is not a binary log file.");
+        lulet(version, reader.read<u32>());
+        if (version != BINARY_LOG_VERSION) return set_error(BasicError::not_supported(), "Unsupported binary log version: %u", version);
+        Vector<String> formats;
+        String tag;
+        Vector<c8> message;
+        while (reader.cur < reader.end)
+        {
+            lulet(chunk_type, reader.read<u8>());
+            if (chunk_type == BINARY_LOG_CHUNK_FORMAT)
+            {
+                lulet(format_id, reader.read<u32>());
+                lulet(format_length, reader.read<u32>());
+                lulet(format, reader.read_bytes(format_length));
+                if (format_id >= formats.size()) formats.resize(format_id + 1);
+                formats[format_id].assign((const c8*)format, format_length);
+            }
+            else if (chunk_type == BINARY_LOG_CHUNK_RECORD)
+            {
+                lulet(verbosity, reader.read<u8>());
+                lulet(format_id, reader.read<u32>());
+                lulet(tag_length, reader.read<u16>());
+                lulet(tag_data, reader.read_bytes(tag_length));
+                lulet(args_size, reader.read<u32>());
+                lulet(args, reader.read_bytes(args_size));
+                if (format_id >= formats.size()) return set_error(BasicError::format_error(), "Undefined format ID: %u", format_id);
+                tag.assign((const c8*)tag_data, tag_length);
+                LogRecord record;
+                record.verbosity = (LogVerbosity)verbosity;
+                record.tag = tag.c_str();
+                record.format = formats[format_id].c_str();
+                record.args = args;
+                record.args_size = args_size;
+                usize len = format_log_record(record, nullptr, 0);
+                message.resize(len + 1);
+                format_log_record(record, message.data(), message.size());
+                write_log_line(output, record.verbosity, tag.c_str(), tag.size(), message.data(), len);
+            }
+            else if (chunk_type == BINARY_LOG_CHUNK_MESSAGE)
+            {
+                lulet(verbosity, reader.read<u8>());
+                lulet(tag_length, reader.read<u16>());
+                lulet(tag_data, reader.read_bytes(tag_length));
+                lulet(message_length, reader.read<u32>());
+                lulet(message_data, reader.read_bytes(message_length));
+                write_log_line(output, (LogVerbosity)verbosity, (const c8*)tag_data, tag_length, (const c8*)message_data, message_length);
+            }
+            else
+            {
+                return set_error(BasicError::format_error(), "Unknown chunk type: %u", (u32)chunk_type);
+            }
+        }
+    }
+    lucatchret;
+    return output;
+}
+
+RV run(int argc, const char* argv[])
+{
+    lutry
+    {
+        set_log_to_platform_enabled(true);
+        set_log_to_platform_verbosity(LogVerbosity::info);
+        auto io = get_std_io_stream();
+        if(argc < 2)
+        {
+            const c8 usage[] = "Usage: LogDecoder <input> [options]\nType \"LogDecoder --help\" for details.\n";
+            luexp(io->write(usage, sizeof(usage) - 1));
+            return ok;
+        }
+        if(!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))
+        {
+            luexp(print_help());
+            return ok;
+        }
+        const c8* input_path = argv[1];
+        const c8* output_path = nullptr;
+        int argi = 2;
+        while(argi < argc)
+        {
+            if(!strcmp(argv[argi], "-o"))
+            {
+                ++argi;
+                if(argi >= argc) return set_error(BasicError::bad_arguments(), "Output path expected for -o");
+                output_path = argv[argi];
+                ++argi;
+            }
+            else
+            {
+                return set_error(BasicError::bad_arguments(), "Unknown parameter: %s", argv[argi]);
+            }
+        }
+        lulet(input, open_file(input_path, FileOpenFlag::read, FileCreationMode::open_existing));
+        lulet(data, load_file_data(input));
+        lulet(output, decode_binary_log(data));
+        if(output_path)
+        {
+            lulet(f, open_file(output_path, FileOpenFlag::write, FileCreationMode::create_always));
+            luexp(f->write(output.data(), output.size()));
+        }
+        else
+        {
+            luexp(io->write(output.data(), output.size()));
+        }
+    }
+    lucatchret;
+    return ok;
+}
+
+int main(int argc, const char* argv[])
+{
+    bool inited = Luna::init();
+    if(!inited) return -1;
+    auto r = run(argc, argv);
+    if(failed(r))
+    {
+        log_error("LogDecoder", "%s", explain(r.errcode()));
+        Luna::close();
+        return -1;
+    }
+    Luna::close();
+    return 0;
+}
@@ -0,0 +1,5 @@
+target("LogDecoder")
+    set_luna_sdk_program()
+    add_files("**.cpp")
+    add_deps("Runtime")
+target_end()
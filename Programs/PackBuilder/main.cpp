@@ -0,0 +1,96 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/Runtime/StdIO.hpp>
+#include <Luna/VFS/VFS.hpp>
+using namespace Luna;
+
+RV print_help()
+{
+    const c8 help_text[] = R"(PackBuilder v0.0.1
+Pack file builder for LunaSDK.
+This program packs all files and directories in one directory to one pack file that can be mounted by the VFS pack driver.
+Usage: PackBuilder <input directory> -o <output file> [options]
+    -o  Sets the output pack file.
+    -a  Sets the alignment of file records in bytes. Must be a power of two. Default is 16.
+    -h, --help      Print help message.
+)";
+    auto io = get_std_io_stream();
+    return io->write(help_text, sizeof(help_text) - 1);
+}
+
+RV run(int argc, const char* argv[])
+{
+    lutry
+    {
+        set_log_to_platform_enabled(true);
+        set_log_to_platform_verbosity(LogVerbosity::info);
+        auto io = get_std_io_stream();
+        if(argc < 2)
+        {
+            const c8 usage[] = "Usage: PackBuilder <input directory> -o <output file> [options]\nType \"PackBuilder --help\" for details.\n";
+            luexp(io->write(usage, sizeof(usage) - 1));
+            return ok;
+        }
+        if(!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))
+        {
+            luexp(print_help());
+            return ok;
+        }
+        const c8* input_path = argv[1];
+        const c8* output_path = nullptr;
+        u32 alignment = 16;
+        int argi = 2;
+        while(argi < argc)
+        {
+            if(!strcmp(argv[argi], "-o"))
+            {
+                ++argi;
+                if(argi >= argc) return set_error(BasicError::bad_arguments(), "Output path expected for -o");
+                output_path = argv[argi];
+                ++argi;
+            }
+            else if(!strcmp(argv[argi], "-a"))
+            {
+                ++argi;
+                if(argi >= argc) return set_error(BasicError::bad_arguments(), "Alignment expected for -a");
+                alignment = (u32)strtoul(argv[argi], nullptr, 10);
+                ++argi;
+            }
+            else
+            {
+                return set_error(BasicError::bad_arguments(), "Unknown parameter: %s", argv[argi]);
+            }
+        }
+        if(!output_path) return set_error(BasicError::bad_arguments(), "Output path not specified.");
+        luexp(add_module(module_vfs()));
+        luexp(init_modules());
+        luexp(VFS::build_pack_file(input_path, output_path, alignment));
+    }
+    lucatchret;
+    return ok;
+}
+
+int main(int argc, const char* argv[])
+{
+    bool inited = Luna::init();
+    if(!inited) return -1;
+    auto r = run(argc, argv);
+    if(failed(r))
+    {
+        log_error("PackBuilder", "%s", explain(r.errcode()));
+        Luna::close();
+        return -1;
+    }
+    Luna::close();
+    return 0;
+}
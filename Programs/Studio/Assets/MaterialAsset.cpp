@@ -19,6 +19,18 @@ namespace Luna
 		return "Material";
 	}
 
+	static RV get_material_asset_dependencies(object_t userdata, Asset::asset_t asset, object_t data, Vector<Asset::asset_t>& out_dependencies)
+	{
+		Material* material = cast_object<Material>(data);
+		if (!material) return BasicError::bad_data();
+		out_dependencies.push_back(material->base_color);
+		out_dependencies.push_back(material->roughness);
+		out_dependencies.push_back(material->normal);
+		out_dependencies.push_back(material->metallic);
+		out_dependencies.push_back(material->emissive);
+		return ok;
+	}
+
 	void register_material_asset_type()
 	{
 		register_enum_type<MeterialType>({
@@ -41,6 +53,7 @@ namespace Luna
 		desc.on_save_asset = save_json_asset<Material>;
 		desc.on_load_asset_default_data = create_default_object<Material>;
 		desc.on_set_asset_data = nullptr;
+		desc.on_get_asset_dependencies = get_material_asset_dependencies;
 		desc.userdata = nullptr;
 		Asset::register_asset_type(desc);
 	}
@@ -25,4 +25,10 @@ namespace Luna
 		Blob vertex_data;
 		Blob index_data;
 	};
+
+	//! Cooks the mesh asset and stores the cooked payload to the cooked asset cache.
+	//! @param[in] source_data The data of the mesh asset file, which is used to compute the cache key.
+	//! @param[in] source_size The size of the mesh asset file.
+	//! @param[in] mesh_asset The mesh asset decoded from the mesh asset file.
+	void save_cooked_static_mesh(const void* source_data, usize source_size, const MeshAsset& mesh_asset);
 }
\ No newline at end of file
@@ -14,6 +14,8 @@
 #include <Luna/Runtime/Serialization.hpp>
 #include "../StudioHeader.hpp"
 #include <Luna/RHI/Utility.hpp>
+#include "../CookedAssetCache.hpp"
+#include <Luna/Runtime/Log.hpp>
 namespace Luna
 {
 	Name get_static_mesh_asset_type()
@@ -21,30 +23,95 @@ namespace Luna
 		return "Static Mesh";
 	}
 
-	static RV reset_mesh(Mesh& mesh, const MeshAsset& mesh_asset)
+	static RV reset_mesh(Mesh& mesh, Span<const MeshPiece> pieces, const void* vertex_data, usize vertex_data_size, const void* index_data, usize index_data_size)
 	{
 		lutry
 		{
 			auto device = RHI::get_main_device();
 			// Upload resource.
 			lulet(vert_res, device->new_buffer(RHI::MemoryType::local, RHI::BufferDesc(
-				RHI::BufferUsageFlag::vertex_buffer | RHI::BufferUsageFlag::copy_dest, mesh_asset.vertex_data.size())));
+				RHI::BufferUsageFlag::vertex_buffer | RHI::BufferUsageFlag::copy_dest, vertex_data_size)));
 			lulet(index_res, device->new_buffer(RHI::MemoryType::local, RHI::BufferDesc(
-				RHI::BufferUsageFlag::index_buffer | RHI::BufferUsageFlag::copy_dest, mesh_asset.index_data.size())));
-			lulet(upload_cmdbuf, device->new_command_buffer(g_env->async_copy_queue));
-			luexp(RHI::copy_resource_data(upload_cmdbuf, {
-				RHI::CopyResourceData::write_buffer(vert_res, 0, mesh_asset.vertex_data.data(), mesh_asset.vertex_data.size()),
-				RHI::CopyResourceData::write_buffer(index_res, 0, mesh_asset.index_data.data(), mesh_asset.index_data.size())}));
-			mesh.pieces = mesh_asset.pieces;
+				RHI::BufferUsageFlag::index_buffer | RHI::BufferUsageFlag::copy_dest, index_data_size)));
+			lulet(ticket, g_env->upload_copier->copy_resource_data({
+				RHI::CopyResourceData::write_buffer(vert_res, 0, vertex_data, vertex_data_size),
+				RHI::CopyResourceData::write_buffer(index_res, 0, index_data, index_data_size)}));
+			luexp(g_env->upload_copier->wait(ticket));
+			mesh.pieces.assign(pieces.begin(), pieces.end());
 			mesh.vb = vert_res;
 			mesh.ib = index_res;
-			mesh.vb_count = (u32)mesh_asset.vertex_data.size() / (u32)sizeof(Vertex);
-			mesh.ib_count = (u32)mesh_asset.index_data.size() / (u32)sizeof(u32);
+			mesh.vb_count = (u32)vertex_data_size / (u32)sizeof(Vertex);
+			mesh.ib_count = (u32)index_data_size / (u32)sizeof(u32);
 		}
 		lucatchret;
 		return ok;
 	}
 
+	// Cooked static mesh payload layout:
+	// CookedMeshHeader
+	// MeshPiece[num_pieces]
+	// Vertex data (aligned to COOKED_MESH_DATA_ALIGNMENT)
+	// Index data (aligned to COOKED_MESH_DATA_ALIGNMENT)
+
+	//! Change the version number when the cooked payload layout changes.
+	constexpr const c8* STATIC_MESH_COOKER = "StaticMesh.1";
+	constexpr usize COOKED_MESH_DATA_ALIGNMENT = 16;
+
+	struct CookedMeshHeader
+	{
+		u32 num_pieces;
+		u32 reserved;
+		u64 vertex_data_offset;
+		u64 vertex_data_size;
+		u64 index_data_offset;
+		u64 index_data_size;
+	};
+
+	static Blob cook_static_mesh(const MeshAsset& mesh_asset)
+	{
+		CookedMeshHeader header;
+		header.num_pieces = (u32)mesh_asset.pieces.size();
+		header.reserved = 0;
+		header.vertex_data_offset = align_upper(sizeof(CookedMeshHeader) + sizeof(MeshPiece) * mesh_asset.pieces.size(), COOKED_MESH_DATA_ALIGNMENT);
+		header.vertex_data_size = mesh_asset.vertex_data.size();
+		header.index_data_offset = align_upper(header.vertex_data_offset + header.vertex_data_size, COOKED_MESH_DATA_ALIGNMENT);
+		header.index_data_size = mesh_asset.index_data.size();
+		Blob ret((usize)(header.index_data_offset + header.index_data_size));
+		memzero(ret.data(), ret.size());
+		memcpy(ret.data(), &header, sizeof(CookedMeshHeader));
+		memcpy(ret.data() + sizeof(CookedMeshHeader), mesh_asset.pieces.data(), sizeof(MeshPiece) * mesh_asset.pieces.size());
+		memcpy(ret.data() + header.vertex_data_offset, mesh_asset.vertex_data.data(), mesh_asset.vertex_data.size());
+		memcpy(ret.data() + header.index_data_offset, mesh_asset.index_data.data(), mesh_asset.index_data.size());
+		return ret;
+	}
+
+	void save_cooked_static_mesh(const void* source_data, usize source_size, const MeshAsset& mesh_asset)
+	{
+		u64 key = calc_cooked_asset_key(source_data, source_size, STATIC_MESH_COOKER);
+		Blob payload = cook_static_mesh(mesh_asset);
+		auto r = save_cooked_asset(key, payload.data(), payload.size());
+		if (failed(r))
+		{
+			log_warning("Studio", "Failed to save cooked static mesh: %s", explain(r.errcode()));
+		}
+	}
+
+	static RV reset_mesh_from_cooked_payload(Mesh& mesh, const byte_t* data, usize size)
+	{
+		if (size < sizeof(CookedMeshHeader)) return BasicError::bad_data();
+		const CookedMeshHeader* header = (const CookedMeshHeader*)data;
+		if (sizeof(CookedMeshHeader) + sizeof(MeshPiece) * (u64)header->num_pieces > size ||
+			header->vertex_data_offset + header->vertex_data_size > size ||
+			header->index_data_offset + header->index_data_size > size)
+		{
+			return BasicError::bad_data();
+		}
+		const MeshPiece* pieces = (const MeshPiece*)(data + sizeof(CookedMeshHeader));
+		return reset_mesh(mesh, { pieces, header->num_pieces },
+			data + header->vertex_data_offset, (usize)header->vertex_data_size,
+			data + header->index_data_offset, (usize)header->index_data_size);
+	}
+
 	static R<ObjRef> load_static_mesh_asset(object_t userdata, Asset::asset_t asset, const Path& path)
 	{
 		ObjRef ret;
@@ -52,18 +119,37 @@ namespace Luna
 		{
 			Path file_path = path;
 			file_path.append_extension("mesh");
-			lulet(file, VFS::open_file(file_path, FileOpenFlag::read | FileOpenFlag::user_buffering, FileCreationMode::open_existing));
-			lulet(data, load_file_data(file));
-			lulet(file_data, VariantUtils::read_json((const c8*)data.data(), data.size()));
+			lulet(source, VFS::map_file(file_path));
+			Ref<Mesh> mesh = new_object<Mesh>();
+			// Load from the cooked payload if the source file is not changed since the last cook.
+			u64 key = calc_cooked_asset_key(source->get_data(), source->get_size(), STATIC_MESH_COOKER);
+			auto cooked = load_cooked_asset(key);
+			if (succeeded(cooked) && succeeded(reset_mesh_from_cooked_payload(*mesh.get(), cooked.get()->get_data(), cooked.get()->get_size())))
+			{
+				ret = mesh;
+				return ret;
+			}
+			lulet(file_data, VariantUtils::read_json((const c8*)source->get_data(), source->get_size()));
 			MeshAsset mesh_asset;
 			luexp(deserialize(mesh_asset, file_data));
-			Ref<Mesh> mesh = new_object<Mesh>();
-			luexp(reset_mesh(*mesh.get(), mesh_asset));
+			save_cooked_static_mesh(source->get_data(), source->get_size(), mesh_asset);
+			luexp(reset_mesh(*mesh.get(), mesh_asset.pieces.cspan(), 
+				mesh_asset.vertex_data.data(), mesh_asset.vertex_data.size(),
+				mesh_asset.index_data.data(), mesh_asset.index_data.size()));
 			ret = mesh;
 		}
 		lucatchret;
 		return ret;
 	}
+	static u64 get_static_mesh_asset_memory_cost(object_t userdata, Asset::asset_t asset, object_t data)
+	{
+		Mesh* mesh = cast_object<Mesh>(data);
+		if (!mesh) return 0;
+		u64 ret = 0;
+		if (mesh->vb) ret += mesh->vb->get_memory()->get_size();
+		if (mesh->ib) ret += mesh->ib->get_memory()->get_size();
+		return ret;
+	}
 	void register_static_mesh_asset_type()
 	{
 		register_struct_type<Vertex>({
@@ -90,6 +176,7 @@ namespace Luna
 		desc.on_load_asset = load_static_mesh_asset;
 		desc.on_save_asset = nullptr;
 		desc.on_set_asset_data = nullptr;
+		desc.on_get_asset_memory_cost = get_static_mesh_asset_memory_cost;
 		desc.userdata = nullptr;
 		Asset::register_asset_type(desc);
 	}
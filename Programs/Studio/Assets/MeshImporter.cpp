@@ -8,6 +8,7 @@
 * @date 2022/12/17
 */
 #include "Mesh.hpp"
+#include "../MeshOptimizer.hpp"
 #include <Luna/ObjLoader/ObjLoader.hpp>
 #include <Luna/Window/FileDialog.hpp>
 #include <Luna/Window/MessageBox.hpp>
@@ -41,121 +42,96 @@ namespace Luna
 		}
 	};
 
-	template <>
-	struct hash<ObjLoader::Index>
-	{
-		usize operator()(const ObjLoader::Index& v) const
-		{
-			return hash<i32>()(v.vertex_index) ^ hash<i32>()(v.normal_index) ^ hash<i32>()(v.texcoord_index);
-		}
-	};
-
 	static RV create_mesh_asset_from_obj(MeshAsset& mesh, const ObjLoader::ObjMesh& obj_file, u32 shape_index)
 	{
-		auto& m = obj_file.shapes[shape_index].mesh;	// We only consider the mesh part of the specified shape.
-		auto& faces = m.num_face_vertices;	// 
 		auto& attrib = obj_file.attributes;
 
-		// Collect vertex used in this shape.
-		Vector<Vertex> vertices;
-		HashMap<ObjLoader::Index, usize> vertices_map;
-		for(auto& i : m.indices)
+		// Weld vertices and build index list for every material.
+		ObjLoader::IndexedMesh indexed = ObjLoader::build_indexed_mesh(obj_file, shape_index);
+
+		// Fill vertex data directly to the vertex buffer.
+		usize num_vertices = indexed.vertices.size();
+		auto vb_blob = Blob(num_vertices * sizeof(Vertex));
+		Vertex* vertices = (Vertex*)vb_blob.data();
+		for (usize i = 0; i < num_vertices; ++i)
 		{
-			if(!vertices_map.contains(i))
+			const ObjLoader::Index& index = indexed.vertices[i];
+			Vertex& v = vertices[i];
+			v.position = attrib.vertices[index.vertex_index];
+			auto& color3 = attrib.colors[index.vertex_index];
+			v.color = Float4U(color3.x, color3.y, color3.z, 1.0f);
+			if (index.normal_index != -1 && index.normal_index < attrib.normals.size())
 			{
-				Vertex v;
-				v.position = attrib.vertices[i.vertex_index];
-				auto& color3 = attrib.colors[i.vertex_index];
-				v.color = Float4U(color3.x, color3.y, color3.z, 1.0f);
-				if (i.normal_index != -1 && i.normal_index < attrib.normals.size())
-				{
-					v.normal = attrib.normals[i.normal_index];
-				}
-				else
-				{
-					v.normal = Float3U(0.0f, 0.0f, 1.0f);
-				}
-				if (i.texcoord_index != -1 && i.texcoord_index < attrib.texcoords.size())
-				{
-					v.texcoord = attrib.texcoords[i.texcoord_index];
-				}
-				else
-				{
-					v.texcoord = Float2U(0.0f, 0.0f);
-				}
-				vertices.push_back(v);
-				vertices_map.insert(make_pair(i, vertices.size() - 1));
+				v.normal = attrib.normals[index.normal_index];
 			}
-		}
-
-		// Build index list for every material.
-		// Material ID -> Index list.
-		HashMap<u32, Vector<u32>> mat_map;
-		usize index_offset = 0;
-		for(usize face_index = 0; face_index < faces.size(); ++face_index)
-		{
-			i32 mat_id = m.material_ids[face_index];
-			auto iter = mat_map.find(mat_id);
-			if (iter == mat_map.end())
+			else
 			{
-				iter = mat_map.insert(make_pair(mat_id, Vector<u32>())).first;
+				v.normal = Float3U(0.0f, 0.0f, 1.0f);
 			}
-			u8 num_face_vertices = faces[face_index];
-			// If this is not a triangle face, convert this to triangle fans.
-			for (i32 j = 0; j < ((i32)num_face_vertices - 2); ++j)
+			if (index.texcoord_index != -1 && index.texcoord_index < attrib.texcoords.size())
+			{
+				v.texcoord = attrib.texcoords[index.texcoord_index];
+			}
+			else
 			{
-				auto index1 = m.indices[index_offset];
-				auto index2 = m.indices[index_offset + j + 1];
-				auto index3 = m.indices[index_offset + j + 2];
-				iter->second.push_back(vertices_map.find(index1)->second);
-				iter->second.push_back(vertices_map.find(index2)->second);
-				iter->second.push_back(vertices_map.find(index3)->second);
+				v.texcoord = Float2U(0.0f, 0.0f);
 			}
-			index_offset += num_face_vertices;
+		}
+
+		Vector<MeshPiece> pieces;
+		for (auto& i : indexed.pieces)
+		{
+			MeshPiece p;
+			p.first_index_offset = i.first_index;
+			p.num_indices = i.num_indices;
+			pieces.push_back(p);
+		}
+
+		// Reorder triangles and vertices for GPU vertex processing.
+		usize num_optimized_vertices = optimize_mesh(indexed.indices.data(), pieces.cspan(), vertices, num_vertices);
+		if (num_optimized_vertices != num_vertices)
+		{
+			num_vertices = num_optimized_vertices;
+			vb_blob = Blob(vb_blob.data(), num_vertices * sizeof(Vertex));
+			vertices = (Vertex*)vb_blob.data();
 		}
 
 		// Calculate tangents.
 		Vector<Float3U> tangents;
 		Vector<Float3U> binormals;
-		tangents.resize(vertices.size(), Float3U(0.0f, 0.0f, 0.0f));
-		binormals.resize(vertices.size(), Float3U(0.0f, 0.0f, 0.0f));
+		tangents.resize(num_vertices, Float3U(0.0f, 0.0f, 0.0f));
+		binormals.resize(num_vertices, Float3U(0.0f, 0.0f, 0.0f));
 
-		u32 idx_offset = 0;
-		for (auto& i : mat_map)
+		usize num_tris = indexed.indices.size() / 3;
+		for (usize j = 0; j < num_tris; ++j)
 		{
-			usize num_tris = i.second.size() / 3;
-			for (usize j = 0; j < num_tris; ++j)
-			{
-				u32 i1 = i.second[j * 3];
-				u32 i2 = i.second[j * 3 + 1];
-				u32 i3 = i.second[j * 3 + 2];
-				Vertex& p1 = vertices[i1];
-				Vertex& p2 = vertices[i2];
-				Vertex& p3 = vertices[i3];
-				Float3 e1 = p3.position - p1.position;
-				Float3 e2 = p2.position - p1.position;
-				f32 u1 = p3.texcoord.x - p1.texcoord.x;
-				f32 v1 = p3.texcoord.y - p1.texcoord.y;
-				f32 u2 = p2.texcoord.x - p1.texcoord.x;
-				f32 v2 = p2.texcoord.y - p1.texcoord.y;
-
-				f32 r = 1.0f / (v1 * u2 - v2 * u1);
-
-				Float3 tangent = (e2 * v1 - e1 * v2) * r;
-				Float3 binormal = (e1 * u2 - e2 * u1) * r;
-
-				tangents[i1] = tangents[i1] + tangent;
-				tangents[i2] = tangents[i2] + tangent;
-				tangents[i3] = tangents[i3] + tangent;
-				binormals[i1] = binormals[i1] + binormal;
-				binormals[i2] = binormals[i2] + binormal;
-				binormals[i3] = binormals[i3] + binormal;
-			}
-
-			idx_offset += (u32)i.second.size();
+			u32 i1 = indexed.indices[j * 3];
+			u32 i2 = indexed.indices[j * 3 + 1];
+			u32 i3 = indexed.indices[j * 3 + 2];
+			Vertex& p1 = vertices[i1];
+			Vertex& p2 = vertices[i2];
+			Vertex& p3 = vertices[i3];
+			Float3 e1 = p3.position - p1.position;
+			Float3 e2 = p2.position - p1.position;
+			f32 u1 = p3.texcoord.x - p1.texcoord.x;
+			f32 v1 = p3.texcoord.y - p1.texcoord.y;
+			f32 u2 = p2.texcoord.x - p1.texcoord.x;
+			f32 v2 = p2.texcoord.y - p1.texcoord.y;
+
+			f32 r = 1.0f / (v1 * u2 - v2 * u1);
+
+			Float3 tangent = (e2 * v1 - e1 * v2) * r;
+			Float3 binormal = (e1 * u2 - e2 * u1) * r;
+
+			tangents[i1] = tangents[i1] + tangent;
+			tangents[i2] = tangents[i2] + tangent;
+			tangents[i3] = tangents[i3] + tangent;
+			binormals[i1] = binormals[i1] + binormal;
+			binormals[i2] = binormals[i2] + binormal;
+			binormals[i3] = binormals[i3] + binormal;
 		}
 
-		for (usize i = 0; i < vertices.size(); ++i)
+		for (usize i = 0; i < num_vertices; ++i)
 		{
 			Float3 n = normalize(vertices[i].normal);
 			Float3 t = normalize(tangents[i]);
@@ -172,30 +148,10 @@ namespace Luna
 			vertices[i].tangent = tang;
 		}
 
-		// Fill vertex data.
-		auto vb_blob = Blob(vertices.size() * sizeof(Vertex));
-		memcpy(vb_blob.data(), vertices.data(), vertices.size() * sizeof(Vertex));
-
 		// Fill indices data.
-		usize idx_count = 0;
-		for (auto& i : mat_map)
-		{
-			idx_count += i.second.size();
-		}
-
-		auto ib_blob = Blob(idx_count * sizeof(u32));
+		auto ib_blob = Blob(indexed.indices.size() * sizeof(u32));
+		memcpy(ib_blob.data(), indexed.indices.data(), ib_blob.size());
 
-		idx_offset = 0;
-		Vector<MeshPiece> pieces;
-		for (auto& i : mat_map)
-		{
-			MeshPiece p;
-			p.first_index_offset = idx_offset;
-			p.num_indices = (u32)i.second.size();
-			memcpy((u32*)ib_blob.data() + idx_offset, i.second.data(), sizeof(u32) * i.second.size());
-			idx_offset += p.num_indices;
-			pieces.push_back(p);
-		}
 		mesh.pieces = move(pieces);
 		mesh.vertex_data = move(vb_blob);
 		mesh.index_data = move(ib_blob);
@@ -216,6 +172,8 @@ namespace Luna
 			auto json_data = VariantUtils::write_json(data);
 			luexp(f->write(json_data.data(), json_data.size()));
 			f.reset();
+			// Cook the mesh now, so that the first load does not need to parse the mesh file.
+			save_cooked_static_mesh(json_data.data(), json_data.size(), mesh_asset);
 			Asset::load_asset(asset);
 		}
 		lucatch
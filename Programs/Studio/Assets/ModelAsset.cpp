@@ -19,6 +19,15 @@ namespace Luna
 		return "Model";
 	}
 
+	static RV get_model_asset_dependencies(object_t userdata, Asset::asset_t asset, object_t data, Vector<Asset::asset_t>& out_dependencies)
+	{
+		Model* model = cast_object<Model>(data);
+		if (!model) return BasicError::bad_data();
+		out_dependencies.push_back(model->mesh);
+		out_dependencies.insert(out_dependencies.end(), model->materials.begin(), model->materials.end());
+		return ok;
+	}
+
 	void register_model_asset_type()
 	{
 		register_struct_type<Model>({
@@ -32,6 +41,7 @@ namespace Luna
 		desc.on_save_asset = save_json_asset<Model>;
 		desc.on_load_asset_default_data = create_default_object<Model>;
 		desc.on_set_asset_data = nullptr;
+		desc.on_get_asset_dependencies = get_model_asset_dependencies;
 		desc.userdata = nullptr;
 		Asset::register_asset_type(desc);
 	}
@@ -11,6 +11,8 @@
 #include <Luna/VFS/VFS.hpp>
 #include <Luna/Runtime/Serialization.hpp>
 #include "../StudioHeader.hpp"
+#include "../ModelRenderer.hpp"
+#include "../SceneSettings.hpp"
 
 namespace Luna
 {
@@ -85,6 +87,33 @@ namespace Luna
 		lucatchret;
 		return ok;
 	}
+	static void get_entity_asset_dependencies(Entity* entity, Vector<Asset::asset_t>& out_dependencies)
+	{
+		ModelRenderer* renderer = entity->get_component<ModelRenderer>();
+		if (renderer)
+		{
+			out_dependencies.push_back(renderer->model);
+		}
+		for (auto& child : entity->children)
+		{
+			get_entity_asset_dependencies(child.get(), out_dependencies);
+		}
+	}
+	static RV get_scene_asset_dependencies(object_t userdata, Asset::asset_t asset, object_t data, Vector<Asset::asset_t>& out_dependencies)
+	{
+		Scene* scene = cast_object<Scene>(data);
+		if (!scene) return BasicError::bad_data();
+		for (auto& entity : scene->root_entities)
+		{
+			get_entity_asset_dependencies(entity.get(), out_dependencies);
+		}
+		SceneSettings* settings = scene->get_scene_component<SceneSettings>();
+		if (settings)
+		{
+			out_dependencies.push_back(settings->skybox);
+		}
+		return ok;
+	}
 	void register_scene_asset_type()
 	{
 		register_struct_type<Entity>({});
@@ -154,6 +183,7 @@ namespace Luna
 			desc.on_save_asset = save_json_asset<Scene>;
 			desc.on_load_asset_default_data = create_default_object<Scene>;
 			desc.on_set_asset_data = nullptr;
+			desc.on_get_asset_dependencies = get_scene_asset_dependencies;
 			desc.userdata = nullptr;
 			Asset::register_asset_type(desc);
 		}
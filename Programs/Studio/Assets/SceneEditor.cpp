@@ -731,17 +731,27 @@ namespace Luna
 		snprintf(title, 32, "Scene Editor###%d", (u32)(usize)this);
 		ImGui::SetNextWindowSize(Float2(1000, 500), ImGuiCond_FirstUseEver);
 		ImGui::Begin(title, &m_open, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_MenuBar);
-		auto s = Asset::get_asset_data<Scene>(m_scene);
+		if (Asset::get_asset_state(m_scene) == Asset::AssetState::unloaded &&
+			Asset::get_asset_loading_result(m_scene).code == ErrCode(0))
+		{
+			// Loads the scene together with all models, meshes, materials and textures it references.
+			Asset::load_asset_recursive(m_scene);
+		}
+		auto s = Asset::get_asset_data<Scene>(m_scene, false);
 		if (!s)
 		{
-			ImGui::Text("Asset Unloaded");
+			auto& err = Asset::get_asset_loading_result(m_scene);
+			if (err.code != ErrCode(0))
+			{
+				ImGui::Text("Asset Loading Failed: %s", err.explain());
+			}
+			else
+			{
+				ImGui::Text("Asset Unloaded");
+			}
 			ImGui::End();
 			return;
 		}
-		if (Asset::get_asset_state(m_scene) == Asset::AssetState::unloaded)
-		{
-			Asset::load_asset(m_scene);
-		}
 		if (Asset::get_asset_state(m_scene) != Asset::AssetState::loaded)
 		{
 			ImGui::Text("Scene Loading");
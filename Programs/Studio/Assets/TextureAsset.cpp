@@ -15,6 +15,8 @@
 #include <Luna/VFS/VFS.hpp>
 #include <Luna/RHI/Utility.hpp>
 #include <Luna/Image/RHIHelper.hpp>
+#include "../CookedAssetCache.hpp"
+#include <Luna/Runtime/Log.hpp>
 
 namespace Luna
 {
@@ -129,6 +131,116 @@ namespace Luna
 		lucatchret;
 		return ok;
 	}
+	// Cooked texture payload layout:
+	// CookedTextureHeader
+	// CookedTextureMip[num_mips]
+	// Pixel data of every mip (aligned to COOKED_TEXTURE_DATA_ALIGNMENT)
+
+	//! Change the version number when the cooked payload layout or the image decoding settings change.
+	constexpr const c8* STATIC_TEXTURE_COOKER = "StaticTexture.1";
+	constexpr usize COOKED_TEXTURE_DATA_ALIGNMENT = 16;
+
+	struct CookedTextureHeader
+	{
+		//! The `RHI::Format` of the texture.
+		u32 format;
+		u32 width;
+		u32 height;
+		u32 num_mips;
+		//! Whether mips after the stored mips should be generated after the texture is uploaded.
+		u32 generate_mips;
+		u32 reserved;
+	};
+
+	struct CookedTextureMip
+	{
+		u32 width;
+		u32 height;
+		u32 row_pitch;
+		u32 slice_pitch;
+		u64 offset;
+		u64 size;
+	};
+
+	static void save_cooked_texture(u64 key, RHI::Format format, u32 width, u32 height, Span<const Image::ImageDesc> mip_descs, Span<const Blob> mip_data, bool generate_mips)
+	{
+		CookedTextureHeader header;
+		header.format = (u32)format;
+		header.width = width;
+		header.height = height;
+		header.num_mips = (u32)mip_descs.size();
+		header.generate_mips = generate_mips ? 1 : 0;
+		header.reserved = 0;
+		Vector<CookedTextureMip> mips;
+		mips.reserve(mip_descs.size());
+		u64 offset = sizeof(CookedTextureHeader) + sizeof(CookedTextureMip) * mip_descs.size();
+		for (usize i = 0; i < mip_descs.size(); ++i)
+		{
+			CookedTextureMip mip;
+			mip.width = mip_descs[i].width;
+			mip.height = mip_descs[i].height;
+			mip.row_pitch = (u32)(pixel_size(mip_descs[i].format) * mip.width);
+			mip.slice_pitch = mip.row_pitch * mip.height;
+			mip.offset = align_upper(offset, COOKED_TEXTURE_DATA_ALIGNMENT);
+			mip.size = mip_data[i].size();
+			offset = mip.offset + mip.size;
+			mips.push_back(mip);
+		}
+		Blob payload((usize)offset);
+		memzero(payload.data(), payload.size());
+		memcpy(payload.data(), &header, sizeof(CookedTextureHeader));
+		memcpy(payload.data() + sizeof(CookedTextureHeader), mips.data(), sizeof(CookedTextureMip) * mips.size());
+		for (usize i = 0; i < mips.size(); ++i)
+		{
+			memcpy(payload.data() + mips[i].offset, mip_data[i].data(), mip_data[i].size());
+		}
+		auto r = save_cooked_asset(key, payload.data(), payload.size());
+		if (failed(r))
+		{
+			log_warning("Studio", "Failed to save cooked texture: %s", explain(r.errcode()));
+		}
+	}
+
+	static R<Ref<RHI::ITexture>> load_cooked_texture(TextureAssetUserdata* ctx, const byte_t* data, usize size)
+	{
+		Ref<RHI::ITexture> ret;
+		lutry
+		{
+			if (size < sizeof(CookedTextureHeader)) return BasicError::bad_data();
+			const CookedTextureHeader* header = (const CookedTextureHeader*)data;
+			if (!header->num_mips || sizeof(CookedTextureHeader) + sizeof(CookedTextureMip) * (u64)header->num_mips > size) return BasicError::bad_data();
+			const CookedTextureMip* mips = (const CookedTextureMip*)(data + sizeof(CookedTextureHeader));
+			for (u32 i = 0; i < header->num_mips; ++i)
+			{
+				if (mips[i].offset + mips[i].size > size || (u64)mips[i].slice_pitch > mips[i].size) return BasicError::bad_data();
+			}
+			// Create resource.
+			lulet(tex, g_env->device->new_texture(RHI::MemoryType::local, RHI::TextureDesc::tex2d(
+				(RHI::Format)header->format,
+				RHI::TextureUsageFlag::read_texture | RHI::TextureUsageFlag::read_write_texture | RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest,
+				header->width, header->height)));
+			// Upload data.
+			Vector<RHI::CopyResourceData> copies;
+			copies.reserve(header->num_mips);
+			for (u32 i = 0; i < header->num_mips; ++i)
+			{
+				copies.push_back(RHI::CopyResourceData::write_texture(tex, RHI::SubresourceIndex(i, 0), 0, 0, 0,
+					data + mips[i].offset, mips[i].row_pitch, mips[i].slice_pitch, mips[i].width, mips[i].height, 1));
+			}
+			lulet(ticket, g_env->upload_copier->copy_resource_data(copies.cspan()));
+			luexp(g_env->upload_copier->wait(ticket));
+			if (header->generate_mips)
+			{
+				lulet(cmdbuf, g_env->device->new_command_buffer(g_env->async_compute_queue));
+				cmdbuf->set_name("MipmapGeneration");
+				luexp(ctx->generate_mipmaps(tex, cmdbuf));
+			}
+			ret = tex;
+		}
+		lucatchret;
+		return ret;
+	}
+
 	static R<ObjRef> load_texture_asset(object_t userdata, Asset::asset_t asset, const Path& path)
 	{
 		ObjRef ret;
@@ -176,7 +288,6 @@ namespace Luna
 				// Create resource.
 				lulet(tex, g_env->device->new_texture(RHI::MemoryType::local, desc));
 				// Upload data.
-				lulet(upload_cmdbuf, g_env->device->new_command_buffer(g_env->async_copy_queue));
 				Vector<RHI::CopyResourceData> copies;
 				for (u32 item = 0; item < desc.array_size; ++item)
 				{
@@ -189,78 +300,110 @@ namespace Luna
 					}
 					if (d > 1) d >>= 1;
 				}
-				luexp(copy_resource_data(upload_cmdbuf, copies.cspan()));
+				lulet(ticket, g_env->upload_copier->copy_resource_data(copies.cspan()));
+				luexp(g_env->upload_copier->wait(ticket));
 				tex->set_name(path.encode().c_str());
 				ret = tex;
 			}
-			else if (file_data.size() >= 8 && !memcmp((const c8*)file_data.data(), "LUNAMIPS", 8))
+			else
 			{
-				u64* dp = (u64*)(file_data.data() + 8);
-				u32 num_mips = (u32)*dp;
-				++dp;
-				Vector<Pair<u64, u64>> mip_descs;
-				mip_descs.reserve(num_mips);
-				for (u64 i = 0; i < num_mips; ++i)
+				// Decoding images is expensive, so decoded images are cooked and loaded from the cooked asset cache
+				// if the source file is not changed since the last cook.
+				Ref<TextureAssetUserdata> ctx = ObjRef(userdata);
+				u64 key = calc_cooked_asset_key(file_data.data(), file_data.size(), STATIC_TEXTURE_COOKER);
+				auto cooked = load_cooked_asset(key);
+				if (succeeded(cooked))
 				{
-					Pair<u64, u64> p;
-					p.first = dp[i * 2];
-					p.second = dp[i * 2 + 1];
-					mip_descs.push_back(p);
+					auto tex = load_cooked_texture(ctx, cooked.get()->get_data(), cooked.get()->get_size());
+					if (succeeded(tex))
+					{
+						tex.get()->set_name(path.encode().c_str());
+						ret = tex.get();
+						return ret;
+					}
 				}
-				// Load texture from file.
-				lulet(desc, Image::read_image_file_desc(file_data.data() + mip_descs[0].first, mip_descs[0].second));
-				auto desired_format = Image::get_rhi_desired_format(desc.format);
-				// Create resource.
-				lulet(tex, g_env->device->new_texture(RHI::MemoryType::local, RHI::TextureDesc::tex2d(
-					Image::image_to_rhi_format(desc.format), 
-					RHI::TextureUsageFlag::read_texture | RHI::TextureUsageFlag::read_write_texture | RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest, 
-					desc.width, desc.height)));
-				// Upload data
-				Vector<Blob> image_data_array;
-				Vector<RHI::CopyResourceData> copies;
-				image_data_array.reserve(num_mips);
-				copies.reserve(num_mips);
-				for (u32 i = 0; i < num_mips; ++i)
+				if (file_data.size() >= 8 && !memcmp((const c8*)file_data.data(), "LUNAMIPS", 8))
 				{
-					Image::ImageDesc desc;
-					lulet(image_data, Image::read_image_file(file_data.data() + mip_descs[i].first, mip_descs[i].second, desired_format, desc));
-					copies.push_back(RHI::CopyResourceData::write_texture(tex, RHI::SubresourceIndex(i, 0), 0, 0, 0, 
-						image_data.data(), pixel_size(desc.format) * desc.width, pixel_size(desc.format) * desc.width * desc.height, desc.width, desc.height, 1));
-					image_data_array.push_back(move(image_data));
+					u64* dp = (u64*)(file_data.data() + 8);
+					u32 num_mips = (u32)*dp;
+					++dp;
+					Vector<Pair<u64, u64>> mip_descs;
+					mip_descs.reserve(num_mips);
+					for (u64 i = 0; i < num_mips; ++i)
+					{
+						Pair<u64, u64> p;
+						p.first = dp[i * 2];
+						p.second = dp[i * 2 + 1];
+						mip_descs.push_back(p);
+					}
+					// Load texture from file.
+					lulet(desc, Image::read_image_file_desc(file_data.data() + mip_descs[0].first, mip_descs[0].second));
+					auto desired_format = Image::get_rhi_desired_format(desc.format);
+					auto format = Image::image_to_rhi_format(desc.format);
+					// Create resource.
+					lulet(tex, g_env->device->new_texture(RHI::MemoryType::local, RHI::TextureDesc::tex2d(
+						format, 
+						RHI::TextureUsageFlag::read_texture | RHI::TextureUsageFlag::read_write_texture | RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest, 
+						desc.width, desc.height)));
+					// Upload data
+					Vector<Blob> image_data_array;
+					Vector<Image::ImageDesc> image_desc_array;
+					Vector<RHI::CopyResourceData> copies;
+					image_data_array.reserve(num_mips);
+					image_desc_array.reserve(num_mips);
+					copies.reserve(num_mips);
+					for (u32 i = 0; i < num_mips; ++i)
+					{
+						Image::ImageDesc desc;
+						lulet(image_data, Image::read_image_file(file_data.data() + mip_descs[i].first, mip_descs[i].second, desired_format, desc));
+						copies.push_back(RHI::CopyResourceData::write_texture(tex, RHI::SubresourceIndex(i, 0), 0, 0, 0, 
+							image_data.data(), pixel_size(desc.format) * desc.width, pixel_size(desc.format) * desc.width * desc.height, desc.width, desc.height, 1));
+						image_data_array.push_back(move(image_data));
+						image_desc_array.push_back(desc);
+					}
+					lulet(ticket, g_env->upload_copier->copy_resource_data(copies.cspan()));
+					luexp(g_env->upload_copier->wait(ticket));
+					save_cooked_texture(key, format, desc.width, desc.height, image_desc_array.cspan(), image_data_array.cspan(), false);
+					tex->set_name(path.encode().c_str());
+					ret = tex;
+				}
+				else
+				{
+					// Load texture from file.
+					lulet(desc, Image::read_image_file_desc(file_data.data(), file_data.size()));
+					auto desired_format = Image::get_rhi_desired_format(desc.format);
+					lulet(image_data, Image::read_image_file(file_data.data(), file_data.size(), desired_format, desc));
+					auto format = Image::image_to_rhi_format(desc.format);
+					// Create resource.
+					lulet(tex, RHI::get_main_device()->new_texture(RHI::MemoryType::local, RHI::TextureDesc::tex2d(
+						format,
+						RHI::TextureUsageFlag::read_texture | RHI::TextureUsageFlag::read_write_texture | RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest,
+						desc.width, desc.height)));
+					// Upload data.
+					lulet(ticket, g_env->upload_copier->copy_resource_data({RHI::CopyResourceData::write_texture(tex, RHI::SubresourceIndex(0, 0), 0, 0, 0,
+						image_data.data(), pixel_size(desc.format) * desc.width, pixel_size(desc.format) * desc.width * desc.height,
+						desc.width, desc.height, 1)}));
+					luexp(g_env->upload_copier->wait(ticket));
+					// Generate mipmaps.
+					lulet(cmdbuf, g_env->device->new_command_buffer(g_env->async_compute_queue));
+					cmdbuf->set_name("MipmapGeneration");
+					luexp(ctx->generate_mipmaps(tex, cmdbuf));
+					save_cooked_texture(key, format, desc.width, desc.height, { &desc, 1 }, { &image_data, 1 }, true);
+					tex->set_name(path.encode().c_str());
+					ret = tex;
 				}
-				lulet(upload_cmdbuf, g_env->device->new_command_buffer(g_env->async_copy_queue));
-				luexp(RHI::copy_resource_data(upload_cmdbuf, {copies.data(), copies.size()}));
-				tex->set_name(path.encode().c_str());
-				ret = tex;
-			}
-			else
-			{
-				// Load texture from file.
-				lulet(desc, Image::read_image_file_desc(file_data.data(), file_data.size()));
-				auto desired_format = Image::get_rhi_desired_format(desc.format);
-				lulet(image_data, Image::read_image_file(file_data.data(), file_data.size(), desired_format, desc));
-				// Create resource.
-				lulet(tex, RHI::get_main_device()->new_texture(RHI::MemoryType::local, RHI::TextureDesc::tex2d(
-					Image::image_to_rhi_format(desc.format),
-					RHI::TextureUsageFlag::read_texture | RHI::TextureUsageFlag::read_write_texture | RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest,
-					desc.width, desc.height)));
-				// Upload data.
-				lulet(upload_cmdbuf, g_env->device->new_command_buffer(g_env->async_copy_queue));
-				luexp(RHI::copy_resource_data(upload_cmdbuf, {RHI::CopyResourceData::write_texture(tex, RHI::SubresourceIndex(0, 0), 0, 0, 0,
-					image_data.data(), pixel_size(desc.format) * desc.width, pixel_size(desc.format) * desc.width * desc.height,
-					desc.width, desc.height, 1)}));
-				// Generate mipmaps.
-				Ref<TextureAssetUserdata> ctx = ObjRef(userdata);
-				lulet(cmdbuf, g_env->device->new_command_buffer(g_env->async_compute_queue));
-                cmdbuf->set_name("MipmapGeneration");
-				luexp(ctx->generate_mipmaps(tex, cmdbuf));
-				tex->set_name(path.encode().c_str());
-				ret = tex;
 			}
 		}
 		lucatchret;
 		return ret;
 	}
+	static u64 get_texture_asset_memory_cost(object_t userdata, Asset::asset_t asset, object_t data)
+	{
+		RHI::IResource* resource = query_interface<RHI::IResource>(data);
+		if (!resource) return 0;
+		RHI::IDeviceMemory* memory = resource->get_memory();
+		return memory ? memory->get_size() : 0;
+	}
 	RV register_static_texture_asset_type()
 	{
 		lutry
@@ -273,6 +416,7 @@ namespace Luna
 			desc.on_load_asset = load_texture_asset;
 			desc.on_save_asset = nullptr;
 			desc.on_set_asset_data = nullptr;
+			desc.on_get_asset_memory_cost = get_texture_asset_memory_cost;
 			desc.userdata = userdata;
 			Asset::register_asset_type(desc);
 		}
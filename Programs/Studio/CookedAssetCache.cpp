@@ -0,0 +1,140 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CookedAssetCache.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "CookedAssetCache.hpp"
+#include <Luna/Runtime/Hash.hpp>
+#include <Luna/Runtime/Thread.hpp>
+#include <Luna/Runtime/Log.hpp>
+
+namespace Luna
+{
+	constexpr c8 COOKED_ASSET_MAGIC[8] = { 'L', 'U', 'N', 'A', 'C', 'O', 'O', 'K' };
+	constexpr u32 COOKED_ASSET_VERSION = 1;
+
+	struct CookedAssetHeader
+	{
+		c8 magic[8];
+		u32 version;
+		u32 payload_offset;
+		u64 key;
+		u64 payload_size;
+	};
+
+	static_assert(sizeof(CookedAssetHeader) <= COOKED_ASSET_PAYLOAD_ALIGNMENT, "Cooked asset header too large.");
+
+	static Path g_cooked_asset_cache_dir;
+
+	static String get_cooked_asset_file_path(u64 key)
+	{
+		c8 filename[32];
+		snprintf(filename, 32, "%016llx.bin", (unsigned long long)key);
+		Path path = g_cooked_asset_cache_dir;
+		path.push_back(filename);
+		return path.encode(PathSeparator::system_preferred);
+	}
+
+	RV init_cooked_asset_cache(const Path& cache_dir)
+	{
+		auto r = create_dir(cache_dir.encode(PathSeparator::system_preferred).c_str());
+		if (failed(r) && r.errcode() != BasicError::already_exists()) return r;
+		g_cooked_asset_cache_dir = cache_dir;
+		return ok;
+	}
+
+	void close_cooked_asset_cache()
+	{
+		// Releases the path buffer before the runtime is closed.
+		g_cooked_asset_cache_dir = Path();
+	}
+
+	u64 calc_cooked_asset_key(const void* source_data, usize source_size, const c8* cooker)
+	{
+		u64 h = strhash64(cooker);
+		h = memhash64(&source_size, sizeof(usize), h);
+		return memhash64(source_data, source_size, h);
+	}
+
+	R<Ref<IFileMapping>> load_cooked_asset(u64 key)
+	{
+		if (g_cooked_asset_cache_dir.empty()) return BasicError::not_found();
+		Ref<IFileMapping> ret;
+		lutry
+		{
+			String path = get_cooked_asset_file_path(key);
+			auto file = open_file(path.c_str(), FileOpenFlag::read, FileCreationMode::open_existing);
+			if (failed(file)) return BasicError::not_found();
+			CookedAssetHeader header;
+			usize read_bytes;
+			luexp(file.get()->read(&header, sizeof(CookedAssetHeader), &read_bytes));
+			if (read_bytes != sizeof(CookedAssetHeader) || 
+				memcmp(header.magic, COOKED_ASSET_MAGIC, sizeof(COOKED_ASSET_MAGIC)) ||
+				header.version != COOKED_ASSET_VERSION ||
+				header.key != key ||
+				header.payload_offset + header.payload_size > file.get()->get_size())
+			{
+				// Treat corrupted payloads as missing, so that they will be cooked again.
+				return BasicError::not_found();
+			}
+			luset(ret, map_file(file.get(), header.payload_offset, (usize)header.payload_size));
+		}
+		lucatchret;
+		return ret;
+	}
+
+	static void delete_temp_file(const String& temp_path)
+	{
+		RV r = delete_file(temp_path.c_str());
+		if (failed(r))
+		{
+			log_warning("App", "Failed to delete temporary cooked asset file %s: %s", temp_path.c_str(), explain(r.errcode()));
+		}
+	}
+
+	RV save_cooked_asset(u64 key, const void* data, usize size)
+	{
+		if (g_cooked_asset_cache_dir.empty()) return BasicError::not_supported();
+		String path = get_cooked_asset_file_path(key);
+		c8 suffix[32];
+		snprintf(suffix, 32, ".%llx.tmp", (unsigned long long)(usize)get_current_thread());
+		String temp_path = path;
+		temp_path.append(suffix);
+		lutry
+		{
+			{
+				lulet(file, open_file(temp_path.c_str(), FileOpenFlag::write | FileOpenFlag::user_buffering, FileCreationMode::create_always));
+				CookedAssetHeader header;
+				memcpy(header.magic, COOKED_ASSET_MAGIC, sizeof(COOKED_ASSET_MAGIC));
+				header.version = COOKED_ASSET_VERSION;
+				header.payload_offset = (u32)COOKED_ASSET_PAYLOAD_ALIGNMENT;
+				header.key = key;
+				header.payload_size = size;
+				u8 padding[COOKED_ASSET_PAYLOAD_ALIGNMENT] = { 0 };
+				memcpy(padding, &header, sizeof(CookedAssetHeader));
+				luexp(file->write(padding, COOKED_ASSET_PAYLOAD_ALIGNMENT));
+				luexp(file->write(data, size));
+				file->flush();
+			}
+			// Re-cooking one payload replaces the old payload file, which may be corrupted or cooked by another thread.
+			RV r = move_file(temp_path.c_str(), path.c_str(), FileMoveFlag::none);
+			if (failed(r))
+			{
+				// Some platforms cannot replace files that are mapped by readers. Payloads with the same key 
+				// have the same data, so the existing payload can still be used if it is valid.
+				if (failed(load_cooked_asset(key))) luthrow(r.errcode());
+				delete_temp_file(temp_path);
+			}
+		}
+		lucatch
+		{
+			delete_temp_file(temp_path);
+			return luerr;
+		}
+		return ok;
+	}
+}
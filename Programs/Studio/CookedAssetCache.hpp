@@ -0,0 +1,43 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CookedAssetCache.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/Path.hpp>
+
+namespace Luna
+{
+	// The cooked asset cache stores derived binary payloads of assets, so that assets can be loaded by
+	// mapping the payload directly instead of parsing the source file. Payloads are addressed by the hash 
+	// of the source file data and the cooker name, so changing either of them produces a different key, and 
+	// stale payloads are never used.
+
+	//! The alignment of the payload data in the mapped memory.
+	constexpr usize COOKED_ASSET_PAYLOAD_ALIGNMENT = 64;
+
+	//! Sets the native directory to store cooked payloads. The directory will be created if not exists.
+	RV init_cooked_asset_cache(const Path& cache_dir);
+
+	void close_cooked_asset_cache();
+
+	//! Computes the key of one cooked payload.
+	//! @param[in] source_data The source file data.
+	//! @param[in] source_size The source file data size in bytes.
+	//! @param[in] cooker The name of the cooker, including its version and any settings that affect the cooked payload.
+	u64 calc_cooked_asset_key(const void* source_data, usize source_size, const c8* cooker);
+
+	//! Maps one cooked payload.
+	//! @return Returns the mapping of the payload data. The payload data is aligned to `COOKED_ASSET_PAYLOAD_ALIGNMENT`.
+	//! Returns `BasicError::not_found` if the payload is not in the cache, cannot be opened, or is corrupted.
+	R<Ref<IFileMapping>> load_cooked_asset(u64 key);
+
+	//! Stores one cooked payload. The payload is written to one temporary file first, so that other readers 
+	//! never see partially written payloads.
+	RV save_cooked_asset(u64 key, const void* data, usize size);
+}
@@ -36,6 +36,7 @@
 #include <Luna/Runtime/Log.hpp>
 #include <Luna/Runtime/Thread.hpp>
 #include <Luna/Runtime/Profiler.hpp>
+#include "CookedAssetCache.hpp"
 
 namespace Luna
 {
@@ -59,9 +60,17 @@ namespace Luna
 			mount_path.push_back("Data");
 			luexp(VFS::mount(VFS::get_platform_filesystem_driver(), mount_path.encode(PathSeparator::system_preferred).c_str(), "/"));
 
+			// Cooked asset payloads are stored outside of the Data folder, so they are not listed as assets.
+			auto cache_path = project_path;
+			cache_path.push_back("Cache");
+			luexp(init_cooked_asset_cache(cache_path));
+
 			// Load all asset metadata.
 			luexp(Asset::update_assets_meta("/"));
 
+			// Reload assets when their files are changed outside of the editor.
+			luexp(Asset::enable_asset_hot_reload("/"));
+
 			// Create window and render objects.
 			snprintf(title, 256, "%s - Luna Studio", name.c_str());
 			luset(m_window, Window::new_window(title, Window::WindowDisplaySettings::as_windowed(), Window::WindowCreationFlag::resizable));
@@ -150,6 +159,12 @@ namespace Luna
 			return ok;
 		}
 
+		Asset::update_asset_hot_reload();
+
+		// All GPU work of the last frame is waited before the last frame ends, so data of assets evicted 
+		// in the last frame can be released.
+		m_asset_frame = Asset::begin_asset_frame(m_asset_frame);
+
 		lutry
 		{
 			// Recreate the back buffer if needed.
@@ -251,6 +266,8 @@ namespace Luna
 	void MainEditor::close()
 	{
 		unregister_profiler_callback(m_memory_profiler_callback_handle);
+		auto _ = Asset::disable_asset_hot_reload("/");
+		close_cooked_asset_cache();
 	}
 
 	void register_components()
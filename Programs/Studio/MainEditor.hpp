@@ -41,10 +41,14 @@ namespace Luna
 		u32 m_main_window_width;
 		u32 m_main_window_height;
 
+		//! The asset frame index of the last frame.
+		u64 m_asset_frame;
+
 		MainEditor() :
 			m_exiting(false),
 			m_main_window_width(0),
-			m_main_window_height(0) {}
+			m_main_window_height(0),
+			m_asset_frame(0) {}
 		//m_next_asset_browser_index(0) {}
 
 		RV init(const Path& project_path);
@@ -0,0 +1,428 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file MeshOptimizer.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "MeshOptimizer.hpp"
+#include <Luna/Runtime/Algorithm.hpp>
+#include <math.h>
+
+namespace Luna
+{
+	// The vertex cache optimizer implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+	// Every vertex gets a score based on its position in a simulated LRU cache and the number of triangles that
+	// still use it, and the triangle with the highest score among triangles that use cached vertices is emitted next.
+
+	constexpr u32 VERTEX_CACHE_SIZE = 16;
+	constexpr u32 VERTEX_VALENCE_SIZE = 32;
+	constexpr u32 NOT_IN_CACHE = U32_MAX;
+
+	struct VertexScoreTable
+	{
+		f32 cache[VERTEX_CACHE_SIZE];
+		f32 valence[VERTEX_VALENCE_SIZE];
+
+		VertexScoreTable()
+		{
+			for (u32 i = 0; i < VERTEX_CACHE_SIZE; ++i)
+			{
+				// Vertices of the last triangle get a fixed score, so that the next triangle does not
+				// prefer reusing the last triangle's edges too much.
+				cache[i] = i < 3 ? 0.75f : powf(1.0f - (f32)(i - 3) / (f32)(VERTEX_CACHE_SIZE - 3), 1.5f);
+			}
+			valence[0] = 0.0f;
+			for (u32 i = 1; i < VERTEX_VALENCE_SIZE; ++i)
+			{
+				// Boosts vertices with few triangles left, so that they can be removed from the cache quickly.
+				valence[i] = 2.0f / sqrtf((f32)i);
+			}
+		}
+		f32 get_score(u32 cache_pos, u32 live_triangles) const
+		{
+			if (!live_triangles) return -1.0f;
+			f32 score = cache_pos == NOT_IN_CACHE ? 0.0f : cache[cache_pos];
+			return score + valence[min(live_triangles, VERTEX_VALENCE_SIZE - 1)];
+		}
+	};
+
+	void optimize_vertex_cache(u32* indices, Span<const MeshPiece> pieces, usize num_vertices)
+	{
+		static const VertexScoreTable score_table;
+		usize num_indices = 0;
+		for (auto& piece : pieces) num_indices = max<usize>(num_indices, (usize)piece.first_index_offset + piece.num_indices);
+		usize num_triangles = num_indices / 3;
+		if (!num_triangles) return;
+
+		// Builds the vertex-triangle adjacency. Triangles of every vertex are removed from the list once emitted,
+		// so `live_triangles` is also the number of triangles that still use the vertex.
+		Vector<u32> live_triangles(num_vertices, 0);
+		Vector<u32> adjacency_offsets(num_vertices);
+		Vector<u32> adjacency(num_triangles * 3);
+		for (usize i = 0; i < num_triangles * 3; ++i) ++live_triangles[indices[i]];
+		u32 offset = 0;
+		for (usize i = 0; i < num_vertices; ++i)
+		{
+			adjacency_offsets[i] = offset;
+			offset += live_triangles[i];
+			live_triangles[i] = 0;
+		}
+		for (usize i = 0; i < num_triangles * 3; ++i)
+		{
+			u32 v = indices[i];
+			adjacency[adjacency_offsets[v] + live_triangles[v]++] = (u32)(i / 3);
+		}
+
+		Vector<u32> cache_pos(num_vertices, NOT_IN_CACHE);
+		Vector<f32> vertex_scores(num_vertices);
+		for (usize i = 0; i < num_vertices; ++i) vertex_scores[i] = score_table.get_score(NOT_IN_CACHE, live_triangles[i]);
+		Vector<f32> triangle_scores(num_triangles);
+		Vector<u8> emitted(num_triangles, 0);
+		for (usize i = 0; i < num_triangles; ++i)
+		{
+			triangle_scores[i] = vertex_scores[indices[i * 3]] + vertex_scores[indices[i * 3 + 1]] + vertex_scores[indices[i * 3 + 2]];
+		}
+
+		// Updates the score of one vertex and triangles that use it.
+		auto update_vertex_score = [&](u32 v)
+		{
+			f32 score = score_table.get_score(cache_pos[v], live_triangles[v]);
+			f32 delta = score - vertex_scores[v];
+			vertex_scores[v] = score;
+			const u32* tris = adjacency.data() + adjacency_offsets[v];
+			for (u32 i = 0; i < live_triangles[v]; ++i) triangle_scores[tris[i]] += delta;
+		};
+
+		Vector<u32> output;
+		u32 cache[VERTEX_CACHE_SIZE + 3];
+		u32 new_cache[VERTEX_CACHE_SIZE + 3];
+		for (auto& piece : pieces)
+		{
+			u32 first_triangle = piece.first_index_offset / 3;
+			u32 end_triangle = first_triangle + piece.num_indices / 3;
+			output.clear();
+			output.reserve(piece.num_indices);
+			u32 cache_size = 0;
+			u32 cursor = first_triangle;
+			u32 best = U32_MAX;
+			for (u32 n = first_triangle; n < end_triangle; ++n)
+			{
+				if (best == U32_MAX)
+				{
+					// No cached vertex is used by any triangle, restarts from the next triangle in the input order.
+					while (emitted[cursor]) ++cursor;
+					best = cursor;
+				}
+				const u32* tri = indices + (usize)best * 3;
+				output.push_back(tri[0]);
+				output.push_back(tri[1]);
+				output.push_back(tri[2]);
+				emitted[best] = 1;
+				for (u32 i = 0; i < 3; ++i)
+				{
+					u32 v = tri[i];
+					u32* tris = adjacency.data() + adjacency_offsets[v];
+					u32 count = live_triangles[v];
+					for (u32 j = 0; j < count; ++j)
+					{
+						if (tris[j] == best)
+						{
+							tris[j] = tris[count - 1];
+							--live_triangles[v];
+							break;
+						}
+					}
+				}
+				// Pushes vertices of the triangle to the front of the cache.
+				u32 new_cache_size = 0;
+				for (u32 i = 0; i < 3; ++i)
+				{
+					u32 v = tri[i];
+					if ((i < 1 || v != tri[0]) && (i < 2 || v != tri[1])) new_cache[new_cache_size++] = v;
+				}
+				for (u32 i = 0; i < cache_size; ++i)
+				{
+					u32 v = cache[i];
+					if (v != tri[0] && v != tri[1] && v != tri[2]) new_cache[new_cache_size++] = v;
+				}
+				for (u32 i = 0; i < new_cache_size; ++i)
+				{
+					u32 v = new_cache[i];
+					cache_pos[v] = i < VERTEX_CACHE_SIZE ? i : NOT_IN_CACHE;
+					update_vertex_score(v);
+				}
+				cache_size = min(new_cache_size, VERTEX_CACHE_SIZE);
+				memcpy(cache, new_cache, sizeof(u32) * cache_size);
+				// Finds the next triangle from triangles that use cached vertices.
+				best = U32_MAX;
+				f32 best_score = -F32_MAX;
+				for (u32 i = 0; i < cache_size; ++i)
+				{
+					u32 v = cache[i];
+					const u32* tris = adjacency.data() + adjacency_offsets[v];
+					for (u32 j = 0; j < live_triangles[v]; ++j)
+					{
+						u32 t = tris[j];
+						if (t >= first_triangle && t < end_triangle && triangle_scores[t] > best_score)
+						{
+							best = t;
+							best_score = triangle_scores[t];
+						}
+					}
+				}
+			}
+			// Clears the cache so that the next piece starts with an empty cache.
+			for (u32 i = 0; i < cache_size; ++i)
+			{
+				cache_pos[cache[i]] = NOT_IN_CACHE;
+				update_vertex_score(cache[i]);
+			}
+			memcpy(indices + piece.first_index_offset, output.data(), sizeof(u32) * output.size());
+		}
+	}
+
+	//! The maximum number of vertices in one overdraw cluster.
+	constexpr u32 CLUSTER_MAX_VERTICES = 64;
+	//! The maximum number of triangles in one overdraw cluster.
+	constexpr u32 CLUSTER_MAX_TRIANGLES = 124;
+
+	//! One cluster of triangles that are stored continuously in the index buffer.
+	struct Cluster
+	{
+		u32 first_index;
+		u32 num_indices;
+	};
+
+	//! Splits triangles of one piece into clusters in their current order.
+	//! `vertex_clusters` stores the last cluster that uses every vertex, and must not contain IDs of `clusters`.
+	static void build_clusters(const u32* indices, const MeshPiece& piece, Vector<Cluster>& clusters, Vector<u32>& vertex_clusters, u32& next_cluster_id)
+	{
+		clusters.clear();
+		Cluster cluster;
+		cluster.first_index = piece.first_index_offset;
+		cluster.num_indices = 0;
+		u32 num_cluster_vertices = 0;
+		u32 id = next_cluster_id++;
+		u32 end_index = piece.first_index_offset + piece.num_indices;
+		for (u32 i = piece.first_index_offset; i + 2 < end_index; i += 3)
+		{
+			const u32* tri = indices + i;
+			u32 new_vertices = 0;
+			for (u32 j = 0; j < 3; ++j)
+			{
+				if (vertex_clusters[tri[j]] != id && (j < 1 || tri[j] != tri[0]) && (j < 2 || tri[j] != tri[1])) ++new_vertices;
+			}
+			if (num_cluster_vertices + new_vertices > CLUSTER_MAX_VERTICES || cluster.num_indices / 3 >= CLUSTER_MAX_TRIANGLES)
+			{
+				clusters.push_back(cluster);
+				cluster.first_index = i;
+				cluster.num_indices = 0;
+				num_cluster_vertices = 0;
+				id = next_cluster_id++;
+				new_vertices = 0;
+				for (u32 j = 0; j < 3; ++j)
+				{
+					if ((j < 1 || tri[j] != tri[0]) && (j < 2 || tri[j] != tri[1])) ++new_vertices;
+				}
+			}
+			for (u32 j = 0; j < 3; ++j) vertex_clusters[tri[j]] = id;
+			num_cluster_vertices += new_vertices;
+			cluster.num_indices += 3;
+		}
+		if (cluster.num_indices) clusters.push_back(cluster);
+	}
+
+	inline const Float3U& get_position(const Float3U* positions, usize position_stride, u32 index)
+	{
+		return *(const Float3U*)((const byte_t*)positions + position_stride * index);
+	}
+
+	void optimize_overdraw(u32* indices, Span<const MeshPiece> pieces, const Float3U* positions, usize position_stride)
+	{
+		// Implements the overdraw pass of "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+		// (Sander et al.). Clusters whose normals point away from the center of the piece are more likely to occlude
+		// other clusters, so they are drawn first.
+		u32 num_vertices = 0;
+		for (auto& piece : pieces)
+		{
+			for (u32 i = piece.first_index_offset; i < piece.first_index_offset + piece.num_indices; ++i) num_vertices = max(num_vertices, indices[i] + 1);
+		}
+		Vector<u32> vertex_clusters(num_vertices, U32_MAX);
+		u32 next_cluster_id = 0;
+		Vector<Cluster> clusters;
+		Vector<Float3> centroids;
+		Vector<Float3> normals;
+		Vector<f32> keys;
+		Vector<u32> order;
+		Vector<u32> sorted_indices;
+		for (auto& piece : pieces)
+		{
+			build_clusters(indices, piece, clusters, vertex_clusters, next_cluster_id);
+			usize num_clusters = clusters.size();
+			if (num_clusters <= 1) continue;
+			centroids.resize(num_clusters);
+			normals.resize(num_clusters);
+			keys.resize(num_clusters);
+			Float3 piece_center(0.0f, 0.0f, 0.0f);
+			f32 piece_area = 0.0f;
+			for (usize c = 0; c < num_clusters; ++c)
+			{
+				const Cluster& cluster = clusters[c];
+				Float3 centroid(0.0f, 0.0f, 0.0f);
+				Float3 normal(0.0f, 0.0f, 0.0f);
+				f32 area = 0.0f;
+				for (u32 i = cluster.first_index; i < cluster.first_index + cluster.num_indices; i += 3)
+				{
+					Float3 p0 = get_position(positions, position_stride, indices[i]);
+					Float3 p1 = get_position(positions, position_stride, indices[i + 1]);
+					Float3 p2 = get_position(positions, position_stride, indices[i + 2]);
+					Float3 n = cross(p1 - p0, p2 - p0);
+					f32 a = length(n);
+					centroid += (p0 + p1 + p2) * (a / 3.0f);
+					normal += n;
+					area += a;
+				}
+				centroid = area > 0.0f ? centroid / area : centroid;
+				centroids[c] = centroid;
+				normals[c] = normal;
+				piece_center += centroid * area;
+				piece_area += area;
+			}
+			if (piece_area > 0.0f) piece_center /= piece_area;
+			for (usize c = 0; c < num_clusters; ++c)
+			{
+				f32 normal_length = length(normals[c]);
+				keys[c] = normal_length > 0.0f ? dot(centroids[c] - piece_center, normals[c] / normal_length) : 0.0f;
+			}
+			order.resize(num_clusters);
+			for (usize i = 0; i < num_clusters; ++i) order[i] = (u32)i;
+			// Clusters with equal keys are kept in their original order to make the result deterministic.
+			sort(order.begin(), order.end(), [&](u32 a, u32 b) { return keys[a] > keys[b] || (keys[a] == keys[b] && a < b); });
+			sorted_indices.clear();
+			sorted_indices.reserve(piece.num_indices);
+			for (usize i = 0; i < num_clusters; ++i)
+			{
+				const Cluster& cluster = clusters[order[i]];
+				sorted_indices.insert(sorted_indices.end(), indices + cluster.first_index, indices + cluster.first_index + cluster.num_indices);
+			}
+			memcpy(indices + piece.first_index_offset, sorted_indices.data(), sizeof(u32) * sorted_indices.size());
+		}
+	}
+
+	usize optimize_vertex_fetch(u32* indices, usize num_indices, Vertex* vertices, usize num_vertices)
+	{
+		Vector<u32> remap(num_vertices, U32_MAX);
+		u32 num_new_vertices = 0;
+		for (usize i = 0; i < num_indices; ++i)
+		{
+			u32& r = remap[indices[i]];
+			if (r == U32_MAX) r = num_new_vertices++;
+			indices[i] = r;
+		}
+		Blob old_vertices((const byte_t*)vertices, sizeof(Vertex) * num_vertices);
+		const Vertex* src = (const Vertex*)old_vertices.data();
+		for (usize i = 0; i < num_vertices; ++i)
+		{
+			if (remap[i] != U32_MAX) vertices[remap[i]] = src[i];
+		}
+		return num_new_vertices;
+	}
+
+	f32 calc_vertex_cache_acmr(const u32* indices, usize num_indices, usize num_vertices, u32 cache_size)
+	{
+		if (num_indices < 3) return 0.0f;
+		// Every vertex records the time it is pushed into the cache, so that the FIFO cache can be simulated
+		// without storing cache entries.
+		Vector<u32> push_time(num_vertices, 0);
+		u32 time = cache_size + 1;
+		usize misses = 0;
+		for (usize i = 0; i < num_indices; ++i)
+		{
+			u32 v = indices[i];
+			if (time - push_time[v] > cache_size)
+			{
+				push_time[v] = time++;
+				++misses;
+			}
+		}
+		return (f32)misses / (f32)(num_indices / 3);
+	}
+
+	f32 calc_overdraw(const u32* indices, usize num_indices, const Float3U* positions, usize position_stride, usize num_vertices)
+	{
+		constexpr i32 VIEWPORT_SIZE = 256;
+		if (num_indices < 3 || !num_vertices) return 0.0f;
+		Float3 min_pos = get_position(positions, position_stride, 0);
+		Float3 max_pos = min_pos;
+		for (u32 i = 1; i < (u32)num_vertices; ++i)
+		{
+			Float3 p = get_position(positions, position_stride, i);
+			min_pos = min(min_pos, p);
+			max_pos = max(max_pos, p);
+		}
+		Float3 extent = max_pos - min_pos;
+		f32 scale = (f32)(VIEWPORT_SIZE - 1) / max(max(max(extent.x, extent.y), extent.z), F32_EPSILON);
+		Vector<f32> depth_buffer(VIEWPORT_SIZE * VIEWPORT_SIZE);
+		usize covered = 0;
+		usize shaded = 0;
+		for (u32 view = 0; view < 6; ++view)
+		{
+			// The viewer looks at the mesh from the positive or negative side of one axis. Larger depth values are
+			// closer to the viewer.
+			u32 axis = view / 2;
+			f32 sign = (view % 2) ? -1.0f : 1.0f;
+			u32 axis_x = (axis + 1) % 3;
+			u32 axis_y = (axis + 2) % 3;
+			for (f32& d : depth_buffer) d = -F32_MAX;
+			for (usize t = 0; t + 2 < num_indices; t += 3)
+			{
+				Float3 p[3];
+				for (u32 j = 0; j < 3; ++j)
+				{
+					Float3 v = (Float3(get_position(positions, position_stride, indices[t + j])) - min_pos) * scale;
+					// Mirrors the x axis for negative views so that the winding order is kept.
+					p[j] = Float3(sign * v.m[axis_x], v.m[axis_y], sign * v.m[axis]);
+				}
+				f32 area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+				if (area <= 0.0f) continue;
+				f32 offset_x = sign < 0.0f ? (f32)(VIEWPORT_SIZE - 1) : 0.0f;
+				for (u32 j = 0; j < 3; ++j) p[j].x += offset_x;
+				i32 x0 = max((i32)floorf(min(min(p[0].x, p[1].x), p[2].x)), 0);
+				i32 x1 = min((i32)ceilf(max(max(p[0].x, p[1].x), p[2].x)), VIEWPORT_SIZE - 1);
+				i32 y0 = max((i32)floorf(min(min(p[0].y, p[1].y), p[2].y)), 0);
+				i32 y1 = min((i32)ceilf(max(max(p[0].y, p[1].y), p[2].y)), VIEWPORT_SIZE - 1);
+				for (i32 y = y0; y <= y1; ++y)
+				{
+					for (i32 x = x0; x <= x1; ++x)
+					{
+						f32 px = (f32)x + 0.5f;
+						f32 py = (f32)y + 0.5f;
+						f32 w0 = (p[2].x - p[1].x) * (py - p[1].y) - (p[2].y - p[1].y) * (px - p[1].x);
+						f32 w1 = (p[0].x - p[2].x) * (py - p[2].y) - (p[0].y - p[2].y) * (px - p[2].x);
+						f32 w2 = area - w0 - w1;
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+						f32 depth = (p[0].z * w0 + p[1].z * w1 + p[2].z * w2) / area;
+						f32& dst = depth_buffer[y * VIEWPORT_SIZE + x];
+						if (depth <= dst) continue;
+						if (dst == -F32_MAX) ++covered;
+						dst = depth;
+						++shaded;
+					}
+				}
+			}
+		}
+		return covered ? (f32)shaded / (f32)covered : 0.0f;
+	}
+
+	usize optimize_mesh(u32* indices, Span<const MeshPiece> pieces, Vertex* vertices, usize num_vertices)
+	{
+		usize num_indices = 0;
+		for (auto& piece : pieces) num_indices = max<usize>(num_indices, (usize)piece.first_index_offset + piece.num_indices);
+		optimize_vertex_cache(indices, pieces, num_vertices);
+		optimize_overdraw(indices, pieces, &vertices[0].position, sizeof(Vertex));
+		return optimize_vertex_fetch(indices, num_indices, vertices, num_vertices);
+	}
+}
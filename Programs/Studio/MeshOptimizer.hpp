@@ -0,0 +1,61 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file MeshOptimizer.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include "Mesh.hpp"
+
+namespace Luna
+{
+	//! Reorders triangles of every mesh piece to reduce post-transform vertex cache misses.
+	//! Triangles are not moved between pieces, so the piece layout is not changed.
+	//! @param[in,out] indices The index buffer.
+	//! @param[in] pieces The pieces of the mesh.
+	//! @param[in] num_vertices The number of vertices referred by the index buffer.
+	void optimize_vertex_cache(u32* indices, Span<const MeshPiece> pieces, usize num_vertices);
+
+	//! Reorders triangles of every mesh piece to reduce overdraw for most view directions. Triangles of every piece
+	//! are split into clusters of at most 64 vertices and 124 triangles in their current order, and clusters facing
+	//! outwards are drawn first. Triangles of every cluster are moved together, so this should be called after
+	//! `optimize_vertex_cache` to keep the vertex cache efficiency.
+	//! @param[in,out] indices The index buffer.
+	//! @param[in] pieces The pieces of the mesh. Pieces may be specified in any order, but must not overlap.
+	//! @param[in] positions The pointer to the position of the first vertex.
+	//! @param[in] position_stride The distance in bytes between positions of two adjacent vertices.
+	void optimize_overdraw(u32* indices, Span<const MeshPiece> pieces, const Float3U* positions, usize position_stride);
+
+	//! Reorders vertices in the order they are first referred by the index buffer, so that vertex fetches are
+	//! as sequential as possible.
+	//! @param[in,out] indices The index buffer. Indices are remapped to the new vertex order.
+	//! @param[in] num_indices The number of indices.
+	//! @param[in,out] vertices The vertex buffer.
+	//! @param[in] num_vertices The number of vertices in the vertex buffer.
+	//! @return The number of vertices after reordering. Vertices that are not referred by any index are removed.
+	usize optimize_vertex_fetch(u32* indices, usize num_indices, Vertex* vertices, usize num_vertices);
+
+	//! Simulates one FIFO post-transform vertex cache and returns the average number of cache misses per triangle.
+	f32 calc_vertex_cache_acmr(const u32* indices, usize num_indices, usize num_vertices, u32 cache_size = 16);
+
+	//! Rasterizes triangles from 6 axis-aligned directions with back-face culling and depth testing, and returns
+	//! the average number of times every covered pixel is shaded. Triangles whose vertices are in counter-clockwise
+	//! order when seen from the viewer are front-facing.
+	//! @param[in] indices The index buffer.
+	//! @param[in] num_indices The number of indices.
+	//! @param[in] positions The pointer to the position of the first vertex.
+	//! @param[in] position_stride The distance in bytes between positions of two adjacent vertices.
+	//! @param[in] num_vertices The number of vertices referred by the index buffer.
+	f32 calc_overdraw(const u32* indices, usize num_indices, const Float3U* positions, usize position_stride, usize num_vertices);
+
+	//! Runs all mesh optimization passes on the mesh.
+	//! @param[in,out] indices The index buffer.
+	//! @param[in] pieces The pieces of the mesh.
+	//! @param[in,out] vertices The vertex buffer.
+	//! @param[in] num_vertices The number of vertices in the vertex buffer.
+	//! @return The number of vertices after optimization.
+	usize optimize_mesh(u32* indices, Span<const MeshPiece> pieces, Vertex* vertices, usize num_vertices);
+}
@@ -59,7 +59,8 @@ namespace Luna
             ps_desc.color_formats[1] = Format::rgba8_unorm;
             ps_desc.color_formats[2] = Format::rgba16_float;
 			ps_desc.depth_stencil_format = Format::d32_float;
-			luset(m_geometry_pass_pso, device->new_graphics_pipeline_state(ps_desc));
+			// The pipeline state is created by job system workers while default textures are uploaded.
+			Ref<IPipelineStateFuture> geometry_pass_pso = new_graphics_pipeline_state_async(device, ps_desc);
 
             luset(m_default_base_color, device->new_texture(MemoryType::local,
 				TextureDesc::tex2d(Format::rgba8_unorm, TextureUsageFlag::read_texture | TextureUsageFlag::copy_dest, 1, 1, 1, 1)));
@@ -85,6 +86,7 @@ namespace Luna
 				CopyResourceData::write_texture(m_default_normal, SubresourceIndex(0, 0), 0, 0, 0, normal_data, 4, 4, 1, 1, 1),
 				CopyResourceData::write_texture(m_default_metallic, SubresourceIndex(0, 0), 0, 0, 0, &metallic_data, 1, 1, 1, 1, 1),
 				CopyResourceData::write_texture(m_default_emissive, SubresourceIndex(0, 0), 0, 0, 0, emissive_data, 4, 4, 1, 1, 1)}));
+			luset(m_geometry_pass_pso, geometry_pass_pso->get());
         }
         lucatchret;
         return ok;
@@ -249,8 +251,7 @@ namespace Luna
 							}
 						}
 					}
-					lulet(vs, device->new_descriptor_set(DescriptorSetDesc(m_global_data->m_geometry_pass_dlayout)));
-					luexp(vs->update_descriptors({
+					lulet(vs, cmdbuf->allocate_transient_descriptor_set(DescriptorSetDesc(m_global_data->m_geometry_pass_dlayout), {
 						WriteDescriptorSet::uniform_buffer_view(0, BufferViewDesc::uniform_buffer(camera_cb, 0, (u32)align_upper(sizeof(CameraCB), cb_align))),
 						WriteDescriptorSet::read_buffer_view(1, BufferViewDesc::structured_buffer(model_matrices, i, 1, sizeof(Float4x4) * 2)),
 						WriteDescriptorSet::read_texture_view(2, TextureViewDesc::tex2d(base_color_tex)),
@@ -261,7 +262,6 @@ namespace Luna
 						WriteDescriptorSet::sampler(7, SamplerDesc(Filter::linear, Filter::linear, Filter::linear, TextureAddressMode::repeat, TextureAddressMode::repeat, TextureAddressMode::repeat))
 						}));
 					cmdbuf->set_graphics_descriptor_set(0, vs);
-					cmdbuf->attach_device_object(vs);
 					cmdbuf->draw_indexed(mesh->pieces[j].num_indices, mesh->pieces[j].first_index_offset, 0);
 				}
 			}
@@ -19,6 +19,11 @@ namespace Luna
         using namespace RHI;
         lutry
         {
+			// Pipeline states are created by job system workers while shaders of other passes are compiled.
+			Ref<IPipelineStateFuture> histogram_clear_pass_pso;
+			Ref<IPipelineStateFuture> histogram_pass_pso;
+			Ref<IPipelineStateFuture> histogram_collect_pass_pso;
+			Ref<IPipelineStateFuture> tone_mapping_pass_pso;
 			// Histogram Clear Pass.
 			{
 				luset(m_histogram_clear_pass_dlayout, device->new_descriptor_set_layout(DescriptorSetLayoutDesc({
@@ -33,7 +38,7 @@ namespace Luna
 				ComputePipelineStateDesc ps_desc;
 				ps_desc.cs = cs_blob.cspan();
 				ps_desc.pipeline_layout = m_histogram_clear_pass_playout;
-				luset(m_histogram_clear_pass_pso, device->new_compute_pipeline_state(ps_desc));
+				histogram_clear_pass_pso = new_compute_pipeline_state_async(device, ps_desc);
 			}
 			// Histogram Lum Pass.
 			{
@@ -51,7 +56,7 @@ namespace Luna
 				ComputePipelineStateDesc ps_desc;
 				ps_desc.cs = cs_blob.cspan();
 				ps_desc.pipeline_layout = m_histogram_pass_playout;
-				luset(m_histogram_pass_pso, device->new_compute_pipeline_state(ps_desc));
+				histogram_pass_pso = new_compute_pipeline_state_async(device, ps_desc);
 			}
 			// Histogram Collect Pass.
 			{
@@ -69,7 +74,7 @@ namespace Luna
 				ComputePipelineStateDesc ps_desc;
 				ps_desc.cs = cs_blob.cspan();
 				ps_desc.pipeline_layout = m_histogram_collect_pass_playout;
-				luset(m_histogram_collect_pass_pso, device->new_compute_pipeline_state(ps_desc));
+				histogram_collect_pass_pso = new_compute_pipeline_state_async(device, ps_desc);
 			}
 			//Tone Mapping Pass.
 			{
@@ -88,8 +93,12 @@ namespace Luna
 				ComputePipelineStateDesc ps_desc;
 				ps_desc.cs = cs_blob.cspan();
 				ps_desc.pipeline_layout = m_tone_mapping_pass_playout;
-				luset(m_tone_mapping_pass_pso, device->new_compute_pipeline_state(ps_desc));
+				tone_mapping_pass_pso = new_compute_pipeline_state_async(device, ps_desc);
 			}
+			luset(m_histogram_clear_pass_pso, histogram_clear_pass_pso->get());
+			luset(m_histogram_pass_pso, histogram_pass_pso->get());
+			luset(m_histogram_collect_pass_pso, histogram_collect_pass_pso->get());
+			luset(m_tone_mapping_pass_pso, tone_mapping_pass_pso->get());
         }
         lucatchret;
         return ok;
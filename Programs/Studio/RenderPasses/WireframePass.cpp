@@ -127,14 +127,11 @@ namespace Luna
 			// Draw Meshes.
 			for (usize i = 0; i < ts.size(); ++i)
 			{
-				auto vs = device->new_descriptor_set(DescriptorSetDesc(m_global_data->m_debug_mesh_renderer_dlayout)).get();
-				luexp(vs->update_descriptors({
+				lulet(vs, cmdbuf->allocate_transient_descriptor_set(DescriptorSetDesc(m_global_data->m_debug_mesh_renderer_dlayout), {
 					WriteDescriptorSet::uniform_buffer_view(0, BufferViewDesc::uniform_buffer(camera_cb, 0, (u32)align_upper(sizeof(CameraCB), cb_align))),
 					WriteDescriptorSet::read_buffer_view(1, BufferViewDesc::structured_buffer(model_matrices, i, 1, sizeof(Float4x4) * 2))
 					}));
-				IDescriptorSet* vs_d = vs.get();
-				cmdbuf->set_graphics_descriptor_sets(0, { &vs_d, 1 });
-				cmdbuf->attach_device_object(vs);
+				cmdbuf->set_graphics_descriptor_set(0, vs);
 
 				// Draw pieces.
 				auto mesh = Asset::get_asset_data<Mesh>(Asset::get_asset_data<Model>(rs[i]->model)->mesh);
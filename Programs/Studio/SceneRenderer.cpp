@@ -206,14 +206,28 @@ namespace Luna
 				auto r = i->get_component<ModelRenderer>();
 				if (r)
 				{
-					auto model = Asset::get_asset_data<Model>(r->model);
+					auto model = Asset::get_asset_data<Model>(r->model, false);
 					if (!model)
 					{
+						// Models that failed to load are not reloaded every frame. They are loaded again when the asset 
+						// is reloaded explicitly, for example by hot reloading, which resets the loading result.
+						if (Asset::get_asset_state(r->model) == Asset::AssetState::unloaded &&
+							Asset::get_asset_loading_result(r->model).code == ErrCode(0))
+						{
+							// Loads the mesh, materials and textures of the model in the same wave.
+							Asset::load_asset_recursive(r->model);
+						}
 						continue;
 					}
-					auto mesh = Asset::get_asset_data<Mesh>(model->mesh);
+					auto mesh = Asset::get_asset_data<Mesh>(model->mesh, false);
 					if (!mesh)
 					{
+						// The mesh may be evicted while the model is still loaded.
+						if (Asset::get_asset_state(model->mesh) == Asset::AssetState::unloaded &&
+							Asset::get_asset_loading_result(model->mesh).code == ErrCode(0))
+						{
+							Asset::load_asset(model->mesh);
+						}
 						continue;
 					}
 					ts.push_back(i);
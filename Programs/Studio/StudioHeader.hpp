@@ -10,6 +10,7 @@
 #pragma once
 #include <Luna/HID/HID.hpp>
 #include <Luna/RHI/RHI.hpp>
+#include <Luna/RHI/Utility.hpp>
 #include <Luna/ImGui/ImGui.hpp>
 #include <Luna/Image/Image.hpp>
 #include <Luna/Image/DDSImage.hpp>
@@ -160,6 +161,10 @@ namespace Luna
 		u32 async_compute_queue;
 		u32 async_copy_queue;
 
+		//! The copier used to upload asset data to the GPU. Copies from multiple loading threads are batched into one 
+		//! submission on the async copy queue.
+		Ref<RHI::IResourceDataCopier> upload_copier;
+
 		void register_asset_importer_type(const Name& name, const AssetImporterDesc& desc)
 		{
 			importer_types.insert(Pair<Name, AssetImporterDesc>(name, desc));
@@ -21,12 +21,21 @@ namespace Luna
 {
 	AppEnv* g_env = nullptr;
 
+	//! The file that stores the pipeline cache data between editor runs, relative to the process path.
+	constexpr const c8* PIPELINE_CACHE_PATH = "PipelineCache.bin";
+
 	RV init_env()
 	{
 		lutry
 		{
 			g_env = memnew<AppEnv>();
 			g_env->device = RHI::get_main_device();
+			// The pipeline cache only speeds up pipeline creation, so the editor runs without it if it cannot be loaded.
+			auto r = RHI::load_pipeline_cache(g_env->device, PIPELINE_CACHE_PATH);
+			if (failed(r))
+			{
+				log_error("App", "Failed to load pipeline cache: %s", explain(r.errcode()));
+			}
 			u32 num_queues = g_env->device->get_num_command_queues();
 			g_env->graphics_queue = U32_MAX;
 			g_env->async_compute_queue = U32_MAX;
@@ -49,11 +58,23 @@ namespace Luna
 			}
 			if (g_env->async_compute_queue == U32_MAX) g_env->async_compute_queue = g_env->graphics_queue;
 			if(g_env->async_copy_queue == U32_MAX) g_env->async_copy_queue = g_env->graphics_queue;
+			luset(g_env->upload_copier, RHI::new_resource_data_copier(g_env->device, g_env->async_copy_queue));
 		}
 		lucatchret;
 		return ok;
 	}
 
+	void close_env()
+	{
+		auto r = RHI::save_pipeline_cache(g_env->device, PIPELINE_CACHE_PATH);
+		if (failed(r))
+		{
+			log_error("App", "Failed to save pipeline cache: %s", explain(r.errcode()));
+		}
+		memdelete(g_env);
+		g_env = nullptr;
+	}
+
 	void run_editor()
 	{
 		set_log_to_platform_enabled(true);
@@ -80,16 +101,14 @@ namespace Luna
 		auto project = select_project();
 		if (failed(project))
 		{
-			memdelete(g_env);
-			g_env = nullptr;
+			close_env();
 			return;
 		}
 
 		// Run main editor.
 		run_main_editor(project.get());
 
-		memdelete(g_env);
-		g_env = nullptr;
+		close_env();
 
 		return;
 	}
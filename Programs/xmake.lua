@@ -1,2 +1,4 @@
 includes("Studio")
-includes("LunaDoc")
\ No newline at end of file
+includes("LunaDoc")
+includes("LogDecoder")
+includes("PackBuilder")
\ No newline at end of file
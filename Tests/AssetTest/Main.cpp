@@ -0,0 +1,151 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/VFS/VFS.hpp>
+#include <Luna/Asset/Asset.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	struct TestAssetData
+	{
+		lustruct("TestAssetData", "{6A0D8D0B-3C7A-4F63-9D43-62F0A5C1E2B7}");
+		static usize s_num_destroyed;
+		u32 value = 0;
+		~TestAssetData()
+		{
+			++s_num_destroyed;
+		}
+	};
+	usize TestAssetData::s_num_destroyed = 0;
+
+	constexpr u64 TEST_ASSET_MEMORY_COST = 100;
+
+	static u64 on_get_test_asset_memory_cost(object_t userdata, Asset::asset_t asset, object_t data)
+	{
+		return TEST_ASSET_MEMORY_COST;
+	}
+
+	static void set_test_asset_data(Asset::asset_t asset, u32 value)
+	{
+		Ref<TestAssetData> data = new_object<TestAssetData>();
+		data->value = value;
+		lutest(succeeded(Asset::set_asset_data(asset, data.object())));
+	}
+
+	static bool is_loaded(Asset::asset_t asset)
+	{
+		return Asset::get_asset_state(asset) == Asset::AssetState::loaded;
+	}
+
+	static void budget_test()
+	{
+		Asset::asset_t assets[4];
+		for (usize i = 0; i < 4; ++i)
+		{
+			c8 path[16];
+			snprintf(path, 16, "/a%u", (u32)i);
+			auto r = Asset::new_asset(path, "TestAsset");
+			lutest(succeeded(r));
+			assets[i] = r.get();
+			set_test_asset_data(assets[i], (u32)i);
+		}
+		auto stats = Asset::get_asset_residency_statistics();
+		lutest(stats.num_resident_assets == 4);
+		lutest(stats.resident_memory == 4 * TEST_ASSET_MEMORY_COST);
+
+		// Using one asset makes it the most recently used one, so the LRU order is a1, a2, a3, a0.
+		lutest(Asset::get_asset_data<TestAssetData>(assets[0], false)->value == 0);
+		usize num_destroyed = TestAssetData::s_num_destroyed;
+		Asset::set_asset_memory_budget(250);
+		lutest(!is_loaded(assets[1]) && !is_loaded(assets[2]));
+		lutest(is_loaded(assets[0]) && is_loaded(assets[3]));
+		stats = Asset::get_asset_residency_statistics();
+		lutest(stats.resident_memory == 2 * TEST_ASSET_MEMORY_COST);
+		lutest(stats.num_evicted_assets == 2);
+		// Evicted data is released immediately before frames are tracked.
+		lutest(TestAssetData::s_num_destroyed == num_destroyed + 2);
+
+		// Loading one asset that exceeds the budget evicts the least recently used asset other than itself.
+		set_test_asset_data(assets[1], 1);
+		lutest(is_loaded(assets[1]) && is_loaded(assets[0]) && !is_loaded(assets[3]));
+
+		// Assets referenced outside of the asset system are not evicted.
+		Asset::set_asset_memory_budget(U64_MAX);
+		{
+			Ref<TestAssetData> data = Asset::get_asset_data<TestAssetData>(assets[1], false);
+			lutest(Asset::evict_assets() == TEST_ASSET_MEMORY_COST);
+			lutest(is_loaded(assets[1]) && !is_loaded(assets[0]));
+		}
+		lutest(Asset::evict_assets() == TEST_ASSET_MEMORY_COST);
+		lutest(Asset::get_asset_residency_statistics().num_resident_assets == 0);
+
+		// Evicted data is kept alive until the frame when it is evicted is completed.
+		u64 frame = Asset::begin_asset_frame(0);
+		lutest(frame == 1);
+		set_test_asset_data(assets[2], 2);
+		set_test_asset_data(assets[3], 3);
+		num_destroyed = TestAssetData::s_num_destroyed;
+		lutest(Asset::evict_assets() == 2 * TEST_ASSET_MEMORY_COST);
+		lutest(!is_loaded(assets[2]) && !is_loaded(assets[3]));
+		stats = Asset::get_asset_residency_statistics();
+		lutest(stats.resident_memory == 0);
+		lutest(stats.num_retired_assets == 2 && stats.retired_memory == 2 * TEST_ASSET_MEMORY_COST);
+		lutest(TestAssetData::s_num_destroyed == num_destroyed);
+		// Frame 1 is still in flight.
+		lutest(Asset::begin_asset_frame(0) == 2);
+		lutest(TestAssetData::s_num_destroyed == num_destroyed);
+		set_test_asset_data(assets[0], 0);
+		lutest(Asset::evict_assets() == TEST_ASSET_MEMORY_COST);
+		// Frame 1 is completed, frame 2 is still in flight.
+		lutest(Asset::begin_asset_frame(1) == 3);
+		lutest(TestAssetData::s_num_destroyed == num_destroyed + 2);
+		stats = Asset::get_asset_residency_statistics();
+		lutest(stats.num_retired_assets == 1 && stats.retired_memory == TEST_ASSET_MEMORY_COST);
+		lutest(Asset::begin_asset_frame(3) == 4);
+		lutest(TestAssetData::s_num_destroyed == num_destroyed + 3);
+		lutest(Asset::get_asset_residency_statistics().num_retired_assets == 0);
+
+		for (usize i = 0; i < 4; ++i)
+		{
+			lutest(succeeded(Asset::delete_asset(assets[i])));
+		}
+	}
+
+	void asset_test()
+	{
+		register_struct_type<TestAssetData>({});
+		Asset::AssetTypeDesc desc;
+		desc.name = "TestAsset";
+		desc.on_get_asset_memory_cost = on_get_test_asset_memory_cost;
+		Asset::register_asset_type(desc);
+		lutest(succeeded(create_dir("AssetTestDir")));
+		lutest(succeeded(VFS::mount(VFS::get_platform_filesystem_driver(), "AssetTestDir", "/")));
+		budget_test();
+		lutest(succeeded(VFS::unmount("/")));
+		lutest(succeeded(delete_file("AssetTestDir")));
+	}
+}
+
+int main()
+{
+	Luna::init();
+	lupanic_if_failed(Luna::add_modules({Luna::module_asset()}));
+	lupanic_if_failed(Luna::init_modules());
+	Luna::set_log_to_platform_enabled(true);
+	Luna::set_log_to_platform_verbosity(Luna::LogVerbosity::warning);
+	Luna::asset_test();
+	Luna::close();
+	return 0;
+}
@@ -0,0 +1,421 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file BCEncoderTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Image/BCEncoder.hpp>
+#include <Luna/Image/Resample.hpp>
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/Runtime/Math/Math.hpp>
+
+namespace Luna
+{
+	using namespace Image;
+
+	// Reference block decoders written from the format specifications, so that encoded blocks are checked
+	// independently of the encoder.
+
+	struct BlockBitReader
+	{
+		const u8* data;
+		u32 pos = 0;
+		u32 read(u32 num_bits)
+		{
+			u32 ret = 0;
+			for (u32 i = 0; i < num_bits; ++i, ++pos)
+			{
+				ret |= (u32)((data[pos >> 3] >> (pos & 7)) & 1) << i;
+			}
+			return ret;
+		}
+	};
+
+	static void decode_bc1_block(const u8* src, u8(*dst)[4], bool always_four_colors)
+	{
+		u16 c[2] = { (u16)(src[0] | (src[1] << 8)), (u16)(src[2] | (src[3] << 8)) };
+		i32 colors[4][4];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			u32 r = (c[i] >> 11) & 0x1F;
+			u32 g = (c[i] >> 5) & 0x3F;
+			u32 b = c[i] & 0x1F;
+			colors[i][0] = (i32)((r << 3) | (r >> 2));
+			colors[i][1] = (i32)((g << 2) | (g >> 4));
+			colors[i][2] = (i32)((b << 3) | (b >> 2));
+			colors[i][3] = 255;
+		}
+		bool four_colors = always_four_colors || c[0] > c[1];
+		for (u32 ch = 0; ch < 3; ++ch)
+		{
+			if (four_colors)
+			{
+				colors[2][ch] = (2 * colors[0][ch] + colors[1][ch] + 1) / 3;
+				colors[3][ch] = (colors[0][ch] + 2 * colors[1][ch] + 1) / 3;
+			}
+			else
+			{
+				colors[2][ch] = (colors[0][ch] + colors[1][ch]) / 2;
+				colors[3][ch] = 0;
+			}
+		}
+		colors[2][3] = 255;
+		colors[3][3] = four_colors ? 255 : 0;
+		u32 indices = (u32)src[4] | ((u32)src[5] << 8) | ((u32)src[6] << 16) | ((u32)src[7] << 24);
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 index = (indices >> (i * 2)) & 3;
+			for (u32 ch = 0; ch < 4; ++ch) dst[i][ch] = (u8)colors[index][ch];
+		}
+	}
+
+	static void decode_bc4_block(const u8* src, u8(*dst)[4], u32 channel)
+	{
+		i32 values[8];
+		values[0] = src[0];
+		values[1] = src[1];
+		if (values[0] > values[1])
+		{
+			for (i32 i = 1; i < 7; ++i) values[i + 1] = ((7 - i) * values[0] + i * values[1] + 3) / 7;
+		}
+		else
+		{
+			for (i32 i = 1; i < 5; ++i) values[i + 1] = ((5 - i) * values[0] + i * values[1] + 2) / 5;
+			values[6] = 0;
+			values[7] = 255;
+		}
+		u64 indices = 0;
+		for (u32 i = 0; i < 6; ++i) indices |= (u64)src[2 + i] << (i * 8);
+		for (u32 i = 0; i < 16; ++i) dst[i][channel] = (u8)values[(indices >> (i * 3)) & 7];
+	}
+
+	constexpr u32 BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static void decode_bc7_mode6_block(const u8* src, u8(*dst)[4])
+	{
+		BlockBitReader reader = { src };
+		// Mode 6 is encoded as 6 zero bits followed by one 1 bit.
+		lutest(reader.read(7) == 0x40);
+		u32 e[2][4];
+		for (u32 c = 0; c < 4; ++c)
+		{
+			e[0][c] = reader.read(7);
+			e[1][c] = reader.read(7);
+		}
+		u32 p[2] = { reader.read(1), reader.read(1) };
+		for (u32 i = 0; i < 2; ++i)
+		{
+			for (u32 c = 0; c < 4; ++c) e[i][c] = (e[i][c] << 1) | p[i];
+		}
+		for (u32 i = 0; i < 16; ++i)
+		{
+			u32 w = BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+			for (u32 c = 0; c < 4; ++c) dst[i][c] = (u8)(((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+		}
+	}
+
+	static f32 f16_to_f32(u16 h)
+	{
+		u32 sign = (u32)(h & 0x8000) << 16;
+		u32 exponent = (h >> 10) & 0x1F;
+		u32 mantissa = h & 0x3FF;
+		f32 value;
+		if (exponent == 0) value = ldexpf((f32)mantissa, -24);
+		else if (exponent == 31) value = F32_MAX;
+		else value = ldexpf((f32)(mantissa | 0x400), (i32)exponent - 25);
+		return sign ? -value : value;
+	}
+
+	static void decode_bc6h_mode11_block(const u8* src, f32(*dst)[3], bool is_signed)
+	{
+		BlockBitReader reader = { src };
+		lutest(reader.read(5) == 0x03);
+		i32 e[2][3];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			for (u32 c = 0; c < 3; ++c)
+			{
+				i32 v = (i32)reader.read(10);
+				if (is_signed && (v & 0x200)) v -= 0x400;
+				// Unquantizes the endpoint.
+				if (is_signed)
+				{
+					i32 x = v < 0 ? -v : v;
+					i32 r = x == 0 ? 0 : (x >= 511 ? 0x7FFF : ((x << 15) + 0x4000) >> 9);
+					e[i][c] = v < 0 ? -r : r;
+				}
+				else
+				{
+					e[i][c] = v == 0 ? 0 : (v == 1023 ? 0xFFFF : ((v << 16) + 0x8000) >> 10);
+				}
+			}
+		}
+		for (u32 i = 0; i < 16; ++i)
+		{
+			i32 w = (i32)BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+			for (u32 c = 0; c < 3; ++c)
+			{
+				i32 v = ((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6;
+				u16 h;
+				if (is_signed) h = v < 0 ? (u16)(0x8000 | (((-v) * 31) >> 5)) : (u16)((v * 31) >> 5);
+				else h = (u16)((v * 31) >> 6);
+				dst[i][c] = f16_to_f32(h);
+			}
+		}
+	}
+
+	//! Decodes one LDR BC image to RGBA8 pixels.
+	static Vector<u8> decode_bc_image(const u8* blocks, DDSFormat format, u32 width, u32 height)
+	{
+		Vector<u8> ret((usize)width * height * 4);
+		u32 num_blocks_x = (width + 3) / 4;
+		u32 num_blocks_y = (height + 3) / 4;
+		usize block_size = (format == DDSFormat::bc1_unorm || format == DDSFormat::bc4_unorm) ? 8 : 16;
+		for (u32 by = 0; by < num_blocks_y; ++by)
+		{
+			for (u32 bx = 0; bx < num_blocks_x; ++bx)
+			{
+				const u8* src = blocks + (by * num_blocks_x + bx) * block_size;
+				u8 pixels[16][4] = {};
+				for (u32 i = 0; i < 16; ++i) pixels[i][3] = 255;
+				switch (format)
+				{
+				case DDSFormat::bc1_unorm: decode_bc1_block(src, pixels, false); break;
+				case DDSFormat::bc3_unorm: decode_bc1_block(src + 8, pixels, true); decode_bc4_block(src, pixels, 3); break;
+				case DDSFormat::bc4_unorm: decode_bc4_block(src, pixels, 0); break;
+				case DDSFormat::bc5_unorm: decode_bc4_block(src, pixels, 0); decode_bc4_block(src + 8, pixels, 1); break;
+				case DDSFormat::bc7_unorm: decode_bc7_mode6_block(src, pixels); break;
+				default: lupanic();
+				}
+				for (u32 y = 0; y < 4; ++y)
+				{
+					for (u32 x = 0; x < 4; ++x)
+					{
+						u32 px = bx * 4 + x;
+						u32 py = by * 4 + y;
+						if (px >= width || py >= height) continue;
+						memcpy(ret.data() + ((usize)py * width + px) * 4, pixels[y * 4 + x], 4);
+					}
+				}
+			}
+		}
+		return ret;
+	}
+
+	//! Computes the PSNR of the specified channels in dB.
+	static f64 calc_psnr(const u8* lhs, const u8* rhs, usize num_pixels, u32 channel_mask)
+	{
+		f64 err = 0.0;
+		usize n = 0;
+		for (usize i = 0; i < num_pixels; ++i)
+		{
+			for (u32 c = 0; c < 4; ++c)
+			{
+				if (!(channel_mask & (1 << c))) continue;
+				f64 d = (f64)lhs[i * 4 + c] - (f64)rhs[i * 4 + c];
+				err += d * d;
+				++n;
+			}
+		}
+		err /= (f64)n;
+		if (err == 0.0) return 100.0;
+		return 10.0 * log10(255.0 * 255.0 / err);
+	}
+
+	//! Generates one test image with smooth gradients, noise and sharp edges inside blocks.
+	static Vector<u8> generate_test_image(u32 width, u32 height)
+	{
+		Vector<u8> ret((usize)width * height * 4);
+		u32 seed = 12345;
+		for (u32 y = 0; y < height; ++y)
+		{
+			for (u32 x = 0; x < width; ++x)
+			{
+				seed = seed * 1664525 + 1013904223;
+				i32 noise = (i32)((seed >> 24) & 7) - 4;
+				u8* p = ret.data() + ((usize)y * width + x) * 4;
+				f32 fx = (f32)x / (f32)width;
+				f32 fy = (f32)y / (f32)height;
+				i32 r = (i32)(fx * 255.0f) + noise;
+				i32 g = (i32)(fy * 200.0f + 30.0f) + noise;
+				i32 b = (i32)(128.0f + 100.0f * sinf((f32)(x + y) * 0.2f)) + noise;
+				i32 a = (i32)(255.0f - fx * fy * 255.0f);
+				// One sharp edge that crosses blocks.
+				if (x > y + 10)
+				{
+					r = 255 - r;
+					b = b / 3;
+				}
+				p[0] = (u8)clamp(r, 0, 255);
+				p[1] = (u8)clamp(g, 0, 255);
+				p[2] = (u8)clamp(b, 0, 255);
+				p[3] = (u8)clamp(a, 0, 255);
+			}
+		}
+		return ret;
+	}
+
+	static Vector<u8> encode_and_decode(const Vector<u8>& image, u32 width, u32 height, DDSFormat format, BCQuality quality)
+	{
+		u32 num_blocks_x = (width + 3) / 4;
+		u32 num_blocks_y = (height + 3) / 4;
+		usize block_size = (format == DDSFormat::bc1_unorm || format == DDSFormat::bc4_unorm) ? 8 : 16;
+		Vector<u8> blocks(num_blocks_x * num_blocks_y * block_size);
+		lutest(succeeded(encode_bc_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), format, quality, blocks.data(), num_blocks_x * block_size)));
+		return decode_bc_image(blocks.data(), format, width, height);
+	}
+
+	static f64 encode_and_measure(const Vector<u8>& image, u32 width, u32 height, DDSFormat format, BCQuality quality, u32 channel_mask)
+	{
+		Vector<u8> decoded = encode_and_decode(image, width, height, format, quality);
+		return calc_psnr(image.data(), decoded.data(), (usize)width * height, channel_mask);
+	}
+
+	static void ldr_psnr_test()
+	{
+		// Sizes that are not multiples of 4 test border handling.
+		u32 width = 70, height = 45;
+		Vector<u8> image = generate_test_image(width, height);
+		Vector<u8> opaque_image = image;
+		for (usize i = 0; i < (usize)width * height; ++i) opaque_image[i * 4 + 3] = 255;
+		struct TestCase
+		{
+			DDSFormat format;
+			u32 channel_mask;
+			f64 min_psnr;
+		};
+		// Minimal PSNRs of `fast` quality.
+		const TestCase cases[] = {
+			{ DDSFormat::bc1_unorm, 0x07, 32.0 },
+			{ DDSFormat::bc3_unorm, 0x0F, 32.0 },
+			{ DDSFormat::bc4_unorm, 0x01, 42.0 },
+			{ DDSFormat::bc5_unorm, 0x03, 42.0 },
+			{ DDSFormat::bc7_unorm, 0x0F, 35.0 },
+		};
+		for (auto& c : cases)
+		{
+			// BC1 encodes alpha as punch-through, which is tested separately.
+			const Vector<u8>& src = c.format == DDSFormat::bc1_unorm ? opaque_image : image;
+			f64 psnr_fast = encode_and_measure(src, width, height, c.format, BCQuality::fast, c.channel_mask);
+			f64 psnr_normal = encode_and_measure(src, width, height, c.format, BCQuality::normal, c.channel_mask);
+			f64 psnr_high = encode_and_measure(src, width, height, c.format, BCQuality::high, c.channel_mask);
+			lutest(psnr_fast >= c.min_psnr);
+			// Higher quality never selects worse blocks.
+			lutest(psnr_normal >= psnr_fast - 0.01);
+			lutest(psnr_high >= psnr_normal - 0.01);
+		}
+		// BC1 blocks with pixels whose alpha is less than 0.5 use the 3-color mode, and such pixels are decoded as 
+		// transparent black.
+		{
+			Vector<u8> decoded = encode_and_decode(image, width, height, DDSFormat::bc1_unorm, BCQuality::normal);
+			f64 err = 0.0;
+			usize n = 0;
+			for (usize i = 0; i < (usize)width * height; ++i)
+			{
+				bool transparent = image[i * 4 + 3] < 128;
+				lutest(decoded[i * 4 + 3] == (transparent ? 0 : 255));
+				if (transparent) continue;
+				for (u32 c = 0; c < 3; ++c)
+				{
+					f64 d = (f64)decoded[i * 4 + c] - (f64)image[i * 4 + c];
+					err += d * d;
+					++n;
+				}
+			}
+			lutest(10.0 * log10(255.0 * 255.0 * (f64)n / err) >= 30.0);
+		}
+		// Constant blocks are encoded exactly by BC4 and BC5, and nearly exactly by BC7.
+		Vector<u8> flat((usize)16 * 16 * 4);
+		for (usize i = 0; i < 16 * 16; ++i)
+		{
+			flat[i * 4] = 77;
+			flat[i * 4 + 1] = 201;
+			flat[i * 4 + 2] = 3;
+			flat[i * 4 + 3] = 128;
+		}
+		lutest(encode_and_measure(flat, 16, 16, DDSFormat::bc4_unorm, BCQuality::fast, 0x01) == 100.0);
+		lutest(encode_and_measure(flat, 16, 16, DDSFormat::bc5_unorm, BCQuality::fast, 0x03) == 100.0);
+		lutest(encode_and_measure(flat, 16, 16, DDSFormat::bc7_unorm, BCQuality::normal, 0x0F) >= 48.0);
+	}
+
+	static void hdr_psnr_test()
+	{
+		u32 width = 32, height = 32;
+		for (bool is_signed : { false, true })
+		{
+			Vector<f32> image((usize)width * height * 3);
+			f32 peak = 0.0f;
+			for (u32 y = 0; y < height; ++y)
+			{
+				for (u32 x = 0; x < width; ++x)
+				{
+					f32* p = image.data() + ((usize)y * width + x) * 3;
+					p[0] = (f32)x * 0.5f;
+					p[1] = 4.0f + 3.0f * sinf((f32)y * 0.3f);
+					p[2] = (f32)(x + y) * 0.05f;
+					if (is_signed && x > 20) p[2] = -p[2];
+					for (u32 c = 0; c < 3; ++c) peak = max(peak, fabsf(p[c]));
+				}
+			}
+			DDSFormat format = is_signed ? DDSFormat::bc6h_sf16 : DDSFormat::bc6h_uf16;
+			u32 num_blocks_x = width / 4;
+			Vector<u8> blocks((usize)num_blocks_x * (height / 4) * 16);
+			lutest(succeeded(encode_bc_image({ ImageFormat::rgb32_float, width, height }, image.data(), format, BCQuality::normal, blocks.data(), num_blocks_x * 16)));
+			f64 err = 0.0;
+			for (u32 by = 0; by < height / 4; ++by)
+			{
+				for (u32 bx = 0; bx < num_blocks_x; ++bx)
+				{
+					f32 decoded[16][3];
+					decode_bc6h_mode11_block(blocks.data() + (by * num_blocks_x + bx) * 16, decoded, is_signed);
+					for (u32 i = 0; i < 16; ++i)
+					{
+						const f32* src = image.data() + ((usize)(by * 4 + i / 4) * width + bx * 4 + i % 4) * 3;
+						for (u32 c = 0; c < 3; ++c)
+						{
+							f64 d = (f64)decoded[i][c] - (f64)src[c];
+							err += d * d;
+						}
+					}
+				}
+			}
+			err /= (f64)(width * height * 3);
+			f64 psnr = 10.0 * log10((f64)peak * (f64)peak / err);
+			lutest(psnr >= 30.0);
+		}
+	}
+
+	static void dds_image_test()
+	{
+		u32 width = 70, height = 45;
+		Vector<u8> image = generate_test_image(width, height);
+		// Generates the full mipmap chain by default.
+		auto dds = encode_bc_dds_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), DDSFormat::bc7_unorm);
+		lutest(succeeded(dds));
+		lutest(dds.get().desc.mip_levels == calc_mip_levels(width, height));
+		lutest(dds.get().subresources.size() == dds.get().desc.mip_levels);
+		const DDSSubresource& last = dds.get().subresources.back();
+		lutest(last.width == 1 && last.height == 1);
+		// The top level matches `encode_bc_image`.
+		f64 psnr = calc_psnr(image.data(), decode_bc_image(dds.get().data.data() + dds.get().subresources[0].data_offset,
+			DDSFormat::bc7_unorm, width, height).data(), (usize)width * height, 0x0F);
+		lutest(psnr == encode_and_measure(image, width, height, DDSFormat::bc7_unorm, BCQuality::normal, 0x0F));
+		dds = encode_bc_dds_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), DDSFormat::bc1_unorm, 2);
+		lutest(succeeded(dds));
+		lutest(dds.get().desc.mip_levels == 2);
+		lutest(failed(encode_bc_dds_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), DDSFormat::bc2_unorm)));
+	}
+
+	void bc_encoder_test()
+	{
+		lutest(is_bc_encoding_supported(DDSFormat::bc7_unorm_srgb));
+		lutest(!is_bc_encoding_supported(DDSFormat::bc2_unorm));
+		ldr_psnr_test();
+		hdr_psnr_test();
+		dds_image_test();
+	}
+}
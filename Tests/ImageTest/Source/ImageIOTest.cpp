@@ -0,0 +1,1070 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file ImageIOTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Image/Image.hpp>
+#include <Luna/Image/DDSImage.hpp>
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/Math/Math.hpp>
+
+namespace Luna
+{
+	using namespace Image;
+
+	// Decoders read files from streams, so test files are written to one temporary file.
+	static const c8 TEST_FILE_PATH[] = "ImageIOTest.tmp";
+
+	static Ref<IFile> open_test_file(const Vector<u8>& data)
+	{
+		auto file = open_file(TEST_FILE_PATH, FileOpenFlag::read | FileOpenFlag::write, FileCreationMode::create_always);
+		lutest(succeeded(file));
+		if (!data.empty()) lutest(succeeded(file.get()->write(data.data(), data.size())));
+		lutest(succeeded(file.get()->seek(0, SeekMode::begin)));
+		return file.get();
+	}
+
+	struct DecodedImage
+	{
+		ImageDesc desc;
+		Vector<u8> data;
+		//! The first row of every band in the order the bands are reported.
+		Vector<u32> band_first_rows;
+	};
+
+	static R<DecodedImage> decode_image_rows(const Vector<u8>& file_data, ImageFormat desired_format, u32 band_rows)
+	{
+		Ref<IFile> file = open_test_file(file_data);
+		DecodedImage ret;
+		auto r = read_image_file_rows(file, desired_format, band_rows,
+			[&ret](const ImageDesc& desc, u32 first_row, u32 num_rows, const void* data) -> RV
+			{
+				usize row_pitch = (usize)desc.width * pixel_size(desc.format);
+				if (ret.data.empty()) ret.data.resize(row_pitch * desc.height);
+				memcpy(ret.data.data() + first_row * row_pitch, data, num_rows * row_pitch);
+				ret.band_first_rows.push_back(first_row);
+				return ok;
+			});
+		if (failed(r)) return r.errcode();
+		ret.desc = r.get();
+		return ret;
+	}
+
+	//! Float pixels may differ in the last bits, since `read_image_file` converts pixels using double precision.
+	static bool equal_pixels(const void* lhs, const void* rhs, usize size, ImageFormat format)
+	{
+		if (format != ImageFormat::r32_float && format != ImageFormat::rg32_float &&
+			format != ImageFormat::rgb32_float && format != ImageFormat::rgba32_float) return !memcmp(lhs, rhs, size);
+		const f32* a = (const f32*)lhs;
+		const f32* b = (const f32*)rhs;
+		for (usize i = 0; i < size / sizeof(f32); ++i)
+		{
+			if (abs(a[i] - b[i]) > max(abs(a[i]), abs(b[i])) * 1e-5f) return false;
+		}
+		return true;
+	}
+
+	//! Checks that the rows decoder and `read_image_file` decode the file to the expected pixels.
+	static void check_decoded_image(const Vector<u8>& file_data, ImageFormat format, u32 width, u32 height, const Vector<u8>& expected)
+	{
+		auto rows = decode_image_rows(file_data, ImageFormat::unkonwn, 4);
+		lutest(succeeded(rows));
+		lutest(rows.get().desc.format == format);
+		lutest(rows.get().desc.width == width && rows.get().desc.height == height);
+		lutest(rows.get().data.size() == expected.size());
+		lutest(!memcmp(rows.get().data.data(), expected.data(), expected.size()));
+		ImageDesc desc;
+		auto image = read_image_file(file_data.data(), file_data.size(), format, desc);
+		lutest(succeeded(image));
+		lutest(desc.width == width && desc.height == height);
+		lutest(image.get().size() == expected.size());
+		lutest(equal_pixels(image.get().data(), expected.data(), expected.size(), format));
+	}
+
+	//! Writes bits starting from the least significant bit of every byte, as DEFLATE does.
+	struct BitWriter
+	{
+		Vector<u8> m_data;
+		u32 m_bits = 0;
+		u32 m_num_bits = 0;
+
+		void write(u32 value, u32 num_bits)
+		{
+			for (u32 i = 0; i < num_bits; ++i)
+			{
+				m_bits |= ((value >> i) & 1) << m_num_bits;
+				if (++m_num_bits == 8)
+				{
+					m_data.push_back((u8)m_bits);
+					m_bits = 0;
+					m_num_bits = 0;
+				}
+			}
+		}
+		//! Huffman codes are stored starting from the most significant bit.
+		void write_code(u32 code, u32 len)
+		{
+			for (u32 i = len; i > 0; --i) write((code >> (i - 1)) & 1, 1);
+		}
+		void align()
+		{
+			if (m_num_bits) write(0, 8 - m_num_bits);
+		}
+	};
+
+	constexpr u16 DEFLATE_LEN_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr u8 DEFLATE_LEN_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr u16 DEFLATE_DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr u8 DEFLATE_DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	constexpr u8 DEFLATE_CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	//! One literal if `dist` is 0, or one match otherwise.
+	struct DeflateToken
+	{
+		u32 value;
+		u32 dist;
+	};
+
+	inline u32 find_deflate_symbol(const u16* bases, u32 num_bases, u32 value)
+	{
+		u32 sym = 0;
+		while (sym + 1 < num_bases && bases[sym + 1] <= value) ++sym;
+		return sym;
+	}
+
+	//! Finds matches of [begin, end) greedily. Matches may refer to data before `begin`.
+	static void find_deflate_tokens(const Vector<u8>& data, usize begin, usize end, Vector<DeflateToken>& tokens)
+	{
+		constexpr usize window_size = 2048;
+		usize i = begin;
+		while (i < end)
+		{
+			usize max_len = min<usize>(258, end - i);
+			u32 best_len = 0;
+			u32 best_dist = 0;
+			if (max_len >= 3)
+			{
+				usize window_begin = i > window_size ? i - window_size : 0;
+				for (usize p = i; p > window_begin; --p)
+				{
+					usize src = p - 1;
+					u32 len = 0;
+					while (len < max_len && data[src + len] == data[i + len]) ++len;
+					if (len > best_len)
+					{
+						best_len = len;
+						best_dist = (u32)(i - src);
+						if (len == max_len) break;
+					}
+				}
+			}
+			if (best_len >= 3)
+			{
+				tokens.push_back({ best_len, best_dist });
+				i += best_len;
+			}
+			else
+			{
+				tokens.push_back({ data[i], 0 });
+				++i;
+			}
+		}
+	}
+
+	//! Computes Huffman code lengths not longer than `max_len`. Symbols with zero frequency get no code.
+	static void build_code_lengths(const u32* freqs, u32 num_symbols, u32 max_len, u8* lengths)
+	{
+		Vector<u32> weights(num_symbols);
+		for (u32 i = 0; i < num_symbols; ++i) weights[i] = freqs[i];
+		while (true)
+		{
+			// Nodes [0, num_symbols) are leaves.
+			Vector<u64> node_weights;
+			Vector<i32> parents;
+			Vector<u8> active;
+			for (u32 i = 0; i < num_symbols; ++i)
+			{
+				node_weights.push_back(weights[i]);
+				parents.push_back(-1);
+				active.push_back(weights[i] != 0);
+			}
+			while (true)
+			{
+				i32 a = -1, b = -1;
+				for (usize i = 0; i < node_weights.size(); ++i)
+				{
+					if (!active[i]) continue;
+					if (a < 0 || node_weights[i] < node_weights[a]) { b = a; a = (i32)i; }
+					else if (b < 0 || node_weights[i] < node_weights[b]) b = (i32)i;
+				}
+				if (b < 0) break;
+				active[a] = false;
+				active[b] = false;
+				parents[a] = parents[b] = (i32)node_weights.size();
+				node_weights.push_back(node_weights[a] + node_weights[b]);
+				parents.push_back(-1);
+				active.push_back(true);
+			}
+			u32 longest = 0;
+			for (u32 i = 0; i < num_symbols; ++i)
+			{
+				u32 len = 0;
+				if (weights[i])
+				{
+					for (i32 n = parents[i]; n >= 0; n = parents[n]) ++len;
+				}
+				lengths[i] = (u8)len;
+				longest = max(longest, len);
+			}
+			if (longest <= max_len) return;
+			// Flattens the distribution and tries again.
+			for (u32 i = 0; i < num_symbols; ++i) if (weights[i]) weights[i] = weights[i] / 2 + 1;
+		}
+	}
+
+	static void build_canonical_codes(const u8* lengths, u32 num_symbols, u32* codes)
+	{
+		u32 count[16] = { 0 };
+		for (u32 i = 0; i < num_symbols; ++i) if (lengths[i]) ++count[lengths[i]];
+		u32 next_code[16] = { 0 };
+		u32 code = 0;
+		for (u32 len = 1; len < 16; ++len)
+		{
+			code = (code + count[len - 1]) << 1;
+			next_code[len] = code;
+		}
+		for (u32 i = 0; i < num_symbols; ++i) if (lengths[i]) codes[i] = next_code[lengths[i]]++;
+	}
+
+	struct HuffmanCodes
+	{
+		u8 lit_lengths[288];
+		u32 lit_codes[288];
+		u8 dist_lengths[30];
+		u32 dist_codes[30];
+	};
+
+	static void write_deflate_tokens(BitWriter& w, const HuffmanCodes& codes, const DeflateToken* tokens, usize num_tokens)
+	{
+		for (usize i = 0; i < num_tokens; ++i)
+		{
+			const DeflateToken& t = tokens[i];
+			if (!t.dist)
+			{
+				w.write_code(codes.lit_codes[t.value], codes.lit_lengths[t.value]);
+				continue;
+			}
+			u32 len_sym = find_deflate_symbol(DEFLATE_LEN_BASE, 29, t.value);
+			w.write_code(codes.lit_codes[257 + len_sym], codes.lit_lengths[257 + len_sym]);
+			w.write(t.value - DEFLATE_LEN_BASE[len_sym], DEFLATE_LEN_EXTRA[len_sym]);
+			u32 dist_sym = find_deflate_symbol(DEFLATE_DIST_BASE, 30, t.dist);
+			w.write_code(codes.dist_codes[dist_sym], codes.dist_lengths[dist_sym]);
+			w.write(t.dist - DEFLATE_DIST_BASE[dist_sym], DEFLATE_DIST_EXTRA[dist_sym]);
+		}
+		w.write_code(codes.lit_codes[256], codes.lit_lengths[256]);
+	}
+
+	static void write_stored_block(BitWriter& w, const u8* data, usize size, bool final_block)
+	{
+		w.write(final_block ? 1 : 0, 1);
+		w.write(0, 2);
+		w.align();
+		w.write((u32)size, 16);
+		w.write((u32)size ^ 0xFFFF, 16);
+		for (usize i = 0; i < size; ++i) w.write(data[i], 8);
+	}
+
+	static void write_fixed_block(BitWriter& w, const Vector<DeflateToken>& tokens, bool final_block)
+	{
+		HuffmanCodes codes;
+		memset(codes.lit_lengths, 8, 144);
+		memset(codes.lit_lengths + 144, 9, 112);
+		memset(codes.lit_lengths + 256, 7, 24);
+		memset(codes.lit_lengths + 280, 8, 8);
+		memset(codes.dist_lengths, 5, 30);
+		build_canonical_codes(codes.lit_lengths, 288, codes.lit_codes);
+		build_canonical_codes(codes.dist_lengths, 30, codes.dist_codes);
+		w.write(final_block ? 1 : 0, 1);
+		w.write(1, 2);
+		write_deflate_tokens(w, codes, tokens.data(), tokens.size());
+	}
+
+	static void write_dynamic_block(BitWriter& w, const Vector<DeflateToken>& tokens, bool final_block)
+	{
+		u32 lit_freqs[286] = { 0 };
+		u32 dist_freqs[30] = { 0 };
+		for (const DeflateToken& t : tokens)
+		{
+			if (!t.dist) ++lit_freqs[t.value];
+			else
+			{
+				++lit_freqs[257 + find_deflate_symbol(DEFLATE_LEN_BASE, 29, t.value)];
+				++dist_freqs[find_deflate_symbol(DEFLATE_DIST_BASE, 30, t.dist)];
+			}
+		}
+		++lit_freqs[256];
+		// Every code has at least two symbols so that it is complete.
+		if (!lit_freqs[0]) lit_freqs[0] = 1;
+		if (!dist_freqs[0]) dist_freqs[0] = 1;
+		if (!dist_freqs[1]) dist_freqs[1] = 1;
+		HuffmanCodes codes;
+		memzero(codes.lit_lengths, sizeof(codes.lit_lengths));
+		build_code_lengths(lit_freqs, 286, 15, codes.lit_lengths);
+		build_code_lengths(dist_freqs, 30, 15, codes.dist_lengths);
+		build_canonical_codes(codes.lit_lengths, 286, codes.lit_codes);
+		build_canonical_codes(codes.dist_lengths, 30, codes.dist_codes);
+		u32 hlit = 286;
+		while (!codes.lit_lengths[hlit - 1]) --hlit;
+		u32 hdist = 30;
+		while (!codes.dist_lengths[hdist - 1]) --hdist;
+		// Run-length encodes code lengths. Runs may cross the boundary between literal and distance lengths.
+		Vector<u8> all_lengths;
+		for (u32 i = 0; i < hlit; ++i) all_lengths.push_back(codes.lit_lengths[i]);
+		for (u32 i = 0; i < hdist; ++i) all_lengths.push_back(codes.dist_lengths[i]);
+		Vector<DeflateToken> cl_tokens;
+		usize n = all_lengths.size();
+		for (usize i = 0; i < n;)
+		{
+			u8 v = all_lengths[i];
+			usize run = 1;
+			while (i + run < n && all_lengths[i + run] == v) ++run;
+			if (v == 0 && run >= 3)
+			{
+				u32 r = (u32)min<usize>(run, 138);
+				cl_tokens.push_back(r >= 11 ? DeflateToken{ 18, r - 11 } : DeflateToken{ 17, r - 3 });
+				i += r;
+				continue;
+			}
+			cl_tokens.push_back({ v, 0 });
+			++i;
+			--run;
+			while (run >= 3)
+			{
+				u32 r = (u32)min<usize>(run, 6);
+				cl_tokens.push_back({ 16, r - 3 });
+				i += r;
+				run -= r;
+			}
+		}
+		u32 cl_freqs[19] = { 0 };
+		for (const DeflateToken& t : cl_tokens) ++cl_freqs[t.value];
+		if (!cl_freqs[0]) cl_freqs[0] = 1;
+		if (!cl_freqs[18]) cl_freqs[18] = 1;
+		u8 cl_lengths[19];
+		u32 cl_codes[19];
+		build_code_lengths(cl_freqs, 19, 7, cl_lengths);
+		build_canonical_codes(cl_lengths, 19, cl_codes);
+		u32 hclen = 19;
+		while (hclen > 4 && !cl_lengths[DEFLATE_CODE_LENGTH_ORDER[hclen - 1]]) --hclen;
+		w.write(final_block ? 1 : 0, 1);
+		w.write(2, 2);
+		w.write(hlit - 257, 5);
+		w.write(hdist - 1, 5);
+		w.write(hclen - 4, 4);
+		for (u32 i = 0; i < hclen; ++i) w.write(cl_lengths[DEFLATE_CODE_LENGTH_ORDER[i]], 3);
+		for (const DeflateToken& t : cl_tokens)
+		{
+			w.write_code(cl_codes[t.value], cl_lengths[t.value]);
+			if (t.value == 16) w.write(t.dist, 2);
+			else if (t.value == 17) w.write(t.dist, 3);
+			else if (t.value == 18) w.write(t.dist, 7);
+		}
+		write_deflate_tokens(w, codes, tokens.data(), tokens.size());
+	}
+
+	static u32 adler32(const Vector<u8>& data)
+	{
+		u32 a = 1, b = 0;
+		for (u8 v : data)
+		{
+			a = (a + v) % 65521;
+			b = (b + a) % 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	enum class DeflateMode : u8
+	{
+		stored,
+		fixed,
+		dynamic,
+		//! Stored, fixed and dynamic blocks in one stream, with one empty stored block.
+		mixed,
+	};
+	constexpr DeflateMode DEFLATE_MODES[] = { DeflateMode::stored, DeflateMode::fixed, DeflateMode::dynamic, DeflateMode::mixed };
+
+	static Vector<u8> zlib_compress(const Vector<u8>& data, DeflateMode mode)
+	{
+		BitWriter w;
+		w.write(0x78, 8);
+		w.write(0x01, 8);
+		usize size = data.size();
+		switch (mode)
+		{
+		case DeflateMode::stored:
+		{
+			// Uses small blocks so that the data is split into many blocks.
+			constexpr usize block_size = 997;
+			usize offset = 0;
+			do
+			{
+				usize n = min(block_size, size - offset);
+				write_stored_block(w, data.data() + offset, n, offset + n == size);
+				offset += n;
+			} while (offset < size);
+			break;
+		}
+		case DeflateMode::fixed:
+		{
+			Vector<DeflateToken> tokens;
+			find_deflate_tokens(data, 0, size, tokens);
+			write_fixed_block(w, tokens, true);
+			break;
+		}
+		case DeflateMode::dynamic:
+		{
+			// Two blocks, so that tables are rebuilt between blocks.
+			Vector<DeflateToken> tokens;
+			find_deflate_tokens(data, 0, size / 2, tokens);
+			write_dynamic_block(w, tokens, false);
+			tokens.clear();
+			find_deflate_tokens(data, size / 2, size, tokens);
+			write_dynamic_block(w, tokens, true);
+			break;
+		}
+		case DeflateMode::mixed:
+		{
+			usize a = size / 3;
+			usize b = size * 2 / 3;
+			write_stored_block(w, data.data(), a, false);
+			Vector<DeflateToken> tokens;
+			find_deflate_tokens(data, a, b, tokens);
+			write_fixed_block(w, tokens, false);
+			write_stored_block(w, nullptr, 0, false);
+			tokens.clear();
+			find_deflate_tokens(data, b, size, tokens);
+			write_dynamic_block(w, tokens, true);
+			break;
+		}
+		}
+		w.align();
+		u32 checksum = adler32(data);
+		for (u32 i = 0; i < 4; ++i) w.write((checksum >> (24 - i * 8)) & 0xFF, 8);
+		return move(w.m_data);
+	}
+
+	static u32 crc32(const u8* data, usize size, u32 crc = 0)
+	{
+		crc = ~crc;
+		for (usize i = 0; i < size; ++i)
+		{
+			crc ^= data[i];
+			for (u32 k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	inline void push_u32_be(Vector<u8>& dst, u32 v)
+	{
+		for (u32 i = 0; i < 4; ++i) dst.push_back((u8)(v >> (24 - i * 8)));
+	}
+
+	static void push_png_chunk(Vector<u8>& dst, const c8* type, const u8* data, usize size)
+	{
+		push_u32_be(dst, (u32)size);
+		usize begin = dst.size();
+		for (u32 i = 0; i < 4; ++i) dst.push_back((u8)type[i]);
+		for (usize i = 0; i < size; ++i) dst.push_back(data[i]);
+		push_u32_be(dst, crc32(dst.data() + begin, dst.size() - begin));
+	}
+
+	struct PNGTestImage
+	{
+		u32 width;
+		u32 height;
+		u8 color_type;
+		u8 depth;
+		bool interlaced;
+		u32 num_channels;
+		//! Palette indices for color type 3, channel values otherwise.
+		Vector<u16> samples;
+		//! RGB triples.
+		Vector<u8> palette;
+		Vector<u8> palette_alpha;
+		bool has_trns;
+		u16 trns[3];
+	};
+
+	static PNGTestImage make_png_test_image(u8 color_type, u8 depth, bool trns, bool interlaced)
+	{
+		PNGTestImage image;
+		image.width = 37;
+		image.height = 19;
+		image.color_type = color_type;
+		image.depth = depth;
+		image.interlaced = interlaced;
+		image.has_trns = trns;
+		image.trns[0] = image.trns[1] = image.trns[2] = 0;
+		constexpr u32 channels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+		image.num_channels = channels[color_type];
+		u32 max_value = color_type == 3 ? min(1u << depth, 200u) - 1 : (1u << depth) - 1;
+		for (u32 y = 0; y < image.height; ++y)
+		{
+			for (u32 x = 0; x < image.width; ++x)
+			{
+				for (u32 c = 0; c < image.num_channels; ++c)
+				{
+					// Repeated patterns produce matches, other pixels produce literals.
+					u32 v = x < image.width / 2 ? (x / 3 + c * 11 + y % 3) : (x * 2621 + y * 7919 + c * 30011 + x * y);
+					image.samples.push_back((u16)(v % (max_value + 1)));
+				}
+			}
+		}
+		if (color_type == 3)
+		{
+			for (u32 i = 0; i <= max_value; ++i)
+			{
+				image.palette.push_back((u8)(i * 47));
+				image.palette.push_back((u8)(255 - i * 3));
+				image.palette.push_back((u8)(i * i));
+				// tRNS may be shorter than the palette.
+				if (trns && i < max_value / 2 + 1) image.palette_alpha.push_back((u8)(i * 61));
+			}
+		}
+		else if (trns)
+		{
+			// Uses the value of one existing pixel so that some pixels become transparent.
+			for (u32 c = 0; c < image.num_channels; ++c) image.trns[c] = image.samples[c];
+		}
+		return image;
+	}
+
+	static void pack_png_row(const PNGTestImage& image, const u16* samples, u32 width, u8* dst)
+	{
+		usize num_samples = (usize)width * image.num_channels;
+		if (image.depth == 16)
+		{
+			for (usize i = 0; i < num_samples; ++i)
+			{
+				dst[i * 2] = (u8)(samples[i] >> 8);
+				dst[i * 2 + 1] = (u8)samples[i];
+			}
+		}
+		else
+		{
+			usize row_bytes = (num_samples * image.depth + 7) / 8;
+			memzero(dst, row_bytes);
+			for (usize i = 0; i < num_samples; ++i)
+			{
+				usize bit = i * image.depth;
+				dst[bit / 8] |= (u8)(samples[i] << (8 - image.depth - bit % 8));
+			}
+		}
+	}
+
+	inline u8 png_paeth(i32 a, i32 b, i32 c)
+	{
+		i32 p = a + b - c;
+		i32 pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+		if (pa <= pb && pa <= pc) return (u8)a;
+		return pb <= pc ? (u8)b : (u8)c;
+	}
+
+	//! Appends the filtered scanlines of one pass. Every row uses a different filter type.
+	static void append_png_pass(const PNGTestImage& image, u32 x0, u32 y0, u32 dx, u32 dy, Vector<u8>& dst)
+	{
+		u32 width = image.width > x0 ? (image.width - x0 + dx - 1) / dx : 0;
+		u32 height = image.height > y0 ? (image.height - y0 + dy - 1) / dy : 0;
+		if (!width || !height) return;
+		usize row_bytes = ((usize)width * image.num_channels * image.depth + 7) / 8;
+		usize bpp = max<usize>(image.num_channels * image.depth / 8, 1);
+		Vector<u8> prev(row_bytes, 0);
+		Vector<u8> cur(row_bytes);
+		Vector<u16> samples;
+		for (u32 y = 0; y < height; ++y)
+		{
+			samples.clear();
+			for (u32 x = 0; x < width; ++x)
+			{
+				const u16* src = image.samples.data() + ((usize)(y0 + y * dy) * image.width + x0 + x * dx) * image.num_channels;
+				for (u32 c = 0; c < image.num_channels; ++c) samples.push_back(src[c]);
+			}
+			pack_png_row(image, samples.data(), width, cur.data());
+			u8 filter = (u8)(y % 5);
+			dst.push_back(filter);
+			for (usize i = 0; i < row_bytes; ++i)
+			{
+				i32 a = i >= bpp ? cur[i - bpp] : 0;
+				i32 b = prev[i];
+				i32 c = i >= bpp ? prev[i - bpp] : 0;
+				u8 pred = 0;
+				switch (filter)
+				{
+				case 1: pred = (u8)a; break;
+				case 2: pred = (u8)b; break;
+				case 3: pred = (u8)((a + b) >> 1); break;
+				case 4: pred = png_paeth(a, b, c); break;
+				default: break;
+				}
+				dst.push_back((u8)(cur[i] - pred));
+			}
+			prev.swap(cur);
+		}
+	}
+
+	static Vector<u8> encode_png_test_image(const PNGTestImage& image, DeflateMode mode, bool corrupt_checksum = false)
+	{
+		Vector<u8> raw;
+		if (image.interlaced)
+		{
+			constexpr u32 adam7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+			for (auto& pass : adam7) append_png_pass(image, pass[0], pass[1], pass[2], pass[3], raw);
+		}
+		else
+		{
+			append_png_pass(image, 0, 0, 1, 1, raw);
+		}
+		Vector<u8> zlib_data = zlib_compress(raw, mode);
+		if (corrupt_checksum) zlib_data.back() ^= 0x5A;
+		Vector<u8> file;
+		const u8 signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+		for (u8 b : signature) file.push_back(b);
+		Vector<u8> ihdr;
+		push_u32_be(ihdr, image.width);
+		push_u32_be(ihdr, image.height);
+		ihdr.push_back(image.depth);
+		ihdr.push_back(image.color_type);
+		ihdr.push_back(0);
+		ihdr.push_back(0);
+		ihdr.push_back(image.interlaced ? 1 : 0);
+		push_png_chunk(file, "IHDR", ihdr.data(), ihdr.size());
+		// Ancillary chunks should be skipped.
+		const c8 text[] = "Comment\0ImageIOTest";
+		push_png_chunk(file, "tEXt", (const u8*)text, sizeof(text) - 1);
+		if (image.color_type == 3)
+		{
+			push_png_chunk(file, "PLTE", image.palette.data(), image.palette.size());
+			if (image.has_trns) push_png_chunk(file, "tRNS", image.palette_alpha.data(), image.palette_alpha.size());
+		}
+		else if (image.has_trns)
+		{
+			Vector<u8> trns;
+			for (u32 c = 0; c < image.num_channels; ++c)
+			{
+				trns.push_back((u8)(image.trns[c] >> 8));
+				trns.push_back((u8)image.trns[c]);
+			}
+			push_png_chunk(file, "tRNS", trns.data(), trns.size());
+		}
+		// Splits the data into many IDAT chunks.
+		constexpr usize idat_size = 101;
+		for (usize offset = 0; offset < zlib_data.size(); offset += idat_size)
+		{
+			push_png_chunk(file, "IDAT", zlib_data.data() + offset, min(idat_size, zlib_data.size() - offset));
+		}
+		push_png_chunk(file, "IEND", nullptr, 0);
+		return file;
+	}
+
+	//! Computes pixels decoded from the test image in the format stored in the file.
+	static Vector<u8> get_png_expected_pixels(const PNGTestImage& image, ImageFormat& out_format)
+	{
+		u32 num_channels = image.color_type == 3 ? (image.has_trns ? 4 : 3) : image.num_channels + (image.has_trns ? 1 : 0);
+		bool is_16_bit = image.depth == 16;
+		constexpr ImageFormat formats[2][4] = {
+			{ ImageFormat::r8_unorm, ImageFormat::rg8_unorm, ImageFormat::rgb8_unorm, ImageFormat::rgba8_unorm },
+			{ ImageFormat::r16_unorm, ImageFormat::rg16_unorm, ImageFormat::rgb16_unorm, ImageFormat::rgba16_unorm },
+		};
+		out_format = formats[is_16_bit ? 1 : 0][num_channels - 1];
+		Vector<u16> values;
+		u32 scale = image.depth < 8 ? 255 / ((1 << image.depth) - 1) : 1;
+		u16 max_value = is_16_bit ? 65535 : 255;
+		usize num_pixels = (usize)image.width * image.height;
+		for (usize i = 0; i < num_pixels; ++i)
+		{
+			const u16* src = image.samples.data() + i * image.num_channels;
+			if (image.color_type == 3)
+			{
+				for (u32 c = 0; c < 3; ++c) values.push_back(image.palette[src[0] * 3 + c]);
+				if (image.has_trns) values.push_back(src[0] < image.palette_alpha.size() ? image.palette_alpha[src[0]] : 255);
+				continue;
+			}
+			bool transparent = image.has_trns;
+			for (u32 c = 0; c < image.num_channels; ++c)
+			{
+				values.push_back((u16)(src[c] * scale));
+				if (src[c] != image.trns[c]) transparent = false;
+			}
+			if (image.has_trns) values.push_back(transparent ? 0 : max_value);
+		}
+		Vector<u8> ret;
+		if (is_16_bit)
+		{
+			ret.resize(values.size() * 2);
+			memcpy(ret.data(), values.data(), ret.size());
+		}
+		else
+		{
+			for (u16 v : values) ret.push_back((u8)v);
+		}
+		return ret;
+	}
+
+	static void png_decode_test()
+	{
+		struct PNGConfig
+		{
+			u8 color_type;
+			u8 depth;
+			bool trns;
+		};
+		const PNGConfig configs[] = {
+			{ 0, 1, false }, { 0, 2, true }, { 0, 4, false }, { 0, 8, false }, { 0, 8, true }, { 0, 16, false }, { 0, 16, true },
+			{ 2, 8, false }, { 2, 8, true }, { 2, 16, false }, { 2, 16, true },
+			{ 3, 1, false }, { 3, 2, false }, { 3, 4, true }, { 3, 8, false }, { 3, 8, true },
+			{ 4, 8, false }, { 4, 16, false },
+			{ 6, 8, false }, { 6, 16, false },
+		};
+		for (const PNGConfig& config : configs)
+		{
+			PNGTestImage image = make_png_test_image(config.color_type, config.depth, config.trns, false);
+			ImageFormat format;
+			Vector<u8> expected = get_png_expected_pixels(image, format);
+			for (DeflateMode mode : DEFLATE_MODES)
+			{
+				Vector<u8> file = encode_png_test_image(image, mode);
+				check_decoded_image(file, format, image.width, image.height, expected);
+			}
+		}
+		// Bands are reported from top to bottom.
+		{
+			PNGTestImage image = make_png_test_image(2, 8, false, false);
+			Vector<u8> file = encode_png_test_image(image, DeflateMode::dynamic);
+			auto rows = decode_image_rows(file, ImageFormat::unkonwn, 8);
+			lutest(succeeded(rows));
+			lutest(rows.get().band_first_rows.size() == 3);
+			lutest(rows.get().band_first_rows[0] == 0 && rows.get().band_first_rows[1] == 8 && rows.get().band_first_rows[2] == 16);
+			// Format conversions match `read_image_file`.
+			for (ImageFormat desired : { ImageFormat::rgba8_unorm, ImageFormat::r8_unorm, ImageFormat::rgba16_unorm, ImageFormat::rgba32_float })
+			{
+				auto converted = decode_image_rows(file, desired, 5);
+				lutest(succeeded(converted));
+				lutest(converted.get().desc.format == desired);
+				ImageDesc desc;
+				auto image_data = read_image_file(file.data(), file.size(), desired, desc);
+				lutest(succeeded(image_data));
+				lutest(image_data.get().size() == converted.get().data.size());
+				lutest(equal_pixels(image_data.get().data(), converted.get().data.data(), image_data.get().size(), desired));
+			}
+		}
+		// Interlaced files are decoded only by `read_image_file`.
+		for (auto config : { PNGConfig{ 2, 8, false }, PNGConfig{ 0, 4, false }, PNGConfig{ 6, 16, false } })
+		{
+			PNGTestImage image = make_png_test_image(config.color_type, config.depth, config.trns, true);
+			ImageFormat format;
+			Vector<u8> expected = get_png_expected_pixels(image, format);
+			Vector<u8> file = encode_png_test_image(image, DeflateMode::mixed);
+			auto rows = decode_image_rows(file, ImageFormat::unkonwn, 4);
+			lutest(failed(rows) && rows.errcode() == BasicError::error_object() && get_error().code == BasicError::not_supported());
+			ImageDesc desc;
+			auto image_data = read_image_file(file.data(), file.size(), format, desc);
+			lutest(succeeded(image_data));
+			lutest(image_data.get().size() == expected.size());
+			lutest(!memcmp(image_data.get().data(), expected.data(), expected.size()));
+		}
+		// Broken streams are rejected.
+		{
+			PNGTestImage image = make_png_test_image(6, 8, false, false);
+			for (DeflateMode mode : DEFLATE_MODES)
+			{
+				Vector<u8> file = encode_png_test_image(image, mode, true);
+				lutest(failed(decode_image_rows(file, ImageFormat::unkonwn, 4)));
+			}
+			Vector<u8> file = encode_png_test_image(image, DeflateMode::fixed);
+			// Drops the IEND chunk and the end of the last IDAT chunk.
+			file.resize(file.size() - 12 - 20);
+			lutest(failed(decode_image_rows(file, ImageFormat::unkonwn, 4)));
+		}
+	}
+
+	//! Encodes pixels in file order using RLE packets. Packets cross row boundaries.
+	static void append_tga_rle(const Vector<u8>& pixels, u32 pixel_size, Vector<u8>& dst)
+	{
+		usize num_pixels = pixels.size() / pixel_size;
+		auto same = [&](usize a, usize b) { return !memcmp(pixels.data() + a * pixel_size, pixels.data() + b * pixel_size, pixel_size); };
+		usize i = 0;
+		while (i < num_pixels)
+		{
+			usize run = 1;
+			while (i + run < num_pixels && run < 128 && same(i, i + run)) ++run;
+			if (run >= 2)
+			{
+				dst.push_back((u8)(0x80 | (run - 1)));
+				for (u32 b = 0; b < pixel_size; ++b) dst.push_back(pixels[i * pixel_size + b]);
+				i += run;
+				continue;
+			}
+			usize count = 1;
+			while (i + count < num_pixels && count < 128 && !(i + count + 1 < num_pixels && same(i + count, i + count + 1))) ++count;
+			dst.push_back((u8)(count - 1));
+			for (usize b = 0; b < count * pixel_size; ++b) dst.push_back(pixels[i * pixel_size + b]);
+			i += count;
+		}
+	}
+
+	static void tga_decode_test()
+	{
+		u32 width = 29, height = 10;
+		for (u32 bits : { 8u, 24u, 32u })
+		{
+			bool gray = bits == 8;
+			u32 pixel_size = bits / 8;
+			ImageFormat format = gray ? ImageFormat::r8_unorm : (bits == 24 ? ImageFormat::rgb8_unorm : ImageFormat::rgba8_unorm);
+			// Pixels in top-to-bottom order in the output channel order.
+			Vector<u8> expected;
+			for (u32 y = 0; y < height; ++y)
+			{
+				for (u32 x = 0; x < width; ++x)
+				{
+					// Runs of equal pixels and single pixels.
+					u32 seed = x < 15 ? x / 4 + y : x * 31 + y * 17;
+					for (u32 c = 0; c < pixel_size; ++c) expected.push_back((u8)(seed * 37 + c * 71));
+				}
+			}
+			for (bool rle : { false, true })
+			{
+				for (bool top_down : { false, true })
+				{
+					// Pixels in file order, with BGR(A) channels.
+					Vector<u8> pixels;
+					for (u32 i = 0; i < height; ++i)
+					{
+						u32 y = top_down ? i : height - 1 - i;
+						const u8* src = expected.data() + (usize)y * width * pixel_size;
+						for (u32 x = 0; x < width; ++x, src += pixel_size)
+						{
+							if (gray) pixels.push_back(src[0]);
+							else
+							{
+								pixels.push_back(src[2]);
+								pixels.push_back(src[1]);
+								pixels.push_back(src[0]);
+								if (bits == 32) pixels.push_back(src[3]);
+							}
+						}
+					}
+					u8 header[18] = { 0 };
+					header[2] = (u8)((gray ? 3 : 2) + (rle ? 8 : 0));
+					header[12] = (u8)width;
+					header[14] = (u8)height;
+					header[16] = (u8)bits;
+					header[17] = (u8)((top_down ? 0x20 : 0) | (bits == 32 ? 8 : 0));
+					Vector<u8> file;
+					for (u8 b : header) file.push_back(b);
+					if (rle) append_tga_rle(pixels, pixel_size, file);
+					else file.insert(file.end(), pixels.begin(), pixels.end());
+					check_decoded_image(file, format, width, height, expected);
+					// Bottom-up files report bands from bottom to top.
+					auto rows = decode_image_rows(file, ImageFormat::unkonwn, 4);
+					lutest(succeeded(rows));
+					auto& bands = rows.get().band_first_rows;
+					lutest(bands.size() == 3);
+					if (top_down) lutest(bands[0] == 0 && bands[1] == 4 && bands[2] == 8);
+					else lutest(bands[0] == 6 && bands[1] == 2 && bands[2] == 0);
+				}
+			}
+		}
+	}
+
+	static void append_hdr_rle_channel(const u8* values, u32 width, Vector<u8>& dst)
+	{
+		u32 x = 0;
+		while (x < width)
+		{
+			u32 run = 1;
+			while (x + run < width && run < 127 && values[(x + run) * 4] == values[x * 4]) ++run;
+			if (run >= 3)
+			{
+				dst.push_back((u8)(128 + run));
+				dst.push_back(values[x * 4]);
+				x += run;
+				continue;
+			}
+			u32 count = 1;
+			while (x + count < width && count < 128 &&
+				!(x + count + 2 < width && values[(x + count) * 4] == values[(x + count + 1) * 4] && values[(x + count) * 4] == values[(x + count + 2) * 4])) ++count;
+			dst.push_back((u8)count);
+			for (u32 i = 0; i < count; ++i) dst.push_back(values[(x + i) * 4]);
+			x += count;
+		}
+	}
+
+	static void hdr_decode_test()
+	{
+		// Scanlines shorter than 8 pixels cannot be run-length encoded.
+		for (u32 width : { 5u, 41u })
+		{
+			u32 height = 7;
+			Vector<u8> rgbe;
+			Vector<f32> expected;
+			for (u32 y = 0; y < height; ++y)
+			{
+				for (u32 x = 0; x < width; ++x)
+				{
+					u32 seed = x < 20 ? x / 5 + y : x * 13 + y * 7;
+					u8 e = (y == 3 && x == 2) ? 0 : (u8)(120 + seed % 20);
+					u8 m[3] = { (u8)(128 + seed % 128), (u8)(128 + (seed * 3) % 128), (u8)((seed * 5) % 256) };
+					for (u32 c = 0; c < 3; ++c)
+					{
+						rgbe.push_back(m[c]);
+						expected.push_back(e ? m[c] * ldexpf(1.0f, (i32)e - 136) : 0.0f);
+					}
+					rgbe.push_back(e);
+				}
+			}
+			Vector<u8> file;
+			c8 header[128];
+			snprintf(header, sizeof(header), "#?RADIANCE\n# ImageIOTest\nFORMAT=32-bit_rle_rgbe\nEXPOSURE=1.0\n\n-Y %u +X %u\n", height, width);
+			for (usize i = 0; header[i]; ++i) file.push_back((u8)header[i]);
+			for (u32 y = 0; y < height; ++y)
+			{
+				const u8* row = rgbe.data() + (usize)y * width * 4;
+				if (width < 8)
+				{
+					file.insert(file.end(), row, row + (usize)width * 4);
+					continue;
+				}
+				file.push_back(2);
+				file.push_back(2);
+				file.push_back((u8)(width >> 8));
+				file.push_back((u8)width);
+				for (u32 c = 0; c < 4; ++c) append_hdr_rle_channel(row + c, width, file);
+			}
+			Vector<u8> expected_data(expected.size() * sizeof(f32));
+			memcpy(expected_data.data(), expected.data(), expected_data.size());
+			check_decoded_image(file, ImageFormat::rgb32_float, width, height, expected_data);
+		}
+	}
+
+	static void dds_region_test()
+	{
+		struct DDSConfig
+		{
+			DDSFormat format;
+			u32 width;
+			u32 height;
+			u32 array_size;
+		};
+		const DDSConfig configs[] = {
+			{ DDSFormat::r8g8b8a8_unorm, 19, 13, 2 },
+			{ DDSFormat::r32g32b32a32_float, 7, 5, 3 },
+			{ DDSFormat::bc1_unorm, 18, 10, 2 },
+			{ DDSFormat::bc7_unorm, 13, 9, 1 },
+		};
+		for (const DDSConfig& config : configs)
+		{
+			DDSImageDesc desc;
+			desc.width = config.width;
+			desc.height = config.height;
+			desc.depth = 1;
+			desc.array_size = config.array_size;
+			desc.mip_levels = 0;
+			desc.format = config.format;
+			desc.dimension = DDSDimension::tex2d;
+			desc.flags = DDSFlag::none;
+			auto image = new_dds_image(desc);
+			lutest(succeeded(image));
+			DDSImage& dds = image.get();
+			for (usize i = 0; i < dds.data.size(); ++i) dds.data.data()[i] = (u8)((i * 131) ^ (i >> 7));
+			{
+				Ref<IFile> file = open_test_file(Vector<u8>());
+				lutest(succeeded(write_dds_file(file, dds)));
+			}
+			auto file = open_file(TEST_FILE_PATH, FileOpenFlag::read, FileCreationMode::open_existing);
+			lutest(succeeded(file));
+			auto file_desc = read_dds_image_file_desc(file.get());
+			lutest(succeeded(file_desc));
+			lutest(file_desc.get().width == dds.desc.width && file_desc.get().height == dds.desc.height);
+			lutest(file_desc.get().depth == dds.desc.depth && file_desc.get().array_size == dds.desc.array_size);
+			lutest(file_desc.get().mip_levels == dds.desc.mip_levels && file_desc.get().format == dds.desc.format);
+			bool compressed = is_compressed(desc.format);
+			usize element_size = compressed ? bits_per_pixel(desc.format) * 2 : bits_per_pixel(desc.format) / 8;
+			u32 block = compressed ? 4 : 1;
+			for (u32 item = 0; item < dds.desc.array_size; ++item)
+			{
+				for (u32 mip = 0; mip < dds.desc.mip_levels; ++mip)
+				{
+					const DDSSubresource& sub = dds.subresources[calc_dds_subresoruce_index(mip, item, dds.desc.mip_levels)];
+					Vector<DDSRegion> regions;
+					regions.push_back({ 0, 0, 0, sub.width, sub.height, 1 });
+					if (sub.width > block * 2 && sub.height > block)
+					{
+						// One interior region and one region reaching the right and bottom edges.
+						regions.push_back({ block, block, 0, block, sub.height - block, 1 });
+						regions.push_back({ block, 0, 0, sub.width - block, block, 1 });
+					}
+					for (const DDSRegion& region : regions)
+					{
+						u32 num_elements_x = (region.width + block - 1) / block;
+						u32 num_rows = (region.height + block - 1) / block;
+						// Pads destination rows so that rows are copied one by one.
+						usize dst_row_pitch = num_elements_x * element_size + 8;
+						usize dst_slice_pitch = dst_row_pitch * num_rows;
+						Vector<u8> dst(dst_slice_pitch * region.depth, 0xCD);
+						lutest(succeeded(read_dds_image_region(file.get(), file_desc.get(), mip, item, region, dst.data(), dst_row_pitch, dst_slice_pitch)));
+						for (u32 z = 0; z < region.depth; ++z)
+						{
+							for (u32 row = 0; row < num_rows; ++row)
+							{
+								const u8* src = dds.data.data() + sub.data_offset + (region.z + z) * sub.slice_pitch +
+									(region.y / block + row) * sub.row_pitch + (region.x / block) * element_size;
+								const u8* d = dst.data() + z * dst_slice_pitch + row * dst_row_pitch;
+								lutest(!memcmp(src, d, num_elements_x * element_size));
+								lutest(d[num_elements_x * element_size] == 0xCD);
+							}
+						}
+						// Contiguous rows are read at once.
+						if (region.x == 0 && region.width == sub.width)
+						{
+							usize row_pitch = num_elements_x * element_size;
+							Vector<u8> packed(row_pitch * num_rows * region.depth);
+							lutest(succeeded(read_dds_image_region(file.get(), file_desc.get(), mip, item, region, packed.data(), row_pitch, row_pitch * num_rows)));
+							for (u32 z = 0; z < region.depth; ++z)
+							{
+								const u8* src = dds.data.data() + sub.data_offset + (region.z + z) * sub.slice_pitch + (region.y / block) * sub.row_pitch;
+								lutest(!memcmp(packed.data() + z * row_pitch * num_rows, src, row_pitch * num_rows));
+							}
+						}
+					}
+				}
+			}
+			// Invalid regions.
+			u8 buffer[256];
+			lutest(failed(read_dds_image_region(file.get(), file_desc.get(), 0, 0, { 0, 0, 0, config.width + 1, 1, 1 }, buffer, sizeof(buffer), sizeof(buffer))));
+			lutest(failed(read_dds_image_region(file.get(), file_desc.get(), dds.desc.mip_levels, 0, { 0, 0, 0, 1, 1, 1 }, buffer, sizeof(buffer), sizeof(buffer))));
+			lutest(failed(read_dds_image_region(file.get(), file_desc.get(), 0, dds.desc.array_size, { 0, 0, 0, 1, 1, 1 }, buffer, sizeof(buffer), sizeof(buffer))));
+			if (compressed)
+			{
+				lutest(failed(read_dds_image_region(file.get(), file_desc.get(), 0, 0, { 2, 0, 0, 4, 4, 1 }, buffer, sizeof(buffer), sizeof(buffer))));
+				lutest(failed(read_dds_image_region(file.get(), file_desc.get(), 0, 0, { 0, 0, 0, 6, 4, 1 }, buffer, sizeof(buffer), sizeof(buffer))));
+			}
+		}
+	}
+
+	void image_io_test()
+	{
+		png_decode_test();
+		tga_decode_test();
+		hdr_decode_test();
+		dds_region_test();
+		lutest(succeeded(delete_file(TEST_FILE_PATH)));
+	}
+}
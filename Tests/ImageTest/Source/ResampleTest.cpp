@@ -0,0 +1,157 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file ResampleTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Image/Resample.hpp>
+#include <Luna/Runtime/Vector.hpp>
+#include <Luna/Runtime/Math/Vector.hpp>
+
+namespace Luna
+{
+	using namespace Image;
+
+	constexpr ResampleFilter TEST_FILTERS[] = { ResampleFilter::box, ResampleFilter::triangle, ResampleFilter::kaiser, ResampleFilter::lanczos };
+
+	static u32 max_u8_error(const u8* lhs, const u8* rhs, usize size)
+	{
+		u32 ret = 0;
+		for (usize i = 0; i < size; ++i) ret = max<u32>(ret, (u32)abs((i32)lhs[i] - (i32)rhs[i]));
+		return ret;
+	}
+
+	static void identity_resize_test()
+	{
+		// Resizing to the same size does not change pixels for any filter.
+		u32 width = 37, height = 23;
+		Vector<u8> image(width * height * 4);
+		for (usize i = 0; i < image.size(); ++i) image[i] = (u8)((i * 37 + i / 7) & 0xFF);
+		Vector<f32> hdr_image(width * height * 3);
+		for (usize i = 0; i < hdr_image.size(); ++i) hdr_image[i] = (f32)(i % 17) * 1.5f;
+		for (ResampleFilter filter : TEST_FILTERS)
+		{
+			for (ResampleFlag flags : { ResampleFlag::none, ResampleFlag::srgb, ResampleFlag::wrap })
+			{
+				auto r = resize_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), width, height, filter, flags);
+				lutest(succeeded(r));
+				lutest(r.get().size() == image.size());
+				lutest(max_u8_error(r.get().data(), image.data(), image.size()) == 0);
+			}
+			auto r = resize_image({ ImageFormat::rgb32_float, width, height }, hdr_image.data(), width, height, filter);
+			lutest(succeeded(r));
+			const f32* data = (const f32*)r.get().data();
+			for (usize i = 0; i < hdr_image.size(); ++i) lutest(abs(data[i] - hdr_image[i]) < 1e-4f);
+		}
+	}
+
+	static void constant_color_test()
+	{
+		// Filters are normalized, so constant images stay constant after resampling, including negative
+		// lobes of Kaiser and Lanczos filters near borders.
+		const u8 color[4] = { 200, 17, 96, 64 };
+		u32 width = 53, height = 31;
+		Vector<u8> image(width * height * 4);
+		for (usize i = 0; i < width * height; ++i) memcpy(image.data() + i * 4, color, 4);
+		Vector<f32> hdr_image(width * height, 1000.0f);
+		const UInt2U sizes[] = { { 17, 9 }, { 100, 64 }, { 1, 1 }, { 53, 5 } };
+		for (ResampleFilter filter : TEST_FILTERS)
+		{
+			for (ResampleFlag flags : { ResampleFlag::none, ResampleFlag::srgb, ResampleFlag::wrap, ResampleFlag::alpha_weighted | ResampleFlag::srgb })
+			{
+				for (auto& size : sizes)
+				{
+					auto r = resize_image({ ImageFormat::rgba8_unorm, width, height }, image.data(), size.x, size.y, filter, flags);
+					lutest(succeeded(r));
+					lutest(r.get().size() == size.x * size.y * 4);
+					for (usize i = 0; i < size.x * size.y; ++i)
+					{
+						lutest(max_u8_error(r.get().data() + i * 4, color, 4) <= 1);
+					}
+				}
+			}
+			auto r = resize_image({ ImageFormat::r32_float, width, height }, hdr_image.data(), 20, 70, filter);
+			lutest(succeeded(r));
+			const f32* data = (const f32*)r.get().data();
+			for (usize i = 0; i < 20 * 70; ++i) lutest(abs(data[i] - 1000.0f) < 0.01f);
+		}
+	}
+
+	static void srgb_test()
+	{
+		// Averages black and white pixels. Linear filtering averages encoded values, while sRGB filtering averages 
+		// linear values and encodes the result, which is brighter. The alpha channel is always filtered linearly.
+		const u8 image[8] = { 0, 0, 0, 0, 255, 255, 255, 255 };
+		ImageDesc desc = { ImageFormat::rgba8_unorm, 2, 1 };
+		auto linear = resize_image(desc, image, 1, 1, ResampleFilter::box, ResampleFlag::none);
+		lutest(succeeded(linear));
+		for (u32 c = 0; c < 4; ++c) lutest(linear.get().data()[c] == 127 || linear.get().data()[c] == 128);
+		auto srgb = resize_image(desc, image, 1, 1, ResampleFilter::box, ResampleFlag::srgb);
+		lutest(succeeded(srgb));
+		// linear_to_srgb(0.5) * 255 = 187.5
+		for (u32 c = 0; c < 3; ++c) lutest(srgb.get().data()[c] == 187 || srgb.get().data()[c] == 188);
+		lutest(srgb.get().data()[3] == 127 || srgb.get().data()[3] == 128);
+		// Floating-point formats are never treated as sRGB.
+		const f32 hdr_image[2] = { 0.0f, 1.0f };
+		auto hdr = resize_image({ ImageFormat::r32_float, 2, 1 }, hdr_image, 1, 1, ResampleFilter::box, ResampleFlag::srgb);
+		lutest(succeeded(hdr));
+		lutest(abs(*(const f32*)hdr.get().data() - 0.5f) < 1e-6f);
+	}
+
+	static void mip_chain_test()
+	{
+		lutest(calc_mip_levels(1, 1) == 1);
+		lutest(calc_mip_levels(2, 1) == 2);
+		lutest(calc_mip_levels(256, 256) == 9);
+		lutest(calc_mip_levels(257, 3) == 9);
+		lutest(calc_mip_levels(1, 1024) == 11);
+
+		u32 width = 37, height = 10;
+		Vector<u8> image(width * height * 2);
+		for (usize i = 0; i < image.size(); ++i) image[i] = (u8)(i * 13);
+		ImageDesc desc = { ImageFormat::rg8_unorm, width, height };
+		auto mips = generate_mipmaps(desc, image.data());
+		lutest(succeeded(mips));
+		// 18x5, 9x2, 4x1, 2x1, 1x1
+		const UInt2U expected_sizes[] = { { 18, 5 }, { 9, 2 }, { 4, 1 }, { 2, 1 }, { 1, 1 } };
+		lutest(mips.get().size() == calc_mip_levels(width, height) - 1);
+		lutest(mips.get().size() == 5);
+		for (usize i = 0; i < 5; ++i)
+		{
+			lutest(mips.get()[i].size() == expected_sizes[i].x * expected_sizes[i].y * 2);
+		}
+		mips = generate_mipmaps(desc, image.data(), 3);
+		lutest(succeeded(mips));
+		lutest(mips.get().size() == 2);
+		mips = generate_mipmaps(desc, image.data(), 1);
+		lutest(succeeded(mips));
+		lutest(mips.get().empty());
+
+		// Box filtered power-of-two mipmaps are 2x2 averages.
+		const u16 block[16] = {
+			0, 100, 200, 300,
+			400, 500, 600, 700,
+			1000, 1000, 3000, 3000,
+			1000, 1000, 3000, 3000
+		};
+		mips = generate_mipmaps({ ImageFormat::r16_unorm, 4, 4 }, block, 0, ResampleFilter::box);
+		lutest(succeeded(mips));
+		lutest(mips.get().size() == 2);
+		const u16* mip1 = (const u16*)mips.get()[0].data();
+		lutest(mip1[0] == 250 && mip1[1] == 450 && mip1[2] == 1000 && mip1[3] == 3000);
+		const u16* mip2 = (const u16*)mips.get()[1].data();
+		lutest(abs((i32)mip2[0] - 1175) <= 1);
+	}
+
+	void resample_test()
+	{
+		identity_resize_test();
+		constant_color_test();
+		srgb_test();
+		mip_chain_test();
+	}
+}
@@ -0,0 +1,21 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file TestCommon.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Assert.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	void resample_test();
+	void bc_encoder_test();
+	void image_io_test();
+}
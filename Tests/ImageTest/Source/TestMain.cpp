@@ -0,0 +1,27 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file TestMain.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/Image/Image.hpp>
+using namespace Luna;
+
+int main()
+{
+	init();
+	lupanic_if_failed(add_modules({module_image()}));
+	lupanic_if_failed(init_modules());
+	set_log_to_platform_enabled(true);
+	resample_test();
+	bc_encoder_test();
+	image_io_test();
+	close();
+	return 0;
+}
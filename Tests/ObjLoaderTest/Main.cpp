@@ -0,0 +1,312 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/Runtime/String.hpp>
+#include <Luna/ObjLoader/ObjLoader.hpp>
+#include <stdio.h>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	using namespace ObjLoader;
+
+	static R<ObjMesh> load_obj(const String& obj, const c8* mtl = "")
+	{
+		return ObjLoader::load(Span<const byte_t>((const byte_t*)obj.data(), obj.size()), Span<const byte_t>((const byte_t*)mtl, strlen(mtl)));
+	}
+
+	static const Shape* find_shape(const ObjMesh& obj, const c8* name)
+	{
+		for (const Shape& shape : obj.shapes)
+		{
+			const c8* shape_name = shape.name.c_str();
+			if (shape_name && !strcmp(shape_name, name)) return &shape;
+		}
+		return nullptr;
+	}
+
+	inline f32 signed_area(const Float3U& a, const Float3U& b, const Float3U& c)
+	{
+		return ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) * 0.5f;
+	}
+
+	static void polygon_test()
+	{
+		// One concave polygon whose triangle fan from the first corner would cross the polygon boundary, and one quad.
+		String obj =
+			"v 0 0 0\n"
+			"v 4 0 0\n"
+			"v 4 4 0\n"
+			"v 2 1 0\n"
+			"v 0 4 0\n"
+			"f 1 2 3 4 5\n"
+			"f 1 2 3 5\n";
+		auto r = load_obj(obj);
+		lutest(succeeded(r));
+		const ObjMesh& mesh = r.get();
+		lutest(mesh.shapes.size() == 1);
+		const Mesh& m = mesh.shapes[0].mesh;
+		lutest(m.num_face_vertices.size() == 5);
+		for (u8 n : m.num_face_vertices) lutest(n == 3);
+		lutest(m.indices.size() == 15);
+		// Triangles keep the winding of the polygon and cover the polygon exactly.
+		f32 areas[2] = { 0.0f, 0.0f };
+		for (usize t = 0; t < 5; ++t)
+		{
+			const Float3U& a = mesh.attributes.vertices[m.indices[t * 3].vertex_index];
+			const Float3U& b = mesh.attributes.vertices[m.indices[t * 3 + 1].vertex_index];
+			const Float3U& c = mesh.attributes.vertices[m.indices[t * 3 + 2].vertex_index];
+			f32 area = signed_area(a, b, c);
+			lutest(area > 0.0f);
+			areas[t < 3 ? 0 : 1] += area;
+		}
+		lutest(areas[0] == 10.0f);
+		lutest(areas[1] == 16.0f);
+
+		// `build_indexed_mesh` triangulates polygons in the same way as `load`.
+		ObjMesh polygon_mesh;
+		polygon_mesh.attributes = mesh.attributes;
+		Shape shape;
+		for (i32 i = 0; i < 5; ++i) shape.mesh.indices.push_back({ i, -1, -1 });
+		shape.mesh.num_face_vertices.push_back(5);
+		shape.mesh.material_ids.push_back(-1);
+		shape.mesh.smoothing_group_ids.push_back(0);
+		polygon_mesh.shapes.push_back(move(shape));
+		IndexedMesh indexed = build_indexed_mesh(polygon_mesh, 0);
+		lutest(indexed.vertices.size() == 5);
+		lutest(indexed.indices.size() == 9);
+		for (usize i = 0; i < 9; ++i)
+		{
+			lutest(indexed.vertices[indexed.indices[i]] == m.indices[i]);
+		}
+		// Vertices are ordered by polygon corners.
+		for (i32 i = 0; i < 5; ++i) lutest(indexed.vertices[i].vertex_index == i);
+	}
+
+	static void index_test()
+	{
+		// Relative indices refer to attributes defined before the line.
+		String obj =
+			"v 0 0 0\n"
+			"v 1 0 0\n"
+			"v 0 1 0\n"
+			"vt 0 0\n"
+			"vt 1 0\n"
+			"vn 0 0 1\n"
+			"f -3 -2 -1\n"
+			"v 1 1 0\n"
+			"vt 1 1\n"
+			"vn 0 0 -1\n"
+			"f -3/-2/-1 -2/-1/-2 -1/-3/-1\n"
+			"f 1//1 2//2 3//1\n"
+			"f 2/1 3/2 4/3\n";
+		auto r = load_obj(obj);
+		lutest(succeeded(r));
+		const ObjMesh& mesh = r.get();
+		lutest(mesh.attributes.vertices.size() == 4);
+		lutest(mesh.attributes.texcoords.size() == 3);
+		lutest(mesh.attributes.normals.size() == 2);
+		lutest(mesh.shapes.size() == 1);
+		const Index expected[] = {
+			{ 0, -1, -1 }, { 1, -1, -1 }, { 2, -1, -1 },
+			{ 1, 1, 1 }, { 2, 0, 2 }, { 3, 1, 0 },
+			{ 0, 0, -1 }, { 1, 1, -1 }, { 2, 0, -1 },
+			{ 1, -1, 0 }, { 2, -1, 1 }, { 3, -1, 2 },
+		};
+		const Vector<Index>& indices = mesh.shapes[0].mesh.indices;
+		lutest(indices.size() == 12);
+		for (usize i = 0; i < 12; ++i)
+		{
+			lutest(indices[i].vertex_index == expected[i].vertex_index);
+			lutest(indices[i].normal_index == expected[i].normal_index);
+			lutest(indices[i].texcoord_index == expected[i].texcoord_index);
+		}
+		// Index 0 and malformed indices are errors.
+		lutest(failed(load_obj("v 0 0 0\nf 0 1 1\n")));
+		lutest(failed(load_obj("v 0 0 0\nf 1 1 x\n")));
+	}
+
+	static void shape_test()
+	{
+		const c8 mtl[] = "newmtl red\nnewmtl blue\n";
+		String obj =
+			"v 0 0 0\n"
+			"v 1 0 0\n"
+			"v 1 1 0\n"
+			"v 0 1 0\n"
+			"o first object\n"
+			"usemtl blue\n"
+			"f 1 2 3\n"
+			"s 1\n"
+			"g group1 group2\n"
+			"usemtl red\n"
+			"f 1 3 4\n"
+			"s off\n"
+			"usemtl unknown\n"
+			"f 2 3 4\n"
+			"g empty\n"
+			"g lines_only\n"
+			"l 1 2 3\n"
+			"p 4\n"
+			"g last\n"
+			"s 2\n"
+			"f 1 2 4\n"
+			"l 2 4\n"
+			"l 1 3 4\n"
+			"p 1 2\n";
+		auto r = load_obj(obj, mtl);
+		lutest(succeeded(r));
+		const ObjMesh& mesh = r.get();
+		// Empty shapes and shapes ended by `g` lines without faces are discarded.
+		lutest(mesh.shapes.size() == 3);
+		lutest(!find_shape(mesh, "empty") && !find_shape(mesh, "lines_only"));
+		const Shape* first = find_shape(mesh, "first object");
+		lutest(first);
+		lutest(first->mesh.material_ids.size() == 1);
+		lutest(first->mesh.material_ids[0] == 1 && first->mesh.smoothing_group_ids[0] == 0);
+		const Shape* group = find_shape(mesh, "group1 group2");
+		lutest(group);
+		lutest(group->mesh.material_ids.size() == 2);
+		lutest(group->mesh.material_ids[0] == 0 && group->mesh.smoothing_group_ids[0] == 1);
+		lutest(group->mesh.material_ids[1] == -1 && group->mesh.smoothing_group_ids[1] == 0);
+		const Shape* last = find_shape(mesh, "last");
+		lutest(last);
+		lutest(last->mesh.material_ids.size() == 1);
+		lutest(last->mesh.material_ids[0] == -1 && last->mesh.smoothing_group_ids[0] == 2);
+		// Lines and points of discarded shapes are not written to other shapes.
+		lutest(last->lines.num_line_vertices.size() == 2);
+		lutest(last->lines.num_line_vertices[0] == 2 && last->lines.num_line_vertices[1] == 3);
+		const i32 line_vertices[] = { 1, 3, 0, 2, 3 };
+		lutest(last->lines.indices.size() == 5);
+		for (usize i = 0; i < 5; ++i) lutest(last->lines.indices[i].vertex_index == line_vertices[i]);
+		lutest(last->points.indices.size() == 2);
+		lutest(last->points.indices[0].vertex_index == 0 && last->points.indices[1].vertex_index == 1);
+	}
+
+	struct ExpectedShape
+	{
+		String name;
+		Vector<i32> triangles;
+		Vector<i32> line_sizes;
+		Vector<i32> lines;
+		Vector<i32> points;
+	};
+
+	static void chunk_test()
+	{
+		// Builds one file that is split into multiple chunks, with shapes, discarded shapes, lines, points and
+		// relative indices crossing chunk boundaries.
+		String obj;
+		Vector<ExpectedShape> expected;
+		c8 buf[256];
+		i32 num_vertices = 0;
+		auto add_vertices = [&](i32 count)
+		{
+			for (i32 i = 0; i < count; ++i)
+			{
+				snprintf(buf, sizeof(buf), "v %d %d 0\n", num_vertices, num_vertices * 7 % 13);
+				obj.append(buf);
+				++num_vertices;
+			}
+		};
+		// Writes relative indices for odd iterations.
+		auto write_index = [&](i32 index, bool relative)
+		{
+			snprintf(buf, sizeof(buf), " %d", relative ? index - num_vertices : index + 1);
+			obj.append(buf);
+		};
+		add_vertices(64);
+		obj.append("g shape_0\n");
+		expected.emplace_back();
+		expected.back().name = "shape_0";
+		constexpr u32 num_iterations = 40000;
+		for (u32 i = 0; i < num_iterations; ++i)
+		{
+			if (i % 5000 == 4999)
+			{
+				add_vertices(3);
+				obj.append("g dropped\nl 1 2 3\np 5 6\n");
+				snprintf(buf, sizeof(buf), "g shape_%u\n", i / 5000 + 1);
+				obj.append(buf);
+				expected.emplace_back();
+				snprintf(buf, sizeof(buf), "shape_%u", i / 5000 + 1);
+				expected.back().name = buf;
+			}
+			ExpectedShape& shape = expected.back();
+			bool relative = i % 2 != 0;
+			i32 a = (i32)(i % (u32)num_vertices);
+			i32 b = (a + 1) % num_vertices;
+			i32 c = (a + 5) % num_vertices;
+			obj.append("f");
+			write_index(a, relative);
+			write_index(b, relative);
+			write_index(c, relative);
+			obj.append("\n");
+			shape.triangles.push_back(a);
+			shape.triangles.push_back(b);
+			shape.triangles.push_back(c);
+			if (i % 3 == 0)
+			{
+				obj.append("l");
+				write_index(c, relative);
+				write_index(a, relative);
+				obj.append("\n");
+				shape.line_sizes.push_back(2);
+				shape.lines.push_back(c);
+				shape.lines.push_back(a);
+			}
+			if (i % 7 == 0)
+			{
+				obj.append("p");
+				write_index(b, relative);
+				obj.append("\n");
+				shape.points.push_back(b);
+			}
+			obj.append("# Padding makes the file large enough to be split into chunks.\n");
+		}
+		lutest(obj.size() > 3 * 1024 * 1024);
+		auto r = load_obj(obj);
+		lutest(succeeded(r));
+		const ObjMesh& mesh = r.get();
+		lutest(mesh.attributes.vertices.size() == (usize)num_vertices);
+		lutest(mesh.shapes.size() == expected.size());
+		for (usize s = 0; s < expected.size(); ++s)
+		{
+			const Shape& shape = mesh.shapes[s];
+			const ExpectedShape& e = expected[s];
+			lutest(!strcmp(shape.name.c_str(), e.name.c_str()));
+			lutest(shape.mesh.indices.size() == e.triangles.size());
+			for (usize i = 0; i < e.triangles.size(); ++i) lutest(shape.mesh.indices[i].vertex_index == e.triangles[i]);
+			lutest(shape.lines.num_line_vertices.size() == e.line_sizes.size());
+			for (usize i = 0; i < e.line_sizes.size(); ++i) lutest(shape.lines.num_line_vertices[i] == e.line_sizes[i]);
+			lutest(shape.lines.indices.size() == e.lines.size());
+			for (usize i = 0; i < e.lines.size(); ++i) lutest(shape.lines.indices[i].vertex_index == e.lines[i]);
+			lutest(shape.points.indices.size() == e.points.size());
+			for (usize i = 0; i < e.points.size(); ++i) lutest(shape.points.indices[i].vertex_index == e.points[i]);
+		}
+	}
+}
+
+int main()
+{
+	Luna::init();
+	lupanic_if_failed(Luna::add_modules({Luna::module_obj_loader()}));
+	lupanic_if_failed(Luna::init_modules());
+	Luna::set_log_to_platform_enabled(true);
+	Luna::polygon_test();
+	Luna::index_test();
+	Luna::shape_test();
+	Luna::chunk_test();
+	Luna::close();
+	return 0;
+}
@@ -0,0 +1,6 @@
+target("ObjLoaderTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_files("*.cpp")
+    add_deps("Runtime", "JobSystem", "ObjLoader")
+target_end()
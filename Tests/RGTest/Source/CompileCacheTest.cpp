@@ -0,0 +1,104 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CompileCacheTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+
+namespace Luna
+{
+	void compile_cache_test()
+	{
+		// E -> T1 -> T2 -> T3 -> Out. `desc_b` resizes T2, which changes descs of T2, T3 and Out.
+		constexpr usize NUM_PASSES = 4;
+		constexpr u32 NUM_ELEMENTS = NUM_PASSES + 1;
+		RG::RenderGraphDesc desc_a = new_test_chain_desc(NUM_PASSES);
+		RG::RenderGraphDesc desc_b = desc_a;
+		desc_b.resources[2].desc.buffer.size = 256;
+		auto graph = RG::new_render_graph(RHI::get_main_device());
+		RG::RenderGraph* impl = get_render_graph_impl(graph);
+		TestPassType* type = get_test_pass_type(RHI::CommandQueueType::graphics);
+		RG::RenderGraphCompileConfig config;
+		u32 num_executions = 0;
+		// Compiles the graph, checks the number of passes that are compiled, then executes the graph.
+		auto compile = [&](const RG::RenderGraphDesc& desc, u32 num_compiles)
+		{
+			u32 num_compiles_before = type->m_num_compiles;
+			graph->set_desc(desc);
+			lutest(succeeded(graph->compile(config)));
+			lutest(type->m_num_compiles - num_compiles_before == num_compiles);
+			u32 expected[NUM_ELEMENTS];
+			expected[0] = 400 + num_executions++;
+			for (u32 i = 1; i < NUM_ELEMENTS; ++i) expected[i] = i;
+			graph->set_external_resource(0, new_test_input_buffer(NUM_ELEMENTS, expected[0]));
+			execute_test_graph(graph, NUM_PASSES, { expected, NUM_ELEMENTS });
+			fetch_test_pass_records();
+		};
+		auto get_transient_resources = [&](Ref<RHI::IResource>* resources)
+		{
+			for (usize i = 0; i < NUM_PASSES - 1; ++i) resources[i] = impl->m_resource_data[i + 1].m_resource;
+		};
+		auto check_transient_resources = [&](const Ref<RHI::IResource>* resources)
+		{
+			for (usize i = 0; i < NUM_PASSES - 1; ++i)
+			{
+				if (impl->m_resource_data[i + 1].m_resource != resources[i]) return false;
+			}
+			return true;
+		};
+
+		// A1: the first compilation compiles all passes.
+		compile(desc_a, NUM_PASSES);
+		Ref<RHI::IResource> output_a = graph->get_persistent_resource(NUM_PASSES);
+		Ref<RHI::IResource> transients_a[NUM_PASSES - 1];
+		get_transient_resources(transients_a);
+		lutest(impl->m_cached_plans.empty());
+
+		// Compiling again without changes does nothing.
+		compile(desc_a, 0);
+		lutest(graph->get_persistent_resource(NUM_PASSES) == output_a && check_transient_resources(transients_a));
+		lutest(impl->m_cached_plans.empty());
+
+		// A2: changing the config creates one new plan, but every pass sees the same resource descs, so no pass is
+		// compiled, and persistent and transient resources are reused.
+		config.max_recording_segments = 2;
+		compile(desc_a, 0);
+		lutest(graph->get_persistent_resource(NUM_PASSES) == output_a && check_transient_resources(transients_a));
+		lutest(impl->m_cached_plans.size() == 1);
+
+		// B2: resizing T2 recompiles only passes that see T2 or resources derived from it. Pass0 is reused.
+		compile(desc_b, NUM_PASSES - 1);
+		Ref<RHI::IBuffer> output_b = graph->get_persistent_resource(NUM_PASSES);
+		lutest(output_b != output_a && output_b->get_desc().size == 256);
+		lutest(impl->m_cached_plans.size() == 2);
+
+		// A2 is loaded from the cache with its resources, and B2 is cached.
+		compile(desc_a, 0);
+		lutest(graph->get_persistent_resource(NUM_PASSES) == output_a && check_transient_resources(transients_a));
+		lutest(impl->m_cached_plans.size() == 2 && impl->m_cached_plans[0].m_desc.resources[2].desc.buffer.size == 256);
+
+		// B2 is loaded from the cache. Plans are ordered from the most recently used one, so shrinking the cache to 1
+		// keeps A2 and evicts A1.
+		config.max_cached_plans = 1;
+		compile(desc_b, 0);
+		lutest(graph->get_persistent_resource(NUM_PASSES) == output_b);
+		lutest(impl->m_cached_plans.size() == 1 && impl->m_cached_plans[0].m_config.max_recording_segments == 2);
+		lutest(impl->m_cached_plans[0].m_desc.resources[2].desc.buffer.size == 0);
+
+		// A1 is evicted, so it is compiled from B2, and only passes that see T2, T3 or Out are compiled again.
+		config.max_recording_segments = 1;
+		compile(desc_a, NUM_PASSES - 1);
+		lutest(graph->get_persistent_resource(NUM_PASSES) != output_b);
+		lutest(impl->m_cached_plans.size() == 1 && impl->m_cached_plans[0].m_desc.resources[2].desc.buffer.size == 256);
+
+		// Caching can be disabled.
+		config.max_cached_plans = 0;
+		compile(desc_a, 0);
+		lutest(impl->m_cached_plans.empty());
+	}
+}
@@ -0,0 +1,129 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file CrossQueueTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+
+namespace Luna
+{
+	//! Checks whether submission `dst` waits for one fence signaled by submission `src`.
+	static bool has_dependency(RG::RenderGraph* impl, usize src, usize dst)
+	{
+		for (usize f : impl->m_submissions[dst].m_wait_fences)
+		{
+			for (usize g : impl->m_submissions[src].m_signal_fences)
+			{
+				if (f == g) return true;
+			}
+		}
+		return false;
+	}
+
+	void cross_queue_test()
+	{
+		// Pass0 (graphics): E -> T1
+		// Pass1 (compute):  T1 -> T2
+		// Pass2 (copy):     E -> T3
+		// Pass3 (graphics): T2, T3 -> T4
+		// Pass4 (graphics): T4 -> Out
+		RG::RenderGraphDesc desc;
+		usize e = add_test_resource(desc, RG::RenderGraphResourceType::external);
+		usize t1 = add_test_resource(desc, RG::RenderGraphResourceType::transient);
+		usize t2 = add_test_resource(desc, RG::RenderGraphResourceType::transient);
+		usize t3 = add_test_resource(desc, RG::RenderGraphResourceType::transient);
+		usize t4 = add_test_resource(desc, RG::RenderGraphResourceType::transient);
+		usize out = add_test_resource(desc, RG::RenderGraphResourceType::persistent, RG::RenderGraphResourceFlag::output);
+		add_test_pass(desc, "TestCopy", e, t1);
+		add_test_pass(desc, "TestComputeCopy", t1, t2);
+		add_test_pass(desc, "TestCopyQueueCopy", e, t3);
+		add_test_pass(desc, "TestCopy", t2, t4, t3);
+		add_test_pass(desc, "TestCopy", t4, out);
+		set_test_input_sizes(desc);
+		constexpr u32 NUM_ELEMENTS = 6;
+		auto graph = RG::new_render_graph(RHI::get_main_device());
+		graph->set_desc(desc);
+		RG::RenderGraphCompileConfig config;
+		config.enable_time_profiling = true;
+		lutest(succeeded(graph->compile(config)));
+
+		// T3 is created after the last access of T1, so they share one slot although they are accessed on different
+		// queues. T2 and T4 overlap with T1 or T3, so they use their own slots.
+		RG::RenderGraph* impl = get_render_graph_impl(graph);
+		auto& data = impl->m_resource_data;
+		lutest(impl->m_transient_memory_slots.size() == 3);
+		lutest(data[t1].m_memory_slot == data[t3].m_memory_slot);
+		lutest(data[t2].m_memory_slot != data[t1].m_memory_slot && data[t4].m_memory_slot != data[t1].m_memory_slot);
+		lutest(data[t2].m_memory_slot != data[t4].m_memory_slot);
+		lutest(data[t1].m_resource->get_memory() == data[t3].m_resource->get_memory());
+
+		u32 expected[NUM_ELEMENTS] = { 300, 1, 2, 3, 4, 5 };
+		graph->set_external_resource(e, new_test_input_buffer(NUM_ELEMENTS, expected[0]));
+		Ref<RHI::ICommandBuffer> cmdbuf;
+		execute_test_graph(graph, out, { expected, NUM_ELEMENTS }, &cmdbuf);
+
+		// Passes on different queues are recorded to different segments.
+		u32 graphics_queue = get_command_queue(RHI::CommandQueueType::graphics);
+		u32 compute_queue = get_command_queue(RHI::CommandQueueType::compute);
+		u32 copy_queue = get_command_queue(RHI::CommandQueueType::copy);
+		lutest(impl->m_segment_begins.size() == 5);
+		const usize segment_begins[] = { 0, 1, 2, 3, 5 };
+		for (usize i = 0; i < 5; ++i) lutest(impl->m_segment_begins[i] == segment_begins[i]);
+		lutest(impl->m_submissions.size() == 4);
+		lutest(impl->m_submissions[0].m_queue == graphics_queue);
+		lutest(impl->m_submissions[1].m_queue == compute_queue);
+		lutest(impl->m_submissions[2].m_queue == copy_queue);
+		lutest(impl->m_submissions[3].m_queue == graphics_queue);
+		// Graphics -> compute for T1.
+		lutest(has_dependency(impl, 0, 1));
+		// Compute -> copy, since T3 overwrites the memory of T1 that is read by the compute pass.
+		lutest(has_dependency(impl, 1, 2));
+		// Compute -> graphics for T2, and copy -> graphics for T3.
+		lutest(has_dependency(impl, 1, 3));
+		lutest(has_dependency(impl, 2, 3));
+		// Every fence is signaled and waited once.
+		usize num_signals = 0;
+		usize num_waits = 0;
+		for (auto& submission : impl->m_submissions)
+		{
+			num_signals += submission.m_signal_fences.size();
+			num_waits += submission.m_wait_fences.size();
+		}
+		lutest(num_signals == num_waits && impl->m_fences.size() >= num_signals);
+
+		// The last segment waits for other queues, so it is recorded to one command buffer of the render graph, and
+		// every segment is recorded to the command buffer of its queue. Segments may be recorded in any order, and the
+		// marker of pass `i` is `i + 1`.
+		auto records = fetch_test_pass_records();
+		lutest(records.size() == 5);
+		bool recorded[5] = { false };
+		for (auto& record : records)
+		{
+			lutest(record.marker >= 1 && record.marker <= 5 && !recorded[record.marker - 1]);
+			usize pass = record.marker - 1;
+			recorded[pass] = true;
+			usize segment = pass < 3 ? pass : 3;
+			RHI::ICommandBuffer* segment_cmdbuf = impl->m_segment_cmdbufs[segment].m_cmdbuf;
+			lutest(record.cmdbuf == segment_cmdbuf && record.cmdbuf != cmdbuf.get());
+			lutest(segment_cmdbuf->get_command_queue_index() == impl->m_submissions[segment].m_queue);
+		}
+
+		// The null backend executes command buffers in submission order using one CPU clock, so passes do not overlap.
+		Vector<RG::RenderPassTimeRange> ranges;
+		f64 overlapped_time;
+		lutest(succeeded(graph->get_pass_time_ranges(ranges, &overlapped_time)));
+		lutest(ranges.size() == 5 && ranges[0].begin == 0.0);
+		for (usize i = 0; i < 5; ++i)
+		{
+			lutest(ranges[i].pass == i && ranges[i].begin <= ranges[i].end);
+			if (i) lutest(ranges[i].begin >= ranges[i - 1].end);
+		}
+		lutest(ranges[1].command_queue == compute_queue && ranges[2].command_queue == copy_queue);
+		lutest(overlapped_time == 0.0);
+	}
+}
@@ -0,0 +1,146 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file DrawTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+// Checks draw commands recorded by the null backend.
+#include <Luna/RHI/Source/Null/CommandBuffer.hpp>
+
+namespace Luna
+{
+	constexpr u32 DRAW_TEXTURE_SIZE = 4;
+
+	//! Draws to the "dst" texture using the "src" buffer as the index buffer.
+	struct TestDrawPass : RG::IRenderPass
+	{
+		lustruct("TestDrawPass", "{5b0f2e6a-93d1-4c7e-a8f4-1e6d2c9b7a30}");
+		luiimpl();
+
+		Ref<RHI::IPipelineLayout> m_pipeline_layout;
+		Ref<RHI::IPipelineState> m_pipeline_state;
+		RHI::ICommandBuffer* m_cmdbuf = nullptr;
+
+		RV execute(RG::IRenderPassContext* ctx) override
+		{
+			lutry
+			{
+				RHI::ICommandBuffer* cmdbuf = ctx->get_command_buffer();
+				Ref<RHI::IBuffer> src = ctx->get_input("src");
+				Ref<RHI::ITexture> dst = ctx->get_output("dst");
+				lutest(src && dst);
+				if (!m_pipeline_state)
+				{
+					auto device = cmdbuf->get_device();
+					luset(m_pipeline_layout, device->new_pipeline_layout(RHI::PipelineLayoutDesc({}, RHI::PipelineLayoutFlag::deny_pixel_shader_access)));
+					RHI::GraphicsPipelineStateDesc desc;
+					desc.pipeline_layout = m_pipeline_layout;
+					desc.num_color_attachments = 1;
+					desc.color_formats[0] = RHI::Format::rgba8_unorm;
+					luset(m_pipeline_state, device->new_graphics_pipeline_state(desc));
+				}
+				m_cmdbuf = cmdbuf;
+				cmdbuf->resource_barrier(
+					{ { src, RHI::BufferStateFlag::automatic, RHI::BufferStateFlag::index_buffer } },
+					{ { dst, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, RHI::TextureStateFlag::automatic, RHI::TextureStateFlag::color_attachment_write, RHI::ResourceBarrierFlag::discard_content } });
+				RHI::RenderPassDesc desc;
+				desc.color_attachments[0] = RHI::ColorAttachment(dst, RHI::LoadOp::clear, RHI::StoreOp::store);
+				cmdbuf->begin_render_pass(desc);
+				cmdbuf->set_graphics_pipeline_layout(m_pipeline_layout);
+				cmdbuf->set_graphics_pipeline_state(m_pipeline_state);
+				cmdbuf->draw_instanced(3, 2, 1, 4);
+				cmdbuf->set_index_buffer({ src, 0, (u32)src->get_desc().size, RHI::Format::r32_uint });
+				cmdbuf->draw_indexed_instanced(2, 1, 1, -1, 3);
+				cmdbuf->end_render_pass();
+			}
+			lucatchret;
+			return ok;
+		}
+	};
+
+	static RV compile_test_draw_pass(object_t userdata, RG::IRenderGraphCompiler* compiler)
+	{
+		usize src = compiler->get_input_resource("src");
+		usize dst = compiler->get_output_resource("dst");
+		if (src == RG::INVALID_RESOURCE || dst == RG::INVALID_RESOURCE)
+		{
+			return set_error(BasicError::bad_arguments(), "TestDrawPass: \"src\" and \"dst\" must be specified.");
+		}
+		RG::ResourceDesc src_desc = compiler->get_resource_desc(src);
+		src_desc.buffer.usages |= RHI::BufferUsageFlag::index_buffer;
+		compiler->set_resource_desc(src, src_desc);
+		RG::ResourceDesc dst_desc = compiler->get_resource_desc(dst);
+		dst_desc.type = RG::ResourceType::texture;
+		dst_desc.texture = RHI::TextureDesc::tex2d(RHI::Format::rgba8_unorm, RHI::TextureUsageFlag::color_attachment, DRAW_TEXTURE_SIZE, DRAW_TEXTURE_SIZE, 1, 1);
+		compiler->set_resource_desc(dst, dst_desc);
+		compiler->set_render_pass_object(new_object<TestDrawPass>());
+		return ok;
+	}
+
+	static void register_test_draw_pass_type()
+	{
+		register_boxed_type<TestDrawPass>();
+		impl_interface_for_type<TestDrawPass, RG::IRenderPass>();
+		RG::RenderPassTypeDesc desc;
+		desc.name = "TestDraw";
+		desc.desc = "Draws to the destination texture using the source buffer as the index buffer.";
+		desc.input_parameters.push_back({ "src", "The index buffer." });
+		desc.output_parameters.push_back({ "dst", "The color attachment." });
+		desc.compile = compile_test_draw_pass;
+		RG::register_render_pass_type(desc);
+	}
+
+	void draw_test()
+	{
+		register_test_draw_pass_type();
+		// Pass0 (TestCopy): E -> T1
+		// Pass1 (TestDraw): T1 -> Out
+		RG::RenderGraphDesc desc;
+		usize e = add_test_resource(desc, RG::RenderGraphResourceType::external);
+		usize t1 = add_test_resource(desc, RG::RenderGraphResourceType::transient);
+		usize out = add_test_resource(desc, RG::RenderGraphResourceType::persistent, RG::RenderGraphResourceFlag::output);
+		desc.resources[out].desc.memory_type = RHI::MemoryType::local;
+		add_test_pass(desc, "TestCopy", e, t1);
+		desc.passes.push_back({ "Pass1", "TestDraw" });
+		desc.input_connections.push_back({ 1, "src", t1 });
+		desc.output_connections.push_back({ 1, "dst", out });
+		set_test_input_sizes(desc);
+		auto graph = RG::new_render_graph(RHI::get_main_device());
+		graph->set_desc(desc);
+		lutest(succeeded(graph->compile({})));
+
+		// The draw pass adds the index buffer usage to its input and creates its output texture.
+		RG::RenderGraph* impl = get_render_graph_impl(graph);
+		lutest(test_flags(impl->m_resource_data[t1].m_resource_desc.buffer.usages, RHI::BufferUsageFlag::index_buffer));
+		Ref<RHI::ITexture> texture = graph->get_persistent_resource(out);
+		lutest(texture && texture->get_desc().width == DRAW_TEXTURE_SIZE && texture->get_desc().height == DRAW_TEXTURE_SIZE);
+
+		auto device = RHI::get_main_device();
+		auto cmdbuf = device->new_command_buffer(get_command_queue(RHI::CommandQueueType::graphics)).get();
+		graph->set_external_resource(e, new_test_input_buffer(3, 0));
+		lutest(succeeded(graph->execute(cmdbuf)));
+		lutest(succeeded(cmdbuf->submit({}, {}, true)));
+		cmdbuf->wait();
+		lutest(fetch_test_pass_records().size() == 1);
+
+		// Both passes are recorded to one segment, and draw commands store their arguments.
+		TestDrawPass* pass = (TestDrawPass*)impl->m_pass_data[1].m_render_pass->get_object();
+		lutest(pass->m_cmdbuf == cmdbuf.get());
+		RHI::CommandBuffer* cmdbuf_impl = (RHI::CommandBuffer*)cmdbuf->get_object();
+		Vector<const RHI::DrawCommand*> draws;
+		for (auto& command : cmdbuf_impl->m_commands)
+		{
+			if (command.type == RHI::CommandType::draw) draws.push_back(&command.draw);
+		}
+		lutest(draws.size() == 2);
+		lutest(!draws[0]->indexed && draws[0]->vertex_or_index_count_per_instance == 3 && draws[0]->instance_count == 2);
+		lutest(draws[0]->start_vertex_or_index_location == 1 && draws[0]->base_vertex_location == 0 && draws[0]->start_instance_location == 4);
+		lutest(draws[1]->indexed && draws[1]->vertex_or_index_count_per_instance == 2 && draws[1]->instance_count == 1);
+		lutest(draws[1]->start_vertex_or_index_location == 1 && draws[1]->base_vertex_location == -1 && draws[1]->start_instance_location == 3);
+	}
+}
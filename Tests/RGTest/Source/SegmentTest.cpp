@@ -0,0 +1,109 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file SegmentTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+#include <Luna/RHI/Source/Null/CommandBuffer.hpp>
+
+namespace Luna
+{
+	//! Counts barrier commands recorded to one command buffer of the null backend.
+	static usize count_barriers(RHI::ICommandBuffer* cmdbuf)
+	{
+		RHI::CommandBuffer* impl = (RHI::CommandBuffer*)cmdbuf->get_object();
+		usize num_barriers = 0;
+		for (auto& command : impl->m_commands)
+		{
+			if (command.type == RHI::CommandType::resource_barrier) ++num_barriers;
+		}
+		return num_barriers;
+	}
+
+	//! Checks segments of one chain whose passes are all executed on the graphics queue.
+	static void check_chain_segments(RG::IRenderGraph* graph, usize num_passes, usize num_segments, RHI::ICommandBuffer* cmdbuf)
+	{
+		RG::RenderGraph* impl = get_render_graph_impl(graph);
+		auto records = fetch_test_pass_records();
+		lutest(records.size() == num_passes);
+		lutest(impl->m_segment_begins.size() == num_segments + 1);
+		lutest(impl->m_segment_begins[0] == 0 && impl->m_segment_begins[num_segments] == num_passes);
+		if (num_segments > 1)
+		{
+			// Segments on the same queue are ordered by submission, so no fence is needed.
+			lutest(impl->m_submissions.size() == num_segments);
+			for (auto& submission : impl->m_submissions)
+			{
+				lutest(submission.m_wait_fences.empty() && submission.m_signal_fences.empty());
+			}
+		}
+		for (usize s = 0; s < num_segments; ++s)
+		{
+			usize begin = impl->m_segment_begins[s];
+			usize end = impl->m_segment_begins[s + 1];
+			lutest(begin < end);
+			// The last segment is recorded to the command buffer of the user, other segments are recorded to
+			// command buffers of the render graph.
+			RHI::ICommandBuffer* segment_cmdbuf = s + 1 == num_segments ? cmdbuf : impl->m_segment_cmdbufs[s].m_cmdbuf.get();
+			for (usize t = 0; t < s; ++t)
+			{
+				lutest(impl->m_segment_cmdbufs[t].m_cmdbuf != segment_cmdbuf);
+			}
+			// Passes of one segment are recorded in pass order.
+			usize next = begin;
+			usize num_barriers = 0;
+			for (auto& record : records)
+			{
+				if (record.cmdbuf != segment_cmdbuf) continue;
+				lutest(next < end && record.marker == next + 1);
+				// Every pass except the last one creates one transient resource, which may alias memory of resources
+				// used by former passes, so one aliasing barrier is recorded before the pass.
+				if (next + 1 < num_passes) ++num_barriers;
+				++next;
+			}
+			lutest(next == end);
+			lutest(count_barriers(segment_cmdbuf) == num_barriers);
+		}
+	}
+
+	void segment_test()
+	{
+		constexpr usize NUM_PASSES = 8;
+		constexpr u32 NUM_ELEMENTS = NUM_PASSES + 1;
+		auto graph = RG::new_render_graph(RHI::get_main_device());
+		graph->set_desc(new_test_chain_desc(NUM_PASSES));
+		// Every pass writes the index of its output resource, and the input carries one value that changes every execution.
+		u32 expected[NUM_ELEMENTS];
+		for (u32 i = 0; i < NUM_ELEMENTS; ++i) expected[i] = i;
+		u32 num_executions = 0;
+		auto execute_chain = [&](usize num_segments)
+		{
+			expected[0] = 100 + num_executions++;
+			graph->set_external_resource(0, new_test_input_buffer(NUM_ELEMENTS, expected[0]));
+			Ref<RHI::ICommandBuffer> cmdbuf;
+			execute_test_graph(graph, NUM_PASSES, { expected, NUM_ELEMENTS }, &cmdbuf);
+			check_chain_segments(graph, NUM_PASSES, num_segments, cmdbuf);
+		};
+
+		RG::RenderGraphCompileConfig config;
+		config.max_recording_segments = 1;
+		lutest(succeeded(graph->compile(config)));
+		execute_chain(1);
+
+		// Segments are recorded concurrently and submitted in pass order. Executes multiple times so that segments
+		// are balanced by the recording time of the last execution, and command buffers of segments are reused.
+		config.max_recording_segments = 4;
+		lutest(succeeded(graph->compile(config)));
+		for (u32 i = 0; i < 3; ++i) execute_chain(4);
+
+		// Every segment has at least one pass.
+		config.max_recording_segments = 16;
+		lutest(succeeded(graph->compile(config)));
+		execute_chain(NUM_PASSES);
+	}
+}
@@ -0,0 +1,88 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file TestCommon.hpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#pragma once
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Assert.hpp>
+#include <Luna/RG/RenderGraph.hpp>
+// RGTest runs on the null RHI backend, and checks the execution plan of the render graph using its internal states.
+#include <Luna/RG/Source/RenderGraph.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	//! The global data of one test pass type.
+	struct TestPassType
+	{
+		lustruct("TestPassType", "{add2cec7-6664-4aaf-b979-3ea495905dde}");
+
+		RHI::CommandQueueType m_queue_type;
+		//! The number of times passes of this type are compiled.
+		u32 m_num_compiles = 0;
+	};
+
+	//! Every test pass copies its "src" input buffer to its "dst" output buffer, then writes the index of the output
+	//! resource to the element of the output buffer at the same index. If the optional "src2" input is connected, the
+	//! element at the index of "src2" is also copied from "src2". Buffers passed between test passes store one u32
+	//! element per resource of the render graph, and buffers of different sizes are copied up to the smaller size.
+	struct TestPass : RG::IRenderPass
+	{
+		lustruct("TestPass", "{8d67ce3c-16b5-4b08-ae9c-3b43c588ae72}");
+		luiimpl();
+
+		u32 m_marker;
+		u32 m_src2;
+		Ref<RHI::IBuffer> m_marker_buffer;
+
+		RV execute(RG::IRenderPassContext* ctx) override;
+	};
+
+	//! One pass recorded by `TestPass::execute`.
+	struct TestPassRecord
+	{
+		u32 marker;
+		RHI::ICommandBuffer* cmdbuf;
+	};
+
+	//! Registers "TestCopy", "TestComputeCopy" and "TestCopyQueueCopy" pass types, which prefer graphics, compute and
+	//! copy queues.
+	void register_test_pass_types();
+	TestPassType* get_test_pass_type(RHI::CommandQueueType queue_type);
+	//! Gets passes recorded since the last call to this function, in the recording order.
+	Vector<TestPassRecord> fetch_test_pass_records();
+
+	RG::RenderGraph* get_render_graph_impl(RG::IRenderGraph* graph);
+	//! Gets the index of the first command queue of the specified type.
+	u32 get_command_queue(RHI::CommandQueueType type);
+
+	//! Adds one resource to the render graph desc. Sizes of transient and persistent buffers are determined by
+	//! test passes.
+	usize add_test_resource(RG::RenderGraphDesc& desc, RG::RenderGraphResourceType type, RG::RenderGraphResourceFlag flags = RG::RenderGraphResourceFlag::none);
+	//! Adds one pass to the render graph desc.
+	usize add_test_pass(RG::RenderGraphDesc& desc, const Name& type, usize src, usize dst, usize src2 = RG::INVALID_RESOURCE);
+	//! Sets the size of every external buffer to store one element per resource. This should be called after all
+	//! resources are added.
+	void set_test_input_sizes(RG::RenderGraphDesc& desc);
+	//! Builds one render graph desc that connects `num_passes` "TestCopy" passes in a chain. Resource 0 is
+	//! one external input buffer, resource `i` is the output of pass `i - 1`, and the output of the last pass
+	//! is one persistent readback buffer.
+	RG::RenderGraphDesc new_test_chain_desc(usize num_passes);
+	//! Creates one upload buffer with `num_elements` u32 elements that are all set to `value`.
+	Ref<RHI::IBuffer> new_test_input_buffer(u32 num_elements, u32 value);
+	//! Executes the render graph on the graphics queue and checks the content of one persistent output buffer.
+	//! @param[in] expected The expected values of the first elements of the output buffer.
+	void execute_test_graph(RG::IRenderGraph* graph, usize output, Span<const u32> expected, Ref<RHI::ICommandBuffer>* out_cmdbuf = nullptr);
+
+	void segment_test();
+	void transient_memory_test();
+	void cross_queue_test();
+	void compile_cache_test();
+	void draw_test();
+}
@@ -0,0 +1,30 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file TestMain.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/RG/RG.hpp>
+using namespace Luna;
+
+int main()
+{
+	init();
+	set_log_to_platform_enabled(true);
+	lupanic_if_failed(add_modules({module_rg()}));
+	lupanic_if_failed(init_modules());
+	register_test_pass_types();
+	segment_test();
+	transient_memory_test();
+	cross_queue_test();
+	compile_cache_test();
+	draw_test();
+	close();
+	return 0;
+}
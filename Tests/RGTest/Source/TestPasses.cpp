@@ -0,0 +1,227 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file TestPasses.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+#include <Luna/Runtime/SpinLock.hpp>
+
+namespace Luna
+{
+	static TestPassType* g_test_pass_types[3];
+	static SpinLock g_records_lock;
+	static Vector<TestPassRecord> g_records;
+
+	RV TestPass::execute(RG::IRenderPassContext* ctx)
+	{
+		lutry
+		{
+			RHI::ICommandBuffer* cmdbuf = ctx->get_command_buffer();
+			Ref<RHI::IBuffer> src = ctx->get_input("src");
+			Ref<RHI::IBuffer> dst = ctx->get_output("dst");
+			lutest(src && dst);
+			if (!m_marker_buffer)
+			{
+				luset(m_marker_buffer, cmdbuf->get_device()->new_buffer(RHI::MemoryType::upload, RHI::BufferDesc(RHI::BufferUsageFlag::copy_source, sizeof(u32))));
+				u32* data;
+				luexp(m_marker_buffer->map(0, 0, (void**)&data));
+				*data = m_marker;
+				m_marker_buffer->unmap(0, sizeof(u32));
+			}
+			{
+				LockGuard guard(g_records_lock);
+				g_records.push_back({ m_marker, cmdbuf });
+			}
+			RHI::CopyPassDesc desc;
+			desc.timestamp_query_heap = ctx->get_timestamp_query_heap(&desc.timestamp_query_begin_pass_write_index, &desc.timestamp_query_end_pass_write_index);
+			cmdbuf->attach_device_object(m_marker_buffer);
+			cmdbuf->begin_copy_pass(desc);
+			cmdbuf->copy_buffer(dst, 0, src, 0, min(src->get_desc().size, dst->get_desc().size));
+			cmdbuf->copy_buffer(dst, m_marker * sizeof(u32), m_marker_buffer, 0, sizeof(u32));
+			if (m_src2 != U32_MAX)
+			{
+				Ref<RHI::IBuffer> src2 = ctx->get_input("src2");
+				lutest(src2);
+				cmdbuf->copy_buffer(dst, m_src2 * sizeof(u32), src2, m_src2 * sizeof(u32), sizeof(u32));
+			}
+			cmdbuf->end_copy_pass();
+		}
+		lucatchret;
+		return ok;
+	}
+
+	static RV compile_test_pass(object_t userdata, RG::IRenderGraphCompiler* compiler)
+	{
+		TestPassType* type = (TestPassType*)userdata;
+		++type->m_num_compiles;
+		usize src = compiler->get_input_resource("src");
+		usize src2 = compiler->get_input_resource("src2");
+		usize dst = compiler->get_output_resource("dst");
+		if (src == RG::INVALID_RESOURCE || dst == RG::INVALID_RESOURCE)
+		{
+			return set_error(BasicError::bad_arguments(), "TestPass: \"src\" and \"dst\" must be specified.");
+		}
+		RG::ResourceDesc src_desc = compiler->get_resource_desc(src);
+		RG::ResourceDesc dst_desc = compiler->get_resource_desc(dst);
+		// Sizes specified by the render graph desc are kept.
+		if (!dst_desc.buffer.size) dst_desc.buffer.size = src_desc.buffer.size;
+		dst_desc.buffer.usages |= RHI::BufferUsageFlag::copy_dest;
+		compiler->set_resource_desc(dst, dst_desc);
+		Ref<TestPass> pass = new_object<TestPass>();
+		pass->m_marker = (u32)dst;
+		pass->m_src2 = src2 == RG::INVALID_RESOURCE ? U32_MAX : (u32)src2;
+		compiler->set_render_pass_object(pass);
+		compiler->set_command_queue_type(type->m_queue_type);
+		return ok;
+	}
+
+	void register_test_pass_types()
+	{
+		register_boxed_type<TestPassType>();
+		register_boxed_type<TestPass>();
+		impl_interface_for_type<TestPass, RG::IRenderPass>();
+		const c8* names[] = { "TestCopy", "TestComputeCopy", "TestCopyQueueCopy" };
+		RHI::CommandQueueType queue_types[] = { RHI::CommandQueueType::graphics, RHI::CommandQueueType::compute, RHI::CommandQueueType::copy };
+		for (u32 i = 0; i < 3; ++i)
+		{
+			RG::RenderPassTypeDesc desc;
+			desc.name = names[i];
+			desc.desc = "Copies the source buffer to the destination buffer and writes one marker.";
+			desc.input_parameters.push_back({ "src", "The source buffer." });
+			desc.input_parameters.push_back({ "src2", "The optional buffer to copy the element at its resource index from." });
+			desc.output_parameters.push_back({ "dst", "The destination buffer." });
+			desc.compile = compile_test_pass;
+			auto data = new_object<TestPassType>();
+			data->m_queue_type = queue_types[i];
+			g_test_pass_types[i] = data.get();
+			desc.userdata = data.object();
+			RG::register_render_pass_type(desc);
+		}
+	}
+
+	TestPassType* get_test_pass_type(RHI::CommandQueueType queue_type)
+	{
+		switch (queue_type)
+		{
+		case RHI::CommandQueueType::compute: return g_test_pass_types[1];
+		case RHI::CommandQueueType::copy: return g_test_pass_types[2];
+		default: return g_test_pass_types[0];
+		}
+	}
+
+	Vector<TestPassRecord> fetch_test_pass_records()
+	{
+		LockGuard guard(g_records_lock);
+		Vector<TestPassRecord> r = move(g_records);
+		g_records = Vector<TestPassRecord>();
+		return r;
+	}
+
+	RG::RenderGraph* get_render_graph_impl(RG::IRenderGraph* graph)
+	{
+		return (RG::RenderGraph*)graph->get_object();
+	}
+
+	u32 get_command_queue(RHI::CommandQueueType type)
+	{
+		auto device = RHI::get_main_device();
+		u32 num_queues = device->get_num_command_queues();
+		for (u32 i = 0; i < num_queues; ++i)
+		{
+			if (device->get_command_queue_desc(i).type == type) return i;
+		}
+		return U32_MAX;
+	}
+
+	usize add_test_resource(RG::RenderGraphDesc& desc, RG::RenderGraphResourceType type, RG::RenderGraphResourceFlag flags)
+	{
+		RG::RenderGraphResourceNode node;
+		node.type = type;
+		node.flags = flags;
+		if (type == RG::RenderGraphResourceType::external)
+		{
+			node.desc = RG::ResourceDesc::as_buffer(RHI::MemoryType::upload, RHI::BufferDesc(RHI::BufferUsageFlag::copy_source, 0));
+		}
+		else if (type == RG::RenderGraphResourceType::persistent)
+		{
+			node.desc = RG::ResourceDesc::as_buffer(RHI::MemoryType::readback, RHI::BufferDesc(RHI::BufferUsageFlag::copy_dest, 0));
+		}
+		else
+		{
+			node.desc = RG::ResourceDesc::as_buffer(RHI::MemoryType::local, RHI::BufferDesc(RHI::BufferUsageFlag::copy_source | RHI::BufferUsageFlag::copy_dest, 0));
+		}
+		usize index = desc.resources.size();
+		c8 name[32];
+		snprintf(name, 32, "Resource%u", (u32)index);
+		node.name = name;
+		desc.resources.push_back(node);
+		return index;
+	}
+
+	usize add_test_pass(RG::RenderGraphDesc& desc, const Name& type, usize src, usize dst, usize src2)
+	{
+		usize index = desc.passes.size();
+		c8 name[32];
+		snprintf(name, 32, "Pass%u", (u32)index);
+		desc.passes.push_back({ name, type });
+		desc.input_connections.push_back({ index, "src", src });
+		if (src2 != RG::INVALID_RESOURCE) desc.input_connections.push_back({ index, "src2", src2 });
+		desc.output_connections.push_back({ index, "dst", dst });
+		return index;
+	}
+
+	RG::RenderGraphDesc new_test_chain_desc(usize num_passes)
+	{
+		RG::RenderGraphDesc desc;
+		add_test_resource(desc, RG::RenderGraphResourceType::external);
+		for (usize i = 0; i < num_passes; ++i)
+		{
+			bool last = i + 1 == num_passes;
+			usize dst = last ? add_test_resource(desc, RG::RenderGraphResourceType::persistent, RG::RenderGraphResourceFlag::output) :
+				add_test_resource(desc, RG::RenderGraphResourceType::transient);
+			add_test_pass(desc, "TestCopy", i, dst);
+		}
+		set_test_input_sizes(desc);
+		return desc;
+	}
+
+	void set_test_input_sizes(RG::RenderGraphDesc& desc)
+	{
+		for (auto& resource : desc.resources)
+		{
+			if (resource.type == RG::RenderGraphResourceType::external) resource.desc.buffer.size = desc.resources.size() * sizeof(u32);
+		}
+	}
+
+	Ref<RHI::IBuffer> new_test_input_buffer(u32 num_elements, u32 value)
+	{
+		RHI::BufferDesc desc(RHI::BufferUsageFlag::copy_source, num_elements * sizeof(u32));
+		auto buffer = RHI::get_main_device()->new_buffer(RHI::MemoryType::upload, desc).get();
+		u32* data;
+		lutest(succeeded(buffer->map(0, 0, (void**)&data)));
+		for (u32 i = 0; i < num_elements; ++i) data[i] = value;
+		buffer->unmap(0, num_elements * sizeof(u32));
+		return buffer;
+	}
+
+	void execute_test_graph(RG::IRenderGraph* graph, usize output, Span<const u32> expected, Ref<RHI::ICommandBuffer>* out_cmdbuf)
+	{
+		auto device = RHI::get_main_device();
+		auto cmdbuf = device->new_command_buffer(get_command_queue(RHI::CommandQueueType::graphics)).get();
+		lutest(succeeded(graph->execute(cmdbuf)));
+		lutest(succeeded(cmdbuf->submit({}, {}, true)));
+		cmdbuf->wait();
+		Ref<RHI::IBuffer> buffer = graph->get_persistent_resource(output);
+		lutest(buffer && buffer->get_desc().size >= expected.size() * sizeof(u32));
+		u32* data;
+		lutest(succeeded(buffer->map(0, expected.size() * sizeof(u32), (void**)&data)));
+		for (usize i = 0; i < expected.size(); ++i) lutest(data[i] == expected[i]);
+		buffer->unmap(0, 0);
+		if (out_cmdbuf) *out_cmdbuf = cmdbuf;
+	}
+}
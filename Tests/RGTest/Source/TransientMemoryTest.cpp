@@ -0,0 +1,65 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file TransientMemoryTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/RHI/Device.hpp>
+
+namespace Luna
+{
+	void transient_memory_test()
+	{
+		// E -> T1 -> T2 -> T3 -> T4 -> Out. Pass `i` writes resource `i + 1` and pass `i + 1` reads it, so the lifetime of
+		// Tn is [n - 1, n]. Sizes are aligned to 16 bytes so that the null backend allocates exactly the specified size.
+		constexpr usize NUM_TRANSIENTS = 4;
+		constexpr u64 sizes[NUM_TRANSIENTS] = { 128, 32, 32, 128 };
+		RG::RenderGraphDesc desc = new_test_chain_desc(NUM_TRANSIENTS + 1);
+		for (usize i = 0; i < NUM_TRANSIENTS; ++i) desc.resources[i + 1].desc.buffer.size = sizes[i];
+		constexpr u32 NUM_ELEMENTS = NUM_TRANSIENTS + 2;
+		auto graph = RG::new_render_graph(RHI::get_main_device());
+		graph->set_desc(desc);
+		lutest(succeeded(graph->compile({})));
+
+		// Resources are placed from the largest one: T1 and T4 share one slot. T2 overlaps T1 and T3 overlaps T2 and T4
+		// at their first and last passes, so they take one slot each.
+		RG::RenderGraph* impl = get_render_graph_impl(graph);
+		auto& data = impl->m_resource_data;
+		lutest(impl->m_transient_memory_slots.size() == 3);
+		lutest(data[1].m_memory_slot == data[4].m_memory_slot);
+		lutest(data[2].m_memory_slot != data[1].m_memory_slot && data[3].m_memory_slot != data[1].m_memory_slot);
+		lutest(data[2].m_memory_slot != data[3].m_memory_slot);
+		lutest(data[1].m_resource->get_memory() == data[4].m_resource->get_memory());
+		for (usize i = 0; i < NUM_TRANSIENTS; ++i)
+		{
+			lutest(data[i + 1].m_first_access == i && data[i + 1].m_last_access == i + 1);
+		}
+
+		// Every slot is as large as its largest resource, so the allocated size is greater than the peak size of
+		// transient resources that are alive at the same time (T1 + T2 or T3 + T4).
+		u64 peak_size = 0;
+		for (usize pass = 0; pass <= NUM_TRANSIENTS; ++pass)
+		{
+			u64 live_size = 0;
+			for (usize i = 0; i < NUM_TRANSIENTS; ++i)
+			{
+				if (data[i + 1].m_first_access <= pass && pass <= data[i + 1].m_last_access) live_size += sizes[i];
+			}
+			peak_size = max(peak_size, live_size);
+		}
+		lutest(peak_size == 160);
+		lutest(graph->get_allocated_transient_memory_size() == 192);
+
+		// Aliased resources still pass correct data.
+		u32 expected[NUM_ELEMENTS];
+		expected[0] = 200;
+		for (u32 i = 1; i < NUM_ELEMENTS; ++i) expected[i] = i;
+		graph->set_external_resource(0, new_test_input_buffer(NUM_ELEMENTS, expected[0]));
+		execute_test_graph(graph, NUM_TRANSIENTS + 1, { expected, NUM_ELEMENTS });
+		fetch_test_pass_records();
+	}
+}
@@ -0,0 +1,7 @@
+target("RGTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_headerfiles("Source/*.hpp")
+    add_files("Source/*.cpp")
+    add_deps("Runtime", "RHI", "RG")
+target_end()
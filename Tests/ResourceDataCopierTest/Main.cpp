@@ -0,0 +1,168 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/RHI/RHI.hpp>
+#include <Luna/RHI/Device.hpp>
+#include <Luna/RHI/Utility.hpp>
+// Checks staging rings of the copier using its internal states.
+#include <Luna/RHI/Source/CopyResourceData.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	// Ring sizes are rounded up to 64KB by the copier.
+	constexpr u64 RING_SIZE = 64 * 1024;
+
+	static Vector<u32> new_test_data(usize size, u32 seed)
+	{
+		Vector<u32> data(size / sizeof(u32));
+		for (usize i = 0; i < data.size(); ++i) data[i] = seed * 100003 + (u32)i;
+		return data;
+	}
+
+	static Ref<RHI::IBuffer> new_test_buffer(u64 size)
+	{
+		return RHI::get_main_device()->new_buffer(RHI::MemoryType::local,
+			RHI::BufferDesc(RHI::BufferUsageFlag::copy_source | RHI::BufferUsageFlag::copy_dest, size)).get();
+	}
+
+	//! Reads the buffer using the blocking copy function and compares it with `expected`.
+	static void check_buffer_data(RHI::IBuffer* buffer, const Vector<u32>& expected)
+	{
+		auto device = RHI::get_main_device();
+		auto cmdbuf = device->new_command_buffer(device->get_num_command_queues() - 1).get();
+		Vector<u32> data(expected.size());
+		lutest(succeeded(RHI::copy_resource_data(cmdbuf, { RHI::CopyResourceData::read_buffer(data.data(), buffer, 0, data.size() * sizeof(u32)) })));
+		lutest(!memcmp(data.data(), expected.data(), data.size() * sizeof(u32)));
+	}
+
+	static RHI::ResourceDataCopier* get_copier_impl(RHI::IResourceDataCopier* copier)
+	{
+		return (RHI::ResourceDataCopier*)copier->get_object();
+	}
+
+	void ring_test()
+	{
+		auto device = RHI::get_main_device();
+		auto copier = RHI::new_resource_data_copier(device, device->get_num_command_queues() - 1, RING_SIZE, RING_SIZE).get();
+		RHI::ResourceDataCopier* impl = get_copier_impl(copier);
+		lutest(impl->m_upload_ring.m_size == RING_SIZE && impl->m_readback_ring.m_size == RING_SIZE);
+		constexpr u64 COPY_SIZE = 24 * 1024;
+		Ref<RHI::IBuffer> buffers[3];
+		Vector<u32> data[3];
+		u64 tickets[3];
+		for (u32 i = 0; i < 3; ++i)
+		{
+			buffers[i] = new_test_buffer(COPY_SIZE);
+			data[i] = new_test_data(COPY_SIZE, i);
+		}
+		// The first two copies fit in the ring and are recorded to one batch without being submitted.
+		for (u32 i = 0; i < 2; ++i)
+		{
+			tickets[i] = copier->copy_resource_data({ RHI::CopyResourceData::write_buffer(buffers[i], 0, data[i].data(), COPY_SIZE) }).get();
+		}
+		lutest(tickets[0] == tickets[1]);
+		lutest(!copier->is_completed(tickets[0]));
+		lutest(impl->m_upload_ring.m_head == COPY_SIZE * 2 && impl->m_upload_ring.m_tail == 0);
+		// The third copy cannot fit at the end of the ring, so the batch is submitted and retired, and the copy wraps around
+		// to the beginning of the ring. Source data can be released after recording.
+		tickets[2] = copier->copy_resource_data({ RHI::CopyResourceData::write_buffer(buffers[2], 0, data[2].data(), COPY_SIZE) }).get();
+		lutest(tickets[2] > tickets[0]);
+		lutest(copier->is_completed(tickets[0]));
+		lutest(impl->m_upload_ring.m_tail == RING_SIZE && impl->m_upload_ring.m_head == RING_SIZE + COPY_SIZE);
+		data[2].clear();
+		lutest(succeeded(copier->flush()));
+		lutest(succeeded(copier->wait(tickets[2])));
+		lutest(copier->is_completed(tickets[2]));
+		lutest(impl->m_batches.empty() && impl->m_upload_ring.m_tail == impl->m_upload_ring.m_head);
+		check_buffer_data(buffers[0], data[0]);
+		check_buffer_data(buffers[1], data[1]);
+		check_buffer_data(buffers[2], new_test_data(COPY_SIZE, 2));
+	}
+
+	void oversized_copy_test()
+	{
+		auto device = RHI::get_main_device();
+		auto copier = RHI::new_resource_data_copier(device, device->get_num_command_queues() - 1, RING_SIZE, RING_SIZE).get();
+		RHI::ResourceDataCopier* impl = get_copier_impl(copier);
+		// Copies larger than the ring use temporary staging buffers and do not use ring space.
+		constexpr u64 COPY_SIZE = RING_SIZE + 36 * 1024;
+		auto buffer = new_test_buffer(COPY_SIZE);
+		Vector<u32> data = new_test_data(COPY_SIZE, 3);
+		u64 write_ticket = copier->copy_resource_data({ RHI::CopyResourceData::write_buffer(buffer, 0, data.data(), COPY_SIZE) }).get();
+		lutest(impl->m_upload_ring.m_head == 0);
+		Vector<u32> read_data(data.size());
+		u64 read_ticket = copier->copy_resource_data({ RHI::CopyResourceData::read_buffer(read_data.data(), buffer, 0, COPY_SIZE) }).get();
+		lutest(impl->m_readback_ring.m_head == 0);
+		lutest(read_ticket == write_ticket);
+		lutest(succeeded(copier->wait(read_ticket)));
+		lutest(!memcmp(read_data.data(), data.data(), COPY_SIZE));
+	}
+
+	void readback_test()
+	{
+		auto device = RHI::get_main_device();
+		auto copier = RHI::new_resource_data_copier(device, device->get_num_command_queues() - 1, RING_SIZE, RING_SIZE).get();
+		RHI::ResourceDataCopier* impl = get_copier_impl(copier);
+		constexpr u64 COPY_SIZE = 24 * 1024;
+		Ref<RHI::IBuffer> buffers[4];
+		Vector<u32> data[4];
+		for (u32 i = 0; i < 4; ++i)
+		{
+			buffers[i] = new_test_buffer(COPY_SIZE);
+			data[i] = new_test_data(COPY_SIZE, 10 + i);
+			lutest(succeeded(copier->copy_resource_data({ RHI::CopyResourceData::write_buffer(buffers[i], 0, data[i].data(), COPY_SIZE) })));
+		}
+		// Reads buffers written by the same batch, including one partial range.
+		constexpr u64 READ_OFFSET = 4 * 1024;
+		Vector<u32> read_data[2];
+		read_data[0].resize((COPY_SIZE - READ_OFFSET) / sizeof(u32), 0);
+		read_data[1].resize(COPY_SIZE / sizeof(u32), 0);
+		u64 ticket = copier->copy_resource_data({
+			RHI::CopyResourceData::read_buffer(read_data[0].data(), buffers[0], READ_OFFSET, COPY_SIZE - READ_OFFSET),
+			RHI::CopyResourceData::read_buffer(read_data[1].data(), buffers[1], 0, COPY_SIZE) }).get();
+		lutest(impl->m_readback_ring.m_head == COPY_SIZE * 2 - READ_OFFSET);
+		// Read copies are not performed until the batch is submitted and retired.
+		lutest(!copier->is_completed(ticket) && read_data[1][0] == 0);
+		lutest(succeeded(copier->flush()));
+		while (!copier->is_completed(ticket)) {}
+		lutest(!memcmp(read_data[0].data(), data[0].data() + READ_OFFSET / sizeof(u32), COPY_SIZE - READ_OFFSET));
+		lutest(!memcmp(read_data[1].data(), data[1].data(), COPY_SIZE));
+		// The empty ring restarts from the next buffer boundary, and the third read wraps around the ring.
+		Vector<u32> wrap_read_data[3];
+		u64 tickets[3];
+		for (u32 i = 0; i < 3; ++i)
+		{
+			wrap_read_data[i].resize(COPY_SIZE / sizeof(u32), 0);
+			tickets[i] = copier->copy_resource_data({ RHI::CopyResourceData::read_buffer(wrap_read_data[i].data(), buffers[i + 1], 0, COPY_SIZE) }).get();
+		}
+		lutest(tickets[0] == tickets[1] && tickets[2] > tickets[1]);
+		lutest(copier->is_completed(tickets[0]));
+		lutest(impl->m_readback_ring.m_tail == RING_SIZE * 2 && impl->m_readback_ring.m_head == RING_SIZE * 2 + COPY_SIZE);
+		lutest(succeeded(copier->wait(tickets[2])));
+		for (u32 i = 0; i < 3; ++i) lutest(!memcmp(wrap_read_data[i].data(), data[i + 1].data(), COPY_SIZE));
+	}
+}
+
+int main()
+{
+	Luna::init();
+	Luna::set_log_to_platform_enabled(true);
+	lupanic_if_failed(Luna::add_modules({Luna::module_rhi()}));
+	lupanic_if_failed(Luna::init_modules());
+	Luna::ring_test();
+	Luna::oversized_copy_test();
+	Luna::readback_test();
+	Luna::close();
+	return 0;
+}
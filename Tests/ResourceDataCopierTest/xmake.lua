@@ -0,0 +1,6 @@
+target("ResourceDataCopierTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_files("*.cpp")
+    add_deps("Runtime", "RHI")
+target_end()
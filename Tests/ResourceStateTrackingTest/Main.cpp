@@ -0,0 +1,123 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file Main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/RHI/RHI.hpp>
+#include <Luna/RHI/Device.hpp>
+// Checks tracking slots using internal states of the Vulkan backend.
+#include <Luna/RHI/Source/Vulkan/CommandBuffer.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	static u32 get_graphics_queue(RHI::IDevice* device)
+	{
+		u32 num_queues = device->get_num_command_queues();
+		for (u32 i = 0; i < num_queues; ++i)
+		{
+			if (device->get_command_queue_desc(i).type == RHI::CommandQueueType::graphics) return i;
+		}
+		return U32_MAX;
+	}
+
+	static RHI::ResourceStateTrackingSystem& get_track_system(RHI::ICommandBuffer* cmdbuf)
+	{
+		return ((RHI::CommandBuffer*)cmdbuf->get_object())->m_track_system;
+	}
+
+	//! Gets the tag of the tracking system that claims the resource, or 0 if the resource is not claimed.
+	static u32 get_claiming_tag(RHI::BufferResource* res)
+	{
+		return (u32)(res->m_tracking_slot >> 32);
+	}
+	static u32 get_claiming_tag(RHI::ImageResource* res)
+	{
+		return (u32)(res->m_tracking_slot >> 32);
+	}
+
+	static void transit(RHI::ICommandBuffer* cmdbuf, RHI::IBuffer* buffer, RHI::BufferStateFlag buffer_state,
+		RHI::ITexture* texture, RHI::TextureStateFlag texture_state)
+	{
+		cmdbuf->resource_barrier(
+			{ { buffer, RHI::BufferStateFlag::automatic, buffer_state } },
+			{ { texture, RHI::TEXTURE_BARRIER_ALL_SUBRESOURCES, RHI::TextureStateFlag::automatic, texture_state } });
+	}
+
+	void concurrent_tracking_test()
+	{
+		auto device = RHI::get_main_device();
+		u32 queue = get_graphics_queue(device);
+		auto buffer = device->new_buffer(RHI::MemoryType::local,
+			RHI::BufferDesc(RHI::BufferUsageFlag::copy_source | RHI::BufferUsageFlag::copy_dest, 256)).get();
+		auto texture = device->new_texture(RHI::MemoryType::local,
+			RHI::TextureDesc::tex2d(RHI::Format::rgba8_unorm, RHI::TextureUsageFlag::copy_source | RHI::TextureUsageFlag::copy_dest, 4, 4, 1, 1)).get();
+		RHI::BufferResource* buffer_res = (RHI::BufferResource*)buffer->get_object();
+		RHI::ImageResource* image_res = (RHI::ImageResource*)texture->get_object();
+		auto a = device->new_command_buffer(queue).get();
+		auto b = device->new_command_buffer(queue).get();
+		auto& track_a = get_track_system(a);
+		auto& track_b = get_track_system(b);
+		lutest(track_a.m_tracking_tag != track_b.m_tracking_tag);
+
+		// The first command buffer claims both resources, and does not use fallback tables.
+		transit(a, buffer, RHI::BufferStateFlag::copy_dest, texture, RHI::TextureStateFlag::copy_dest);
+		lutest(get_claiming_tag(buffer_res) == track_a.m_tracking_tag && get_claiming_tag(image_res) == track_a.m_tracking_tag);
+		lutest(track_a.m_buffer_slot_map.empty() && track_a.m_image_slot_map.empty());
+
+		// The second command buffer that records at the same time cannot claim the resources, so it uses fallback
+		// tables, and the claims of the first command buffer are kept.
+		transit(b, buffer, RHI::BufferStateFlag::copy_dest, texture, RHI::TextureStateFlag::copy_dest);
+		lutest(get_claiming_tag(buffer_res) == track_a.m_tracking_tag && get_claiming_tag(image_res) == track_a.m_tracking_tag);
+		lutest(track_b.m_buffer_slot_map.size() == 1 && track_b.m_image_slot_map.size() == 1);
+
+		// Both command buffers find their own slots for the next transition.
+		transit(a, buffer, RHI::BufferStateFlag::copy_source, texture, RHI::TextureStateFlag::copy_source);
+		transit(b, buffer, RHI::BufferStateFlag::copy_source, texture, RHI::TextureStateFlag::copy_source);
+		lutest(track_a.m_buffer_slots.size() == 1 && track_a.m_image_slots.size() == 1);
+		lutest(track_b.m_buffer_slots.size() == 1 && track_b.m_image_slots.size() == 1);
+		lutest(track_a.m_buffer_slots[0].m_state == RHI::BufferStateFlag::copy_source);
+		lutest(track_b.m_buffer_slots[0].m_state == RHI::BufferStateFlag::copy_source);
+		lutest(track_a.m_image_slots[0].m_whole_resource && track_a.m_image_slots[0].m_state == RHI::TextureStateFlag::copy_source);
+
+		// Claims are released when the command buffer is submitted.
+		lutest(succeeded(a->submit({}, {}, true)));
+		a->wait();
+		lutest(get_claiming_tag(buffer_res) == 0 && get_claiming_tag(image_res) == 0);
+		lutest(succeeded(b->submit({}, {}, true)));
+		b->wait();
+		lutest(get_claiming_tag(buffer_res) == 0 && get_claiming_tag(image_res) == 0);
+
+		// One command buffer that is reset without being submitted does not keep its claims live, so the claims
+		// can be overwritten by other command buffers.
+		lutest(succeeded(a->reset()));
+		lutest(succeeded(b->reset()));
+		transit(a, buffer, RHI::BufferStateFlag::copy_dest, texture, RHI::TextureStateFlag::copy_dest);
+		lutest(get_claiming_tag(buffer_res) == track_a.m_tracking_tag);
+		lutest(succeeded(a->reset()));
+		transit(b, buffer, RHI::BufferStateFlag::copy_dest, texture, RHI::TextureStateFlag::copy_dest);
+		lutest(get_claiming_tag(buffer_res) == track_b.m_tracking_tag && get_claiming_tag(image_res) == track_b.m_tracking_tag);
+		lutest(track_b.m_buffer_slot_map.empty() && track_b.m_image_slot_map.empty());
+		lutest(succeeded(b->submit({}, {}, true)));
+		b->wait();
+	}
+}
+
+int main()
+{
+	Luna::init();
+	Luna::set_log_to_platform_enabled(true);
+	lupanic_if_failed(Luna::add_modules({Luna::module_rhi()}));
+	lupanic_if_failed(Luna::init_modules());
+	Luna::concurrent_tracking_test();
+	Luna::close();
+	return 0;
+}
@@ -0,0 +1,8 @@
+target("ResourceStateTrackingTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_files("*.cpp")
+    add_deps("Runtime", "RHI")
+    -- Internal headers of the Vulkan backend are included.
+    add_packages("volk", "vulkan-memory-allocator")
+target_end()
@@ -9,6 +9,9 @@
 */
 #include "TestCommon.hpp"
 #include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/AsyncFile.hpp>
+#include <Luna/Runtime/Atomic.hpp>
+#include <Luna/Runtime/FileWatcher.hpp>
 
 namespace Luna
 {
@@ -32,10 +35,129 @@ namespace Luna
 			lutest(succeeded(file->read(str, 13 * sizeof(char))));
 			str[13] = 0;
 			lutest(!strcmp(s, str));
+
+			// Map the file and checks the mapped data.
+			auto mapping = map_file(file).get();
+			lutest(mapping->get_size() == 13);
+			lutest(!memcmp(mapping->get_data(), s, 13));
+			auto sub_mapping = map_file(file, 7, 6).get();
+			lutest(sub_mapping->get_size() == 6);
+			lutest(!memcmp(sub_mapping->get_data(), "String", 6));
+			lutest(map_file(file, 7, 7).errcode() == BasicError::out_of_range());
+			file = nullptr;
+
+			// The mapping is still valid after the file is closed, and copy-on-write
+			// modifications are not written back.
+			lutest(!memcmp(mapping->get_data(), s, 13));
+			file = open_file("SampleFile.txt",
+				FileOpenFlag::read, FileCreationMode::open_existing).get();
+			auto cow_mapping = map_file(file, 0, USIZE_MAX, FileMapFlag::copy_on_write).get();
+			cow_mapping->get_data()[0] = 'X';
+			lutest(mapping->get_data()[0] == 'S');
+			lutest(succeeded(file->read(str, 13 * sizeof(char))));
+			lutest(str[0] == 'S');
+			cow_mapping = nullptr;
+			sub_mapping = nullptr;
+			mapping = nullptr;
 			file = nullptr;
 
 			// Clean up.
 			lutest(succeeded(delete_file("SampleFile.txt")));
 		}
+
+		{
+			// Write and read one file asynchronously.
+			constexpr usize num_chunks = 16;
+			constexpr usize chunk_size = 4096;
+			Vector<u32> data(num_chunks * chunk_size / sizeof(u32));
+			for (usize i = 0; i < data.size(); ++i) data[i] = (u32)i;
+			auto file = open_file("AsyncFile.bin",
+				FileOpenFlag::read | FileOpenFlag::write, FileCreationMode::create_always).get();
+			FileIORequest requests[num_chunks];
+			for (usize i = 0; i < num_chunks; ++i)
+			{
+				// Write chunks in reverse order to test positional writes.
+				usize chunk = num_chunks - i - 1;
+				requests[i] = { file, chunk * chunk_size, (u8*)data.data() + chunk * chunk_size, chunk_size, FileIOOp::write };
+			}
+			auto write_batch = submit_file_io({ requests, num_chunks }).get();
+			write_batch->wait();
+			lutest(write_batch->is_finished());
+			for (usize i = 0; i < num_chunks; ++i)
+			{
+				lutest(succeeded(write_batch->get_result(i)));
+				lutest(write_batch->get_transferred_bytes(i) == chunk_size);
+			}
+			lutest(file->get_size() == num_chunks * chunk_size);
+
+			Vector<u32> read_data(data.size() + 16);
+			for (usize i = 0; i < num_chunks; ++i)
+			{
+				requests[i] = { file, i * chunk_size, (u8*)read_data.data() + i * chunk_size, chunk_size, FileIOOp::read };
+			}
+			// Reads beyond the end of the file.
+			requests[num_chunks - 1].size = chunk_size + 64;
+			volatile usize num_callbacks = 0;
+			auto read_batch = submit_file_io({ requests, num_chunks }, [&num_callbacks](usize index, RV result, usize transferred_bytes)
+				{
+					atom_inc_usize(&num_callbacks);
+				}).get();
+			read_batch->wait();
+			lutest(num_callbacks == num_chunks);
+			lutest(read_batch->get_transferred_bytes(num_chunks - 1) == chunk_size);
+			lutest(!memcmp(data.data(), read_data.data(), data.size() * sizeof(u32)));
+			read_batch = nullptr;
+			write_batch = nullptr;
+			file = nullptr;
+			lutest(succeeded(delete_file("AsyncFile.bin")));
+		}
+
+		{
+			// Watch one directory for file changes.
+			lutest(succeeded(create_dir("WatchedDir")));
+			auto watcher = watch_dir("WatchedDir");
+			if (succeeded(watcher))
+			{
+				auto file = open_file("WatchedDir/WatchedFile.txt", FileOpenFlag::write, FileCreationMode::create_always).get();
+				lutest(succeeded(file->write(s, sizeof(s) - sizeof(char))));
+				file = nullptr;
+				lutest(succeeded(create_dir("WatchedDir/SubDir")));
+				file = open_file("WatchedDir/SubDir/WatchedFile.txt", FileOpenFlag::write, FileCreationMode::create_always).get();
+				file = nullptr;
+				lutest(succeeded(delete_file("WatchedDir/WatchedFile.txt")));
+				Vector<FileChange> changes;
+				lutest(succeeded(watcher.get()->read_changes(changes)));
+				bool file_added = false;
+				bool file_modified = false;
+				bool file_removed = false;
+				bool subdir_file_added = false;
+				for (auto& change : changes)
+				{
+					if (change.path == "WatchedFile.txt")
+					{
+						file_added |= change.type == FileChangeType::added;
+						file_modified |= change.type == FileChangeType::modified;
+						file_removed |= change.type == FileChangeType::removed;
+					}
+					else if (change.path == "SubDir/WatchedFile.txt")
+					{
+						subdir_file_added |= change.type == FileChangeType::added;
+					}
+				}
+				lutest(file_added && file_modified && file_removed && subdir_file_added);
+				// All changes are fetched.
+				changes.clear();
+				lutest(succeeded(watcher.get()->read_changes(changes)));
+				lutest(changes.empty());
+			}
+			else
+			{
+				lutest(watcher.errcode() == BasicError::not_supported());
+			}
+			watcher = BasicError::not_supported();
+			lutest(succeeded(delete_file("WatchedDir/SubDir/WatchedFile.txt")));
+			lutest(succeeded(delete_file("WatchedDir/SubDir")));
+			lutest(succeeded(delete_file("WatchedDir")));
+		}
 	}
 }
\ No newline at end of file
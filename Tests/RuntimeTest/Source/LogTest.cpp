@@ -0,0 +1,200 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file LogTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/Runtime/Thread.hpp>
+#include <Luna/Runtime/Vector.hpp>
+
+namespace Luna
+{
+	constexpr u32 LOG_TEST_NUM_THREADS = 4;
+	constexpr u32 LOG_TEST_NUM_LOGS = 1000;
+
+	static u32 g_log_test_count;
+	static u32 g_log_test_next_index[LOG_TEST_NUM_THREADS];
+	static bool g_log_test_in_order;
+	static usize g_log_test_long_message_length;
+
+	static void log_test_handler(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	{
+		if (strcmp(tag, "LogTest")) return;
+		if (message[0] == 'L')
+		{
+			g_log_test_long_message_length = message_length;
+			return;
+		}
+		u32 thread_index, log_index;
+		if (sscanf(message, "%u:%u", &thread_index, &log_index) != 2 || thread_index >= LOG_TEST_NUM_THREADS) return;
+		if (g_log_test_next_index[thread_index] != log_index) g_log_test_in_order = false;
+		g_log_test_next_index[thread_index] = log_index + 1;
+		++g_log_test_count;
+	}
+
+	static void log_test_thread(void* params)
+	{
+		u32 thread_index = (u32)(usize)params;
+		for (u32 i = 0; i < LOG_TEST_NUM_LOGS; ++i)
+		{
+			log_verbose("LogTest", "%u:%u", thread_index, i);
+		}
+	}
+
+	static bool g_log_test_record_received;
+
+	static void log_test_record_handler(const LogRecord& record)
+	{
+		if (strcmp(record.tag, "LogTest")) return;
+		c8 buf[64];
+		usize len = format_log_record(record, buf, 64);
+		lutest(len == 31);
+		lutest(!strcmp(buf, "Record 42 -7 1.50 str 0x1f 100%"));
+		g_log_test_record_received = true;
+	}
+
+	static void structured_log_test()
+	{
+		// Formats one record with truncated buffer.
+		{
+			u8 args[64];
+			u8* dst = args;
+			Impl::encode_log_arg(dst, 12345);
+			Impl::encode_log_arg(dst, "abcdef");
+			LogRecord record;
+			record.verbosity = LogVerbosity::info;
+			record.tag = "LogTest";
+			record.format = "%05d:%.3s";
+			record.args = args;
+			record.args_size = dst - args;
+			c8 buf[8];
+			lutest(format_log_record(record, buf, 8) == 9);
+			lutest(!strcmp(buf, "12345:a"));
+		}
+		// No handler accepts verbose logs by default.
+		lutest(!is_log_verbosity_enabled(LogVerbosity::verbose));
+		g_log_test_record_received = false;
+		usize handler = register_log_record_handler(log_test_record_handler, LogVerbosity::debug);
+		lutest(is_log_verbosity_enabled(LogVerbosity::debug));
+		lutest(!is_log_verbosity_enabled(LogVerbosity::verbose));
+		log_record(LogVerbosity::debug, "LogTest", "Record %d %lld %.2f %s 0x%x 100%%", 42, (i64)-7, 1.5f, "str", 31u);
+		lutest(g_log_test_record_received);
+		unregister_log_handler(handler);
+	}
+
+	static void log_test_toggle_thread(void* params)
+	{
+		for (u32 i = 0; i < 100; ++i)
+		{
+			set_log_async_enabled(true);
+			log_verbose("LogTest", "Toggle");
+			set_log_async_enabled(false);
+		}
+	}
+
+	static void log_test_reentrant_handler(LogVerbosity verbosity, const c8* tag, usize tag_length, const c8* message, usize message_length)
+	{
+		if (strcmp(tag, "LogTest") || strcmp(message, "Reentrant")) return;
+		// Logs more than the queue can hold while the log mutex is held by the dispatching thread.
+		for (u32 i = 0; i < 100; ++i)
+		{
+			log_verbose("LogTest", "R%0199d", i);
+		}
+	}
+
+	static void reentrant_block_test()
+	{
+		// Logs from handlers on the synchronous path must be dropped instead of waiting for the logger thread.
+		set_log_async_enabled(true);
+		usize handler = register_log_handler(log_test_reentrant_handler);
+		u64 dropped_count = get_log_dropped_count();
+		log(LogVerbosity::fatal_error, "LogTest", "Reentrant");
+		lutest(get_log_dropped_count() > dropped_count);
+		unregister_log_handler(handler);
+		set_log_async_enabled(false);
+	}
+
+	static void log_test_oversized_thread(void* params)
+	{
+		// Moves the write position to the middle of the new queue, then logs messages that can fit neither in the 
+		// tail nor in the head of the queue without being truncated.
+		log_verbose("LogTest", "P%01899d", 0);
+		flush_log();
+		Vector<c8> message(3_kb, 'L');
+		message.push_back(0);
+		log_verbose("LogTest", "%s", message.data());
+		flush_log();
+		lutest(g_log_test_long_message_length == 2_kb - 16 - 7 - 2);
+		g_log_test_long_message_length = 0;
+		set_log_async_queue_full_policy(LogQueueFullPolicy::drop);
+		u64 dropped_count = get_log_dropped_count();
+		log_verbose("LogTest", "%s", message.data());
+		flush_log();
+		lutest(g_log_test_long_message_length == 2_kb - 16 - 7 - 2);
+		lutest(get_log_dropped_count() == dropped_count);
+		// Records that cannot fit in half of the queue are dropped.
+		log_record(LogVerbosity::verbose, "LogTest", "%s", message.data());
+		lutest(get_log_dropped_count() == dropped_count + 1);
+		set_log_async_queue_full_policy(LogQueueFullPolicy::block);
+	}
+
+	static void oversized_message_test()
+	{
+		// Messages larger than half of the queue are truncated so that they always fit in one empty queue.
+		g_log_test_long_message_length = 0;
+		auto t = new_thread(log_test_oversized_thread, nullptr);
+		t->wait();
+	}
+
+	static void async_toggle_test()
+	{
+		// Concurrent enabling and disabling must not leak logger threads or hang.
+		Vector<Ref<IThread>> threads;
+		for (u32 i = 0; i < 2; ++i)
+		{
+			threads.push_back(new_thread(log_test_toggle_thread, nullptr));
+		}
+		for (auto& t : threads) t->wait();
+		set_log_async_enabled(false);
+	}
+
+	void log_test()
+	{
+		set_log_to_platform_enabled(false);
+		structured_log_test();
+		g_log_test_count = 0;
+		g_log_test_in_order = true;
+		memzero(g_log_test_next_index, sizeof(g_log_test_next_index));
+		usize handler = register_log_handler(log_test_handler);
+		set_log_async_queue_size(4_kb);
+		set_log_async_queue_full_policy(LogQueueFullPolicy::block);
+		set_log_async_enabled(true);
+		{
+			Vector<Ref<IThread>> threads;
+			for (u32 i = 0; i < LOG_TEST_NUM_THREADS; ++i)
+			{
+				threads.push_back(new_thread(log_test_thread, (void*)(usize)i));
+			}
+			for (auto& t : threads) t->wait();
+		}
+		// Long messages are formatted directly into the queue.
+		log_verbose("LogTest", "L%0999d", 0);
+		flush_log();
+		lutest(g_log_test_count == LOG_TEST_NUM_THREADS * LOG_TEST_NUM_LOGS);
+		lutest(g_log_test_in_order);
+		lutest(g_log_test_long_message_length == 1000);
+		oversized_message_test();
+		set_log_async_enabled(false);
+		async_toggle_test();
+		reentrant_block_test();
+		set_log_async_queue_full_policy(LogQueueFullPolicy::drop);
+		set_log_async_queue_size(64_kb);
+		unregister_log_handler(handler);
+		set_log_to_platform_enabled(true);
+	}
+}
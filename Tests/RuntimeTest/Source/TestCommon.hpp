@@ -34,6 +34,7 @@ namespace Luna
 	void invoke_test();
 	void function_test();
 	void unicode_test();
+	void log_test();
 
 	// STL test framework modified from EASTL.
 
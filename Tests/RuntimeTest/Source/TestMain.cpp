@@ -35,6 +35,7 @@ void run()
 	invoke_test();
 	function_test();
 	unicode_test();
+	log_test();
 	unregister_profiler_callback(handle);
 }
 
@@ -0,0 +1,91 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file CookedAssetCacheTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <CookedAssetCache.hpp>
+#include <Luna/Runtime/Vector.hpp>
+
+namespace Luna
+{
+	static bool check_cooked_asset(u64 key, const void* data, usize size)
+	{
+		auto mapping = load_cooked_asset(key);
+		if (failed(mapping)) return false;
+		lutest(((usize)mapping.get()->get_data() % COOKED_ASSET_PAYLOAD_ALIGNMENT) == 0);
+		return mapping.get()->get_size() == size && !memcmp(mapping.get()->get_data(), data, size);
+	}
+
+	static String get_test_cooked_file_path(u64 key)
+	{
+		c8 path[64];
+		snprintf(path, 64, "CookedAssetCacheTest/%016llx.bin", (unsigned long long)key);
+		return path;
+	}
+
+	void cooked_asset_cache_test()
+	{
+		const c8 source[] = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+		u64 key = calc_cooked_asset_key(source, sizeof(source), "TestCooker 1");
+		lutest(key != calc_cooked_asset_key(source, sizeof(source), "TestCooker 2"));
+		lutest(key != calc_cooked_asset_key(source, sizeof(source) - 1, "TestCooker 1"));
+
+		lutest(succeeded(init_cooked_asset_cache("CookedAssetCacheTest")));
+		lutest(load_cooked_asset(key).errcode() == BasicError::not_found());
+
+		Vector<u32> payload_a(1000);
+		Vector<u32> payload_b(3000);
+		for (usize i = 0; i < payload_a.size(); ++i) payload_a[i] = (u32)i;
+		for (usize i = 0; i < payload_b.size(); ++i) payload_b[i] = (u32)(i * 7 + 1);
+		usize size_a = payload_a.size() * sizeof(u32);
+		usize size_b = payload_b.size() * sizeof(u32);
+
+		lutest(succeeded(save_cooked_asset(key, payload_a.data(), size_a)));
+		lutest(check_cooked_asset(key, payload_a.data(), size_a));
+
+		// Re-cooking replaces the existing payload.
+		lutest(succeeded(save_cooked_asset(key, payload_b.data(), size_b)));
+		lutest(check_cooked_asset(key, payload_b.data(), size_b));
+
+		// Re-cooking while the old payload is mapped.
+		{
+			auto mapping = load_cooked_asset(key);
+			lutest(succeeded(mapping));
+			lutest(succeeded(save_cooked_asset(key, payload_a.data(), size_a)));
+			lutest(check_cooked_asset(key, payload_a.data(), size_a));
+		}
+
+		// Corrupted payloads are treated as missing, and are replaced when cooked again.
+		String path = get_test_cooked_file_path(key);
+		{
+			auto file = open_file(path.c_str(), FileOpenFlag::write, FileCreationMode::open_existing_as_new);
+			lutest(succeeded(file));
+			lutest(succeeded(file.get()->write(source, sizeof(source))));
+		}
+		lutest(load_cooked_asset(key).errcode() == BasicError::not_found());
+		lutest(succeeded(save_cooked_asset(key, payload_b.data(), size_b)));
+		lutest(check_cooked_asset(key, payload_b.data(), size_b));
+
+		// No temporary file is left in the cache directory.
+		{
+			auto iter = open_dir("CookedAssetCacheTest");
+			lutest(succeeded(iter));
+			usize num_files = 0;
+			for (auto& it = iter.get(); it->is_valid(); it->move_next())
+			{
+				if (!strcmp(it->get_filename(), ".") || !strcmp(it->get_filename(), "..")) continue;
+				++num_files;
+			}
+			lutest(num_files == 1);
+		}
+
+		close_cooked_asset_cache();
+		lutest(succeeded(delete_file(path.c_str())));
+		lutest(succeeded(delete_file("CookedAssetCacheTest")));
+	}
+}
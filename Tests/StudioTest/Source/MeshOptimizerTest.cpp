@@ -0,0 +1,163 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+*
+* @file MeshOptimizerTest.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <MeshOptimizer.hpp>
+#include <Luna/Runtime/Algorithm.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <math.h>
+
+namespace Luna
+{
+	//! One triangle identified by the original indices of its vertices, rotated so that the smallest index comes
+	//! first without changing the winding order.
+	struct TriangleKey
+	{
+		u32 v[3];
+
+		bool operator<(const TriangleKey& rhs) const
+		{
+			return v[0] != rhs.v[0] ? v[0] < rhs.v[0] : (v[1] != rhs.v[1] ? v[1] < rhs.v[1] : v[2] < rhs.v[2]);
+		}
+		bool operator==(const TriangleKey& rhs) const
+		{
+			return v[0] == rhs.v[0] && v[1] == rhs.v[1] && v[2] == rhs.v[2];
+		}
+	};
+
+	//! Collects triangles of one piece. The original index of every vertex is stored in `color.x`.
+	static Vector<TriangleKey> get_piece_triangles(const u32* indices, const MeshPiece& piece, const Vertex* vertices)
+	{
+		Vector<TriangleKey> triangles;
+		for (u32 i = piece.first_index_offset; i < piece.first_index_offset + piece.num_indices; i += 3)
+		{
+			u32 v[3];
+			for (u32 j = 0; j < 3; ++j) v[j] = (u32)vertices[indices[i + j]].color.x;
+			u32 first = v[0] <= v[1] && v[0] <= v[2] ? 0 : (v[1] <= v[2] ? 1 : 2);
+			TriangleKey key;
+			for (u32 j = 0; j < 3; ++j) key.v[j] = v[(first + j) % 3];
+			triangles.push_back(key);
+		}
+		sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	void mesh_optimizer_test()
+	{
+		// Builds a bumpy sphere, which is concave in many places so that the triangle order affects overdraw.
+		constexpr u32 NUM_RINGS = 48;
+		constexpr u32 NUM_SEGMENTS = 96;
+		constexpr f32 PI = 3.14159265f;
+		Vector<Vertex> vertices;
+		for (u32 i = 0; i <= NUM_RINGS; ++i)
+		{
+			for (u32 j = 0; j <= NUM_SEGMENTS; ++j)
+			{
+				f32 theta = PI * (f32)i / (f32)NUM_RINGS;
+				f32 phi = 2.0f * PI * (f32)j / (f32)NUM_SEGMENTS;
+				f32 r = 1.0f + 0.3f * sinf(6.0f * theta) * sinf(6.0f * phi);
+				Vertex v;
+				memzero(&v, sizeof(Vertex));
+				v.position = Float3U(r * sinf(theta) * cosf(phi), r * cosf(theta), r * sinf(theta) * sinf(phi));
+				v.color = Float4U((f32)vertices.size(), 0.0f, 0.0f, 1.0f);
+				vertices.push_back(v);
+			}
+		}
+		// One vertex that is not referred by any triangle, which should be removed.
+		Vertex unused_vertex;
+		memzero(&unused_vertex, sizeof(Vertex));
+		unused_vertex.color.x = (f32)vertices.size();
+		vertices.push_back(unused_vertex);
+		usize num_referred_vertices = vertices.size() - 1;
+
+		// Triangles of the upper and lower half are stored in two pieces, and triangles of every piece are shuffled.
+		Vector<u32> indices;
+		Vector<MeshPiece> pieces;
+		u32 seed = 12345;
+		auto random = [&]() { seed = seed * 1664525 + 1013904223; return seed >> 8; };
+		for (u32 half = 0; half < 2; ++half)
+		{
+			Vector<u32> triangles;
+			for (u32 i = half * NUM_RINGS / 2; i < (half + 1) * NUM_RINGS / 2; ++i)
+			{
+				for (u32 j = 0; j < NUM_SEGMENTS; ++j)
+				{
+					u32 v00 = i * (NUM_SEGMENTS + 1) + j;
+					u32 v01 = v00 + 1;
+					u32 v10 = v00 + NUM_SEGMENTS + 1;
+					u32 v11 = v10 + 1;
+					// Counter-clockwise when seen from outside.
+					u32 quad[6] = { v00, v01, v10, v01, v11, v10 };
+					triangles.insert(triangles.end(), quad, quad + 6);
+				}
+			}
+			usize num_triangles = triangles.size() / 3;
+			for (usize t = num_triangles - 1; t > 0; --t)
+			{
+				usize k = random() % (t + 1);
+				for (u32 j = 0; j < 3; ++j)
+				{
+					u32 tmp = triangles[t * 3 + j];
+					triangles[t * 3 + j] = triangles[k * 3 + j];
+					triangles[k * 3 + j] = tmp;
+				}
+			}
+			MeshPiece piece;
+			piece.first_index_offset = (u32)indices.size();
+			piece.num_indices = (u32)triangles.size();
+			pieces.push_back(piece);
+			indices.insert(indices.end(), triangles.begin(), triangles.end());
+		}
+		// Pieces are not required to be sorted by their first index.
+		MeshPiece piece0 = pieces[0];
+		pieces[0] = pieces[1];
+		pieces[1] = piece0;
+
+		Vector<TriangleKey> triangles_before[2];
+		for (u32 i = 0; i < 2; ++i) triangles_before[i] = get_piece_triangles(indices.data(), pieces[i], vertices.data());
+		f32 acmr_before = calc_vertex_cache_acmr(indices.data(), indices.size(), vertices.size());
+		f32 overdraw_before = calc_overdraw(indices.data(), indices.size(), &vertices[0].position, sizeof(Vertex), vertices.size());
+
+		// Vertex cache optimization only.
+		Vector<u32> cache_indices = indices;
+		optimize_vertex_cache(cache_indices.data(), pieces.cspan(), vertices.size());
+		f32 acmr_cache = calc_vertex_cache_acmr(cache_indices.data(), cache_indices.size(), vertices.size());
+		f32 overdraw_cache = calc_overdraw(cache_indices.data(), cache_indices.size(), &vertices[0].position, sizeof(Vertex), vertices.size());
+
+		// All passes.
+		usize num_vertices = optimize_mesh(indices.data(), pieces.cspan(), vertices.data(), vertices.size());
+		f32 acmr_after = calc_vertex_cache_acmr(indices.data(), indices.size(), num_vertices);
+		f32 overdraw_after = calc_overdraw(indices.data(), indices.size(), &vertices[0].position, sizeof(Vertex), num_vertices);
+
+		log_info("StudioTest", "Mesh optimizer ACMR: %f (shuffled), %f (vertex cache), %f (all passes)", acmr_before, acmr_cache, acmr_after);
+		log_info("StudioTest", "Mesh optimizer overdraw: %f (shuffled), %f (vertex cache), %f (all passes)", overdraw_before, overdraw_cache, overdraw_after);
+
+		// A regular grid gets about 0.6~0.8 misses per triangle after optimization.
+		lutest(acmr_cache < 0.8f && acmr_cache < acmr_before * 0.5f);
+		lutest(acmr_after < 0.9f && acmr_after < acmr_before * 0.5f);
+		lutest(overdraw_after >= 1.0f && overdraw_after < overdraw_cache);
+
+		// Every piece keeps its own triangles with their winding order.
+		lutest(num_vertices == num_referred_vertices);
+		for (u32 i = 0; i < 2; ++i)
+		{
+			Vector<TriangleKey> triangles_after = get_piece_triangles(indices.data(), pieces[i], vertices.data());
+			lutest(triangles_after.size() == triangles_before[i].size());
+			for (usize j = 0; j < triangles_after.size(); ++j) lutest(triangles_after[j] == triangles_before[i][j]);
+		}
+		// Vertices are ordered by their first use.
+		u32 next_vertex = 0;
+		for (u32 index : indices)
+		{
+			lutest(index <= next_vertex);
+			if (index == next_vertex) ++next_vertex;
+		}
+		lutest(next_vertex == num_vertices);
+	}
+}
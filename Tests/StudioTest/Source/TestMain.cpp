@@ -0,0 +1,22 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file TestMain.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include "TestCommon.hpp"
+#include <Luna/Runtime/Log.hpp>
+using namespace Luna;
+
+int main()
+{
+	init();
+	set_log_to_platform_enabled(true);
+	cooked_asset_cache_test();
+	mesh_optimizer_test();
+	close();
+	return 0;
+}
@@ -0,0 +1,11 @@
+target("StudioTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_headerfiles("Source/*.hpp")
+    add_files("Source/*.cpp")
+    -- Studio is one program, so the tested Studio sources are compiled into the test directly.
+    add_includedirs("$(projectdir)/Programs/Studio")
+    add_files("$(projectdir)/Programs/Studio/CookedAssetCache.cpp")
+    add_files("$(projectdir)/Programs/Studio/MeshOptimizer.cpp")
+    add_deps("Runtime")
+target_end()
@@ -0,0 +1,233 @@
+/*!
+* This file is a portion of Luna SDK.
+* For conditions of distribution and use, see the disclaimer
+* and license in LICENSE.txt
+* 
+* @file Main.cpp
+* @author JXMaster
+* @date 2026/10/19
+*/
+#include <Luna/Runtime/Runtime.hpp>
+#include <Luna/Runtime/Module.hpp>
+#include <Luna/Runtime/File.hpp>
+#include <Luna/Runtime/Log.hpp>
+#include <Luna/VFS/VFS.hpp>
+// Corrupts pack files using the internal pack layout.
+#include <Luna/VFS/Source/Drivers/PackDriver.hpp>
+
+#define lutest luassert_always
+
+namespace Luna
+{
+	static void write_test_file(const c8* path, const void* data, usize size)
+	{
+		auto file = open_file(path, FileOpenFlag::write, FileCreationMode::create_always);
+		lutest(succeeded(file));
+		lutest(succeeded(file.get()->write(data, size)));
+	}
+
+	static Blob read_vfs_file(const c8* path)
+	{
+		auto file = VFS::open_file(path, FileOpenFlag::read, FileCreationMode::open_existing);
+		lutest(succeeded(file));
+		auto data = load_file_data(file.get());
+		lutest(succeeded(data));
+		return move(data.get());
+	}
+
+	static usize find_data(const Blob& data, const void* pattern, usize pattern_size)
+	{
+		for (usize i = 0; i + pattern_size <= data.size(); ++i)
+		{
+			if (!memcmp(data.data() + i, pattern, pattern_size)) return i;
+		}
+		return USIZE_MAX;
+	}
+
+	static void pack_test(u32 alignment)
+	{
+		const c8 small_data[] = "Hello, pack!";
+		// Large files are aligned to at least 4KB.
+		Vector<u32> large_data(32_kb);
+		for (usize i = 0; i < large_data.size(); ++i) large_data[i] = (u32)i | 0x80000000;
+		lutest(succeeded(create_dir("PackTestSource")));
+		lutest(succeeded(create_dir("PackTestSource/Sub")));
+		lutest(succeeded(create_dir("PackTestSource/Sub/Deep")));
+		write_test_file("PackTestSource/a.txt", small_data, sizeof(small_data));
+		write_test_file("PackTestSource/b.bin", large_data.data(), large_data.size() * sizeof(u32));
+		write_test_file("PackTestSource/Sub/d.txt", small_data, 5);
+		write_test_file("PackTestSource/Sub/c.txt", small_data, 1);
+		write_test_file("PackTestSource/Sub/Deep/e.txt", nullptr, 0);
+		lutest(succeeded(VFS::build_pack_file("PackTestSource", "PackTest.pack", alignment)));
+
+		// Checks the layout of the pack file. Every file record is aligned, and the padding between records is zero.
+		{
+			auto file = open_file("PackTest.pack", FileOpenFlag::read, FileCreationMode::open_existing);
+			lutest(succeeded(file));
+			Blob pack = load_file_data(file.get()).get();
+			usize small_offset = find_data(pack, small_data, sizeof(small_data));
+			usize large_offset = find_data(pack, large_data.data(), 64);
+			lutest(small_offset != USIZE_MAX && small_offset % alignment == 0);
+			lutest(large_offset != USIZE_MAX && large_offset % max<usize>(alignment, 4_kb) == 0);
+			lutest(small_offset < large_offset);
+			for (usize i = small_offset + sizeof(small_data); i < large_offset; ++i)
+			{
+				lutest(pack.data()[i] == 0);
+			}
+			lutest(!memcmp(pack.data() + large_offset, large_data.data(), large_data.size() * sizeof(u32)));
+		}
+
+		// Mounts the pack file and reads files back.
+		lutest(succeeded(VFS::mount(VFS::get_pack_driver(), "PackTest.pack", "/pack")));
+		{
+			Blob data = read_vfs_file("/pack/a.txt");
+			lutest(data.size() == sizeof(small_data) && !memcmp(data.data(), small_data, sizeof(small_data)));
+			data = read_vfs_file("/pack/b.bin");
+			lutest(data.size() == large_data.size() * sizeof(u32) && !memcmp(data.data(), large_data.data(), data.size()));
+			data = read_vfs_file("/pack/Sub/d.txt");
+			lutest(data.size() == 5 && !memcmp(data.data(), small_data, 5));
+			data = read_vfs_file("/pack/Sub/Deep/e.txt");
+			lutest(data.empty());
+			lutest(failed(VFS::open_file("/pack/Sub/missing.txt", FileOpenFlag::read, FileCreationMode::open_existing)));
+			lutest(failed(VFS::open_file("/pack/a.txt", FileOpenFlag::write, FileCreationMode::open_existing)));
+
+			auto attribute = VFS::get_file_attribute("/pack/b.bin");
+			lutest(succeeded(attribute) && attribute.get().size == large_data.size() * sizeof(u32));
+			attribute = VFS::get_file_attribute("/pack/Sub");
+			lutest(succeeded(attribute) && test_flags(attribute.get().attributes, FileAttributeFlag::directory));
+
+			// Children are listed in name order.
+			auto iter = VFS::open_dir("/pack/Sub");
+			lutest(succeeded(iter));
+			const c8* expected_names[] = { "Deep", "c.txt", "d.txt" };
+			usize num_children = 0;
+			for (auto& it = iter.get(); it->is_valid(); it->move_next())
+			{
+				lutest(num_children < 3 && !strcmp(it->get_filename(), expected_names[num_children]));
+				++num_children;
+			}
+			lutest(num_children == 3);
+
+			auto mapping = VFS::map_file("/pack/b.bin");
+			lutest(succeeded(mapping));
+			lutest(mapping.get()->get_size() == large_data.size() * sizeof(u32));
+			lutest(!memcmp(mapping.get()->get_data(), large_data.data(), large_data.size() * sizeof(u32)));
+		}
+		lutest(succeeded(VFS::unmount("/pack")));
+		lutest(succeeded(delete_file("PackTest.pack")));
+		const c8* source_files[] = {
+			"PackTestSource/Sub/Deep/e.txt", "PackTestSource/Sub/Deep",
+			"PackTestSource/Sub/c.txt", "PackTestSource/Sub/d.txt", "PackTestSource/Sub",
+			"PackTestSource/a.txt", "PackTestSource/b.bin", "PackTestSource"
+		};
+		for (const c8* path : source_files)
+		{
+			lutest(succeeded(delete_file(path)));
+		}
+	}
+
+	//! Writes one copy of the pack with `corrupt` applied, and checks that mounting it fails with `format_error`.
+	template <typename _Func>
+	static void check_corrupted_pack(const Blob& pack, _Func&& corrupt)
+	{
+		Blob data(pack);
+		VFS::PackHeader* header = (VFS::PackHeader*)data.data();
+		VFS::PackEntry* entries = (VFS::PackEntry*)(data.data() + header->entries_offset);
+		c8* strings = (c8*)(data.data() + header->strings_offset);
+		corrupt(header, entries, strings);
+		write_test_file("Corrupted.pack", data.data(), data.size());
+		lutest(VFS::mount(VFS::get_pack_driver(), "Corrupted.pack", "/corrupted").errcode() == BasicError::format_error());
+		lutest(succeeded(delete_file("Corrupted.pack")));
+	}
+
+	static VFS::PackEntry* find_pack_entry(VFS::PackHeader* header, VFS::PackEntry* entries, bool directory)
+	{
+		for (u32 i = 0; i < header->num_entries; ++i)
+		{
+			if (test_flags(entries[i].flags, VFS::PackEntryFlag::directory) == directory) return entries + i;
+		}
+		lutest(false);
+		return nullptr;
+	}
+
+	static void corrupted_pack_test()
+	{
+		const c8 data[] = "Hello, pack!";
+		lutest(succeeded(create_dir("PackTestSource")));
+		lutest(succeeded(create_dir("PackTestSource/Sub")));
+		write_test_file("PackTestSource/a.txt", data, sizeof(data));
+		write_test_file("PackTestSource/Sub/b.txt", data, sizeof(data));
+		lutest(succeeded(VFS::build_pack_file("PackTestSource", "PackTest.pack", 16)));
+		Blob pack;
+		{
+			auto file = open_file("PackTest.pack", FileOpenFlag::read, FileCreationMode::open_existing);
+			lutest(succeeded(file));
+			pack = load_file_data(file.get()).get();
+		}
+		// The unmodified pack can be mounted.
+		lutest(succeeded(VFS::mount(VFS::get_pack_driver(), "PackTest.pack", "/pack")));
+		lutest(succeeded(VFS::unmount("/pack")));
+		// One name that is not terminated.
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				VFS::PackEntry* e = find_pack_entry(header, entries, false);
+				strings[e->name_offset + e->name_length] = 'x';
+			});
+		// The last name is not terminated in the string table.
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				VFS::PackEntry* e = find_pack_entry(header, entries, false);
+				header->strings_size = e->name_offset + e->name_length;
+			});
+		// File ranges, directory ranges and the string table range that wrap around.
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				VFS::PackEntry* e = find_pack_entry(header, entries, false);
+				e->offset = U64_MAX - 7;
+				e->size = 16;
+			});
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				VFS::PackEntry* e = find_pack_entry(header, entries, true);
+				e->offset = U64_MAX;
+				e->size = 2;
+			});
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				header->strings_offset = U64_MAX - 15;
+				header->strings_size = 32;
+			});
+		check_corrupted_pack(pack, [](VFS::PackHeader* header, VFS::PackEntry* entries, c8* strings)
+			{
+				header->entries_offset = U64_MAX - sizeof(VFS::PackEntry) + 1;
+			});
+		lutest(succeeded(delete_file("PackTest.pack")));
+		const c8* source_files[] = { "PackTestSource/Sub/b.txt", "PackTestSource/Sub", "PackTestSource/a.txt", "PackTestSource" };
+		for (const c8* path : source_files)
+		{
+			lutest(succeeded(delete_file(path)));
+		}
+	}
+
+	void vfs_test()
+	{
+		pack_test(16);
+		// Alignments larger than the large file alignment.
+		pack_test(8_kb);
+		pack_test(64_kb);
+		lutest(failed(VFS::build_pack_file("PackTestSource", "PackTest.pack", 24)));
+		corrupted_pack_test();
+	}
+}
+
+int main()
+{
+	Luna::init();
+	lupanic_if_failed(Luna::add_modules({Luna::module_vfs()}));
+	lupanic_if_failed(Luna::init_modules());
+	Luna::set_log_to_platform_enabled(true);
+	Luna::set_log_to_platform_verbosity(Luna::LogVerbosity::warning);
+	Luna::vfs_test();
+	Luna::close();
+	return 0;
+}
@@ -0,0 +1,6 @@
+target("VFSTest")
+    set_luna_sdk_test()
+    set_kind("binary")
+    add_files("*.cpp")
+    add_deps("Runtime", "VFS")
+target_end()
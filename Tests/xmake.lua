@@ -1,5 +1,6 @@
 includes("RuntimeTest")
 includes("VariantUtilsTest")
+includes("VFSTest")
 includes("WindowTest")
 includes("RHITests")
 includes("VGTest")
@@ -7,4 +8,17 @@ includes("FontArrangeTest")
 includes("ImGuiTest")
 includes("JobSystemTest")
 includes("ECSTest")
-includes("AHITest")
\ No newline at end of file
+includes("AHITest")
+includes("AssetTest")
+includes("StudioTest")
+includes("ImageTest")
+includes("ObjLoaderTest")
+includes("ResourceDataCopierTest")
+if is_config("rhi_api", "Null") then
+    -- RGTest checks commands recorded by the null RHI backend.
+    includes("RGTest")
+end
+if is_config("rhi_api", "Vulkan") then
+    -- ResourceStateTrackingTest checks resource states tracked by the Vulkan RHI backend.
+    includes("ResourceStateTrackingTest")
+end
\ No newline at end of file